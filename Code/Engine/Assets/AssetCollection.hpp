@@ -5,9 +5,23 @@
 /* Description: Class to represent a collection of a single asset type
 /************************************************************************/
 #pragma once
+#include <vector>
+#include <shared_mutex>
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Assets/AssetHandle.hpp"
+#include "Engine/Core/Utility/StringID.hpp"
 #include "Engine/Rendering/Resources/Texture.hpp"
 
+// An unreferenced asset that could be evicted, gathered across collections so they can be evicted oldest first
+struct AssetEvictionCandidate_t
+{
+	uint64_t	nameHash = 0;
+	uint64_t	lastUsedTime = 0;
+	size_t		cpuBytes = 0;
+	size_t		gpuBytes = 0;
+	bool		(*evictFunction)(uint64_t nameHash) = nullptr;
+};
+
 template <typename RESOURCETYPE>
 class AssetCollection
 {
@@ -17,50 +31,370 @@ class AssetCollection
 private:
 	//-----Private Methods-----
 
-	static RESOURCETYPE*	GetAsset(const std::string& name);
-	static bool				AddAsset(const std::string& name, RESOURCETYPE* resource);
+	// Safe to call from any thread, lookups only take a shared lock so they don't block each other
+	static RESOURCETYPE*	GetAsset(StringID name);	// Pins the asset, since the caller may hold onto the pointer
+	static RESOURCETYPE*	FindAsset(StringID name);	// Doesn't pin, for the AssetDB's own checks
+	static AssetRecord_t*	AcquireAsset(StringID name);	// Adds a reference for a handle, nullptr if not found
+	static bool				AddAsset(const std::string& name, RESOURCETYPE* resource, bool isPinned = true);	// False, without adding, if the name is taken
+	static void				GetAllAssets(std::vector<RESOURCETYPE*>& out_assets);
+
+	// Memory accounting
+	static void				SetAssetMemory(StringID name, size_t cpuBytes, size_t gpuBytes);
+	static void				GetMemoryUsage(int& out_assetCount, size_t& out_cpuBytes, size_t& out_gpuBytes);
+
+	// Eviction
+	static void				GetEvictionCandidates(std::vector<AssetEvictionCandidate_t>& out_candidates);
+	static bool				EvictAsset(uint64_t nameHash);	// False if it was referenced or pinned since it was a candidate
+
+	static int				FindSlot(uint64_t hash);	// Slot holding the hash, or the empty slot it would go in
+	static void				RemoveSlot(int slotIndex);
+	static void				Grow();
 
 
 private:
 	//-----Private Data-----
 
-	static std::map<std::string, RESOURCETYPE*> s_collection;
+	// Open addressing with linear probing, keyed by the name's hash - a hash of 0 marks an empty slot
+	// The hash is kept inline so probing doesn't touch the records
+	struct AssetSlot_t
+	{
+		uint64_t		hash = 0;
+		AssetRecord_t*	record = nullptr;
+	};
+
+	static std::vector<AssetSlot_t>	s_slots;		// Size is always a power of two
+	static int						s_assetCount;
+	static size_t					s_cpuBytes;		// Totals of the records' estimates
+	static size_t					s_gpuBytes;
+	static std::shared_mutex		s_lock;
+
+	static constexpr int INITIAL_SLOT_COUNT = 64;
 
 };
 
 
+template <typename RESOURCETYPE>
+std::vector<typename AssetCollection<RESOURCETYPE>::AssetSlot_t> AssetCollection<RESOURCETYPE>::s_slots;
+
+template <typename RESOURCETYPE>
+int AssetCollection<RESOURCETYPE>::s_assetCount = 0;
+
+template <typename RESOURCETYPE>
+size_t AssetCollection<RESOURCETYPE>::s_cpuBytes = 0;
+
+template <typename RESOURCETYPE>
+size_t AssetCollection<RESOURCETYPE>::s_gpuBytes = 0;
+
+template <typename RESOURCETYPE>
+std::shared_mutex AssetCollection<RESOURCETYPE>::s_lock;
+
+
 //-----------------------------------------------------------------------------------------------
 // Returns the resource given by the name, returns nullptr if not found
+// Pins it, so it will never be evicted
 //
 template <typename RESOURCETYPE>
-std::map<std::string, RESOURCETYPE*> AssetCollection<RESOURCETYPE>::s_collection;
+RESOURCETYPE* AssetCollection<RESOURCETYPE>::GetAsset(StringID name)
+{
+	RESOURCETYPE* asset = nullptr;
+
+	s_lock.lock_shared();
+	{
+		AssetRecord_t* record = (s_slots.size() > 0 ? s_slots[FindSlot(name.GetHash())].record : nullptr);
+
+		if (record != nullptr)
+		{
+			record->isPinned = true;
+			record->MarkUsed();
+			asset = static_cast<RESOURCETYPE*>(record->asset);
+		}
+	}
+	s_lock.unlock_shared();
+
+	return asset;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the resource given by the name without pinning it, returns nullptr if not found
+//
+template <typename RESOURCETYPE>
+RESOURCETYPE* AssetCollection<RESOURCETYPE>::FindAsset(StringID name)
+{
+	RESOURCETYPE* asset = nullptr;
+
+	s_lock.lock_shared();
+	{
+		AssetRecord_t* record = (s_slots.size() > 0 ? s_slots[FindSlot(name.GetHash())].record : nullptr);
 
+		if (record != nullptr)
+		{
+			asset = static_cast<RESOURCETYPE*>(record->asset);
+		}
+	}
+	s_lock.unlock_shared();
+
+	return asset;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a reference to the asset and returns its record, returns nullptr if not found
+// The reference is added under the lock, so the asset can't be evicted between the lookup and the add
+//
 template <typename RESOURCETYPE>
-RESOURCETYPE* AssetCollection<RESOURCETYPE>::GetAsset(const std::string& name)
+AssetRecord_t* AssetCollection<RESOURCETYPE>::AcquireAsset(StringID name)
 {
-	bool resourceExists = (s_collection.find(name) != s_collection.end());
-	
-	if (resourceExists)
+	AssetRecord_t* record = nullptr;
+
+	s_lock.lock_shared();
 	{
-		return s_collection[name];
+		record = (s_slots.size() > 0 ? s_slots[FindSlot(name.GetHash())].record : nullptr);
+
+		if (record != nullptr)
+		{
+			record->AddReference();
+		}
 	}
+	s_lock.unlock_shared();
 
-	return nullptr;
+	return record;
 }
 
 
 //-----------------------------------------------------------------------------------------------
 // Adds the resource to the collection, checking for duplicates
+// Unpinned resources can be evicted once nothing holds a handle to them
 //
 template <typename RESOURCETYPE>
-bool AssetCollection<RESOURCETYPE>::AddAsset(const std::string& name, RESOURCETYPE* resource)
+bool AssetCollection<RESOURCETYPE>::AddAsset(const std::string& name, RESOURCETYPE* resource, bool isPinned /*= true*/)
 {
-	bool resourceAlreadyExists = s_collection.find(name) != s_collection.end();
+	// Interned so a name that collides with an existing one is caught here, rather than silently aliasing it
+	uint64_t hash = StringID::Intern(name).GetHash();
+	bool resourceAlreadyExists = false;
 
-	if (!resourceAlreadyExists)
+	s_lock.lock();
 	{
-		s_collection[name] = resource;
+		// Keep the table at most half full, so probes stay short
+		if ((s_assetCount + 1) * 2 > (int) s_slots.size())
+		{
+			Grow();
+		}
+
+		AssetSlot_t& slot = s_slots[FindSlot(hash)];
+		resourceAlreadyExists = (slot.hash != 0);
+
+		if (!resourceAlreadyExists)
+		{
+			AssetRecord_t* record = new AssetRecord_t();
+			record->asset = resource;
+			record->nameHash = hash;
+			record->isPinned = isPinned;
+			record->lastUsedTime = GetPerformanceCounter();
+
+			slot.hash = hash;
+			slot.record = record;
+			s_assetCount++;
+		}
 	}
+	s_lock.unlock();
 
 	return !resourceAlreadyExists;
 }
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends every resource in the collection, in no particular order
+//
+template <typename RESOURCETYPE>
+void AssetCollection<RESOURCETYPE>::GetAllAssets(std::vector<RESOURCETYPE*>& out_assets)
+{
+	s_lock.lock_shared();
+	{
+		for (int slotIndex = 0; slotIndex < (int) s_slots.size(); ++slotIndex)
+		{
+			if (s_slots[slotIndex].hash != 0)
+			{
+				out_assets.push_back(static_cast<RESOURCETYPE*>(s_slots[slotIndex].record->asset));
+			}
+		}
+	}
+	s_lock.unlock_shared();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets the estimated memory the asset uses, for when it's created or its data changes
+//
+template <typename RESOURCETYPE>
+void AssetCollection<RESOURCETYPE>::SetAssetMemory(StringID name, size_t cpuBytes, size_t gpuBytes)
+{
+	s_lock.lock();
+	{
+		AssetRecord_t* record = (s_slots.size() > 0 ? s_slots[FindSlot(name.GetHash())].record : nullptr);
+
+		if (record != nullptr)
+		{
+			s_cpuBytes = s_cpuBytes - record->cpuBytes + cpuBytes;
+			s_gpuBytes = s_gpuBytes - record->gpuBytes + gpuBytes;
+
+			record->cpuBytes = cpuBytes;
+			record->gpuBytes = gpuBytes;
+		}
+	}
+	s_lock.unlock();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of assets in the collection and the total memory they're estimated to use
+//
+template <typename RESOURCETYPE>
+void AssetCollection<RESOURCETYPE>::GetMemoryUsage(int& out_assetCount, size_t& out_cpuBytes, size_t& out_gpuBytes)
+{
+	s_lock.lock_shared();
+	{
+		out_assetCount = s_assetCount;
+		out_cpuBytes = s_cpuBytes;
+		out_gpuBytes = s_gpuBytes;
+	}
+	s_lock.unlock_shared();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends every asset that's unpinned and unreferenced right now
+//
+template <typename RESOURCETYPE>
+void AssetCollection<RESOURCETYPE>::GetEvictionCandidates(std::vector<AssetEvictionCandidate_t>& out_candidates)
+{
+	s_lock.lock_shared();
+	{
+		for (int slotIndex = 0; slotIndex < (int) s_slots.size(); ++slotIndex)
+		{
+			AssetRecord_t* record = s_slots[slotIndex].record;
+
+			if (record != nullptr && !record->isPinned && record->refCount == 0)
+			{
+				AssetEvictionCandidate_t candidate;
+				candidate.nameHash = record->nameHash;
+				candidate.lastUsedTime = record->lastUsedTime;
+				candidate.cpuBytes = record->cpuBytes;
+				candidate.gpuBytes = record->gpuBytes;
+				candidate.evictFunction = &AssetCollection<RESOURCETYPE>::EvictAsset;
+
+				out_candidates.push_back(candidate);
+			}
+		}
+	}
+	s_lock.unlock_shared();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes and deletes the asset, if nothing has referenced or pinned it
+// Takes the write lock, so no acquire can be partway through while the count is checked
+//
+template <typename RESOURCETYPE>
+bool AssetCollection<RESOURCETYPE>::EvictAsset(uint64_t nameHash)
+{
+	AssetRecord_t* evictedRecord = nullptr;
+
+	s_lock.lock();
+	{
+		int slotIndex = (s_slots.size() > 0 ? FindSlot(nameHash) : -1);
+		AssetRecord_t* record = (slotIndex >= 0 ? s_slots[slotIndex].record : nullptr);
+
+		if (record != nullptr && !record->isPinned && record->refCount == 0)
+		{
+			RemoveSlot(slotIndex);
+
+			s_assetCount--;
+			s_cpuBytes -= record->cpuBytes;
+			s_gpuBytes -= record->gpuBytes;
+
+			evictedRecord = record;
+		}
+	}
+	s_lock.unlock();
+
+	// Deleted outside the lock, so a slow destructor doesn't hold up lookups
+	if (evictedRecord != nullptr)
+	{
+		delete static_cast<RESOURCETYPE*>(evictedRecord->asset);
+		delete evictedRecord;
+	}
+
+	return (evictedRecord != nullptr);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the slot the hash is in, or the first empty slot after its home slot if it isn't in the table
+// Expects the lock to be held and the table to have at least one empty slot
+//
+template <typename RESOURCETYPE>
+int AssetCollection<RESOURCETYPE>::FindSlot(uint64_t hash)
+{
+	int slotMask = (int) s_slots.size() - 1;
+	int slotIndex = (int)(hash ^ (hash >> 32)) & slotMask;
+
+	while (s_slots[slotIndex].hash != 0 && s_slots[slotIndex].hash != hash)
+	{
+		slotIndex = (slotIndex + 1) & slotMask;
+	}
+
+	return slotIndex;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Empties the slot, shifting back any later entries in the probe run that would otherwise be
+// unreachable past the gap, expects the write lock to be held
+//
+template <typename RESOURCETYPE>
+void AssetCollection<RESOURCETYPE>::RemoveSlot(int slotIndex)
+{
+	int slotMask = (int) s_slots.size() - 1;
+	int gapIndex = slotIndex;
+	int currIndex = (slotIndex + 1) & slotMask;
+
+	while (s_slots[currIndex].hash != 0)
+	{
+		uint64_t hash = s_slots[currIndex].hash;
+		int homeIndex = (int)(hash ^ (hash >> 32)) & slotMask;
+
+		// The entry can fill the gap if the gap is between its home slot and where it is now
+		if (((currIndex - homeIndex) & slotMask) >= ((currIndex - gapIndex) & slotMask))
+		{
+			s_slots[gapIndex] = s_slots[currIndex];
+			gapIndex = currIndex;
+		}
+
+		currIndex = (currIndex + 1) & slotMask;
+	}
+
+	s_slots[gapIndex] = AssetSlot_t();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Doubles the slot count and reinserts everything, expects the write lock to be held
+//
+template <typename RESOURCETYPE>
+void AssetCollection<RESOURCETYPE>::Grow()
+{
+	std::vector<AssetSlot_t> oldSlots;
+	oldSlots.swap(s_slots);
+
+	int newSlotCount = (oldSlots.size() > 0 ? (int) oldSlots.size() * 2 : INITIAL_SLOT_COUNT);
+	s_slots.resize(newSlotCount);
+
+	for (int slotIndex = 0; slotIndex < (int) oldSlots.size(); ++slotIndex)
+	{
+		if (oldSlots[slotIndex].hash != 0)
+		{
+			s_slots[FindSlot(oldSlots[slotIndex].hash)] = oldSlots[slotIndex];
+		}
+	}
+}
@@ -4,11 +4,21 @@
 /* Date: April 11th, 2018
 /* Description: Implementation of the Resource class
 /************************************************************************/
+#include <map>
+#include <mutex>
+#include <algorithm>
 #include "Engine/Core/Image.hpp"
+#include "Engine/Core/PackFile.hpp"
+#include "Engine/Core/FileWatcher.hpp"
+#include "Engine/Core/CompressedImage.hpp"
+#include "Engine/Assets/BakeFile.hpp"
 #include "Engine/Assets/AssetDB.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time/Time.hpp"
+#include "Engine/Core/JobSystem/Job.hpp"
 #include "Engine/Assets/AssetCollection.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
 #include "Engine/Core/Time/ProfileScoped.hpp"
 #include "Engine/Rendering/Shaders/Shader.hpp"
 #include "Engine/Rendering/Resources/Skybox.hpp"
@@ -20,10 +30,147 @@
 #include "Engine/Rendering/Resources/SpriteSheet.hpp"
 #include "Engine/Rendering/Resources/SpriteSheet.hpp"
 #include "Engine/Rendering/Shaders/ShaderProgram.hpp"
+#include "Engine/Core/DeveloperConsole/Command.hpp"
 #include "Engine/Core/DeveloperConsole/DevConsole.hpp"
 #include "Engine/Rendering/Meshes/MeshGroupBuilder.hpp"
 #include "Engine/Rendering/Materials/MaterialInstance.hpp"
 
+// A load started by one of the async functions, split into the part that can run on a worker and
+// the GPU upload, which has to run on the main thread
+class AsyncAssetLoad
+{
+public:
+	AsyncAssetLoad(const std::string& filepath) : m_filepath(filepath) {}
+	virtual ~AsyncAssetLoad() {}
+
+	// File reads and decoding only, no GPU calls
+	// Anything it reaches that splits into jobs must run inline on a worker (see JobSystem::IsOnWorkerThread()),
+	// since the load's job could be on any ALL worker and waiting there can leave nothing to run the splits
+	virtual void LoadOnWorker() = 0;
+	virtual void UploadOnMainThread() = 0;
+	virtual void GetMemoryUsage(size_t& out_cpuBytes, size_t& out_gpuBytes) const = 0;
+
+	std::string		m_filepath;
+
+	// Set for loads of AssetDB entries - the reference keeps the placeholder from being evicted before the upload
+	AssetRecord_t*	m_record = nullptr;
+	void			(*m_setMemoryFunction)(StringID name, size_t cpuBytes, size_t gpuBytes) = nullptr;
+};
+
+// Reads and decodes the image, then uploads it into the placeholder texture handed out when the load started
+class AsyncTextureLoad : public AsyncAssetLoad
+{
+public:
+	AsyncTextureLoad(const std::string& filepath, Texture* texture, bool useMipMaps, bool useCompressedCache)
+		: AsyncAssetLoad(filepath), m_texture(texture), m_useMipMaps(useMipMaps), m_useCompressedCache(useCompressedCache) {}
+
+	virtual void LoadOnWorker() override;
+	virtual void UploadOnMainThread() override;
+	virtual void GetMemoryUsage(size_t& out_cpuBytes, size_t& out_gpuBytes) const override;
+
+	Texture*			m_texture = nullptr;
+	bool				m_useMipMaps = false;
+	bool				m_useCompressedCache = false;
+	Image*				m_image = nullptr;
+	CompressedImage*	m_compressedImage = nullptr;
+};
+
+// Reads the bake, or parses the OBJ and writes the bake if it's out of date, then creates the meshes in the group handed out
+class AsyncMeshGroupLoad : public AsyncAssetLoad
+{
+public:
+	AsyncMeshGroupLoad(const std::string& filepath, MeshGroup* group)
+		: AsyncAssetLoad(filepath), m_group(group) {}
+
+	virtual void LoadOnWorker() override;
+	virtual void UploadOnMainThread() override;
+	virtual void GetMemoryUsage(size_t& out_cpuBytes, size_t& out_gpuBytes) const override;
+
+	MeshGroup*			m_group = nullptr;
+	BakeFile			m_bake;
+	uint64_t			m_bakeKey = 0;			// Whether the meshes were optimized
+	bool				m_isBakeValid = false;
+	MeshGroupBuilder	m_builder;
+	bool				m_isReload = false;		// Updates the group's meshes in place instead of adding to it
+
+private:
+	void UpdateMeshesInPlace();
+};
+
+// Parses the OBJ again and rebuilds a shared mesh in place, for hot reloads
+class AsyncMeshLoad : public AsyncAssetLoad
+{
+public:
+	AsyncMeshLoad(const std::string& filepath, Mesh* mesh)
+		: AsyncAssetLoad(filepath), m_mesh(mesh) {}
+
+	virtual void LoadOnWorker() override;
+	virtual void UploadOnMainThread() override;
+	virtual void GetMemoryUsage(size_t& out_cpuBytes, size_t& out_gpuBytes) const override;
+
+	Mesh*				m_mesh = nullptr;
+	MeshBuilder			m_builder;
+};
+
+// Runs a load's worker half on a disk thread, then hands it back to the main thread to wait for upload
+class AssetLoadJob : public Job
+{
+public:
+	AssetLoadJob(AsyncAssetLoad* load)
+		: m_load(load)
+	{
+		m_jobType = JOB_TYPE_ASSET_LOAD;
+		m_jobFlags = WORKER_FLAGS_DISK;
+	}
+
+	virtual void Execute() override;
+	virtual void Finalize() override;
+
+	AsyncAssetLoad* m_load = nullptr;
+};
+
+// Async load state, only touched on the main thread - jobs hand loads back through Finalize()
+static std::vector<AsyncAssetLoad*>	s_loadsInFlight;		// Started and not yet uploaded
+static std::vector<AsyncAssetLoad*>	s_loadsReadyToUpload;	// Oldest first
+static float						s_uploadBudgetSeconds = AssetDB::DEFAULT_UPLOAD_BUDGET_SECONDS;
+
+// Eviction budget, 0 for no limit
+static size_t						s_cpuBudgetBytes = 0;
+static size_t						s_gpuBudgetBytes = 0;
+
+// What an asset was made from, so a change to the file reloads it
+enum HotReloadType
+{
+	HOT_RELOAD_TEXTURE,
+	HOT_RELOAD_MESH,
+	HOT_RELOAD_MESH_GROUP,
+	HOT_RELOAD_SHADER,
+	HOT_RELOAD_MATERIAL,
+	HOT_RELOAD_SPRITESHEET
+};
+
+struct HotReloadSource_t
+{
+	HotReloadType	type;
+	std::string		assetName;
+	bool			useMipMaps = false;				// Textures only
+	bool			useCompressedCache = false;		// Textures only
+};
+
+// Sources are recorded wherever assets are created, the rest is only touched on the main thread
+static std::map<std::string, std::vector<HotReloadSource_t>>	s_hotReloadSources;		// Keyed by PackFile::NormalizePath() of the file
+static std::mutex												s_hotReloadSourceLock;
+static FileWatcher*												s_hotReloadWatcher = nullptr;
+static std::vector<std::string>									s_deferredReloads;		// Files with a load still in flight
+
+static void		TrackHotReloadSource(const std::string& sourcePath, HotReloadType type, const std::string& assetName, bool useMipMaps = false, bool useCompressedCache = false);
+static void		TrackShaderSources(const std::string& shaderPath, Shader* shader);
+static void		StartAsyncLoad(AsyncAssetLoad* load);
+static size_t	GetImageMemorySize(const Image* image);
+static Image*	CreateFlippedCopy(const Image* image);
+static size_t	GetMeshGPUMemorySize(const Mesh* mesh);
+static size_t	GetMeshGroupGPUMemorySize(const MeshGroup* group);
+
 //-----------------------------------------------------------------------------------------------
 // Constructs all the built-in assets for the Engine, called at start up
 //
@@ -40,6 +187,8 @@ void AssetDB::CreateBuiltInAssets()
 
 	//---------------------Meshes--------------------
 	CreateMeshes();
+
+	InitializeConsoleCommands();
 }
 
 
@@ -288,7 +437,7 @@ void AssetDB::CreateMeshes()
 //-----------------------------------------------------------------------------------------------
 // Returns the image given by the filepath, returning null if it doesn't exist
 //
-Image* AssetDB::GetImage(const std::string& filename)
+Image* AssetDB::GetImage(StringID filename)
 {
 	return AssetCollection<Image>::GetAsset(filename);
 }
@@ -299,31 +448,19 @@ Image* AssetDB::GetImage(const std::string& filename)
 //
 Image* AssetDB::CreateOrGetImage(const std::string& filepath)
 {
-	Image* img = AssetCollection<Image>::GetAsset(filepath);
-
-	if (img == nullptr)
+	if (FindOrLoadImage(filepath) == nullptr)
 	{
-		img = new Image();
-		bool successful = img->LoadFromFile(filepath);
-
-		// Don't put nullptr in the AssetDB - allows for image reloading if failed
-		if (!successful)
-		{
-			delete img;
-			return nullptr;
-		}
-
-		AssetCollection<Image>::AddAsset(filepath, img);
+		return nullptr;
 	}
 
-	return img;
+	return AssetCollection<Image>::GetAsset(filepath);
 }
 
 
 //-----------------------------------------------------------------------------------------------
 // Returns the texture given by the filepath, returning null if it doesn't exist
 //
-Texture* AssetDB::GetTexture(const std::string& filename)
+Texture* AssetDB::GetTexture(StringID filename)
 {
 	Texture* texture = AssetCollection<Texture>::GetAsset(filename);
 	return texture;
@@ -332,33 +469,23 @@ Texture* AssetDB::GetTexture(const std::string& filename)
 
 //-----------------------------------------------------------------------------------------------
 // Returns the Texture given by filepath, attempting to construct it if it doesn't exist
+// The image it's made from is freed after the upload, unless retainImage is set
 //
-Texture* AssetDB::CreateOrGetTexture(const std::string& filepath, bool generateMipMaps /*= false*/)
+Texture* AssetDB::CreateOrGetTexture(const std::string& filepath, bool generateMipMaps /*= false*/, bool retainImage /*= false*/, bool useCompressedCache /*= false*/)
 {
-	Texture* texture = AssetCollection<Texture>::GetAsset(filepath);
-
-	if (texture == nullptr)
+	if (FindOrLoadTexture(filepath, generateMipMaps, retainImage, useCompressedCache) == nullptr)
 	{
-		texture = new Texture();
-		bool successful = texture->CreateFromFile(filepath, generateMipMaps);
-		
-		if (!successful)
-		{
-			delete texture;
-			return nullptr;
-		}
-
-		AssetCollection<Texture>::AddAsset(filepath, texture);
+		return nullptr;
 	}
 
-	return texture;
+	return AssetCollection<Texture>::GetAsset(filepath);
 }
 
 
 //-----------------------------------------------------------------------------------------------
 // Returns the TextureCube given by name, returning null if it doesn't exist
 //
-TextureCube* AssetDB::GetTextureCube(const std::string& filename)
+TextureCube* AssetDB::GetTextureCube(StringID filename)
 {
 	return AssetCollection<TextureCube>::GetAsset(filename);
 }
@@ -375,7 +502,15 @@ TextureCube* AssetDB::CreateOrGetTextureCube(const std::string& filepath)
 	{
 		textureCube = new TextureCube();
 		textureCube->CreateFromFile(filepath);
-		AssetCollection<TextureCube>::AddAsset(filepath, textureCube);
+
+		// Another thread may have added it while this one was loading, so keep theirs
+		if (!AssetCollection<TextureCube>::AddAsset(filepath, textureCube))
+		{
+			delete textureCube;
+			return AssetCollection<TextureCube>::GetAsset(filepath);
+		}
+
+		AssetCollection<TextureCube>::SetAssetMemory(filepath, 0, textureCube->GetGPUMemorySize());
 	}
 
 	return textureCube;
@@ -385,7 +520,7 @@ TextureCube* AssetDB::CreateOrGetTextureCube(const std::string& filepath)
 //-----------------------------------------------------------------------------------------------
 // Returns the Skybox given by name, returning null if it doesn't exist
 //
-Skybox* AssetDB::GetSkybox(const std::string& textureName)
+Skybox* AssetDB::GetSkybox(StringID textureName)
 {
 	return AssetCollection<Skybox>::GetAsset(textureName);
 }
@@ -403,7 +538,11 @@ Skybox* AssetDB::CreateOrGetSkybox(const std::string& textureName)
 		TextureCube* skyboxTexture = CreateOrGetTextureCube(textureName);
 		skybox = new Skybox(skyboxTexture);
 
-		AssetCollection<Skybox>::AddAsset(textureName, skybox);
+		if (!AssetCollection<Skybox>::AddAsset(textureName, skybox))
+		{
+			delete skybox;
+			return AssetCollection<Skybox>::GetAsset(textureName);
+		}
 	}
 
 	return skybox;
@@ -413,7 +552,7 @@ Skybox* AssetDB::CreateOrGetSkybox(const std::string& textureName)
 //-----------------------------------------------------------------------------------------------
 // Returns the SpriteSheet given by name, returning null if it doesn't exist
 //
-SpriteSheet* AssetDB::GetSpriteSheet(const std::string& name)
+SpriteSheet* AssetDB::GetSpriteSheet(StringID name)
 {
 	return AssetCollection<SpriteSheet>::GetAsset(name);
 }
@@ -429,7 +568,14 @@ SpriteSheet* AssetDB::CreateOrGetSpriteSheet(const std::string& spritesheetPath)
 	if (spritesheet == nullptr)
 	{
 		spritesheet = SpriteSheet::LoadSpriteSheet(spritesheetPath);
-		AssetCollection<SpriteSheet>::AddAsset(spritesheetPath, spritesheet);
+
+		if (!AssetCollection<SpriteSheet>::AddAsset(spritesheetPath, spritesheet))
+		{
+			delete spritesheet;
+			return AssetCollection<SpriteSheet>::GetAsset(spritesheetPath);
+		}
+
+		TrackHotReloadSource(spritesheetPath, HOT_RELOAD_SPRITESHEET, spritesheetPath);
 	}
 
 	return spritesheet;
@@ -439,7 +585,7 @@ SpriteSheet* AssetDB::CreateOrGetSpriteSheet(const std::string& spritesheetPath)
 //-----------------------------------------------------------------------------------------------
 // Returns the BitmapFont given by name, returning null if it doesn't exist
 //
-BitmapFont* AssetDB::GetBitmapFont(const std::string& filename)
+BitmapFont* AssetDB::GetBitmapFont(StringID filename)
 {
 	BitmapFont* font = AssetCollection<BitmapFont>::GetAsset(filename);
 	return font;
@@ -464,7 +610,13 @@ BitmapFont* AssetDB::CreateOrGetBitmapFont(const std::string& fontPath)
 		SpriteSheet spriteSheet = SpriteSheet(*fontTexture, IntVector2(16, 16));
 		font = new BitmapFont(spriteSheet, 1.0f);
 
-		AssetCollection<BitmapFont>::AddAsset(fontPath, font);
+		// The font doesn't own its texture, so it goes too
+		if (!AssetCollection<BitmapFont>::AddAsset(fontPath, font))
+		{
+			delete font;
+			delete fontTexture;
+			return AssetCollection<BitmapFont>::GetAsset(fontPath);
+		}
 	}
 
 	return font;
@@ -474,7 +626,7 @@ BitmapFont* AssetDB::CreateOrGetBitmapFont(const std::string& fontPath)
 //-----------------------------------------------------------------------------------------------
 // Returns the shared Mesh given by filename, returning null if it doesn't exist
 //
-Mesh* AssetDB::GetMesh(const std::string& filename)
+Mesh* AssetDB::GetMesh(StringID filename)
 {
 	return AssetCollection<Mesh>::GetAsset(filename);
 }
@@ -491,8 +643,22 @@ Mesh* AssetDB::CreateOrGetMesh(const std::string& meshPath)
 	{
 		MeshBuilder mb;
 		mb.LoadFromObjFile(meshPath);
+
+		if (MeshBuilder::IsOptimizeOnLoadEnabled())
+		{
+			mb.Optimize();
+		}
+
 		mesh = mb.CreateMesh();
-		AssetCollection<Mesh>::AddAsset(meshPath, mesh);
+
+		if (!AssetCollection<Mesh>::AddAsset(meshPath, mesh))
+		{
+			delete mesh;
+			return AssetCollection<Mesh>::GetAsset(meshPath);
+		}
+
+		AssetCollection<Mesh>::SetAssetMemory(meshPath, 0, GetMeshGPUMemorySize(mesh));
+		TrackHotReloadSource(meshPath, HOT_RELOAD_MESH, meshPath);
 	}
 
 	return mesh;
@@ -504,45 +670,36 @@ Mesh* AssetDB::CreateOrGetMesh(const std::string& meshPath)
 //
 void AssetDB::AddMesh(const std::string& name, Mesh* mesh)
 {
-	Mesh* existingMesh = AssetCollection<Mesh>::GetAsset(name);
-	ASSERT_OR_DIE(existingMesh == nullptr, Stringf("Error: AssetDB::AddMesh() tried to add a duplicate mesh of name \"%s\"", name.c_str()));
+	bool wasAdded = AssetCollection<Mesh>::AddAsset(name, mesh);
+	ASSERT_OR_DIE(wasAdded, Stringf("Error: AssetDB::AddMesh() tried to add a duplicate mesh of name \"%s\"", name.c_str()));
 
-	AssetCollection<Mesh>::AddAsset(name, mesh);
+	AssetCollection<Mesh>::SetAssetMemory(name, 0, GetMeshGPUMemorySize(mesh));
 }
 
 
 //-----------------------------------------------------------------------------------------------
 // Returns the Mesh Group given by filename, returning null if it doesn't exist
 //
-MeshGroup* AssetDB::GetMeshGroup(const std::string& filename)
+MeshGroup* AssetDB::GetMeshGroup(StringID filename)
 {
 	return AssetCollection<MeshGroup>::GetAsset(filename);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Returns the Mesh Group given by filename, returning null if it doesn't exist
+// Returns the Mesh Group given by filename, attempting to load it if it doesn't exist
 //
 MeshGroup* AssetDB::CreateOrGetMeshGroup(const std::string& filepath)
 {
-	MeshGroup* group = AssetCollection<MeshGroup>::GetAsset(filepath);
-
-	if (group == nullptr)
-	{
-		MeshGroupBuilder mgb;
-		mgb.LoadFromObjFile(filepath);
-		group = mgb.CreateMeshGroup();
-		AssetCollection<MeshGroup>::AddAsset(filepath, group);
-	}
-
-	return group;
+	FindOrLoadMeshGroup(filepath);
+	return AssetCollection<MeshGroup>::GetAsset(filepath);
 }
 
 
 //-----------------------------------------------------------------------------------------------
 // Returns the Shader given by filename, returning null if it doesn't exist
 //
-Shader* AssetDB::GetShader(const std::string& name)
+Shader* AssetDB::GetShader(StringID name)
 {
 	return AssetCollection<Shader>::GetAsset(name);
 }
@@ -558,7 +715,14 @@ Shader* AssetDB::CreateOrGetShader(const std::string& shaderPath)
 	if (shader == nullptr)
 	{
 		shader = new Shader(shaderPath);
-		AssetCollection<Shader>::AddAsset(shaderPath, shader);
+
+		if (!AssetCollection<Shader>::AddAsset(shaderPath, shader))
+		{
+			delete shader;
+			return AssetCollection<Shader>::GetAsset(shaderPath);
+		}
+
+		TrackShaderSources(shaderPath, shader);
 	}
 
 	return shader;
@@ -570,14 +734,13 @@ Shader* AssetDB::CreateOrGetShader(const std::string& shaderPath)
 //
 void AssetDB::ReloadShaderPrograms()
 {
-	// Get an iterator over the shader collection
-	std::map<std::string, Shader*> shaders = AssetCollection<Shader>::s_collection;
-	std::map<std::string, Shader*>::iterator shaderItr = shaders.begin();
+	std::vector<Shader*> shaders;
+	AssetCollection<Shader>::GetAllAssets(shaders);
 
-	for(shaderItr; shaderItr != shaders.end(); shaderItr++)
+	for (int shaderIndex = 0; shaderIndex < (int) shaders.size(); ++shaderIndex)
 	{
 		// Check to ensure that we don't attempt to load a built-in shader
-		ShaderProgram* currProgram = shaderItr->second->GetProgram();
+		ShaderProgram* currProgram = shaders[shaderIndex]->GetProgram();
 		if (currProgram->WasBuiltFromSource())
 		{
 			continue;
@@ -594,7 +757,7 @@ void AssetDB::ReloadShaderPrograms()
 //-----------------------------------------------------------------------------------------------
 // Returns the shared material given by name, or nullptr if it doesn't exist
 //
-Material* AssetDB::GetSharedMaterial(const std::string& name)
+Material* AssetDB::GetSharedMaterial(StringID name)
 {
 	Material* material = AssetCollection<Material>::GetAsset(name);
 	return material;
@@ -637,8 +800,1088 @@ Material* AssetDB::CreateOrGetSharedMaterial(const std::string& materialPath)
 			return nullptr;
 		}
 
-		AssetCollection<Material>::AddAsset(materialPath, material);
+		if (!AssetCollection<Material>::AddAsset(materialPath, material))
+		{
+			delete material;
+			return AssetCollection<Material>::GetAsset(materialPath);
+		}
+
+		TrackHotReloadSource(materialPath, HOT_RELOAD_MATERIAL, materialPath);
 	}
 
 	return material;
 }
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the Texture given by filepath, starting a load on a disk worker if it doesn't exist
+// The texture returned shows the default texture until FinalizeAsyncLoads() uploads the real one into it
+//
+Texture* AssetDB::CreateOrGetTextureAsync(const std::string& filepath, bool generateMipMaps /*= false*/, bool useCompressedCache /*= false*/)
+{
+	FindOrStartTextureLoad(filepath, generateMipMaps, useCompressedCache);
+	return AssetCollection<Texture>::GetAsset(filepath);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the Mesh Group given by filepath, starting a load on a disk worker if it doesn't exist
+// The group returned is empty until FinalizeAsyncLoads() adds the meshes to it
+//
+MeshGroup* AssetDB::CreateOrGetMeshGroupAsync(const std::string& filepath)
+{
+	FindOrStartMeshGroupLoad(filepath);
+	return AssetCollection<MeshGroup>::GetAsset(filepath);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the asset at filepath was loaded async and hasn't been uploaded yet
+//
+bool AssetDB::IsAssetLoading(const std::string& filepath)
+{
+	for (int loadIndex = 0; loadIndex < (int) s_loadsInFlight.size(); ++loadIndex)
+	{
+		if (s_loadsInFlight[loadIndex]->m_filepath == filepath)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of async loads that haven't been uploaded yet
+//
+int AssetDB::GetLoadingAssetCount()
+{
+	return (int) s_loadsInFlight.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets how long FinalizeAsyncLoads() may spend uploading each frame
+//
+void AssetDB::SetAsyncUploadBudget(float budgetSeconds)
+{
+	s_uploadBudgetSeconds = budgetSeconds;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Collects loads the workers have finished and uploads them in the order they finished, until the
+// frame's budget is spent - at least one is uploaded per call, so a large asset can't stall the queue
+//
+void AssetDB::FinalizeAsyncLoads()
+{
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	if (jobSystem != nullptr)
+	{
+		jobSystem->FinalizeAllFinishedJobsOfType(JOB_TYPE_ASSET_LOAD);
+	}
+
+	uint64_t startTime = GetPerformanceCounter();
+	int uploadCount = 0;
+
+	for (; uploadCount < (int) s_loadsReadyToUpload.size(); ++uploadCount)
+	{
+		float secondsElapsed = (float) TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - startTime);
+		if (uploadCount > 0 && secondsElapsed >= s_uploadBudgetSeconds)
+		{
+			break;
+		}
+
+		AsyncAssetLoad* load = s_loadsReadyToUpload[uploadCount];
+		load->UploadOnMainThread();
+
+		if (load->m_record != nullptr)
+		{
+			size_t cpuBytes = 0;
+			size_t gpuBytes = 0;
+			load->GetMemoryUsage(cpuBytes, gpuBytes);
+
+			load->m_setMemoryFunction(load->m_filepath, cpuBytes, gpuBytes);
+			load->m_record->ReleaseReference();
+		}
+
+		s_loadsInFlight.erase(std::find(s_loadsInFlight.begin(), s_loadsInFlight.end(), load));
+		delete load;
+	}
+
+	s_loadsReadyToUpload.erase(s_loadsReadyToUpload.begin(), s_loadsReadyToUpload.begin() + uploadCount);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Starts watching the directory for changes to files assets were made from, replacing any directory already watched
+//
+bool AssetDB::EnableHotReload(const std::string& directory /*= "Data"*/, bool usePolling /*= false*/)
+{
+	if (s_hotReloadWatcher == nullptr)
+	{
+		s_hotReloadWatcher = new FileWatcher();
+	}
+
+	if (!s_hotReloadWatcher->Start(directory, usePolling))
+	{
+		DisableHotReload();
+		return false;
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Stops watching for changes, assets already reloading still finish
+//
+void AssetDB::DisableHotReload()
+{
+	if (s_hotReloadWatcher != nullptr)
+	{
+		delete s_hotReloadWatcher;
+		s_hotReloadWatcher = nullptr;
+	}
+
+	s_deferredReloads.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if a directory is being watched for changes
+//
+bool AssetDB::IsHotReloadEnabled()
+{
+	return (s_hotReloadWatcher != nullptr);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Reloads the assets of every file that changed since the last call
+// Textures and meshes are read on disk workers and swapped in by FinalizeAsyncLoads() at a later frame start,
+// shaders, materials and sprite sheets are small enough to just re-parse here, between frames
+//
+void AssetDB::ReloadChangedAssets()
+{
+	std::vector<std::string> changedFiles;
+	changedFiles.swap(s_deferredReloads);
+
+	if (s_hotReloadWatcher != nullptr)
+	{
+		s_hotReloadWatcher->GetChangedFiles(changedFiles);
+	}
+
+	if (changedFiles.size() > 0)
+	{
+		ReloadAssetsFromFiles(changedFiles);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Reloads every asset that was made from one of the files, whether or not they changed, returning the number reloaded
+// Files with a load in flight are put off to the next ReloadChangedAssets(), since that load would finish
+// after the reload and put the old data back
+//
+int AssetDB::ReloadAssetsFromFiles(const std::vector<std::string>& filepaths)
+{
+	std::vector<HotReloadSource_t> sources;
+
+	{
+		std::lock_guard<std::mutex> lock(s_hotReloadSourceLock);
+
+		for (int fileIndex = 0; fileIndex < (int) filepaths.size(); ++fileIndex)
+		{
+			std::map<std::string, std::vector<HotReloadSource_t>>::const_iterator itr = s_hotReloadSources.find(PackFile::NormalizePath(filepaths[fileIndex].c_str()));
+
+			if (itr == s_hotReloadSources.end())
+			{
+				continue;
+			}
+
+			for (int sourceIndex = 0; sourceIndex < (int) itr->second.size(); ++sourceIndex)
+			{
+				const HotReloadSource_t& source = itr->second[sourceIndex];
+
+				if (IsAssetLoading(source.assetName))
+				{
+					if (std::find(s_deferredReloads.begin(), s_deferredReloads.end(), filepaths[fileIndex]) == s_deferredReloads.end())
+					{
+						s_deferredReloads.push_back(filepaths[fileIndex]);
+					}
+
+					continue;
+				}
+
+				// A shader's XML and GLSL saved together only needs the one reload
+				bool isDuplicate = false;
+				for (int existingIndex = 0; existingIndex < (int) sources.size(); ++existingIndex)
+				{
+					if (sources[existingIndex].type == source.type && sources[existingIndex].assetName == source.assetName)
+					{
+						isDuplicate = true;
+						break;
+					}
+				}
+
+				if (!isDuplicate)
+				{
+					sources.push_back(source);
+				}
+			}
+		}
+	}
+
+	int reloadCount = 0;
+
+	for (int sourceIndex = 0; sourceIndex < (int) sources.size(); ++sourceIndex)
+	{
+		if (ReloadInPlace(sources[sourceIndex]))
+		{
+			ConsolePrintf(Rgba::GREEN, "Reloaded \"%s\"", sources[sourceIndex].assetName.c_str());
+			reloadCount++;
+		}
+	}
+
+	return reloadCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a handle to the image given by filepath, loading it if it doesn't exist
+//
+AssetHandle<Image> AssetDB::AcquireImage(const std::string& filepath)
+{
+	FindOrLoadImage(filepath);
+	return MakeHandle<Image>(filepath);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a handle to the texture given by filepath, loading it if it doesn't exist
+//
+AssetHandle<Texture> AssetDB::AcquireTexture(const std::string& filepath, bool generateMipMaps /*= false*/, bool useCompressedCache /*= false*/)
+{
+	FindOrLoadTexture(filepath, generateMipMaps, false, useCompressedCache);
+	return MakeHandle<Texture>(filepath);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a handle to the texture given by filepath, starting a load on a disk worker if it doesn't exist
+//
+AssetHandle<Texture> AssetDB::AcquireTextureAsync(const std::string& filepath, bool generateMipMaps /*= false*/, bool useCompressedCache /*= false*/)
+{
+	FindOrStartTextureLoad(filepath, generateMipMaps, useCompressedCache);
+	return MakeHandle<Texture>(filepath);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a handle to the mesh group given by filepath, loading it if it doesn't exist
+//
+AssetHandle<MeshGroup> AssetDB::AcquireMeshGroup(const std::string& filepath)
+{
+	FindOrLoadMeshGroup(filepath);
+	return MakeHandle<MeshGroup>(filepath);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a handle to the mesh group given by filepath, starting a load on a disk worker if it doesn't exist
+//
+AssetHandle<MeshGroup> AssetDB::AcquireMeshGroupAsync(const std::string& filepath)
+{
+	FindOrStartMeshGroupLoad(filepath);
+	return MakeHandle<MeshGroup>(filepath);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets the memory the AssetDB tries to stay under, 0 for no limit
+// The budget is soft - referenced and pinned assets are never evicted to meet it
+//
+void AssetDB::SetMemoryBudget(size_t cpuBudgetBytes, size_t gpuBudgetBytes)
+{
+	s_cpuBudgetBytes = cpuBudgetBytes;
+	s_gpuBudgetBytes = gpuBudgetBytes;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Evicts unreferenced assets, least recently used first, until the usage is back under budget
+// Only evicts assets that free memory in a pool that's over, so a CPU overage doesn't throw out textures
+//
+void AssetDB::EvictUnusedAssets()
+{
+	if (s_cpuBudgetBytes == 0 && s_gpuBudgetBytes == 0)
+	{
+		return;
+	}
+
+	std::vector<AssetMemoryUsage_t> usagePerType;
+	GetMemoryUsage(usagePerType);
+
+	size_t cpuBytes = 0;
+	size_t gpuBytes = 0;
+
+	for (int typeIndex = 0; typeIndex < (int) usagePerType.size(); ++typeIndex)
+	{
+		cpuBytes += usagePerType[typeIndex].cpuBytes;
+		gpuBytes += usagePerType[typeIndex].gpuBytes;
+	}
+
+	bool isOverCPUBudget = (s_cpuBudgetBytes > 0 && cpuBytes > s_cpuBudgetBytes);
+	bool isOverGPUBudget = (s_gpuBudgetBytes > 0 && gpuBytes > s_gpuBudgetBytes);
+
+	if (!isOverCPUBudget && !isOverGPUBudget)
+	{
+		return;
+	}
+
+	// Only types that can be acquired through handles can ever be unpinned
+	std::vector<AssetEvictionCandidate_t> candidates;
+	AssetCollection<Image>::GetEvictionCandidates(candidates);
+	AssetCollection<Texture>::GetEvictionCandidates(candidates);
+	AssetCollection<MeshGroup>::GetEvictionCandidates(candidates);
+
+	std::sort(candidates.begin(), candidates.end(), [](const AssetEvictionCandidate_t& a, const AssetEvictionCandidate_t& b)
+	{
+		return a.lastUsedTime < b.lastUsedTime;
+	});
+
+	for (int candidateIndex = 0; candidateIndex < (int) candidates.size() && (isOverCPUBudget || isOverGPUBudget); ++candidateIndex)
+	{
+		const AssetEvictionCandidate_t& candidate = candidates[candidateIndex];
+		bool freesOverBudgetMemory = (isOverCPUBudget && candidate.cpuBytes > 0) || (isOverGPUBudget && candidate.gpuBytes > 0);
+
+		if (freesOverBudgetMemory && candidate.evictFunction(candidate.nameHash))
+		{
+			cpuBytes -= candidate.cpuBytes;
+			gpuBytes -= candidate.gpuBytes;
+
+			isOverCPUBudget = (s_cpuBudgetBytes > 0 && cpuBytes > s_cpuBudgetBytes);
+			isOverGPUBudget = (s_gpuBudgetBytes > 0 && gpuBytes > s_gpuBudgetBytes);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the estimated memory used by each type of asset that has an estimate
+//
+void AssetDB::GetMemoryUsage(std::vector<AssetMemoryUsage_t>& out_usagePerType)
+{
+	AssetMemoryUsage_t imageUsage;
+	imageUsage.typeName = "Images";
+	AssetCollection<Image>::GetMemoryUsage(imageUsage.assetCount, imageUsage.cpuBytes, imageUsage.gpuBytes);
+	out_usagePerType.push_back(imageUsage);
+
+	AssetMemoryUsage_t textureUsage;
+	textureUsage.typeName = "Textures";
+	AssetCollection<Texture>::GetMemoryUsage(textureUsage.assetCount, textureUsage.cpuBytes, textureUsage.gpuBytes);
+	out_usagePerType.push_back(textureUsage);
+
+	AssetMemoryUsage_t textureCubeUsage;
+	textureCubeUsage.typeName = "Texture Cubes";
+	AssetCollection<TextureCube>::GetMemoryUsage(textureCubeUsage.assetCount, textureCubeUsage.cpuBytes, textureCubeUsage.gpuBytes);
+	out_usagePerType.push_back(textureCubeUsage);
+
+	AssetMemoryUsage_t meshUsage;
+	meshUsage.typeName = "Meshes";
+	AssetCollection<Mesh>::GetMemoryUsage(meshUsage.assetCount, meshUsage.cpuBytes, meshUsage.gpuBytes);
+	out_usagePerType.push_back(meshUsage);
+
+	AssetMemoryUsage_t meshGroupUsage;
+	meshGroupUsage.typeName = "Mesh Groups";
+	AssetCollection<MeshGroup>::GetMemoryUsage(meshGroupUsage.assetCount, meshGroupUsage.cpuBytes, meshGroupUsage.gpuBytes);
+	out_usagePerType.push_back(meshGroupUsage);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the image given by the filepath, loading it unpinned if it doesn't exist
+//
+Image* AssetDB::FindOrLoadImage(const std::string& filepath)
+{
+	Image* img = AssetCollection<Image>::FindAsset(filepath);
+
+	if (img == nullptr)
+	{
+		img = new Image();
+		bool successful = img->LoadFromFile(filepath);
+
+		// Don't put nullptr in the AssetDB - allows for image reloading if failed
+		if (!successful)
+		{
+			delete img;
+			return nullptr;
+		}
+
+		// Another thread may have added it while this one was loading, so keep theirs
+		if (!AssetCollection<Image>::AddAsset(filepath, img, false))
+		{
+			delete img;
+			return AssetCollection<Image>::FindAsset(filepath);
+		}
+
+		AssetCollection<Image>::SetAssetMemory(filepath, GetImageMemorySize(img), 0);
+	}
+
+	return img;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the texture given by the filepath, loading it unpinned if it doesn't exist
+// Uses the AssetDB's copy of the image if there is one, otherwise the texture's load frees its own after the upload
+//
+Texture* AssetDB::FindOrLoadTexture(const std::string& filepath, bool generateMipMaps, bool retainImage, bool useCompressedCache)
+{
+	Texture* texture = AssetCollection<Texture>::FindAsset(filepath);
+
+	if (texture == nullptr)
+	{
+		texture = new Texture();
+		bool successful = false;
+
+		// Retained images are pinned, they were asked for as raw pointers
+		if (retainImage && FindOrLoadImage(filepath) != nullptr)
+		{
+			AssetCollection<Image>::GetAsset(filepath);
+		}
+
+		// Referenced so it can't be evicted during the upload
+		AssetRecord_t* imageRecord = AssetCollection<Image>::AcquireAsset(filepath);
+
+		if (imageRecord != nullptr)
+		{
+			// The image is shared, so it's flipped into a copy for the upload rather than in place
+			Image* uploadImage = CreateFlippedCopy(static_cast<const Image*>(imageRecord->asset));
+			texture->CreateFromImage(uploadImage, generateMipMaps);
+
+			delete uploadImage;
+			imageRecord->ReleaseReference();
+			successful = true;
+		}
+		else
+		{
+			successful = texture->CreateFromFile(filepath, generateMipMaps, useCompressedCache);
+		}
+		
+		if (!successful)
+		{
+			delete texture;
+			return nullptr;
+		}
+
+		if (!AssetCollection<Texture>::AddAsset(filepath, texture, false))
+		{
+			delete texture;
+			return AssetCollection<Texture>::FindAsset(filepath);
+		}
+
+		AssetCollection<Texture>::SetAssetMemory(filepath, 0, texture->GetGPUMemorySize());
+		TrackHotReloadSource(filepath, HOT_RELOAD_TEXTURE, filepath, generateMipMaps, useCompressedCache);
+	}
+
+	return texture;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the texture given by the filepath, adding an unpinned placeholder and starting its load if it doesn't exist
+//
+Texture* AssetDB::FindOrStartTextureLoad(const std::string& filepath, bool generateMipMaps, bool useCompressedCache)
+{
+	Texture* texture = AssetCollection<Texture>::FindAsset(filepath);
+
+	if (texture == nullptr)
+	{
+		texture = new Texture();
+		texture->CreateFromImage(&Image::IMAGE_DEFAULT_TEXTURE);
+
+		// Someone else's load is already running if this loses
+		if (!AssetCollection<Texture>::AddAsset(filepath, texture, false))
+		{
+			delete texture;
+			return AssetCollection<Texture>::FindAsset(filepath);
+		}
+
+		AssetCollection<Texture>::SetAssetMemory(filepath, 0, texture->GetGPUMemorySize());
+
+		AsyncTextureLoad* load = new AsyncTextureLoad(filepath, texture, generateMipMaps, useCompressedCache);
+		load->m_record = AssetCollection<Texture>::AcquireAsset(filepath);
+		load->m_setMemoryFunction = &AssetCollection<Texture>::SetAssetMemory;
+
+		StartAsyncLoad(load);
+		TrackHotReloadSource(filepath, HOT_RELOAD_TEXTURE, filepath, generateMipMaps, useCompressedCache);
+	}
+
+	return texture;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the mesh group given by the filepath, loading it unpinned if it doesn't exist
+//
+MeshGroup* AssetDB::FindOrLoadMeshGroup(const std::string& filepath)
+{
+	MeshGroup* group = AssetCollection<MeshGroup>::FindAsset(filepath);
+
+	if (group == nullptr)
+	{
+		// Same steps as the async load, just run back to back here
+		group = new MeshGroup();
+
+		AsyncMeshGroupLoad load(filepath, group);
+		load.LoadOnWorker();
+		load.UploadOnMainThread();
+
+		if (!AssetCollection<MeshGroup>::AddAsset(filepath, group, false))
+		{
+			delete group;
+			return AssetCollection<MeshGroup>::FindAsset(filepath);
+		}
+
+		AssetCollection<MeshGroup>::SetAssetMemory(filepath, 0, GetMeshGroupGPUMemorySize(group));
+		TrackHotReloadSource(filepath, HOT_RELOAD_MESH_GROUP, filepath);
+	}
+
+	return group;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the mesh group given by the filepath, adding an unpinned empty group and starting its load if it doesn't exist
+//
+MeshGroup* AssetDB::FindOrStartMeshGroupLoad(const std::string& filepath)
+{
+	MeshGroup* group = AssetCollection<MeshGroup>::FindAsset(filepath);
+
+	if (group == nullptr)
+	{
+		group = new MeshGroup();
+
+		// Someone else's load is already running if this loses
+		if (!AssetCollection<MeshGroup>::AddAsset(filepath, group, false))
+		{
+			delete group;
+			return AssetCollection<MeshGroup>::FindAsset(filepath);
+		}
+
+		AsyncMeshGroupLoad* load = new AsyncMeshGroupLoad(filepath, group);
+		load->m_record = AssetCollection<MeshGroup>::AcquireAsset(filepath);
+		load->m_setMemoryFunction = &AssetCollection<MeshGroup>::SetAssetMemory;
+
+		StartAsyncLoad(load);
+		TrackHotReloadSource(filepath, HOT_RELOAD_MESH_GROUP, filepath);
+	}
+
+	return group;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a handle holding a new reference to the asset, or an invalid handle if it doesn't exist
+//
+template <typename RESOURCETYPE>
+AssetHandle<RESOURCETYPE> AssetDB::MakeHandle(StringID name)
+{
+	AssetRecord_t* record = AssetCollection<RESOURCETYPE>::AcquireAsset(name);
+
+	if (record == nullptr)
+	{
+		return AssetHandle<RESOURCETYPE>();
+	}
+
+	return AssetHandle<RESOURCETYPE>(static_cast<RESOURCETYPE*>(record->asset), record);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Reloads the asset in place, returning false if it was evicted since or couldn't be reloaded
+// Textures and meshes only start their load here, they change when FinalizeAsyncLoads() uploads them
+//
+bool AssetDB::ReloadInPlace(const HotReloadSource_t& source)
+{
+	switch (source.type)
+	{
+	case HOT_RELOAD_TEXTURE:
+	{
+		AssetRecord_t* record = AssetCollection<Texture>::AcquireAsset(source.assetName);
+		if (record == nullptr)
+		{
+			return false;
+		}
+
+		AsyncTextureLoad* load = new AsyncTextureLoad(source.assetName, static_cast<Texture*>(record->asset), source.useMipMaps, source.useCompressedCache);
+		load->m_record = record;
+		load->m_setMemoryFunction = &AssetCollection<Texture>::SetAssetMemory;
+
+		StartAsyncLoad(load);
+		return true;
+	}
+	case HOT_RELOAD_MESH:
+	{
+		AssetRecord_t* record = AssetCollection<Mesh>::AcquireAsset(source.assetName);
+		if (record == nullptr)
+		{
+			return false;
+		}
+
+		AsyncMeshLoad* load = new AsyncMeshLoad(source.assetName, static_cast<Mesh*>(record->asset));
+		load->m_record = record;
+		load->m_setMemoryFunction = &AssetCollection<Mesh>::SetAssetMemory;
+
+		StartAsyncLoad(load);
+		return true;
+	}
+	case HOT_RELOAD_MESH_GROUP:
+	{
+		AssetRecord_t* record = AssetCollection<MeshGroup>::AcquireAsset(source.assetName);
+		if (record == nullptr)
+		{
+			return false;
+		}
+
+		AsyncMeshGroupLoad* load = new AsyncMeshGroupLoad(source.assetName, static_cast<MeshGroup*>(record->asset));
+		load->m_record = record;
+		load->m_setMemoryFunction = &AssetCollection<MeshGroup>::SetAssetMemory;
+		load->m_isReload = true;
+
+		StartAsyncLoad(load);
+		return true;
+	}
+	case HOT_RELOAD_SHADER:
+	{
+		Shader* shader = AssetCollection<Shader>::FindAsset(source.assetName);
+		if (shader == nullptr || !shader->ReloadFromFile(source.assetName))
+		{
+			return false;
+		}
+
+		// The XML may point at different GLSL files now
+		TrackShaderSources(source.assetName, shader);
+		return true;
+	}
+	case HOT_RELOAD_MATERIAL:
+	{
+		// Material instances are copies, so ones made before the change keep the old values
+		Material* material = AssetCollection<Material>::FindAsset(source.assetName);
+		return (material != nullptr && material->LoadFromFile(source.assetName));
+	}
+	case HOT_RELOAD_SPRITESHEET:
+	{
+		SpriteSheet* spritesheet = AssetCollection<SpriteSheet>::FindAsset(source.assetName);
+		return (spritesheet != nullptr && spritesheet->ReloadFromFile(source.assetName));
+	}
+	default:
+		return false;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Prints the estimated memory used by each asset type, and the budget
+//
+static void Command_AssetMemory(Command& cmd)
+{
+	UNUSED(cmd);
+
+	std::vector<AssetMemoryUsage_t> usagePerType;
+	AssetDB::GetMemoryUsage(usagePerType);
+
+	for (int typeIndex = 0; typeIndex < (int) usagePerType.size(); ++typeIndex)
+	{
+		const AssetMemoryUsage_t& usage = usagePerType[typeIndex];
+		ConsolePrintf("%s: %i assets, %.2f MB CPU, %.2f MB GPU", usage.typeName, usage.assetCount, (float) usage.cpuBytes / (1024.f * 1024.f), (float) usage.gpuBytes / (1024.f * 1024.f));
+	}
+
+	ConsolePrintf(Rgba::GREEN, "Budget: %.2f MB CPU, %.2f MB GPU (0 is no limit)", (float) s_cpuBudgetBytes / (1024.f * 1024.f), (float) s_gpuBudgetBytes / (1024.f * 1024.f));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Turns hot reload on or off, toggling it if -e isn't given
+//
+static void Command_HotReload(Command& cmd)
+{
+	bool enable = !AssetDB::IsHotReloadEnabled();
+	cmd.GetParam("e", enable, &enable);
+
+	std::string directory = "Data";
+	cmd.GetParam("d", directory, &directory);
+
+	if (!enable)
+	{
+		AssetDB::DisableHotReload();
+		ConsolePrintf(Rgba::GREEN, "Hot reload disabled");
+	}
+	else if (AssetDB::EnableHotReload(directory))
+	{
+		ConsolePrintf(Rgba::GREEN, "Hot reloading assets under \"%s\"", directory.c_str());
+	}
+	else
+	{
+		ConsoleErrorf("Couldn't watch \"%s\" for changes", directory.c_str());
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Reloads the assets made from the given file
+//
+static void Command_AssetReload(Command& cmd)
+{
+	std::string filepath;
+	if (!cmd.GetParam("f", filepath))
+	{
+		ConsoleErrorf("No file specified, use -f <filepath>");
+		return;
+	}
+
+	std::vector<std::string> filepaths;
+	filepaths.push_back(filepath);
+
+	if (AssetDB::ReloadAssetsFromFiles(filepaths) == 0)
+	{
+		ConsoleWarningf("No loaded assets were made from \"%s\"", filepath.c_str());
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Registers the AssetDB's console commands
+//
+void AssetDB::InitializeConsoleCommands()
+{
+	Command::Register("asset_memory", "Prints the estimated memory used by each type of asset", Command_AssetMemory);
+	Command::Register("hot_reload", "Turns reloading assets when their files change on or off with -e, watching directory -d", Command_HotReload);
+	Command::Register("asset_reload", "Reloads every asset made from file -f", Command_AssetReload);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Reads the compressed cache or decodes the image, doing everything but the upload so the main thread only copies it to the GPU
+//
+void AsyncTextureLoad::LoadOnWorker()
+{
+	Texture::LoadFileForUpload(m_filepath, m_useMipMaps, m_useCompressedCache, m_image, m_compressedImage);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Replaces the placeholder with the loaded data, a failed load keeps the placeholder
+// The data is only needed for the upload, so it isn't kept in the AssetDB
+//
+void AsyncTextureLoad::UploadOnMainThread()
+{
+	if (m_compressedImage != nullptr)
+	{
+		m_texture->CreateFromCompressedImage(m_compressedImage, m_useMipMaps);
+
+		delete m_compressedImage;
+		m_compressedImage = nullptr;
+	}
+	else if (m_image != nullptr)
+	{
+		m_texture->CreateFromImage(m_image, m_useMipMaps);
+
+		delete m_image;
+		m_image = nullptr;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the estimated memory the texture uses, now that the image is uploaded and freed
+//
+void AsyncTextureLoad::GetMemoryUsage(size_t& out_cpuBytes, size_t& out_gpuBytes) const
+{
+	out_cpuBytes = 0;
+	out_gpuBytes = m_texture->GetGPUMemorySize();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Reads the bake if it was made from the OBJ as it is now with the current load options, otherwise parses
+// the OBJ and adds the meshes to the bake
+//
+void AsyncMeshGroupLoad::LoadOnWorker()
+{
+	m_bakeKey = (MeshBuilder::IsOptimizeOnLoadEnabled() ? 1 : 0);
+	m_isBakeValid = m_bake.Open(m_filepath) && m_bake.HasMeshes(m_bakeKey);
+
+	if (!m_isBakeValid)
+	{
+		m_builder.LoadFromObjFile(m_filepath);
+
+		m_bake.BeginMeshSection(m_bakeKey);
+		for (int builderIndex = 0; builderIndex < m_builder.GetMeshBuilderCount(); ++builderIndex)
+		{
+			m_bake.AddMesh(*m_builder.GetMeshBuilder(builderIndex), false);
+		}
+		m_bake.EndMeshSection();
+		m_bake.Save();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Creates the meshes, straight from the bake's data if it was valid
+//
+void AsyncMeshGroupLoad::UploadOnMainThread()
+{
+	if (m_isReload)
+	{
+		// A bake that's still valid was made from the OBJ as it is now, so it was saved without changing
+		if (!m_isBakeValid)
+		{
+			UpdateMeshesInPlace();
+		}
+
+		m_bake.Close();
+		return;
+	}
+
+	std::vector<Mesh*> meshes;
+
+	if (!m_isBakeValid || !m_bake.ReadMeshes(m_bakeKey, meshes))
+	{
+		for (int builderIndex = 0; builderIndex < m_builder.GetMeshBuilderCount(); ++builderIndex)
+		{
+			meshes.push_back(m_builder.GetMeshBuilder(builderIndex)->CreateMesh<VertexLit>());
+		}
+	}
+
+	for (int meshIndex = 0; meshIndex < (int) meshes.size(); ++meshIndex)
+	{
+		m_group->AddMeshUnique(meshes[meshIndex]);
+	}
+
+	m_bake.Close();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Rebuilds the group's meshes from the parsed OBJ, reusing the Mesh objects so anything pointing at them sees the change
+// Meshes the OBJ no longer has are emptied rather than removed, since something may still be drawing them
+//
+void AsyncMeshGroupLoad::UpdateMeshesInPlace()
+{
+	int builderCount = m_builder.GetMeshBuilderCount();
+
+	// Nothing parsed, likely a bad save - keep what's there
+	if (builderCount == 0)
+	{
+		return;
+	}
+
+	for (int builderIndex = 0; builderIndex < builderCount; ++builderIndex)
+	{
+		const MeshBuilder* builder = m_builder.GetMeshBuilder(builderIndex);
+
+		if (builderIndex < m_group->GetMeshCount())
+		{
+			builder->UpdateMesh<VertexLit>(*m_group->GetMesh(builderIndex));
+		}
+		else
+		{
+			m_group->AddMeshUnique(builder->CreateMesh<VertexLit>());
+		}
+	}
+
+	MeshBuilder emptyBuilder;
+	for (int meshIndex = builderCount; meshIndex < m_group->GetMeshCount(); ++meshIndex)
+	{
+		emptyBuilder.UpdateMesh<VertexLit>(*m_group->GetMesh(meshIndex));
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the estimated memory the group's meshes use
+//
+void AsyncMeshGroupLoad::GetMemoryUsage(size_t& out_cpuBytes, size_t& out_gpuBytes) const
+{
+	out_cpuBytes = 0;
+	out_gpuBytes = GetMeshGroupGPUMemorySize(m_group);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses and optimizes the OBJ the same way CreateOrGetMesh() does
+//
+void AsyncMeshLoad::LoadOnWorker()
+{
+	m_builder.LoadFromObjFile(m_filepath);
+
+	if (m_builder.GetVertexCount() > 0 && MeshBuilder::IsOptimizeOnLoadEnabled())
+	{
+		m_builder.Optimize();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Replaces the mesh's buffers, keeping the old ones if nothing could be parsed
+//
+void AsyncMeshLoad::UploadOnMainThread()
+{
+	if (m_builder.GetVertexCount() > 0)
+	{
+		m_builder.UpdateMesh<VertexLit>(*m_mesh);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the estimated memory the mesh's buffers use
+//
+void AsyncMeshLoad::GetMemoryUsage(size_t& out_cpuBytes, size_t& out_gpuBytes) const
+{
+	out_cpuBytes = 0;
+	out_gpuBytes = GetMeshGPUMemorySize(m_mesh);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Does the load's file reading and decoding
+//
+void AssetLoadJob::Execute()
+{
+	m_load->LoadOnWorker();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Called on the main thread once the job finishes, queues the load for upload
+//
+void AssetLoadJob::Finalize()
+{
+	s_loadsReadyToUpload.push_back(m_load);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Queues the load on a disk worker, or does the worker half now if there isn't a thread that can take it
+// Only one worker is needed either way - the mip, compress and OBJ parse stages run inline in the load's job
+//
+static void StartAsyncLoad(AsyncAssetLoad* load)
+{
+	s_loadsInFlight.push_back(load);
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	if (jobSystem != nullptr && jobSystem->GetWorkerThreadCount(WORKER_FLAGS_DISK) > 0)
+	{
+		QueueJob(new AssetLoadJob(load));
+	}
+	else
+	{
+		load->LoadOnWorker();
+		s_loadsReadyToUpload.push_back(load);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Records that the asset was made from the file, so hot reload knows what to reload when it changes
+//
+static void TrackHotReloadSource(const std::string& sourcePath, HotReloadType type, const std::string& assetName, bool useMipMaps /*= false*/, bool useCompressedCache /*= false*/)
+{
+	std::lock_guard<std::mutex> lock(s_hotReloadSourceLock);
+	std::vector<HotReloadSource_t>& sources = s_hotReloadSources[PackFile::NormalizePath(sourcePath.c_str())];
+
+	// Assets evicted and loaded again are already here
+	for (int sourceIndex = 0; sourceIndex < (int) sources.size(); ++sourceIndex)
+	{
+		if (sources[sourceIndex].type == type && sources[sourceIndex].assetName == assetName)
+		{
+			sources[sourceIndex].useMipMaps = useMipMaps;
+			sources[sourceIndex].useCompressedCache = useCompressedCache;
+			return;
+		}
+	}
+
+	HotReloadSource_t source;
+	source.type = type;
+	source.assetName = assetName;
+	source.useMipMaps = useMipMaps;
+	source.useCompressedCache = useCompressedCache;
+
+	sources.push_back(source);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Tracks the shader's XML and the GLSL files its program was compiled from, so a change to any reloads it
+//
+static void TrackShaderSources(const std::string& shaderPath, Shader* shader)
+{
+	TrackHotReloadSource(shaderPath, HOT_RELOAD_SHADER, shaderPath);
+
+	ShaderProgram* program = shader->GetProgram();
+	if (program != nullptr && !program->WasBuiltFromSource())
+	{
+		TrackHotReloadSource(program->GetVSFilePathOrSource(), HOT_RELOAD_SHADER, shaderPath);
+		TrackHotReloadSource(program->GetFSFilePathOrSource(), HOT_RELOAD_SHADER, shaderPath);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the bytes of the image's texel data
+//
+static size_t GetImageMemorySize(const Image* image)
+{
+	IntVector2 dimensions = image->GetTexelDimensions();
+	return (size_t) dimensions.x * (size_t) dimensions.y * (size_t) image->GetNumComponentsPerTexel();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a copy of the image's texels flipped for a texture upload, which the caller owns
+//
+static Image* CreateFlippedCopy(const Image* image)
+{
+	size_t byteCount = GetImageMemorySize(image);
+	unsigned char* imageData = (unsigned char*)malloc(byteCount);
+	memcpy(imageData, image->GetImageData(), byteCount);
+
+	Image* copy = new Image(image->GetTexelDimensions(), image->GetNumComponentsPerTexel(), imageData);
+
+	if (!image->IsFlippedForTextures())
+	{
+		copy->FlipVertical();
+	}
+
+	return copy;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the bytes of the mesh's vertex and index buffers
+//
+static size_t GetMeshGPUMemorySize(const Mesh* mesh)
+{
+	return mesh->GetVertexBuffer()->GetSize() + mesh->GetIndexBuffer()->GetSize();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the bytes of the buffers of every mesh in the group
+//
+static size_t GetMeshGroupGPUMemorySize(const MeshGroup* group)
+{
+	size_t totalBytes = 0;
+
+	for (int meshIndex = 0; meshIndex < group->GetMeshCount(); ++meshIndex)
+	{
+		totalBytes += GetMeshGPUMemorySize(group->GetMesh(meshIndex));
+	}
+
+	return totalBytes;
+}
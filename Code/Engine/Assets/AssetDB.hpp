@@ -8,6 +8,8 @@
 #pragma once
 #include <vector>
 #include <string>
+#include "Engine/Assets/AssetHandle.hpp"
+#include "Engine/Core/Utility/StringID.hpp"
 
 class Mesh;
 class Image;
@@ -23,6 +25,16 @@ class TextureCube;
 class Skeleton;
 class ShaderProgram;
 class MaterialInstance;
+struct HotReloadSource_t;
+
+// Estimated memory used by one type of asset
+struct AssetMemoryUsage_t
+{
+	const char*	typeName = nullptr;
+	int			assetCount = 0;
+	size_t		cpuBytes = 0;
+	size_t		gpuBytes = 0;
+};
 
 class AssetDB
 {
@@ -35,50 +47,110 @@ public:
 		static void CreateMaterials();
 		static void CreateMeshes();
 
-	// Images
-	static Image* GetImage(const std::string& filename);
+	// Assets returned as raw pointers are pinned, since there's no telling when the pointer is let go of
+	// Only assets that are only ever acquired through handles can be evicted
+
+	// Images - textures don't keep the image they were made from unless retainImage is set, or it was already loaded here
+	static Image* GetImage(StringID filename);
 	static Image* CreateOrGetImage(const std::string& filename);
 
 	// Textures
-	static Texture* GetTexture(const std::string& filename);
-	static Texture* CreateOrGetTexture(const std::string& filename, bool generateMipMaps = false);
+	static Texture* GetTexture(StringID filename);
+	// useCompressedCache opts in to lossy block compression, cached next to the file - the image isn't compressed if it's retained
+	static Texture* CreateOrGetTexture(const std::string& filename, bool generateMipMaps = false, bool retainImage = false, bool useCompressedCache = false);
 	
 	// Texture Cubes
-	static TextureCube* GetTextureCube(const std::string& filename);
+	static TextureCube* GetTextureCube(StringID filename);
 	static TextureCube* CreateOrGetTextureCube(const std::string& filename);
 
 	// Skyboxes
-	static Skybox* GetSkybox(const std::string& textureName);
+	static Skybox* GetSkybox(StringID textureName);
 	static Skybox* CreateOrGetSkybox(const std::string& textureName);
 
 	// SpriteSheets
-	static SpriteSheet* GetSpriteSheet(const std::string& name);
+	static SpriteSheet* GetSpriteSheet(StringID name);
 	static SpriteSheet* CreateOrGetSpriteSheet(const std::string& name);
 
 	// Fonts
-	static BitmapFont* GetBitmapFont(const std::string& filename);
+	static BitmapFont* GetBitmapFont(StringID filename);
 	static BitmapFont* CreateOrGetBitmapFont(const std::string& filename);
 
 	// Meshes
-	static Mesh*	GetMesh(const std::string& filename);
+	static Mesh*	GetMesh(StringID filename);
 	static Mesh*	CreateOrGetMesh(const std::string& filename);
 	static void		AddMesh(const std::string& name, Mesh* mesh);
 
 	// Mesh Groups
-	static MeshGroup* GetMeshGroup(const std::string& filename);
+	static MeshGroup* GetMeshGroup(StringID filename);
 	static MeshGroup* CreateOrGetMeshGroup(const std::string& filename);
 
 	// Shaders
-	static Shader*	GetShader(const std::string& name);
+	static Shader*	GetShader(StringID name);
 	static Shader*	CreateOrGetShader(const std::string& name);
 	static void		ReloadShaderPrograms();
 	
 
 	// Material
-	static Material*			GetSharedMaterial(const std::string& name);
+	static Material*			GetSharedMaterial(StringID name);
 	static MaterialInstance*	CreateMaterialInstance(const std::string& name);
 	static Material*			CreateOrGetSharedMaterial(const std::string& name);
 
+	// Async loading - file reads and decoding run on disk workers, and the asset returned right away is a
+	// placeholder that FinalizeAsyncLoads() fills in place, so it can be drawn with before the load finishes
+	static Texture*		CreateOrGetTextureAsync(const std::string& filename, bool generateMipMaps = false, bool useCompressedCache = false);
+	static MeshGroup*	CreateOrGetMeshGroupAsync(const std::string& filename);
+
+	static bool			IsAssetLoading(const std::string& filename);
+	static int			GetLoadingAssetCount();
+
+	// Uploads finished loads on the main thread, called by the Renderer at the start of each frame
+	static void			FinalizeAsyncLoads();
+	static void			SetAsyncUploadBudget(float budgetSeconds);
+
+	// Handles - the asset can be evicted once every handle to it is released, if it was never handed out as a raw pointer
+	static AssetHandle<Image>		AcquireImage(const std::string& filename);
+	static AssetHandle<Texture>		AcquireTexture(const std::string& filename, bool generateMipMaps = false, bool useCompressedCache = false);
+	static AssetHandle<Texture>		AcquireTextureAsync(const std::string& filename, bool generateMipMaps = false, bool useCompressedCache = false);
+	static AssetHandle<MeshGroup>	AcquireMeshGroup(const std::string& filename);
+	static AssetHandle<MeshGroup>	AcquireMeshGroupAsync(const std::string& filename);
+
+	// Hot reload - assets are reloaded in place when a file they were made from changes under the watched directory,
+	// so pointers and handles to them stay valid. Pass usePolling to compare write times instead of using OS notifications
+	static bool			EnableHotReload(const std::string& directory = "Data", bool usePolling = false);
+	static void			DisableHotReload();
+	static bool			IsHotReloadEnabled();
+	static void			ReloadChangedAssets();	// Called by the Renderer at the start of each frame, before the async uploads
+	static int			ReloadAssetsFromFiles(const std::vector<std::string>& filepaths);
+
+	// Memory budget - 0 means no limit, unreferenced assets are evicted least recently used first to stay under it
+	static void			SetMemoryBudget(size_t cpuBudgetBytes, size_t gpuBudgetBytes);
+	static void			EvictUnusedAssets();	// Called by the Renderer each frame, after the async uploads
+	static void			GetMemoryUsage(std::vector<AssetMemoryUsage_t>& out_usagePerType);
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr float DEFAULT_UPLOAD_BUDGET_SECONDS = 0.002f;
+
+
+private:
+	//-----Private Methods-----
+
+	// Shared by the raw pointer and handle versions, these add assets unpinned
+	static Image*		FindOrLoadImage(const std::string& filepath);
+	static Texture*		FindOrLoadTexture(const std::string& filepath, bool generateMipMaps, bool retainImage, bool useCompressedCache);
+	static Texture*		FindOrStartTextureLoad(const std::string& filepath, bool generateMipMaps, bool useCompressedCache);
+	static MeshGroup*	FindOrLoadMeshGroup(const std::string& filepath);
+	static MeshGroup*	FindOrStartMeshGroupLoad(const std::string& filepath);
+
+	template <typename RESOURCETYPE>
+	static AssetHandle<RESOURCETYPE> MakeHandle(StringID name);
+
+	static bool			ReloadInPlace(const HotReloadSource_t& source);
+
+	static void			InitializeConsoleCommands();
+
 
 private:
 	//-----Private Data-----
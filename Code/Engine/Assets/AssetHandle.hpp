@@ -0,0 +1,168 @@
+/************************************************************************/
+/* File: AssetHandle.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Reference-counted handle to an asset in the AssetDB, assets
+/*				with no handles left can be evicted to stay under budget
+/************************************************************************/
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include "Engine/Core/Time/Time.hpp"
+
+// Bookkeeping the AssetDB keeps for every asset, owned by the asset's AssetCollection
+struct AssetRecord_t
+{
+	void*					asset = nullptr;
+	uint64_t				nameHash = 0;
+
+	std::atomic<int>		refCount{ 0 };
+	std::atomic<bool>		isPinned{ false };		// Handed out as a raw pointer, so it can never be known to be unused
+	std::atomic<uint64_t>	lastUsedTime{ 0 };		// Performance count of the last fetch, acquire or release, for LRU eviction
+
+	size_t					cpuBytes = 0;			// Estimates, written under the collection's lock
+	size_t					gpuBytes = 0;
+
+	// The timestamp is written first, since the record may be evicted as soon as the count hits 0
+	void AddReference()		{ lastUsedTime = GetPerformanceCounter(); refCount++; }
+	void ReleaseReference()	{ lastUsedTime = GetPerformanceCounter(); refCount--; }
+
+	// Only read when picking what to evict, so there's nothing to order against
+	void MarkUsed()			{ lastUsedTime.store(GetPerformanceCounter(), std::memory_order_relaxed); }
+};
+
+
+template <typename RESOURCETYPE>
+class AssetHandle
+{
+	friend class AssetDB;
+
+public:
+	//-----Public Methods-----
+
+	AssetHandle() {}
+	AssetHandle(const AssetHandle& copy);
+	AssetHandle(AssetHandle&& moved);
+	~AssetHandle();
+
+	AssetHandle& operator=(const AssetHandle& copy);
+	AssetHandle& operator=(AssetHandle&& moved);
+
+	// Only valid while this handle (or another to the same asset) is alive
+	// Each access counts as a use, so assets in constant use are the last to be evicted once released
+	RESOURCETYPE*	Get() const			{ MarkUsed(); return m_asset; }
+	RESOURCETYPE*	operator->() const	{ MarkUsed(); return m_asset; }
+	RESOURCETYPE&	operator*() const	{ MarkUsed(); return *m_asset; }
+
+	bool			IsValid() const		{ return m_asset != nullptr; }
+	void			Release();
+
+
+private:
+	//-----Private Methods-----
+
+	// Takes over a reference the AssetDB already added for this handle
+	AssetHandle(RESOURCETYPE* asset, AssetRecord_t* record) : m_asset(asset), m_record(record) {}
+
+	void MarkUsed() const { if (m_record != nullptr) { m_record->MarkUsed(); } }
+
+
+private:
+	//-----Private Data-----
+
+	RESOURCETYPE*	m_asset = nullptr;
+	AssetRecord_t*	m_record = nullptr;
+
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Copy constructor, the copy holds its own reference
+//
+template <typename RESOURCETYPE>
+AssetHandle<RESOURCETYPE>::AssetHandle(const AssetHandle& copy)
+	: m_asset(copy.m_asset), m_record(copy.m_record)
+{
+	if (m_record != nullptr)
+	{
+		m_record->AddReference();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Move constructor, takes the moved handle's reference
+//
+template <typename RESOURCETYPE>
+AssetHandle<RESOURCETYPE>::AssetHandle(AssetHandle&& moved)
+	: m_asset(moved.m_asset), m_record(moved.m_record)
+{
+	moved.m_asset = nullptr;
+	moved.m_record = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+template <typename RESOURCETYPE>
+AssetHandle<RESOURCETYPE>::~AssetHandle()
+{
+	Release();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Copy assign, releasing whatever this handle held before
+//
+template <typename RESOURCETYPE>
+AssetHandle<RESOURCETYPE>& AssetHandle<RESOURCETYPE>::operator=(const AssetHandle& copy)
+{
+	if (copy.m_record != nullptr)
+	{
+		copy.m_record->AddReference();
+	}
+
+	Release();
+
+	m_asset = copy.m_asset;
+	m_record = copy.m_record;
+
+	return *this;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Move assign, releasing whatever this handle held before
+//
+template <typename RESOURCETYPE>
+AssetHandle<RESOURCETYPE>& AssetHandle<RESOURCETYPE>::operator=(AssetHandle&& moved)
+{
+	if (this != &moved)
+	{
+		Release();
+
+		m_asset = moved.m_asset;
+		m_record = moved.m_record;
+		moved.m_asset = nullptr;
+		moved.m_record = nullptr;
+	}
+
+	return *this;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Drops this handle's reference, the asset may be evicted any time after if it was the last one
+//
+template <typename RESOURCETYPE>
+void AssetHandle<RESOURCETYPE>::Release()
+{
+	if (m_record != nullptr)
+	{
+		m_record->ReleaseReference();
+	}
+
+	m_asset = nullptr;
+	m_record = nullptr;
+}
@@ -7,9 +7,9 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Assets/AssetDB.hpp"
 #include "Engine/Math/Quaternion.hpp"
+#include "Engine/Core/File.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Assets/AssimpLoader.hpp"
-#include "Engine/Rendering/Animation/Pose.hpp"
 #include "Engine/Core/Time/ProfileScoped.hpp"
 #include "Engine/Rendering/Core/Renderable.hpp"
 #include "Engine/Rendering/Resources/Sampler.hpp"
@@ -18,13 +18,45 @@
 #include "Engine/Rendering/Animation/Skeleton.hpp"
 #include "Engine/Core/DeveloperConsole/DevConsole.hpp"
 #include "Engine/Rendering/Animation/AnimationClip.hpp"
+#include "Engine/Rendering/Animation/CPUSkinnedMesh.hpp"
 #include "Engine/Rendering/DebugRendering/DebugRenderSystem.hpp"
+#include "ThirdParty/assimp/include/assimp/IOSystem.hpp"
+#include "ThirdParty/assimp/include/assimp/IOStream.hpp"
 
 // Assimp importer, so we don't need to pass it between open/close files
 Assimp::Importer g_importer;
 
+// Stream over a MappedFile, so Assimp reads models (and any files they reference) through mounted packs
+class MappedFileIOStream : public Assimp::IOStream
+{
+public:
+
+	virtual size_t		Read(void* pvBuffer, size_t pSize, size_t pCount) override;
+	virtual size_t		Write(const void* pvBuffer, size_t pSize, size_t pCount) override;
+	virtual aiReturn	Seek(size_t pOffset, aiOrigin pOrigin) override;
+	virtual size_t		Tell() const override;
+	virtual size_t		FileSize() const override;
+	virtual void		Flush() override;
+
+	MappedFile	m_file;
+	size_t		m_position = 0;
+
+};
+
+// Read-only file system handing out MappedFileIOStreams
+class MappedFileIOSystem : public Assimp::IOSystem
+{
+public:
+
+	virtual bool				Exists(const char* pFile) const override;
+	virtual char				getOsSeparator() const override;
+	virtual Assimp::IOStream*	Open(const char* pFile, const char* pMode = "rb") override;
+	virtual void				Close(Assimp::IOStream* pFile) override;
+
+};
+
 // C utility functions
-std::vector<Texture*>	LoadAssimpMaterialTextures(aiMaterial* aimaterial, aiTextureType type);
+std::string				GetAssimpMaterialTexturePath(aiMaterial* aimaterial, aiTextureType type);
 Matrix44				GetNodeWorldTransform(aiNode* node);
 Matrix44				ConvertAiMatrixToMyMatrix(aiMatrix4x4 aimatrix);
 Quaternion				ConvertAiQuaternionToMyQuaternion(aiQuaternion aiQuat);
@@ -40,30 +72,57 @@ void					DebugPrintAITree(aiNode* node, const std::string& indent);
 
 
 //-----------------------------------------------------------------------------------------------
-// Opens the file specified by filepath, and reads the contents to assemble the Assimp tree
+// Opens the file specified by filepath
+// If the file has an up to date bake the Assimp tree is only assembled if something asked for isn't in it,
+// otherwise it's assembled now, so a missing or broken file still fails here
 //
 void AssimpLoader::OpenFile(const std::string& filepath)
 {
-	if (m_scene == nullptr)
+	m_filepath = filepath;
+
+	if (!m_bake.Open(filepath))
 	{
-		m_scene = g_importer.ReadFile(filepath.c_str(), aiProcessPreset_TargetRealtime_Quality | aiProcess_MakeLeftHanded);
+		OpenScene();
 	}
+}
 
-	// Ensure the file loads
-	if (m_scene == nullptr || m_scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || m_scene->mRootNode == nullptr)
+
+//-----------------------------------------------------------------------------------------------
+// Frees the Assimp scene, and writes anything that was imported from it to the bake
+//
+void AssimpLoader::CloseFile()
+{
+	m_bake.Close();
+
+	if (m_scene != nullptr)
 	{
-		ERROR_AND_DIE(Stringf("Error: AssimpLoader::OpenFile ran into error \"%s\" while loading file \"%s\"", g_importer.GetErrorString(), filepath.c_str()));
+		g_importer.FreeScene();
+		m_scene = nullptr;
 	}
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Frees the Assimp scene
+// Reads the file contents to assemble the Assimp tree, if it hasn't been already
 //
-void AssimpLoader::CloseFile()
+void AssimpLoader::OpenScene()
 {
-	g_importer.FreeScene();
-	m_scene = nullptr;
+	if (m_scene == nullptr)
+	{
+		// Importer takes ownership of the handler
+		if (g_importer.IsDefaultIOHandler())
+		{
+			g_importer.SetIOHandler(new MappedFileIOSystem());
+		}
+
+		m_scene = g_importer.ReadFile(m_filepath.c_str(), aiProcessPreset_TargetRealtime_Quality | aiProcess_MakeLeftHanded);
+	}
+
+	// Ensure the file loads
+	if (m_scene == nullptr || m_scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || m_scene->mRootNode == nullptr)
+	{
+		ERROR_AND_DIE(Stringf("Error: AssimpLoader::OpenFile ran into error \"%s\" while loading file \"%s\"", g_importer.GetErrorString(), m_filepath.c_str()));
+	}
 }
 
 
@@ -80,7 +139,13 @@ void AssimpLoader::CloseFile()
 Skeleton* AssimpLoader::ImportSkeleton()
 {
 	Skeleton* skeleton = new Skeleton();
-	InitializeSkeleton(skeleton);
+
+	if (!m_bake.ReadSkeleton(skeleton))
+	{
+		OpenScene();
+		InitializeSkeleton(skeleton);
+		m_bake.AddSkeleton(skeleton);
+	}
 
 	return skeleton;
 }
@@ -94,7 +159,34 @@ Skeleton* AssimpLoader::ImportSkeleton()
 Renderable* AssimpLoader::ImportMesh(Skeleton* skeleton /*= nullptr*/)
 {
 	Renderable* renderable = new Renderable();
-	BuildMeshesAndMaterials_FromScene(renderable, skeleton);
+
+	// Skinned vertices store bone indices, so baked meshes are only reused with the skeleton they were weighted to,
+	// and optimized ones only while the loaders are optimizing
+	bool isOptimized = MeshBuilder::IsOptimizeOnLoadEnabled();
+	uint64_t bakeKey = BakeFile::HashBytes(&isOptimized, sizeof(bool), BakeFile::HashSkeleton(skeleton));
+
+	std::vector<Mesh*> meshes;
+	std::vector<BakedMaterialPaths_t> materialPaths;
+
+	if (m_bake.ReadMeshes(bakeKey, meshes, &materialPaths))
+	{
+		for (int meshIndex = 0; meshIndex < (int) meshes.size(); ++meshIndex)
+		{
+			RenderableDraw_t draw;
+			draw.sharedMaterial = CreateMaterial(materialPaths[meshIndex].diffusePath, materialPaths[meshIndex].normalPath, skeleton != nullptr);
+			draw.mesh = meshes[meshIndex];
+
+			renderable->AddDraw(draw);
+		}
+	}
+	else
+	{
+		OpenScene();
+
+		m_bake.BeginMeshSection(bakeKey);
+		BuildMeshesAndMaterials_FromScene(renderable, skeleton);
+		m_bake.EndMeshSection();
+	}
 
 	return renderable;
 }
@@ -109,12 +201,36 @@ Renderable* AssimpLoader::ImportMesh(Skeleton* skeleton /*= nullptr*/)
 std::vector<AnimationClip*> AssimpLoader::ImportAnimation(Skeleton* skeleton, int tickOffset /*= 0*/)
 {
 	std::vector<AnimationClip*> animations;
-	BuildAnimations(skeleton, animations, tickOffset);
+
+	// Tracks are indexed by bone, so clips are keyed to the skeleton as well as the offset
+	uint64_t bakeKey = BakeFile::HashBytes(&tickOffset, sizeof(int), BakeFile::HashSkeleton(skeleton));
+
+	if (!m_bake.ReadAnimations(bakeKey, skeleton, animations))
+	{
+		OpenScene();
+		BuildAnimations(skeleton, animations, tickOffset);
+		m_bake.AddAnimations(bakeKey, animations);
+	}
 
 	return animations;
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Builds a CPU copy of each mesh in the scene, weighted to the skeleton, for skinning on the CPU
+// Doesn't create any GPU resources, so it can be used without a renderer
+//
+std::vector<CPUSkinnedMesh*> AssimpLoader::ImportCPUSkinnedMeshes(Skeleton* skeleton)
+{
+	std::vector<CPUSkinnedMesh*> meshes;
+
+	OpenScene();
+	BuildCPUSkinnedMeshes_FromNode(m_scene->mRootNode, Matrix44::IDENTITY, skeleton, meshes);
+
+	return meshes;
+}
+
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // Skeleton
@@ -401,6 +517,96 @@ void AssimpLoader::BuildMeshAndMaterials_FromAIMesh(aiMesh* aimesh, const Matrix
 	//-----Build the mesh from this aiMesh-----
 
 	MeshBuilder mb;
+	BuildMeshBuilder_FromAIMesh(aimesh, transformation, skeleton, mb);
+
+	Mesh* mesh;
+	
+	// Only build with skinned vertices if bones are present
+	if (skeleton != nullptr)
+	{
+		mesh = mb.CreateMesh<VertexSkinned>();
+	}
+	else
+	{
+		mesh = mb.CreateMesh<VertexLit>();
+	}
+
+
+	//-----Build the material for this mesh-----
+
+	// Every aiMesh has a material, Assimp makes a default one if the file doesn't
+	aiMaterial* aimaterial = m_scene->mMaterials[aimesh->mMaterialIndex];
+
+	std::string diffusePath = GetAssimpMaterialTexturePath(aimaterial, aiTextureType_DIFFUSE);
+	std::string normalPath = GetAssimpMaterialTexturePath(aimaterial, aiTextureType_NORMALS);
+
+	Material* material = CreateMaterial(diffusePath, normalPath, skeleton != nullptr);
+
+	// Save the vertices and the textures, the material is cheap to remake from them
+	m_bake.AddMesh(mb, skeleton != nullptr, diffusePath, normalPath);
+
+	// Add the draw!
+	RenderableDraw_t draw;
+	draw.sharedMaterial = material;
+	draw.mesh = mesh;
+
+    renderable->AddDraw(draw);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Makes a material using the given textures, defaulting missing textures to built-in engine textures
+// Paths are empty if the source material didn't have that texture
+//
+Material* AssimpLoader::CreateMaterial(const std::string& diffusePath, const std::string& normalPath, bool isSkinned) const
+{
+	Material* material = new Material();
+
+	Texture* diffuse = AssetDB::GetTexture("Default");
+	if (diffusePath.size() > 0)
+	{
+		diffuse = AssetDB::CreateOrGetTexture(diffusePath.c_str(), true);
+		diffuse = (diffuse != nullptr ? diffuse : AssetDB::GetTexture("White"));
+	}
+
+	Texture* normal = AssetDB::GetTexture("Flat");
+	if (normalPath.size() > 0)
+	{
+		normal = AssetDB::CreateOrGetTexture(normalPath.c_str(), true);
+		normal = (normal != nullptr ? normal : AssetDB::GetTexture("Flat"));
+	}
+
+	material->SetDiffuse(diffuse);
+	material->SetNormal(normal);
+
+	// If we have a skeleton, then use a skinning shader
+	if (isSkinned)
+	{
+		material->SetShader(AssetDB::CreateOrGetShader("Data/Shaders/Skinning.shader"));
+	}
+	else
+	{
+		material->SetShader(AssetDB::CreateOrGetShader("Phong_Opaque"));
+	}
+
+	// Set up a linear sampler for looks
+	Sampler* sampler = new Sampler();
+	sampler->Initialize(SAMPLER_FILTER_LINEAR_MIPMAP_LINEAR, EDGE_SAMPLING_REPEAT);
+	material->SetSampler(0, sampler);
+	material->SetProperty("SPECULAR_AMOUNT", 0.3f);
+	material->SetProperty("SPECULAR_POWER", 10.f);
+
+	return material;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Fills the MeshBuilder with the aiMesh's vertices, indices and bone weights
+// The transformation passed is the space the current mesh exists in, and is used to convert
+// all mesh vertices into "model/world" space
+//
+void AssimpLoader::BuildMeshBuilder_FromAIMesh(aiMesh* aimesh, const Matrix44& transformation, Skeleton* skeleton, MeshBuilder& mb)
+{
 	mb.BeginBuilding(PRIMITIVE_TRIANGLES, true);
 
 	// Iterate across vertices
@@ -498,75 +704,53 @@ void AssimpLoader::BuildMeshAndMaterials_FromAIMesh(aiMesh* aimesh, const Matrix
 	}
 	
 	mb.FinishBuilding();
-	Mesh* mesh;
-	
-	// Only build with skinned vertices if bones are present
-	if (skeleton != nullptr)
+
+	// The import preset already joins vertices and reorders for its own cache model, so this mostly adds
+	// the fetch reorder, but it keeps every loaded mesh going through the same passes
+	if (MeshBuilder::IsOptimizeOnLoadEnabled())
 	{
-		mesh = mb.CreateMesh<VertexSkinned>();
-	}
-	else
-	{
-		mesh = mb.CreateMesh<VertexLit>();
+		mb.Optimize();
 	}
+}
 
 
-	//-----Build the material for this mesh-----
+//-----------------------------------------------------------------------------------------------
+// Builds a CPUSkinnedMesh from each aiMesh used by the node and its children
+//
+void AssimpLoader::BuildCPUSkinnedMeshes_FromNode(aiNode* node, const Matrix44& parentTransform, Skeleton* skeleton, std::vector<CPUSkinnedMesh*>& out_meshes)
+{
+	Matrix44 currTransform = parentTransform * ConvertAiMatrixToMyMatrix(node->mTransformation);
 
-	Material* material = AssetDB::GetSharedMaterial("Default_Opaque");
-	if (aimesh->mMaterialIndex >= 0)
+	for (unsigned int meshIndex = 0; meshIndex < node->mNumMeshes; ++meshIndex)
 	{
-		aiMaterial* aimaterial = m_scene->mMaterials[aimesh->mMaterialIndex];
-		std::vector<Texture*> diffuse, normal;
+		MeshBuilder mb;
+		BuildMeshBuilder_FromAIMesh(m_scene->mMeshes[node->mMeshes[meshIndex]], currTransform, skeleton, mb);
 
-		diffuse		= LoadAssimpMaterialTextures(aimaterial,	aiTextureType_DIFFUSE);
-		normal		= LoadAssimpMaterialTextures(aimaterial,	aiTextureType_NORMALS);
+		int vertexCount = mb.GetVertexCount();
+		int indexCount = mb.GetIndexCount();
 
-		// Make the material, defaulting missing textures to built-in engine textures
-		material = new Material();
-		if (diffuse.size() > 0)
-		{
-			material->SetDiffuse(diffuse[0]); // Only pull the first texture
-		}
-		else
+		std::vector<VertexSkinned> vertices(vertexCount);
+		for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
 		{
-			material->SetDiffuse(AssetDB::GetTexture("Default"));
+			vertices[vertexIndex] = mb.GetVertex<VertexSkinned>(vertexIndex);
 		}
 
-		if (normal.size() > 0)
+		std::vector<unsigned int> indices(indexCount);
+		for (int indexIndex = 0; indexIndex < indexCount; ++indexIndex)
 		{
-			material->SetNormal(normal[0]); // Only pull the first texture
-		}
-		else
-		{
-			material->SetNormal(AssetDB::GetTexture("Flat"));
+			indices[indexIndex] = mb.GetIndex(indexIndex);
 		}
 
+		CPUSkinnedMesh* mesh = new CPUSkinnedMesh();
+		mesh->Initialize(vertices.data(), vertexCount, indices.data(), indexCount);
 
-		// If we have a skeleton, then use a skinning shader
-		if (skeleton != nullptr)
-		{
-			material->SetShader(AssetDB::CreateOrGetShader("Data/Shaders/Skinning.shader"));
-		}
-		else
-		{
-			material->SetShader(AssetDB::CreateOrGetShader("Phong_Opaque"));
-		}
-
-		// Set up a linear sampler for looks
-		Sampler* sampler = new Sampler();
-		sampler->Initialize(SAMPLER_FILTER_LINEAR_MIPMAP_LINEAR, EDGE_SAMPLING_REPEAT);
-		material->SetSampler(0, sampler);
-		material->SetProperty("SPECULAR_AMOUNT", 0.3f);
-		material->SetProperty("SPECULAR_POWER", 10.f);
+		out_meshes.push_back(mesh);
 	}
 
-	// Add the draw!
-	RenderableDraw_t draw;
-	draw.sharedMaterial = material;
-	draw.mesh = mesh;
-
-    renderable->AddDraw(draw);
+	for (unsigned int childIndex = 0; childIndex < node->mNumChildren; ++childIndex)
+	{
+		BuildCPUSkinnedMeshes_FromNode(node->mChildren[childIndex], currTransform, skeleton, out_meshes);
+	}
 }
 
 
@@ -613,32 +797,30 @@ AnimationClip* AssimpLoader::BuildAnimation(unsigned int animationIndex, Skeleto
 	animation->Initialize(numFramesToGenerate, skeleton, framesPerSecond);
 	animation->SetName(aianimation->mName.C_Str());
 
-	// Iterate across the frames, and build a pose for each
-	for (int frameIndex = 0; frameIndex < numFramesToGenerate; ++frameIndex)
-	{
-		Pose* pose = animation->GetPoseAtIndex(frameIndex);
-
-		// Pass our time in number of ticks, since channels store times as number of ticks
-		float time = (frameIndex * secondsPerFrame * (float) aianimation->mTicksPerSecond);
-		FillPoseForTime(pose, aianimation, time, skeleton, tickOffset);
-	}
+	// Sample every bone at each frame, the clip reduces these down to keys
+	FillBoneTracks(animation, aianimation, skeleton, numFramesToGenerate, secondsPerFrame, tickOffset);
 
 	return animation;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Fills in the pose given for the animation at time time
+// Samples the translation, rotation and scale of every animated bone at each frame and gives them to the clip
+// Bones without any channels are left without a track, so they stay at their bind pose local transform
 //
-void AssimpLoader::FillPoseForTime(Pose* out_pose, aiAnimation* aianimation, float time, Skeleton* skeleton, int tickOffset)
+void AssimpLoader::FillBoneTracks(AnimationClip* clip, aiAnimation* aianimation, Skeleton* skeleton, int numFrames, float secondsPerFrame, int tickOffset)
 {
-	// Initialize the pose
 	std::vector<std::string> boneNames = skeleton->GetAllBoneNames();
-	out_pose->Initialize(skeleton);
-	
-	// Iterate across all bones
 	int numBones = (int) boneNames.size();
 
+	std::vector<Vector3> translations;
+	std::vector<Quaternion> rotations;
+	std::vector<Vector3> scales;
+
+	translations.resize(numFrames);
+	rotations.resize(numFrames);
+	scales.resize(numFrames);
+
 	for (int boneNameIndex = 0; boneNameIndex < numBones; ++boneNameIndex)
 	{
 		std::string currBoneName = boneNames[boneNameIndex];
@@ -646,30 +828,29 @@ void AssimpLoader::FillPoseForTime(Pose* out_pose, aiAnimation* aianimation, flo
 
 		// Get the channel for the bone
 		aiNodeAnim* channel = GetChannelForBone(currBoneName, aianimation);
+		bool isAnimated = true;
 
-		// If the channel exists, get the transform at the current time
-		if (channel != nullptr)
+		for (int frameIndex = 0; frameIndex < numFrames && isAnimated; ++frameIndex)
 		{
-			Matrix44 boneTransform = GetLocalTransfromAtTime(channel, time, skeleton->GetBoneData(boneDataIndex).preRotation, tickOffset);
-			out_pose->SetBoneTransform(boneDataIndex, boneTransform);
-		}
-		else
-		{
-			// Assimp may have separated the animation channel for this bone into 3 separate channels, so we look for them
-			Matrix44 boneTransform;
-			bool channelsExist = ConstructTransformFromSeparatedChannels(currBoneName, aianimation, time, skeleton, boneTransform, tickOffset);
+			// Pass our time in number of ticks, since channels store times as number of ticks
+			float time = (frameIndex * secondsPerFrame * (float) aianimation->mTicksPerSecond);
 
-			// If they existed as separate channels, then set the transform
-			// Otherwise leave the transform alone, which was already initialized to the bind pose bone's local transform
-			if (channelsExist)
+			if (channel != nullptr)
+			{
+				GetLocalTRSAtTime(channel, time, tickOffset, translations[frameIndex], rotations[frameIndex], scales[frameIndex]);
+			}
+			else
 			{
-				out_pose->SetBoneTransform(boneDataIndex, boneTransform);
+				// Assimp may have separated the animation channel for this bone into 3 separate channels, so we look for them
+				isAnimated = GetTRSFromSeparatedChannels(currBoneName, aianimation, time, skeleton, translations[frameIndex], rotations[frameIndex], scales[frameIndex], tickOffset);
 			}
 		}
-	}
 
-	// All the pose matrices are in their local space, so need to concatenate parents in order to finish it, as well as apply offsets matrices and the global inverse
-	out_pose->ConstructWorldMatrices();
+		if (isAnimated)
+		{
+			clip->SetBoneTrack(boneDataIndex, translations.data(), rotations.data(), scales.data());
+		}
+	}
 }
 
 
@@ -696,31 +877,19 @@ aiNodeAnim* AssimpLoader::GetChannelForBone(const std::string& boneName, aiAnima
 
 
 //-----------------------------------------------------------------------------------------------
-// Determines the transform to use from the channel at the given time
+// Determines the translation, rotation and scale of the channel at the given time
+// The rotation doesn't include the bone's pre-rotation, that's applied when the clip is sampled
 //
-Matrix44 AssimpLoader::GetLocalTransfromAtTime(aiNodeAnim* channel, float time, const Matrix44& preRotation, int tickOffset)
+void AssimpLoader::GetLocalTRSAtTime(aiNodeAnim* channel, float time, int tickOffset, Vector3& out_translation, Quaternion& out_rotation, Vector3& out_scale)
 {
 	// Assumes the start time for all nodes is mTime == 0
-
-	// Translation
 	aiVector3D position = GetAnimationTranslationAtTime(channel, time, tickOffset);
-
-	Vector3 myPosition = Vector3(position.x, position.y, position.z);
-
-	// Rotation
 	aiQuaternion rotation = GetAnimationRotationAtTime(channel, time, tickOffset);
-
-	Matrix44 rotationMat = preRotation * Matrix44::MakeRotation(ConvertAiQuaternionToMyQuaternion(rotation)); // Append prerotation
-
-	// Scale
 	aiVector3D scale = GetAnimationScaleAtTime(channel, time, tickOffset);
 
-	// Make the model
-	Matrix44 translationMat = Matrix44::MakeTranslation(Vector3(position.x, position.y, position.z));
-	Matrix44 scaleMat = Matrix44::MakeScale(Vector3(scale.x, scale.y, scale.z));
-	Matrix44 transform = translationMat * rotationMat * scaleMat;
-
-	return transform;
+	out_translation = Vector3(position.x, position.y, position.z);
+	out_rotation = ConvertAiQuaternionToMyQuaternion(rotation);
+	out_scale = Vector3(scale.x, scale.y, scale.z);
 }
 
 
@@ -908,80 +1077,63 @@ aiVector3D AssimpLoader::GetAnimationScaleAtTime(aiNodeAnim* channel, float time
 
 
 //-----------------------------------------------------------------------------------------------
-// Constructs the animation for the given bone name from 3 separate channels:
+// Constructs the translation, rotation and scale for the given bone name from 3 separate channels:
 //		boneName__$AssimpFbx$_Translation
 //		boneName__$AssimpFbx$_Rotation
 //		boneName__$AssimpFbx$_Scale
-// It's not guarenteed that all three (or any at all) exist
+// It's not guarenteed that all three (or any at all) exist - missing translation/scale fall back
+// to the bind pose's, and a missing rotation is identity
 // Returns true if at least one existed
 //
-bool AssimpLoader::ConstructTransformFromSeparatedChannels(const std::string& boneName, aiAnimation* animation, float time, Skeleton* skeleton, Matrix44& out_transform, int firstFrameIndex) const
+bool AssimpLoader::GetTRSFromSeparatedChannels(const std::string& boneName, aiAnimation* animation, float time, Skeleton* skeleton, Vector3& out_translation, Quaternion& out_rotation, Vector3& out_scale, int firstFrameIndex) const
 {
 	bool channelFound = false;
+	Matrix44 localTransform = skeleton->GetBoneData(skeleton->GetBoneMapping(boneName)).localTransform;
 
 	// Translation
 	std::string translationChannelName = boneName + "_$AssimpFbx$_Translation";
-	aiVector3D translation = aiVector3D(0.f, 0.f, 0.f);
-
 	aiNodeAnim* translationChannel = GetChannelForBone(translationChannelName, animation);
 	
 	if (translationChannel != nullptr)
 	{
-		translation = GetAnimationTranslationAtTime(translationChannel, time, firstFrameIndex);
+		aiVector3D translation = GetAnimationTranslationAtTime(translationChannel, time, firstFrameIndex);
+		out_translation = Vector3(translation.x, translation.y, translation.z);
 		channelFound = true;
 	}
 	else 
 	{
-		Matrix44 localTransform = skeleton->GetBoneData(skeleton->GetBoneMapping(boneName)).localTransform;
-		Vector3 positionOld = Matrix44::ExtractTranslation(localTransform);
-		translation = aiVector3D(positionOld.x, positionOld.y, positionOld.z);
+		out_translation = Matrix44::ExtractTranslation(localTransform);
 	}
 
-	// Prerotation - from skeleton
-	int boneMapping = skeleton->GetBoneMapping(boneName);
-	BoneData_t boneData = skeleton->GetBoneData(boneMapping);
-	Matrix44 preRotation = boneData.preRotation;
-
 	// Rotation
 	std::string rotationChannelName = boneName + "_$AssimpFbx$_Rotation";
-	aiQuaternion rotation;
-
 	aiNodeAnim* rotationChannel = GetChannelForBone(rotationChannelName, animation);
 
 	if (rotationChannel != nullptr)
 	{
-		rotation = GetAnimationRotationAtTime(rotationChannel, time, firstFrameIndex);
+		out_rotation = ConvertAiQuaternionToMyQuaternion(GetAnimationRotationAtTime(rotationChannel, time, firstFrameIndex));
 		channelFound = true;
 	}
-
-	// Prepend prerotation
-	Matrix44 rotationMat = ConvertAiMatrixToMyMatrix(aiMatrix4x4(aiVector3D(1.f, 1.f, 1.f), rotation, aiVector3D(0.f, 0.f, 0.f)));
-	Matrix44 finalRotation = preRotation * rotationMat;
+	else
+	{
+		out_rotation = Quaternion::IDENTITY;
+	}
 
 	// Scale
 	std::string scaleChannelName = boneName + "_$AssimpFbx$_Scale";
-	aiVector3D scale = aiVector3D(1.f, 1.f, 1.f);
-
 	aiNodeAnim* scaleChannel = GetChannelForBone(scaleChannelName, animation);
 
 	if (scaleChannel != nullptr)
 	{
-		scale = GetAnimationScaleAtTime(scaleChannel, time, firstFrameIndex);
+		aiVector3D scale = GetAnimationScaleAtTime(scaleChannel, time, firstFrameIndex);
+		out_scale = Vector3(scale.x, scale.y, scale.z);
 		channelFound = true;
 	}
 	else 
 	{
-		Matrix44 localTransform = skeleton->GetBoneData(skeleton->GetBoneMapping(boneName)).localTransform;
-		Vector3 scaleOld = Matrix44::ExtractScale(localTransform);
-		scale = aiVector3D(scaleOld.x, scaleOld.y, scaleOld.z);
+		out_scale = Matrix44::ExtractScale(localTransform);
 	}
 
-	Matrix44 scaleMat = Matrix44::MakeScale(Vector3(scale.x, scale.y, scale.z));
-
-	// Final transform
-	Matrix44 translationMat = Matrix44::MakeTranslation(Vector3(translation.x, translation.y, translation.z));
-	out_transform = translationMat * finalRotation * scaleMat;
-
 	return channelFound;
 }
 
@@ -994,41 +1146,20 @@ bool AssimpLoader::ConstructTransformFromSeparatedChannels(const std::string& bo
 
 
 //-----------------------------------------------------------------------------------------------
-// Find the textures used by the given aiMaterial and attempts to load and return them
+// Returns the path to the first texture of the given type on the aiMaterial, or "" if it has none
 //
-std::vector<Texture*> LoadAssimpMaterialTextures(aiMaterial* aimaterial, aiTextureType type)
+std::string GetAssimpMaterialTexturePath(aiMaterial* aimaterial, aiTextureType type)
 {
-	std::vector<Texture*> textures;
-
-	for (unsigned int textureIndex = 0; textureIndex < aimaterial->GetTextureCount(type); ++textureIndex)
+	if (aimaterial->GetTextureCount(type) == 0)
 	{
-		aiString texturePath;
-		aimaterial->GetTexture(type, textureIndex, &texturePath);
-
-		std::string fullPath	= "Data/Models/" + std::string(texturePath.C_Str());
-		Texture* texture		= AssetDB::CreateOrGetTexture(fullPath.c_str(), true);
-
-		if (texture == nullptr)
-		{
-			// Default the texture to some default
-			switch(type)
-			{
-			case aiTextureType_DIFFUSE:
-				texture = AssetDB::GetTexture("White");
-				break;
-			case aiTextureType_NORMALS:
-				texture = AssetDB::GetTexture("Flat");
-				break;
-			case aiTextureType_EMISSIVE:
-				texture = AssetDB::GetTexture("Black");
-				break;
-			}
-		}
-
-		textures.push_back(texture);
+		return "";
 	}
 
-	return textures;
+	// Only pull the first texture
+	aiString texturePath;
+	aimaterial->GetTexture(type, 0, &texturePath);
+
+	return "Data/Models/" + std::string(texturePath.C_Str());
 }
 
 
@@ -1150,3 +1281,142 @@ void DebugPrintAnimation(aiAnimation* anim)
 			channelIndex, channel->mNodeName.C_Str(), numPos, channel->mPositionKeys[0].mTime / tps, channel->mPositionKeys[numPos - 1].mTime / tps, numRot, channel->mRotationKeys[0].mTime / tps, channel->mRotationKeys[numRot - 1].mTime / tps, numSca, channel->mScalingKeys[0].mTime / tps, channel->mScalingKeys[numSca - 1].mTime / tps);
 	}
 }
+
+
+//-----------------------------------------------------------------------------------------------
+// Copies up to pCount elements of pSize bytes, returning the number of whole elements read
+//
+size_t MappedFileIOStream::Read(void* pvBuffer, size_t pSize, size_t pCount)
+{
+	if (pSize == 0)
+	{
+		return 0;
+	}
+
+	size_t elementsLeft = (m_file.GetSize() - m_position) / pSize;
+	size_t elementCount = (pCount < elementsLeft ? pCount : elementsLeft);
+
+	if (elementCount > 0)
+	{
+		memcpy(pvBuffer, m_file.GetData() + m_position, elementCount * pSize);
+		m_position += elementCount * pSize;
+	}
+
+	return elementCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Streams are read-only, so nothing is ever written
+//
+size_t MappedFileIOStream::Write(const void* pvBuffer, size_t pSize, size_t pCount)
+{
+	UNUSED(pvBuffer);
+	UNUSED(pSize);
+	UNUSED(pCount);
+
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Moves the read position, failing if it would leave the file
+//
+aiReturn MappedFileIOStream::Seek(size_t pOffset, aiOrigin pOrigin)
+{
+	size_t basePosition = 0;
+
+	switch (pOrigin)
+	{
+	case aiOrigin_CUR: basePosition = m_position;			break;
+	case aiOrigin_END: basePosition = m_file.GetSize();	break;
+	default:												break;
+	}
+
+	// Offsets from the end come in as wrapped negative values
+	size_t newPosition = basePosition + pOffset;
+
+	if (newPosition > m_file.GetSize())
+	{
+		return aiReturn_FAILURE;
+	}
+
+	m_position = newPosition;
+	return aiReturn_SUCCESS;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the read position
+//
+size_t MappedFileIOStream::Tell() const
+{
+	return m_position;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the size of the whole file
+//
+size_t MappedFileIOStream::FileSize() const
+{
+	return m_file.GetSize();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Nothing to flush on a read-only stream
+//
+void MappedFileIOStream::Flush()
+{
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the file can be opened, on disk or in a mounted pack
+//
+bool MappedFileIOSystem::Exists(const char* pFile) const
+{
+	MappedFile file;
+	return file.Open(pFile);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Pack paths are normalized to forward slashes, and Windows takes either
+//
+char MappedFileIOSystem::getOsSeparator() const
+{
+	return '/';
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Opens a stream over the file, returning nullptr if it doesn't exist or a write was asked for
+//
+Assimp::IOStream* MappedFileIOSystem::Open(const char* pFile, const char* pMode /*= "rb"*/)
+{
+	if (strchr(pMode, 'w') != nullptr || strchr(pMode, 'a') != nullptr || strchr(pMode, '+') != nullptr)
+	{
+		return nullptr;
+	}
+
+	MappedFileIOStream* stream = new MappedFileIOStream();
+
+	if (!stream->m_file.Open(pFile))
+	{
+		delete stream;
+		return nullptr;
+	}
+
+	return stream;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Closes the stream's file
+//
+void MappedFileIOSystem::Close(Assimp::IOStream* pFile)
+{
+	delete pFile;
+}
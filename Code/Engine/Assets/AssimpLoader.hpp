@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Assets/BakeFile.hpp"
 
 #include "ThirdParty/assimp/include/assimp/scene.h"
 #include "ThirdParty/assimp/include/assimp/cimport.h"
@@ -16,10 +17,13 @@
 
 // Predeclares
 class Texture;
+class Material;
 class Renderable;
+class MeshBuilder;
+class CPUSkinnedMesh;
 class Skeleton;
+class Quaternion;
 class AnimationClip;
-class Pose;
 
 struct aiNode;
 struct aiMesh;
@@ -44,11 +48,15 @@ public:
 	Renderable*						ImportMesh(Skeleton* skeleton = nullptr);
 	Skeleton*						ImportSkeleton();
 	std::vector<AnimationClip*>		ImportAnimation(Skeleton* skeleton, int firstFrame = 0);
+	std::vector<CPUSkinnedMesh*>	ImportCPUSkinnedMeshes(Skeleton* skeleton);
 
 
 private:
 	//-----Private Methods-----
 
+	// Only done when something isn't in the bake
+	void OpenScene();
+
 	// Skeleton loading
 	void InitializeSkeleton(Skeleton* skeleton);
 		void GetBoneNamesFromNode(std::vector<std::string>& out_names);
@@ -63,18 +71,21 @@ private:
 	void BuildMeshesAndMaterials_FromScene(Renderable* renderable, Skeleton* skeleton);
 		void BuildMeshesAndMaterials_FromNode(aiNode* node, const Matrix44& parentTransform, Renderable* renderable, Skeleton* skeleton);
 			void BuildMeshAndMaterials_FromAIMesh(aiMesh* mesh, const Matrix44& transformation, Renderable* renderable, Skeleton* skeleton);
+				void BuildMeshBuilder_FromAIMesh(aiMesh* mesh, const Matrix44& transformation, Skeleton* skeleton, MeshBuilder& out_builder);
+	Material* CreateMaterial(const std::string& diffusePath, const std::string& normalPath, bool isSkinned) const;
+	void BuildCPUSkinnedMeshes_FromNode(aiNode* node, const Matrix44& parentTransform, Skeleton* skeleton, std::vector<CPUSkinnedMesh*>& out_meshes);
 
 
 	// Animation
 	void BuildAnimations(Skeleton* skeleton, std::vector<AnimationClip*>& animations, int firstFrameIndex);
 		AnimationClip* BuildAnimation(unsigned int animationIndex, Skeleton* skeleton,  int firstFrameIndex);
-			void FillPoseForTime(Pose* out_pose, aiAnimation* aianimation, float time, Skeleton* skeleton,  int firstFrameIndex);
+			void FillBoneTracks(AnimationClip* clip, aiAnimation* aianimation, Skeleton* skeleton, int numFrames, float secondsPerFrame, int firstFrameIndex);
 				aiNodeAnim* GetChannelForBone(const std::string& boneName, aiAnimation* animation) const;
-				Matrix44	GetLocalTransfromAtTime(aiNodeAnim* channel, float time, const Matrix44& preRotation,  int firstFrameIndex);
+				void		GetLocalTRSAtTime(aiNodeAnim* channel, float time, int firstFrameIndex, Vector3& out_translation, Quaternion& out_rotation, Vector3& out_scale);
 					aiVector3D		GetAnimationTranslationAtTime(const aiNodeAnim* channel, float time,  int firstFrameIndex) const;
 					aiQuaternion	GetAnimationRotationAtTime(aiNodeAnim* channel, float time,  int firstFrameIndex) const;
 					aiVector3D		GetAnimationScaleAtTime(aiNodeAnim* channel, float time,  int firstFrameIndex) const;
-				bool	ConstructTransformFromSeparatedChannels(const std::string& boneName, aiAnimation* animation, float time, Skeleton* skeleton, Matrix44& out_transform,  int firstFrameIndex) const;
+				bool	GetTRSFromSeparatedChannels(const std::string& boneName, aiAnimation* animation, float time, Skeleton* skeleton, Vector3& out_translation, Quaternion& out_rotation, Vector3& out_scale, int firstFrameIndex) const;
 
 
 private:
@@ -82,5 +93,9 @@ private:
 
 	// The Assimp scene that hold the file data in a tree
 	const aiScene*	m_scene = nullptr;
+	std::string		m_filepath;
+
+	// Imports are read from here when the source hasn't changed, and added to it when they aren't
+	BakeFile		m_bake;
 
 };
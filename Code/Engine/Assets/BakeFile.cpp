@@ -0,0 +1,1029 @@
+/************************************************************************/
+/* File: BakeFile.cpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Implementation of the BakeFile class
+/************************************************************************/
+#include "Engine/Assets/BakeFile.hpp"
+#include "Engine/Core/File.hpp"
+#include "Engine/Core/CompressedImage.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Rendering/Meshes/Mesh.hpp"
+#include "Engine/Rendering/Core/Vertex.hpp"
+#include "Engine/Rendering/Meshes/MeshBuilder.hpp"
+#include "Engine/Rendering/Animation/Skeleton.hpp"
+#include "Engine/Core/DeveloperConsole/DevConsole.hpp"
+#include "Engine/Rendering/Animation/AnimationClip.hpp"
+
+// File layout is a BakeFileHeader_t, then one BakeSectionHeader_t per section, then the sections
+// Every array starts on a BAKE_ALIGNMENT boundary from the start of the file, so once the file is in memory
+// vertex and index streams go straight to the GPU and everything else is a single copy per array
+// Bakes are only read on the machine type that wrote them, so everything is stored native-endian
+static const uint32_t	BAKE_FILE_MAGIC = 0x454B4142; // "BAKE"
+static const size_t		BAKE_ALIGNMENT = 16;
+
+struct BakeFileHeader_t
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+	uint64_t sourceSize;
+	uint32_t sectionCount;
+	uint32_t reserved;
+};
+
+struct BakeSectionHeader_t
+{
+	uint32_t type;
+	uint32_t reserved;
+	uint64_t key;
+	uint64_t offset;	// From the start of the file
+	uint64_t size;
+};
+
+// Everything below is offset from the start of its section
+struct BakedArray_t
+{
+	uint64_t offset;
+	uint64_t count;
+};
+
+enum BakedVertexType : uint32_t
+{
+	BAKED_VERTEX_LIT,
+	BAKED_VERTEX_SKINNED
+};
+
+struct BakedMeshSection_t
+{
+	uint32_t meshCount;
+	uint32_t reserved;
+	uint64_t meshTableOffset;	// Meshes are only counted once they're all written, so the table comes last
+};
+
+struct BakedMesh_t
+{
+	uint32_t vertexType;
+	uint32_t vertexSize;		// Catches a vertex struct changing without a version bump
+	BakedArray_t vertices;
+	BakedArray_t indices;
+
+	uint32_t primitiveType;
+	uint32_t startIndex;
+	uint32_t elementCount;
+	uint32_t usesIndices;
+
+	uint32_t diffusePathOffset;	// 0 if the mesh has no texture
+	uint32_t normalPathOffset;
+};
+
+struct BakedSkeleton_t
+{
+	uint32_t boneCount;
+	uint32_t boneDataSize;
+	uint64_t boneDataOffset;
+	uint64_t nameOffsetsOffset;	// One uint32_t per bone, to null terminated names
+};
+
+struct BakedAnimationSection_t
+{
+	uint32_t clipCount;
+	uint32_t reserved;
+	uint64_t clipTableOffset;
+};
+
+struct BakedClip_t
+{
+	uint32_t nameOffset;
+	uint32_t frameCount;
+	float framesPerSecond;
+	uint32_t rotationInterpolation;
+
+	float translationTolerance;
+	float rotationToleranceDegrees;
+	float scaleTolerance;
+	uint32_t reserved;
+
+	BakedArray_t tracks;
+	BakedArray_t translationKeyFrames;
+	BakedArray_t translationKeys;
+	BakedArray_t rotationKeyFrames;
+	BakedArray_t rotationKeys;
+	BakedArray_t scaleKeyFrames;
+	BakedArray_t scaleKeys;
+};
+
+struct BakedTextureSection_t
+{
+	uint32_t format;
+	uint32_t reserved;
+	BakedArray_t mips;
+	BakedArray_t blockData;
+};
+
+struct BakedTextureMip_t
+{
+	uint32_t width;
+	uint32_t height;
+	uint64_t offset;		// Into the block data
+	uint64_t size;
+};
+
+// C functions
+static size_t			AppendBytes(std::vector<uint8_t>& buffer, const void* data, size_t byteCount, size_t alignment = BAKE_ALIGNMENT);
+static uint32_t			AppendString(std::vector<uint8_t>& buffer, const std::string& text);
+static bool				IsRangeInBuffer(size_t bufferSize, uint64_t offset, uint64_t count, size_t elementSize);
+static const char*		GetStringInBuffer(const uint8_t* buffer, size_t bufferSize, uint32_t offset);
+
+template <typename T>
+static BakedArray_t AppendArray(std::vector<uint8_t>& buffer, const std::vector<T>& elements)
+{
+	BakedArray_t array;
+	array.offset = AppendBytes(buffer, elements.data(), elements.size() * sizeof(T));
+	array.count = elements.size();
+
+	return array;
+}
+
+template <typename T>
+static bool ReadArray(const uint8_t* buffer, size_t bufferSize, const BakedArray_t& array, std::vector<T>& out_elements)
+{
+	if (!IsRangeInBuffer(bufferSize, array.offset, array.count, sizeof(T)))
+	{
+		return false;
+	}
+
+	const T* elements = (const T*)(buffer + array.offset);
+	out_elements.assign(elements, elements + array.count);
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+BakeFile::~BakeFile()
+{
+	Close();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Hashes the source and reads the bake next to it, keeping the bake's sections only if it was
+// made from the same source contents by the same version of this code
+//
+bool BakeFile::Open(const std::string& sourcePath)
+{
+	Close();
+	m_sourcePath = sourcePath;
+
+	MappedFile sourceFile;
+
+	if (!sourceFile.Open(sourcePath.c_str()))
+	{
+		return false;
+	}
+
+	m_sourceHash = HashBytes(sourceFile.GetData(), sourceFile.GetSize());
+	m_sourceSize = sourceFile.GetSize();
+	m_isSourceReadable = true;
+	sourceFile.Close();
+
+	if (!m_bakeFile.Open(GetBakePathForSource(sourcePath).c_str()))
+	{
+		return false;
+	}
+
+	// Mapped views are page aligned, so the alignment of everything in the bake holds in memory
+	const char* fileData = m_bakeFile.GetData();
+	size_t bakeSize = m_bakeFile.GetSize();
+
+	const BakeFileHeader_t* header = (const BakeFileHeader_t*) fileData;
+	bool isHeaderValid = bakeSize >= sizeof(BakeFileHeader_t)
+		&& header->magic == BAKE_FILE_MAGIC
+		&& header->version == BAKE_FILE_VERSION
+		&& header->sourceHash == m_sourceHash
+		&& header->sourceSize == m_sourceSize
+		&& IsRangeInBuffer(bakeSize, sizeof(BakeFileHeader_t), header->sectionCount, sizeof(BakeSectionHeader_t));
+
+	if (isHeaderValid)
+	{
+		const BakeSectionHeader_t* sectionHeaders = (const BakeSectionHeader_t*)(fileData + sizeof(BakeFileHeader_t));
+
+		for (uint32_t sectionIndex = 0; sectionIndex < header->sectionCount && isHeaderValid; ++sectionIndex)
+		{
+			const BakeSectionHeader_t& sectionHeader = sectionHeaders[sectionIndex];
+			isHeaderValid = IsRangeInBuffer(bakeSize, sectionHeader.offset, sectionHeader.size, 1);
+
+			BakeSection_t section;
+			section.type = (BakeSectionType) sectionHeader.type;
+			section.key = sectionHeader.key;
+			section.data = (const uint8_t*)(fileData + sectionHeader.offset);
+			section.size = (size_t) sectionHeader.size;
+
+			m_sections.push_back(section);
+		}
+	}
+
+	// Out of date bakes are dropped entirely, and rewritten with whatever gets imported from the source
+	if (!isHeaderValid)
+	{
+		m_sections.clear();
+		m_bakeFile.Close();
+
+		return false;
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Writes every section to the bake next to the source, returning false if it couldn't be written
+//
+bool BakeFile::Save()
+{
+	if (!m_isSourceReadable)
+	{
+		return false;
+	}
+
+	// Lay the sections out before writing anything
+	uint32_t sectionCount = (uint32_t) m_sections.size();
+	std::vector<BakeSectionHeader_t> sectionHeaders(sectionCount);
+
+	size_t fileSize = sizeof(BakeFileHeader_t) + sectionCount * sizeof(BakeSectionHeader_t);
+
+	for (uint32_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex)
+	{
+		fileSize = (fileSize + BAKE_ALIGNMENT - 1) & ~(BAKE_ALIGNMENT - 1);
+
+		sectionHeaders[sectionIndex].type = m_sections[sectionIndex].type;
+		sectionHeaders[sectionIndex].reserved = 0;
+		sectionHeaders[sectionIndex].key = m_sections[sectionIndex].key;
+		sectionHeaders[sectionIndex].offset = fileSize;
+		sectionHeaders[sectionIndex].size = m_sections[sectionIndex].size;
+
+		fileSize += m_sections[sectionIndex].size;
+	}
+
+	// Build the file in memory so it's written with one call
+	std::vector<uint8_t> fileData;
+	fileData.reserve(fileSize);
+
+	BakeFileHeader_t header;
+	header.magic = BAKE_FILE_MAGIC;
+	header.version = BAKE_FILE_VERSION;
+	header.sourceHash = m_sourceHash;
+	header.sourceSize = m_sourceSize;
+	header.sectionCount = sectionCount;
+	header.reserved = 0;
+
+	AppendBytes(fileData, &header, sizeof(BakeFileHeader_t));
+	AppendBytes(fileData, sectionHeaders.data(), sectionCount * sizeof(BakeSectionHeader_t), 1);
+
+	for (uint32_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex)
+	{
+		AppendBytes(fileData, m_sections[sectionIndex].data, m_sections[sectionIndex].size);
+	}
+
+	// Windows won't truncate a file that's mapped
+	ReleaseMappedSections();
+
+	std::string bakePath = GetBakePathForSource(m_sourcePath);
+	FILE* fileHandle = OpenFile(bakePath.c_str(), "wb");
+
+	if (fileHandle == nullptr)
+	{
+		ConsoleWarningf("Couldn't write bake file \"%s\"", bakePath.c_str());
+		return false;
+	}
+
+	bool succeeded = (fwrite(fileData.data(), 1, fileData.size(), fileHandle) == fileData.size());
+	succeeded = CloseFile(fileHandle) && succeeded;
+
+	m_hasUnsavedSections = !succeeded;
+	return succeeded;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Saves any added sections and frees the file data
+//
+void BakeFile::Close()
+{
+	if (m_hasUnsavedSections)
+	{
+		Save();
+	}
+
+	m_sections.clear();
+
+	m_bakeFile.Close();
+
+	m_isSourceReadable = false;
+	m_hasUnsavedSections = false;
+
+	m_isBuildingMeshSection = false;
+	m_pendingMeshData.clear();
+	m_pendingMeshTable.clear();
+	m_pendingMeshCount = 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Starts a mesh section, for the meshes added before EndMeshSection()
+//
+void BakeFile::BeginMeshSection(uint64_t key)
+{
+	ASSERT_OR_DIE(!m_isBuildingMeshSection, "Error: BakeFile::BeginMeshSection() called while already building a mesh section");
+
+	m_isBuildingMeshSection = true;
+	m_pendingMeshKey = key;
+	m_pendingMeshCount = 0;
+	m_pendingMeshTable.clear();
+
+	// Leave room for the section header, which is filled in once the meshes are counted
+	m_pendingMeshData.clear();
+	m_pendingMeshData.resize(sizeof(BakedMeshSection_t));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the builder's vertices and indices to the current mesh section, converted to the vertex type used to draw them
+//
+void BakeFile::AddMesh(MeshBuilder& mb, bool useSkinnedVertices, const std::string& diffusePath /*= ""*/, const std::string& normalPath /*= ""*/)
+{
+	ASSERT_OR_DIE(m_isBuildingMeshSection, "Error: BakeFile::AddMesh() called outside of BeginMeshSection()/EndMeshSection()");
+
+	// Nothing gets saved without a source to hash, so don't bother copying
+	if (!m_isSourceReadable)
+	{
+		return;
+	}
+
+	int vertexCount = mb.GetVertexCount();
+	int indexCount = mb.GetIndexCount();
+
+	BakedMesh_t bakedMesh;
+	memset(&bakedMesh, 0, sizeof(BakedMesh_t));
+
+	if (useSkinnedVertices)
+	{
+		std::vector<VertexSkinned> vertices(vertexCount);
+		for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			vertices[vertexIndex] = mb.GetVertex<VertexSkinned>(vertexIndex);
+		}
+
+		bakedMesh.vertexType = BAKED_VERTEX_SKINNED;
+		bakedMesh.vertexSize = sizeof(VertexSkinned);
+		bakedMesh.vertices = AppendArray(m_pendingMeshData, vertices);
+	}
+	else
+	{
+		std::vector<VertexLit> vertices(vertexCount);
+		for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			vertices[vertexIndex] = mb.GetVertex<VertexLit>(vertexIndex);
+		}
+
+		bakedMesh.vertexType = BAKED_VERTEX_LIT;
+		bakedMesh.vertexSize = sizeof(VertexLit);
+		bakedMesh.vertices = AppendArray(m_pendingMeshData, vertices);
+	}
+
+	std::vector<unsigned int> indices(indexCount);
+	for (int indexIndex = 0; indexIndex < indexCount; ++indexIndex)
+	{
+		indices[indexIndex] = mb.GetIndex(indexIndex);
+	}
+
+	bakedMesh.indices = AppendArray(m_pendingMeshData, indices);
+
+	DrawInstruction instruction = mb.GetDrawInstruction();
+	bakedMesh.primitiveType = (uint32_t) instruction.m_primType;
+	bakedMesh.startIndex = instruction.m_startIndex;
+	bakedMesh.elementCount = instruction.m_elementCount;
+	bakedMesh.usesIndices = (instruction.m_usingIndices ? 1 : 0);
+
+	bakedMesh.diffusePathOffset = AppendString(m_pendingMeshData, diffusePath);
+	bakedMesh.normalPathOffset = AppendString(m_pendingMeshData, normalPath);
+
+	AppendBytes(m_pendingMeshTable, &bakedMesh, sizeof(BakedMesh_t));
+	m_pendingMeshCount++;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Finishes the current mesh section, replacing any existing one with the same key
+//
+void BakeFile::EndMeshSection()
+{
+	ASSERT_OR_DIE(m_isBuildingMeshSection, "Error: BakeFile::EndMeshSection() called without BeginMeshSection()");
+	m_isBuildingMeshSection = false;
+
+	if (!m_isSourceReadable)
+	{
+		return;
+	}
+
+	BakedMeshSection_t sectionHeader;
+	sectionHeader.meshCount = m_pendingMeshCount;
+	sectionHeader.reserved = 0;
+	sectionHeader.meshTableOffset = AppendBytes(m_pendingMeshData, m_pendingMeshTable.data(), m_pendingMeshTable.size());
+
+	memcpy(m_pendingMeshData.data(), &sectionHeader, sizeof(BakedMeshSection_t));
+	AddSection(BAKE_SECTION_MESHES, m_pendingMeshKey, m_pendingMeshData);
+
+	m_pendingMeshTable.clear();
+	m_pendingMeshCount = 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if there's a mesh section for the key
+//
+bool BakeFile::HasMeshes(uint64_t key) const
+{
+	return FindSection(BAKE_SECTION_MESHES, key) != nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Creates a mesh for each mesh in the section, uploading the vertex and index streams directly from the file data
+// Returns false without creating anything if the section doesn't exist or is damaged
+//
+bool BakeFile::ReadMeshes(uint64_t key, std::vector<Mesh*>& out_meshes, std::vector<BakedMaterialPaths_t>* out_materials /*= nullptr*/) const
+{
+	const BakeSection_t* section = FindSection(BAKE_SECTION_MESHES, key);
+	if (section == nullptr || section->size < sizeof(BakedMeshSection_t))
+	{
+		return false;
+	}
+
+	const BakedMeshSection_t* sectionHeader = (const BakedMeshSection_t*) section->data;
+	if (!IsRangeInBuffer(section->size, sectionHeader->meshTableOffset, sectionHeader->meshCount, sizeof(BakedMesh_t)))
+	{
+		return false;
+	}
+
+	const BakedMesh_t* bakedMeshes = (const BakedMesh_t*)(section->data + sectionHeader->meshTableOffset);
+
+	// Check everything first, so a damaged bake falls back to the source instead of leaving half its meshes made
+	for (uint32_t meshIndex = 0; meshIndex < sectionHeader->meshCount; ++meshIndex)
+	{
+		const BakedMesh_t& bakedMesh = bakedMeshes[meshIndex];
+
+		size_t expectedVertexSize = (bakedMesh.vertexType == BAKED_VERTEX_SKINNED ? sizeof(VertexSkinned) : sizeof(VertexLit));
+		bool isValid = (bakedMesh.vertexType == BAKED_VERTEX_LIT || bakedMesh.vertexType == BAKED_VERTEX_SKINNED)
+			&& bakedMesh.vertexSize == expectedVertexSize
+			&& bakedMesh.primitiveType < NUM_PRIMITIVE_TYPES
+			&& IsRangeInBuffer(section->size, bakedMesh.vertices.offset, bakedMesh.vertices.count, bakedMesh.vertexSize)
+			&& IsRangeInBuffer(section->size, bakedMesh.indices.offset, bakedMesh.indices.count, sizeof(unsigned int))
+			&& GetStringInBuffer(section->data, section->size, bakedMesh.diffusePathOffset) != nullptr
+			&& GetStringInBuffer(section->data, section->size, bakedMesh.normalPathOffset) != nullptr;
+
+		if (!isValid)
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t meshIndex = 0; meshIndex < sectionHeader->meshCount; ++meshIndex)
+	{
+		const BakedMesh_t& bakedMesh = bakedMeshes[meshIndex];
+		Mesh* mesh = new Mesh();
+
+		const uint8_t* vertexData = section->data + bakedMesh.vertices.offset;
+		if (bakedMesh.vertexType == BAKED_VERTEX_SKINNED)
+		{
+			mesh->SetVertices((unsigned int) bakedMesh.vertices.count, (const VertexSkinned*) vertexData);
+		}
+		else
+		{
+			mesh->SetVertices((unsigned int) bakedMesh.vertices.count, (const VertexLit*) vertexData);
+		}
+
+		mesh->SetIndices((unsigned int) bakedMesh.indices.count, (const unsigned int*)(section->data + bakedMesh.indices.offset));
+		mesh->SetDrawInstruction((PrimitiveType) bakedMesh.primitiveType, bakedMesh.usesIndices != 0, bakedMesh.startIndex, bakedMesh.elementCount);
+
+		out_meshes.push_back(mesh);
+
+		if (out_materials != nullptr)
+		{
+			BakedMaterialPaths_t paths;
+			paths.diffusePath = GetStringInBuffer(section->data, section->size, bakedMesh.diffusePathOffset);
+			paths.normalPath = GetStringInBuffer(section->data, section->size, bakedMesh.normalPathOffset);
+
+			out_materials->push_back(paths);
+		}
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the skeleton's bones and names, replacing any skeleton already in the bake
+//
+void BakeFile::AddSkeleton(const Skeleton* skeleton)
+{
+	if (!m_isSourceReadable)
+	{
+		return;
+	}
+
+	unsigned int boneCount = skeleton->GetBoneCount();
+	std::vector<std::string> boneNames = skeleton->GetAllBoneNames();
+
+	std::vector<BoneData_t> boneData(boneCount);
+	for (unsigned int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		boneData[boneIndex] = skeleton->GetBoneData(boneIndex);
+	}
+
+	std::vector<uint8_t> data(sizeof(BakedSkeleton_t));
+
+	std::vector<uint32_t> nameOffsets(boneCount);
+	for (unsigned int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		nameOffsets[boneIndex] = AppendString(data, boneNames[boneIndex]);
+	}
+
+	BakedSkeleton_t bakedSkeleton;
+	bakedSkeleton.boneCount = boneCount;
+	bakedSkeleton.boneDataSize = sizeof(BoneData_t);
+	bakedSkeleton.boneDataOffset = AppendArray(data, boneData).offset;
+	bakedSkeleton.nameOffsetsOffset = AppendArray(data, nameOffsets).offset;
+
+	memcpy(data.data(), &bakedSkeleton, sizeof(BakedSkeleton_t));
+	AddSection(BAKE_SECTION_SKELETON, 0, data);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Fills the empty skeleton with the baked bones, returning false if there isn't a usable skeleton in the bake
+//
+bool BakeFile::ReadSkeleton(Skeleton* out_skeleton) const
+{
+	const BakeSection_t* section = FindSection(BAKE_SECTION_SKELETON, 0);
+	if (section == nullptr || section->size < sizeof(BakedSkeleton_t))
+	{
+		return false;
+	}
+
+	const BakedSkeleton_t* bakedSkeleton = (const BakedSkeleton_t*) section->data;
+	bool isValid = bakedSkeleton->boneDataSize == sizeof(BoneData_t)
+		&& IsRangeInBuffer(section->size, bakedSkeleton->boneDataOffset, bakedSkeleton->boneCount, sizeof(BoneData_t))
+		&& IsRangeInBuffer(section->size, bakedSkeleton->nameOffsetsOffset, bakedSkeleton->boneCount, sizeof(uint32_t));
+
+	if (!isValid)
+	{
+		return false;
+	}
+
+	const BoneData_t* boneData = (const BoneData_t*)(section->data + bakedSkeleton->boneDataOffset);
+	const uint32_t* nameOffsets = (const uint32_t*)(section->data + bakedSkeleton->nameOffsetsOffset);
+
+	for (uint32_t boneIndex = 0; boneIndex < bakedSkeleton->boneCount; ++boneIndex)
+	{
+		if (GetStringInBuffer(section->data, section->size, nameOffsets[boneIndex]) == nullptr)
+		{
+			return false;
+		}
+	}
+
+	// Bones were baked in mapping order, so creating the mappings in order gives back the same indices
+	for (uint32_t boneIndex = 0; boneIndex < bakedSkeleton->boneCount; ++boneIndex)
+	{
+		const BoneData_t& bone = boneData[boneIndex];
+		int mapping = out_skeleton->CreateOrGetBoneMapping(GetStringInBuffer(section->data, section->size, nameOffsets[boneIndex]));
+
+		out_skeleton->SetLocalTransform(mapping, bone.localTransform);
+		out_skeleton->SetWorldTransform(mapping, bone.worldTransform);
+		out_skeleton->SetBoneToMeshMatrix(mapping, bone.boneToMeshMatrix);
+		out_skeleton->SetMeshToBoneMatrix(mapping, bone.meshToBoneMatrix);
+		out_skeleton->SetOffsetMatrix(mapping, bone.offsetMatrix);
+		out_skeleton->SetBonePreRotation(mapping, bone.preRotation);
+		out_skeleton->SetParentBoneIndex(mapping, bone.parentIndex);
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the clips' compressed keys, so reading them back skips both sampling and compression
+//
+void BakeFile::AddAnimations(uint64_t key, const std::vector<AnimationClip*>& clips)
+{
+	if (!m_isSourceReadable)
+	{
+		return;
+	}
+
+	std::vector<uint8_t> data(sizeof(BakedAnimationSection_t));
+	std::vector<BakedClip_t> bakedClips(clips.size());
+
+	for (size_t clipIndex = 0; clipIndex < clips.size(); ++clipIndex)
+	{
+		const AnimationClip* clip = clips[clipIndex];
+		BakedClip_t& bakedClip = bakedClips[clipIndex];
+
+		memset(&bakedClip, 0, sizeof(BakedClip_t));
+		bakedClip.nameOffset = AppendString(data, clip->m_name);
+		bakedClip.frameCount = clip->m_numFrames;
+		bakedClip.framesPerSecond = clip->m_framesPerSecond;
+		bakedClip.rotationInterpolation = (uint32_t) clip->m_rotationInterpolation;
+
+		bakedClip.translationTolerance = clip->m_compressionSettings.translationTolerance;
+		bakedClip.rotationToleranceDegrees = clip->m_compressionSettings.rotationToleranceDegrees;
+		bakedClip.scaleTolerance = clip->m_compressionSettings.scaleTolerance;
+
+		bakedClip.tracks = AppendArray(data, clip->m_tracks);
+		bakedClip.translationKeyFrames = AppendArray(data, clip->m_translationKeyFrames);
+		bakedClip.translationKeys = AppendArray(data, clip->m_translationKeys);
+		bakedClip.rotationKeyFrames = AppendArray(data, clip->m_rotationKeyFrames);
+		bakedClip.rotationKeys = AppendArray(data, clip->m_rotationKeys);
+		bakedClip.scaleKeyFrames = AppendArray(data, clip->m_scaleKeyFrames);
+		bakedClip.scaleKeys = AppendArray(data, clip->m_scaleKeys);
+	}
+
+	BakedAnimationSection_t sectionHeader;
+	sectionHeader.clipCount = (uint32_t) clips.size();
+	sectionHeader.reserved = 0;
+	sectionHeader.clipTableOffset = AppendArray(data, bakedClips).offset;
+
+	memcpy(data.data(), &sectionHeader, sizeof(BakedAnimationSection_t));
+	AddSection(BAKE_SECTION_ANIMATIONS, key, data);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Creates the baked clips against the skeleton, returning false without creating any if the section
+// doesn't exist or doesn't fit the skeleton
+//
+bool BakeFile::ReadAnimations(uint64_t key, const Skeleton* skeleton, std::vector<AnimationClip*>& out_clips) const
+{
+	const BakeSection_t* section = FindSection(BAKE_SECTION_ANIMATIONS, key);
+	if (section == nullptr || section->size < sizeof(BakedAnimationSection_t))
+	{
+		return false;
+	}
+
+	const BakedAnimationSection_t* sectionHeader = (const BakedAnimationSection_t*) section->data;
+	if (!IsRangeInBuffer(section->size, sectionHeader->clipTableOffset, sectionHeader->clipCount, sizeof(BakedClip_t)))
+	{
+		return false;
+	}
+
+	const BakedClip_t* bakedClips = (const BakedClip_t*)(section->data + sectionHeader->clipTableOffset);
+	std::vector<AnimationClip*> clips;
+	bool isValid = true;
+
+	for (uint32_t clipIndex = 0; clipIndex < sectionHeader->clipCount && isValid; ++clipIndex)
+	{
+		const BakedClip_t& bakedClip = bakedClips[clipIndex];
+		const char* name = GetStringInBuffer(section->data, section->size, bakedClip.nameOffset);
+
+		isValid = name != nullptr
+			&& bakedClip.frameCount > 0 && bakedClip.frameCount <= 0xffff
+			&& bakedClip.framesPerSecond > 0.f
+			&& bakedClip.tracks.count == skeleton->GetBoneCount();
+
+		if (!isValid)
+		{
+			break;
+		}
+
+		AnimationClip* clip = new AnimationClip();
+		clip->Initialize(bakedClip.frameCount, skeleton, bakedClip.framesPerSecond);
+		clip->SetName(name);
+		clip->m_rotationInterpolation = (RotationInterpolationMode) bakedClip.rotationInterpolation;
+
+		clip->m_compressionSettings.translationTolerance = bakedClip.translationTolerance;
+		clip->m_compressionSettings.rotationToleranceDegrees = bakedClip.rotationToleranceDegrees;
+		clip->m_compressionSettings.scaleTolerance = bakedClip.scaleTolerance;
+
+		isValid = ReadArray(section->data, section->size, bakedClip.tracks, clip->m_tracks)
+			&& ReadArray(section->data, section->size, bakedClip.translationKeyFrames, clip->m_translationKeyFrames)
+			&& ReadArray(section->data, section->size, bakedClip.translationKeys, clip->m_translationKeys)
+			&& ReadArray(section->data, section->size, bakedClip.rotationKeyFrames, clip->m_rotationKeyFrames)
+			&& ReadArray(section->data, section->size, bakedClip.rotationKeys, clip->m_rotationKeys)
+			&& ReadArray(section->data, section->size, bakedClip.scaleKeyFrames, clip->m_scaleKeyFrames)
+			&& ReadArray(section->data, section->size, bakedClip.scaleKeys, clip->m_scaleKeys)
+			&& bakedClip.translationKeyFrames.count == bakedClip.translationKeys.count
+			&& bakedClip.rotationKeyFrames.count == bakedClip.rotationKeys.count
+			&& bakedClip.scaleKeyFrames.count == bakedClip.scaleKeys.count;
+
+		// Sampling trusts the track ranges, so make sure they're inside the key arrays
+		for (size_t trackIndex = 0; trackIndex < clip->m_tracks.size() && isValid; ++trackIndex)
+		{
+			const BoneTrack_t& track = clip->m_tracks[trackIndex];
+
+			isValid = IsRangeInBuffer(clip->m_translationKeys.size(), track.firstTranslationKey, track.translationKeyCount, 1)
+				&& IsRangeInBuffer(clip->m_rotationKeys.size(), track.firstRotationKey, track.rotationKeyCount, 1)
+				&& IsRangeInBuffer(clip->m_scaleKeys.size(), track.firstScaleKey, track.scaleKeyCount, 1)
+				&& track.firstTranslationKey >= 0 && track.firstRotationKey >= 0 && track.firstScaleKey >= 0;
+		}
+
+		clips.push_back(clip);
+	}
+
+	if (!isValid)
+	{
+		for (size_t clipIndex = 0; clipIndex < clips.size(); ++clipIndex)
+		{
+			delete clips[clipIndex];
+		}
+
+		return false;
+	}
+
+	out_clips.insert(out_clips.end(), clips.begin(), clips.end());
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the image's compressed levels, replacing any with the same key
+//
+void BakeFile::AddCompressedImage(uint64_t key, const CompressedImage& image)
+{
+	if (!m_isSourceReadable)
+	{
+		return;
+	}
+
+	std::vector<uint8_t> data(sizeof(BakedTextureSection_t));
+	std::vector<BakedTextureMip_t> bakedMips(image.m_mips.size());
+
+	for (size_t mipIndex = 0; mipIndex < image.m_mips.size(); ++mipIndex)
+	{
+		bakedMips[mipIndex].width = (uint32_t) image.m_mips[mipIndex].dimensions.x;
+		bakedMips[mipIndex].height = (uint32_t) image.m_mips[mipIndex].dimensions.y;
+		bakedMips[mipIndex].offset = image.m_mips[mipIndex].offset;
+		bakedMips[mipIndex].size = image.m_mips[mipIndex].size;
+	}
+
+	BakedTextureSection_t sectionHeader;
+	sectionHeader.format = (uint32_t) image.m_format;
+	sectionHeader.reserved = 0;
+	sectionHeader.mips = AppendArray(data, bakedMips);
+	sectionHeader.blockData = AppendArray(data, image.m_blockData);
+
+	memcpy(data.data(), &sectionHeader, sizeof(BakedTextureSection_t));
+	AddSection(BAKE_SECTION_TEXTURE, key, data);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Fills the image with the baked levels, returning false if the section doesn't exist or doesn't add up
+//
+bool BakeFile::ReadCompressedImage(uint64_t key, CompressedImage& out_image) const
+{
+	const BakeSection_t* section = FindSection(BAKE_SECTION_TEXTURE, key);
+	if (section == nullptr || section->size < sizeof(BakedTextureSection_t))
+	{
+		return false;
+	}
+
+	const BakedTextureSection_t* sectionHeader = (const BakedTextureSection_t*) section->data;
+	std::vector<BakedTextureMip_t> bakedMips;
+
+	bool isValid = sectionHeader->format < NUM_BLOCK_FORMATS
+		&& sectionHeader->mips.count > 0
+		&& ReadArray(section->data, section->size, sectionHeader->mips, bakedMips)
+		&& IsRangeInBuffer(section->size, sectionHeader->blockData.offset, sectionHeader->blockData.count, 1);
+
+	if (!isValid)
+	{
+		return false;
+	}
+
+	// Uploads trust the level sizes, so check them against the dimensions
+	BlockCompressionFormat format = (BlockCompressionFormat) sectionHeader->format;
+	std::vector<CompressedImage::CompressedMip_t> mips(bakedMips.size());
+
+	for (size_t mipIndex = 0; mipIndex < bakedMips.size(); ++mipIndex)
+	{
+		const BakedTextureMip_t& bakedMip = bakedMips[mipIndex];
+		mips[mipIndex].dimensions = IntVector2((int) bakedMip.width, (int) bakedMip.height);
+		mips[mipIndex].offset = (size_t) bakedMip.offset;
+		mips[mipIndex].size = (size_t) bakedMip.size;
+
+		if (bakedMip.width == 0 || bakedMip.height == 0 || bakedMip.width > 0xffff || bakedMip.height > 0xffff
+			|| bakedMip.size != GetBlockCompressedSize(format, mips[mipIndex].dimensions)
+			|| !IsRangeInBuffer((size_t) sectionHeader->blockData.count, bakedMip.offset, bakedMip.size, 1))
+		{
+			return false;
+		}
+	}
+
+	out_image.m_format = format;
+	out_image.m_mips.swap(mips);
+
+	ReadArray(section->data, section->size, sectionHeader->blockData, out_image.m_blockData);
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a 64-bit hash of the bytes, eight at a time - used to tell whether a source file changed,
+// so it only needs to be fast and well mixed, not secure
+//
+uint64_t BakeFile::HashBytes(const void* data, size_t byteCount, uint64_t seed /*= 0*/)
+{
+	static const uint64_t WORD_MULTIPLIER = 0xbf58476d1ce4e5b9ULL;
+	static const uint64_t HASH_MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+	const uint8_t* bytes = (const uint8_t*) data;
+	uint64_t hash = seed ^ (byteCount * HASH_MULTIPLIER);
+
+	size_t wordCount = byteCount / sizeof(uint64_t);
+	for (size_t wordIndex = 0; wordIndex <= wordCount; ++wordIndex)
+	{
+		uint64_t word = 0;
+
+		// The last word is whatever bytes are left over, zero padded
+		size_t wordSize = (wordIndex < wordCount ? sizeof(uint64_t) : byteCount - wordCount * sizeof(uint64_t));
+		memcpy(&word, bytes + wordIndex * sizeof(uint64_t), wordSize);
+
+		word *= WORD_MULTIPLIER;
+		word ^= (word >> 31);
+
+		hash = (hash ^ word) * HASH_MULTIPLIER;
+		hash = (hash << 27) | (hash >> 37);
+	}
+
+	hash ^= (hash >> 33);
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= (hash >> 33);
+
+	return hash;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a hash of the skeleton's bone names and hierarchy, which is what bone indices in
+// skinned vertices and animation tracks depend on
+//
+uint64_t BakeFile::HashSkeleton(const Skeleton* skeleton)
+{
+	if (skeleton == nullptr)
+	{
+		return 0;
+	}
+
+	unsigned int boneCount = skeleton->GetBoneCount();
+	std::vector<std::string> boneNames = skeleton->GetAllBoneNames();
+
+	uint64_t hash = HashBytes(skeleton->GetParentIndices(), boneCount * sizeof(int), boneCount);
+	for (unsigned int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		hash = HashBytes(boneNames[boneIndex].c_str(), boneNames[boneIndex].size(), hash);
+	}
+
+	// Keep 0 for "no skeleton"
+	return (hash == 0 ? 1 : hash);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the path of the bake for the given source file, which sits next to it
+//
+std::string BakeFile::GetBakePathForSource(const std::string& sourcePath)
+{
+	return sourcePath + ".bake";
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the section of the given type and key, or nullptr if it isn't in the bake
+//
+const BakeFile::BakeSection_t* BakeFile::FindSection(BakeSectionType type, uint64_t key) const
+{
+	for (size_t sectionIndex = 0; sectionIndex < m_sections.size(); ++sectionIndex)
+	{
+		if (m_sections[sectionIndex].type == type && m_sections[sectionIndex].key == key)
+		{
+			return &m_sections[sectionIndex];
+		}
+	}
+
+	return nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Copies the sections still in the mapped bake into memory, then unmaps it
+//
+void BakeFile::ReleaseMappedSections()
+{
+	if (!m_bakeFile.IsOpen())
+	{
+		return;
+	}
+
+	for (size_t sectionIndex = 0; sectionIndex < m_sections.size(); ++sectionIndex)
+	{
+		BakeSection_t& section = m_sections[sectionIndex];
+
+		if (section.data != section.ownedData.data())
+		{
+			section.ownedData.assign(section.data, section.data + section.size);
+			section.data = section.ownedData.data();
+		}
+	}
+
+	m_bakeFile.Close();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Takes the data as a new section, replacing any section with the same type and key
+//
+void BakeFile::AddSection(BakeSectionType type, uint64_t key, std::vector<uint8_t>& data)
+{
+	BakeSection_t* section = const_cast<BakeSection_t*>(FindSection(type, key));
+
+	if (section == nullptr)
+	{
+		m_sections.emplace_back();
+		section = &m_sections.back();
+	}
+
+	section->type = type;
+	section->key = key;
+	section->ownedData.swap(data);
+	section->data = section->ownedData.data();
+	section->size = section->ownedData.size();
+
+	m_hasUnsavedSections = true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends the bytes at the next multiple of the alignment, returning the offset they were written at
+//
+static size_t AppendBytes(std::vector<uint8_t>& buffer, const void* data, size_t byteCount, size_t alignment /*= BAKE_ALIGNMENT*/)
+{
+	size_t offset = (buffer.size() + alignment - 1) & ~(alignment - 1);
+	buffer.resize(offset + byteCount, 0);
+
+	if (byteCount > 0)
+	{
+		memcpy(&buffer[offset], data, byteCount);
+	}
+
+	return offset;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends the text null terminated, returning its offset - or 0 for empty text, which reads back as empty
+//
+static uint32_t AppendString(std::vector<uint8_t>& buffer, const std::string& text)
+{
+	if (text.empty())
+	{
+		return 0;
+	}
+
+	return (uint32_t) AppendBytes(buffer, text.c_str(), text.size() + 1, 1);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if count elements of the given size starting at offset fit in the buffer, without overflowing
+//
+static bool IsRangeInBuffer(size_t bufferSize, uint64_t offset, uint64_t count, size_t elementSize)
+{
+	if (offset > bufferSize)
+	{
+		return false;
+	}
+
+	return (count <= (bufferSize - offset) / elementSize);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the null terminated string at the offset, "" for offset 0, or nullptr if it runs off the end of the buffer
+//
+static const char* GetStringInBuffer(const uint8_t* buffer, size_t bufferSize, uint32_t offset)
+{
+	if (offset == 0)
+	{
+		return "";
+	}
+
+	if (offset >= bufferSize || memchr(buffer + offset, 0, bufferSize - offset) == nullptr)
+	{
+		return nullptr;
+	}
+
+	return (const char*)(buffer + offset);
+}
@@ -0,0 +1,113 @@
+/************************************************************************/
+/* File: BakeFile.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Binary cache of imported mesh, skeleton, animation and
+/*				compressed texture data, kept next to the source file and
+/*				rebuilt when it changes
+/************************************************************************/
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "Engine/Core/File.hpp"
+
+class Mesh;
+class Skeleton;
+class MeshBuilder;
+class AnimationClip;
+class CompressedImage;
+
+// Bump when a section layout or the import code that fills one changes, so old bakes are rebuilt rather than misread
+#define BAKE_FILE_VERSION (2)
+
+enum BakeSectionType : uint32_t
+{
+	BAKE_SECTION_MESHES,		// Vertex and index streams, plus the texture paths each mesh's material used
+	BAKE_SECTION_SKELETON,
+	BAKE_SECTION_ANIMATIONS,
+	BAKE_SECTION_TEXTURE		// Block compressed levels, keyed by whether the mip chain is included
+};
+
+// Textures a baked mesh's material was built from, empty where the source had none
+struct BakedMaterialPaths_t
+{
+	std::string diffusePath;
+	std::string normalPath;
+};
+
+class BakeFile
+{
+public:
+	//-----Public Methods-----
+
+	~BakeFile();
+
+	// Reads the bake next to the source, returning false if there isn't one made from the source's current contents
+	// Sections can be added and saved either way, as long as the source itself could be read
+	bool	Open(const std::string& sourcePath);
+	bool	Save();
+	void	Close();	// Saves if any sections were added
+
+	// Meshes are added one at a time between Begin/End, and read back as GPU meshes made straight from the file data
+	void	BeginMeshSection(uint64_t key);
+	void	AddMesh(MeshBuilder& mb, bool useSkinnedVertices, const std::string& diffusePath = "", const std::string& normalPath = "");
+	void	EndMeshSection();
+	bool	ReadMeshes(uint64_t key, std::vector<Mesh*>& out_meshes, std::vector<BakedMaterialPaths_t>* out_materials = nullptr) const;
+	bool	HasMeshes(uint64_t key) const;	// For checking off the main thread, where the meshes can't be read
+
+	void	AddSkeleton(const Skeleton* skeleton);
+	bool	ReadSkeleton(Skeleton* out_skeleton) const;
+
+	// Clips are read back against the skeleton they're keyed to, which must match the one they were baked with
+	void	AddAnimations(uint64_t key, const std::vector<AnimationClip*>& clips);
+	bool	ReadAnimations(uint64_t key, const Skeleton* skeleton, std::vector<AnimationClip*>& out_clips) const;
+
+	void	AddCompressedImage(uint64_t key, const CompressedImage& image);
+	bool	ReadCompressedImage(uint64_t key, CompressedImage& out_image) const;
+
+	// Producers
+	static uint64_t		HashBytes(const void* data, size_t byteCount, uint64_t seed = 0);
+	static uint64_t		HashSkeleton(const Skeleton* skeleton);	// 0 for no skeleton, for keying data built against one
+	static std::string	GetBakePathForSource(const std::string& sourcePath);
+
+
+private:
+	//-----Private Methods-----
+
+	// Sections read from disk point into the mapped bake, added ones own their bytes
+	struct BakeSection_t
+	{
+		BakeSectionType			type;
+		uint64_t				key = 0;
+		const uint8_t*			data = nullptr;
+		size_t					size = 0;
+		std::vector<uint8_t>	ownedData;
+	};
+
+	const BakeSection_t*	FindSection(BakeSectionType type, uint64_t key) const;
+	void					ReleaseMappedSections();
+	void					AddSection(BakeSectionType type, uint64_t key, std::vector<uint8_t>& data);
+
+
+private:
+	//-----Private Data-----
+
+	std::string					m_sourcePath;
+	uint64_t					m_sourceHash = 0;
+	uint64_t					m_sourceSize = 0;
+	bool						m_isSourceReadable = false;
+	bool						m_hasUnsavedSections = false;
+
+	// The bake is mapped and sections are used in place, so nothing here is copied until it's needed
+	MappedFile					m_bakeFile;
+	std::vector<BakeSection_t>	m_sections;
+
+	// Mesh section being built between BeginMeshSection() and EndMeshSection()
+	bool						m_isBuildingMeshSection = false;
+	uint64_t					m_pendingMeshKey = 0;
+	std::vector<uint8_t>		m_pendingMeshData;
+	std::vector<uint8_t>		m_pendingMeshTable;
+	unsigned int				m_pendingMeshCount = 0;
+
+};
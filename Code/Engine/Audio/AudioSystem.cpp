@@ -1,6 +1,7 @@
 #include "Engine/Assets/AssetDB.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Core/File.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Rendering/Core/Renderer.hpp"
 #include "Engine/Core/Utility/StringUtils.hpp"
@@ -121,7 +122,20 @@ SoundID AudioSystem::CreateOrGetSound( const std::string& soundFilePath )
 	else
 	{
 		FMOD::Sound* newSound = nullptr;
-		m_fmodSystem->createSound( soundFilePath.c_str(), FMOD_DEFAULT, nullptr, &newSound );
+
+		// Opened from memory so sounds resolve through mounted packs - FMOD copies the data for non-streamed sounds,
+		// so the file can be closed right after
+		MappedFile soundFile;
+		if (soundFile.Open(soundFilePath.c_str()) && soundFile.GetSize() > 0)
+		{
+			FMOD_CREATESOUNDEXINFO soundInfo;
+			memset(&soundInfo, 0, sizeof(FMOD_CREATESOUNDEXINFO));
+			soundInfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+			soundInfo.length = (unsigned int) soundFile.GetSize();
+
+			m_fmodSystem->createSound( soundFile.GetData(), FMOD_DEFAULT | FMOD_CREATESAMPLE | FMOD_OPENMEMORY, &soundInfo, &newSound );
+		}
+
 		if( newSound )
 		{
 			SoundID newSoundID = m_registeredSounds.size();
@@ -311,7 +325,7 @@ void AudioSystem::LoadAudioGroupFile(const std::string& filepath)
 {
 	// Load the document
 	XMLDocument document;
-	XMLError error = document.LoadFile(filepath.c_str());
+	XMLError error = LoadXmlDocument(document, filepath);
 
 	if (error != tinyxml2::XML_SUCCESS)
 	{
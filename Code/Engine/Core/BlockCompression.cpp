@@ -0,0 +1,461 @@
+/************************************************************************/
+/* File: BlockCompression.cpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Implementation of the BC1/BC3 block encoder and decoder
+/************************************************************************/
+#include <string.h>
+#include "Engine/Core/BlockCompression.hpp"
+#include "Engine/Math/IntVector2.hpp"
+
+// Bytes per 4x4 block
+static const size_t BLOCK_SIZES[NUM_BLOCK_FORMATS] = { 8, 16 };
+
+
+//-----------------------------------------------------------------------------------------------
+// Packs an 8 bit color into 5:6:5, rounding to nearest
+//
+static uint16_t PackColor565(const int color[3])
+{
+	int r = (color[0] * 31 + 127) / 255;
+	int g = (color[1] * 63 + 127) / 255;
+	int b = (color[2] * 31 + 127) / 255;
+
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Expands a 5:6:5 color back out to 8 bits per channel by replicating the high bits, as the GPU does
+//
+static void UnpackColor565(uint16_t packed, int out_color[3])
+{
+	int r = (packed >> 11) & 31;
+	int g = (packed >> 5) & 63;
+	int b = packed & 31;
+
+	out_color[0] = (r << 3) | (r >> 2);
+	out_color[1] = (g << 2) | (g >> 4);
+	out_color[2] = (b << 3) | (b >> 2);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Builds the 4 entry palette for a pair of endpoints, in 4 color mode (color0 > color1)
+// or 3 color + black mode otherwise - BC3 color blocks always use 4 color mode
+//
+static void BuildColorPalette(uint16_t color0, uint16_t color1, bool forceFourColorMode, int out_palette[4][4])
+{
+	UnpackColor565(color0, out_palette[0]);
+	UnpackColor565(color1, out_palette[1]);
+	out_palette[0][3] = 255;
+	out_palette[1][3] = 255;
+
+	if (forceFourColorMode || color0 > color1)
+	{
+		for (int channelIndex = 0; channelIndex < 3; ++channelIndex)
+		{
+			out_palette[2][channelIndex] = (2 * out_palette[0][channelIndex] + out_palette[1][channelIndex]) / 3;
+			out_palette[3][channelIndex] = (out_palette[0][channelIndex] + 2 * out_palette[1][channelIndex]) / 3;
+		}
+
+		out_palette[2][3] = 255;
+		out_palette[3][3] = 255;
+	}
+	else
+	{
+		for (int channelIndex = 0; channelIndex < 3; ++channelIndex)
+		{
+			out_palette[2][channelIndex] = (out_palette[0][channelIndex] + out_palette[1][channelIndex]) / 2;
+			out_palette[3][channelIndex] = 0;
+		}
+
+		out_palette[2][3] = 255;
+		out_palette[3][3] = 0;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Builds the 8 entry palette for a pair of alpha endpoints, in 8 step mode (alpha0 > alpha1)
+// or 6 step + 0 and 255 mode otherwise
+//
+static void BuildAlphaPalette(int alpha0, int alpha1, int out_palette[8])
+{
+	out_palette[0] = alpha0;
+	out_palette[1] = alpha1;
+
+	if (alpha0 > alpha1)
+	{
+		for (int stepIndex = 1; stepIndex < 7; ++stepIndex)
+		{
+			out_palette[stepIndex + 1] = ((7 - stepIndex) * alpha0 + stepIndex * alpha1) / 7;
+		}
+	}
+	else
+	{
+		for (int stepIndex = 1; stepIndex < 5; ++stepIndex)
+		{
+			out_palette[stepIndex + 1] = ((5 - stepIndex) * alpha0 + stepIndex * alpha1) / 5;
+		}
+
+		out_palette[6] = 0;
+		out_palette[7] = 255;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Copies the 4x4 block at the given block coordinates out of the image, clamping at the edges
+//
+static void GatherBlock(const unsigned char* rgbaTexels, const IntVector2& dimensions, int blockX, int blockY, unsigned char out_block[64])
+{
+	for (int y = 0; y < 4; ++y)
+	{
+		int sourceY = blockY * 4 + y;
+		sourceY = (sourceY < dimensions.y ? sourceY : dimensions.y - 1);
+
+		for (int x = 0; x < 4; ++x)
+		{
+			int sourceX = blockX * 4 + x;
+			sourceX = (sourceX < dimensions.x ? sourceX : dimensions.x - 1);
+
+			memcpy(&out_block[(y * 4 + x) * 4], &rgbaTexels[(sourceY * dimensions.x + sourceX) * 4], 4);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Encodes the color of a block into 8 bytes, always in 4 color mode
+// Endpoints are the texels furthest apart along the block's principal axis, pulled in slightly
+// so the interpolated colors land on the spread of the block instead of its outliers
+//
+static void EncodeColorBlock(const unsigned char block[64], unsigned char* out_encoded)
+{
+	// Mean and covariance of the block's colors
+	float mean[3] = { 0.f, 0.f, 0.f };
+	for (int texelIndex = 0; texelIndex < 16; ++texelIndex)
+	{
+		mean[0] += block[texelIndex * 4 + 0];
+		mean[1] += block[texelIndex * 4 + 1];
+		mean[2] += block[texelIndex * 4 + 2];
+	}
+
+	mean[0] /= 16.f;
+	mean[1] /= 16.f;
+	mean[2] /= 16.f;
+
+	float covariance[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f }; // rr, rg, rb, gg, gb, bb
+	for (int texelIndex = 0; texelIndex < 16; ++texelIndex)
+	{
+		float r = block[texelIndex * 4 + 0] - mean[0];
+		float g = block[texelIndex * 4 + 1] - mean[1];
+		float b = block[texelIndex * 4 + 2] - mean[2];
+
+		covariance[0] += r * r;
+		covariance[1] += r * g;
+		covariance[2] += r * b;
+		covariance[3] += g * g;
+		covariance[4] += g * b;
+		covariance[5] += b * b;
+	}
+
+	// Principal axis by power iteration, a few steps is plenty for picking endpoints
+	float axis[3] = { 1.f, 1.f, 1.f };
+	for (int iteration = 0; iteration < 4; ++iteration)
+	{
+		float r = axis[0] * covariance[0] + axis[1] * covariance[1] + axis[2] * covariance[2];
+		float g = axis[0] * covariance[1] + axis[1] * covariance[3] + axis[2] * covariance[4];
+		float b = axis[0] * covariance[2] + axis[1] * covariance[4] + axis[2] * covariance[5];
+
+		float largest = (r > g ? r : g);
+		largest = (largest > b ? largest : b);
+		float smallest = (r < g ? r : g);
+		smallest = (smallest < b ? smallest : b);
+		largest = (largest > -smallest ? largest : -smallest);
+
+		if (largest <= 0.f)
+		{
+			break; // Solid block, any axis will do
+		}
+
+		axis[0] = r / largest;
+		axis[1] = g / largest;
+		axis[2] = b / largest;
+	}
+
+	int minIndex = 0;
+	int maxIndex = 0;
+	float minProjection = 0.f;
+	float maxProjection = 0.f;
+
+	for (int texelIndex = 0; texelIndex < 16; ++texelIndex)
+	{
+		float projection = block[texelIndex * 4 + 0] * axis[0] + block[texelIndex * 4 + 1] * axis[1] + block[texelIndex * 4 + 2] * axis[2];
+
+		if (texelIndex == 0 || projection < minProjection)
+		{
+			minProjection = projection;
+			minIndex = texelIndex;
+		}
+
+		if (texelIndex == 0 || projection > maxProjection)
+		{
+			maxProjection = projection;
+			maxIndex = texelIndex;
+		}
+	}
+
+	int maxColor[3];
+	int minColor[3];
+	for (int channelIndex = 0; channelIndex < 3; ++channelIndex)
+	{
+		int high = block[maxIndex * 4 + channelIndex];
+		int low = block[minIndex * 4 + channelIndex];
+		int inset = (high - low) / 16;
+
+		maxColor[channelIndex] = high - inset;
+		minColor[channelIndex] = low + inset;
+	}
+
+	uint16_t color0 = PackColor565(maxColor);
+	uint16_t color1 = PackColor565(minColor);
+
+	if (color0 < color1)
+	{
+		uint16_t temp = color0;
+		color0 = color1;
+		color1 = temp;
+	}
+
+	uint32_t indices = 0;
+
+	// Equal endpoints would read as 3 color mode in BC1, but index 0 is color0 in both modes
+	if (color0 != color1)
+	{
+		int palette[4][4];
+		BuildColorPalette(color0, color1, true, palette);
+
+		for (int texelIndex = 0; texelIndex < 16; ++texelIndex)
+		{
+			int bestIndex = 0;
+			int bestDistance = 0x7FFFFFFF;
+
+			for (int paletteIndex = 0; paletteIndex < 4; ++paletteIndex)
+			{
+				int dr = block[texelIndex * 4 + 0] - palette[paletteIndex][0];
+				int dg = block[texelIndex * 4 + 1] - palette[paletteIndex][1];
+				int db = block[texelIndex * 4 + 2] - palette[paletteIndex][2];
+				int distance = dr * dr + dg * dg + db * db;
+
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = paletteIndex;
+				}
+			}
+
+			indices |= ((uint32_t)bestIndex << (texelIndex * 2));
+		}
+	}
+
+	// Little endian, as the GPU reads it
+	out_encoded[0] = (unsigned char)(color0 & 0xFF);
+	out_encoded[1] = (unsigned char)(color0 >> 8);
+	out_encoded[2] = (unsigned char)(color1 & 0xFF);
+	out_encoded[3] = (unsigned char)(color1 >> 8);
+	out_encoded[4] = (unsigned char)(indices & 0xFF);
+	out_encoded[5] = (unsigned char)((indices >> 8) & 0xFF);
+	out_encoded[6] = (unsigned char)((indices >> 16) & 0xFF);
+	out_encoded[7] = (unsigned char)(indices >> 24);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Encodes the alpha of a block into 8 bytes, in 8 step mode between the block's min and max alpha
+//
+static void EncodeAlphaBlock(const unsigned char block[64], unsigned char* out_encoded)
+{
+	int alpha0 = block[3];
+	int alpha1 = block[3];
+
+	for (int texelIndex = 1; texelIndex < 16; ++texelIndex)
+	{
+		int alpha = block[texelIndex * 4 + 3];
+		alpha0 = (alpha > alpha0 ? alpha : alpha0);
+		alpha1 = (alpha < alpha1 ? alpha : alpha1);
+	}
+
+	uint64_t indices = 0;
+
+	if (alpha0 != alpha1)
+	{
+		int palette[8];
+		BuildAlphaPalette(alpha0, alpha1, palette);
+
+		for (int texelIndex = 0; texelIndex < 16; ++texelIndex)
+		{
+			int alpha = block[texelIndex * 4 + 3];
+			int bestIndex = 0;
+			int bestDistance = 256;
+
+			for (int paletteIndex = 0; paletteIndex < 8; ++paletteIndex)
+			{
+				int distance = (alpha > palette[paletteIndex] ? alpha - palette[paletteIndex] : palette[paletteIndex] - alpha);
+
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = paletteIndex;
+				}
+			}
+
+			indices |= ((uint64_t)bestIndex << (texelIndex * 3));
+		}
+	}
+
+	out_encoded[0] = (unsigned char)alpha0;
+	out_encoded[1] = (unsigned char)alpha1;
+
+	for (int byteIndex = 0; byteIndex < 6; ++byteIndex)
+	{
+		out_encoded[2 + byteIndex] = (unsigned char)((indices >> (byteIndex * 8)) & 0xFF);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Decodes 8 bytes of color into the RGB of a block, leaving alpha to the caller unless 3 color mode makes it transparent
+//
+static void DecodeColorBlock(const unsigned char* encoded, bool forceFourColorMode, unsigned char out_block[64])
+{
+	uint16_t color0 = (uint16_t)(encoded[0] | (encoded[1] << 8));
+	uint16_t color1 = (uint16_t)(encoded[2] | (encoded[3] << 8));
+	uint32_t indices = (uint32_t)encoded[4] | ((uint32_t)encoded[5] << 8) | ((uint32_t)encoded[6] << 16) | ((uint32_t)encoded[7] << 24);
+
+	int palette[4][4];
+	BuildColorPalette(color0, color1, forceFourColorMode, palette);
+
+	for (int texelIndex = 0; texelIndex < 16; ++texelIndex)
+	{
+		int paletteIndex = (indices >> (texelIndex * 2)) & 3;
+
+		out_block[texelIndex * 4 + 0] = (unsigned char)palette[paletteIndex][0];
+		out_block[texelIndex * 4 + 1] = (unsigned char)palette[paletteIndex][1];
+		out_block[texelIndex * 4 + 2] = (unsigned char)palette[paletteIndex][2];
+		out_block[texelIndex * 4 + 3] = (unsigned char)palette[paletteIndex][3];
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Decodes 8 bytes of alpha into the alpha channel of a block
+//
+static void DecodeAlphaBlock(const unsigned char* encoded, unsigned char out_block[64])
+{
+	int palette[8];
+	BuildAlphaPalette(encoded[0], encoded[1], palette);
+
+	uint64_t indices = 0;
+	for (int byteIndex = 0; byteIndex < 6; ++byteIndex)
+	{
+		indices |= ((uint64_t)encoded[2 + byteIndex] << (byteIndex * 8));
+	}
+
+	for (int texelIndex = 0; texelIndex < 16; ++texelIndex)
+	{
+		out_block[texelIndex * 4 + 3] = (unsigned char)palette[(indices >> (texelIndex * 3)) & 7];
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Encodes block rows [startBlockRow, endBlockRow) of the image, writing each row's blocks at its place in out_blocks
+//
+void CompressBlocks(BlockCompressionFormat format, const unsigned char* rgbaTexels, const IntVector2& dimensions, unsigned char* out_blocks, int startBlockRow, int endBlockRow)
+{
+	int blocksPerRow = (dimensions.x + 3) / 4;
+	size_t blockSize = BLOCK_SIZES[format];
+
+	unsigned char block[64];
+
+	for (int blockY = startBlockRow; blockY < endBlockRow; ++blockY)
+	{
+		for (int blockX = 0; blockX < blocksPerRow; ++blockX)
+		{
+			GatherBlock(rgbaTexels, dimensions, blockX, blockY, block);
+			unsigned char* encoded = out_blocks + ((size_t)blockY * blocksPerRow + blockX) * blockSize;
+
+			if (format == BLOCK_FORMAT_BC3)
+			{
+				EncodeAlphaBlock(block, encoded);
+				EncodeColorBlock(block, encoded + 8);
+			}
+			else
+			{
+				EncodeColorBlock(block, encoded);
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Decodes a whole image of blocks back to RGBA texels, matching what the GPU would sample
+//
+void DecompressBlocks(BlockCompressionFormat format, const unsigned char* blocks, const IntVector2& dimensions, unsigned char* out_rgbaTexels)
+{
+	int blocksPerRow = (dimensions.x + 3) / 4;
+	int blockRowCount = GetBlockRowCount(dimensions);
+	size_t blockSize = BLOCK_SIZES[format];
+
+	unsigned char block[64];
+
+	for (int blockY = 0; blockY < blockRowCount; ++blockY)
+	{
+		for (int blockX = 0; blockX < blocksPerRow; ++blockX)
+		{
+			const unsigned char* encoded = blocks + ((size_t)blockY * blocksPerRow + blockX) * blockSize;
+
+			if (format == BLOCK_FORMAT_BC3)
+			{
+				DecodeColorBlock(encoded + 8, true, block);
+				DecodeAlphaBlock(encoded, block);
+			}
+			else
+			{
+				DecodeColorBlock(encoded, false, block);
+			}
+
+			// Drop the texels that only padded out the edge blocks
+			for (int y = 0; y < 4 && blockY * 4 + y < dimensions.y; ++y)
+			{
+				for (int x = 0; x < 4 && blockX * 4 + x < dimensions.x; ++x)
+				{
+					int destIndex = (blockY * 4 + y) * dimensions.x + (blockX * 4 + x);
+					memcpy(&out_rgbaTexels[destIndex * 4], &block[(y * 4 + x) * 4], 4);
+				}
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of rows of 4x4 blocks an image of the given size takes
+//
+int GetBlockRowCount(const IntVector2& dimensions)
+{
+	return (dimensions.y + 3) / 4;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the size in bytes of an image of the given size once block compressed
+//
+size_t GetBlockCompressedSize(BlockCompressionFormat format, const IntVector2& dimensions)
+{
+	size_t blockCount = (size_t)((dimensions.x + 3) / 4) * (size_t)GetBlockRowCount(dimensions);
+	return blockCount * BLOCK_SIZES[format];
+}
@@ -0,0 +1,26 @@
+/************************************************************************/
+/* File: BlockCompression.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: CPU encoder and decoder for BC1 and BC3 (DXT1/DXT5)
+/*				texture blocks, no GPU or GL calls
+/************************************************************************/
+#pragma once
+#include <stdint.h>
+
+class IntVector2;
+
+enum BlockCompressionFormat : uint32_t
+{
+	BLOCK_FORMAT_BC1,		// 8 bytes per 4x4 block, opaque color
+	BLOCK_FORMAT_BC3,		// 16 bytes per 4x4 block, color plus interpolated alpha
+	NUM_BLOCK_FORMATS
+};
+
+// Texels are tightly packed RGBA8 rows, images that aren't a multiple of 4 repeat their last row/column to fill the edge blocks
+// Block rows are independent, so ranges of [startBlockRow, endBlockRow) can be encoded on separate threads
+void	CompressBlocks(BlockCompressionFormat format, const unsigned char* rgbaTexels, const IntVector2& dimensions, unsigned char* out_blocks, int startBlockRow, int endBlockRow);
+void	DecompressBlocks(BlockCompressionFormat format, const unsigned char* blocks, const IntVector2& dimensions, unsigned char* out_rgbaTexels);
+
+int		GetBlockRowCount(const IntVector2& dimensions);
+size_t	GetBlockCompressedSize(BlockCompressionFormat format, const IntVector2& dimensions);
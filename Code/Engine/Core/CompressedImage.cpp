@@ -0,0 +1,231 @@
+/************************************************************************/
+/* File: CompressedImage.cpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Implementation of the CompressedImage class
+/************************************************************************/
+#include "Engine/Core/Image.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Assets/BakeFile.hpp"
+#include "Engine/Core/CompressedImage.hpp"
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
+#include "Engine/Core/Utility/ErrorWarningAssert.hpp"
+
+// Block rows are ~4x the work of a texel row, so levels need fewer texels than mips do to be worth splitting
+#define MIN_TEXELS_PER_COMPRESS_JOB (16 * 1024)
+
+// Job for compressing a range of block rows of one level
+class BlockCompressJob : public Job
+{
+public:
+
+	BlockCompressJob(BlockCompressionFormat format, const Image* source, unsigned char* destination, int startBlockRow, int endBlockRow)
+		: m_format(format), m_source(source), m_destination(destination), m_startBlockRow(startBlockRow), m_endBlockRow(endBlockRow)
+	{
+		m_jobType = JOB_TYPE_BLOCK_COMPRESS;
+		m_jobFlags = WORKER_FLAGS_ALL_BUT_DISK;
+	}
+
+	virtual void Execute() override;
+
+	BlockCompressionFormat	m_format;
+	const Image*			m_source = nullptr;
+	unsigned char*			m_destination = nullptr;
+	int						m_startBlockRow = 0;
+	int						m_endBlockRow = 0;
+
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Reads the compressed copy of the source out of its bake, returning false if there isn't one
+// for the source's current contents
+//
+bool CompressedImage::LoadFromCache(const std::string& sourcePath, bool hasMipMaps)
+{
+	BakeFile bake;
+
+	if (!bake.Open(sourcePath))
+	{
+		return false;
+	}
+
+	return bake.ReadCompressedImage((hasMipMaps ? 1 : 0), *this);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Writes this image into the source's bake, keeping whatever else the bake already has
+//
+bool CompressedImage::SaveToCache(const std::string& sourcePath, bool hasMipMaps) const
+{
+	BakeFile bake;
+	bake.Open(sourcePath);
+	bake.AddCompressedImage((hasMipMaps ? 1 : 0), *this);
+
+	return bake.Save();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the image can be block compressed without padding
+//
+bool CompressedImage::CanCompress(const Image& image)
+{
+	IntVector2 dimensions = image.GetTexelDimensions();
+
+	return image.GetNumComponentsPerTexel() == 4
+		&& dimensions.x > 0 && dimensions.y > 0
+		&& (dimensions.x % 4) == 0 && (dimensions.y % 4) == 0;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Compresses every level of the image, split across worker threads for the large ones unless already on one
+//
+void CompressedImage::CreateFromImage(const Image& image)
+{
+	GUARANTEE_OR_DIE(image.GetNumComponentsPerTexel() == 4, "Error: CompressedImage::CreateFromImage() requires an RGBA image");
+
+	// Opaque images don't need the alpha block, which halves their size
+	m_format = BLOCK_FORMAT_BC1;
+
+	const unsigned char* texels = image.GetImageData();
+	int texelCount = image.GetTexelCount();
+
+	for (int texelIndex = 0; texelIndex < texelCount; ++texelIndex)
+	{
+		if (texels[texelIndex * 4 + 3] != 255)
+		{
+			m_format = BLOCK_FORMAT_BC3;
+			break;
+		}
+	}
+
+	// Lay out every level first so the data is allocated once
+	int mipCount = image.GetMipLevelCount();
+	m_mips.resize(mipCount);
+
+	size_t totalSize = 0;
+	for (int mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		CompressedMip_t& mip = m_mips[mipIndex];
+		mip.dimensions = image.GetMipLevel(mipIndex)->GetTexelDimensions();
+		mip.offset = totalSize;
+		mip.size = GetBlockCompressedSize(m_format, mip.dimensions);
+
+		totalSize += mip.size;
+	}
+
+	m_blockData.resize(totalSize);
+
+	// Nested in a job (as async texture loads are) it all runs inline, since waiting would tie up the worker
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	bool canUseJobs = (jobSystem != nullptr && !JobSystem::IsOnWorkerThread());
+	int workerCount = (canUseJobs ? jobSystem->GetWorkerThreadCount(WORKER_FLAGS_ALL_BUT_DISK) : 0);
+
+	std::vector<int> jobIDs;
+
+	for (int mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+	{
+		const Image* source = image.GetMipLevel(mipIndex);
+		const CompressedMip_t& mip = m_mips[mipIndex];
+		unsigned char* destination = m_blockData.data() + mip.offset;
+
+		// The calling thread compresses the first split of each level itself
+		int blockRowCount = GetBlockRowCount(mip.dimensions);
+		int splitCount = ClampInt((mip.dimensions.x * mip.dimensions.y) / MIN_TEXELS_PER_COMPRESS_JOB, 1, MinInt(workerCount + 1, blockRowCount));
+		int blockRowsPerSplit = (blockRowCount + splitCount - 1) / splitCount;
+
+		// Levels don't depend on each other, so they can all be in flight at once
+		for (int startBlockRow = blockRowsPerSplit; startBlockRow < blockRowCount; startBlockRow += blockRowsPerSplit)
+		{
+			jobIDs.push_back(QueueJob(new BlockCompressJob(m_format, source, destination, startBlockRow, MinInt(startBlockRow + blockRowsPerSplit, blockRowCount))));
+		}
+
+		CompressBlocks(m_format, source->GetImageData(), mip.dimensions, destination, 0, MinInt(blockRowsPerSplit, blockRowCount));
+	}
+
+	if (jobIDs.size() > 0)
+	{
+		jobSystem->BlockUntilJobsAreFinalized(jobIDs);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Decodes the given level back into an RGBA image, as the GPU would sample it
+//
+Image* CompressedImage::CreateDecompressedImage(int mipLevel) const
+{
+	const CompressedMip_t& mip = m_mips[mipLevel];
+	unsigned char* texels = (unsigned char*)malloc(sizeof(unsigned char) * 4 * mip.dimensions.x * mip.dimensions.y);
+
+	DecompressBlocks(m_format, m_blockData.data() + mip.offset, mip.dimensions, texels);
+
+	return new Image(mip.dimensions, 4, texels);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the block format of every level
+//
+BlockCompressionFormat CompressedImage::GetFormat() const
+{
+	return m_format;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of levels, 1 if the image has no mip chain
+//
+int CompressedImage::GetMipLevelCount() const
+{
+	return (int) m_mips.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the texel dimensions of the given level
+//
+IntVector2 CompressedImage::GetMipDimensions(int mipLevel) const
+{
+	return m_mips[mipLevel].dimensions;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the blocks of the given level
+//
+const unsigned char* CompressedImage::GetMipData(int mipLevel) const
+{
+	return m_blockData.data() + m_mips[mipLevel].offset;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the size in bytes of the given level's blocks
+//
+size_t CompressedImage::GetMipSize(int mipLevel) const
+{
+	return m_mips[mipLevel].size;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the size in bytes of all levels
+//
+size_t CompressedImage::GetTotalSize() const
+{
+	return m_blockData.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Compresses the job's block rows
+//
+void BlockCompressJob::Execute()
+{
+	CompressBlocks(m_format, m_source->GetImageData(), m_source->GetTexelDimensions(), m_destination, m_startBlockRow, m_endBlockRow);
+}
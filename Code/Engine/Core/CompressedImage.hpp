@@ -0,0 +1,56 @@
+/************************************************************************/
+/* File: CompressedImage.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Block compressed image and its mip chain, cached in the
+/*				bake next to the source image
+/************************************************************************/
+#pragma once
+#include <string>
+#include <vector>
+#include "Engine/Math/IntVector2.hpp"
+#include "Engine/Core/BlockCompression.hpp"
+
+class Image;
+
+class CompressedImage
+{
+	friend class BakeFile;
+
+public:
+	//-----Public Methods-----
+
+	// Cache is keyed by the source's contents, so an edited image is recompressed on its next load
+	bool					LoadFromCache(const std::string& sourcePath, bool hasMipMaps);
+	bool					SaveToCache(const std::string& sourcePath, bool hasMipMaps) const;
+
+	// Compresses the image and its mip chain, as BC1 if it's fully opaque and BC3 otherwise
+	static bool				CanCompress(const Image& image);	// RGBA and a multiple of 4 texels on both sides, as the GPU requires
+	void					CreateFromImage(const Image& image);
+
+	// For checking the encoder without a GPU, caller owns the image
+	Image*					CreateDecompressedImage(int mipLevel) const;
+
+	BlockCompressionFormat	GetFormat() const;
+	int						GetMipLevelCount() const;
+	IntVector2				GetMipDimensions(int mipLevel) const;
+	const unsigned char*	GetMipData(int mipLevel) const;
+	size_t					GetMipSize(int mipLevel) const;
+	size_t					GetTotalSize() const;
+
+
+private:
+	//-----Private Data-----
+
+	struct CompressedMip_t
+	{
+		IntVector2	dimensions;
+		size_t		offset = 0;		// Into m_blockData
+		size_t		size = 0;
+	};
+
+	BlockCompressionFormat			m_format = BLOCK_FORMAT_BC1;
+	std::vector<CompressedMip_t>	m_mips;
+	std::vector<unsigned char>		m_blockData;	// Every level back to back, largest first
+
+};
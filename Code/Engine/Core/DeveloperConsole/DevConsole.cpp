@@ -777,16 +777,13 @@ void DevConsole::LoadCommandHistoryFromFile()
 		return;
 	}
 
-	file.LoadFileToMemory();
-
-	while (!file.IsAtEndOfFile())
+	const char* line = nullptr;
+	size_t lineLength = 0;
+	while (file.GetNextLine(line, lineLength))
 	{
-		std::string line;
-		file.GetNextLine(line);
-
-		if (line.size() > 0)
+		if (lineLength > 0)
 		{
-			m_commandHistory.push_back(line);
+			m_commandHistory.push_back(std::string(line, lineLength));
 		}
 	}
 
@@ -939,7 +936,7 @@ static void WriteToDevConsole(LogMessage_t log, void* args)
 
 	// No need to check for nullptr, as the callback is registered in DevConsole::Initialize()
 	ConsoleOutputText outputText;
-	outputText.m_text = Stringf("%s: %s\n", log.tag.c_str(), log.message.c_str());
+	outputText.m_text = Stringf("%s: %s\n", log.tag, log.message);
 
 	DevConsole::GetInstance()->AddToMessageQueue(outputText);
 }
@@ -1129,17 +1126,14 @@ void Command_RunBatchFile(Command& cmd)
 
 	ConsolePrintf(Rgba::GREEN, "-----Running Batch Job-----");
 
-	file.LoadFileToMemory();
-
 	int numCommandsSuccess = 0;
-	while (!file.IsAtEndOfFile())
+	const char* line = nullptr;
+	size_t lineLength = 0;
+	while (file.GetNextLine(line, lineLength))
 	{
-		std::string line;
-		file.GetNextLine(line);
-
-		if (line.size() > 0)
+		if (lineLength > 0)
 		{
-			bool commandSucceeded = Command::Run(line);
+			bool commandSucceeded = Command::Run(std::string(line, lineLength));
 			if (commandSucceeded)
 			{
 				++numCommandsSuccess;
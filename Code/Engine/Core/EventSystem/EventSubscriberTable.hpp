@@ -0,0 +1,234 @@
+/************************************************************************/
+/* File: EventSubscriberTable.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Flat, open addressed table of subscriber lists keyed by
+/*				event ID, for the EventSystem
+/************************************************************************/
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+template <typename SUBSCRIPTION_TYPE>
+class EventSubscriberTable
+{
+public:
+	//-----Public Methods-----
+
+	EventSubscriberTable() {}
+	~EventSubscriberTable();
+	EventSubscriberTable(const EventSubscriberTable& copy) = delete;
+
+	// Null if nothing ever subscribed to the key
+	std::vector<SUBSCRIPTION_TYPE*>*	Find(uint64_t key) const;
+	std::vector<SUBSCRIPTION_TYPE*>&	FindOrAdd(uint64_t key);
+
+	// Fires bracket their loop with these, so removals made by callbacks (even in nested fires) null the entry
+	// instead of shifting the list under the loop - the lists are compacted once the outermost dispatch ends
+	void	BeginDispatch();
+	void	EndDispatch();
+	void	Remove(std::vector<SUBSCRIPTION_TYPE*>& subscriptions, int index);
+
+
+private:
+	//-----Private Methods-----
+
+	int		FindSlot(uint64_t key) const;	// The key's slot, or the empty one it would go in
+	void	Grow();
+
+
+private:
+	//-----Private Data-----
+
+	// Lists are allocated separately so they stay put when the table grows, even mid-dispatch
+	// Emptied lists are kept, events are a small fixed set so there's no need for tombstones
+	struct Slot_t
+	{
+		uint64_t							key = 0;		// 0 is empty, StringID never hashes to it
+		std::vector<SUBSCRIPTION_TYPE*>*	subscriptions = nullptr;
+	};
+
+	std::vector<Slot_t>	m_slots;		// Power of two size
+	int					m_usedCount = 0;
+
+	// Deferred removals, the subscriptions aren't deleted mid-dispatch as one may be the callback still running
+	int												m_dispatchDepth = 0;
+	std::vector<std::vector<SUBSCRIPTION_TYPE*>*>	m_listsToCompact;
+	std::vector<SUBSCRIPTION_TYPE*>					m_removedSubscriptions;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////////
+// Template Implementations
+//////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------------------------
+// Destructor - deletes the lists and the subscriptions still in them
+//
+template <typename SUBSCRIPTION_TYPE>
+EventSubscriberTable<SUBSCRIPTION_TYPE>::~EventSubscriberTable()
+{
+	for (int slotIndex = 0; slotIndex < (int)m_slots.size(); ++slotIndex)
+	{
+		std::vector<SUBSCRIPTION_TYPE*>* subscriptions = m_slots[slotIndex].subscriptions;
+
+		if (subscriptions != nullptr)
+		{
+			for (int subIndex = 0; subIndex < (int)subscriptions->size(); ++subIndex)
+			{
+				delete (*subscriptions)[subIndex];
+			}
+
+			delete subscriptions;
+		}
+	}
+
+	for (int removedIndex = 0; removedIndex < (int)m_removedSubscriptions.size(); ++removedIndex)
+	{
+		delete m_removedSubscriptions[removedIndex];
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the subscriptions to the key, or nullptr if it was never subscribed to
+//
+template <typename SUBSCRIPTION_TYPE>
+std::vector<SUBSCRIPTION_TYPE*>* EventSubscriberTable<SUBSCRIPTION_TYPE>::Find(uint64_t key) const
+{
+	if (m_slots.size() == 0)
+	{
+		return nullptr;
+	}
+
+	return m_slots[FindSlot(key)].subscriptions;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the subscriptions to the key, adding an empty list for it if there isn't one
+//
+template <typename SUBSCRIPTION_TYPE>
+std::vector<SUBSCRIPTION_TYPE*>& EventSubscriberTable<SUBSCRIPTION_TYPE>::FindOrAdd(uint64_t key)
+{
+	// Keep it under 3/4 full so probes stay short
+	if ((m_usedCount + 1) * 4 > (int)m_slots.size() * 3)
+	{
+		Grow();
+	}
+
+	Slot_t& slot = m_slots[FindSlot(key)];
+
+	if (slot.subscriptions == nullptr)
+	{
+		slot.key = key;
+		slot.subscriptions = new std::vector<SUBSCRIPTION_TYPE*>();
+		m_usedCount++;
+	}
+
+	return *slot.subscriptions;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Linear probes from the key's home slot, returning the slot with the key or the first empty one
+//
+template <typename SUBSCRIPTION_TYPE>
+int EventSubscriberTable<SUBSCRIPTION_TYPE>::FindSlot(uint64_t key) const
+{
+	int slotMask = (int)m_slots.size() - 1;
+	int slotIndex = (int)(key & slotMask);
+
+	while (m_slots[slotIndex].subscriptions != nullptr && m_slots[slotIndex].key != key)
+	{
+		slotIndex = (slotIndex + 1) & slotMask;
+	}
+
+	return slotIndex;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Doubles the slot count and reinserts every list
+//
+template <typename SUBSCRIPTION_TYPE>
+void EventSubscriberTable<SUBSCRIPTION_TYPE>::Grow()
+{
+	std::vector<Slot_t> oldSlots;
+	oldSlots.swap(m_slots);
+
+	m_slots.resize(oldSlots.size() > 0 ? oldSlots.size() * 2 : 16);
+
+	for (int slotIndex = 0; slotIndex < (int)oldSlots.size(); ++slotIndex)
+	{
+		if (oldSlots[slotIndex].subscriptions != nullptr)
+		{
+			m_slots[FindSlot(oldSlots[slotIndex].key)] = oldSlots[slotIndex];
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Marks the start of a fire, removals are deferred until every fire in progress has ended
+//
+template <typename SUBSCRIPTION_TYPE>
+void EventSubscriberTable<SUBSCRIPTION_TYPE>::BeginDispatch()
+{
+	m_dispatchDepth++;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Marks the end of a fire, and applies the deferred removals if it was the outermost one
+//
+template <typename SUBSCRIPTION_TYPE>
+void EventSubscriberTable<SUBSCRIPTION_TYPE>::EndDispatch()
+{
+	m_dispatchDepth--;
+
+	if (m_dispatchDepth > 0 || m_removedSubscriptions.size() == 0)
+	{
+		return;
+	}
+
+	// A list is in here once per removal, but compacting it again is a no-op
+	for (int listIndex = 0; listIndex < (int)m_listsToCompact.size(); ++listIndex)
+	{
+		std::vector<SUBSCRIPTION_TYPE*>* subscriptions = m_listsToCompact[listIndex];
+		subscriptions->erase(std::remove(subscriptions->begin(), subscriptions->end(), nullptr), subscriptions->end());
+	}
+
+	for (int removedIndex = 0; removedIndex < (int)m_removedSubscriptions.size(); ++removedIndex)
+	{
+		delete m_removedSubscriptions[removedIndex];
+	}
+
+	m_listsToCompact.clear();
+	m_removedSubscriptions.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes and deletes the subscription at the index, or nulls it out if a fire is in progress
+//
+template <typename SUBSCRIPTION_TYPE>
+void EventSubscriberTable<SUBSCRIPTION_TYPE>::Remove(std::vector<SUBSCRIPTION_TYPE*>& subscriptions, int index)
+{
+	SUBSCRIPTION_TYPE* subscription = subscriptions[index];
+
+	if (m_dispatchDepth > 0)
+	{
+		subscriptions[index] = nullptr;
+		m_listsToCompact.push_back(&subscriptions);
+		m_removedSubscriptions.push_back(subscription);
+	}
+	else
+	{
+		subscriptions.erase(subscriptions.begin() + index);
+		delete subscription;
+	}
+}
@@ -6,10 +6,19 @@
 /*				System
 /************************************************************************/
 #pragma once
+#include <stdint.h>
 
 class NamedProperties;
 typedef bool(*EventFunctionCallback)(NamedProperties& args);
 
+// ID for a typed event's payload struct, the address of a static per type - same as TypedProperty, no RTTI needed
+template <typename T>
+struct EventTypeID
+{
+	static uint64_t Get() { return (uint64_t)&s_typeID; }
+	static constexpr int s_typeID = 0;
+};
+
 class EventSubscription
 {
 public:
@@ -68,6 +77,68 @@ private:
 };
 
 
+// Subscription to a typed event, the payload is a POD struct passed by pointer instead of through NamedProperties
+class TypedEventSubscription
+{
+public:
+	//-----Public Methods-----
+	TypedEventSubscription() {}
+	virtual ~TypedEventSubscription() {}
+	virtual bool Execute(const void* payload) = 0;
+};
+
+
+template <typename T_Event>
+class TypedEventFunctionSubscription : public TypedEventSubscription
+{
+	friend class EventSystem;
+
+public:
+
+	typedef bool(*TypedEventFunctionCallback)(const T_Event& payload);
+
+
+public:
+	//-----Public Methods-----
+
+	TypedEventFunctionSubscription(TypedEventFunctionCallback callback) : m_functionCallback(callback) {}
+	virtual bool Execute(const void* payload) override { return m_functionCallback(*(const T_Event*)payload); }
+
+
+private:
+	//-----Private Data-----
+
+	TypedEventFunctionCallback m_functionCallback = nullptr;
+
+};
+
+
+template <typename T_Event, typename T>
+class TypedEventObjectMethodSubscription : public TypedEventSubscription
+{
+	friend class EventSystem;
+
+public:
+
+	typedef bool(T::*TypedEventObjectMethodCallback)(const T_Event& payload);
+
+
+public:
+	//-----Public Methods-----
+
+	TypedEventObjectMethodSubscription(TypedEventObjectMethodCallback callback, T& object) : m_methodCallback(callback), m_object(object) {}
+	virtual bool Execute(const void* payload) override { return (m_object.*m_methodCallback)(*(const T_Event*)payload); }
+
+
+private:
+	//-----Private Data-----
+
+	TypedEventObjectMethodCallback m_methodCallback = nullptr;
+	T& m_object;
+
+};
+
+
 //////////////////////////////////////////////////////////////////////////
 // Template Implementations
 //////////////////////////////////////////////////////////////////////////
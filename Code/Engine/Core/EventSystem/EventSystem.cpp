@@ -7,10 +7,21 @@
 #include "Engine/Core/EventSystem/EventSystem.hpp"
 #include "Engine/DataStructures/NamedProperties.hpp"
 #include "Engine/Core/Utility/ErrorWarningAssert.hpp"
+#include <string.h>
 
 // Singleton instance
 EventSystem* EventSystem::s_instance = nullptr;
 
+// First block of each record in the event queue
+struct QueuedEventHeader_t
+{
+	uint64_t	eventKey;				// Name hash, or payload type ID if typed
+	uint32_t	payloadBlockCount;
+	bool		isTyped;
+};
+
+static_assert(sizeof(QueuedEventHeader_t) <= sizeof(QueuedEventBlock_t), "Queued event header doesn't fit in a block");
+
 
 //-----------------------------------------------------------------------------------------------
 // Constructor
@@ -21,7 +32,7 @@ EventSystem::EventSystem()
 
 
 //-----------------------------------------------------------------------------------------------
-// Destructor
+// Destructor - the subscriber tables delete the subscriptions left in them
 //
 EventSystem::~EventSystem()
 {
@@ -63,72 +74,162 @@ EventSystem* EventSystem::GetInstance()
 //-----------------------------------------------------------------------------------------------
 // Adds a subscription for the given function callback
 //
-void EventSystem::SubscribeEventCallbackFunction(const char* eventNameToSubTo, EventFunctionCallback callback)
+void EventSystem::SubscribeEventCallbackFunction(StringID eventIDToSubTo, EventFunctionCallback callback)
 {
 	EventFunctionSubscription* subscription = new EventFunctionSubscription(callback);
 
 	// This creates the entry if there isn't one already
-	std::vector<EventSubscription*>& subsToEvent = m_subscriptions[eventNameToSubTo];
+	std::vector<EventSubscription*>& subsToEvent = m_subscriptions.FindOrAdd(eventIDToSubTo.GetHash());
 	subsToEvent.push_back(subscription);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Removes the function subscription from the event listed by eventNameToUnsubFrom
+// Removes the function subscription from the event given by eventIDToUnsubFrom
 //
-void EventSystem::UnsubscribeEventCallbackFunction(const char* eventNameToUnsubFrom, EventFunctionCallback callback)
+void EventSystem::UnsubscribeEventCallbackFunction(StringID eventIDToUnsubFrom, EventFunctionCallback callback)
 {
-	std::vector<EventSubscription*>& subsToEvent = m_subscriptions[eventNameToUnsubFrom];
+	std::vector<EventSubscription*>* subsToEvent = m_subscriptions.Find(eventIDToUnsubFrom.GetHash());
 
-	int numSubs = (int)subsToEvent.size();
+	int numSubs = (subsToEvent != nullptr ? (int)subsToEvent->size() : 0);
 	for (int subIndex = 0; subIndex < numSubs; ++subIndex)
 	{
-		EventFunctionSubscription* currSub = dynamic_cast<EventFunctionSubscription*>(subsToEvent[subIndex]);
+		EventFunctionSubscription* currSub = dynamic_cast<EventFunctionSubscription*>((*subsToEvent)[subIndex]);
 
 		if (currSub != nullptr) // currSub is a standalone function subscription
 		{
 			if (currSub->m_functionCallback == callback) // currSub is the one for the given callback
 			{
-				subsToEvent.erase(subsToEvent.begin() + subIndex);
+				m_subscriptions.Remove(*subsToEvent, subIndex);
+				return;
+			}
+		}
+	}
+
+	// This is only reached if we don't find an event for this function callback
+	LogTaggedPrintf("EVENT", "Tried to unsubscribe a function subscription from event named \"%s\" but couldn't find it", eventIDToUnsubFrom.ToString().c_str());
+}
 
-				if (subsToEvent.size() == 0)
-				{
-					m_subscriptions.erase(eventNameToUnsubFrom);
-				}
 
-				delete currSub;
-				return;
+//-----------------------------------------------------------------------------------------------
+// Calls all callbacks that are subscribed to the event given by eventID
+//
+void EventSystem::FireEvent(StringID eventID, NamedProperties& args)
+{
+	std::vector<EventSubscription*>* subsToEvent = m_subscriptions.Find(eventID.GetHash());
+
+	if (subsToEvent != nullptr)
+	{
+		m_subscriptions.BeginDispatch();
+
+		// Size is checked every time, in case a callback subscribes - unsubscribed entries are nulled until the end
+		for (int subIndex = 0; subIndex < (int)subsToEvent->size(); ++subIndex)
+		{
+			EventSubscription* subscription = (*subsToEvent)[subIndex];
+
+			if (subscription != nullptr && subscription->Execute(args))
+			{
+				break;
 			}
 		}
+
+		m_subscriptions.EndDispatch();
 	}
+}
 
-	// This is only reached if we don't find an event for this object and method callback
-	LogTaggedPrintf("EVENT", "Tried to unsubscribe a function subscription from event named \"%s\" but couldn't find it");
+
+//-----------------------------------------------------------------------------------------------
+// Queues the named event with no args, to be fired on the next DispatchQueuedEvents()
+//
+void EventSystem::QueueEvent(StringID eventID)
+{
+	QueueEventRecord(eventID.GetHash(), false, nullptr, 0);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Calls all callbacks that are subscribed to the event given by eventName
+// Fires every event queued since the last call, in the order they were queued
+// Events queued while dispatching (by the callbacks or other threads) wait for the next call
 //
-void EventSystem::FireEvent(const char* eventName, NamedProperties& args)
+void EventSystem::DispatchQueuedEvents()
 {
-	bool subsToEventExist = (m_subscriptions.find(eventName) != m_subscriptions.end());
+	{
+		std::lock_guard<std::mutex> lock(m_queueLock);
+		m_queuedEvents.swap(m_dispatchingEvents);
+	}
 
-	if (subsToEventExist)
+	NamedProperties emptyArgs;
+
+	int numBlocks = (int)m_dispatchingEvents.size();
+	int blockIndex = 0;
+
+	while (blockIndex < numBlocks)
 	{
-		std::vector<EventSubscription*>& subsToEvent = m_subscriptions[eventName];
+		const QueuedEventHeader_t* header = (const QueuedEventHeader_t*)&m_dispatchingEvents[blockIndex];
+
+		if (header->isTyped)
+		{
+			FireTypedEventByID(header->eventKey, &m_dispatchingEvents[blockIndex + 1]);
+		}
+		else
+		{
+			FireEvent(StringID::FromHash(header->eventKey), emptyArgs);
+		}
+
+		blockIndex += 1 + header->payloadBlockCount;
+	}
+
+	// Keeps the capacity for the next swap
+	m_dispatchingEvents.clear();
+}
+
 
-		int numSubs = (int)subsToEvent.size();
+//-----------------------------------------------------------------------------------------------
+// Calls all callbacks subscribed to the payload type given by typeID, until one consumes it
+//
+void EventSystem::FireTypedEventByID(uint64_t typeID, const void* payload)
+{
+	std::vector<TypedEventSubscription*>* subsToEvent = m_typedSubscriptions.Find(typeID);
+
+	if (subsToEvent != nullptr)
+	{
+		m_typedSubscriptions.BeginDispatch();
 
-		for (int subIndex = 0; subIndex < numSubs; ++subIndex)
+		for (int subIndex = 0; subIndex < (int)subsToEvent->size(); ++subIndex)
 		{
-			bool subConsumedEvent = subsToEvent[subIndex]->Execute(args);
+			TypedEventSubscription* subscription = (*subsToEvent)[subIndex];
 
-			if (subConsumedEvent)
+			if (subscription != nullptr && subscription->Execute(payload))
 			{
 				break;
 			}
 		}
+
+		m_typedSubscriptions.EndDispatch();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends a header block and the payload's blocks to the queue, safe from any thread
+//
+void EventSystem::QueueEventRecord(uint64_t eventKey, bool isTyped, const void* payload, size_t payloadSize)
+{
+	QueuedEventHeader_t header;
+	header.eventKey = eventKey;
+	header.payloadBlockCount = (uint32_t)((payloadSize + sizeof(QueuedEventBlock_t) - 1) / sizeof(QueuedEventBlock_t));
+	header.isTyped = isTyped;
+
+	std::lock_guard<std::mutex> lock(m_queueLock);
+
+	size_t recordStart = m_queuedEvents.size();
+	m_queuedEvents.resize(recordStart + 1 + header.payloadBlockCount);
+
+	memcpy(&m_queuedEvents[recordStart], &header, sizeof(QueuedEventHeader_t));
+
+	if (payloadSize > 0)
+	{
+		memcpy(&m_queuedEvents[recordStart + 1], payload, payloadSize);
 	}
 }
 
@@ -136,18 +237,27 @@ void EventSystem::FireEvent(const char* eventName, NamedProperties& args)
 //---C FUNCTION----------------------------------------------------------------------------------
 // Shortcut function for firing an event by name with no parameters
 //
-void FireEvent(const char* name)
+void FireEvent(StringID eventID)
 {
 	NamedProperties args;
-	FireEvent(name, args);
+	FireEvent(eventID, args);
 }
 
 
 //---C FUNCTION----------------------------------------------------------------------------------
 // Shortcut function for firing an event by name on the singleton EventSystem instance
 //
-void FireEvent(const char* eventName, NamedProperties& args)
+void FireEvent(StringID eventID, NamedProperties& args)
 {
 	EventSystem* eventSystem = EventSystem::GetInstance();
-	eventSystem->FireEvent(eventName, args);
+	eventSystem->FireEvent(eventID, args);
+}
+
+
+//---C FUNCTION----------------------------------------------------------------------------------
+// Shortcut function for queueing an event by name with no parameters, from any thread
+//
+void QueueEvent(StringID eventID)
+{
+	EventSystem::GetInstance()->QueueEvent(eventID);
 }
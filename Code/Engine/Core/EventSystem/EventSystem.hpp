@@ -6,12 +6,22 @@
 /************************************************************************/
 #pragma once
 #include "Engine/Core/LogSystem.hpp"
+#include "Engine/Core/Utility/StringID.hpp"
 #include "Engine/Core/EventSystem/EventSubscription.hpp"
-#include <map>
-#include <string>
+#include "Engine/Core/EventSystem/EventSubscriberTable.hpp"
+#include <type_traits>
 #include <vector>
+#include <mutex>
 
 class NamedProperties;
+
+// Unit the event queue is stored in - a record is a block of header, then the payload rounded up to whole blocks
+// Being a type (rather than bytes) is what gets the vector's storage aligned for the payloads
+struct alignas(16) QueuedEventBlock_t
+{
+	uint8_t bytes[16];
+};
+
 class EventSystem
 {
 public:
@@ -21,15 +31,39 @@ public:
 	static void			Shutdown();
 	static EventSystem* GetInstance();
 
-	void SubscribeEventCallbackFunction(const char* eventNameToSubTo, EventFunctionCallback callback);
-	void UnsubscribeEventCallbackFunction(const char* eventNameToUnsubFrom, EventFunctionCallback callback);
+	// Named events - IDs hash at compile time when given a literal, or keep a constexpr StringID/SID() around
+	// Callbacks can subscribe and unsubscribe freely, even during a nested fire: an unsubscribed callback isn't called
+	// again, no other subscriber is skipped, and it's deleted once the outermost fire returns
+	void SubscribeEventCallbackFunction(StringID eventIDToSubTo, EventFunctionCallback callback);
+	void UnsubscribeEventCallbackFunction(StringID eventIDToUnsubFrom, EventFunctionCallback callback);
 
 	template <typename T, typename T_Method>
-	void SubscribeEventCallbackObjectMethod(const char* eventNameToSubTo, T_Method callback, T& object);
+	void SubscribeEventCallbackObjectMethod(StringID eventIDToSubTo, T_Method callback, T& object);
 	template <typename T, typename T_Method>
-	void UnsubscribeEventCallbackObjectMethod(const char* eventNameToUnsubFrom, T_Method callback, T& object);
+	void UnsubscribeEventCallbackObjectMethod(StringID eventIDToUnsubFrom, T_Method callback, T& object);
+
+	void FireEvent(StringID eventID, NamedProperties& args);
 
-	void FireEvent(const char* eventName, NamedProperties& args);
+	// Typed events - the payload struct's type is the event, and firing one doesn't allocate
+	template <typename T_Event>
+	void SubscribeTypedEventCallbackFunction(bool(*callback)(const T_Event& payload));
+	template <typename T_Event>
+	void UnsubscribeTypedEventCallbackFunction(bool(*callback)(const T_Event& payload));
+
+	template <typename T_Event, typename T>
+	void SubscribeTypedEventCallbackObjectMethod(bool(T::*callback)(const T_Event& payload), T& object);
+	template <typename T_Event, typename T>
+	void UnsubscribeTypedEventCallbackObjectMethod(bool(T::*callback)(const T_Event& payload), T& object);
+
+	template <typename T_Event>
+	void FireTypedEvent(const T_Event& payload);
+
+	// Queued events - can be queued from any thread, and are fired in order on the main thread by DispatchQueuedEvents()
+	// Named events can't take args here, NamedProperties isn't safe to copy across threads
+	void QueueEvent(StringID eventID);
+	template <typename T_Event>
+	void QueueTypedEvent(const T_Event& payload);
+	void DispatchQueuedEvents();		// Call once a frame
 
 
 private:
@@ -40,11 +74,22 @@ private:
 	~EventSystem();
 	EventSystem(const EventSystem& copy) = delete;
 
+	void FireTypedEventByID(uint64_t typeID, const void* payload);
+	void QueueEventRecord(uint64_t eventKey, bool isTyped, const void* payload, size_t payloadSize);
+
 
 private:
 	//-----Private Data-----
 
-	std::map<std::string, std::vector<EventSubscription*>> m_subscriptions;
+	// Keyed by event name hash, and by payload type ID for typed events
+	EventSubscriberTable<EventSubscription>			m_subscriptions;
+	EventSubscriberTable<TypedEventSubscription>	m_typedSubscriptions;
+
+	// Double buffered - threads queue into one while the main thread dispatches the other
+	// Both keep their capacity, so queueing stops allocating once they've grown to a frame's worth
+	std::mutex						m_queueLock;
+	std::vector<QueuedEventBlock_t>	m_queuedEvents;
+	std::vector<QueuedEventBlock_t>	m_dispatchingEvents;
 
 	static EventSystem* s_instance;
 
@@ -59,12 +104,12 @@ private:
 // Creates and adds an object method subscription for the given object and callback
 //
 template <typename T, typename T_Method>
-void EventSystem::SubscribeEventCallbackObjectMethod(const char* eventNameToSubTo, T_Method callback, T& object)
+void EventSystem::SubscribeEventCallbackObjectMethod(StringID eventIDToSubTo, T_Method callback, T& object)
 {
 	EventObjectMethodSubscription<T>* subscription = new EventObjectMethodSubscription<T>(callback, object);
 
 	// This creates the entry if there isn't one already
-	std::vector<EventSubscription*>& subsToEvent = m_subscriptions[eventNameToSubTo];
+	std::vector<EventSubscription*>& subsToEvent = m_subscriptions.FindOrAdd(eventIDToSubTo.GetHash());
 	subsToEvent.push_back(subscription);
 }
 
@@ -73,39 +118,133 @@ void EventSystem::SubscribeEventCallbackObjectMethod(const char* eventNameToSubT
 // Removes the given subscription from the list of subscribers for the given event
 //
 template <typename T, typename T_Method>
-void EventSystem::UnsubscribeEventCallbackObjectMethod(const char* eventNameToUnsubFrom, T_Method callback, T& object)
+void EventSystem::UnsubscribeEventCallbackObjectMethod(StringID eventIDToUnsubFrom, T_Method callback, T& object)
 {
-	std::vector<EventSubscription*>& subsToEvent = m_subscriptions[eventNameToUnsubFrom];
+	std::vector<EventSubscription*>* subsToEvent = m_subscriptions.Find(eventIDToUnsubFrom.GetHash());
 
-	int numSubs = (int)subsToEvent.size();
+	int numSubs = (subsToEvent != nullptr ? (int)subsToEvent->size() : 0);
 	for (int subIndex = 0; subIndex < numSubs; ++subIndex)
 	{
-		EventObjectMethodSubscription<T>* currSub = dynamic_cast<EventObjectMethodSubscription<T>*>(subsToEvent[subIndex]);
+		EventObjectMethodSubscription<T>* currSub = dynamic_cast<EventObjectMethodSubscription<T>*>((*subsToEvent)[subIndex]);
 
 		if (currSub != nullptr) // currSub is an object method subscription
 		{
 			if (currSub->m_methodCallback == callback && &currSub->m_object == &object) // currSub is the one for the given object and callback
 			{
-				subsToEvent.erase(subsToEvent.begin() + subIndex);
-
-				if (subsToEvent.size() == 0)
-				{
-					m_subscriptions.erase(eventNameToUnsubFrom);
-				}
-
-				delete currSub;
+				m_subscriptions.Remove(*subsToEvent, subIndex);
 				return;
 			}
 		}
 	}
 
 	// This is only reached if we don't find an event for this object and method callback
-	LogTaggedPrintf("EVENT", "Tried to unsubscribe an object method subscription from event named \"%s\" but couldn't find it");
+	LogTaggedPrintf("EVENT", "Tried to unsubscribe an object method subscription from event named \"%s\" but couldn't find it", eventIDToUnsubFrom.ToString().c_str());
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a subscription for the given function callback to the event for its payload type
+//
+template <typename T_Event>
+void EventSystem::SubscribeTypedEventCallbackFunction(bool(*callback)(const T_Event& payload))
+{
+	TypedEventFunctionSubscription<T_Event>* subscription = new TypedEventFunctionSubscription<T_Event>(callback);
+	m_typedSubscriptions.FindOrAdd(EventTypeID<T_Event>::Get()).push_back(subscription);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the function subscription from the event for its payload type
+//
+template <typename T_Event>
+void EventSystem::UnsubscribeTypedEventCallbackFunction(bool(*callback)(const T_Event& payload))
+{
+	std::vector<TypedEventSubscription*>* subsToEvent = m_typedSubscriptions.Find(EventTypeID<T_Event>::Get());
+
+	int numSubs = (subsToEvent != nullptr ? (int)subsToEvent->size() : 0);
+	for (int subIndex = 0; subIndex < numSubs; ++subIndex)
+	{
+		TypedEventFunctionSubscription<T_Event>* currSub = dynamic_cast<TypedEventFunctionSubscription<T_Event>*>((*subsToEvent)[subIndex]);
+
+		if (currSub != nullptr && currSub->m_functionCallback == callback)
+		{
+			m_typedSubscriptions.Remove(*subsToEvent, subIndex);
+			return;
+		}
+	}
+
+	LogTaggedPrintf("EVENT", "Tried to unsubscribe a function subscription from a typed event but couldn't find it");
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds an object method subscription to the event for its payload type
+//
+template <typename T_Event, typename T>
+void EventSystem::SubscribeTypedEventCallbackObjectMethod(bool(T::*callback)(const T_Event& payload), T& object)
+{
+	TypedEventObjectMethodSubscription<T_Event, T>* subscription = new TypedEventObjectMethodSubscription<T_Event, T>(callback, object);
+	m_typedSubscriptions.FindOrAdd(EventTypeID<T_Event>::Get()).push_back(subscription);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the object method subscription from the event for its payload type
+//
+template <typename T_Event, typename T>
+void EventSystem::UnsubscribeTypedEventCallbackObjectMethod(bool(T::*callback)(const T_Event& payload), T& object)
+{
+	std::vector<TypedEventSubscription*>* subsToEvent = m_typedSubscriptions.Find(EventTypeID<T_Event>::Get());
+
+	int numSubs = (subsToEvent != nullptr ? (int)subsToEvent->size() : 0);
+	for (int subIndex = 0; subIndex < numSubs; ++subIndex)
+	{
+		TypedEventObjectMethodSubscription<T_Event, T>* currSub = dynamic_cast<TypedEventObjectMethodSubscription<T_Event, T>*>((*subsToEvent)[subIndex]);
+
+		if (currSub != nullptr && currSub->m_methodCallback == callback && &currSub->m_object == &object)
+		{
+			m_typedSubscriptions.Remove(*subsToEvent, subIndex);
+			return;
+		}
+	}
+
+	LogTaggedPrintf("EVENT", "Tried to unsubscribe an object method subscription from a typed event but couldn't find it");
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Calls all callbacks subscribed to the payload's type, until one consumes it
+//
+template <typename T_Event>
+void EventSystem::FireTypedEvent(const T_Event& payload)
+{
+	FireTypedEventByID(EventTypeID<T_Event>::Get(), &payload);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Copies the payload into the queue, to be fired on the next DispatchQueuedEvents()
+// Payloads are copied as bytes, so they can't own anything or point at anything short lived
+//
+template <typename T_Event>
+void EventSystem::QueueTypedEvent(const T_Event& payload)
+{
+	static_assert(std::is_trivially_copyable<T_Event>::value, "Queued event payloads must be trivially copyable");
+	static_assert(alignof(T_Event) <= alignof(QueuedEventBlock_t), "Queued event payload is over aligned");
+
+	QueueEventRecord(EventTypeID<T_Event>::Get(), true, &payload, sizeof(T_Event));
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 // C Function Shortcuts
 //////////////////////////////////////////////////////////////////////////
-void FireEvent(const char* name);
-void FireEvent(const char* eventName, NamedProperties& args);
+void FireEvent(StringID eventID);
+void FireEvent(StringID eventID, NamedProperties& args);
+void QueueEvent(StringID eventID);
+
+template <typename T_Event>
+void FireTypedEvent(const T_Event& payload) { EventSystem::GetInstance()->FireTypedEvent(payload); }
+
+template <typename T_Event>
+void QueueTypedEvent(const T_Event& payload) { EventSystem::GetInstance()->QueueTypedEvent(payload); }
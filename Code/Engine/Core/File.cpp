@@ -5,6 +5,9 @@
 /* Description: Implementation of the File Class + helper functions
 /************************************************************************/
 #include "Engine/Core/File.hpp"
+#include "Engine/Core/PackFile.hpp"
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
 #include "Engine/Core/DeveloperConsole/DevConsole.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include <stdio.h>
@@ -16,6 +19,32 @@
 #endif
 #include <windows.h>			// #include this (massive, platform-specific) header in very few places
 
+// Streaming reads are done this much at a time, growing only for a line that doesn't fit
+#define FILE_READ_CHUNK_SIZE (64 * 1024)
+
+// Maps a file on a disk worker and pages it in, then hands it to the callback when finalized
+class FileReadJob : public Job
+{
+public:
+
+	FileReadJob(const std::string& filepath, FileRead_cb callback, void* args)
+		: m_filepath(filepath), m_callback(callback), m_args(args)
+	{
+		m_jobType = JOB_TYPE_FILE_READ;
+		m_jobFlags = WORKER_FLAGS_DISK;
+	}
+
+	virtual void Execute() override;
+	virtual void Finalize() override;
+
+	std::string		m_filepath;
+	FileRead_cb		m_callback = nullptr;
+	void*			m_args = nullptr;
+	MappedFile		m_file;
+	bool			m_opened = false;
+
+};
+
 TODO("Safety checks, if file is open already or not, if file is loaded into memory or not");
 //-----------------------------------------------------------------------------------------------
 // Opens the file given by filepath and returns the file pointer associated to it
@@ -60,26 +89,22 @@ bool CloseFile(FILE* fileHandle)
 //
 void* FileReadToNewBuffer( char const *filename, size_t& out_size)
 {
-	FILE* fp = OpenFile(filename, "r");
-	if (fp == nullptr) 
+	MappedFile file;
+	if (!file.Open(filename))
 	{
 		return nullptr;
 	}
 
-	out_size = 0U; 
-
-	fseek(fp, 0L, SEEK_END);
-	out_size = ftell(fp); 
-
-	fseek(fp, 0L, SEEK_SET); 
+	out_size = file.GetSize();
 
 	unsigned char *buffer = (unsigned char*) malloc(out_size + 1U); // space for NULL 
 
-	size_t read = fread( buffer, 1, out_size, fp );
-	
-	CloseFile(fp);
+	if (out_size > 0)
+	{
+		memcpy(buffer, file.GetData(), out_size);
+	}
 
-	buffer[read] = NULL; 
+	buffer[out_size] = NULL; 
 	return buffer;  
 }
 
@@ -103,6 +128,40 @@ bool FileWriteFromBuffer(char const *filename, char const* buffer, int bufferSiz
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Queues the file to be mapped and read on a disk worker, running the file on this thread if there's no job system
+//
+int ReadFileAsync(const std::string& filepath, FileRead_cb callback, void* args /*= nullptr*/)
+{
+	FileReadJob* job = new FileReadJob(filepath, callback, args);
+
+	if (JobSystem::GetInstance() == nullptr)
+	{
+		job->Execute();
+		job->Finalize();
+		delete job;
+
+		return -1;
+	}
+
+	return QueueJob(job);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs the callbacks of every async read that has finished
+//
+void FinalizeAsyncFileReads()
+{
+	JobSystem* jobSystem = JobSystem::GetInstance();
+
+	if (jobSystem != nullptr)
+	{
+		jobSystem->FinalizeAllFinishedJobsOfType(JOB_TYPE_FILE_READ);
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Returns the working directory path
 //
@@ -126,6 +185,47 @@ std::string GetFullFilePath(const std::string& localFilePath)
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Appends the path of every file in the directory, and in its subdirectories if recursive
+//
+void GetFilesInDirectory(const std::string& directory, std::vector<std::string>& out_filepaths, bool recursive)
+{
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA((directory + "/*").c_str(), &findData);
+
+	if (findHandle == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	do 
+	{
+		std::string name = findData.cFileName;
+		if (name == "." || name == "..")
+		{
+			continue;
+		}
+
+		std::string path = directory + "/" + name;
+
+		if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+		{
+			if (recursive)
+			{
+				GetFilesInDirectory(path, out_filepaths, true);
+			}
+		}
+		else
+		{
+			out_filepaths.push_back(path);
+		}
+
+	} while (FindNextFileA(findHandle, &findData));
+
+	FindClose(findHandle);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Destructor
 //
@@ -144,15 +244,29 @@ bool File::Open(const char* filepath, const char* flags)
 		Close();
 	}
 
-	m_filePointer = (void*) OpenFile(filepath, flags);
+	// Writes always go to disk
+	bool isReadOnly = (strchr(flags, 'r') != nullptr && strchr(flags, '+') == nullptr);
+	bool packFirst = (isReadOnly && !PackFile::AreLooseFileOverridesEnabled());
 
-	if (m_filePointer != nullptr)
+	bool opened = (packFirst && OpenFromPack(filepath));
+
+	if (!opened)
+	{
+		m_filePointer = (void*) OpenFile(filepath, flags);
+		opened = (m_filePointer != nullptr);
+	}
+
+	if (!opened && isReadOnly && !packFirst)
+	{
+		opened = OpenFromPack(filepath);
+	}
+
+	if (opened)
 	{
 		m_filePathOpened = filepath;
-		return true;
 	}
 
-	return false;
+	return opened;
 }
 
 
@@ -164,17 +278,14 @@ bool File::Close()
 	bool success = CloseFile((FILE*) m_filePointer);
 	m_filePointer = nullptr;
 
-	if (m_data != nullptr)
-	{
-		free((void*)m_data);
-		m_data = nullptr;
-	}
-
-	// Reset members
-	m_size = 0;
-	m_offset = 0;
+	// Reset members, keeping the read buffer for the next file
+	m_readOffset = 0;
+	m_readEnd = 0;
+	m_hasReadToEnd = false;
 	m_isAtEndOfFile = false;
 	m_lineNumber = 0;
+	m_packedSize = 0;
+	m_isOpenFromPack = false;
 
 	return success;
 }
@@ -208,93 +319,404 @@ void File::Flush()
 
 
 //-----------------------------------------------------------------------------------------------
-// Reads the file contents into memory
+// Reads up to byteCount bytes, taking whatever is left of the current chunk first
+// Returns the number of bytes read, which is short only at the end of the file
 //
-bool File::LoadFileToMemory()
+size_t File::Read(void* out_buffer, size_t byteCount)
 {
-	m_size = 0U; 
+	size_t bufferedCount = m_readEnd - m_readOffset;
+	size_t fromBuffer = (bufferedCount < byteCount ? bufferedCount : byteCount);
+
+	if (fromBuffer > 0)
+	{
+		memcpy(out_buffer, &m_readBuffer[m_readOffset], fromBuffer);
+		m_readOffset += fromBuffer;
+	}
+
+	size_t fromFile = 0;
+	if (fromBuffer < byteCount && m_filePointer != nullptr)
+	{
+		fromFile = fread((char*)out_buffer + fromBuffer, 1, byteCount - fromBuffer, (FILE*) m_filePointer);
+	}
+
+	if (fromBuffer + fromFile < byteCount)
+	{
+		m_hasReadToEnd = true;
+		m_isAtEndOfFile = true;
+	}
+
+	return fromBuffer + fromFile;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Finds the next line in the read buffer, reading the next chunk in when the line runs off the end of it
+//
+bool File::GetNextLine(const char*& out_line, size_t& out_length)
+{
+	while (true)
+	{
+		const char* lineStart = m_readBuffer.data() + m_readOffset;
+		size_t bufferedCount = m_readEnd - m_readOffset;
+		const char* lineEnd = (bufferedCount > 0 ? (const char*) memchr(lineStart, '\n', bufferedCount) : nullptr);
+
+		// The last line may not have a line ending
+		if (lineEnd == nullptr && m_hasReadToEnd && bufferedCount > 0)
+		{
+			lineEnd = lineStart + bufferedCount;
+		}
+
+		if (lineEnd != nullptr)
+		{
+			m_readOffset = (size_t)(lineEnd - m_readBuffer.data()) + (lineEnd < m_readBuffer.data() + m_readEnd ? 1 : 0);
+
+			// Binary reads keep the \r of Windows line endings
+			if (lineEnd > lineStart && lineEnd[-1] == '\r')
+			{
+				lineEnd--;
+			}
+
+			out_line = lineStart;
+			out_length = (size_t)(lineEnd - lineStart);
+			m_lineNumber++;
+
+			return true;
+		}
+
+		// Out of file, but the last line may still be waiting in the buffer
+		if (!FillReadBuffer() && m_readEnd == m_readOffset)
+		{
+			out_line = nullptr;
+			out_length = 0;
+			m_isAtEndOfFile = true;
+
+			return false;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of lines read so far, so the line number of the last one returned
+//
+unsigned int File::GetLineNumber() const
+{
+	return m_lineNumber;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true once a read has run out of file
+//
+bool File::IsAtEndOfFile() const
+{
+	return m_isAtEndOfFile;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the size of the file on disk
+//
+size_t File::GetSize() const
+{
+	if (m_isOpenFromPack)
+	{
+		return m_packedSize;
+	}
 
 	FILE* fp = (FILE*) m_filePointer;
+	if (fp == nullptr)
+	{
+		return 0;
+	}
 
-	// Get the file size
+	long position = ftell(fp);
 	fseek(fp, 0L, SEEK_END);
-	m_size = ftell(fp); 
+	long size = ftell(fp);
+	fseek(fp, position, SEEK_SET);
 
-	// Set back to beginning
-	fseek(fp, 0L, SEEK_SET); 
+	return (size_t) size;
+}
 
-	// Make the buffer
-	unsigned char* data = (unsigned char*) malloc(m_size + 1U); // space for NULL 
 
-	// Read the data in
-	size_t read = fread(data, 1, m_size, fp);
+//-----------------------------------------------------------------------------------------------
+// Returns the path to the file currently opened by this File object
+//
+std::string File::GetFilePathOpened() const
+{
+	return m_filePathOpened;
+}
 
-	// Null terminate and return
-	data[read] = NULL;   
-	m_data = (const char*) data;
+
+//-----------------------------------------------------------------------------------------------
+// Moves the unconsumed bytes to the front of the buffer and reads the next chunk in after them,
+// growing the buffer if a single line already fills it
+// Returns false if there was nothing left to read
+//
+bool File::FillReadBuffer()
+{
+	if (m_hasReadToEnd || m_filePointer == nullptr)
+	{
+		m_hasReadToEnd = true;
+		return false;
+	}
+
+	size_t bufferedCount = m_readEnd - m_readOffset;
+
+	if (m_readBuffer.size() == 0)
+	{
+		m_readBuffer.resize(FILE_READ_CHUNK_SIZE);
+	}
+	else if (bufferedCount == m_readBuffer.size())
+	{
+		m_readBuffer.resize(m_readBuffer.size() * 2);
+	}
+
+	if (bufferedCount > 0 && m_readOffset > 0)
+	{
+		memmove(m_readBuffer.data(), m_readBuffer.data() + m_readOffset, bufferedCount);
+	}
+
+	m_readOffset = 0;
+	m_readEnd = bufferedCount;
+
+	size_t readCount = fread(m_readBuffer.data() + m_readEnd, 1, m_readBuffer.size() - m_readEnd, (FILE*) m_filePointer);
+	m_readEnd += readCount;
+
+	if (readCount == 0)
+	{
+		m_hasReadToEnd = true;
+		return false;
+	}
 
 	return true;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Returns the next line of the file, using the internal offset in this File object
+// Reads the whole file out of the mounted packs into the read buffer, as if it were one big chunk
+// Returns false if no pack has it
 //
-unsigned int File::GetNextLine(std::string& out_string)
+bool File::OpenFromPack(const char* filepath)
 {
-	if (m_data == nullptr || m_offset >= m_size || m_data[m_offset] == NULL)
+	const char* data = nullptr;
+	size_t size = 0;
+	bool isOwned = false;
+
+	if (!PackFile::FindFile(filepath, data, size, isOwned))
 	{
-		out_string = "";
-		m_isAtEndOfFile = true;
-		return m_lineNumber;
+		return false;
 	}
 
-	unsigned int endIndex = m_offset;
-	while (m_data[endIndex] != '\n' && endIndex < m_size)
+	if (m_readBuffer.size() < size)
 	{
-		endIndex++;
+		m_readBuffer.resize(size);
 	}
 
-	size_t length = (endIndex - m_offset);
-	out_string = std::string(&m_data[m_offset], length);
+	if (size > 0)
+	{
+		memcpy(m_readBuffer.data(), data, size);
+	}
+
+	if (isOwned)
+	{
+		free((void*) data);
+	}
 
-	m_offset = endIndex + 1;
-	m_lineNumber++;
-	m_isAtEndOfFile = (m_offset >= m_size);
+	m_readOffset = 0;
+	m_readEnd = size;
+	m_hasReadToEnd = true;
+	m_packedSize = size;
+	m_isOpenFromPack = true;
 
-	return m_lineNumber;
+	return true;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Returns true if the file offset is at or passed the end of the file contents
+// Destructor
 //
-bool File::IsAtEndOfFile() const
+MappedFile::~MappedFile()
 {
-	return m_isAtEndOfFile;
+	Close();
 }
 
+
 //-----------------------------------------------------------------------------------------------
-// Returns the size of the file
+// Opens the file from disk or from the mounted packs, in the order the loose file override setting gives
 //
-size_t File::GetSize() const
+bool MappedFile::Open(const char* filepath)
 {
-	return m_size;
+	bool looseFirst = PackFile::AreLooseFileOverridesEnabled();
+
+	if (looseFirst && OpenLooseFile(filepath))
+	{
+		return true;
+	}
+
+	Close();
+
+	bool isOwned = false;
+	if (PackFile::FindFile(filepath, m_data, m_size, isOwned))
+	{
+		m_ownsData = isOwned;
+		m_isOpen = true;
+
+		return true;
+	}
+
+	return (!looseFirst && OpenLooseFile(filepath));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Maps the whole file read-only, returning false if it couldn't be opened or mapped
+//
+bool MappedFile::OpenLooseFile(const char* filepath)
+{
+	Close();
+
+	HANDLE fileHandle = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize))
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	m_fileHandle = fileHandle;
+	m_size = (size_t) fileSize.QuadPart;
+	m_isOpen = true;
+
+	// Empty files can't be mapped, but are still valid files
+	if (m_size == 0)
+	{
+		return true;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	void* view = (mappingHandle != NULL ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr);
+
+	m_mappingHandle = mappingHandle;
+	m_data = (const char*) view;
+
+	if (m_data == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Unmaps the file, or frees it if it was inflated out of a pack, invalidating any pointers into it
+//
+void MappedFile::Close()
+{
+	if (m_ownsData)
+	{
+		free((void*) m_data);
+	}
+	else if (m_data != nullptr && m_mappingHandle != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+	}
+
+	m_data = nullptr;
+	m_ownsData = false;
+
+	if (m_mappingHandle != nullptr)
+	{
+		CloseHandle((HANDLE) m_mappingHandle);
+		m_mappingHandle = nullptr;
+	}
+
+	if (m_fileHandle != nullptr)
+	{
+		CloseHandle((HANDLE) m_fileHandle);
+		m_fileHandle = nullptr;
+	}
+
+	m_size = 0;
+	m_isOpen = false;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Returns the data loaded into memory of the current file
-const char* File::GetData() const
+// Reads a byte from every page, so the pages fault in here and not wherever the data is first used
+//
+void MappedFile::Prefetch() const
+{
+	static const size_t PAGE_SIZE = 4096;
+
+	volatile char sink = 0;
+	for (size_t offset = 0; offset < m_size; offset += PAGE_SIZE)
+	{
+		sink += m_data[offset];
+	}
+
+	UNUSED(sink);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if a file is open, even if it's empty
+//
+bool MappedFile::IsOpen() const
+{
+	return m_isOpen;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the start of the mapped file
+//
+const char* MappedFile::GetData() const
 {
 	return m_data;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Returns the path to the file currently opened by this File object
+// Returns the size of the file in bytes
 //
-std::string File::GetFilePathOpened() const
+size_t MappedFile::GetSize() const
 {
-	return m_filePathOpened;
+	return m_size;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Maps the file and pages it in, off the main thread
+//
+void FileReadJob::Execute()
+{
+	m_opened = m_file.Open(m_filepath.c_str());
+
+	if (m_opened)
+	{
+		m_file.Prefetch();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Hands the file to the callback, then unmaps it
+//
+void FileReadJob::Finalize()
+{
+	if (m_callback != nullptr)
+	{
+		m_callback(m_filepath, (m_opened ? &m_file : nullptr), m_args);
+	}
+
+	m_file.Close();
 }
@@ -4,26 +4,73 @@
 /* Date: July 10th, 2018
 /* Description: File for File I/O utility functions
 /************************************************************************/
+#pragma once
 #include <string>
+#include <vector>
 #include "Engine/Core/EngineCommon.hpp"
 
 TODO("Remove these excess functions, and make everything use the File class");
 TODO("Make enumeration for file open flags");
-TODO("Update files to not have to load all to memory");
-TODO("File flush");
+
+class MappedFile;
+
+// Called on the main thread once the read finishes, with nullptr if the file couldn't be opened
+// The mapping is closed once the callback returns, so copy out anything that's needed later
+typedef void(*FileRead_cb)(const std::string& filepath, const MappedFile* file, void* args);
 
 // File I/O
 FILE*				OpenFile(const char* filepath, const char* flags);
 bool				CloseFile(FILE* fileHandle);
-void*				FileReadToNewBuffer( char const *filename, size_t& out_size);
+void*				FileReadToNewBuffer( char const *filename, size_t& out_size);		// Copies the whole file, loaders should use a MappedFile instead
 bool				FileWriteFromBuffer(char const *filename, char const* buffer, int bufferSize);
-					
+
+// Reads the file on a disk worker thread, returning the job ID - the callback runs from FinalizeAsyncFileReads(),
+// or from JobSystem::BlockUntilJobIsFinalized() on the ID to wait on a single read
+int					ReadFileAsync(const std::string& filepath, FileRead_cb callback, void* args = nullptr);
+void				FinalizeAsyncFileReads();
+
 // Windows directory
 std::string			GetWorkingDirectory();
 std::string			GetFullFilePath(const std::string& localFilePath);
+void				GetFilesInDirectory(const std::string& directory, std::vector<std::string>& out_filepaths, bool recursive);	// Paths start with directory, joined with '/'
+
+
+// Read-only view of a whole file, mapped into memory rather than copied so loaders can parse it in place
+// The data is exactly the file's bytes with no null terminator, so always go by GetSize()
+// Paths resolve through any mounted PackFiles, with loose files on disk first if overrides are enabled
+class MappedFile
+{
+public:
+	//-----Public Methods-----
+
+	MappedFile() {}
+	~MappedFile();
+	MappedFile(const MappedFile& copy) = delete;
+
+	bool			Open(const char* filepath);
+	bool			OpenLooseFile(const char* filepath);	// Only from disk, skipping mounted packs
+	void			Close();
+	void			Prefetch() const;	// Touches every page, so the disk read happens now rather than on first access
+
+	bool			IsOpen() const;
+	const char*		GetData() const;	// nullptr for an empty file
+	size_t			GetSize() const;
+
+
+private:
+	//-----Private Data-----
+
+	void*			m_fileHandle = nullptr;
+	void*			m_mappingHandle = nullptr;
+	const char*		m_data = nullptr;
+	size_t			m_size = 0;
+	bool			m_ownsData = false;		// Set for compressed pack entries, which are inflated into a new buffer
+	bool			m_isOpen = false;
+
+};
 
 
-// Class to represent a single file object
+// Class to represent a single file object, read front to back in chunks so the whole file is never in memory at once
 class File
 {
 public:
@@ -34,38 +81,49 @@ public:
 	~File();
 
 	// Opening/Closing
+	// Read-only opens resolve through mounted packs like MappedFile does, with the packed file read in as one chunk
 	bool Open(const char* filepath, const char* flags);
 	bool Close();
 
 	// Read/Writing
-	bool LoadFileToMemory();
-	void Write(const char* buffer, size_t length);
-	void Write(uint8_t* buffer, size_t length);
-	void Flush();
+	size_t	Read(void* out_buffer, size_t byteCount);
+	void	Write(const char* buffer, size_t length);
+	void	Write(uint8_t* buffer, size_t length);
+	void	Flush();
 
-	// For manipulating files loaded into memory
-	unsigned int	GetNextLine(std::string& out_string);
+	// The line points into the read buffer and doesn't include its line ending, so it's only valid until the next read
+	// and isn't null terminated - returns false once there are no lines left
+	bool			GetNextLine(const char*& out_line, size_t& out_length);
+	unsigned int	GetLineNumber() const;
 	bool			IsAtEndOfFile() const;
 
 	size_t			GetSize() const;
-	const char*		GetData() const;
 	std::string		GetFilePathOpened() const;
 
 
+private:
+	//-----Private Methods-----
+
+	bool			FillReadBuffer();
+	bool			OpenFromPack(const char* filepath);
+
+
 private:
 	//-----Private Data-----
 
 	// File pointer (FILE*)
 	void* m_filePointer = nullptr;
 	std::string m_filePathOpened;
+	size_t m_packedSize = 0;		// Size of the file if it was read out of a pack, in which case there's no file pointer
+	bool m_isOpenFromPack = false;
 
-	// File data
-	size_t		m_size = 0;
-	const char* m_data = nullptr;
+	// Chunk most recently read, only [m_readOffset, m_readEnd) is still unconsumed
+	std::vector<char>	m_readBuffer;
+	size_t				m_readOffset = 0;
+	size_t				m_readEnd = 0;
+	bool				m_hasReadToEnd = false;
 
-	// For parsing file contents loaded into memory
-	unsigned int	m_offset = 0;
-	bool			m_isAtEndOfFile = false;
-	unsigned int	m_lineNumber = 0;
+	bool				m_isAtEndOfFile = false;
+	unsigned int		m_lineNumber = 0;
 
 };
@@ -0,0 +1,333 @@
+/************************************************************************/
+/* File: FileWatcher.cpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Implementation of the FileWatcher class
+/************************************************************************/
+#include "Engine/Core/File.hpp"
+#include "Engine/Core/FileWatcher.hpp"
+#include "Engine/Core/Time/Time.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DeveloperConsole/DevConsole.hpp"
+
+// For directory change notifications
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>			// #include this (massive, platform-specific) header in very few places
+
+// Big enough for a few hundred notifications between wakeups, more than that and the OS drops them all
+#define NOTIFICATION_BUFFER_SIZE (64 * 1024)
+
+
+//-----------------------------------------------------------------------------------------------
+// Destructor - stops the thread if it's still running
+//
+FileWatcher::~FileWatcher()
+{
+	Stop();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Starts watching the directory and everything under it on a new thread, returning false if the
+// directory couldn't be watched at all
+//
+bool FileWatcher::Start(const std::string& directory, bool usePolling /*= false*/)
+{
+	Stop();
+
+	m_directory = directory;
+	while (m_directory.size() > 0 && (m_directory.back() == '/' || m_directory.back() == '\\'))
+	{
+		m_directory.pop_back();
+	}
+
+	DWORD attributes = GetFileAttributesA(m_directory.c_str());
+	if (attributes == INVALID_FILE_ATTRIBUTES || (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+	{
+		ConsoleErrorf("FileWatcher couldn't watch \"%s\", it isn't a directory", m_directory.c_str());
+		return false;
+	}
+
+	m_isPolling = usePolling;
+
+	if (!m_isPolling)
+	{
+		HANDLE directoryHandle = CreateFileA(m_directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+
+		if (directoryHandle == INVALID_HANDLE_VALUE)
+		{
+			ConsoleWarningf("FileWatcher couldn't open \"%s\" for notifications, polling it instead", m_directory.c_str());
+			m_isPolling = true;
+		}
+		else
+		{
+			m_directoryHandle = directoryHandle;
+		}
+	}
+
+	if (m_isPolling)
+	{
+		// Baseline to compare against, so everything isn't reported as changed on the first scan
+		ScanWriteTimes(false);
+	}
+
+	m_stopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	m_isRunning = true;
+	m_thread = Thread::Create(ThreadEntry, this);
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Stops the watch thread and waits for it to exit, dropping any changes not yet returned
+//
+void FileWatcher::Stop()
+{
+	if (m_thread != nullptr)
+	{
+		m_isRunning = false;
+		SetEvent((HANDLE)m_stopEvent);
+
+		Thread::Join(m_thread);
+		m_thread = nullptr;
+	}
+
+	if (m_directoryHandle != nullptr)
+	{
+		CloseHandle((HANDLE)m_directoryHandle);
+		m_directoryHandle = nullptr;
+	}
+
+	if (m_stopEvent != nullptr)
+	{
+		CloseHandle((HANDLE)m_stopEvent);
+		m_stopEvent = nullptr;
+	}
+
+	m_writeTimes.clear();
+
+	std::lock_guard<std::mutex> lock(m_changeLock);
+	m_pendingChanges.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the watch thread is running
+//
+bool FileWatcher::IsWatching() const
+{
+	return m_isRunning;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if changes are found by comparing write times instead of OS notifications
+//
+bool FileWatcher::IsPolling() const
+{
+	return m_isPolling;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Moves the paths that have settled into the list, leaving ones that changed too recently for a later call
+//
+void FileWatcher::GetChangedFiles(std::vector<std::string>& out_filepaths)
+{
+	uint64_t settleCounts = TimeSystem::SecondsToPerformanceCount(SETTLE_SECONDS);
+	uint64_t nowHPC = GetPerformanceCounter();
+
+	std::lock_guard<std::mutex> lock(m_changeLock);
+
+	std::map<std::string, uint64_t>::iterator itr = m_pendingChanges.begin();
+	while (itr != m_pendingChanges.end())
+	{
+		if (nowHPC - itr->second >= settleCounts)
+		{
+			out_filepaths.push_back(itr->first);
+			itr = m_pendingChanges.erase(itr);
+		}
+		else
+		{
+			itr++;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Entry point for the watch thread
+//
+void FileWatcher::ThreadEntry(void* watcher)
+{
+	FileWatcher* fileWatcher = (FileWatcher*)watcher;
+
+	if (fileWatcher->m_isPolling)
+	{
+		fileWatcher->PollForChanges();
+	}
+	else
+	{
+		fileWatcher->WatchForNotifications();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Waits on directory change notifications until stopped, switching to polling if they stop working
+//
+void FileWatcher::WatchForNotifications()
+{
+	// Notifications are DWORD aligned
+	DWORD* buffer = (DWORD*)malloc(NOTIFICATION_BUFFER_SIZE);
+
+	OVERLAPPED overlapped;
+	memset(&overlapped, 0, sizeof(OVERLAPPED));
+	overlapped.hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+	HANDLE waitHandles[2] = { overlapped.hEvent, (HANDLE)m_stopEvent };
+	DWORD notifyFilter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+
+	while (m_isRunning)
+	{
+		if (!ReadDirectoryChangesW((HANDLE)m_directoryHandle, buffer, NOTIFICATION_BUFFER_SIZE, TRUE, notifyFilter, NULL, &overlapped, NULL))
+		{
+			ConsoleWarningf("FileWatcher lost notifications for \"%s\", polling it instead", m_directory.c_str());
+
+			m_isPolling = true;
+			ScanWriteTimes(false);
+			break;
+		}
+
+		DWORD waitResult = WaitForMultipleObjects(2, waitHandles, FALSE, INFINITE);
+		if (waitResult != WAIT_OBJECT_0)
+		{
+			// Stopped - cancel the outstanding read and wait for it, since it writes into the buffer
+			DWORD bytesReturned = 0;
+			CancelIo((HANDLE)m_directoryHandle);
+			GetOverlappedResult((HANDLE)m_directoryHandle, &overlapped, &bytesReturned, TRUE);
+			break;
+		}
+
+		DWORD bytesReturned = 0;
+		GetOverlappedResult((HANDLE)m_directoryHandle, &overlapped, &bytesReturned, FALSE);
+
+		if (bytesReturned == 0)
+		{
+			// Buffer overflowed and the OS dropped the notifications, so anything could have changed
+			// Report everything written since the last overflow, or every file if this is the first
+			ScanWriteTimes(true);
+			continue;
+		}
+
+		const char* notificationBytes = (const char*)buffer;
+		while (true)
+		{
+			const FILE_NOTIFY_INFORMATION* notification = (const FILE_NOTIFY_INFORMATION*)notificationBytes;
+
+			// Removals have nothing to reload from, and old names of renames are gone
+			if (notification->Action != FILE_ACTION_REMOVED && notification->Action != FILE_ACTION_RENAMED_OLD_NAME)
+			{
+				int wideLength = (int)(notification->FileNameLength / sizeof(WCHAR));
+				int narrowLength = WideCharToMultiByte(CP_UTF8, 0, notification->FileName, wideLength, NULL, 0, NULL, NULL);
+
+				std::string relativePath(narrowLength, '\0');
+				WideCharToMultiByte(CP_UTF8, 0, notification->FileName, wideLength, &relativePath[0], narrowLength, NULL, NULL);
+
+				AddChange(m_directory + "/" + relativePath);
+			}
+
+			if (notification->NextEntryOffset == 0)
+			{
+				break;
+			}
+
+			notificationBytes += notification->NextEntryOffset;
+		}
+	}
+
+	CloseHandle(overlapped.hEvent);
+	free(buffer);
+
+	if (m_isRunning && m_isPolling)
+	{
+		PollForChanges();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Compares write times every poll interval until stopped
+//
+void FileWatcher::PollForChanges()
+{
+	while (m_isRunning)
+	{
+		if (WaitForSingleObject((HANDLE)m_stopEvent, POLL_INTERVAL_MS) != WAIT_TIMEOUT)
+		{
+			break;
+		}
+
+		ScanWriteTimes(true);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Updates the write time of every file under the directory, reporting new files and ones
+// whose time moved if recordChanges is set
+//
+void FileWatcher::ScanWriteTimes(bool recordChanges)
+{
+	std::vector<std::string> filepaths;
+	GetFilesInDirectory(m_directory, filepaths, true);
+
+	std::map<std::string, uint64_t> writeTimes;
+
+	for (int fileIndex = 0; fileIndex < (int)filepaths.size(); ++fileIndex)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA fileData;
+		if (!GetFileAttributesExA(filepaths[fileIndex].c_str(), GetFileExInfoStandard, &fileData))
+		{
+			continue;
+		}
+
+		uint64_t writeTime = ((uint64_t)fileData.ftLastWriteTime.dwHighDateTime << 32) | (uint64_t)fileData.ftLastWriteTime.dwLowDateTime;
+		writeTimes[filepaths[fileIndex]] = writeTime;
+
+		if (recordChanges)
+		{
+			std::map<std::string, uint64_t>::const_iterator itr = m_writeTimes.find(filepaths[fileIndex]);
+
+			if (itr == m_writeTimes.end() || itr->second != writeTime)
+			{
+				AddChange(filepaths[fileIndex]);
+			}
+		}
+	}
+
+	m_writeTimes.swap(writeTimes);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Records a change to the file, restarting its settle time if it's already pending
+//
+void FileWatcher::AddChange(const std::string& filepath)
+{
+	std::string normalizedPath = filepath;
+	for (int charIndex = 0; charIndex < (int)normalizedPath.size(); ++charIndex)
+	{
+		if (normalizedPath[charIndex] == '\\')
+		{
+			normalizedPath[charIndex] = '/';
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_changeLock);
+	m_pendingChanges[normalizedPath] = GetPerformanceCounter();
+}
@@ -0,0 +1,75 @@
+/************************************************************************/
+/* File: FileWatcher.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Watches a directory tree on a background thread and
+/*				reports the files that changed under it
+/************************************************************************/
+#pragma once
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "Engine/Core/Threading/Threading.hpp"
+
+class FileWatcher
+{
+public:
+	//-----Public Methods-----
+
+	FileWatcher() {}
+	~FileWatcher();
+	FileWatcher(const FileWatcher& copy) = delete;
+
+	// Uses the OS's change notifications, falling back to comparing write times every POLL_INTERVAL_MS
+	// if they aren't available for the directory (e.g. some network drives) or usePolling is set
+	bool	Start(const std::string& directory, bool usePolling = false);
+	void	Stop();
+
+	bool	IsWatching() const;
+	bool	IsPolling() const;
+
+	// Paths that were written, created or renamed to since the last call, each only once and only once
+	// they've gone SETTLE_SECONDS without another change, so a file still being saved isn't read half written
+	// Paths start with the watched directory and use '/'
+	void	GetChangedFiles(std::vector<std::string>& out_filepaths);
+
+
+public:
+	//-----Public Data-----
+
+	static constexpr unsigned int	POLL_INTERVAL_MS = 500;
+	static constexpr double			SETTLE_SECONDS = 0.1;
+
+
+private:
+	//-----Private Methods-----
+
+	static void		ThreadEntry(void* watcher);
+
+	void			WatchForNotifications();
+	void			PollForChanges();
+	void			ScanWriteTimes(bool recordChanges);
+	void			AddChange(const std::string& filepath);
+
+
+private:
+	//-----Private Data-----
+
+	std::string			m_directory;
+	ThreadHandle_t		m_thread = nullptr;
+	void*				m_directoryHandle = nullptr;	// Only when using notifications
+	void*				m_stopEvent = nullptr;			// Wakes the thread up to exit
+	std::atomic<bool>	m_isRunning{ false };
+	bool				m_isPolling = false;
+
+	// Path to the performance count of its most recent change, shared with the watch thread
+	std::mutex							m_changeLock;
+	std::map<std::string, uint64_t>		m_pendingChanges;
+
+	// Last write time of every file, only used by the watch thread when polling
+	std::map<std::string, uint64_t>		m_writeTimes;
+
+};
@@ -49,11 +49,10 @@ Gif::~Gif()
 //
 bool Gif::LoadFromFile(const std::string& filepath)
 {
-	// Load the data in a raw buffer first
-	size_t size;
-	void* data = FileReadToNewBuffer(filepath.c_str(), size);
+	// Decode straight from the mapped file
+	MappedFile file;
 	
-	if (data == nullptr)
+	if (!file.Open(filepath.c_str()))
 	{
 		return false;
 	}
@@ -63,7 +62,7 @@ bool Gif::LoadFromFile(const std::string& filepath)
 
 	int* delays;
 	stbi_set_flip_vertically_on_load(1);
-	m_gifData = (unsigned char*) stbi_load_gif_from_memory((const stbi_uc*)data, (int) size, &delays, &m_frameDimensions.x, &m_frameDimensions.y, &m_numFrames, &m_numComponentsPerTexel, 0);
+	m_gifData = (unsigned char*) stbi_load_gif_from_memory((const stbi_uc*)file.GetData(), (int) file.GetSize(), &delays, &m_frameDimensions.x, &m_frameDimensions.y, &m_numFrames, &m_numComponentsPerTexel, 0);
 	stbi_set_flip_vertically_on_load(0);
 
 	if (m_gifData == nullptr)
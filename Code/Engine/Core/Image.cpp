@@ -5,7 +5,12 @@
 /* Bugs: None
 /* Description: Implementation of the Image class, indexed as top left (0,0)
 /************************************************************************/
+#include "Engine/Core/File.hpp"
 #include "Engine/Core/Image.hpp"
+#include "Engine/Core/ImageKernels.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
 #include "Engine/Core/Utility/StringUtils.hpp"
 #include "Engine/Core/Utility/ErrorWarningAssert.hpp"
 #include "Engine/Core/DeveloperConsole/DevConsole.hpp"
@@ -18,6 +23,33 @@ const Image Image::IMAGE_FLAT = Image(IntVector2(2, 2), Rgba(127, 127, 255, 255)
 const Image Image::IMAGE_BLACK = Image(IntVector2(2, 2), Rgba::BLACK);
 const Image Image::IMAGE_DEFAULT_TEXTURE = Image(IntVector2(64, 64), IntVector2(8, 8), Rgba::BLUE, Rgba::GRAY);
 
+// Mip levels smaller than this are filtered on the calling thread, since the jobs would cost more than the work
+#define MIN_TEXELS_PER_MIP_JOB (64 * 1024)
+
+// Job for filtering a range of rows of one mip level from the level above it
+class MipDownsampleJob : public Job
+{
+public:
+
+	MipDownsampleJob(const Image* source, Image* destination, unsigned char* destinationData, int startRow, int endRow)
+		: m_source(source), m_destination(destination), m_destinationData(destinationData), m_startRow(startRow), m_endRow(endRow)
+	{
+		m_jobType = JOB_TYPE_IMAGE_MIPS;
+		m_jobFlags = WORKER_FLAGS_ALL_BUT_DISK;
+	}
+
+	virtual void Execute() override;
+
+	const Image*	m_source = nullptr;
+	Image*			m_destination = nullptr;
+	unsigned char*	m_destinationData = nullptr;
+	int				m_startRow = 0;
+	int				m_endRow = 0;
+
+};
+
+static void DownsampleRows(const Image* source, const Image* destination, unsigned char* destinationData, int startRow, int endRow);
+
 
 //-----------------------------------------------------------------------------------------------
 // Default constructor, just makes a white 2x2 texel image
@@ -111,6 +143,8 @@ Image::Image(const IntVector2& dimensions, int numComponentsPerTexel, unsigned c
 //
 Image::~Image()
 {
+	ClearMipChain();
+
 	free((void*)m_imageData);
 	m_imageData = nullptr;
 }
@@ -124,8 +158,19 @@ bool Image::LoadFromFile(const std::string& filepath)
 	m_numComponentsPerTexel = 0;		// Filled in for us to indicate how many color/alpha components the image had (e.g. 3=RGB, 4=RGBA)
 	int numComponentsRequested = 0;		// don't care; we support 3 (RGB) or 4 (RGBA)
 
-	// Load (and decompress) the image RGB(A) bytes from a file on disk
-	m_imageData = stbi_load(filepath.c_str(), &m_dimensions.x, &m_dimensions.y, &m_numComponentsPerTexel, numComponentsRequested);
+	// Free whatever the constructor filled in, it's replaced by the file's data
+	free((void*)m_imageData);
+	m_isFlippedForTextures = false;
+	ClearMipChain();
+
+	// Decompress the image RGB(A) bytes straight from the mapped file
+	MappedFile file;
+	m_imageData = nullptr;
+
+	if (file.Open(filepath.c_str()) && file.GetSize() > 0)
+	{
+		m_imageData = stbi_load_from_memory((const stbi_uc*) file.GetData(), (int) file.GetSize(), &m_dimensions.x, &m_dimensions.y, &m_numComponentsPerTexel, numComponentsRequested);
+	}
 
 	if (DevConsole::GetInstance() != nullptr)
 	{
@@ -252,32 +297,214 @@ void Image::SetTexel(int x, int y, const Rgba& color)
 
 
 //-----------------------------------------------------------------------------------------------
-// Flips the image horizontally (over the X axis, making the top row the bottom row, and so on) 
+// Flips the image vertically (over the X axis, making the top row the bottom row, and so on)
+// Swaps rows in place, through a buffer of one row
 //
 void Image::FlipVertical()
 {
-	// Create a temp vector for assembly
-	int numTexels = GetTexelCount();
+	int rowSize = m_dimensions.x * m_numComponentsPerTexel;
+	unsigned char* rowBuffer = (unsigned char*)malloc(sizeof(unsigned char) * rowSize);
+
+	unsigned char* topRow = m_imageData;
+	unsigned char* bottomRow = m_imageData + (m_dimensions.y - 1) * rowSize;
+
+	for (int rowIndex = 0; rowIndex < m_dimensions.y / 2; ++rowIndex)
+	{
+		memcpy(rowBuffer, topRow, rowSize);
+		memcpy(topRow, bottomRow, rowSize);
+		memcpy(bottomRow, rowBuffer, rowSize);
+
+		topRow += rowSize;
+		bottomRow -= rowSize;
+	}
+
+	free(rowBuffer);
+
+	for (int mipIndex = 0; mipIndex < (int) m_mipLevels.size(); ++mipIndex)
+	{
+		m_mipLevels[mipIndex]->FlipVertical();
+	}
+
+	m_isFlippedForTextures = !m_isFlippedForTextures;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Expands an RGB image to RGBA with the given alpha, so it uploads without the driver repacking it
+//
+void Image::ConvertToRGBA(unsigned char alpha /*= 255*/)
+{
+	if (m_numComponentsPerTexel != 3)
+	{
+		return;
+	}
+
+	unsigned char* rgbaData = (unsigned char*)malloc(sizeof(unsigned char) * 4 * GetTexelCount());
+
+#ifdef IMAGE_USE_SSE2
+	ExpandRGBToRGBA_SSE2(m_imageData, rgbaData, GetTexelCount(), alpha);
+#else
+	ExpandRGBToRGBA_Scalar(m_imageData, rgbaData, GetTexelCount(), alpha);
+#endif
+
+	free(m_imageData);
+	m_imageData = rgbaData;
+	m_numComponentsPerTexel = 4;
+
+	for (int mipIndex = 0; mipIndex < (int) m_mipLevels.size(); ++mipIndex)
+	{
+		m_mipLevels[mipIndex]->ConvertToRGBA(alpha);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Multiplies the color channels by alpha, for blending with premultiplied alpha
+//
+void Image::PremultiplyAlpha()
+{
+	if (m_numComponentsPerTexel != 4)
+	{
+		return;
+	}
+
+#ifdef IMAGE_USE_SSE2
+	PremultiplyAlpha_SSE2(m_imageData, GetTexelCount());
+#else
+	PremultiplyAlpha_Scalar(m_imageData, GetTexelCount());
+#endif
+
+	for (int mipIndex = 0; mipIndex < (int) m_mipLevels.size(); ++mipIndex)
+	{
+		m_mipLevels[mipIndex]->PremultiplyAlpha();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Converts the color channels from sRGB to linear, alpha is already linear
+//
+void Image::ConvertSRGBToLinear()
+{
+	::ConvertSRGBToLinear(m_imageData, GetTexelCount(), m_numComponentsPerTexel);
+
+	for (int mipIndex = 0; mipIndex < (int) m_mipLevels.size(); ++mipIndex)
+	{
+		m_mipLevels[mipIndex]->ConvertSRGBToLinear();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Converts the color channels from linear to sRGB
+//
+void Image::ConvertLinearToSRGB()
+{
+	::ConvertLinearToSRGB(m_imageData, GetTexelCount(), m_numComponentsPerTexel);
+
+	for (int mipIndex = 0; mipIndex < (int) m_mipLevels.size(); ++mipIndex)
+	{
+		m_mipLevels[mipIndex]->ConvertLinearToSRGB();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Builds every mip level down to 1x1, each filtered from the one above it
+// Large levels are split by rows between the calling thread and the non-disk workers, unless this is
+// already running in a job (as async texture loads are), where it all runs inline instead
+//
+void Image::GenerateMipChain()
+{
+	ClearMipChain();
 
-	int numComponents = numTexels * m_numComponentsPerTexel;
-	unsigned char* newBuffer = (unsigned char*)malloc(sizeof(unsigned char) * numComponents);
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	bool canUseJobs = (jobSystem != nullptr && !JobSystem::IsOnWorkerThread());
+	int workerCount = (canUseJobs ? jobSystem->GetWorkerThreadCount(WORKER_FLAGS_ALL_BUT_DISK) : 0);
 
-	for (int rowIndex = m_dimensions.y - 1; rowIndex >= 0; --rowIndex)	// Start from the last (bottom) row and work back up
+	std::vector<int> jobIDs;
+	const Image* source = this;
+
+	while (source->m_dimensions.x > 1 || source->m_dimensions.y > 1)
 	{
-		for (int colIndex = 0; colIndex < m_dimensions.x; ++colIndex)
+		IntVector2 mipDimensions = IntVector2(MaxInt(source->m_dimensions.x / 2, 1), MaxInt(source->m_dimensions.y / 2, 1));
+		unsigned char* mipData = (unsigned char*)malloc(sizeof(unsigned char) * m_numComponentsPerTexel * mipDimensions.x * mipDimensions.y);
+
+		Image* mip = new Image(mipDimensions, m_numComponentsPerTexel, mipData);
+		mip->m_isFlippedForTextures = m_isFlippedForTextures;
+
+		// The calling thread takes a share too
+		int splitCount = ClampInt((mipDimensions.x * mipDimensions.y) / MIN_TEXELS_PER_MIP_JOB, 1, workerCount + 1);
+		int rowsPerSplit = (mipDimensions.y + splitCount - 1) / splitCount;
+
+		for (int startRow = rowsPerSplit; startRow < mipDimensions.y; startRow += rowsPerSplit)
 		{
-			Rgba currTexel = GetTexelColor(colIndex, rowIndex);
+			jobIDs.push_back(QueueJob(new MipDownsampleJob(source, mip, mipData, startRow, MinInt(startRow + rowsPerSplit, mipDimensions.y))));
+		}
+
+		DownsampleRows(source, mip, mipData, 0, MinInt(rowsPerSplit, mipDimensions.y));
 
-			// Temporarily swap the buffers to make use of the SetTexel function
-			unsigned char* temp = m_imageData;
-			m_imageData = newBuffer;
-			SetTexel(colIndex, m_dimensions.y - rowIndex - 1, currTexel);
-			m_imageData = temp;
+		if (jobIDs.size() > 0)
+		{
+			jobSystem->BlockUntilJobsAreFinalized(jobIDs);
+			jobIDs.clear();
 		}
+
+		m_mipLevels.push_back(mip);
+		source = mip;
 	}
+}
 
-	free(m_imageData);
-	m_imageData = newBuffer;
 
-	m_isFlippedForTextures = !m_isFlippedForTextures;
+//-----------------------------------------------------------------------------------------------
+// Deletes the mip levels, leaving just the image itself
+//
+void Image::ClearMipChain()
+{
+	for (int mipIndex = 0; mipIndex < (int) m_mipLevels.size(); ++mipIndex)
+	{
+		delete m_mipLevels[mipIndex];
+	}
+
+	m_mipLevels.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of mip levels, counting this image as level 0
+//
+int Image::GetMipLevelCount() const
+{
+	return (int) m_mipLevels.size() + 1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the given mip level, where level 0 is this image
+//
+const Image* Image::GetMipLevel(int level) const
+{
+	return (level == 0 ? this : m_mipLevels[level - 1]);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Filters the job's rows
+//
+void MipDownsampleJob::Execute()
+{
+	DownsampleRows(m_source, m_destination, m_destinationData, m_startRow, m_endRow);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Filters rows [startRow, endRow) of the destination from the source, twice its size
+//
+static void DownsampleRows(const Image* source, const Image* destination, unsigned char* destinationData, int startRow, int endRow)
+{
+#ifdef IMAGE_USE_SSE2
+	DownsampleRows_SSE2(source->GetImageData(), source->GetTexelDimensions(), destinationData, destination->GetTexelDimensions(), source->GetNumComponentsPerTexel(), startRow, endRow);
+#else
+	DownsampleRows_Scalar(source->GetImageData(), source->GetTexelDimensions(), destinationData, destination->GetTexelDimensions(), source->GetNumComponentsPerTexel(), startRow, endRow);
+#endif
 }
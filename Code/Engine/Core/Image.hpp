@@ -12,7 +12,6 @@
 #include "Engine/Math/IntVector2.hpp"
 #include "Engine/Core/Image.hpp"
 #include "Engine/Core/EngineCommon.hpp"
-TODO("Make flip Y fast (profile)");
 
 class Image
 {
@@ -39,6 +38,18 @@ public:
 	void SetTexel( int x, int y, const Rgba& color );
 	void FlipVertical();
 
+	// Whole image passes, applied to the mip chain too if there is one
+	void ConvertToRGBA(unsigned char alpha = 255);	// No-op unless the image is RGB
+	void PremultiplyAlpha();						// No-op unless the image is RGBA
+	void ConvertSRGBToLinear();
+	void ConvertLinearToSRGB();
+
+	// Mip chain down to 1x1, box filtered on worker threads when there are any, so textures can upload it as is
+	void					GenerateMipChain();
+	void					ClearMipChain();
+	int						GetMipLevelCount() const;	// Including the image itself, so 1 without a chain
+	const Image*			GetMipLevel(int level) const;
+
 
 public:
 	//-----Public Data-----
@@ -58,4 +69,6 @@ protected:
 		
 	unsigned char* m_imageData;		// Raw string data of the image from stbi
 	bool m_isFlippedForTextures = false;
+
+	std::vector<Image*> m_mipLevels;	// Level 1 onward, owned
 };
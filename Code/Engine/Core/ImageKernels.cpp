@@ -0,0 +1,296 @@
+/************************************************************************/
+/* File: ImageKernels.cpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Implementation of the Image kernels
+/************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "Engine/Core/ImageKernels.hpp"
+#include "Engine/Math/IntVector2.hpp"
+
+#ifdef IMAGE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// 8 bit to 8 bit conversion tables, built on first use
+struct ColorSpaceTables_t
+{
+	ColorSpaceTables_t();
+
+	unsigned char srgbToLinear[256];
+	unsigned char linearToSRGB[256];
+};
+
+static const ColorSpaceTables_t& GetColorSpaceTables();
+
+
+//-----------------------------------------------------------------------------------------------
+// Copies RGB texels out to RGBA, setting every alpha to the one given
+//
+void ExpandRGBToRGBA_Scalar(const unsigned char* rgbTexels, unsigned char* out_rgbaTexels, int texelCount, unsigned char alpha)
+{
+	for (int texelIndex = 0; texelIndex < texelCount; ++texelIndex)
+	{
+		out_rgbaTexels[texelIndex * 4 + 0] = rgbTexels[texelIndex * 3 + 0];
+		out_rgbaTexels[texelIndex * 4 + 1] = rgbTexels[texelIndex * 3 + 1];
+		out_rgbaTexels[texelIndex * 4 + 2] = rgbTexels[texelIndex * 3 + 2];
+		out_rgbaTexels[texelIndex * 4 + 3] = alpha;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Multiplies each color channel by alpha, rounding to nearest
+//
+void PremultiplyAlpha_Scalar(unsigned char* rgbaTexels, int texelCount)
+{
+	for (int texelIndex = 0; texelIndex < texelCount; ++texelIndex)
+	{
+		unsigned char* texel = &rgbaTexels[texelIndex * 4];
+		unsigned int alpha = texel[3];
+
+		for (int channelIndex = 0; channelIndex < 3; ++channelIndex)
+		{
+			// x / 255 rounded, without the divide
+			unsigned int product = texel[channelIndex] * alpha + 128;
+			texel[channelIndex] = (unsigned char)((product + (product >> 8)) >> 8);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Averages each 2x2 block of source texels into one destination texel
+// Odd source sizes drop the last row/column, and a source size of 1 is sampled twice
+//
+void DownsampleRows_Scalar(const unsigned char* sourceTexels, const IntVector2& sourceDimensions, unsigned char* out_destTexels, const IntVector2& destDimensions, int numComponents, int startRow, int endRow)
+{
+	int sourceRowSize = sourceDimensions.x * numComponents;
+
+	for (int destY = startRow; destY < endRow; ++destY)
+	{
+		int sourceY0 = (2 * destY < sourceDimensions.y ? 2 * destY : sourceDimensions.y - 1);
+		int sourceY1 = (2 * destY + 1 < sourceDimensions.y ? 2 * destY + 1 : sourceDimensions.y - 1);
+
+		const unsigned char* sourceRow0 = sourceTexels + sourceY0 * sourceRowSize;
+		const unsigned char* sourceRow1 = sourceTexels + sourceY1 * sourceRowSize;
+		unsigned char* destRow = out_destTexels + destY * destDimensions.x * numComponents;
+
+		for (int destX = 0; destX < destDimensions.x; ++destX)
+		{
+			int sourceX0 = (2 * destX < sourceDimensions.x ? 2 * destX : sourceDimensions.x - 1);
+			int sourceX1 = (2 * destX + 1 < sourceDimensions.x ? 2 * destX + 1 : sourceDimensions.x - 1);
+
+			for (int channelIndex = 0; channelIndex < numComponents; ++channelIndex)
+			{
+				unsigned int sum = sourceRow0[sourceX0 * numComponents + channelIndex] + sourceRow0[sourceX1 * numComponents + channelIndex]
+					+ sourceRow1[sourceX0 * numComponents + channelIndex] + sourceRow1[sourceX1 * numComponents + channelIndex];
+
+				destRow[destX * numComponents + channelIndex] = (unsigned char)((sum + 2) >> 2);
+			}
+		}
+	}
+}
+
+
+#ifdef IMAGE_USE_SSE2
+
+//-----------------------------------------------------------------------------------------------
+// Reads 4 bytes that may not be aligned
+//
+static inline int LoadUnaligned32(const unsigned char* data)
+{
+	int value;
+	memcpy(&value, data, sizeof(int));
+	return value;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Expands 4 texels at a time - each is read as 4 bytes, picking up the next texel's red, which is masked off
+// The last few texels are left to the scalar version so the reads never run past the source
+//
+void ExpandRGBToRGBA_SSE2(const unsigned char* rgbTexels, unsigned char* out_rgbaTexels, int texelCount, unsigned char alpha)
+{
+	const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+	const __m128i alphaBits = _mm_set1_epi32((int)((unsigned int) alpha << 24));
+
+	int texelIndex = 0;
+	for (; texelIndex + 4 < texelCount; texelIndex += 4)
+	{
+		const unsigned char* source = &rgbTexels[texelIndex * 3];
+
+		__m128i texels = _mm_setr_epi32(LoadUnaligned32(source), LoadUnaligned32(source + 3), LoadUnaligned32(source + 6), LoadUnaligned32(source + 9));
+		texels = _mm_or_si128(_mm_and_si128(texels, rgbMask), alphaBits);
+
+		_mm_storeu_si128((__m128i*) &out_rgbaTexels[texelIndex * 4], texels);
+	}
+
+	ExpandRGBToRGBA_Scalar(&rgbTexels[texelIndex * 3], &out_rgbaTexels[texelIndex * 4], texelCount - texelIndex, alpha);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Premultiplies 4 texels at a time in 16 bit lanes, with alpha multiplied by 255 so it divides back to itself
+//
+void PremultiplyAlpha_SSE2(unsigned char* rgbaTexels, int texelCount)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i colorMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+	const __m128i alphaFactor = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+	const __m128i roundingBias = _mm_set1_epi16(128);
+
+	int texelIndex = 0;
+	for (; texelIndex + 4 <= texelCount; texelIndex += 4)
+	{
+		__m128i texels = _mm_loadu_si128((const __m128i*) &rgbaTexels[texelIndex * 4]);
+		__m128i halves[2] = { _mm_unpacklo_epi8(texels, zero), _mm_unpackhi_epi8(texels, zero) };
+
+		for (int halfIndex = 0; halfIndex < 2; ++halfIndex)
+		{
+			// Alpha into every lane of its texel, then swap its own lane's factor for 255
+			__m128i alphas = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[halfIndex], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			alphas = _mm_or_si128(_mm_and_si128(alphas, colorMask), alphaFactor);
+
+			__m128i product = _mm_add_epi16(_mm_mullo_epi16(halves[halfIndex], alphas), roundingBias);
+			halves[halfIndex] = _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+		}
+
+		_mm_storeu_si128((__m128i*) &rgbaTexels[texelIndex * 4], _mm_packus_epi16(halves[0], halves[1]));
+	}
+
+	PremultiplyAlpha_Scalar(&rgbaTexels[texelIndex * 4], texelCount - texelIndex);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Four channel images make 2 destination texels from each pair of 16 byte source loads, anything
+// else (or what's left at the end of a row) goes through the scalar version
+//
+void DownsampleRows_SSE2(const unsigned char* sourceTexels, const IntVector2& sourceDimensions, unsigned char* out_destTexels, const IntVector2& destDimensions, int numComponents, int startRow, int endRow)
+{
+	if (numComponents != 4 || sourceDimensions.x < 2)
+	{
+		DownsampleRows_Scalar(sourceTexels, sourceDimensions, out_destTexels, destDimensions, numComponents, startRow, endRow);
+		return;
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i roundingBias = _mm_set1_epi16(2);
+	int sourceRowSize = sourceDimensions.x * 4;
+
+	for (int destY = startRow; destY < endRow; ++destY)
+	{
+		int sourceY0 = (2 * destY < sourceDimensions.y ? 2 * destY : sourceDimensions.y - 1);
+		int sourceY1 = (2 * destY + 1 < sourceDimensions.y ? 2 * destY + 1 : sourceDimensions.y - 1);
+
+		const unsigned char* sourceRow0 = sourceTexels + sourceY0 * sourceRowSize;
+		const unsigned char* sourceRow1 = sourceTexels + sourceY1 * sourceRowSize;
+		unsigned char* destRow = out_destTexels + destY * destDimensions.x * 4;
+
+		int destX = 0;
+		for (; destX + 2 <= destDimensions.x; destX += 2)
+		{
+			__m128i row0 = _mm_loadu_si128((const __m128i*) &sourceRow0[destX * 8]);
+			__m128i row1 = _mm_loadu_si128((const __m128i*) &sourceRow1[destX * 8]);
+
+			// Vertical sums, two source texels per register
+			__m128i sumLow = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero), _mm_unpacklo_epi8(row1, zero));
+			__m128i sumHigh = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero), _mm_unpackhi_epi8(row1, zero));
+
+			// Horizontal sums, leaving each destination texel in the low 4 lanes
+			sumLow = _mm_add_epi16(sumLow, _mm_srli_si128(sumLow, 8));
+			sumHigh = _mm_add_epi16(sumHigh, _mm_srli_si128(sumHigh, 8));
+
+			__m128i averages = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(sumLow, sumHigh), roundingBias), 2);
+			_mm_storel_epi64((__m128i*) &destRow[destX * 4], _mm_packus_epi16(averages, zero));
+		}
+
+		// Odd destination width, filter the last texel as its own one row pass
+		if (destX < destDimensions.x)
+		{
+			for (int channelIndex = 0; channelIndex < 4; ++channelIndex)
+			{
+				int sourceX0 = 2 * destX;
+				int sourceX1 = (2 * destX + 1 < sourceDimensions.x ? 2 * destX + 1 : sourceDimensions.x - 1);
+
+				unsigned int sum = sourceRow0[sourceX0 * 4 + channelIndex] + sourceRow0[sourceX1 * 4 + channelIndex]
+					+ sourceRow1[sourceX0 * 4 + channelIndex] + sourceRow1[sourceX1 * 4 + channelIndex];
+
+				destRow[destX * 4 + channelIndex] = (unsigned char)((sum + 2) >> 2);
+			}
+		}
+	}
+}
+
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+// Converts the color channels from sRGB encoding to linear, keeping 8 bits per channel
+// Dark values lose precision, so keep the sRGB source around if it will be converted back
+//
+void ConvertSRGBToLinear(unsigned char* texels, int texelCount, int numComponents)
+{
+	const unsigned char* table = GetColorSpaceTables().srgbToLinear;
+	int colorChannelCount = (numComponents == 2 || numComponents == 4 ? numComponents - 1 : numComponents);
+
+	for (int texelIndex = 0; texelIndex < texelCount; ++texelIndex)
+	{
+		unsigned char* texel = &texels[texelIndex * numComponents];
+
+		for (int channelIndex = 0; channelIndex < colorChannelCount; ++channelIndex)
+		{
+			texel[channelIndex] = table[texel[channelIndex]];
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Converts the color channels from linear to sRGB encoding
+//
+void ConvertLinearToSRGB(unsigned char* texels, int texelCount, int numComponents)
+{
+	const unsigned char* table = GetColorSpaceTables().linearToSRGB;
+	int colorChannelCount = (numComponents == 2 || numComponents == 4 ? numComponents - 1 : numComponents);
+
+	for (int texelIndex = 0; texelIndex < texelCount; ++texelIndex)
+	{
+		unsigned char* texel = &texels[texelIndex * numComponents];
+
+		for (int channelIndex = 0; channelIndex < colorChannelCount; ++channelIndex)
+		{
+			texel[channelIndex] = table[texel[channelIndex]];
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Builds both tables from the sRGB transfer functions
+//
+ColorSpaceTables_t::ColorSpaceTables_t()
+{
+	for (int value = 0; value < 256; ++value)
+	{
+		float normalized = (float) value / 255.f;
+
+		float linear = (normalized <= 0.04045f ? normalized / 12.92f : powf((normalized + 0.055f) / 1.055f, 2.4f));
+		float srgb = (normalized <= 0.0031308f ? normalized * 12.92f : 1.055f * powf(normalized, 1.f / 2.4f) - 0.055f);
+
+		srgbToLinear[value] = (unsigned char)(linear * 255.f + 0.5f);
+		linearToSRGB[value] = (unsigned char)(srgb * 255.f + 0.5f);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the tables, building them the first time - the static is initialized once even with threads racing to it
+//
+static const ColorSpaceTables_t& GetColorSpaceTables()
+{
+	static ColorSpaceTables_t s_tables;
+	return s_tables;
+}
@@ -0,0 +1,35 @@
+/************************************************************************/
+/* File: ImageKernels.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Scalar and SSE2 versions of the per-texel Image passes,
+/*				Image picks one at compile time
+/************************************************************************/
+#pragma once
+
+class IntVector2;
+
+// Define ENGINE_DISABLE_SIMD to build with the scalar versions only
+#if !defined(ENGINE_DISABLE_SIMD) && (defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define IMAGE_USE_SSE2
+#endif
+
+// Texel data is tightly packed rows, 8 bits per channel, and the SSE2 versions match the scalar ones bit for bit
+
+// Scalar, the reference versions
+void	ExpandRGBToRGBA_Scalar(const unsigned char* rgbTexels, unsigned char* out_rgbaTexels, int texelCount, unsigned char alpha);
+void	PremultiplyAlpha_Scalar(unsigned char* rgbaTexels, int texelCount);
+
+// Box filters rows [startRow, endRow) of the destination from the source, which is twice its size (clamped at 1)
+// Rows are independent, so row ranges can run on separate threads
+void	DownsampleRows_Scalar(const unsigned char* sourceTexels, const IntVector2& sourceDimensions, unsigned char* out_destTexels, const IntVector2& destDimensions, int numComponents, int startRow, int endRow);
+
+#ifdef IMAGE_USE_SSE2
+void	ExpandRGBToRGBA_SSE2(const unsigned char* rgbTexels, unsigned char* out_rgbaTexels, int texelCount, unsigned char alpha);
+void	PremultiplyAlpha_SSE2(unsigned char* rgbaTexels, int texelCount);
+void	DownsampleRows_SSE2(const unsigned char* sourceTexels, const IntVector2& sourceDimensions, unsigned char* out_destTexels, const IntVector2& destDimensions, int numComponents, int startRow, int endRow);
+#endif
+
+// Table lookups, faster than SIMD math for 8 bit channels - alpha is left alone
+void	ConvertSRGBToLinear(unsigned char* texels, int texelCount, int numComponents);
+void	ConvertLinearToSRGB(unsigned char* texels, int texelCount, int numComponents);
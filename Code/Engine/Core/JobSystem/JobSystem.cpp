@@ -10,6 +10,7 @@
 #include "Engine/Core/Utility/ErrorWarningAssert.hpp"
 
 JobSystem* JobSystem::s_instance = nullptr;
+thread_local bool JobSystem::s_isWorkerThread = false;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -101,13 +102,35 @@ void JobSystem::DestroyAllWorkerThreads()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns the number of worker threads that would pick up a job with the given flags
+// Systems that block on their jobs should check this first, since with zero they'd wait forever
+//
+int JobSystem::GetWorkerThreadCount(uint32_t jobFlags) const
+{
+	int threadCount = 0;
+	int numThreads = (int)m_workerThreads.size();
+
+	for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+	{
+		if (m_workerThreads[threadIndex]->CanExecuteJobWithFlags(jobFlags))
+		{
+			threadCount++;
+		}
+	}
+
+	return threadCount;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Adds the given job to the "todo" list for worker threads to work on
 // Returns the ID assigned to the job
 //
 int JobSystem::QueueJob(Job* job)
 {
-	job->m_jobID = m_nextJobID;
+	// Masked instead of reset on wrap, so no two threads can take the same ID
+	job->m_jobID = (m_nextJobID.fetch_add(1, std::memory_order_relaxed) & INT32_MAX);
 
 	m_queuedLock.lock();
 	{
@@ -115,12 +138,6 @@ int JobSystem::QueueJob(Job* job)
 	}
 	m_queuedLock.unlock();
 
-	m_nextJobID++;
-	if (m_nextJobID < 0)
-	{
-		m_nextJobID = 0;
-	}
-
 	return job->m_jobID;
 }
 
@@ -286,22 +303,33 @@ void JobSystem::FinalizeAllFinishedJobs()
 
 
 //------------------------------------------------------------------------------
-// Finalizes all jobs in the finished list that are the given ID
+// Finalizes all jobs in the finished list that are the given type, in the order they finished
 //
 void JobSystem::FinalizeAllFinishedJobsOfType(int jobType)
 {
 	m_finishedLock.lock();
 	{
 		int numFinished = (int)m_finishedJobs.size();
+		int numKept = 0;
 
+		// Compacts the other types down as it goes, instead of erasing each finalized job
 		for (int finishedIndex = 0; finishedIndex < numFinished; ++finishedIndex)
 		{
-			if (m_finishedJobs[finishedIndex]->m_jobType == jobType)
-			m_finishedJobs[finishedIndex]->Finalize();
-			delete m_finishedJobs[finishedIndex];
+			Job* finishedJob = m_finishedJobs[finishedIndex];
+
+			if (finishedJob->m_jobType == jobType)
+			{
+				finishedJob->Finalize();
+				delete finishedJob;
+			}
+			else
+			{
+				m_finishedJobs[numKept] = finishedJob;
+				numKept++;
+			}
 		}
 
-		m_finishedJobs.clear();
+		m_finishedJobs.resize(numKept);
 	}
 	m_finishedLock.unlock();
 }
@@ -338,6 +366,28 @@ void JobSystem::BlockUntilJobIsFinalized(int jobID)
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Waits until each of the given jobs is complete, finalizing and destroying each
+// Unlike waiting on a type, this won't wait on or finalize jobs queued by anyone else
+//
+void JobSystem::BlockUntilJobsAreFinalized(const std::vector<int>& jobIDs)
+{
+	for (int idIndex = 0; idIndex < (int)jobIDs.size(); ++idIndex)
+	{
+		BlockUntilJobIsFinalized(jobIDs[idIndex]);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if called from a job running on one of the worker threads
+//
+bool JobSystem::IsOnWorkerThread()
+{
+	return s_isWorkerThread;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Waits until all jobs of the give type are in the finished list only, and when done so finalizes
 // and deletes all
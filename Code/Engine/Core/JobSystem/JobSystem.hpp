@@ -5,6 +5,7 @@
 /* Description: Class for the multi-threaded job system
 /************************************************************************/
 #pragma once
+#include <atomic>
 #include <vector>
 #include <shared_mutex>
 
@@ -25,6 +26,23 @@ enum WorkerThreadFlags : uint32_t
 };
 
 
+// Job types used by engine systems, kept away from zero so they don't collide with game job types
+enum EngineJobType
+{
+	JOB_TYPE_PARTICLE_UPDATE = 1000,
+	JOB_TYPE_ANIMATION_UPDATE,
+	JOB_TYPE_CPU_SKINNING,
+	JOB_TYPE_TRANSFORM_UPDATE,
+	JOB_TYPE_NOISE_GRID,
+	JOB_TYPE_HEATMAP_SOLVE,
+	JOB_TYPE_OBJ_PARSE,
+	JOB_TYPE_ASSET_LOAD,
+	JOB_TYPE_IMAGE_MIPS,
+	JOB_TYPE_BLOCK_COMPRESS,
+	JOB_TYPE_FILE_READ
+};
+
+
 class Job;
 
 class JobSystem
@@ -41,6 +59,7 @@ public:
 	void				CreateWorkerThread(const char* name, WorkerThreadFlags flags);
 	void				DestroyWorkerThread(const char* name);
 	void				DestroyAllWorkerThreads();
+	int					GetWorkerThreadCount(uint32_t jobFlags) const;
 
 	int					QueueJob(Job* job);
 	void				DestroyAllJobs();
@@ -52,6 +71,11 @@ public:
 	void				FinalizeAllFinishedJobsOfType(int jobType);
 	void				BlockUntilJobIsFinalized(int jobID);
 	void				BlockUntilAllJobsOfTypeAreFinalized(int jobType);
+	void				BlockUntilJobsAreFinalized(const std::vector<int>& jobIDs);
+
+	// Jobs that split their work into more jobs must do it inline when this is true - waiting on
+	// a worker ties it up, and with every worker waiting there's nothing left to run the splits
+	static bool			IsOnWorkerThread();
 
 
 private:
@@ -73,9 +97,10 @@ private:
 	std::vector<Job*>				m_queuedJobs;
 	std::vector<Job*>				m_runningJobs;
 	std::vector<Job*>				m_finishedJobs;
-	int								m_nextJobID = 0;
+	std::atomic<int>				m_nextJobID{ 0 };		// Jobs queue jobs from worker threads too
 
 	static JobSystem*				s_instance;
+	static thread_local bool		s_isWorkerThread;		// Set by each JobWorkerThread on start
 
 };
 
@@ -65,6 +65,8 @@ void JobWorkerThread::Join()
 //
 void JobWorkerThread::JobWorkerThreadEntry()
 {
+	JobSystem::s_isWorkerThread = true;
+
 	while (m_isRunning)
 	{
 		// Get a job
@@ -24,6 +24,7 @@ public:
 
 	inline std::string	GetName() const { return m_name; }
 	inline bool			IsRunning() const { return m_isRunning; }
+	inline bool			CanExecuteJobWithFlags(uint32_t jobFlags) const { return (jobFlags & m_workerFlags) == jobFlags; }
 	inline JobSystem*	GetOwningJobSystem() const { return m_jobSystem; }
 	inline std::thread&	GetThreadHandle() { return m_threadHandle; }
 
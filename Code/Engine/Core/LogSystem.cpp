@@ -10,6 +10,7 @@
 #include "Engine/Core/LogSystem.hpp"
 #include "Engine/Core/Time/Time.hpp"
 #include "Engine/Core/Time/Clock.hpp"
+#include "Engine/Core/Utility/StringID.hpp"
 #include "Engine/Core/Utility/StringUtils.hpp"
 #include "Engine/Core/DeveloperConsole/Command.hpp"
 
@@ -27,15 +28,43 @@ TODO("Make this singleton");
 // For LogPrintf, ensuring we don't copy anything too large
 const int STRINGF_STACK_LOCAL_TEMP_LENGTH = 2048;
 
+// A message takes as many records as its text needs, one after the other in the ring
+#define LOG_RECORD_COUNT (4096)		// Power of two
+#define LOG_RECORD_TEXT_SIZE (112)
+
+// A record's turn is 2x the lap of the ring it's free for, plus one once it's written for that lap,
+// so the zero initialized array starts out free for the first lap
+struct alignas(64) LogRecord_t
+{
+	std::atomic<uint64_t>	turn;
+	uint16_t				tagIndex;		// The rest are only set on a message's first record
+	uint16_t				recordCount;
+	uint32_t				textLength;
+	char					text[LOG_RECORD_TEXT_SIZE];
+};
+
+static LogRecord_t s_recordBuffer[LOG_RECORD_COUNT];
+
 // Static members
 bool											LogSystem::s_isRunning = true;
 File*											LogSystem::s_logFile = nullptr;
 File*											LogSystem::s_timeStampFile = nullptr;
 const char*										LogSystem::LOG_FILE_NAME_FORMAT = "Data/Logs/SystemLog_%s.log";
 ThreadHandle_t									LogSystem::s_logThread = nullptr;
+LogRecord_t*									LogSystem::s_records = s_recordBuffer;
+std::atomic<uint64_t>							LogSystem::s_writePosition{ 0 };
+std::atomic<uint64_t>							LogSystem::s_readPosition{ 0 };
+std::atomic<bool>								LogSystem::s_isLogThreadWaiting{ false };
+std::atomic<bool>								LogSystem::s_hasLogThread{ false };
+void*											LogSystem::s_wakeSemaphore = nullptr;
+std::atomic<uint64_t>							LogSystem::s_tagHashes[LOG_MAX_TAGS * 2];
+uint8_t											LogSystem::s_tagIndices[LOG_MAX_TAGS * 2];
+char											LogSystem::s_tagNames[LOG_MAX_TAGS][32];
+int												LogSystem::s_tagCount = 1;		// 0 is untagged
+std::mutex										LogSystem::s_tagLock;
 std::shared_mutex								LogSystem::s_callbackLock;
-ThreadSafeQueue<LogMessage_t>					LogSystem::s_logQueue;
 std::map<std::string, LogFilteredCallback_t>	LogSystem::s_callbacks;
+std::atomic<uint64_t>							LogSystem::s_enabledTagMask{ ~0ULL };		// Everything, until there are callbacks to say otherwise
 
 // Callback for writing the log to the system file
 static void WriteToFile(LogMessage_t log, void* fileptr);
@@ -98,8 +127,10 @@ void LogSystem::Initialize()
 	SetCallbackToBlackList("Debug Output", false);
 	AddCallbackFilter("Debug Output", "DEBUG");
 
-	s_logThread = Thread::Create(&ProcessLog, nullptr);
+	s_wakeSemaphore = CreateSemaphoreA(NULL, 0, 1, NULL);
 	s_isRunning = true;
+	s_logThread = Thread::Create(&ProcessLog, nullptr);
+	s_hasLogThread = true;
 
 	// Initialize the console commands
 	InitializeConsoleCommands();
@@ -114,9 +145,14 @@ void LogSystem::Shutdown()
 	s_isRunning = false;
 
 	// Flush the rest of the log
+	ReleaseSemaphore((HANDLE)s_wakeSemaphore, 1, NULL);
 	Thread::Join(s_logThread);
+	s_hasLogThread = false;
 	s_logThread = nullptr;
 
+	CloseHandle((HANDLE)s_wakeSemaphore);
+	s_wakeSemaphore = nullptr;
+
 	if (s_logFile != nullptr)
 	{
 		s_logFile->Close();
@@ -143,11 +179,114 @@ bool LogSystem::IsRunning()
 
 
 //-----------------------------------------------------------------------------------------------
-// Adds the given log message to the LogSystem
+// Copies the text into the ring for the log thread, waiting for room if it's full
+// Dropped if no callback takes the tag, or the ring is full with no log thread to empty it
+//
+void LogSystem::AddLog(const char* tag, const char* text, size_t textLength)
+{
+	int tagIndex = GetOrCreateTagIndex(tag);
+
+	if (tagIndex < 0)
+	{
+		// Out of tag bits, so keep the tag in the text instead
+		char taggedText[STRINGF_STACK_LOCAL_TEMP_LENGTH];
+		int taggedLength = snprintf(taggedText, STRINGF_STACK_LOCAL_TEMP_LENGTH, "%s: %.*s", tag, (int)textLength, text);
+		AddLog("", taggedText, (taggedLength < STRINGF_STACK_LOCAL_TEMP_LENGTH ? (size_t)taggedLength : STRINGF_STACK_LOCAL_TEMP_LENGTH - 1));
+		return;
+	}
+
+	if (((s_enabledTagMask.load(std::memory_order_relaxed) >> tagIndex) & 1) == 0)
+	{
+		return;
+	}
+
+	if (textLength > STRINGF_STACK_LOCAL_TEMP_LENGTH - 1)
+	{
+		textLength = STRINGF_STACK_LOCAL_TEMP_LENGTH - 1;
+	}
+
+	// Room for the terminator too, so the log thread can hand out single record messages in place
+	uint64_t recordCount = (textLength + LOG_RECORD_TEXT_SIZE) / LOG_RECORD_TEXT_SIZE;
+	uint64_t position = s_writePosition.load(std::memory_order_relaxed);
+
+	// Claim the records - the log thread frees them in order, so if the last is free for this lap they all are
+	while (true)
+	{
+		uint64_t lastPosition = position + recordCount - 1;
+		uint64_t lastTurn = s_records[lastPosition & (LOG_RECORD_COUNT - 1)].turn.load(std::memory_order_acquire);
+		uint64_t freeTurn = 2 * (lastPosition / LOG_RECORD_COUNT);
+
+		if (lastTurn == freeTurn)
+		{
+			if (s_writePosition.compare_exchange_weak(position, position + recordCount, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (lastTurn < freeTurn)
+		{
+			// Full, the log thread hasn't gotten to the last lap's message in this record yet
+			if (!s_hasLogThread)
+			{
+				return;
+			}
+
+			WakeLogThread();
+			Thread::YieldThisThread();
+			position = s_writePosition.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			// Another thread claimed it first
+			position = s_writePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Fill in the records, publishing the first last so the log thread never sees part of a message
+	for (uint64_t recordIndex = recordCount; recordIndex-- > 0;)
+	{
+		uint64_t recordPosition = position + recordIndex;
+		LogRecord_t& record = s_records[recordPosition & (LOG_RECORD_COUNT - 1)];
+
+		size_t textOffset = (size_t)recordIndex * LOG_RECORD_TEXT_SIZE;
+		size_t copySize = textLength - textOffset;
+		copySize = (copySize < LOG_RECORD_TEXT_SIZE ? copySize : LOG_RECORD_TEXT_SIZE);
+
+		// Only the last record is short, and it always has room for the terminator
+		memcpy(record.text, text + textOffset, copySize);
+		if (copySize < LOG_RECORD_TEXT_SIZE)
+		{
+			record.text[copySize] = '\0';
+		}
+
+		if (recordIndex == 0)
+		{
+			record.tagIndex = (uint16_t)tagIndex;
+			record.recordCount = (uint16_t)recordCount;
+			record.textLength = (uint32_t)textLength;
+
+			// Ordered before the check for a sleeping log thread, since it checks for this after saying it's sleeping
+			record.turn.store(2 * (recordPosition / LOG_RECORD_COUNT) + 1, std::memory_order_seq_cst);
+		}
+		else
+		{
+			record.turn.store(2 * (recordPosition / LOG_RECORD_COUNT) + 1, std::memory_order_release);
+		}
+	}
+
+	if (s_isLogThreadWaiting.load(std::memory_order_seq_cst))
+	{
+		WakeLogThread();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the null terminated text to the log
 //
-void LogSystem::AddLog(LogMessage_t message)
+void LogSystem::AddLog(const char* tag, const char* text)
 {
-	s_logQueue.Enqueue(message);
+	AddLog(tag, text, strlen(text));
 }
 
 
@@ -158,6 +297,7 @@ void LogSystem::AddCallback(LogCallBack_t callback)
 {
 	s_callbackLock.lock();
 	s_callbacks[callback.name].logCallback = callback;
+	UpdateEnabledTags();
 	s_callbackLock.unlock();
 }
 
@@ -177,9 +317,12 @@ void LogSystem::AddCallback(const char* name, Log_cb callback, void* argumentDat
 //
 void LogSystem::FlushLog()
 {
-	while (!s_logQueue.IsEmpty())
+	uint64_t endPosition = s_writePosition.load();
+	WakeLogThread();
+
+	while (s_hasLogThread && s_readPosition.load(std::memory_order_acquire) < endPosition)
 	{
-		// Spin wait
+		Thread::YieldThisThread();
 	}
 	
 	// Flush the files
@@ -196,9 +339,16 @@ void LogSystem::AddCallbackFilter(const std::string& callbackName, const std::st
 
 	std::map<std::string, LogFilteredCallback_t>::iterator itr = s_callbacks.find(callbackName);
 
-	if (itr != s_callbacks.end())
+	int tagIndex = GetOrCreateTagIndex(filter.c_str());
+
+	if (itr != s_callbacks.end() && tagIndex >= 0)
+	{
+		itr->second.filterMask |= (1ULL << tagIndex);
+		UpdateEnabledTags();
+	}
+	else if (itr != s_callbacks.end())
 	{
-		itr->second.filters.InsertUnique(filter);
+		ERROR_RECOVERABLE(Stringf("Error: LogSystem::AddCallbackFilter couldn't filter \"%s\", there are already %i tags", filter.c_str(), LOG_MAX_TAGS));
 	}
 	else
 	{
@@ -218,9 +368,15 @@ void LogSystem::RemoveCallBackFilter(const std::string& callbackName, const std:
 
 	std::map<std::string, LogFilteredCallback_t>::iterator itr = s_callbacks.find(callbackName);
 
+	int tagIndex = GetOrCreateTagIndex(filter.c_str());
+
 	if (itr != s_callbacks.end())
 	{
-		itr->second.filters.Remove(filter);
+		if (tagIndex >= 0)
+		{
+			itr->second.filterMask &= ~(1ULL << tagIndex);
+			UpdateEnabledTags();
+		}
 	}
 	else
 	{
@@ -243,7 +399,8 @@ void LogSystem::SetCallbackToBlackList(const std::string& callbackName, bool isB
 	if (itr != s_callbacks.end())
 	{
 		itr->second.isBlackList = isBlackList;
-		itr->second.filters.Clear();
+		itr->second.filterMask = 0;
+		UpdateEnabledTags();
 	}
 	else
 	{
@@ -265,9 +422,12 @@ void LogSystem::ShowAllTags()
 	while (itr != s_callbacks.end())
 	{
 		itr->second.isBlackList = true;
-		itr->second.filters.Clear();
+		itr->second.filterMask = 0;
+		itr++;
 	}
 
+	UpdateEnabledTags();
+
 	s_callbackLock.unlock();
 }
 
@@ -283,9 +443,12 @@ void LogSystem::HideAllTags()
 	while (itr != s_callbacks.end())
 	{
 		itr->second.isBlackList = false;
-		itr->second.filters.Clear();
+		itr->second.filterMask = 0;
+		itr++;
 	}
 
+	UpdateEnabledTags();
+
 	s_callbackLock.unlock();
 }
 
@@ -300,16 +463,122 @@ void LogSystem::InitializeConsoleCommands()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns true if a callback would take logs with the given tag
+//
+bool LogSystem::IsTagEnabled(const char* tag)
+{
+	int tagIndex = GetOrCreateTagIndex(tag);
+	tagIndex = (tagIndex >= 0 ? tagIndex : 0);
+
+	return (((s_enabledTagMask.load(std::memory_order_relaxed) >> tagIndex) & 1) != 0);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the index of the tag's bit in the filters, adding it if it's new, or -1 if there's no room for it
+// Tags are never removed, so lookups of ones already added don't need the lock
+//
+int LogSystem::GetOrCreateTagIndex(const char* tag)
+{
+	if (tag == nullptr || tag[0] == '\0')
+	{
+		return 0;
+	}
+
+	const int slotMask = (LOG_MAX_TAGS * 2) - 1;
+	uint64_t hash = StringID::HashCString(tag);
+	int startSlot = (int)(hash & slotMask);
+
+	for (int probeCount = 0; probeCount <= slotMask; ++probeCount)
+	{
+		int slot = (startSlot + probeCount) & slotMask;
+		uint64_t slotHash = s_tagHashes[slot].load(std::memory_order_acquire);
+
+		if (slotHash == hash)
+		{
+			return s_tagIndices[slot];
+		}
+		else if (slotHash == 0)
+		{
+			break;
+		}
+	}
+
+	// New tag - check again under the lock, in case another thread is adding it too
+	std::lock_guard<std::mutex> lock(s_tagLock);
+
+	for (int probeCount = 0; probeCount <= slotMask; ++probeCount)
+	{
+		int slot = (startSlot + probeCount) & slotMask;
+		uint64_t slotHash = s_tagHashes[slot].load(std::memory_order_relaxed);
+
+		if (slotHash == hash)
+		{
+			return s_tagIndices[slot];
+		}
+		else if (slotHash == 0)
+		{
+			int tagIndex = s_tagCount;
+			if (tagIndex >= LOG_MAX_TAGS)
+			{
+				return -1;
+			}
+
+			strncpy_s(s_tagNames[tagIndex], sizeof(s_tagNames[tagIndex]), tag, _TRUNCATE);
+			s_tagIndices[slot] = (uint8_t)tagIndex;
+			s_tagCount = tagIndex + 1;
+
+			// Published last, so a thread that finds the hash sees the name and index
+			s_tagHashes[slot].store(hash, std::memory_order_release);
+			return tagIndex;
+		}
+	}
+
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Recomputes which tags any callback would take, so logs nothing listens to are dropped before they're formatted
+//
+void LogSystem::UpdateEnabledTags()
+{
+	uint64_t enabledMask = 0;
+	std::map<std::string, LogFilteredCallback_t>::const_iterator itr = s_callbacks.begin();
+
+	for (itr; itr != s_callbacks.end(); itr++)
+	{
+		enabledMask |= (itr->second.isBlackList ? ~itr->second.filterMask : itr->second.filterMask);
+	}
+
+	s_enabledTagMask = enabledMask;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Log Thread
-// Constantly spins/sleeps, processing and removing messages in the queue
+// Processes messages until the ring is empty, then sleeps until a writer wakes it up
 //
 void LogSystem::ProcessLog(void*)
 {
 	while (IsRunning())
 	{
 		ProcessAllLogsInQueue();
-		Thread::SleepThisThreadFor(10); TODO("Use a semaphore here")
+
+		// Say we're waiting before the last check, so a message added after the check sees it and wakes us
+		s_isLogThreadWaiting.store(true, std::memory_order_seq_cst);
+
+		uint64_t readPosition = s_readPosition.load(std::memory_order_relaxed);
+		uint64_t readyTurn = 2 * (readPosition / LOG_RECORD_COUNT) + 1;
+		bool isEmpty = (s_records[readPosition & (LOG_RECORD_COUNT - 1)].turn.load(std::memory_order_seq_cst) != readyTurn);
+
+		if (isEmpty && IsRunning())
+		{
+			WaitForSingleObject((HANDLE)s_wakeSemaphore, INFINITE);
+		}
+
+		s_isLogThreadWaiting.store(false, std::memory_order_relaxed);
 	}
 
 	// Ensure the last of the messages are processed before terminating
@@ -318,33 +587,79 @@ void LogSystem::ProcessLog(void*)
 
 
 //-----------------------------------------------------------------------------------------------
-// Processes the messages in the queue, emptying it
+// Processes the messages in the ring, emptying it
 //
 void LogSystem::ProcessAllLogsInQueue()
 {
-	LogMessage_t message;
-	while (s_logQueue.Dequeue(message)) // Returns false when the queue is empty
+	// Messages that span records are copied together here, only the log thread uses it
+	static char s_spanningText[STRINGF_STACK_LOCAL_TEMP_LENGTH + LOG_RECORD_TEXT_SIZE];
+
+	uint64_t readPosition = s_readPosition.load(std::memory_order_relaxed);
+
+	while (true)
 	{
+		LogRecord_t& firstRecord = s_records[readPosition & (LOG_RECORD_COUNT - 1)];
+		if (firstRecord.turn.load(std::memory_order_acquire) != 2 * (readPosition / LOG_RECORD_COUNT) + 1)
+		{
+			break;
+		}
+
+		// The first record is published last, so the rest of the message is already there
+		int recordCount = firstRecord.recordCount;
+		const char* text = firstRecord.text;
+
+		if (recordCount > 1)
+		{
+			for (int recordIndex = 0; recordIndex < recordCount; ++recordIndex)
+			{
+				const LogRecord_t& record = s_records[(readPosition + recordIndex) & (LOG_RECORD_COUNT - 1)];
+				memcpy(s_spanningText + recordIndex * LOG_RECORD_TEXT_SIZE, record.text, LOG_RECORD_TEXT_SIZE);
+			}
+
+			s_spanningText[firstRecord.textLength] = '\0';
+			text = s_spanningText;
+		}
+
+		LogMessage_t message(s_tagNames[firstRecord.tagIndex], text);
+		int tagIndex = firstRecord.tagIndex;
+
 		s_callbackLock.lock_shared();
 
 		std::map<std::string, LogFilteredCallback_t>::iterator itr = s_callbacks.begin();
 
 		for (itr; itr != s_callbacks.end(); itr++)
 		{
-			LogCallBack_t logCallback = itr->second.logCallback;
-
 			// Only process the message if it's on our whitelist OR not on our blacklist, depending on our state
-			if (itr->second.isBlackList && !itr->second.filters.Contains(message.tag))
-			{
-				logCallback.callback(message, logCallback.argumentData);
-			}
-			else if (!itr->second.isBlackList && itr->second.filters.Contains(message.tag))
+			if (itr->second.AcceptsTag(tagIndex))
 			{
+				LogCallBack_t& logCallback = itr->second.logCallback;
 				logCallback.callback(message, logCallback.argumentData);
 			}
 		}
 
 		s_callbackLock.unlock_shared();
+
+		// Free the records for the next lap
+		for (int recordIndex = 0; recordIndex < recordCount; ++recordIndex)
+		{
+			uint64_t recordPosition = readPosition + recordIndex;
+			s_records[recordPosition & (LOG_RECORD_COUNT - 1)].turn.store(2 * (recordPosition / LOG_RECORD_COUNT + 1), std::memory_order_release);
+		}
+
+		readPosition += recordCount;
+		s_readPosition.store(readPosition, std::memory_order_release);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Wakes the log thread if it's waiting for messages, without the call into the OS if it isn't
+//
+void LogSystem::WakeLogThread()
+{
+	if (s_wakeSemaphore != nullptr && s_isLogThreadWaiting.exchange(false))
+	{
+		ReleaseSemaphore((HANDLE)s_wakeSemaphore, 1, NULL);
 	}
 }
 
@@ -355,7 +670,7 @@ void LogSystem::ProcessAllLogsInQueue()
 static void WriteToFile(LogMessage_t log, void* fileptr)
 {
 	File* file = (File*) fileptr;
-	std::string toPrint = Stringf("[%s] %s: %s\n", GetFormattedSystemTime().c_str(), log.tag.c_str(), log.message.c_str());
+	std::string toPrint = Stringf("[%s] %s: %s\n", GetFormattedSystemTime().c_str(), log.tag, log.message);
 	file->Write(toPrint.c_str(), toPrint.size());
 }
 
@@ -366,7 +681,7 @@ static void WriteToFile(LogMessage_t log, void* fileptr)
 static void WriteToDebugOutput(LogMessage_t log, void* fileptr)
 {
 	UNUSED(fileptr);
-	std::string toPrint = Stringf("%s: %s\n", log.tag.c_str(), log.message.c_str());
+	std::string toPrint = Stringf("%s: %s\n", log.tag, log.message);
 
 #if defined( PLATFORM_WINDOWS )
 	if( IsDebuggerAvailable() )
@@ -397,11 +712,7 @@ void LogPrintf(char const *format, ...)
 //
 void LogPrintString(const std::string& textLiteral)
 {
-	LogMessage_t log;
-	log.message = textLiteral;
-	log.tag = "";
-
-	LogSystem::AddLog(log);
+	LogSystem::AddLog("", textLiteral.c_str(), textLiteral.size());
 }
 
 
@@ -410,15 +721,7 @@ void LogPrintString(const std::string& textLiteral)
 //
 void LogPrintv(char const* format, va_list args)
 {
-	char textLiteral[STRINGF_STACK_LOCAL_TEMP_LENGTH];
-	vsnprintf_s(textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, args);	
-	textLiteral[STRINGF_STACK_LOCAL_TEMP_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
-
-	LogMessage_t log;
-	log.message	= std::string(textLiteral);
-	log.tag = "";
-
-	LogSystem::AddLog(log);
+	LogTaggedPrintv("", format, args);
 }
 
 
@@ -427,15 +730,18 @@ void LogPrintv(char const* format, va_list args)
 //
 void LogTaggedPrintv(char const* tag, char const* format, va_list args)
 {
+	// Don't pay for the formatting if nothing would show it
+	if (!LogSystem::IsTagEnabled(tag))
+	{
+		return;
+	}
+
 	char textLiteral[STRINGF_STACK_LOCAL_TEMP_LENGTH];
-	vsnprintf_s(textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, args);	
+	int textLength = vsnprintf_s(textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, args);
 	textLiteral[STRINGF_STACK_LOCAL_TEMP_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
-													
-	LogMessage_t log;
-	log.message	= std::string(textLiteral);
-	log.tag = tag;
 
-	LogSystem::AddLog(log);
+	// -1 when it was truncated
+	LogSystem::AddLog(tag, textLiteral, (textLength >= 0 ? (size_t)textLength : STRINGF_STACK_LOCAL_TEMP_LENGTH - 1));
 }
 
 
@@ -6,28 +6,34 @@
 /************************************************************************/
 #pragma once
 #include "Engine/Core/Threading/Threading.hpp"
-#include "Engine/DataStructures/ThreadSafeSet.hpp"
-#include "Engine/DataStructures/ThreadSafeMap.hpp"
-#include "Engine/DataStructures/ThreadSafeQueue.hpp"
 #include <shared_mutex>
+#include <stdint.h>
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <map>
 
 class File;
+struct LogRecord_t;
 
-// Struct to represent a single log
+// One bit per tag in the callback filters, tags past this are logged untagged with the tag in the text
+#define LOG_MAX_TAGS (64)
+
+// Struct to represent a single log, as handed to the callbacks
+// Both strings point into the log thread's buffers, so they're only valid for the duration of the callback
 struct LogMessage_t
 {
 	LogMessage_t() {}
 	LogMessage_t(const char* _tag, const char* _message)
 	 : tag(_tag), message(_message) {}
 
-	std::string tag;
-	std::string message;
+	const char* tag = "";
+	const char* message = "";
 
 };
 
 // Log callback, for hooking into processed messages
-typedef void (*Log_cb)(LogMessage_t, void *paramData); 
+typedef void (*Log_cb)(LogMessage_t, void *paramData);
 
 // Struct for representing a callback with argument data
 struct LogCallBack_t
@@ -42,18 +48,18 @@ struct LogCallBack_t
 
 };
 
-// Struct for a callback with a filtered list
-// This allows us to pass the LogCallback_t around by value, since
-// inside the set the std::mutex can't be copied (thus, can't copy LogFilteredCallback_t)
+// Struct for a callback with its filtered tags, as a bit per tag index
 struct LogFilteredCallback_t
 {
 	LogFilteredCallback_t() {}
 	LogFilteredCallback_t(LogCallBack_t logCallback)
 	 : logCallback(logCallback) {}
 
-	LogCallBack_t				logCallback;
-	ThreadSafeSet<std::string>	filters;
-	bool						isBlackList = true;
+	bool AcceptsTag(int tagIndex) const { return (((filterMask >> tagIndex) & 1) == 0) == isBlackList; }
+
+	LogCallBack_t	logCallback;
+	uint64_t		filterMask = 0;
+	bool			isBlackList = true;
 };
 
 class LogSystem
@@ -68,8 +74,9 @@ public:
 	// Accessors
 	static bool IsRunning();
 
-	// Mutators
-	static void AddLog(LogMessage_t message);
+	// Mutators - logging is safe from any thread, and never allocates or locks after the first use of a tag
+	static void AddLog(const char* tag, const char* text, size_t textLength);
+	static void AddLog(const char* tag, const char* text);
 	static void AddCallback(LogCallBack_t callback);
 	static void AddCallback(const char* name, Log_cb callback, void* argumentData);
 	static void FlushLog();
@@ -81,6 +88,9 @@ public:
 	static void ShowAllTags();
 	static void HideAllTags();
 
+	// Returns false if no callback would take the tag, so the caller can skip formatting the message
+	static bool IsTagEnabled(const char* tag);
+
 
 private:
 	//-----Private Methods-----
@@ -92,10 +102,14 @@ private:
 
 	static void InitializeConsoleCommands();
 
+	// Tags
+	static int	GetOrCreateTagIndex(const char* tag);
+	static void	UpdateEnabledTags();		// Call with the callback lock held
 
 	// Log thread functions
 	static void ProcessLog(void*);
 	static void ProcessAllLogsInQueue();
+	static void WakeLogThread();
 
 
 private:
@@ -107,11 +121,27 @@ private:
 
 	static bool s_isRunning;
 	static ThreadHandle_t s_logThread;
-	static ThreadSafeQueue<LogMessage_t> s_logQueue;
-	
+
+	// Ring of fixed size records, written by any thread and read only by the log thread
+	// The positions only ever increase, and are on their own cache lines so writers don't stall the reader
+	static LogRecord_t*							s_records;
+	alignas(64) static std::atomic<uint64_t>	s_writePosition;
+	alignas(64) static std::atomic<uint64_t>	s_readPosition;
+	static std::atomic<bool>					s_isLogThreadWaiting;
+	static std::atomic<bool>					s_hasLogThread;
+	static void*								s_wakeSemaphore;
+
+	// Tags are interned into indices once, and only added to after that
+	static std::atomic<uint64_t>	s_tagHashes[LOG_MAX_TAGS * 2];
+	static uint8_t					s_tagIndices[LOG_MAX_TAGS * 2];
+	static char						s_tagNames[LOG_MAX_TAGS][32];
+	static int						s_tagCount;
+	static std::mutex				s_tagLock;
+
 	// Callbacks
 	static std::shared_mutex s_callbackLock;
 	static std::map<std::string, LogFilteredCallback_t> s_callbacks;
+	static std::atomic<uint64_t> s_enabledTagMask;		// Tags at least one callback would take
 
 	// Statics
 	static LogSystem* s_instance;
@@ -0,0 +1,517 @@
+/************************************************************************/
+/* File: PackFile.cpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Implementation of the PackFile class
+/************************************************************************/
+#include "Engine/Core/PackFile.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Utility/StringID.hpp"
+#include "Engine/Core/DeveloperConsole/Command.hpp"
+#include "Engine/Core/DeveloperConsole/DevConsole.hpp"
+#include "ThirdParty/stb/stb_image.h"
+#include <algorithm>
+#include <limits.h>
+#include <mutex>
+
+// Defined with the rest of stb_image_write in Renderer.cpp, but not declared in its header section
+unsigned char* stbi_zlib_compress(unsigned char* data, int data_len, int* out_len, int quality);
+
+// File layout is a PackFileHeader_t, then every entry's data, then the PackEntry_t table, then the null-terminated paths
+// The table comes last so the builder can stream entries out without knowing their sizes up front
+// Like bakes, packs are only read on the machine type that wrote them, so everything is native-endian
+static const uint32_t	PACK_FILE_MAGIC = 0x4B434150; // "PACK"
+static const size_t		PACK_ALIGNMENT = 16;
+static const int		PACK_ZLIB_QUALITY = 8;
+
+struct PackFileHeader_t
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t reserved;
+	uint64_t entryTableOffset;
+	uint64_t stringTableOffset;
+	uint64_t stringTableSize;
+};
+
+struct PackEntry_t
+{
+	uint64_t pathHash;		// Of the normalized path
+	uint64_t offset;		// From the start of the file
+	uint64_t storedSize;	// Size in the pack, after compression
+	uint64_t size;			// Size once read
+	uint32_t compression;
+	uint32_t pathOffset;	// Into the string table, for telling apart two paths with the same hash
+};
+
+// Statics
+std::vector<PackFile*>	PackFile::s_mountedPacks;
+std::shared_mutex		PackFile::s_mountLock;
+
+#ifdef _DEBUG
+bool PackFile::s_looseFileOverridesEnabled = true;
+#else
+bool PackFile::s_looseFileOverridesEnabled = false;
+#endif
+
+// Console commands
+static void Command_PackBuild(Command& cmd);
+static void Command_PackMount(Command& cmd);
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the offset rounded up to the next pack alignment
+//
+static uint64_t AlignPackOffset(uint64_t offset)
+{
+	return (offset + PACK_ALIGNMENT - 1) & ~((uint64_t)PACK_ALIGNMENT - 1);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Writes zeroes until the file's write position is aligned, returning the new position
+//
+static uint64_t WritePackPadding(FILE* file, uint64_t offset)
+{
+	static const char ZEROES[PACK_ALIGNMENT] = {};
+
+	uint64_t alignedOffset = AlignPackOffset(offset);
+	fwrite(ZEROES, 1, (size_t)(alignedOffset - offset), file);
+
+	return alignedOffset;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Maps the pack and adds it to the front of the search order
+//
+bool PackFile::Mount(const std::string& packPath)
+{
+	PackFile* pack = new PackFile();
+
+	if (!pack->Open(packPath))
+	{
+		delete pack;
+		return false;
+	}
+
+	std::unique_lock<std::shared_mutex> lock(s_mountLock);
+	s_mountedPacks.push_back(pack);
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Unmaps the pack mounted from the given path, returning false if it isn't mounted
+//
+bool PackFile::Unmount(const std::string& packPath)
+{
+	std::unique_lock<std::shared_mutex> lock(s_mountLock);
+
+	for (int packIndex = (int)s_mountedPacks.size() - 1; packIndex >= 0; --packIndex)
+	{
+		if (s_mountedPacks[packIndex]->m_packPath == packPath)
+		{
+			delete s_mountedPacks[packIndex];
+			s_mountedPacks.erase(s_mountedPacks.begin() + packIndex);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Unmaps every mounted pack
+//
+void PackFile::UnmountAll()
+{
+	std::unique_lock<std::shared_mutex> lock(s_mountLock);
+
+	for (int packIndex = 0; packIndex < (int)s_mountedPacks.size(); ++packIndex)
+	{
+		delete s_mountedPacks[packIndex];
+	}
+
+	s_mountedPacks.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of packs currently mounted
+//
+int PackFile::GetMountedCount()
+{
+	std::shared_lock<std::shared_mutex> lock(s_mountLock);
+	return (int)s_mountedPacks.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets whether loose files on disk take priority over packed ones
+//
+void PackFile::SetLooseFileOverridesEnabled(bool enabled)
+{
+	s_looseFileOverridesEnabled = enabled;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if loose files on disk take priority over packed ones
+//
+bool PackFile::AreLooseFileOverridesEnabled()
+{
+	return s_looseFileOverridesEnabled;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Searches the mounted packs newest first, returning the file's data from the first that has it
+//
+bool PackFile::FindFile(const char* filepath, const char*& out_data, size_t& out_size, bool& out_isOwned)
+{
+	std::shared_lock<std::shared_mutex> lock(s_mountLock);
+
+	if (s_mountedPacks.size() == 0)
+	{
+		return false;
+	}
+
+	std::string normalizedPath = NormalizePath(filepath);
+	uint64_t pathHash = StringID::HashCString(normalizedPath.c_str());
+
+	for (int packIndex = (int)s_mountedPacks.size() - 1; packIndex >= 0; --packIndex)
+	{
+		const PackFile* pack = s_mountedPacks[packIndex];
+		const PackEntry_t* entry = pack->FindEntry(pathHash, normalizedPath);
+
+		if (entry != nullptr)
+		{
+			return pack->ReadEntry(*entry, out_data, out_size, out_isOwned);
+		}
+	}
+
+	return false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Writes every file under the directory into a new pack, compressing the entries it's worth it for
+//
+bool PackFile::Build(const std::string& sourceDirectory, const std::string& packPath, bool compress, PackBuildStats_t* out_stats /*= nullptr*/)
+{
+	std::vector<std::string> filepaths;
+	GetFilesInDirectory(sourceDirectory, filepaths, true);
+
+	FILE* packFile = OpenFile(packPath.c_str(), "wb");
+	if (packFile == nullptr)
+	{
+		ConsoleErrorf("PackFile::Build() couldn't open \"%s\" for writing", packPath.c_str());
+		return false;
+	}
+
+	// Header is rewritten once the tables are in
+	PackFileHeader_t header;
+	memset(&header, 0, sizeof(PackFileHeader_t));
+	fwrite(&header, sizeof(PackFileHeader_t), 1, packFile);
+
+	uint64_t writeOffset = sizeof(PackFileHeader_t);
+
+	std::string normalizedPackPath = NormalizePath(packPath.c_str());
+	std::vector<PackEntry_t> entries;
+	std::string stringTable;
+	PackBuildStats_t stats;
+
+	for (int fileIndex = 0; fileIndex < (int)filepaths.size(); ++fileIndex)
+	{
+		std::string normalizedPath = NormalizePath(filepaths[fileIndex].c_str());
+
+		// Don't pack an older copy of the pack into itself
+		if (normalizedPath == normalizedPackPath)
+		{
+			continue;
+		}
+
+		// Always from disk, even if an older pack with this file is mounted
+		MappedFile source;
+		if (!source.OpenLooseFile(filepaths[fileIndex].c_str()))
+		{
+			ConsoleWarningf("PackFile::Build() couldn't read \"%s\", skipping it", filepaths[fileIndex].c_str());
+			continue;
+		}
+
+		PackEntry_t entry;
+		entry.pathHash = StringID::HashCString(normalizedPath.c_str());
+		entry.size = source.GetSize();
+		entry.storedSize = source.GetSize();
+		entry.compression = PACK_COMPRESSION_NONE;
+		entry.pathOffset = (uint32_t)stringTable.size();
+
+		stringTable.append(normalizedPath);
+		stringTable.push_back('\0');
+
+		const char* storedData = source.GetData();
+		unsigned char* compressedData = nullptr;
+
+		// Already compressed formats (png, ogg...) won't shrink, so only keep the result if it saves at least an eighth
+		if (compress && entry.size > 0 && entry.size <= INT_MAX)
+		{
+			int compressedSize = 0;
+			compressedData = stbi_zlib_compress((unsigned char*)source.GetData(), (int)entry.size, &compressedSize, PACK_ZLIB_QUALITY);
+
+			if (compressedData != nullptr && (uint64_t)compressedSize < entry.size - (entry.size / 8))
+			{
+				storedData = (const char*)compressedData;
+				entry.storedSize = (uint64_t)compressedSize;
+				entry.compression = PACK_COMPRESSION_ZLIB;
+				stats.compressedCount++;
+			}
+		}
+
+		writeOffset = WritePackPadding(packFile, writeOffset);
+		entry.offset = writeOffset;
+
+		if (entry.storedSize > 0)
+		{
+			fwrite(storedData, 1, (size_t)entry.storedSize, packFile);
+		}
+
+		writeOffset += entry.storedSize;
+		free(compressedData);
+
+		entries.push_back(entry);
+		stats.fileCount++;
+		stats.sourceBytes += (size_t)entry.size;
+	}
+
+	// Sorted so a lookup is a binary search, with the path check only on a hash match
+	std::sort(entries.begin(), entries.end(), [](const PackEntry_t& a, const PackEntry_t& b) { return a.pathHash < b.pathHash; });
+
+	writeOffset = WritePackPadding(packFile, writeOffset);
+	header.entryTableOffset = writeOffset;
+
+	if (entries.size() > 0)
+	{
+		fwrite(entries.data(), sizeof(PackEntry_t), entries.size(), packFile);
+	}
+
+	writeOffset += sizeof(PackEntry_t) * entries.size();
+
+	header.stringTableOffset = writeOffset;
+	header.stringTableSize = stringTable.size();
+	fwrite(stringTable.data(), 1, stringTable.size(), packFile);
+	writeOffset += stringTable.size();
+
+	header.magic = PACK_FILE_MAGIC;
+	header.version = PACK_FILE_VERSION;
+	header.entryCount = (uint32_t)entries.size();
+
+	fseek(packFile, 0L, SEEK_SET);
+	fwrite(&header, sizeof(PackFileHeader_t), 1, packFile);
+
+	bool success = (ferror(packFile) == 0);
+	success = CloseFile(packFile) && success;
+
+	stats.packBytes = (size_t)writeOffset;
+
+	if (out_stats != nullptr)
+	{
+		*out_stats = stats;
+	}
+
+	return success;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the path in the form it's hashed and stored in
+//
+std::string PackFile::NormalizePath(const char* filepath)
+{
+	while (filepath[0] == '.' && (filepath[1] == '/' || filepath[1] == '\\'))
+	{
+		filepath += 2;
+	}
+
+	std::string normalizedPath(filepath);
+
+	for (size_t charIndex = 0; charIndex < normalizedPath.size(); ++charIndex)
+	{
+		char currChar = normalizedPath[charIndex];
+
+		if (currChar == '\\')
+		{
+			normalizedPath[charIndex] = '/';
+		}
+		else if (currChar >= 'A' && currChar <= 'Z')
+		{
+			normalizedPath[charIndex] = currChar - 'A' + 'a';
+		}
+	}
+
+	return normalizedPath;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Registers the commands for building and mounting packs
+//
+void PackFile::InitializeConsoleCommands()
+{
+	Command::Register("pack_build", "Packs every file under directory -d into pack -f, -c false to store everything uncompressed", Command_PackBuild);
+	Command::Register("pack_mount", "Mounts pack -f over any packs already mounted", Command_PackMount);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Maps the pack and checks its header and tables fit in the file
+//
+bool PackFile::Open(const std::string& packPath)
+{
+	// Not through the mounted packs, a pack is never inside another
+	if (!m_file.OpenLooseFile(packPath.c_str()))
+	{
+		ConsoleErrorf("PackFile::Mount() couldn't open \"%s\"", packPath.c_str());
+		return false;
+	}
+
+	const char* data = m_file.GetData();
+	size_t size = m_file.GetSize();
+	const PackFileHeader_t* header = (const PackFileHeader_t*)data;
+
+	bool isValid = size >= sizeof(PackFileHeader_t)
+		&& header->magic == PACK_FILE_MAGIC
+		&& header->version == PACK_FILE_VERSION
+		&& header->entryTableOffset + (uint64_t)header->entryCount * sizeof(PackEntry_t) <= size
+		&& header->stringTableOffset + header->stringTableSize <= size
+		&& (header->stringTableSize == 0 || data[header->stringTableOffset + header->stringTableSize - 1] == '\0');
+
+	if (!isValid)
+	{
+		ConsoleErrorf("PackFile::Mount() - \"%s\" isn't a version %i pack", packPath.c_str(), PACK_FILE_VERSION);
+		m_file.Close();
+		return false;
+	}
+
+	m_packPath = packPath;
+	m_entries = (const PackEntry_t*)(data + header->entryTableOffset);
+	m_entryCount = header->entryCount;
+	m_stringTable = data + header->stringTableOffset;
+	m_stringTableSize = (size_t)header->stringTableSize;
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Binary searches the table for the path, returning nullptr if this pack doesn't have it
+//
+const PackEntry_t* PackFile::FindEntry(uint64_t pathHash, const std::string& normalizedPath) const
+{
+	const PackEntry_t* entriesEnd = m_entries + m_entryCount;
+	const PackEntry_t* entry = std::lower_bound(m_entries, entriesEnd, pathHash, [](const PackEntry_t& a, uint64_t hash) { return a.pathHash < hash; });
+
+	// Two paths can share a hash, so check each match's stored path
+	for (; entry < entriesEnd && entry->pathHash == pathHash; ++entry)
+	{
+		if (entry->pathOffset < m_stringTableSize && normalizedPath == (m_stringTable + entry->pathOffset))
+		{
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the entry's bytes, inflating them into a new buffer if they were compressed
+//
+bool PackFile::ReadEntry(const PackEntry_t& entry, const char*& out_data, size_t& out_size, bool& out_isOwned) const
+{
+	if (entry.offset + entry.storedSize > m_file.GetSize())
+	{
+		ConsoleErrorf("PackFile - entry \"%s\" runs past the end of \"%s\"", m_stringTable + entry.pathOffset, m_packPath.c_str());
+		return false;
+	}
+
+	const char* storedData = m_file.GetData() + entry.offset;
+
+	if (entry.compression == PACK_COMPRESSION_NONE)
+	{
+		out_data = (entry.size > 0 ? storedData : nullptr);
+		out_size = (size_t)entry.size;
+		out_isOwned = false;
+
+		return true;
+	}
+
+	char* inflatedData = (char*)malloc((size_t)entry.size);
+	int inflatedSize = stbi_zlib_decode_buffer(inflatedData, (int)entry.size, storedData, (int)entry.storedSize);
+
+	if (inflatedSize != (int)entry.size)
+	{
+		ConsoleErrorf("PackFile - entry \"%s\" in \"%s\" is corrupt", m_stringTable + entry.pathOffset, m_packPath.c_str());
+		free(inflatedData);
+		return false;
+	}
+
+	out_data = inflatedData;
+	out_size = (size_t)entry.size;
+	out_isOwned = true;
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Builds a pack from a directory and prints how much it saved
+//
+static void Command_PackBuild(Command& cmd)
+{
+	std::string directory;
+	if (!cmd.GetParam("d", directory))
+	{
+		ConsoleErrorf("No directory specified, use -d <directory>");
+		return;
+	}
+
+	std::string packPath = directory + ".pack";
+	cmd.GetParam("f", packPath, &packPath);
+
+	bool compress = true;
+	cmd.GetParam("c", compress, &compress);
+
+	PackBuildStats_t stats;
+	if (!PackFile::Build(directory, packPath, compress, &stats))
+	{
+		ConsoleErrorf("Couldn't build pack \"%s\"", packPath.c_str());
+		return;
+	}
+
+	ConsolePrintf(Rgba::GREEN, "Packed %i files (%i compressed) into \"%s\", %u bytes down to %u",
+		stats.fileCount, stats.compressedCount, packPath.c_str(), (unsigned int)stats.sourceBytes, (unsigned int)stats.packBytes);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Mounts a pack
+//
+static void Command_PackMount(Command& cmd)
+{
+	std::string packPath;
+	if (!cmd.GetParam("f", packPath))
+	{
+		ConsoleErrorf("No pack specified, use -f <pack>");
+		return;
+	}
+
+	if (PackFile::Mount(packPath))
+	{
+		ConsolePrintf(Rgba::GREEN, "Mounted \"%s\", %i packs mounted", packPath.c_str(), PackFile::GetMountedCount());
+	}
+}
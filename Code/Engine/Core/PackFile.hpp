@@ -0,0 +1,89 @@
+/************************************************************************/
+/* File: PackFile.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Read-only archive of many asset files behind one index,
+/*				mapped once and resolved through by the File layer
+/************************************************************************/
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <shared_mutex>
+#include "Engine/Core/File.hpp"
+
+#define PACK_FILE_VERSION (1)
+
+struct PackEntry_t;
+
+enum PackCompression : uint32_t
+{
+	PACK_COMPRESSION_NONE,		// Read straight out of the mapping
+	PACK_COMPRESSION_ZLIB		// Inflated into a new buffer on every open
+};
+
+struct PackBuildStats_t
+{
+	int		fileCount = 0;
+	int		compressedCount = 0;
+	size_t	sourceBytes = 0;
+	size_t	packBytes = 0;
+};
+
+
+class PackFile
+{
+public:
+	//-----Public Methods-----
+
+	// Packs mounted later are searched first, so a patch pack can override the base one
+	static bool			Mount(const std::string& packPath);
+	static bool			Unmount(const std::string& packPath);
+	static void			UnmountAll();	// Any MappedFile opened out of a pack must be closed first
+	static int			GetMountedCount();
+
+	// When enabled a loose file on disk wins over the packed copy, so edited assets show up without rebuilding the pack
+	static void			SetLooseFileOverridesEnabled(bool enabled);
+	static bool			AreLooseFileOverridesEnabled();
+
+	// Data points into the pack's mapping unless out_isOwned is set, in which case the caller frees it
+	static bool			FindFile(const char* filepath, const char*& out_data, size_t& out_size, bool& out_isOwned);
+
+	// Packs every file under the directory, keyed by its path as the game would open it (i.e. starting with sourceDirectory)
+	static bool			Build(const std::string& sourceDirectory, const std::string& packPath, bool compress, PackBuildStats_t* out_stats = nullptr);
+
+	// Lower case with forward slashes, so "Data\Images\A.png" and "./data/images/a.png" are the same entry
+	static std::string	NormalizePath(const char* filepath);
+
+	static void			InitializeConsoleCommands();
+
+
+private:
+	//-----Private Methods-----
+
+	PackFile() {}
+	~PackFile() {}
+	PackFile(const PackFile& copy) = delete;
+
+	bool				Open(const std::string& packPath);
+	const PackEntry_t*	FindEntry(uint64_t pathHash, const std::string& normalizedPath) const;
+	bool				ReadEntry(const PackEntry_t& entry, const char*& out_data, size_t& out_size, bool& out_isOwned) const;
+
+
+private:
+	//-----Private Data-----
+
+	std::string			m_packPath;
+	MappedFile			m_file;
+
+	// Both point into m_file, entries are sorted by path hash
+	const PackEntry_t*	m_entries = nullptr;
+	uint32_t			m_entryCount = 0;
+	const char*			m_stringTable = nullptr;
+	size_t				m_stringTableSize = 0;
+
+	static std::vector<PackFile*>	s_mountedPacks;
+	static std::shared_mutex		s_mountLock;
+	static bool						s_looseFileOverridesEnabled;
+
+};
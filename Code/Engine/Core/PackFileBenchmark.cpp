@@ -0,0 +1,198 @@
+/************************************************************************/
+/* File: PackFileBenchmark.cpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Implementation of the PackFileBenchmark class
+/************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include "Engine/Core/File.hpp"
+#include "Engine/Core/PackFile.hpp"
+#include "Engine/Core/Time/Time.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/PackFileBenchmark.hpp"
+#include "Engine/Core/DeveloperConsole/Command.hpp"
+#include "Engine/Core/DeveloperConsole/DevConsole.hpp"
+
+// Console commands
+static void Command_PackFileBenchmark(Command& cmd);
+
+
+//-----------------------------------------------------------------------------------------------
+// Maps and pages in every file from disk, returning the performance counts it took
+//
+static uint64_t TimeLooseReads(const std::vector<std::string>& filepaths)
+{
+	uint64_t startHPC = GetPerformanceCounter();
+
+	for (int fileIndex = 0; fileIndex < (int)filepaths.size(); ++fileIndex)
+	{
+		MappedFile file;
+		if (file.OpenLooseFile(filepaths[fileIndex].c_str()))
+		{
+			file.Prefetch();
+		}
+	}
+
+	return GetPerformanceCounter() - startHPC;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Mounts the pack and pages in every file from it, returning the performance counts it took
+// Loose file overrides must be off, or this is just timing the loose files again
+//
+static uint64_t TimePackReads(const std::string& packPath, const std::vector<std::string>& filepaths)
+{
+	uint64_t startHPC = GetPerformanceCounter();
+
+	PackFile::Mount(packPath);
+
+	for (int fileIndex = 0; fileIndex < (int)filepaths.size(); ++fileIndex)
+	{
+		MappedFile file;
+		if (file.Open(filepaths[fileIndex].c_str()))
+		{
+			file.Prefetch();
+		}
+	}
+
+	PackFile::Unmount(packPath);
+
+	return GetPerformanceCounter() - startHPC;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of files that don't read back out of the pack exactly as they are on disk
+//
+static int CountMismatches(const std::string& packPath, const std::vector<std::string>& filepaths)
+{
+	int mismatchCount = 0;
+	PackFile::Mount(packPath);
+
+	for (int fileIndex = 0; fileIndex < (int)filepaths.size(); ++fileIndex)
+	{
+		MappedFile looseFile;
+		MappedFile packedFile;
+
+		bool matches = looseFile.OpenLooseFile(filepaths[fileIndex].c_str())
+			&& packedFile.Open(filepaths[fileIndex].c_str())
+			&& looseFile.GetSize() == packedFile.GetSize()
+			&& (looseFile.GetSize() == 0 || memcmp(looseFile.GetData(), packedFile.GetData(), looseFile.GetSize()) == 0);
+
+		if (!matches)
+		{
+			mismatchCount++;
+		}
+	}
+
+	PackFile::Unmount(packPath);
+	return mismatchCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Packs the directory with and without compression, then times reading every file loose and from each pack
+//
+PackFileBenchmarkResults_t PackFileBenchmark::Run(const std::string& directory, int passCount)
+{
+	PackFileBenchmarkResults_t results;
+
+	std::vector<std::string> filepaths;
+	GetFilesInDirectory(directory, filepaths, true);
+	results.fileCount = (int)filepaths.size();
+
+	if (results.fileCount == 0 || passCount <= 0)
+	{
+		return results;
+	}
+
+	// Next to the directory rather than in it, so they don't end up in each other
+	std::string packPath = directory + ".benchmark.pack";
+	std::string compressedPackPath = directory + ".benchmark_zlib.pack";
+
+	PackBuildStats_t stats;
+	bool built = PackFile::Build(directory, packPath, false, &stats);
+	results.looseBytes = stats.sourceBytes;
+	results.packBytes = stats.packBytes;
+
+	built = PackFile::Build(directory, compressedPackPath, true, &stats) && built;
+	results.compressedPackBytes = stats.packBytes;
+
+	if (built)
+	{
+		bool overridesEnabled = PackFile::AreLooseFileOverridesEnabled();
+		PackFile::SetLooseFileOverridesEnabled(false);
+
+		results.mismatchCount = CountMismatches(packPath, filepaths) + CountMismatches(compressedPackPath, filepaths);
+
+		uint64_t looseCounts = UINT64_MAX;
+		uint64_t packCounts = UINT64_MAX;
+		uint64_t compressedPackCounts = UINT64_MAX;
+
+		for (int passIndex = 0; passIndex < passCount; ++passIndex)
+		{
+			uint64_t passLooseCounts = TimeLooseReads(filepaths);
+			uint64_t passPackCounts = TimePackReads(packPath, filepaths);
+			uint64_t passCompressedPackCounts = TimePackReads(compressedPackPath, filepaths);
+
+			looseCounts = (passLooseCounts < looseCounts ? passLooseCounts : looseCounts);
+			packCounts = (passPackCounts < packCounts ? passPackCounts : packCounts);
+			compressedPackCounts = (passCompressedPackCounts < compressedPackCounts ? passCompressedPackCounts : compressedPackCounts);
+		}
+
+		PackFile::SetLooseFileOverridesEnabled(overridesEnabled);
+
+		results.looseSeconds = TimeSystem::PerformanceCountToSeconds(looseCounts);
+		results.packSeconds = TimeSystem::PerformanceCountToSeconds(packCounts);
+		results.compressedPackSeconds = TimeSystem::PerformanceCountToSeconds(compressedPackCounts);
+	}
+
+	remove(packPath.c_str());
+	remove(compressedPackPath.c_str());
+
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Registers the benchmark console command
+//
+void PackFileBenchmark::InitializeConsoleCommands()
+{
+	Command::Register("pack_benchmark", "Times reading every file under directory -d loose against from packs of it, best of -n passes", Command_PackFileBenchmark);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs the benchmark on the given directory and prints the results
+//
+static void Command_PackFileBenchmark(Command& cmd)
+{
+	std::string directory;
+	if (!cmd.GetParam("d", directory))
+	{
+		ConsoleErrorf("No directory specified, use -d <directory>");
+		return;
+	}
+
+	int passCount = 5;
+	cmd.GetParam("n", passCount, &passCount);
+
+	PackFileBenchmarkResults_t results = PackFileBenchmark::Run(directory, passCount);
+
+	if (results.fileCount == 0)
+	{
+		ConsoleErrorf("No files found under \"%s\"", directory.c_str());
+		return;
+	}
+
+	Rgba color = (results.mismatchCount == 0 ? Rgba::GREEN : Rgba::RED);
+
+	ConsolePrintf(color, "%s: %i files, %u bytes loose, %u packed, %u packed with compression, %i mismatched",
+		directory.c_str(), results.fileCount, (unsigned int)results.looseBytes, (unsigned int)results.packBytes, (unsigned int)results.compressedPackBytes, results.mismatchCount);
+	ConsolePrintf(color, "Read all: %.2fms loose, %.2fms packed (%.2fx), %.2fms packed with compression (%.2fx)",
+		results.looseSeconds * 1000.0, results.packSeconds * 1000.0, results.looseSeconds / results.packSeconds,
+		results.compressedPackSeconds * 1000.0, results.looseSeconds / results.compressedPackSeconds);
+}
@@ -0,0 +1,37 @@
+/************************************************************************/
+/* File: PackFileBenchmark.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Compares opening a directory's files loose against
+/*				opening them out of packs built from it
+/************************************************************************/
+#pragma once
+#include <string>
+
+struct PackFileBenchmarkResults_t
+{
+	int		fileCount = 0;
+	size_t	looseBytes = 0;
+	size_t	packBytes = 0;
+	size_t	compressedPackBytes = 0;
+
+	// Each is the time to read every file once, including the mount for the packs
+	double	looseSeconds = 0.0;
+	double	packSeconds = 0.0;
+	double	compressedPackSeconds = 0.0;
+
+	int		mismatchCount = 0;		// Files whose packed bytes differ from the loose file
+};
+
+
+class PackFileBenchmark
+{
+public:
+	//-----Public Methods-----
+
+	// Builds temporary packs next to the directory, and times the best of passCount passes of each
+	// After the first pass everything is in the OS file cache, so these are warm-start times - cold starts favor the packs more
+	static PackFileBenchmarkResults_t	Run(const std::string& directory, int passCount);
+	static void							InitializeConsoleCommands();
+
+};
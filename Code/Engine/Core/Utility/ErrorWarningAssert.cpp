@@ -56,7 +56,7 @@ void DebuggerPrintf( const char* messageFormat, ... )
 	messageLiteral[ MESSAGE_MAX_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
 	// Send it to the LogSystem so the logging thread does the printing
-	LogSystem::AddLog(LogMessage_t("DEBUG", messageLiteral));
+	LogSystem::AddLog("DEBUG", messageLiteral);
 }
 
 
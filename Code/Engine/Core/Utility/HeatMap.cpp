@@ -5,11 +5,42 @@
 /* Bugs: None
 /* Description: Implementation of the HeatMap class
 /************************************************************************/
+#include <float.h>
+#include <algorithm>
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
 #include "Engine/Core/Utility/HeatMap.hpp"
 #include "Engine/Core/Utility/StringUtils.hpp"
 #include "Engine/Core/Utility/ErrorWarningAssert.hpp"
 #include "Engine/Math/MathUtils.hpp"
 
+
+//-----------------------------------------------------------------------------------------------
+// Job for solving one of several heat maps at once
+//
+class HeatMapSolveJob : public Job
+{
+public:
+
+	HeatMapSolveJob(HeatMap* map, float maxDistance, const HeatMap* costs)
+		: m_map(map), m_maxDistance(maxDistance), m_costs(costs)
+	{
+		m_jobType = JOB_TYPE_HEATMAP_SOLVE;
+		m_jobFlags = WORKER_FLAGS_ALL_BUT_DISK;
+	}
+
+	virtual void Execute() override
+	{
+		m_map->SolveMapUpToDistance(m_maxDistance, m_costs);
+	}
+
+	HeatMap*		m_map = nullptr;
+	float			m_maxDistance = 0.f;
+	const HeatMap*	m_costs = nullptr;
+
+};
+
+
 //-----------------------------------------------------------------------------------------------
 // Constructor - makes the map of dimensions and initializes all cells to the initial heat value
 //
@@ -30,6 +61,8 @@ HeatMap::HeatMap(const HeatMap& copy)
 {
 	m_heatPerGridCell = copy.m_heatPerGridCell;
 	m_dimensions = copy.m_dimensions;
+	m_parentIndices = copy.m_parentIndices;
+	m_seedValues = copy.m_seedValues;
 	m_maxDistanceSolved = copy.m_maxDistanceSolved;
 
 	if (copy.m_costMap != nullptr)
@@ -40,7 +73,17 @@ HeatMap::HeatMap(const HeatMap& copy)
 
 
 //-----------------------------------------------------------------------------------------------
-// Sets all cells to have the given clear value
+// Destructor
+//
+HeatMap::~HeatMap()
+{
+	delete m_costMap;
+	m_costMap = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets all cells to have the given clear value, which also removes all seeds
 //
 void HeatMap::Clear(float clearValue)
 {
@@ -49,6 +92,9 @@ void HeatMap::Clear(float clearValue)
 	{
 		m_heatPerGridCell[i] = clearValue;
 	}
+
+	m_seedValues.clear();
+	m_parentIndices.clear();
 }
 
 
@@ -109,84 +155,394 @@ void HeatMap::Seed(float seedValue, const IntVector2& seedLocation)
 	{
 		int index = (seedLocation.y * m_dimensions.x) + seedLocation.x;
 		m_heatPerGridCell[index] = seedValue;
+
+		if (m_seedValues.size() == 0)
+		{
+			m_seedValues.resize(GetCellCount(), FLT_MAX);
+		}
+
+		m_seedValues[index] = seedValue;
 	}
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Solves this distance map up to a set distance
+// Removes the seed at the location, setting it back to the unsolved value
+// Call ResolveChangedCells() with the location afterwards to remove the heat that came from it
 //
-void HeatMap::SolveMapUpToDistance(float maxDist, const HeatMap* costs/*= nullptr*/)
+void HeatMap::Unseed(const IntVector2& seedLocation, float unsolvedValue)
 {
-	// No cost specified, so each step costs 1 by default
-	bool costsProvided = (costs != nullptr);
-	if (!costsProvided)
+	if (AreCoordsValid(seedLocation))
 	{
-		costs = new HeatMap(m_dimensions, 1.f);
+		int index = (seedLocation.y * m_dimensions.x) + seedLocation.x;
+		m_heatPerGridCell[index] = unsolvedValue;
+
+		if (m_seedValues.size() > 0)
+		{
+			m_seedValues[index] = FLT_MAX;
+		}
 	}
+}
+
 
-	// Keep iterating until we no longer notice a change in the map
-	bool valueChanged = true;
-	while (valueChanged)
+//-----------------------------------------------------------------------------------------------
+// Solves this distance map up to a set distance, visiting each cell once in order of distance
+//
+void HeatMap::SolveMapUpToDistance(float maxDistance, const HeatMap* costs/*= nullptr*/)
+{
+	int cellCount = (int)GetCellCount();
+
+	m_parentIndices.clear();
+	m_parentIndices.resize(cellCount, -1);
+
+	std::vector<int> sourceIndices;
+	for (int cellIndex = 0; cellIndex < cellCount; ++cellIndex)
 	{
-		valueChanged = false;
+		if (m_heatPerGridCell[cellIndex] < maxDistance)
+		{
+			sourceIndices.push_back(cellIndex);
+		}
+	}
+
+	SolveFromSources(sourceIndices, maxDistance, costs);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Resets every cell whose heat was derived through one of the changed cells, then solves again from the
+// edges of that region. Cells outside it already have valid distances, so they're only visited if
+// the change lowered them
+//
+void HeatMap::ResolveChangedCells(const std::vector<IntVector2>& changedCells, float maxDistance, float unsolvedValue, const HeatMap* costs /*= nullptr*/)
+{
+	int cellCount = (int)GetCellCount();
+
+	// Nothing to go off of without a previous solve
+	if ((int)m_parentIndices.size() != cellCount)
+	{
+		SolveMapUpToDistance(maxDistance, costs);
+		return;
+	}
 
-		// Iterate across the map
-		for (int xIndex = 0; xIndex < m_dimensions.x; xIndex++)
+	// 1 for cells being re-solved, 2 for cells already added as sources
+	std::vector<uint8_t> cellStates(cellCount, 0);
+	std::vector<int> regionIndices;
+
+	for (int changedIndex = 0; changedIndex < (int)changedCells.size(); ++changedIndex)
+	{
+		int cellIndex = GetIndex(changedCells[changedIndex].x, changedCells[changedIndex].y);
+
+		if (cellIndex >= 0 && cellStates[cellIndex] == 0)
 		{
-			for (int yIndex = 0; yIndex < m_dimensions.y; yIndex++)
+			cellStates[cellIndex] = 1;
+			regionIndices.push_back(cellIndex);
+		}
+	}
+
+	// Follow parent links down to everything that got its heat through the changed cells
+	int neighborIndices[4];
+	for (int regionIndex = 0; regionIndex < (int)regionIndices.size(); ++regionIndex)
+	{
+		int cellIndex = regionIndices[regionIndex];
+		int neighborCount = GetNeighborIndices(cellIndex, neighborIndices);
+
+		for (int neighborNumber = 0; neighborNumber < neighborCount; ++neighborNumber)
+		{
+			int neighborIndex = neighborIndices[neighborNumber];
+
+			if (cellStates[neighborIndex] == 0 && m_parentIndices[neighborIndex] == cellIndex)
 			{
-				int currIndex = GetIndex(xIndex, yIndex);
+				cellStates[neighborIndex] = 1;
+				regionIndices.push_back(neighborIndex);
+			}
+		}
+	}
 
-				// Update the current index by checking all 4 neighbors
-				int southIndex      = GetIndex(xIndex, yIndex - 1);
-				bool southChanged   = UpdateCurrFromNeighbor(currIndex, southIndex, maxDist, costs);
+	// Seeds go back to their seeded value, everything else starts over
+	bool hasSeeds = (m_seedValues.size() > 0);
+	for (int regionIndex = 0; regionIndex < (int)regionIndices.size(); ++regionIndex)
+	{
+		int cellIndex = regionIndices[regionIndex];
+		bool isSeed = (hasSeeds && m_seedValues[cellIndex] != FLT_MAX);
+
+		m_heatPerGridCell[cellIndex] = (isSeed ? m_seedValues[cellIndex] : unsolvedValue);
+		m_parentIndices[cellIndex] = -1;
+	}
 
-				int northIndex      = GetIndex(xIndex, yIndex + 1);
-				bool northChanged   = UpdateCurrFromNeighbor(currIndex, northIndex, maxDist, costs);
+	// Sources are the seeds in the region plus every solved cell bordering it
+	std::vector<int> sourceIndices;
+	for (int regionIndex = 0; regionIndex < (int)regionIndices.size(); ++regionIndex)
+	{
+		int cellIndex = regionIndices[regionIndex];
 
-				int westIndex       = GetIndex(xIndex - 1, yIndex);
-				bool westChanged    = UpdateCurrFromNeighbor(currIndex, westIndex, maxDist, costs);
+		if (m_heatPerGridCell[cellIndex] < maxDistance)
+		{
+			sourceIndices.push_back(cellIndex);
+		}
 
-				int eastIndex       = GetIndex(xIndex + 1, yIndex);
-				bool eastChanged    = UpdateCurrFromNeighbor(currIndex, eastIndex, maxDist, costs);
+		int neighborCount = GetNeighborIndices(cellIndex, neighborIndices);
+		for (int neighborNumber = 0; neighborNumber < neighborCount; ++neighborNumber)
+		{
+			int neighborIndex = neighborIndices[neighborNumber];
 
-				// Update if we changed or not
-				valueChanged = valueChanged || northChanged || southChanged || eastChanged || westChanged;
+			if (cellStates[neighborIndex] == 0 && m_heatPerGridCell[neighborIndex] < maxDistance)
+			{
+				cellStates[neighborIndex] = 2;
+				sourceIndices.push_back(neighborIndex);
 			}
 		}
 	}
 
-	if (!costsProvided)
+	SolveFromSources(sourceIndices, maxDistance, costs);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Solves each map on its own worker thread, returning once they're all done
+// The maps must be different, but can share the cost map since it's only read
+//
+void HeatMap::SolveMapsUpToDistance(const std::vector<HeatMap*>& maps, float maxDistance, const HeatMap* costs /*= nullptr*/)
+{
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	bool useJobs = (jobSystem != nullptr && jobSystem->GetWorkerThreadCount(WORKER_FLAGS_ALL_BUT_DISK) > 0 && maps.size() > 1);
+
+	if (!useJobs)
+	{
+		for (int mapIndex = 0; mapIndex < (int)maps.size(); ++mapIndex)
+		{
+			maps[mapIndex]->SolveMapUpToDistance(maxDistance, costs);
+		}
+
+		return;
+	}
+
+	for (int mapIndex = 0; mapIndex < (int)maps.size(); ++mapIndex)
 	{
-		delete costs;
+		QueueJob(new HeatMapSolveJob(maps[mapIndex], maxDistance, costs));
 	}
+
+	jobSystem->BlockUntilAllJobsOfTypeAreFinalized(JOB_TYPE_HEATMAP_SOLVE);
 }
 
 
-//----------------------------------------------------------------------------------
-// Updates the distance value at currIndex based on the distance value of neighborIndex
+//-----------------------------------------------------------------------------------------------
+// Runs Dijkstra's algorithm from the given cells, each starting at its current heat
+// Uses Dial's bucket queue when every cost is positive and the costs don't span too many buckets,
+// otherwise a binary heap
+//
+void HeatMap::SolveFromSources(std::vector<int>& sourceIndices, float maxDistance, const HeatMap* costs)
+{
+	m_maxDistanceSolved = maxDistance;
+
+	if (sourceIndices.size() == 0)
+	{
+		return;
+	}
+
+	if (costs != nullptr)
+	{
+		GUARANTEE_OR_DIE(costs->m_dimensions == m_dimensions, "Error: HeatMap solve given a cost map of different dimensions");
+	}
+
+	// Lowest first, so sources can be fed into the buckets as the solve reaches them
+	std::sort(sourceIndices.begin(), sourceIndices.end(), [this](int a, int b) { return m_heatPerGridCell[a] < m_heatPerGridCell[b]; });
+
+	float minCost = 1.f;
+	float maxCost = 1.f;
+
+	if (costs != nullptr)
+	{
+		minCost = FLT_MAX;
+		maxCost = 0.f;
+
+		for (int cellIndex = 0; cellIndex < (int)costs->m_heatPerGridCell.size(); ++cellIndex)
+		{
+			minCost = MinFloat(minCost, costs->m_heatPerGridCell[cellIndex]);
+			maxCost = MaxFloat(maxCost, costs->m_heatPerGridCell[cellIndex]);
+		}
+	}
+
+	// Steps that cost more than the whole solved range never happen, so they don't need buckets
+	double distanceRange = (double)maxDistance - (double)m_heatPerGridCell[sourceIndices[0]];
+	double largestStep = (maxCost < distanceRange ? (double)maxCost : distanceRange);
+	double bucketCount = (minCost > 0.f ? (largestStep / (double)minCost) + 2.0 : DBL_MAX);
+
+	if (bucketCount <= (double)MAX_BUCKET_COUNT)
+	{
+		SolveWithBuckets(sourceIndices, maxDistance, costs, minCost, (int)bucketCount);
+	}
+	else
+	{
+		SolveWithHeap(sourceIndices, maxDistance, costs);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Dial's algorithm - with buckets as wide as the cheapest step, a cell can only lower cells in later
+// buckets, so everything in a bucket is final by the time the bucket is reached and order within it
+// doesn't matter. Buckets are a ring, since no step reaches further ahead than the ring is long
 //
-bool HeatMap::UpdateCurrFromNeighbor(int currIndex, int neighborIndex, float maxDistance, const HeatMap* costs)
+void HeatMap::SolveWithBuckets(const std::vector<int>& sourceIndices, float maxDistance, const HeatMap* costs, float bucketWidth, int bucketCount)
 {
-	// Bad index, just return false
-	if (neighborIndex == -1) { return false; }
+	float baseDistance = m_heatPerGridCell[sourceIndices[0]];
+	float oneOverBucketWidth = 1.f / bucketWidth;
+
+	std::vector<std::vector<int>> buckets(bucketCount);
+	std::vector<uint8_t> isCellDone(GetCellCount(), 0);
+
+	int currentBucket = 0;
+	int nextSourceIndex = 0;
+	int queuedCount = 0;
+	int neighborIndices[4];
+
+	while (queuedCount > 0 || nextSourceIndex < (int)sourceIndices.size())
+	{
+		// Skip over empty stretches straight to the next source
+		if (queuedCount == 0)
+		{
+			int sourceBucket = (int)((m_heatPerGridCell[sourceIndices[nextSourceIndex]] - baseDistance) * oneOverBucketWidth);
+			currentBucket = MaxInt(currentBucket, sourceBucket);
+		}
+
+		std::vector<int>& bucket = buckets[currentBucket % bucketCount];
+
+		// Sources that belong in this bucket - ones lowered by the solve already are queued further ahead
+		while (nextSourceIndex < (int)sourceIndices.size())
+		{
+			int sourceIndex = sourceIndices[nextSourceIndex];
+			int sourceBucket = (int)((m_heatPerGridCell[sourceIndex] - baseDistance) * oneOverBucketWidth);
+
+			if (sourceBucket > currentBucket)
+			{
+				break;
+			}
+
+			bucket.push_back(sourceIndex);
+			queuedCount++;
+			nextSourceIndex++;
+		}
 
-	float currDistance = m_heatPerGridCell[currIndex];
-	float newDistance = m_heatPerGridCell[neighborIndex] + costs->GetHeat(currIndex);
+		// Indexed since rounding can occasionally land a step back in this same bucket
+		for (int entryIndex = 0; entryIndex < (int)bucket.size(); ++entryIndex)
+		{
+			int cellIndex = bucket[entryIndex];
+			queuedCount--;
+
+			if (isCellDone[cellIndex] != 0)
+			{
+				continue;
+			}
 
-	bool isWithinMaxDist = (newDistance < maxDistance);
+			isCellDone[cellIndex] = 1;
 
-	if (newDistance < currDistance && isWithinMaxDist)
+			int neighborCount = GetNeighborIndices(cellIndex, neighborIndices);
+			for (int neighborNumber = 0; neighborNumber < neighborCount; ++neighborNumber)
+			{
+				int neighborIndex = neighborIndices[neighborNumber];
+
+				if (isCellDone[neighborIndex] == 0 && RelaxNeighbor(cellIndex, neighborIndex, maxDistance, costs))
+				{
+					int neighborBucket = (int)((m_heatPerGridCell[neighborIndex] - baseDistance) * oneOverBucketWidth);
+					buckets[MaxInt(neighborBucket, currentBucket) % bucketCount].push_back(neighborIndex);
+					queuedCount++;
+				}
+			}
+		}
+
+		bucket.clear();
+		currentBucket++;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Plain Dijkstra with a binary heap, for when costs are zero somewhere or vary too much for buckets
+// Cells are pushed again when lowered, and the stale entries are skipped when popped
+//
+void HeatMap::SolveWithHeap(const std::vector<int>& sourceIndices, float maxDistance, const HeatMap* costs)
+{
+	typedef std::pair<float, int> HeapEntry;
+	std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> openCells;
+
+	for (int sourceNumber = 0; sourceNumber < (int)sourceIndices.size(); ++sourceNumber)
 	{
-		m_heatPerGridCell[currIndex] = newDistance;
+		int sourceIndex = sourceIndices[sourceNumber];
+		openCells.push(HeapEntry(m_heatPerGridCell[sourceIndex], sourceIndex));
+	}
+
+	int neighborIndices[4];
+	while (!openCells.empty())
+	{
+		HeapEntry entry = openCells.top();
+		openCells.pop();
+
+		int cellIndex = entry.second;
+		if (entry.first > m_heatPerGridCell[cellIndex])
+		{
+			continue;
+		}
+
+		int neighborCount = GetNeighborIndices(cellIndex, neighborIndices);
+		for (int neighborNumber = 0; neighborNumber < neighborCount; ++neighborNumber)
+		{
+			int neighborIndex = neighborIndices[neighborNumber];
+
+			if (RelaxNeighbor(cellIndex, neighborIndex, maxDistance, costs))
+			{
+				openCells.push(HeapEntry(m_heatPerGridCell[neighborIndex], neighborIndex));
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------
+// Lowers the neighbor's distance if stepping to it from the current cell is shorter and within the max distance
+// Returns true if it was lowered
+//
+bool HeatMap::RelaxNeighbor(int currIndex, int neighborIndex, float maxDistance, const HeatMap* costs)
+{
+	float newDistance = m_heatPerGridCell[currIndex] + GetCost(neighborIndex, costs);
+
+	if (newDistance < m_heatPerGridCell[neighborIndex] && newDistance < maxDistance)
+	{
+		m_heatPerGridCell[neighborIndex] = newDistance;
+		m_parentIndices[neighborIndex] = currIndex;
 		return true;
-	} 
+	}
 
 	return false;
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Writes the indices of the cell's in-bounds neighbors, east, west, north, then south, returning how many there are
+//
+int HeatMap::GetNeighborIndices(int index, int* out_neighborIndices) const
+{
+	int x = index % m_dimensions.x;
+	int y = index / m_dimensions.x;
+	int neighborCount = 0;
+
+	if (x + 1 < m_dimensions.x)	{ out_neighborIndices[neighborCount++] = index + 1; }
+	if (x > 0)					{ out_neighborIndices[neighborCount++] = index - 1; }
+	if (y + 1 < m_dimensions.y)	{ out_neighborIndices[neighborCount++] = index + m_dimensions.x; }
+	if (y > 0)					{ out_neighborIndices[neighborCount++] = index - m_dimensions.x; }
+
+	return neighborCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the cost of stepping into the cell, 1 if there's no cost map
+//
+float HeatMap::GetCost(int index, const HeatMap* costs) const
+{
+	return (costs != nullptr ? costs->m_heatPerGridCell[index] : 1.f);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Returns the float value at cellCoords
 //
@@ -270,6 +626,40 @@ void HeatMap::GetGreedyShortestPath(const IntVector2& pathStartCoords, const Int
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Fills the field with the step each cell should take to go downhill, toward the lowest neighbor that's
+// lower than it, or (0,0) at seeds and cells with nowhere lower to go
+// One pass for the whole map, so any number of agents can path from it without a walk each.
+// Ties go east, west, north, then south so the field doesn't change between calls
+//
+void HeatMap::GetFlowField(std::vector<IntVector2>& out_flowField) const
+{
+	int cellCount = (int)GetCellCount();
+	out_flowField.resize(cellCount);
+
+	int neighborIndices[4];
+	for (int cellIndex = 0; cellIndex < cellCount; ++cellIndex)
+	{
+		float lowestHeat = m_heatPerGridCell[cellIndex];
+		int lowestIndex = cellIndex;
+
+		int neighborCount = GetNeighborIndices(cellIndex, neighborIndices);
+		for (int neighborNumber = 0; neighborNumber < neighborCount; ++neighborNumber)
+		{
+			int neighborIndex = neighborIndices[neighborNumber];
+
+			if (m_heatPerGridCell[neighborIndex] < lowestHeat)
+			{
+				lowestHeat = m_heatPerGridCell[neighborIndex];
+				lowestIndex = neighborIndex;
+			}
+		}
+
+		out_flowField[cellIndex] = GetCoordsForIndex(lowestIndex) - GetCoordsForIndex(cellIndex);
+	}
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Returns the coords of the min neighbor to this tile
 //
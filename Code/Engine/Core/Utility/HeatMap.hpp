@@ -17,6 +17,7 @@ public:
 
 	HeatMap(const IntVector2& dimensions, float initialHeatValuePerCell);
 	HeatMap(const HeatMap& copy);
+	~HeatMap();
 
 	// Mutators
 	void Clear(float clearValue);
@@ -25,8 +26,20 @@ public:
 	void AddHeat(const IntVector2& cellCoords, float addAmount);
 	void Seed(float seedValue, const IntVector2& seedLocation);
 	void Seed(float seedValue, const std::vector<IntVector2>& seedCoords);
+	void Unseed(const IntVector2& seedLocation, float unsolvedValue);
+
+	// Every cell below maxDistance is a source at its current heat, and stepping into a cell adds its cost (1 if no
+	// costs are given), so seeds should be low and everything else cleared high. Costs must not be negative
 	void SolveMapUpToDistance(float maxDistance, const HeatMap* costs = nullptr);
 
+	// Re-solves only the cells that depended on the changed ones, after seeding, unseeding, or changing costs at
+	// them since the last solve. Cells marked with Seed() keep their value, other changed cells are re-derived
+	// Max distance and costs should match the last solve, and unsolvedValue should be what the map was cleared to
+	void ResolveChangedCells(const std::vector<IntVector2>& changedCells, float maxDistance, float unsolvedValue, const HeatMap* costs = nullptr);
+
+	// Solves several maps at once on the JobSystem, for example one per target that share a cost map
+	static void SolveMapsUpToDistance(const std::vector<HeatMap*>& maps, float maxDistance, const HeatMap* costs = nullptr);
+
 	// Accessors
 	float GetHeat(const IntVector2& cellCoords) const;
 	float GetHeat(int index) const;
@@ -36,6 +49,7 @@ public:
 	int			GetIndex(int x, int y) const;
 	IntVector2  GetCoordsForIndex(unsigned int index) const;
 	void		GetGreedyShortestPath(const IntVector2& pathStartCoords, const IntVector2& pathEndCoords, std::vector<IntVector2>& path) const;
+	void		GetFlowField(std::vector<IntVector2>& out_flowField) const;
 	IntVector2	GetMinNeighborCoords(const IntVector2& currCoords) const;
 	bool		AreCoordsValid(const IntVector2& coords) const;
 
@@ -43,7 +57,13 @@ public:
 private:
 	//-----Private Methods-----
 
-	bool UpdateCurrFromNeighbor(int currIndex, int neighborIndex, float maxDistance, const HeatMap* costs);
+	void	SolveFromSources(std::vector<int>& sourceIndices, float maxDistance, const HeatMap* costs);
+	void	SolveWithBuckets(const std::vector<int>& sourceIndices, float maxDistance, const HeatMap* costs, float bucketWidth, int bucketCount);
+	void	SolveWithHeap(const std::vector<int>& sourceIndices, float maxDistance, const HeatMap* costs);
+
+	bool	RelaxNeighbor(int currIndex, int neighborIndex, float maxDistance, const HeatMap* costs);
+	int		GetNeighborIndices(int index, int* out_neighborIndices) const;
+	float	GetCost(int index, const HeatMap* costs) const;
 
 
 private:
@@ -52,6 +72,14 @@ private:
 	std::vector<float> m_heatPerGridCell;	// Ordered from bottom-left, across rows then up
 	IntVector2 m_dimensions;				// Width x height of the grid
 
-	int m_maxDistanceSolved;				// Set when the HeatMap is solved up to a certain distance from seeds
-	HeatMap* m_costMap;						// Costs associated with a solve
-};
\ No newline at end of file
+	std::vector<int>	m_parentIndices;	// Neighbor each cell's heat came from on the last solve, -1 for sources
+	std::vector<float>	m_seedValues;		// Set by Seed(), so re-solves can put seeds back - FLT_MAX where there's no seed
+
+	float m_maxDistanceSolved = 0.f;		// Set when the HeatMap is solved up to a certain distance from seeds
+	HeatMap* m_costMap = nullptr;			// Costs associated with a solve
+
+	// Dial's algorithm keeps one bucket per bucket-width of distance, in a ring covering the largest cost
+	// Cost maps that would need more buckets than this, or that have free cells, use a binary heap instead
+	static constexpr int MAX_BUCKET_COUNT = 4096;
+
+};
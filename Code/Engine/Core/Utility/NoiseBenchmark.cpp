@@ -0,0 +1,197 @@
+/************************************************************************/
+/* File: NoiseBenchmark.cpp
+/* Author: Andrew Chase
+/* Date: June 14th, 2019
+/* Description: Implementation of the NoiseBenchmark class
+/************************************************************************/
+#include <string.h>
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time/Time.hpp"
+#include "Engine/Core/Utility/SmoothNoise.hpp"
+#include "Engine/Core/Utility/NoiseBenchmark.hpp"
+#include "Engine/Core/DeveloperConsole/Command.hpp"
+#include "Engine/Core/DeveloperConsole/DevConsole.hpp"
+
+// Console commands
+static void Command_NoiseBenchmark(Command& cmd);
+
+// Single-sample version of each grid function, so the scalar loop can call any of them the same way
+typedef float (*NoiseSampleFunction)(float posX, float posY, float posZ, const NoiseGrid_t& grid);
+
+
+//-----------------------------------------------------------------------------------------------
+// Wrappers putting the single-sample functions behind one signature
+//
+static float Sample2dFractalNoise(float posX, float posY, float posZ, const NoiseGrid_t& grid)
+{
+	UNUSED(posZ);
+	return Compute2dFractalNoise(posX, posY, grid.scale, grid.numOctaves, grid.octavePersistence, grid.octaveScale, grid.renormalize, grid.seed);
+}
+
+static float Sample3dFractalNoise(float posX, float posY, float posZ, const NoiseGrid_t& grid)
+{
+	return Compute3dFractalNoise(posX, posY, posZ, grid.scale, grid.numOctaves, grid.octavePersistence, grid.octaveScale, grid.renormalize, grid.seed);
+}
+
+static float Sample2dPerlinNoise(float posX, float posY, float posZ, const NoiseGrid_t& grid)
+{
+	UNUSED(posZ);
+	return Compute2dPerlinNoise(posX, posY, grid.scale, grid.numOctaves, grid.octavePersistence, grid.octaveScale, grid.renormalize, grid.seed);
+}
+
+static float Sample3dPerlinNoise(float posX, float posY, float posZ, const NoiseGrid_t& grid)
+{
+	return Compute3dPerlinNoise(posX, posY, posZ, grid.scale, grid.numOctaves, grid.octavePersistence, grid.octaveScale, grid.renormalize, grid.seed);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Fills the grid with nested loops over the single-sample function, the way callers did before the grid functions
+//
+static void FillGridScalar(NoiseSampleFunction sampleFunction, const NoiseGrid_t& grid, float* out_values)
+{
+	for (int indexZ = 0; indexZ < grid.countZ; ++indexZ)
+	{
+		float posZ = grid.originZ + ((float)indexZ * grid.stepZ);
+
+		for (int indexY = 0; indexY < grid.countY; ++indexY)
+		{
+			float posY = grid.originY + ((float)indexY * grid.stepY);
+			float* rowValues = out_values + (grid.countX * (indexY + grid.countY * indexZ));
+
+			for (int indexX = 0; indexX < grid.countX; ++indexX)
+			{
+				float posX = grid.originX + ((float)indexX * grid.stepX);
+				rowValues[indexX] = sampleFunction(posX, posY, posZ, grid);
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of samples whose bits differ between the two arrays
+//
+static int CountMismatches(const std::vector<float>& expected, const std::vector<float>& actual)
+{
+	int mismatchCount = 0;
+
+	for (int sampleIndex = 0; sampleIndex < (int)expected.size(); ++sampleIndex)
+	{
+		if (memcmp(&expected[sampleIndex], &actual[sampleIndex], sizeof(float)) != 0)
+		{
+			mismatchCount++;
+		}
+	}
+
+	return mismatchCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Times one noise function filling the grid each of the three ways
+//
+static NoiseBenchmarkResult_t RunFunction(const char* name, NoiseSampleFunction sampleFunction, NoiseGridFunction gridFunction, const NoiseGrid_t& grid)
+{
+	int sampleCount = grid.countX * grid.countY * grid.countZ;
+
+	std::vector<float> scalarValues(sampleCount);
+	std::vector<float> gridValues(sampleCount);
+	std::vector<float> jobValues(sampleCount);
+
+	uint64_t startHPC = GetPerformanceCounter();
+	FillGridScalar(sampleFunction, grid, scalarValues.data());
+	uint64_t scalarCounts = GetPerformanceCounter() - startHPC;
+
+	startHPC = GetPerformanceCounter();
+	gridFunction(grid, gridValues.data(), 0, -1);
+	uint64_t gridCounts = GetPerformanceCounter() - startHPC;
+
+	startHPC = GetPerformanceCounter();
+	ComputeNoiseGridInJobs(gridFunction, grid, jobValues.data());
+	uint64_t jobCounts = GetPerformanceCounter() - startHPC;
+
+	NoiseBenchmarkResult_t result;
+	result.name = name;
+	result.scalarSamplesPerSecond = (double)sampleCount / TimeSystem::PerformanceCountToSeconds(scalarCounts);
+	result.gridSamplesPerSecond = (double)sampleCount / TimeSystem::PerformanceCountToSeconds(gridCounts);
+	result.jobSamplesPerSecond = (double)sampleCount / TimeSystem::PerformanceCountToSeconds(jobCounts);
+	result.mismatchCount = CountMismatches(scalarValues, gridValues) + CountMismatches(scalarValues, jobValues);
+
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs each grid function against its single-sample version over a grid with a non-integer origin and step,
+// so samples land all over their noise cells and cross negative coordinates
+//
+std::vector<NoiseBenchmarkResult_t> NoiseBenchmark::Run(int gridSize, unsigned int numOctaves)
+{
+	std::vector<NoiseBenchmarkResult_t> results;
+
+	if (gridSize <= 0)
+	{
+		return results;
+	}
+
+	NoiseGrid_t grid;
+	grid.originX = -0.37f * (float)gridSize;
+	grid.originY = -0.51f * (float)gridSize;
+	grid.originZ = 3.3f;
+	grid.stepX = 0.73f;
+	grid.stepY = 0.91f;
+	grid.stepZ = 1.17f;
+	grid.countX = gridSize;
+	grid.countY = gridSize;
+	grid.scale = 23.f;
+	grid.numOctaves = numOctaves;
+	grid.seed = 7;
+
+	results.push_back(RunFunction("2D fractal", Sample2dFractalNoise, Compute2dFractalNoiseGrid, grid));
+	results.push_back(RunFunction("2D Perlin", Sample2dPerlinNoise, Compute2dPerlinNoiseGrid, grid));
+
+	grid.countZ = MaxInt(gridSize / 8, 1);
+
+	results.push_back(RunFunction("3D fractal", Sample3dFractalNoise, Compute3dFractalNoiseGrid, grid));
+	results.push_back(RunFunction("3D Perlin", Sample3dPerlinNoise, Compute3dPerlinNoiseGrid, grid));
+
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Registers the benchmark console command
+//
+void NoiseBenchmark::InitializeConsoleCommands()
+{
+	Command::Register("noise_benchmark", "Compares noise grid functions against per-sample calls, -n grid size -o octaves", Command_NoiseBenchmark);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs the benchmark and prints a line per noise function
+//
+static void Command_NoiseBenchmark(Command& cmd)
+{
+	int gridSize = 512;
+	cmd.GetParam("n", gridSize, &gridSize);
+
+	int octaveCount = 4;
+	cmd.GetParam("o", octaveCount, &octaveCount);
+
+	std::vector<NoiseBenchmarkResult_t> results = NoiseBenchmark::Run(gridSize, (unsigned int)MaxInt(octaveCount, 1));
+
+	for (int resultIndex = 0; resultIndex < (int)results.size(); ++resultIndex)
+	{
+		const NoiseBenchmarkResult_t& result = results[resultIndex];
+		Rgba color = (result.mismatchCount == 0 ? Rgba::GREEN : Rgba::RED);
+
+		ConsolePrintf(color, "%s: %.2fM samples/sec scalar, %.2fM grid (%.2fx), %.2fM in jobs (%.2fx), %i mismatched",
+			result.name.c_str(), result.scalarSamplesPerSecond * 1.0e-6,
+			result.gridSamplesPerSecond * 1.0e-6, result.gridSamplesPerSecond / result.scalarSamplesPerSecond,
+			result.jobSamplesPerSecond * 1.0e-6, result.jobSamplesPerSecond / result.scalarSamplesPerSecond,
+			result.mismatchCount);
+	}
+}
@@ -0,0 +1,31 @@
+/************************************************************************/
+/* File: NoiseBenchmark.hpp
+/* Author: Andrew Chase
+/* Date: June 14th, 2019
+/* Description: Compares filling noise grids one sample at a time against
+/*				the batch grid functions, single threaded and in jobs
+/************************************************************************/
+#pragma once
+#include <vector>
+#include <string>
+
+struct NoiseBenchmarkResult_t
+{
+	std::string	name;
+	double		scalarSamplesPerSecond = 0.0;
+	double		gridSamplesPerSecond = 0.0;
+	double		jobSamplesPerSecond = 0.0;
+	int			mismatchCount = 0;				// Samples where either batch path's bits differ from the scalar result
+};
+
+
+class NoiseBenchmark
+{
+public:
+	//-----Public Methods-----
+
+	// 2D functions fill gridSize x gridSize samples, 3D functions gridSize x gridSize x (gridSize / 8)
+	static std::vector<NoiseBenchmarkResult_t>	Run(int gridSize, unsigned int numOctaves);
+	static void									InitializeConsoleCommands();
+
+};
@@ -60,6 +60,21 @@ float Get2dNoiseNegOneToOne( int indexX, int indexY, unsigned int seed=0 );
 float Get3dNoiseNegOneToOne( int indexX, int indexY, int indexZ, unsigned int seed=0 );
 float Get4dNoiseNegOneToOne( int indexX, int indexY, int indexZ, int indexT, unsigned int seed=0 );
 
+//-----------------------------------------------------------------------------------------------
+// Four-lane SSE2 versions, for filling grids of samples at once.  Each lane gets exactly the
+//	same bits as the scalar function given the same index and seed.
+//
+#if !defined(ENGINE_DISABLE_SIMD) && (defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define RAW_NOISE_USE_SSE2
+#include <emmintrin.h>
+
+__m128i Get1dNoiseUint_SSE2( __m128i indices, unsigned int seed=0 );
+__m128i Get2dNoiseUint_SSE2( __m128i indicesX, __m128i indicesY, unsigned int seed=0 );
+__m128i Get3dNoiseUint_SSE2( __m128i indicesX, __m128i indicesY, __m128i indicesZ, unsigned int seed=0 );
+
+__m128	GetNoiseZeroToOne_SSE2( __m128i noise );	// Maps four results of the above the same way Get*dNoiseZeroToOne() does
+#endif
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // Simple functions inlined below
@@ -157,3 +172,73 @@ inline float Get4dNoiseNegOneToOne( int indexX, int indexY, int indexZ, int inde
 }
 
 
+#ifdef RAW_NOISE_USE_SSE2
+//-----------------------------------------------------------------------------------------------
+// SSE2 has no 32-bit low multiply, so the even and odd lanes are done as 64-bit multiplies
+//	and the low halves are put back together
+//
+inline __m128i MultiplyUints_SSE2( __m128i a, __m128i b )
+{
+	__m128i productsEven = _mm_mul_epu32( a, b );
+	__m128i productsOdd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+	return _mm_unpacklo_epi32( _mm_shuffle_epi32( productsEven, _MM_SHUFFLE( 0, 0, 2, 0 ) ), _mm_shuffle_epi32( productsOdd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Same steps as Get1dNoiseUint(), inlined here since grid functions call it per corner per octave
+//
+inline __m128i Get1dNoiseUint_SSE2( __m128i indices, unsigned int seed )
+{
+	const __m128i BIT_NOISE1 = _mm_set1_epi32( (int) 0xD2A80A23 );
+	const __m128i BIT_NOISE2 = _mm_set1_epi32( (int) 0xA884F197 );
+	const __m128i BIT_NOISE3 = _mm_set1_epi32( (int) 0x1B56C4E9 );
+
+	__m128i mangledBits = MultiplyUints_SSE2( indices, BIT_NOISE1 );
+	mangledBits = _mm_add_epi32( mangledBits, _mm_set1_epi32( (int) seed ) );
+	mangledBits = _mm_xor_si128( mangledBits, _mm_srli_epi32( mangledBits, 7 ) );
+	mangledBits = _mm_add_epi32( mangledBits, BIT_NOISE2 );
+	mangledBits = _mm_xor_si128( mangledBits, _mm_srli_epi32( mangledBits, 8 ) );
+	mangledBits = MultiplyUints_SSE2( mangledBits, BIT_NOISE3 );
+	mangledBits = _mm_xor_si128( mangledBits, _mm_srli_epi32( mangledBits, 11 ) );
+	return mangledBits;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline __m128i Get2dNoiseUint_SSE2( __m128i indicesX, __m128i indicesY, unsigned int seed )
+{
+	const __m128i PRIME_NUMBER = _mm_set1_epi32( 198491317 );
+	return Get1dNoiseUint_SSE2( _mm_add_epi32( indicesX, MultiplyUints_SSE2( PRIME_NUMBER, indicesY ) ), seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline __m128i Get3dNoiseUint_SSE2( __m128i indicesX, __m128i indicesY, __m128i indicesZ, unsigned int seed )
+{
+	const __m128i PRIME1 = _mm_set1_epi32( 198491317 );
+	const __m128i PRIME2 = _mm_set1_epi32( 6542989 );
+	__m128i combinedIndices = _mm_add_epi32( indicesX, MultiplyUints_SSE2( PRIME1, indicesY ) );
+	return Get1dNoiseUint_SSE2( _mm_add_epi32( combinedIndices, MultiplyUints_SSE2( PRIME2, indicesZ ) ), seed );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Done in doubles like the scalar version so the rounding matches; the bias trick converts
+//	unsigned to double exactly, since SSE2 only converts signed ints
+//
+inline __m128 GetNoiseZeroToOne_SSE2( __m128i noise )
+{
+	const __m128d ONE_OVER_MAX_UINT = _mm_set1_pd( 1.0 / (double) 0xFFFFFFFF );
+	const __m128d SIGN_BIAS = _mm_set1_pd( 2147483648.0 );
+
+	__m128i signedNoise = _mm_xor_si128( noise, _mm_set1_epi32( (int) 0x80000000 ) );
+	__m128d noiseLow = _mm_add_pd( _mm_cvtepi32_pd( signedNoise ), SIGN_BIAS );
+	__m128d noiseHigh = _mm_add_pd( _mm_cvtepi32_pd( _mm_shuffle_epi32( signedNoise, _MM_SHUFFLE( 3, 2, 3, 2 ) ) ), SIGN_BIAS );
+
+	__m128 valuesLow = _mm_cvtpd_ps( _mm_mul_pd( ONE_OVER_MAX_UINT, noiseLow ) );
+	__m128 valuesHigh = _mm_cvtpd_ps( _mm_mul_pd( ONE_OVER_MAX_UINT, noiseHigh ) );
+	return _mm_movelh_ps( valuesLow, valuesHigh );
+}
+#endif
+
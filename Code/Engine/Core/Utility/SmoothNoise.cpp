@@ -3,6 +3,9 @@
 //
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/Utility/RawNoise.hpp"
+#include "Engine/Core/Utility/SmoothNoise.hpp"
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Math/Vector4.hpp"
@@ -742,3 +745,597 @@ float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, floa
 	return totalNoise;
 }
 
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Grid (batch) noise
+//
+// The SSE2 paths below repeat the single-sample functions' arithmetic operation for operation,
+//	in the same order, so every lane rounds exactly like the scalar code and results match bit
+//	for bit.  Gradient table lookups are replaced by bit tricks that pick the same constants.
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns one past the last row to write, given a range that may use -1 for "to the end"
+//
+static int GetGridEndRow( const NoiseGrid_t& grid, int firstRow, int rowCount )
+{
+	int totalRows = grid.countY * grid.countZ;
+
+	if( rowCount < 0 || firstRow + rowCount > totalRows )
+		return totalRows;
+
+	return firstRow + rowCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Positions of a sample along each axis, done the same way by the scalar and SSE2 paths
+//
+static inline float GetGridPosition( float origin, float step, int index )
+{
+	return origin + ( (float) index * step );
+}
+
+
+#ifdef RAW_NOISE_USE_SSE2
+//-----------------------------------------------------------------------------------------------
+static inline __m128 GetGridPositions_SSE2( float origin, float step, int firstIndex )
+{
+	__m128 indices = _mm_cvtepi32_ps( _mm_add_epi32( _mm_set1_epi32( firstIndex ), _mm_set_epi32( 3, 2, 1, 0 ) ) );
+	return _mm_add_ps( _mm_set1_ps( origin ), _mm_mul_ps( indices, _mm_set1_ps( step ) ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// floorf() for four values, valid in the same range as the (int) casts that follow it
+//
+static inline __m128 Floor_SSE2( __m128 values )
+{
+	__m128 truncated = _mm_cvtepi32_ps( _mm_cvttps_epi32( values ) );
+	__m128 roundedUp = _mm_and_ps( _mm_cmpgt_ps( truncated, values ), _mm_set1_ps( 1.f ) );
+	return _mm_sub_ps( truncated, roundedUp );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Same as SmoothStep3(), i.e. ((1 - t) * t^2) + (t * (1 - (1 - t)^2))
+//
+static inline __m128 SmoothStep3_SSE2( __m128 t )
+{
+	const __m128 ONE = _mm_set1_ps( 1.f );
+
+	__m128 flipped = _mm_sub_ps( ONE, t );
+	__m128 smoothStart = _mm_mul_ps( t, t );
+	__m128 smoothStop = _mm_sub_ps( ONE, _mm_mul_ps( flipped, flipped ) );
+	return _mm_add_ps( _mm_mul_ps( flipped, smoothStart ), _mm_mul_ps( t, smoothStop ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a * weightA + b * weightB, the blend every noise function is built from
+//
+static inline __m128 Blend_SSE2( __m128 weightA, __m128 a, __m128 weightB, __m128 b )
+{
+	return _mm_add_ps( _mm_mul_ps( weightA, a ), _mm_mul_ps( weightB, b ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Same final mapping as the single-sample functions
+//
+static inline __m128 Renormalize_SSE2( __m128 totalNoise, float totalAmplitude )
+{
+	totalNoise = _mm_div_ps( totalNoise, _mm_set1_ps( totalAmplitude ) );
+	totalNoise = _mm_add_ps( _mm_mul_ps( totalNoise, _mm_set1_ps( 0.5f ) ), _mm_set1_ps( 0.5f ) );
+	totalNoise = SmoothStep3_SSE2( totalNoise );
+	return _mm_sub_ps( _mm_mul_ps( totalNoise, _mm_set1_ps( 2.0f ) ), _mm_set1_ps( 1.f ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the bit at the given index of each lane moved up to the float sign bit
+//
+static inline __m128 GetSignFromBit_SSE2( __m128i noise, int bitIndex )
+{
+	__m128i bit = _mm_and_si128( _mm_srli_epi32( noise, bitIndex ), _mm_set1_epi32( 1 ) );
+	return _mm_castsi128_ps( _mm_slli_epi32( bit, 31 ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Dot product of the 2D Perlin gradient picked by (noise & 7) with the displacement
+// In that table, X is the long component when bits 0 and 1 match, X is negative for entries
+//	2 through 5, and Y is negative for entries 4 through 7
+//
+static inline __m128 DotWith2dGradient_SSE2( __m128i noise, __m128 displacementX, __m128 displacementY )
+{
+	const __m128 LONG_COMPONENT = _mm_set1_ps( 0.923879533f );
+	const __m128 SHORT_COMPONENT = _mm_set1_ps( 0.382683432f );
+
+	__m128i bitsDiffer = _mm_and_si128( _mm_xor_si128( noise, _mm_srli_epi32( noise, 1 ) ), _mm_set1_epi32( 1 ) );
+	__m128 isXLong = _mm_castsi128_ps( _mm_cmpeq_epi32( bitsDiffer, _mm_setzero_si128() ) );
+
+	__m128 gradientX = _mm_or_ps( _mm_and_ps( isXLong, LONG_COMPONENT ), _mm_andnot_ps( isXLong, SHORT_COMPONENT ) );
+	__m128 gradientY = _mm_or_ps( _mm_and_ps( isXLong, SHORT_COMPONENT ), _mm_andnot_ps( isXLong, LONG_COMPONENT ) );
+
+	gradientX = _mm_xor_ps( gradientX, GetSignFromBit_SSE2( _mm_add_epi32( noise, _mm_set1_epi32( 2 ) ), 2 ) );
+	gradientY = _mm_xor_ps( gradientY, GetSignFromBit_SSE2( noise, 2 ) );
+
+	return _mm_add_ps( _mm_mul_ps( gradientX, displacementX ), _mm_mul_ps( gradientY, displacementY ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Dot product of the 3D Perlin gradient picked by (noise & 7) with the displacement
+// Every component in that table is sqrt(3)/3, with bits 0, 1, and 2 making X, Y, and Z negative
+//
+static inline __m128 DotWith3dGradient_SSE2( __m128i noise, __m128 component, __m128 displacementX, __m128 displacementY, __m128 displacementZ )
+{
+	__m128 gradientX = _mm_xor_ps( component, GetSignFromBit_SSE2( noise, 0 ) );
+	__m128 gradientY = _mm_xor_ps( component, GetSignFromBit_SSE2( noise, 1 ) );
+	__m128 gradientZ = _mm_xor_ps( component, GetSignFromBit_SSE2( noise, 2 ) );
+
+	__m128 dot = _mm_add_ps( _mm_mul_ps( gradientX, displacementX ), _mm_mul_ps( gradientY, displacementY ) );
+	return _mm_add_ps( dot, _mm_mul_ps( gradientZ, displacementZ ) );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Four samples of Compute2dFractalNoise()
+//
+static __m128 Compute2dFractalNoise_SSE2( __m128 posX, __m128 posY, const NoiseGrid_t& grid )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f;
+	const __m128 ONE = _mm_set1_ps( 1.f );
+	const __m128 HALF = _mm_set1_ps( 0.5f );
+	const __m128i ONE_INT = _mm_set1_epi32( 1 );
+
+	__m128 totalNoise = _mm_setzero_ps();
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / grid.scale);
+	__m128 currentX = _mm_mul_ps( posX, _mm_set1_ps( invScale ) );
+	__m128 currentY = _mm_mul_ps( posY, _mm_set1_ps( invScale ) );
+	unsigned int seed = grid.seed;
+
+	for( unsigned int octaveNum = 0; octaveNum < grid.numOctaves; ++ octaveNum )
+	{
+		__m128 cellMinsX = Floor_SSE2( currentX );
+		__m128 cellMinsY = Floor_SSE2( currentY );
+		__m128i indexWestX = _mm_cvttps_epi32( cellMinsX );
+		__m128i indexSouthY = _mm_cvttps_epi32( cellMinsY );
+		__m128i indexEastX = _mm_add_epi32( indexWestX, ONE_INT );
+		__m128i indexNorthY = _mm_add_epi32( indexSouthY, ONE_INT );
+
+		__m128 valueSouthWest = GetNoiseZeroToOne_SSE2( Get2dNoiseUint_SSE2( indexWestX, indexSouthY, seed ) );
+		__m128 valueSouthEast = GetNoiseZeroToOne_SSE2( Get2dNoiseUint_SSE2( indexEastX, indexSouthY, seed ) );
+		__m128 valueNorthWest = GetNoiseZeroToOne_SSE2( Get2dNoiseUint_SSE2( indexWestX, indexNorthY, seed ) );
+		__m128 valueNorthEast = GetNoiseZeroToOne_SSE2( Get2dNoiseUint_SSE2( indexEastX, indexNorthY, seed ) );
+
+		__m128 weightEast  = SmoothStep3_SSE2( _mm_sub_ps( currentX, cellMinsX ) );
+		__m128 weightNorth = SmoothStep3_SSE2( _mm_sub_ps( currentY, cellMinsY ) );
+		__m128 weightWest  = _mm_sub_ps( ONE, weightEast );
+		__m128 weightSouth = _mm_sub_ps( ONE, weightNorth );
+
+		__m128 blendSouth = Blend_SSE2( weightEast, valueSouthEast, weightWest, valueSouthWest );
+		__m128 blendNorth = Blend_SSE2( weightEast, valueNorthEast, weightWest, valueNorthWest );
+		__m128 blendTotal = Blend_SSE2( weightSouth, blendSouth, weightNorth, blendNorth );
+		__m128 noiseThisOctave = _mm_mul_ps( _mm_set1_ps( 2.f ), _mm_sub_ps( blendTotal, HALF ) );
+
+		totalNoise = _mm_add_ps( totalNoise, _mm_mul_ps( noiseThisOctave, _mm_set1_ps( currentAmplitude ) ) );
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= grid.octavePersistence;
+		currentX = _mm_add_ps( _mm_mul_ps( currentX, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		currentY = _mm_add_ps( _mm_mul_ps( currentY, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		++ seed;
+	}
+
+	if( grid.renormalize && totalAmplitude > 0.f )
+		totalNoise = Renormalize_SSE2( totalNoise, totalAmplitude );
+
+	return totalNoise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Four samples of Compute3dFractalNoise()
+//
+static __m128 Compute3dFractalNoise_SSE2( __m128 posX, __m128 posY, __m128 posZ, const NoiseGrid_t& grid )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f;
+	const __m128 ONE = _mm_set1_ps( 1.f );
+	const __m128 HALF = _mm_set1_ps( 0.5f );
+	const __m128i ONE_INT = _mm_set1_epi32( 1 );
+
+	__m128 totalNoise = _mm_setzero_ps();
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / grid.scale);
+	__m128 currentX = _mm_mul_ps( posX, _mm_set1_ps( invScale ) );
+	__m128 currentY = _mm_mul_ps( posY, _mm_set1_ps( invScale ) );
+	__m128 currentZ = _mm_mul_ps( posZ, _mm_set1_ps( invScale ) );
+	unsigned int seed = grid.seed;
+
+	for( unsigned int octaveNum = 0; octaveNum < grid.numOctaves; ++ octaveNum )
+	{
+		__m128 cellMinsX = Floor_SSE2( currentX );
+		__m128 cellMinsY = Floor_SSE2( currentY );
+		__m128 cellMinsZ = Floor_SSE2( currentZ );
+		__m128i indexWestX  = _mm_cvttps_epi32( cellMinsX );
+		__m128i indexSouthY = _mm_cvttps_epi32( cellMinsY );
+		__m128i indexBelowZ = _mm_cvttps_epi32( cellMinsZ );
+		__m128i indexEastX  = _mm_add_epi32( indexWestX, ONE_INT );
+		__m128i indexNorthY = _mm_add_epi32( indexSouthY, ONE_INT );
+		__m128i indexAboveZ = _mm_add_epi32( indexBelowZ, ONE_INT );
+
+		__m128 aboveSouthWest = GetNoiseZeroToOne_SSE2( Get3dNoiseUint_SSE2( indexWestX, indexSouthY, indexAboveZ, seed ) );
+		__m128 aboveSouthEast = GetNoiseZeroToOne_SSE2( Get3dNoiseUint_SSE2( indexEastX, indexSouthY, indexAboveZ, seed ) );
+		__m128 aboveNorthWest = GetNoiseZeroToOne_SSE2( Get3dNoiseUint_SSE2( indexWestX, indexNorthY, indexAboveZ, seed ) );
+		__m128 aboveNorthEast = GetNoiseZeroToOne_SSE2( Get3dNoiseUint_SSE2( indexEastX, indexNorthY, indexAboveZ, seed ) );
+		__m128 belowSouthWest = GetNoiseZeroToOne_SSE2( Get3dNoiseUint_SSE2( indexWestX, indexSouthY, indexBelowZ, seed ) );
+		__m128 belowSouthEast = GetNoiseZeroToOne_SSE2( Get3dNoiseUint_SSE2( indexEastX, indexSouthY, indexBelowZ, seed ) );
+		__m128 belowNorthWest = GetNoiseZeroToOne_SSE2( Get3dNoiseUint_SSE2( indexWestX, indexNorthY, indexBelowZ, seed ) );
+		__m128 belowNorthEast = GetNoiseZeroToOne_SSE2( Get3dNoiseUint_SSE2( indexEastX, indexNorthY, indexBelowZ, seed ) );
+
+		__m128 weightEast  = SmoothStep3_SSE2( _mm_sub_ps( currentX, cellMinsX ) );
+		__m128 weightNorth = SmoothStep3_SSE2( _mm_sub_ps( currentY, cellMinsY ) );
+		__m128 weightAbove = SmoothStep3_SSE2( _mm_sub_ps( currentZ, cellMinsZ ) );
+		__m128 weightWest  = _mm_sub_ps( ONE, weightEast );
+		__m128 weightSouth = _mm_sub_ps( ONE, weightNorth );
+		__m128 weightBelow = _mm_sub_ps( ONE, weightAbove );
+
+		__m128 blendBelowSouth = Blend_SSE2( weightEast, belowSouthEast, weightWest, belowSouthWest );
+		__m128 blendBelowNorth = Blend_SSE2( weightEast, belowNorthEast, weightWest, belowNorthWest );
+		__m128 blendAboveSouth = Blend_SSE2( weightEast, aboveSouthEast, weightWest, aboveSouthWest );
+		__m128 blendAboveNorth = Blend_SSE2( weightEast, aboveNorthEast, weightWest, aboveNorthWest );
+		__m128 blendBelow = Blend_SSE2( weightSouth, blendBelowSouth, weightNorth, blendBelowNorth );
+		__m128 blendAbove = Blend_SSE2( weightSouth, blendAboveSouth, weightNorth, blendAboveNorth );
+		__m128 blendTotal = Blend_SSE2( weightBelow, blendBelow, weightAbove, blendAbove );
+		__m128 noiseThisOctave = _mm_mul_ps( _mm_set1_ps( 2.f ), _mm_sub_ps( blendTotal, HALF ) );
+
+		totalNoise = _mm_add_ps( totalNoise, _mm_mul_ps( noiseThisOctave, _mm_set1_ps( currentAmplitude ) ) );
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= grid.octavePersistence;
+		currentX = _mm_add_ps( _mm_mul_ps( currentX, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		currentY = _mm_add_ps( _mm_mul_ps( currentY, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		currentZ = _mm_add_ps( _mm_mul_ps( currentZ, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		++ seed;
+	}
+
+	if( grid.renormalize && totalAmplitude > 0.f )
+		totalNoise = Renormalize_SSE2( totalNoise, totalAmplitude );
+
+	return totalNoise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Four samples of Compute2dPerlinNoise()
+//
+static __m128 Compute2dPerlinNoise_SSE2( __m128 posX, __m128 posY, const NoiseGrid_t& grid )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f;
+	const __m128 ONE = _mm_set1_ps( 1.f );
+	const __m128i ONE_INT = _mm_set1_epi32( 1 );
+
+	__m128 totalNoise = _mm_setzero_ps();
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / grid.scale);
+	__m128 currentX = _mm_mul_ps( posX, _mm_set1_ps( invScale ) );
+	__m128 currentY = _mm_mul_ps( posY, _mm_set1_ps( invScale ) );
+	unsigned int seed = grid.seed;
+
+	for( unsigned int octaveNum = 0; octaveNum < grid.numOctaves; ++ octaveNum )
+	{
+		__m128 cellMinsX = Floor_SSE2( currentX );
+		__m128 cellMinsY = Floor_SSE2( currentY );
+		__m128 cellMaxsX = _mm_add_ps( cellMinsX, ONE );
+		__m128 cellMaxsY = _mm_add_ps( cellMinsY, ONE );
+		__m128i indexWestX  = _mm_cvttps_epi32( cellMinsX );
+		__m128i indexSouthY = _mm_cvttps_epi32( cellMinsY );
+		__m128i indexEastX  = _mm_add_epi32( indexWestX, ONE_INT );
+		__m128i indexNorthY = _mm_add_epi32( indexSouthY, ONE_INT );
+
+		__m128i noiseSW = Get2dNoiseUint_SSE2( indexWestX, indexSouthY, seed );
+		__m128i noiseSE = Get2dNoiseUint_SSE2( indexEastX, indexSouthY, seed );
+		__m128i noiseNW = Get2dNoiseUint_SSE2( indexWestX, indexNorthY, seed );
+		__m128i noiseNE = Get2dNoiseUint_SSE2( indexEastX, indexNorthY, seed );
+
+		__m128 displacementWestX  = _mm_sub_ps( currentX, cellMinsX );
+		__m128 displacementEastX  = _mm_sub_ps( currentX, cellMaxsX );
+		__m128 displacementSouthY = _mm_sub_ps( currentY, cellMinsY );
+		__m128 displacementNorthY = _mm_sub_ps( currentY, cellMaxsY );
+
+		__m128 dotSouthWest = DotWith2dGradient_SSE2( noiseSW, displacementWestX, displacementSouthY );
+		__m128 dotSouthEast = DotWith2dGradient_SSE2( noiseSE, displacementEastX, displacementSouthY );
+		__m128 dotNorthWest = DotWith2dGradient_SSE2( noiseNW, displacementWestX, displacementNorthY );
+		__m128 dotNorthEast = DotWith2dGradient_SSE2( noiseNE, displacementEastX, displacementNorthY );
+
+		__m128 weightEast  = SmoothStep3_SSE2( displacementWestX );
+		__m128 weightNorth = SmoothStep3_SSE2( displacementSouthY );
+		__m128 weightWest  = _mm_sub_ps( ONE, weightEast );
+		__m128 weightSouth = _mm_sub_ps( ONE, weightNorth );
+
+		__m128 blendSouth = Blend_SSE2( weightEast, dotSouthEast, weightWest, dotSouthWest );
+		__m128 blendNorth = Blend_SSE2( weightEast, dotNorthEast, weightWest, dotNorthWest );
+		__m128 blendTotal = Blend_SSE2( weightSouth, blendSouth, weightNorth, blendNorth );
+		__m128 noiseThisOctave = _mm_mul_ps( blendTotal, _mm_set1_ps( 1.f / 0.662578106f ) );
+
+		totalNoise = _mm_add_ps( totalNoise, _mm_mul_ps( noiseThisOctave, _mm_set1_ps( currentAmplitude ) ) );
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= grid.octavePersistence;
+		currentX = _mm_add_ps( _mm_mul_ps( currentX, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		currentY = _mm_add_ps( _mm_mul_ps( currentY, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		++ seed;
+	}
+
+	if( grid.renormalize && totalAmplitude > 0.f )
+		totalNoise = Renormalize_SSE2( totalNoise, totalAmplitude );
+
+	return totalNoise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Four samples of Compute3dPerlinNoise()
+//
+static __m128 Compute3dPerlinNoise_SSE2( __m128 posX, __m128 posY, __m128 posZ, const NoiseGrid_t& grid )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f;
+	const __m128 ONE = _mm_set1_ps( 1.f );
+	const __m128i ONE_INT = _mm_set1_epi32( 1 );
+	const __m128 GRADIENT_COMPONENT = _mm_set1_ps( sqrtf( 3.f ) / 3.f );
+
+	__m128 totalNoise = _mm_setzero_ps();
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / grid.scale);
+	__m128 currentX = _mm_mul_ps( posX, _mm_set1_ps( invScale ) );
+	__m128 currentY = _mm_mul_ps( posY, _mm_set1_ps( invScale ) );
+	__m128 currentZ = _mm_mul_ps( posZ, _mm_set1_ps( invScale ) );
+	unsigned int seed = grid.seed;
+
+	for( unsigned int octaveNum = 0; octaveNum < grid.numOctaves; ++ octaveNum )
+	{
+		__m128 cellMinsX = Floor_SSE2( currentX );
+		__m128 cellMinsY = Floor_SSE2( currentY );
+		__m128 cellMinsZ = Floor_SSE2( currentZ );
+		__m128 cellMaxsX = _mm_add_ps( cellMinsX, ONE );
+		__m128 cellMaxsY = _mm_add_ps( cellMinsY, ONE );
+		__m128 cellMaxsZ = _mm_add_ps( cellMinsZ, ONE );
+		__m128i indexWestX  = _mm_cvttps_epi32( cellMinsX );
+		__m128i indexSouthY = _mm_cvttps_epi32( cellMinsY );
+		__m128i indexBelowZ = _mm_cvttps_epi32( cellMinsZ );
+		__m128i indexEastX  = _mm_add_epi32( indexWestX, ONE_INT );
+		__m128i indexNorthY = _mm_add_epi32( indexSouthY, ONE_INT );
+		__m128i indexAboveZ = _mm_add_epi32( indexBelowZ, ONE_INT );
+
+		__m128 displacementWestX  = _mm_sub_ps( currentX, cellMinsX );
+		__m128 displacementEastX  = _mm_sub_ps( currentX, cellMaxsX );
+		__m128 displacementSouthY = _mm_sub_ps( currentY, cellMinsY );
+		__m128 displacementNorthY = _mm_sub_ps( currentY, cellMaxsY );
+		__m128 displacementBelowZ = _mm_sub_ps( currentZ, cellMinsZ );
+		__m128 displacementAboveZ = _mm_sub_ps( currentZ, cellMaxsZ );
+
+		__m128 dotBelowSW = DotWith3dGradient_SSE2( Get3dNoiseUint_SSE2( indexWestX, indexSouthY, indexBelowZ, seed ), GRADIENT_COMPONENT, displacementWestX, displacementSouthY, displacementBelowZ );
+		__m128 dotBelowSE = DotWith3dGradient_SSE2( Get3dNoiseUint_SSE2( indexEastX, indexSouthY, indexBelowZ, seed ), GRADIENT_COMPONENT, displacementEastX, displacementSouthY, displacementBelowZ );
+		__m128 dotBelowNW = DotWith3dGradient_SSE2( Get3dNoiseUint_SSE2( indexWestX, indexNorthY, indexBelowZ, seed ), GRADIENT_COMPONENT, displacementWestX, displacementNorthY, displacementBelowZ );
+		__m128 dotBelowNE = DotWith3dGradient_SSE2( Get3dNoiseUint_SSE2( indexEastX, indexNorthY, indexBelowZ, seed ), GRADIENT_COMPONENT, displacementEastX, displacementNorthY, displacementBelowZ );
+		__m128 dotAboveSW = DotWith3dGradient_SSE2( Get3dNoiseUint_SSE2( indexWestX, indexSouthY, indexAboveZ, seed ), GRADIENT_COMPONENT, displacementWestX, displacementSouthY, displacementAboveZ );
+		__m128 dotAboveSE = DotWith3dGradient_SSE2( Get3dNoiseUint_SSE2( indexEastX, indexSouthY, indexAboveZ, seed ), GRADIENT_COMPONENT, displacementEastX, displacementSouthY, displacementAboveZ );
+		__m128 dotAboveNW = DotWith3dGradient_SSE2( Get3dNoiseUint_SSE2( indexWestX, indexNorthY, indexAboveZ, seed ), GRADIENT_COMPONENT, displacementWestX, displacementNorthY, displacementAboveZ );
+		__m128 dotAboveNE = DotWith3dGradient_SSE2( Get3dNoiseUint_SSE2( indexEastX, indexNorthY, indexAboveZ, seed ), GRADIENT_COMPONENT, displacementEastX, displacementNorthY, displacementAboveZ );
+
+		__m128 weightEast  = SmoothStep3_SSE2( displacementWestX );
+		__m128 weightNorth = SmoothStep3_SSE2( displacementSouthY );
+		__m128 weightAbove = SmoothStep3_SSE2( displacementBelowZ );
+		__m128 weightWest  = _mm_sub_ps( ONE, weightEast );
+		__m128 weightSouth = _mm_sub_ps( ONE, weightNorth );
+		__m128 weightBelow = _mm_sub_ps( ONE, weightAbove );
+
+		__m128 blendBelowSouth = Blend_SSE2( weightEast, dotBelowSE, weightWest, dotBelowSW );
+		__m128 blendBelowNorth = Blend_SSE2( weightEast, dotBelowNE, weightWest, dotBelowNW );
+		__m128 blendAboveSouth = Blend_SSE2( weightEast, dotAboveSE, weightWest, dotAboveSW );
+		__m128 blendAboveNorth = Blend_SSE2( weightEast, dotAboveNE, weightWest, dotAboveNW );
+		__m128 blendBelow = Blend_SSE2( weightSouth, blendBelowSouth, weightNorth, blendBelowNorth );
+		__m128 blendAbove = Blend_SSE2( weightSouth, blendAboveSouth, weightNorth, blendAboveNorth );
+		__m128 blendTotal = Blend_SSE2( weightBelow, blendBelow, weightAbove, blendAbove );
+		__m128 noiseThisOctave = _mm_mul_ps( blendTotal, _mm_set1_ps( 1.f / 0.793856621f ) );
+
+		totalNoise = _mm_add_ps( totalNoise, _mm_mul_ps( noiseThisOctave, _mm_set1_ps( currentAmplitude ) ) );
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= grid.octavePersistence;
+		currentX = _mm_add_ps( _mm_mul_ps( currentX, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		currentY = _mm_add_ps( _mm_mul_ps( currentY, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		currentZ = _mm_add_ps( _mm_mul_ps( currentZ, _mm_set1_ps( grid.octaveScale ) ), _mm_set1_ps( OCTAVE_OFFSET ) );
+		++ seed;
+	}
+
+	if( grid.renormalize && totalAmplitude > 0.f )
+		totalNoise = Renormalize_SSE2( totalNoise, totalAmplitude );
+
+	return totalNoise;
+}
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+void Compute2dFractalNoiseGrid( const NoiseGrid_t& grid, float* out_values, int firstRow, int rowCount )
+{
+	int endRow = GetGridEndRow( grid, firstRow, rowCount );
+
+	for( int rowIndex = firstRow; rowIndex < endRow; ++ rowIndex )
+	{
+		float posY = GetGridPosition( grid.originY, grid.stepY, rowIndex % grid.countY );
+		float* rowValues = out_values + (rowIndex * grid.countX);
+		int indexX = 0;
+
+#ifdef RAW_NOISE_USE_SSE2
+		__m128 posY4 = _mm_set1_ps( posY );
+		for( ; indexX + 4 <= grid.countX; indexX += 4 )
+		{
+			__m128 posX4 = GetGridPositions_SSE2( grid.originX, grid.stepX, indexX );
+			_mm_storeu_ps( rowValues + indexX, Compute2dFractalNoise_SSE2( posX4, posY4, grid ) );
+		}
+#endif
+
+		for( ; indexX < grid.countX; ++ indexX )
+		{
+			float posX = GetGridPosition( grid.originX, grid.stepX, indexX );
+			rowValues[ indexX ] = Compute2dFractalNoise( posX, posY, grid.scale, grid.numOctaves, grid.octavePersistence, grid.octaveScale, grid.renormalize, grid.seed );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Compute3dFractalNoiseGrid( const NoiseGrid_t& grid, float* out_values, int firstRow, int rowCount )
+{
+	int endRow = GetGridEndRow( grid, firstRow, rowCount );
+
+	for( int rowIndex = firstRow; rowIndex < endRow; ++ rowIndex )
+	{
+		float posY = GetGridPosition( grid.originY, grid.stepY, rowIndex % grid.countY );
+		float posZ = GetGridPosition( grid.originZ, grid.stepZ, rowIndex / grid.countY );
+		float* rowValues = out_values + (rowIndex * grid.countX);
+		int indexX = 0;
+
+#ifdef RAW_NOISE_USE_SSE2
+		__m128 posY4 = _mm_set1_ps( posY );
+		__m128 posZ4 = _mm_set1_ps( posZ );
+		for( ; indexX + 4 <= grid.countX; indexX += 4 )
+		{
+			__m128 posX4 = GetGridPositions_SSE2( grid.originX, grid.stepX, indexX );
+			_mm_storeu_ps( rowValues + indexX, Compute3dFractalNoise_SSE2( posX4, posY4, posZ4, grid ) );
+		}
+#endif
+
+		for( ; indexX < grid.countX; ++ indexX )
+		{
+			float posX = GetGridPosition( grid.originX, grid.stepX, indexX );
+			rowValues[ indexX ] = Compute3dFractalNoise( posX, posY, posZ, grid.scale, grid.numOctaves, grid.octavePersistence, grid.octaveScale, grid.renormalize, grid.seed );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Compute2dPerlinNoiseGrid( const NoiseGrid_t& grid, float* out_values, int firstRow, int rowCount )
+{
+	int endRow = GetGridEndRow( grid, firstRow, rowCount );
+
+	for( int rowIndex = firstRow; rowIndex < endRow; ++ rowIndex )
+	{
+		float posY = GetGridPosition( grid.originY, grid.stepY, rowIndex % grid.countY );
+		float* rowValues = out_values + (rowIndex * grid.countX);
+		int indexX = 0;
+
+#ifdef RAW_NOISE_USE_SSE2
+		__m128 posY4 = _mm_set1_ps( posY );
+		for( ; indexX + 4 <= grid.countX; indexX += 4 )
+		{
+			__m128 posX4 = GetGridPositions_SSE2( grid.originX, grid.stepX, indexX );
+			_mm_storeu_ps( rowValues + indexX, Compute2dPerlinNoise_SSE2( posX4, posY4, grid ) );
+		}
+#endif
+
+		for( ; indexX < grid.countX; ++ indexX )
+		{
+			float posX = GetGridPosition( grid.originX, grid.stepX, indexX );
+			rowValues[ indexX ] = Compute2dPerlinNoise( posX, posY, grid.scale, grid.numOctaves, grid.octavePersistence, grid.octaveScale, grid.renormalize, grid.seed );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Compute3dPerlinNoiseGrid( const NoiseGrid_t& grid, float* out_values, int firstRow, int rowCount )
+{
+	int endRow = GetGridEndRow( grid, firstRow, rowCount );
+
+	for( int rowIndex = firstRow; rowIndex < endRow; ++ rowIndex )
+	{
+		float posY = GetGridPosition( grid.originY, grid.stepY, rowIndex % grid.countY );
+		float posZ = GetGridPosition( grid.originZ, grid.stepZ, rowIndex / grid.countY );
+		float* rowValues = out_values + (rowIndex * grid.countX);
+		int indexX = 0;
+
+#ifdef RAW_NOISE_USE_SSE2
+		__m128 posY4 = _mm_set1_ps( posY );
+		__m128 posZ4 = _mm_set1_ps( posZ );
+		for( ; indexX + 4 <= grid.countX; indexX += 4 )
+		{
+			__m128 posX4 = GetGridPositions_SSE2( grid.originX, grid.stepX, indexX );
+			_mm_storeu_ps( rowValues + indexX, Compute3dPerlinNoise_SSE2( posX4, posY4, posZ4, grid ) );
+		}
+#endif
+
+		for( ; indexX < grid.countX; ++ indexX )
+		{
+			float posX = GetGridPosition( grid.originX, grid.stepX, indexX );
+			rowValues[ indexX ] = Compute3dPerlinNoise( posX, posY, posZ, grid.scale, grid.numOctaves, grid.octavePersistence, grid.octaveScale, grid.renormalize, grid.seed );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Job for filling a range of a noise grid's rows, which no other job writes to
+//
+class NoiseGridJob : public Job
+{
+public:
+
+	NoiseGridJob( NoiseGridFunction gridFunction, const NoiseGrid_t& grid, float* out_values, int firstRow, int rowCount )
+		: m_gridFunction( gridFunction ), m_grid( grid ), m_values( out_values ), m_firstRow( firstRow ), m_rowCount( rowCount )
+	{
+		m_jobType = JOB_TYPE_NOISE_GRID;
+		m_jobFlags = WORKER_FLAGS_ALL_BUT_DISK;
+	}
+
+	virtual void Execute() override
+	{
+		m_gridFunction( m_grid, m_values, m_firstRow, m_rowCount );
+	}
+
+	NoiseGridFunction	m_gridFunction = nullptr;
+	NoiseGrid_t			m_grid;
+	float*				m_values = nullptr;
+	int					m_firstRow = 0;
+	int					m_rowCount = 0;
+
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Rows are handed out in contiguous blocks, about one per worker, each at least a few thousand
+//	samples so queueing a job never costs more than the job
+//
+void ComputeNoiseGridInJobs( NoiseGridFunction gridFunction, const NoiseGrid_t& grid, float* out_values )
+{
+	const int MIN_SAMPLES_PER_JOB = 4096;
+
+	int totalRows = grid.countY * grid.countZ;
+	int totalSamples = totalRows * grid.countX;
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	int workerCount = (jobSystem != nullptr ? jobSystem->GetWorkerThreadCount( WORKER_FLAGS_ALL_BUT_DISK ) : 0);
+	int jobCount = ClampInt( totalSamples / MIN_SAMPLES_PER_JOB, 1, MaxInt( workerCount, 1 ) );
+
+	if( workerCount == 0 || jobCount == 1 || totalRows < 2 )
+	{
+		gridFunction( grid, out_values, 0, totalRows );
+		return;
+	}
+
+	int rowsPerJob = (totalRows + jobCount - 1) / jobCount;
+
+	for( int firstRow = 0; firstRow < totalRows; firstRow += rowsPerJob )
+	{
+		QueueJob( new NoiseGridJob( gridFunction, grid, out_values, firstRow, MinInt( rowsPerJob, totalRows - firstRow ) ) );
+	}
+
+	jobSystem->BlockUntilAllJobsOfTypeAreFinalized( JOB_TYPE_NOISE_GRID );
+}
@@ -75,6 +75,52 @@ float Compute3dPerlinNoise( float posX, float posY, float posZ, float scale=1.f,
 float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
 
 
+//-----------------------------------------------------------------------------------------------
+// Grid (batch) noise functions
+//
+// Fill a whole grid of samples at once, four at a time with SSE2 where available.  Each sample
+//	gets exactly the value the single-sample function above returns for the same position.
+//
+// Sample (x,y,z) is at (origin + index * step), written to out_values[ x + countX * (y + countY * z) ].
+//	Each run of countX samples along X is a row, and only rows [firstRow, firstRow + rowCount)
+//	are written (-1 meaning "to the end"), so a grid can be split up across threads.
+//	2D functions ignore Z, so 2D grids should leave countZ at 1.
+//
+struct NoiseGrid_t
+{
+	float originX = 0.f;
+	float originY = 0.f;
+	float originZ = 0.f;
+
+	float stepX = 1.f;
+	float stepY = 1.f;
+	float stepZ = 1.f;
+
+	int countX = 0;
+	int countY = 1;
+	int countZ = 1;
+
+	// Same meaning as the single-sample parameters
+	float			scale = 1.f;
+	unsigned int	numOctaves = 1;
+	float			octavePersistence = 0.5f;
+	float			octaveScale = 2.f;
+	bool			renormalize = true;
+	unsigned int	seed = 0;
+};
+
+typedef void (*NoiseGridFunction)( const NoiseGrid_t& grid, float* out_values, int firstRow, int rowCount );
+
+void Compute2dFractalNoiseGrid( const NoiseGrid_t& grid, float* out_values, int firstRow=0, int rowCount=-1 );
+void Compute3dFractalNoiseGrid( const NoiseGrid_t& grid, float* out_values, int firstRow=0, int rowCount=-1 );
+void Compute2dPerlinNoiseGrid( const NoiseGrid_t& grid, float* out_values, int firstRow=0, int rowCount=-1 );
+void Compute3dPerlinNoiseGrid( const NoiseGrid_t& grid, float* out_values, int firstRow=0, int rowCount=-1 );
+
+// Splits the grid into jobs of whole rows on the JobSystem's workers, and returns once it's filled
+//	Runs on the calling thread if there are no workers or the grid is small
+void ComputeNoiseGridInJobs( NoiseGridFunction gridFunction, const NoiseGrid_t& grid, float* out_values );
+
+
 //-----------------------------------------------------------------------------------------------
 // Simplex noise functions (random-access / deterministic)
 //
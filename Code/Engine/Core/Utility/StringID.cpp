@@ -0,0 +1,71 @@
+/************************************************************************/
+/* File: StringID.cpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: Implementation of the StringID class
+/************************************************************************/
+#include <map>
+#include <shared_mutex>
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Utility/StringID.hpp"
+
+// Text of every interned ID - only written when assets or other names are registered, so lookups share the lock
+static std::map<uint64_t, std::string>	s_internedStrings;
+static std::shared_mutex				s_internLock;
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the ID for the text, recording the text against it
+// Dies if a different string was already interned with the same hash, since every lookup by either would alias
+//
+StringID StringID::Intern(const std::string& text)
+{
+	StringID id(text);
+	std::string existingText = text;
+
+	s_internLock.lock();
+	{
+		std::map<uint64_t, std::string>::iterator itr = s_internedStrings.find(id.m_hash);
+
+		if (itr == s_internedStrings.end())
+		{
+			s_internedStrings[id.m_hash] = text;
+		}
+		else
+		{
+			existingText = itr->second;
+		}
+	}
+	s_internLock.unlock();
+
+	GUARANTEE_OR_DIE(existingText == text, Stringf("Error: StringID::Intern() - \"%s\" and \"%s\" have the same hash", text.c_str(), existingText.c_str()));
+
+	return id;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the text the ID was interned with, or its hash in hex if it never was
+//
+std::string StringID::ToString() const
+{
+	std::string text;
+
+	s_internLock.lock_shared();
+	{
+		std::map<uint64_t, std::string>::const_iterator itr = s_internedStrings.find(m_hash);
+
+		if (itr != s_internedStrings.end())
+		{
+			text = itr->second;
+		}
+	}
+	s_internLock.unlock_shared();
+
+	if (text.empty() && m_hash != 0)
+	{
+		text = Stringf("0x%016llx", (unsigned long long) m_hash);
+	}
+
+	return text;
+}
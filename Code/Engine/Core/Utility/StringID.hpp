@@ -0,0 +1,56 @@
+/************************************************************************/
+/* File: StringID.hpp
+/* Author: Andrew Chase
+/* Date: June 16th, 2019
+/* Description: 64-bit hash of a string, for comparing and looking up names
+/*				without touching the characters - literals hash at compile time
+/************************************************************************/
+#pragma once
+#include <string>
+#include <stdint.h>
+#include <type_traits>
+
+class StringID
+{
+public:
+	//-----Public Methods-----
+
+	constexpr StringID() {}
+	constexpr StringID(const char* text) : m_hash(HashCString(text)) {}
+	StringID(const std::string& text) : m_hash(HashCString(text.c_str())) {}
+
+	static constexpr StringID FromHash(uint64_t hash) { StringID id; id.m_hash = hash; return id; }
+
+	// Records the text, so ToString() works and two strings with the same hash are caught
+	static StringID	Intern(const std::string& text);
+
+	constexpr uint64_t	GetHash() const { return m_hash; }
+	constexpr bool		IsValid() const { return m_hash != 0; }
+	std::string			ToString() const;	// The interned text, or the hash in hex if it wasn't interned
+
+	constexpr bool operator==(const StringID& compare) const { return m_hash == compare.m_hash; }
+	constexpr bool operator!=(const StringID& compare) const { return m_hash != compare.m_hash; }
+	constexpr bool operator<(const StringID& compare) const { return m_hash < compare.m_hash; }
+
+	// FNV-1a, one byte at a time so it can run at compile time - 0 is kept for the empty StringID
+	static constexpr uint64_t HashCString(const char* text)
+	{
+		uint64_t hash = 0xcbf29ce484222325ULL;
+		for (const char* currChar = text; *currChar != '\0'; ++currChar)
+		{
+			hash = (hash ^ (uint64_t)(unsigned char)*currChar) * 0x100000001b3ULL;
+		}
+
+		return (hash == 0 ? 1 : hash);
+	}
+
+
+private:
+	//-----Private Data-----
+
+	uint64_t m_hash = 0;
+
+};
+
+// For hot paths that look up by a literal, e.g. AssetDB::GetShader(SID("Phong_Opaque")) - forces the hash to compile time
+#define SID(text) (StringID::FromHash(std::integral_constant<uint64_t, StringID::HashCString(text)>::value))
@@ -7,6 +7,7 @@
 /*				structures
 /************************************************************************/
 #include "Engine/Core/Utility/XmlUtilities.hpp"
+#include "Engine/Core/File.hpp"
 #include "Engine/Core/Utility/StringUtils.hpp"
 #include "Engine/Core/Utility/ErrorWarningAssert.hpp"
 #include "Engine/Core/Rgba.hpp"
@@ -18,6 +19,22 @@
 #include "Engine/Math/IntVector3.hpp"
 #include "Engine/Math/AABB2.hpp"
 
+//-----------------------------------------------------------------------------------------------
+// Parses the file into the document, returning XML_ERROR_FILE_NOT_FOUND if it couldn't be opened
+//
+XMLError LoadXmlDocument(XMLDocument& document, const std::string& filepath)
+{
+	MappedFile file;
+	if (!file.Open(filepath.c_str()))
+	{
+		return tinyxml2::XML_ERROR_FILE_NOT_FOUND;
+	}
+
+	// Parse() copies the text, so the file can be unmapped once it returns
+	return document.Parse(file.GetData(), file.GetSize());
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Gets an attribute value and returns it as an int
 //
@@ -24,6 +24,9 @@ class IntVector2;
 class IntVector3;
 class AABB2;
 
+// Reads the file through MappedFile rather than tinyxml2's own fopen, so it resolves through mounted packs
+XMLError		LoadXmlDocument(XMLDocument& document, const std::string& filepath);
+
 int				ParseXmlAttribute( const XMLElement& element, const char* attributeName, int defaultValue );
 unsigned int	ParseXmlAttribute(const XMLElement& element, const char* attributeName, unsigned int defaultValue);
 char			ParseXmlAttribute( const XMLElement& element, const char* attributeName, char defaultValue );
@@ -10,6 +10,7 @@
 #include "Engine/Math/Matrix44.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/Matrix44Kernels.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 
 const Matrix44 Matrix44::IDENTITY = Matrix44();
@@ -87,7 +88,7 @@ Matrix44::Matrix44(const Vector4& iBasis, const Vector4& jBasis, const Vector4&
 	Jx = jBasis.x;
 	Jy = jBasis.y;
 	Jz = jBasis.z;
-	Jw = iBasis.w;
+	Jw = jBasis.w;
 
 	Kx = kBasis.x;
 	Ky = kBasis.y;
@@ -106,8 +107,13 @@ Matrix44::Matrix44(const Vector4& iBasis, const Vector4& jBasis, const Vector4&
 //
 const Matrix44 Matrix44::operator*(const Matrix44& rightMat) const
 {
-	Matrix44 result = *this;
-	result.Append(rightMat);
+	Matrix44 result;
+
+#ifdef MATRIX44_USE_SSE
+	MultiplyMatrices_SSE(*this, rightMat, result);
+#else
+	MultiplyMatrices_Scalar(*this, rightMat, result);
+#endif
 
 	return result;
 }
@@ -229,10 +235,11 @@ Vector4 Matrix44::Transform(const Vector4& vector) const
 {
 	Vector4 result;
 
-	result.x = DotProduct(GetXVector(), vector);
-	result.y = DotProduct(GetYVector(), vector);
-	result.z = DotProduct(GetZVector(), vector);
-	result.w = DotProduct(GetWVector(), vector);
+#ifdef MATRIX44_USE_SSE
+	TransformVector4_SSE(*this, vector, result);
+#else
+	TransformVector4_Scalar(*this, vector, result);
+#endif
 
 	return result;
 }
@@ -298,32 +305,11 @@ void Matrix44::SetValues(const float* sixteenValuesBasisMajor)
 //
 void Matrix44::Append(const Matrix44& matrixToAppend)
 {
-	// Copy old values for calculation
-	Matrix44 oldValues = *this;
-
-	// New I basis vector
-	Ix = DotProduct(oldValues.GetXVector(), matrixToAppend.GetIVector());
-	Iy = DotProduct(oldValues.GetYVector(), matrixToAppend.GetIVector());
-	Iz = DotProduct(oldValues.GetZVector(), matrixToAppend.GetIVector());
-	Iw = DotProduct(oldValues.GetWVector(), matrixToAppend.GetIVector());
-
-	// New J basis vector
-	Jx = DotProduct(oldValues.GetXVector(), matrixToAppend.GetJVector());
-	Jy = DotProduct(oldValues.GetYVector(), matrixToAppend.GetJVector());
-	Jz = DotProduct(oldValues.GetZVector(), matrixToAppend.GetJVector());
-	Jw = DotProduct(oldValues.GetWVector(), matrixToAppend.GetJVector());
-
-	// New K basis vector
-	Kx = DotProduct(oldValues.GetXVector(), matrixToAppend.GetKVector());
-	Ky = DotProduct(oldValues.GetYVector(), matrixToAppend.GetKVector());
-	Kz = DotProduct(oldValues.GetZVector(), matrixToAppend.GetKVector());
-	Kw = DotProduct(oldValues.GetWVector(), matrixToAppend.GetKVector());
-
-	// New T basis vector
-	Tx = DotProduct(oldValues.GetXVector(), matrixToAppend.GetTVector());
-	Ty = DotProduct(oldValues.GetYVector(), matrixToAppend.GetTVector());
-	Tz = DotProduct(oldValues.GetZVector(), matrixToAppend.GetTVector());
-	Tw = DotProduct(oldValues.GetWVector(), matrixToAppend.GetTVector());
+#ifdef MATRIX44_USE_SSE
+	MultiplyMatrices_SSE(*this, matrixToAppend, *this);
+#else
+	MultiplyMatrices_Scalar(*this, matrixToAppend, *this);
+#endif
 }
 
 
@@ -332,25 +318,11 @@ void Matrix44::Append(const Matrix44& matrixToAppend)
 //
 void Matrix44::Transpose()
 {
-	Matrix44 original = *this;
-
-	Iy = original.Jx;
-	Jx = original.Iy;
-
-	Iz = original.Kx;
-	Kx = original.Iz;
-
-	Iw = original.Tx;
-	Tx = original.Iw;
-
-	Jz = original.Ky;
-	Ky = original.Jz;
-
-	Jw = original.Ty;
-	Ty = original.Jw;
-
-	Kw = original.Tz;
-	Tz = original.Kw;
+#ifdef MATRIX44_USE_SSE
+	TransposeMatrix_SSE(*this, *this);
+#else
+	TransposeMatrix_Scalar(*this, *this);
+#endif
 }
 
 
@@ -574,160 +546,13 @@ Vector3 Matrix44::ExtractScale(const Matrix44& scaleMatrix)
 //
 Matrix44 Matrix44::GetInverse(const Matrix44& matrix)
 {
-	double inv[16];
-	double det;
-	double m[16];
-
-	m[0]	= (double) matrix.Ix;
-	m[1]	= (double) matrix.Iy;
-	m[2]	= (double) matrix.Iz;
-	m[3]	= (double) matrix.Iw;
-	m[4]	= (double) matrix.Jx;
-	m[5]	= (double) matrix.Jy;
-	m[6]	= (double) matrix.Jz;
-	m[7]	= (double) matrix.Jw;
-	m[8]	= (double) matrix.Kx;
-	m[9]	= (double) matrix.Ky;
-	m[10]	= (double) matrix.Kz;
-	m[11]	= (double) matrix.Kw;
-	m[12]	= (double) matrix.Tx;
-	m[13]	= (double) matrix.Ty;
-	m[14]	= (double) matrix.Tz;
-	m[15]	= (double) matrix.Tw;
-
-	inv[0] = m[5]  * m[10] * m[15] - 
-		m[5]  * m[11] * m[14] - 
-		m[9]  * m[6]  * m[15] + 
-		m[9]  * m[7]  * m[14] +
-		m[13] * m[6]  * m[11] - 
-		m[13] * m[7]  * m[10];
-
-	inv[4] = -m[4]  * m[10] * m[15] + 
-		m[4]  * m[11] * m[14] + 
-		m[8]  * m[6]  * m[15] - 
-		m[8]  * m[7]  * m[14] - 
-		m[12] * m[6]  * m[11] + 
-		m[12] * m[7]  * m[10];
-
-	inv[8] = m[4]  * m[9] * m[15] - 
-		m[4]  * m[11] * m[13] - 
-		m[8]  * m[5] * m[15] + 
-		m[8]  * m[7] * m[13] + 
-		m[12] * m[5] * m[11] - 
-		m[12] * m[7] * m[9];
-
-	inv[12] = -m[4]  * m[9] * m[14] + 
-		m[4]  * m[10] * m[13] +
-		m[8]  * m[5] * m[14] - 
-		m[8]  * m[6] * m[13] - 
-		m[12] * m[5] * m[10] + 
-		m[12] * m[6] * m[9];
-
-	inv[1] = -m[1]  * m[10] * m[15] + 
-		m[1]  * m[11] * m[14] + 
-		m[9]  * m[2] * m[15] - 
-		m[9]  * m[3] * m[14] - 
-		m[13] * m[2] * m[11] + 
-		m[13] * m[3] * m[10];
-
-	inv[5] = m[0]  * m[10] * m[15] - 
-		m[0]  * m[11] * m[14] - 
-		m[8]  * m[2] * m[15] + 
-		m[8]  * m[3] * m[14] + 
-		m[12] * m[2] * m[11] - 
-		m[12] * m[3] * m[10];
-
-	inv[9] = -m[0]  * m[9] * m[15] + 
-		m[0]  * m[11] * m[13] + 
-		m[8]  * m[1] * m[15] - 
-		m[8]  * m[3] * m[13] - 
-		m[12] * m[1] * m[11] + 
-		m[12] * m[3] * m[9];
-
-	inv[13] = m[0]  * m[9] * m[14] - 
-		m[0]  * m[10] * m[13] - 
-		m[8]  * m[1] * m[14] + 
-		m[8]  * m[2] * m[13] + 
-		m[12] * m[1] * m[10] - 
-		m[12] * m[2] * m[9];
-
-	inv[2] = m[1]  * m[6] * m[15] - 
-		m[1]  * m[7] * m[14] - 
-		m[5]  * m[2] * m[15] + 
-		m[5]  * m[3] * m[14] + 
-		m[13] * m[2] * m[7] - 
-		m[13] * m[3] * m[6];
-
-	inv[6] = -m[0]  * m[6] * m[15] + 
-		m[0]  * m[7] * m[14] + 
-		m[4]  * m[2] * m[15] - 
-		m[4]  * m[3] * m[14] - 
-		m[12] * m[2] * m[7] + 
-		m[12] * m[3] * m[6];
-
-	inv[10] = m[0]  * m[5] * m[15] - 
-		m[0]  * m[7] * m[13] - 
-		m[4]  * m[1] * m[15] + 
-		m[4]  * m[3] * m[13] + 
-		m[12] * m[1] * m[7] - 
-		m[12] * m[3] * m[5];
-
-	inv[14] = -m[0]  * m[5] * m[14] + 
-		m[0]  * m[6] * m[13] + 
-		m[4]  * m[1] * m[14] - 
-		m[4]  * m[2] * m[13] - 
-		m[12] * m[1] * m[6] + 
-		m[12] * m[2] * m[5];
-
-	inv[3] = -m[1] * m[6] * m[11] + 
-		m[1] * m[7] * m[10] + 
-		m[5] * m[2] * m[11] - 
-		m[5] * m[3] * m[10] - 
-		m[9] * m[2] * m[7] + 
-		m[9] * m[3] * m[6];
-
-	inv[7] = m[0] * m[6] * m[11] - 
-		m[0] * m[7] * m[10] - 
-		m[4] * m[2] * m[11] + 
-		m[4] * m[3] * m[10] + 
-		m[8] * m[2] * m[7] - 
-		m[8] * m[3] * m[6];
-
-	inv[11] = -m[0] * m[5] * m[11] + 
-		m[0] * m[7] * m[9] + 
-		m[4] * m[1] * m[11] - 
-		m[4] * m[3] * m[9] - 
-		m[8] * m[1] * m[7] + 
-		m[8] * m[3] * m[5];
-
-	inv[15] = m[0] * m[5] * m[10] - 
-		m[0] * m[6] * m[9] - 
-		m[4] * m[1] * m[10] + 
-		m[4] * m[2] * m[9] + 
-		m[8] * m[1] * m[6] - 
-		m[8] * m[2] * m[5];
-
-	det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
-	det = 1.0 / det;
-
 	Matrix44 inverse;
 
-	inverse.Ix = (float)(inv[0] * det);
-	inverse.Iy = (float)(inv[1] * det);
-	inverse.Iz = (float)(inv[2] * det);
-	inverse.Iw = (float)(inv[3] * det);
-	inverse.Jx = (float)(inv[4] * det);
-	inverse.Jy = (float)(inv[5] * det);
-	inverse.Jz = (float)(inv[6] * det);
-	inverse.Jw = (float)(inv[7] * det);
-	inverse.Kx = (float)(inv[8] * det);
-	inverse.Ky = (float)(inv[9] * det);
-	inverse.Kz = (float)(inv[10] * det);
-	inverse.Kw = (float)(inv[11] * det);
-	inverse.Tx = (float)(inv[12] * det);
-	inverse.Ty = (float)(inv[13] * det);
-	inverse.Tz = (float)(inv[14] * det);
-	inverse.Tw = (float)(inv[15] * det);
+#ifdef MATRIX44_USE_SSE
+	InvertMatrix_SSE(matrix, inverse);
+#else
+	InvertMatrix_Scalar(matrix, inverse);
+#endif
 
 	return inverse;
 }
@@ -744,28 +569,93 @@ Matrix44 Matrix44::GetInverse() const
 
 
 //-----------------------------------------------------------------------------------------------
-// Interpolates between the two matrices and returns the result
+// Transforms each point by the matrix (w = 1), output can be the input
 //
-Matrix44 Interpolate(const Matrix44& start, const Matrix44& end, float fractionTowardEnd)
+void Matrix44::TransformPoints(const Matrix44& matrix, const Vector3* points, Vector3* out_points, int count)
 {
-	Vector4 startI = start.GetIVector();
-	Vector4 endI = end.GetIVector();
+	if (count <= 0)
+	{
+		return;
+	}
 
-	Vector4 startJ = start.GetJVector();
-	Vector4 endJ = end.GetJVector();
+#ifdef MATRIX44_USE_SSE
+	TransformPoints_SSE(matrix, &points[0].x, 3, &out_points[0].x, 3, count, 1.0f);
+#else
+	for (int pointIndex = 0; pointIndex < count; ++pointIndex)
+	{
+		out_points[pointIndex] = matrix.TransformPoint(points[pointIndex]).xyz();
+	}
+#endif
+}
 
-	Vector4 startK = start.GetKVector();
-	Vector4 endK = end.GetKVector();
 
-	Vector4 startT = start.GetTVector();
-	Vector4 endT = end.GetTVector();
+//-----------------------------------------------------------------------------------------------
+// Transforms each vector by the matrix (w = 0), output can be the input
+//
+void Matrix44::TransformVectors(const Matrix44& matrix, const Vector3* vectors, Vector3* out_vectors, int count)
+{
+	if (count <= 0)
+	{
+		return;
+	}
 
-	Vector4 resultI = Interpolate(startI, endI, fractionTowardEnd);
-	Vector4 resultJ = Interpolate(startJ, endJ, fractionTowardEnd);
-	Vector4 resultK = Interpolate(startK, endK, fractionTowardEnd);
-	Vector4 resultT = Interpolate(startT, endT, fractionTowardEnd);
+#ifdef MATRIX44_USE_SSE
+	TransformPoints_SSE(matrix, &vectors[0].x, 3, &out_vectors[0].x, 3, count, 0.f);
+#else
+	for (int vectorIndex = 0; vectorIndex < count; ++vectorIndex)
+	{
+		out_vectors[vectorIndex] = matrix.TransformVector(vectors[vectorIndex]).xyz();
+	}
+#endif
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Transforms each Vector4 by the matrix, output can be the input
+//
+void Matrix44::TransformVector4s(const Matrix44& matrix, const Vector4* vectors, Vector4* out_vectors, int count)
+{
+	for (int vectorIndex = 0; vectorIndex < count; ++vectorIndex)
+	{
+#ifdef MATRIX44_USE_SSE
+		TransformVector4_SSE(matrix, vectors[vectorIndex], out_vectors[vectorIndex]);
+#else
+		TransformVector4_Scalar(matrix, vectors[vectorIndex], out_vectors[vectorIndex]);
+#endif
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Computes left * rights[n] for each matrix, output can be the input
+//
+void Matrix44::MultiplyMatrices(const Matrix44& left, const Matrix44* rights, Matrix44* out_results, int count)
+{
+#ifdef MATRIX44_USE_SSE
+	MultiplyMatrices_SSE(left, rights, out_results, count);
+#else
+	for (int matrixIndex = 0; matrixIndex < count; ++matrixIndex)
+	{
+		MultiplyMatrices_Scalar(left, rights[matrixIndex], out_results[matrixIndex]);
+	}
+#endif
+}
 
-	return Matrix44(resultI, resultJ, resultK, resultT);
+
+//-----------------------------------------------------------------------------------------------
+// Interpolates between the two matrices and returns the result
+//
+Matrix44 Interpolate(const Matrix44& start, const Matrix44& end, float fractionTowardEnd)
+{
+	Matrix44 result;
+
+#ifdef MATRIX44_USE_SSE
+	InterpolateMatrices_SSE(start, end, fractionTowardEnd, result);
+#else
+	InterpolateMatrices_Scalar(start, end, fractionTowardEnd, result);
+#endif
+
+	return result;
 }
 
 
@@ -85,6 +85,12 @@ public:
 
 	static Matrix44 GetInverse(const Matrix44& matrix);
 
+	// Batch, for transforming many things by one matrix - outputs can be the inputs
+	static void TransformPoints(const Matrix44& matrix, const Vector3* points, Vector3* out_points, int count);
+	static void TransformVectors(const Matrix44& matrix, const Vector3* vectors, Vector3* out_vectors, int count);
+	static void TransformVector4s(const Matrix44& matrix, const Vector4* vectors, Vector4* out_vectors, int count);
+	static void MultiplyMatrices(const Matrix44& left, const Matrix44* rights, Matrix44* out_results, int count);
+
 
 public:
 	//-----Public data----- 
@@ -0,0 +1,228 @@
+/************************************************************************/
+/* File: Matrix44Benchmark.cpp
+/* Author: Andrew Chase
+/* Date: June 12th, 2019
+/* Description: Implementation of the Matrix44Benchmark class
+/************************************************************************/
+#include <math.h>
+#include "Engine/Core/Time/Time.hpp"
+#include "Engine/Math/Vector4.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomStream.hpp"
+#include "Engine/Math/Matrix44Kernels.hpp"
+#include "Engine/Math/Matrix44Benchmark.hpp"
+#include "Engine/Core/DeveloperConsole/Command.hpp"
+#include "Engine/Core/DeveloperConsole/DevConsole.hpp"
+
+// Console commands
+static void Command_Matrix44Benchmark(Command& cmd);
+
+#ifdef MATRIX44_USE_SSE
+
+//-----------------------------------------------------------------------------------------------
+// Returns the largest difference between the floats, relative to their size when it's above 1
+//
+static float GetMaxError(const float* expected, const float* actual, int count)
+{
+	float maxError = 0.f;
+
+	for (int index = 0; index < count; ++index)
+	{
+		float error = fabsf(expected[index] - actual[index]);
+		float magnitude = fabsf(expected[index]);
+
+		if (magnitude > 1.f)
+		{
+			error /= magnitude;
+		}
+
+		maxError = MaxFloat(maxError, error);
+	}
+
+	return maxError;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Fills the result with the timings and error of two runs that produced the given outputs
+//
+static Matrix44BenchmarkResult_t MakeResult(const char* name, int operationCount, uint64_t scalarCounts, uint64_t simdCounts, const float* scalarOutput, const float* simdOutput, int floatCount)
+{
+	Matrix44BenchmarkResult_t result;
+
+	result.name = name;
+	result.scalarOpsPerSecond = (double)operationCount / TimeSystem::PerformanceCountToSeconds(scalarCounts);
+	result.simdOpsPerSecond = (double)operationCount / TimeSystem::PerformanceCountToSeconds(simdCounts);
+	result.maxError = GetMaxError(scalarOutput, simdOutput, floatCount);
+	result.withinTolerance = (result.maxError <= Matrix44Benchmark::TOLERANCE);
+
+	return result;
+}
+
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs each kernel operationCount times, scalar then SSE, on random well-conditioned transforms
+// Returns nothing if the engine was built without SSE
+//
+std::vector<Matrix44BenchmarkResult_t> Matrix44Benchmark::Run(int operationCount)
+{
+	std::vector<Matrix44BenchmarkResult_t> results;
+
+#ifdef MATRIX44_USE_SSE
+	if (operationCount <= 0)
+	{
+		return results;
+	}
+
+	RandomStream randomStream(1234, 0);
+
+	std::vector<Matrix44> lefts(operationCount);
+	std::vector<Matrix44> rights(operationCount);
+	std::vector<Vector4> vectors(operationCount);
+
+	for (int index = 0; index < operationCount; ++index)
+	{
+		Vector3 translation = randomStream.GetRandomPointInBox(Vector3(-100.f), Vector3(100.f));
+		Vector3 rotation = randomStream.GetRandomPointInBox(Vector3(-180.f), Vector3(180.f));
+		Vector3 scale = randomStream.GetRandomPointInBox(Vector3(0.5f), Vector3(2.f));
+
+		lefts[index] = Matrix44::MakeModelMatrix(translation, rotation, scale);
+		rights[index] = Matrix44::MakeModelMatrix(rotation * 0.1f, translation, Vector3(scale.z, scale.x, scale.y));
+		vectors[index] = Vector4(randomStream.GetRandomPointInBox(Vector3(-10.f), Vector3(10.f)), randomStream.GetRandomFloatZeroToOne());
+	}
+
+	std::vector<Matrix44> scalarMatrices(operationCount);
+	std::vector<Matrix44> simdMatrices(operationCount);
+	std::vector<Vector4> scalarVectors(operationCount);
+	std::vector<Vector4> simdVectors(operationCount);
+
+	int matrixFloatCount = operationCount * 16;
+	int vectorFloatCount = operationCount * 4;
+	uint64_t startHPC, scalarCounts, simdCounts;
+
+	// Multiply
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { MultiplyMatrices_Scalar(lefts[index], rights[index], scalarMatrices[index]); }
+	scalarCounts = GetPerformanceCounter() - startHPC;
+
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { MultiplyMatrices_SSE(lefts[index], rights[index], simdMatrices[index]); }
+	simdCounts = GetPerformanceCounter() - startHPC;
+
+	results.push_back(MakeResult("Multiply", operationCount, scalarCounts, simdCounts, &scalarMatrices[0].Ix, &simdMatrices[0].Ix, matrixFloatCount));
+
+	// Multiply many by one
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { MultiplyMatrices_Scalar(lefts[0], rights[index], scalarMatrices[index]); }
+	scalarCounts = GetPerformanceCounter() - startHPC;
+
+	startHPC = GetPerformanceCounter();
+	MultiplyMatrices_SSE(lefts[0], rights.data(), simdMatrices.data(), operationCount);
+	simdCounts = GetPerformanceCounter() - startHPC;
+
+	results.push_back(MakeResult("Multiply (batch)", operationCount, scalarCounts, simdCounts, &scalarMatrices[0].Ix, &simdMatrices[0].Ix, matrixFloatCount));
+
+	// Inverse
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { InvertMatrix_Scalar(lefts[index], scalarMatrices[index]); }
+	scalarCounts = GetPerformanceCounter() - startHPC;
+
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { InvertMatrix_SSE(lefts[index], simdMatrices[index]); }
+	simdCounts = GetPerformanceCounter() - startHPC;
+
+	results.push_back(MakeResult("Inverse", operationCount, scalarCounts, simdCounts, &scalarMatrices[0].Ix, &simdMatrices[0].Ix, matrixFloatCount));
+
+	// Transpose
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { TransposeMatrix_Scalar(lefts[index], scalarMatrices[index]); }
+	scalarCounts = GetPerformanceCounter() - startHPC;
+
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { TransposeMatrix_SSE(lefts[index], simdMatrices[index]); }
+	simdCounts = GetPerformanceCounter() - startHPC;
+
+	results.push_back(MakeResult("Transpose", operationCount, scalarCounts, simdCounts, &scalarMatrices[0].Ix, &simdMatrices[0].Ix, matrixFloatCount));
+
+	// Interpolate
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { InterpolateMatrices_Scalar(lefts[index], rights[index], 0.3f, scalarMatrices[index]); }
+	scalarCounts = GetPerformanceCounter() - startHPC;
+
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { InterpolateMatrices_SSE(lefts[index], rights[index], 0.3f, simdMatrices[index]); }
+	simdCounts = GetPerformanceCounter() - startHPC;
+
+	results.push_back(MakeResult("Interpolate", operationCount, scalarCounts, simdCounts, &scalarMatrices[0].Ix, &simdMatrices[0].Ix, matrixFloatCount));
+
+	// Transform
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { TransformVector4_Scalar(lefts[index], vectors[index], scalarVectors[index]); }
+	scalarCounts = GetPerformanceCounter() - startHPC;
+
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { TransformVector4_SSE(lefts[index], vectors[index], simdVectors[index]); }
+	simdCounts = GetPerformanceCounter() - startHPC;
+
+	results.push_back(MakeResult("Transform", operationCount, scalarCounts, simdCounts, &scalarVectors[0].x, &simdVectors[0].x, vectorFloatCount));
+
+	// Transform points by one matrix
+	for (int index = 0; index < operationCount; ++index) { vectors[index].w = 1.0f; }
+
+	startHPC = GetPerformanceCounter();
+	for (int index = 0; index < operationCount; ++index) { TransformVector4_Scalar(lefts[0], vectors[index], scalarVectors[index]); }
+	scalarCounts = GetPerformanceCounter() - startHPC;
+
+	startHPC = GetPerformanceCounter();
+	TransformPoints_SSE(lefts[0], &vectors[0].x, 4, &simdVectors[0].x, 4, operationCount, 1.0f);
+	simdCounts = GetPerformanceCounter() - startHPC;
+
+	// The batch only writes xyz, so w is copied over for the comparison
+	for (int index = 0; index < operationCount; ++index) { simdVectors[index].w = scalarVectors[index].w; }
+
+	results.push_back(MakeResult("Transform points (batch)", operationCount, scalarCounts, simdCounts, &scalarVectors[0].x, &simdVectors[0].x, vectorFloatCount));
+#else
+	UNUSED(operationCount);
+#endif
+
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Registers the benchmark console command
+//
+void Matrix44Benchmark::InitializeConsoleCommands()
+{
+	Command::Register("matrix_benchmark", "Compares SSE and scalar Matrix44 kernels over -n operations each", Command_Matrix44Benchmark);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs the benchmark and prints a line per kernel
+//
+static void Command_Matrix44Benchmark(Command& cmd)
+{
+	int operationCount = 100000;
+	cmd.GetParam("n", operationCount, &operationCount);
+
+	std::vector<Matrix44BenchmarkResult_t> results = Matrix44Benchmark::Run(operationCount);
+
+	if (results.size() == 0)
+	{
+		ConsoleWarningf("Matrix44 kernels were built without SSE, nothing to compare");
+		return;
+	}
+
+	for (int resultIndex = 0; resultIndex < (int)results.size(); ++resultIndex)
+	{
+		const Matrix44BenchmarkResult_t& result = results[resultIndex];
+		Rgba color = (result.withinTolerance ? Rgba::GREEN : Rgba::RED);
+
+		ConsolePrintf(color, "%s: %.0f ops/sec scalar, %.0f ops/sec SSE (%.2fx), max error %g",
+			result.name.c_str(), result.scalarOpsPerSecond, result.simdOpsPerSecond, result.simdOpsPerSecond / result.scalarOpsPerSecond, result.maxError);
+	}
+}
@@ -0,0 +1,32 @@
+/************************************************************************/
+/* File: Matrix44Benchmark.hpp
+/* Author: Andrew Chase
+/* Date: June 12th, 2019
+/* Description: Compares the SSE Matrix44 kernels against the scalar
+/*				reference versions for speed and agreement
+/************************************************************************/
+#pragma once
+#include <vector>
+#include <string>
+
+struct Matrix44BenchmarkResult_t
+{
+	std::string	name;
+	double		scalarOpsPerSecond = 0.0;
+	double		simdOpsPerSecond = 0.0;
+	float		maxError = 0.f;			// Largest difference of any element, relative to the element's size when above 1
+	bool		withinTolerance = true;
+};
+
+
+class Matrix44Benchmark
+{
+public:
+	//-----Public Methods-----
+
+	static std::vector<Matrix44BenchmarkResult_t>	Run(int operationCount);
+	static void										InitializeConsoleCommands();
+
+	static constexpr float TOLERANCE = 0.001f;
+
+};
@@ -0,0 +1,525 @@
+/************************************************************************/
+/* File: Matrix44Kernels.cpp
+/* Author: Andrew Chase
+/* Date: June 12th, 2019
+/* Description: Implementation of the Matrix44 kernels
+/************************************************************************/
+#include "Engine/Math/Vector4.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Matrix44Kernels.hpp"
+
+#ifdef MATRIX44_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+// Multiplies left * right, each element a dot of a row of the left with a column of the right
+//
+void MultiplyMatrices_Scalar(const Matrix44& left, const Matrix44& right, Matrix44& out_result)
+{
+	Vector4 leftX = left.GetXVector();
+	Vector4 leftY = left.GetYVector();
+	Vector4 leftZ = left.GetZVector();
+	Vector4 leftW = left.GetWVector();
+
+	Vector4 rightI = right.GetIVector();
+	Vector4 rightJ = right.GetJVector();
+	Vector4 rightK = right.GetKVector();
+	Vector4 rightT = right.GetTVector();
+
+	// New I basis vector
+	out_result.Ix = DotProduct(leftX, rightI);
+	out_result.Iy = DotProduct(leftY, rightI);
+	out_result.Iz = DotProduct(leftZ, rightI);
+	out_result.Iw = DotProduct(leftW, rightI);
+
+	// New J basis vector
+	out_result.Jx = DotProduct(leftX, rightJ);
+	out_result.Jy = DotProduct(leftY, rightJ);
+	out_result.Jz = DotProduct(leftZ, rightJ);
+	out_result.Jw = DotProduct(leftW, rightJ);
+
+	// New K basis vector
+	out_result.Kx = DotProduct(leftX, rightK);
+	out_result.Ky = DotProduct(leftY, rightK);
+	out_result.Kz = DotProduct(leftZ, rightK);
+	out_result.Kw = DotProduct(leftW, rightK);
+
+	// New T basis vector
+	out_result.Tx = DotProduct(leftX, rightT);
+	out_result.Ty = DotProduct(leftY, rightT);
+	out_result.Tz = DotProduct(leftZ, rightT);
+	out_result.Tw = DotProduct(leftW, rightT);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Transforms the vector by the matrix, each component a dot of a row with the vector
+//
+void TransformVector4_Scalar(const Matrix44& matrix, const Vector4& vector, Vector4& out_result)
+{
+	Vector4 result;
+
+	result.x = DotProduct(matrix.GetXVector(), vector);
+	result.y = DotProduct(matrix.GetYVector(), vector);
+	result.z = DotProduct(matrix.GetZVector(), vector);
+	result.w = DotProduct(matrix.GetWVector(), vector);
+
+	out_result = result;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Flips the matrix over its diagonal
+//
+void TransposeMatrix_Scalar(const Matrix44& matrix, Matrix44& out_result)
+{
+	Matrix44 original = matrix;
+
+	out_result = original;
+
+	out_result.Iy = original.Jx;
+	out_result.Jx = original.Iy;
+
+	out_result.Iz = original.Kx;
+	out_result.Kx = original.Iz;
+
+	out_result.Iw = original.Tx;
+	out_result.Tx = original.Iw;
+
+	out_result.Jz = original.Ky;
+	out_result.Ky = original.Jz;
+
+	out_result.Jw = original.Ty;
+	out_result.Ty = original.Jw;
+
+	out_result.Kw = original.Tz;
+	out_result.Tz = original.Kw;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Inverts the matrix by cofactors, computed in double
+//
+void InvertMatrix_Scalar(const Matrix44& matrix, Matrix44& out_result)
+{
+	double inv[16];
+	double det;
+	double m[16];
+
+	m[0]	= (double) matrix.Ix;
+	m[1]	= (double) matrix.Iy;
+	m[2]	= (double) matrix.Iz;
+	m[3]	= (double) matrix.Iw;
+	m[4]	= (double) matrix.Jx;
+	m[5]	= (double) matrix.Jy;
+	m[6]	= (double) matrix.Jz;
+	m[7]	= (double) matrix.Jw;
+	m[8]	= (double) matrix.Kx;
+	m[9]	= (double) matrix.Ky;
+	m[10]	= (double) matrix.Kz;
+	m[11]	= (double) matrix.Kw;
+	m[12]	= (double) matrix.Tx;
+	m[13]	= (double) matrix.Ty;
+	m[14]	= (double) matrix.Tz;
+	m[15]	= (double) matrix.Tw;
+
+	inv[0] = m[5]  * m[10] * m[15] - 
+		m[5]  * m[11] * m[14] - 
+		m[9]  * m[6]  * m[15] + 
+		m[9]  * m[7]  * m[14] +
+		m[13] * m[6]  * m[11] - 
+		m[13] * m[7]  * m[10];
+
+	inv[4] = -m[4]  * m[10] * m[15] + 
+		m[4]  * m[11] * m[14] + 
+		m[8]  * m[6]  * m[15] - 
+		m[8]  * m[7]  * m[14] - 
+		m[12] * m[6]  * m[11] + 
+		m[12] * m[7]  * m[10];
+
+	inv[8] = m[4]  * m[9] * m[15] - 
+		m[4]  * m[11] * m[13] - 
+		m[8]  * m[5] * m[15] + 
+		m[8]  * m[7] * m[13] + 
+		m[12] * m[5] * m[11] - 
+		m[12] * m[7] * m[9];
+
+	inv[12] = -m[4]  * m[9] * m[14] + 
+		m[4]  * m[10] * m[13] +
+		m[8]  * m[5] * m[14] - 
+		m[8]  * m[6] * m[13] - 
+		m[12] * m[5] * m[10] + 
+		m[12] * m[6] * m[9];
+
+	inv[1] = -m[1]  * m[10] * m[15] + 
+		m[1]  * m[11] * m[14] + 
+		m[9]  * m[2] * m[15] - 
+		m[9]  * m[3] * m[14] - 
+		m[13] * m[2] * m[11] + 
+		m[13] * m[3] * m[10];
+
+	inv[5] = m[0]  * m[10] * m[15] - 
+		m[0]  * m[11] * m[14] - 
+		m[8]  * m[2] * m[15] + 
+		m[8]  * m[3] * m[14] + 
+		m[12] * m[2] * m[11] - 
+		m[12] * m[3] * m[10];
+
+	inv[9] = -m[0]  * m[9] * m[15] + 
+		m[0]  * m[11] * m[13] + 
+		m[8]  * m[1] * m[15] - 
+		m[8]  * m[3] * m[13] - 
+		m[12] * m[1] * m[11] + 
+		m[12] * m[3] * m[9];
+
+	inv[13] = m[0]  * m[9] * m[14] - 
+		m[0]  * m[10] * m[13] - 
+		m[8]  * m[1] * m[14] + 
+		m[8]  * m[2] * m[13] + 
+		m[12] * m[1] * m[10] - 
+		m[12] * m[2] * m[9];
+
+	inv[2] = m[1]  * m[6] * m[15] - 
+		m[1]  * m[7] * m[14] - 
+		m[5]  * m[2] * m[15] + 
+		m[5]  * m[3] * m[14] + 
+		m[13] * m[2] * m[7] - 
+		m[13] * m[3] * m[6];
+
+	inv[6] = -m[0]  * m[6] * m[15] + 
+		m[0]  * m[7] * m[14] + 
+		m[4]  * m[2] * m[15] - 
+		m[4]  * m[3] * m[14] - 
+		m[12] * m[2] * m[7] + 
+		m[12] * m[3] * m[6];
+
+	inv[10] = m[0]  * m[5] * m[15] - 
+		m[0]  * m[7] * m[13] - 
+		m[4]  * m[1] * m[15] + 
+		m[4]  * m[3] * m[13] + 
+		m[12] * m[1] * m[7] - 
+		m[12] * m[3] * m[5];
+
+	inv[14] = -m[0]  * m[5] * m[14] + 
+		m[0]  * m[6] * m[13] + 
+		m[4]  * m[1] * m[14] - 
+		m[4]  * m[2] * m[13] - 
+		m[12] * m[1] * m[6] + 
+		m[12] * m[2] * m[5];
+
+	inv[3] = -m[1] * m[6] * m[11] + 
+		m[1] * m[7] * m[10] + 
+		m[5] * m[2] * m[11] - 
+		m[5] * m[3] * m[10] - 
+		m[9] * m[2] * m[7] + 
+		m[9] * m[3] * m[6];
+
+	inv[7] = m[0] * m[6] * m[11] - 
+		m[0] * m[7] * m[10] - 
+		m[4] * m[2] * m[11] + 
+		m[4] * m[3] * m[10] + 
+		m[8] * m[2] * m[7] - 
+		m[8] * m[3] * m[6];
+
+	inv[11] = -m[0] * m[5] * m[11] + 
+		m[0] * m[7] * m[9] + 
+		m[4] * m[1] * m[11] - 
+		m[4] * m[3] * m[9] - 
+		m[8] * m[1] * m[7] + 
+		m[8] * m[3] * m[5];
+
+	inv[15] = m[0] * m[5] * m[10] - 
+		m[0] * m[6] * m[9] - 
+		m[4] * m[1] * m[10] + 
+		m[4] * m[2] * m[9] + 
+		m[8] * m[1] * m[6] - 
+		m[8] * m[2] * m[5];
+
+	det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+	det = 1.0 / det;
+
+	out_result.Ix = (float)(inv[0] * det);
+	out_result.Iy = (float)(inv[1] * det);
+	out_result.Iz = (float)(inv[2] * det);
+	out_result.Iw = (float)(inv[3] * det);
+	out_result.Jx = (float)(inv[4] * det);
+	out_result.Jy = (float)(inv[5] * det);
+	out_result.Jz = (float)(inv[6] * det);
+	out_result.Jw = (float)(inv[7] * det);
+	out_result.Kx = (float)(inv[8] * det);
+	out_result.Ky = (float)(inv[9] * det);
+	out_result.Kz = (float)(inv[10] * det);
+	out_result.Kw = (float)(inv[11] * det);
+	out_result.Tx = (float)(inv[12] * det);
+	out_result.Ty = (float)(inv[13] * det);
+	out_result.Tz = (float)(inv[14] * det);
+	out_result.Tw = (float)(inv[15] * det);
+
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Interpolates each element between the two matrices
+//
+void InterpolateMatrices_Scalar(const Matrix44& start, const Matrix44& end, float fractionTowardEnd, Matrix44& out_result)
+{
+	Vector4 resultI = Interpolate(start.GetIVector(), end.GetIVector(), fractionTowardEnd);
+	Vector4 resultJ = Interpolate(start.GetJVector(), end.GetJVector(), fractionTowardEnd);
+	Vector4 resultK = Interpolate(start.GetKVector(), end.GetKVector(), fractionTowardEnd);
+	Vector4 resultT = Interpolate(start.GetTVector(), end.GetTVector(), fractionTowardEnd);
+
+	out_result = Matrix44(resultI, resultJ, resultK, resultT);
+}
+
+
+#ifdef MATRIX44_USE_SSE
+
+// The matrix is stored basis-major, so each basis vector loads straight into a register
+#define LOAD_I(matrix) _mm_loadu_ps(&(matrix).Ix)
+#define LOAD_J(matrix) _mm_loadu_ps(&(matrix).Jx)
+#define LOAD_K(matrix) _mm_loadu_ps(&(matrix).Kx)
+#define LOAD_T(matrix) _mm_loadu_ps(&(matrix).Tx)
+
+#define SHUFFLE(first, second, x, y, z, w) _mm_shuffle_ps(first, second, _MM_SHUFFLE(w, z, y, x))
+#define SWIZZLE(vector, x, y, z, w) SHUFFLE(vector, vector, x, y, z, w)
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns i * v.x + j * v.y + k * v.z + t * v.w
+//
+static inline __m128 LinearCombination(const __m128& i, const __m128& j, const __m128& k, const __m128& t, const __m128& vector)
+{
+	__m128 result = _mm_mul_ps(i, SWIZZLE(vector, 0, 0, 0, 0));
+	result = _mm_add_ps(result, _mm_mul_ps(j, SWIZZLE(vector, 1, 1, 1, 1)));
+	result = _mm_add_ps(result, _mm_mul_ps(k, SWIZZLE(vector, 2, 2, 2, 2)));
+	result = _mm_add_ps(result, _mm_mul_ps(t, SWIZZLE(vector, 3, 3, 3, 3)));
+
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Multiplies left * right, each result basis is the left's basis combined by the right's basis
+//
+void MultiplyMatrices_SSE(const Matrix44& left, const Matrix44& right, Matrix44& out_result)
+{
+	__m128 leftI = LOAD_I(left);
+	__m128 leftJ = LOAD_J(left);
+	__m128 leftK = LOAD_K(left);
+	__m128 leftT = LOAD_T(left);
+
+	// Load all of the right before storing, in case it is the output
+	__m128 rightI = LOAD_I(right);
+	__m128 rightJ = LOAD_J(right);
+	__m128 rightK = LOAD_K(right);
+	__m128 rightT = LOAD_T(right);
+
+	_mm_storeu_ps(&out_result.Ix, LinearCombination(leftI, leftJ, leftK, leftT, rightI));
+	_mm_storeu_ps(&out_result.Jx, LinearCombination(leftI, leftJ, leftK, leftT, rightJ));
+	_mm_storeu_ps(&out_result.Kx, LinearCombination(leftI, leftJ, leftK, leftT, rightK));
+	_mm_storeu_ps(&out_result.Tx, LinearCombination(leftI, leftJ, leftK, leftT, rightT));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Transforms the vector by the matrix
+//
+void TransformVector4_SSE(const Matrix44& matrix, const Vector4& vector, Vector4& out_result)
+{
+	__m128 result = LinearCombination(LOAD_I(matrix), LOAD_J(matrix), LOAD_K(matrix), LOAD_T(matrix), _mm_loadu_ps(&vector.x));
+	_mm_storeu_ps(&out_result.x, result);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Flips the matrix over its diagonal
+//
+void TransposeMatrix_SSE(const Matrix44& matrix, Matrix44& out_result)
+{
+	__m128 i = LOAD_I(matrix);
+	__m128 j = LOAD_J(matrix);
+	__m128 k = LOAD_K(matrix);
+	__m128 t = LOAD_T(matrix);
+
+	_MM_TRANSPOSE4_PS(i, j, k, t);
+
+	_mm_storeu_ps(&out_result.Ix, i);
+	_mm_storeu_ps(&out_result.Jx, j);
+	_mm_storeu_ps(&out_result.Kx, k);
+	_mm_storeu_ps(&out_result.Tx, t);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// 2x2 helpers for the inverse, each register holds a 2x2 block as (m00, m01, m10, m11)
+//
+static inline __m128 Mat2Multiply(const __m128& first, const __m128& second)
+{
+	return _mm_add_ps(_mm_mul_ps(first, SWIZZLE(second, 0, 3, 0, 3)), _mm_mul_ps(SWIZZLE(first, 1, 0, 3, 2), SWIZZLE(second, 2, 1, 2, 1)));
+}
+
+// Adjugate of the first times the second
+static inline __m128 Mat2AdjugateMultiply(const __m128& first, const __m128& second)
+{
+	return _mm_sub_ps(_mm_mul_ps(SWIZZLE(first, 3, 3, 0, 0), second), _mm_mul_ps(SWIZZLE(first, 1, 1, 2, 2), SWIZZLE(second, 2, 3, 0, 1)));
+}
+
+// First times the adjugate of the second
+static inline __m128 Mat2MultiplyAdjugate(const __m128& first, const __m128& second)
+{
+	return _mm_sub_ps(_mm_mul_ps(first, SWIZZLE(second, 3, 0, 3, 0)), _mm_mul_ps(SWIZZLE(first, 1, 0, 3, 2), SWIZZLE(second, 2, 1, 2, 1)));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Inverts the matrix by splitting it into 2x2 blocks and inverting blockwise
+// Inverting the transpose and transposing back is the same, so this works on the basis vectors directly
+//
+void InvertMatrix_SSE(const Matrix44& matrix, Matrix44& out_result)
+{
+	__m128 i = LOAD_I(matrix);
+	__m128 j = LOAD_J(matrix);
+	__m128 k = LOAD_K(matrix);
+	__m128 t = LOAD_T(matrix);
+
+	// 2x2 blocks
+	__m128 a = _mm_movelh_ps(i, j);
+	__m128 b = _mm_movehl_ps(j, i);
+	__m128 c = _mm_movelh_ps(k, t);
+	__m128 d = _mm_movehl_ps(t, k);
+
+	// Determinants of the blocks as (|A|, |B|, |C|, |D|)
+	__m128 blockDeterminants = _mm_sub_ps(
+		_mm_mul_ps(SHUFFLE(i, k, 0, 2, 0, 2), SHUFFLE(j, t, 1, 3, 1, 3)),
+		_mm_mul_ps(SHUFFLE(i, k, 1, 3, 1, 3), SHUFFLE(j, t, 0, 2, 0, 2)));
+
+	__m128 determinantA = SWIZZLE(blockDeterminants, 0, 0, 0, 0);
+	__m128 determinantB = SWIZZLE(blockDeterminants, 1, 1, 1, 1);
+	__m128 determinantC = SWIZZLE(blockDeterminants, 2, 2, 2, 2);
+	__m128 determinantD = SWIZZLE(blockDeterminants, 3, 3, 3, 3);
+
+	__m128 adjDTimesC = Mat2AdjugateMultiply(d, c);
+	__m128 adjATimesB = Mat2AdjugateMultiply(a, b);
+
+	// Adjugates of the result's blocks, before dividing by the determinant
+	__m128 x = _mm_sub_ps(_mm_mul_ps(determinantD, a), Mat2Multiply(b, adjDTimesC));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(determinantA, d), Mat2Multiply(c, adjATimesB));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(determinantB, c), Mat2MultiplyAdjugate(d, adjATimesB));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(determinantC, b), Mat2MultiplyAdjugate(a, adjDTimesC));
+
+	// |M| = |A||D| + |B||C| - trace((A#B)(D#C))
+	__m128 trace = _mm_mul_ps(adjATimesB, SWIZZLE(adjDTimesC, 0, 2, 1, 3));
+	trace = _mm_add_ps(trace, SWIZZLE(trace, 2, 3, 0, 1));
+	trace = _mm_add_ps(trace, SWIZZLE(trace, 1, 0, 3, 2));
+
+	__m128 determinant = _mm_add_ps(_mm_mul_ps(determinantA, determinantD), _mm_mul_ps(determinantB, determinantC));
+	determinant = _mm_sub_ps(determinant, trace);
+
+	__m128 reciprocalDeterminant = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), determinant);
+
+	x = _mm_mul_ps(x, reciprocalDeterminant);
+	y = _mm_mul_ps(y, reciprocalDeterminant);
+	z = _mm_mul_ps(z, reciprocalDeterminant);
+	w = _mm_mul_ps(w, reciprocalDeterminant);
+
+	// Applying the adjugate swizzle and reassembling the blocks into basis vectors
+	_mm_storeu_ps(&out_result.Ix, SHUFFLE(x, y, 3, 1, 3, 1));
+	_mm_storeu_ps(&out_result.Jx, SHUFFLE(x, y, 2, 0, 2, 0));
+	_mm_storeu_ps(&out_result.Kx, SHUFFLE(z, w, 3, 1, 3, 1));
+	_mm_storeu_ps(&out_result.Tx, SHUFFLE(z, w, 2, 0, 2, 0));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Interpolates each element between the two matrices
+//
+void InterpolateMatrices_SSE(const Matrix44& start, const Matrix44& end, float fractionTowardEnd, Matrix44& out_result)
+{
+	__m128 fraction = _mm_set1_ps(fractionTowardEnd);
+
+	__m128 startI = LOAD_I(start);
+	__m128 startJ = LOAD_J(start);
+	__m128 startK = LOAD_K(start);
+	__m128 startT = LOAD_T(start);
+
+	__m128 endI = LOAD_I(end);
+	__m128 endJ = LOAD_J(end);
+	__m128 endK = LOAD_K(end);
+	__m128 endT = LOAD_T(end);
+
+	_mm_storeu_ps(&out_result.Ix, _mm_add_ps(startI, _mm_mul_ps(_mm_sub_ps(endI, startI), fraction)));
+	_mm_storeu_ps(&out_result.Jx, _mm_add_ps(startJ, _mm_mul_ps(_mm_sub_ps(endJ, startJ), fraction)));
+	_mm_storeu_ps(&out_result.Kx, _mm_add_ps(startK, _mm_mul_ps(_mm_sub_ps(endK, startK), fraction)));
+	_mm_storeu_ps(&out_result.Tx, _mm_add_ps(startT, _mm_mul_ps(_mm_sub_ps(endT, startT), fraction)));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Transforms count 3-component points (or vectors, with w = 0) by the matrix
+// Points are read and written with the given strides, so this works on arrays of vertex structs too
+//
+void TransformPoints_SSE(const Matrix44& matrix, const float* points, int pointStrideFloats, float* out_points, int outStrideFloats, int count, float w)
+{
+	__m128 i = LOAD_I(matrix);
+	__m128 j = LOAD_J(matrix);
+	__m128 k = LOAD_K(matrix);
+	__m128 t = _mm_mul_ps(LOAD_T(matrix), _mm_set1_ps(w));
+
+	float result[4];
+
+	for (int pointIndex = 0; pointIndex < count; ++pointIndex)
+	{
+		const float* point = points + pointIndex * pointStrideFloats;
+
+		__m128 transformed = _mm_add_ps(_mm_mul_ps(i, _mm_set1_ps(point[0])), t);
+		transformed = _mm_add_ps(transformed, _mm_mul_ps(j, _mm_set1_ps(point[1])));
+		transformed = _mm_add_ps(transformed, _mm_mul_ps(k, _mm_set1_ps(point[2])));
+
+		_mm_storeu_ps(result, transformed);
+
+		float* outPoint = out_points + pointIndex * outStrideFloats;
+		outPoint[0] = result[0];
+		outPoint[1] = result[1];
+		outPoint[2] = result[2];
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Multiplies left * rights[n] for every n, keeping the left in registers
+//
+void MultiplyMatrices_SSE(const Matrix44& left, const Matrix44* rights, Matrix44* out_results, int count)
+{
+	__m128 leftI = LOAD_I(left);
+	__m128 leftJ = LOAD_J(left);
+	__m128 leftK = LOAD_K(left);
+	__m128 leftT = LOAD_T(left);
+
+	for (int matrixIndex = 0; matrixIndex < count; ++matrixIndex)
+	{
+		const Matrix44& right = rights[matrixIndex];
+		Matrix44& result = out_results[matrixIndex];
+
+		__m128 rightI = LOAD_I(right);
+		__m128 rightJ = LOAD_J(right);
+		__m128 rightK = LOAD_K(right);
+		__m128 rightT = LOAD_T(right);
+
+		_mm_storeu_ps(&result.Ix, LinearCombination(leftI, leftJ, leftK, leftT, rightI));
+		_mm_storeu_ps(&result.Jx, LinearCombination(leftI, leftJ, leftK, leftT, rightJ));
+		_mm_storeu_ps(&result.Kx, LinearCombination(leftI, leftJ, leftK, leftT, rightK));
+		_mm_storeu_ps(&result.Tx, LinearCombination(leftI, leftJ, leftK, leftT, rightT));
+	}
+}
+
+#undef LOAD_I
+#undef LOAD_J
+#undef LOAD_K
+#undef LOAD_T
+#undef SHUFFLE
+#undef SWIZZLE
+
+#endif // MATRIX44_USE_SSE
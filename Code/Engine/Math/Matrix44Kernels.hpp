@@ -0,0 +1,38 @@
+/************************************************************************/
+/* File: Matrix44Kernels.hpp
+/* Author: Andrew Chase
+/* Date: June 12th, 2019
+/* Description: Scalar and SSE versions of the Matrix44 operations that
+/*				run the most, Matrix44 picks one at compile time
+/************************************************************************/
+#pragma once
+
+class Matrix44;
+class Vector4;
+
+// Define ENGINE_DISABLE_SIMD to build with the scalar versions only
+#if !defined(ENGINE_DISABLE_SIMD) && (defined(_M_X64) || defined(__SSE__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define MATRIX44_USE_SSE
+#endif
+
+// All kernels allow the output to be one of the inputs
+
+// Scalar, the reference versions
+void	MultiplyMatrices_Scalar(const Matrix44& left, const Matrix44& right, Matrix44& out_result);
+void	TransformVector4_Scalar(const Matrix44& matrix, const Vector4& vector, Vector4& out_result);
+void	TransposeMatrix_Scalar(const Matrix44& matrix, Matrix44& out_result);
+void	InvertMatrix_Scalar(const Matrix44& matrix, Matrix44& out_result);
+void	InterpolateMatrices_Scalar(const Matrix44& start, const Matrix44& end, float fractionTowardEnd, Matrix44& out_result);
+
+#ifdef MATRIX44_USE_SSE
+// SSE, inverse is done in float so differs from the scalar (double) version by rounding
+void	MultiplyMatrices_SSE(const Matrix44& left, const Matrix44& right, Matrix44& out_result);
+void	TransformVector4_SSE(const Matrix44& matrix, const Vector4& vector, Vector4& out_result);
+void	TransposeMatrix_SSE(const Matrix44& matrix, Matrix44& out_result);
+void	InvertMatrix_SSE(const Matrix44& matrix, Matrix44& out_result);
+void	InterpolateMatrices_SSE(const Matrix44& start, const Matrix44& end, float fractionTowardEnd, Matrix44& out_result);
+
+// Batch, one matrix against many
+void	TransformPoints_SSE(const Matrix44& matrix, const float* points, int pointStrideFloats, float* out_points, int outStrideFloats, int count, float w);
+void	MultiplyMatrices_SSE(const Matrix44& left, const Matrix44* rights, Matrix44* out_results, int count);
+#endif
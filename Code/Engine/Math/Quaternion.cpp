@@ -129,6 +129,23 @@ Quaternion Quaternion::Lerp(const Quaternion& a, const Quaternion& b, float frac
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Linearly interpolates along the shorter arc and renormalizes
+// Doesn't move at a constant angular rate like Slerp, but is much cheaper and close for small angles
+//
+Quaternion Quaternion::Nlerp(const Quaternion& start, const Quaternion& end, float fractionTowardEnd)
+{
+	float endScale = (DotProduct(start, end) < 0.f ? -fractionTowardEnd : fractionTowardEnd);
+	float startScale = 1.0f - fractionTowardEnd;
+
+	Quaternion result;
+	result.s = startScale * start.s + endScale * end.s;
+	result.v = startScale * start.v + endScale * end.v;
+
+	return result.GetNormalized();
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // *= operator
 //
@@ -303,6 +320,61 @@ Quaternion Quaternion::FromEuler(const Vector3& eulerAnglesDegrees)
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Constructs a Quaternion from the rotation in the matrix, ignoring any translation or scale
+//
+Quaternion Quaternion::FromMatrix(const Matrix44& matrix)
+{
+	// Remove scale from the basis vectors
+	Vector3 i = Vector3(matrix.Ix, matrix.Iy, matrix.Iz);
+	Vector3 j = Vector3(matrix.Jx, matrix.Jy, matrix.Jz);
+	Vector3 k = Vector3(matrix.Kx, matrix.Ky, matrix.Kz);
+
+	i.NormalizeAndGetLength();
+	j.NormalizeAndGetLength();
+	k.NormalizeAndGetLength();
+
+	// Branch on the largest of w, x, y and z so we never divide by something near zero
+	float trace = i.x + j.y + k.z;
+	Quaternion result;
+
+	if (trace > 0.f)
+	{
+		float scale = 2.0f * sqrtf(trace + 1.0f);
+		result.s = 0.25f * scale;
+		result.v.x = (j.z - k.y) / scale;
+		result.v.y = (k.x - i.z) / scale;
+		result.v.z = (i.y - j.x) / scale;
+	}
+	else if (i.x > j.y && i.x > k.z)
+	{
+		float scale = 2.0f * sqrtf(1.0f + i.x - j.y - k.z);
+		result.s = (j.z - k.y) / scale;
+		result.v.x = 0.25f * scale;
+		result.v.y = (j.x + i.y) / scale;
+		result.v.z = (k.x + i.z) / scale;
+	}
+	else if (j.y > k.z)
+	{
+		float scale = 2.0f * sqrtf(1.0f + j.y - i.x - k.z);
+		result.s = (k.x - i.z) / scale;
+		result.v.x = (j.x + i.y) / scale;
+		result.v.y = 0.25f * scale;
+		result.v.z = (k.y + j.z) / scale;
+	}
+	else
+	{
+		float scale = 2.0f * sqrtf(1.0f + k.z - i.x - j.y);
+		result.s = (i.y - j.x) / scale;
+		result.v.x = (k.x + i.z) / scale;
+		result.v.y = (k.y + j.z) / scale;
+		result.v.z = 0.25f * scale;
+	}
+
+	return result.GetNormalized();
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Returns the quaternion rotation between start and end, moving a maximum of maxAngleDegrees from start
 //
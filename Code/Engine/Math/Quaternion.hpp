@@ -4,8 +4,11 @@
 /* Date: June 12th, 2018
 /* Description: Class to represent a Quaternion rotation
 /************************************************************************/
+#pragma once
 #include "Engine/Math/Vector3.hpp"
 
+class Matrix44;
+
 class Quaternion
 {
 public:
@@ -45,9 +48,11 @@ public:
 
 	static float		GetAngleBetweenDegrees(const Quaternion& a, const Quaternion& b);
 	static Quaternion	FromEuler(const Vector3& eulerAnglesDegrees);
+	static Quaternion	FromMatrix(const Matrix44& matrix);
 	static Quaternion	RotateToward(const Quaternion& start, const Quaternion& end, float maxAngleDegrees);
 
 	static Quaternion Lerp(const Quaternion& a, const Quaternion& b, float fractionTowardEnd);
+	static Quaternion Nlerp(const Quaternion& start, const Quaternion& end, float fractionTowardEnd);
 	static Quaternion Slerp(const Quaternion& start, const Quaternion& end, float fractionTowardEnd);
 
 
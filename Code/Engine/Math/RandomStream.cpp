@@ -0,0 +1,148 @@
+/************************************************************************/
+/* File: RandomStream.cpp
+/* Author: Andrew Chase
+/* Date: June 6th, 2019
+/* Description: Implementation of the RandomStream class
+/************************************************************************/
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomStream.hpp"
+#include <math.h>
+
+// 1 / 2^24, for turning the top 24 bits of a result into a float in [0, 1)
+static constexpr float ONE_OVER_2_TO_THE_24 = 1.0f / 16777216.0f;
+
+
+//-----------------------------------------------------------------------------------------------
+// Constructor
+//
+RandomStream::RandomStream(uint64_t seed /*= 0*/, uint64_t streamID /*= 0*/)
+{
+	SetSeed(seed, streamID);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Restarts the sequence; streams with the same seed but different IDs produce unrelated sequences
+//
+void RandomStream::SetSeed(uint64_t seed, uint64_t streamID /*= 0*/)
+{
+	m_state = 0;
+	m_increment = (streamID << 1u) | 1u;
+
+	GetNextUInt();
+	m_state += seed;
+	GetNextUInt();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Advances the state and returns the next 32 random bits
+//
+uint32_t RandomStream::GetNextUInt()
+{
+	uint64_t oldState = m_state;
+	m_state = oldState * 6364136223846793005ULL + m_increment;
+
+	uint32_t xorShifted = (uint32_t)(((oldState >> 18u) ^ oldState) >> 27u);
+	uint32_t rotation = (uint32_t)(oldState >> 59u);
+
+	return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1u) & 31u));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a float in [0, 1)
+//
+float RandomStream::GetRandomFloatZeroToOne()
+{
+	return (float)(GetNextUInt() >> 8u) * ONE_OVER_2_TO_THE_24;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a float between min and max
+//
+float RandomStream::GetRandomFloatInRange(float minInclusive, float maxInclusive)
+{
+	return minInclusive + (maxInclusive - minInclusive) * GetRandomFloatZeroToOne();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns an int between min and max, inclusive of both
+//
+int RandomStream::GetRandomIntInRange(int minInclusive, int maxInclusive)
+{
+	if (maxInclusive <= minInclusive)
+	{
+		return minInclusive;
+	}
+
+	uint32_t rangeSize = (uint32_t)(maxInclusive - minInclusive) + 1u;
+	return minInclusive + (int)(GetNextUInt() % rangeSize);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a unit vector uniformly distributed over the sphere
+//
+Vector3 RandomStream::GetRandomPointOnSphere()
+{
+	float z = GetRandomFloatInRange(-1.f, 1.f);
+	float azimuthDegrees = GetRandomFloatInRange(0.f, 360.f);
+	float radiusInXY = sqrtf(1.f - z * z);
+
+	return Vector3(radiusInXY * CosDegrees(azimuthDegrees), radiusInXY * SinDegrees(azimuthDegrees), z);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a point with each component picked independently between the box's bounds
+//
+Vector3 RandomStream::GetRandomPointInBox(const Vector3& mins, const Vector3& maxs)
+{
+	float x = GetRandomFloatInRange(mins.x, maxs.x);
+	float y = GetRandomFloatInRange(mins.y, maxs.y);
+	float z = GetRandomFloatInRange(mins.z, maxs.z);
+
+	return Vector3(x, y, z);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Writes count random floats in the range into the array
+//
+void RandomStream::FillFloatsInRange(float* out_values, int count, float minInclusive, float maxInclusive)
+{
+	if (minInclusive == maxInclusive)
+	{
+		for (int valueIndex = 0; valueIndex < count; ++valueIndex)
+		{
+			out_values[valueIndex] = minInclusive;
+		}
+
+		return;
+	}
+
+	// Bits are generated in chunks on the stack, then converted in a loop with no dependency between elements
+	constexpr int CHUNK_SIZE = 64;
+	uint32_t randomBits[CHUNK_SIZE];
+
+	float scale = (maxInclusive - minInclusive) * ONE_OVER_2_TO_THE_24;
+
+	for (int chunkStart = 0; chunkStart < count; chunkStart += CHUNK_SIZE)
+	{
+		int chunkCount = (count - chunkStart < CHUNK_SIZE ? count - chunkStart : CHUNK_SIZE);
+
+		for (int bitsIndex = 0; bitsIndex < chunkCount; ++bitsIndex)
+		{
+			randomBits[bitsIndex] = GetNextUInt() >> 8u;
+		}
+
+		float* chunkValues = out_values + chunkStart;
+		for (int bitsIndex = 0; bitsIndex < chunkCount; ++bitsIndex)
+		{
+			chunkValues[bitsIndex] = minInclusive + (float)randomBits[bitsIndex] * scale;
+		}
+	}
+}
@@ -0,0 +1,40 @@
+/************************************************************************/
+/* File: RandomStream.hpp
+/* Author: Andrew Chase
+/* Date: June 6th, 2019
+/* Description: Seeded random number generator (PCG32) with its own state,
+/*				so each owner gets a reproducible sequence that is safe
+/*				to draw from on any one thread at a time
+/************************************************************************/
+#pragma once
+#include <stdint.h>
+#include "Engine/Math/Vector3.hpp"
+
+
+class RandomStream
+{
+public:
+	//-----Public Methods-----
+
+	RandomStream(uint64_t seed = 0, uint64_t streamID = 0);
+
+	void		SetSeed(uint64_t seed, uint64_t streamID = 0);
+
+	uint32_t	GetNextUInt();
+	float		GetRandomFloatZeroToOne();									// [0, 1)
+	float		GetRandomFloatInRange(float minInclusive, float maxInclusive);
+	int			GetRandomIntInRange(int minInclusive, int maxInclusive);
+	Vector3		GetRandomPointOnSphere();									// Random unit vector
+	Vector3		GetRandomPointInBox(const Vector3& mins, const Vector3& maxs);
+
+	// Fills contiguous arrays, for writing straight into structure-of-arrays data
+	void		FillFloatsInRange(float* out_values, int count, float minInclusive, float maxInclusive);
+
+
+private:
+	//-----Private Data-----
+
+	uint64_t m_state = 0;
+	uint64_t m_increment = 1;	// Must be odd
+
+};
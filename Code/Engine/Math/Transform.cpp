@@ -6,15 +6,15 @@
 /************************************************************************/
 #include "Engine/Math/Transform.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/TransformHierarchy.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 
 //-----------------------------------------------------------------------------------------------
 // Constructor from position, rotation, and scale
 //
-Transform::Transform(const Vector3& position, const Vector3& rotationP, const Vector3& scale)
-	: position(position), rotation(rotationP), scale(scale)
+Transform::Transform(const Vector3& position, const Vector3& rotation, const Vector3& scale)
+	: m_position(position), m_rotation(rotation), m_scale(scale)
 {
-	CheckAndUpdateLocalMatrix();
 }
 
 
@@ -23,7 +23,36 @@ Transform::Transform(const Vector3& position, const Vector3& rotationP, const Ve
 //
 Transform::Transform()
 {
-	CheckAndUpdateLocalMatrix();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Copy constructor - the copy has the same parent, but none of the children and isn't in a hierarchy
+//
+Transform::Transform(const Transform& copy)
+	: m_position(copy.m_position), m_rotation(copy.m_rotation), m_scale(copy.m_scale)
+{
+	SetParentTransform(copy.m_parentTransform);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Destructor - detaches from the parent and hierarchy, and orphans any children
+//
+Transform::~Transform()
+{
+	if (m_hierarchy != nullptr)
+	{
+		m_hierarchy->RemoveTransform(this);
+	}
+
+	SetParentTransform(nullptr);
+
+	// Children become roots rather than pointing at freed memory
+	while (m_childTransforms.size() > 0)
+	{
+		m_childTransforms.back()->SetParentTransform(nullptr);
+	}
 }
 
 
@@ -32,9 +61,7 @@ Transform::Transform()
 //
 void Transform::operator=(const Transform& copyFrom)
 {
-	position = copyFrom.position;
-	rotation = copyFrom.rotation;
-	scale = copyFrom.scale;
+	SetLocalTransform(copyFrom.m_position, copyFrom.m_rotation, copyFrom.m_scale);
 }
 
 
@@ -43,16 +70,18 @@ void Transform::operator=(const Transform& copyFrom)
 //
 void Transform::SetPosition(const Vector3& newPosition)
 {
-	position = newPosition;
+	m_position = newPosition;
+	MarkLocalMatrixDirty();
 }
- 
+
 
 //-----------------------------------------------------------------------------------------------
 // Sets the rotation of the transform
 //
 void Transform::SetRotation(const Vector3& newRotation)
 {
-	rotation = newRotation;
+	m_rotation = newRotation;
+	MarkLocalMatrixDirty();
 }
 
 
@@ -61,20 +90,38 @@ void Transform::SetRotation(const Vector3& newRotation)
 //
 void Transform::SetScale(const Vector3& newScale)
 {
-	scale = newScale;
+	m_scale = newScale;
+	MarkLocalMatrixDirty();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets the position, rotation, and scale at once, only dirtying the transform once
+//
+void Transform::SetLocalTransform(const Vector3& newPosition, const Vector3& newRotation, const Vector3& newScale)
+{
+	m_position = newPosition;
+	m_rotation = newRotation;
+	m_scale = newScale;
+
+	MarkLocalMatrixDirty();
 }
 
 
 //-----------------------------------------------------------------------------------------------
 // Sets the model matrix for this transform, updating its position, rotation, and scale
+// The matrix is kept as given, not rebuilt from the extracted values
 //
 void Transform::SetModelMatrix(const Matrix44& model)
 {
+	m_position	= Matrix44::ExtractTranslation(model);
+	m_rotation	= Matrix44::ExtractRotationDegrees(model);
+	m_scale		= Matrix44::ExtractScale(model);
+
 	m_localMatrix = model;
+	m_isLocalMatrixDirty = false;
 
-	position	= Matrix44::ExtractTranslation(model);
-	rotation	= Matrix44::ExtractRotationDegrees(model);
-	scale		= Matrix44::ExtractScale(model);
+	MarkWorldMatrixDirty();
 }
 
 
@@ -83,7 +130,28 @@ void Transform::SetModelMatrix(const Matrix44& model)
 //
 void Transform::SetParentTransform(Transform* parent)
 {
+	if (parent == m_parentTransform)
+	{
+		return;
+	}
+
+	if (m_parentTransform != nullptr)
+	{
+		m_parentTransform->RemoveChild(this);
+	}
+
 	m_parentTransform = parent;
+
+	if (m_parentTransform != nullptr)
+	{
+		m_parentTransform->AddChild(this);
+	}
+
+	// Force the whole subtree dirty, even if this one was already
+	m_isWorldMatrixDirty = false;
+	MarkWorldMatrixDirty();
+
+	OnHierarchyChanged();
 }
 
 
@@ -92,7 +160,7 @@ void Transform::SetParentTransform(Transform* parent)
 //
 void Transform::TranslateWorld(const Vector3& worldTranslation)
 {
-	position += worldTranslation;
+	SetPosition(m_position + worldTranslation);
 }
 
 
@@ -107,18 +175,16 @@ void Transform::TranslateLocal(const Vector3& localTranslation)
 
 
 //-----------------------------------------------------------------------------------------------
-// Rotates the translation by deltaRotation
+// Rotates the transform by deltaRotation, keeping each angle between 0 and 360
 //
 void Transform::Rotate(const Vector3& deltaRotation)
 {
-	CheckAndUpdateLocalMatrix();
-
-	Vector3 oldRotation = Matrix44::ExtractRotationDegrees(m_localMatrix);
-
 	Vector3 newRotation;
-	newRotation.x = GetAngleBetweenZeroThreeSixty(oldRotation.x + deltaRotation.x);
-	newRotation.y = GetAngleBetweenZeroThreeSixty(oldRotation.y + deltaRotation.y);
-	newRotation.z = GetAngleBetweenZeroThreeSixty(oldRotation.z + deltaRotation.z);
+	newRotation.x = GetAngleBetweenZeroThreeSixty(m_rotation.x + deltaRotation.x);
+	newRotation.y = GetAngleBetweenZeroThreeSixty(m_rotation.y + deltaRotation.y);
+	newRotation.z = GetAngleBetweenZeroThreeSixty(m_rotation.z + deltaRotation.z);
+
+	SetRotation(newRotation);
 }
 
 
@@ -127,45 +193,111 @@ void Transform::Rotate(const Vector3& deltaRotation)
 //
 void Transform::Scale(const Vector3& deltaScale)
 {
-	scale.x *= deltaScale.x;
-	scale.y *= deltaScale.y;
-	scale.z *= deltaScale.z;
+	SetScale(Vector3(m_scale.x * deltaScale.x, m_scale.y * deltaScale.y, m_scale.z * deltaScale.z));
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Returns the model matrix of this transform, recalculating it if it's outdated
+// Returns the position relative to the parent
 //
-Matrix44 Transform::GetLocalMatrix()
+const Vector3& Transform::GetPosition() const
 {
-	CheckAndUpdateLocalMatrix();
-	return m_localMatrix;
+	return m_position;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Returns the matrix that transforms this space to absolute world space
+// Returns the rotation relative to the parent, as Euler angles in degrees
 //
-Matrix44 Transform::GetWorldMatrix()
+const Vector3& Transform::GetRotation() const
 {
-	CheckAndUpdateLocalMatrix();
+	return m_rotation;
+}
 
-	if (m_parentTransform != nullptr)
+
+//-----------------------------------------------------------------------------------------------
+// Returns the scale relative to the parent
+//
+const Vector3& Transform::GetScale() const
+{
+	return m_scale;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the parent transform, or nullptr if this is a root
+//
+Transform* Transform::GetParentTransform() const
+{
+	return m_parentTransform;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of transforms parented directly to this one
+//
+int Transform::GetChildCount() const
+{
+	return (int)m_childTransforms.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the child at the given index
+//
+Transform* Transform::GetChild(int childIndex) const
+{
+	return m_childTransforms[childIndex];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the world matrix will be recalculated on the next read or hierarchy update
+//
+bool Transform::IsWorldMatrixDirty() const
+{
+	return m_isWorldMatrixDirty;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the model matrix of this transform, recalculating it if it's outdated
+//
+const Matrix44& Transform::GetLocalMatrix() const
+{
+	if (m_isLocalMatrixDirty)
 	{
-		Matrix44 parentWorld = m_parentTransform->GetWorldMatrix();
-		return parentWorld * m_localMatrix;
+		UpdateLocalMatrix();
 	}
-	else
+
+	return m_localMatrix;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the matrix that transforms this space to absolute world space
+// Only walks up to the parent if this one is dirty, which means something above changed
+//
+const Matrix44& Transform::GetWorldMatrix() const
+{
+	if (m_isWorldMatrixDirty)
 	{
-		return m_localMatrix;
+		if (m_parentTransform != nullptr)
+		{
+			m_parentTransform->GetWorldMatrix();
+		}
+
+		UpdateWorldMatrixFromParent();
 	}
+
+	return m_worldMatrix;
 }
 
 
 //-----------------------------------------------------------------------------------------------
 // Returns the parent's matrix transformation, from parent space to world space
 //
-Matrix44 Transform::GetParentsToWorldMatrix()
+Matrix44 Transform::GetParentsToWorldMatrix() const
 {
 	if (m_parentTransform != nullptr)
 	{
@@ -179,7 +311,7 @@ Matrix44 Transform::GetParentsToWorldMatrix()
 //-----------------------------------------------------------------------------------------------
 // Returns the world right vector for this transform
 //
-Vector3 Transform::GetIVector()
+Vector3 Transform::GetIVector() const
 {
 	return GetWorldMatrix().GetIVector().xyz();
 }
@@ -188,7 +320,7 @@ Vector3 Transform::GetIVector()
 //-----------------------------------------------------------------------------------------------
 // Returns the world up vector for this transform
 //
-Vector3 Transform::GetJVector()
+Vector3 Transform::GetJVector() const
 {
 	return GetWorldMatrix().GetJVector().xyz();
 }
@@ -197,7 +329,7 @@ Vector3 Transform::GetJVector()
 //-----------------------------------------------------------------------------------------------
 // Returns the world forward vector for this transform
 //
-Vector3 Transform::GetKVector()
+Vector3 Transform::GetKVector() const
 {
 	return GetWorldMatrix().GetKVector().xyz();
 }
@@ -206,49 +338,122 @@ Vector3 Transform::GetKVector()
 //-----------------------------------------------------------------------------------------------
 // Returns the world position of the transform
 //
-Vector3 Transform::GetWorldPosition()
+Vector3 Transform::GetWorldPosition() const
 {
-	CheckAndUpdateLocalMatrix();
-
-	Matrix44 toWorldMatrix = GetWorldMatrix();
-	return Matrix44::ExtractTranslation(toWorldMatrix);
+	return Matrix44::ExtractTranslation(GetWorldMatrix());
 }
 
 
 //-----------------------------------------------------------------------------------------------
 // Returns the world rotation of the transform, as Euler angles in degrees
 //
-Vector3 Transform::GetWorldRotation()
+Vector3 Transform::GetWorldRotation() const
 {
-	CheckAndUpdateLocalMatrix();
+	return Matrix44::ExtractRotationDegrees(GetWorldMatrix());
+}
+
 
-	Matrix44 toWorldMatrix = GetWorldMatrix();
-	return Matrix44::ExtractRotationDegrees(toWorldMatrix);
+//-----------------------------------------------------------------------------------------------
+// Flags the local matrix for rebuilding, which also makes this and everything below it dirty in world space
+//
+void Transform::MarkLocalMatrixDirty()
+{
+	m_isLocalMatrixDirty = true;
+	MarkWorldMatrixDirty();
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Recalculates the model matrix of this transform given its current position, rotation, and scale
+// Flags this and all descendants' world matrices as dirty
+// A clean transform always has clean ancestors, so a dirty one's subtree is already all dirty
+// and the walk can stop there
 //
-void Transform::CheckAndUpdateLocalMatrix()
+void Transform::MarkWorldMatrixDirty()
 {
-	// Check if it needs to be updated first
-	bool translationUpToDate	= AreMostlyEqual(position, m_oldPosition);
-	bool rotationUpToDate		= AreMostlyEqual(rotation, m_oldRotation);
-	bool scaleUpToDate			= AreMostlyEqual(scale, m_oldScale);
+	if (m_isWorldMatrixDirty)
+	{
+		return;
+	}
+
+	m_isWorldMatrixDirty = true;
 
-	// If any out of date, recalculate the matrix
-	if (!translationUpToDate || !rotationUpToDate || !scaleUpToDate)
+	for (int childIndex = 0; childIndex < (int)m_childTransforms.size(); ++childIndex)
 	{
-		Matrix44 translationMatrix	= Matrix44::MakeTranslation(position);
-		Matrix44 rotationMatrix		= Matrix44::MakeRotation(rotation);
-		Matrix44 scaleMatrix		= Matrix44::MakeScale(scale);
+		m_childTransforms[childIndex]->MarkWorldMatrixDirty();
+	}
+}
 
-		m_localMatrix = translationMatrix * rotationMatrix * scaleMatrix;
 
-		// Set old values for the next call
-		m_oldPosition = position;
-		m_oldRotation = rotation;
-		m_oldScale = scale;
+//-----------------------------------------------------------------------------------------------
+// Rebuilds the local matrix from the position, rotation, and scale
+//
+void Transform::UpdateLocalMatrix() const
+{
+	Matrix44 translationMatrix	= Matrix44::MakeTranslation(m_position);
+	Matrix44 rotationMatrix		= Matrix44::MakeRotation(m_rotation);
+	Matrix44 scaleMatrix		= Matrix44::MakeScale(m_scale);
+
+	m_localMatrix = translationMatrix * rotationMatrix * scaleMatrix;
+	m_isLocalMatrixDirty = false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Rebuilds the world matrix from the parent's cached one
+// Doesn't touch any other transform, so it's safe to call on many siblings at once from different threads
+//
+void Transform::UpdateWorldMatrixFromParent() const
+{
+	if (m_isLocalMatrixDirty)
+	{
+		UpdateLocalMatrix();
+	}
+
+	if (m_parentTransform != nullptr)
+	{
+		m_worldMatrix = m_parentTransform->m_worldMatrix * m_localMatrix;
+	}
+	else
+	{
+		m_worldMatrix = m_localMatrix;
+	}
+
+	m_isWorldMatrixDirty = false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the transform to this one's child list
+//
+void Transform::AddChild(Transform* child)
+{
+	m_childTransforms.push_back(child);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the transform from this one's child list
+//
+void Transform::RemoveChild(Transform* child)
+{
+	for (int childIndex = 0; childIndex < (int)m_childTransforms.size(); ++childIndex)
+	{
+		if (m_childTransforms[childIndex] == child)
+		{
+			m_childTransforms.erase(m_childTransforms.begin() + childIndex);
+			return;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Lets the hierarchy know its update order needs to be rebuilt
+//
+void Transform::OnHierarchyChanged()
+{
+	if (m_hierarchy != nullptr)
+	{
+		m_hierarchy->MarkOrderDirty();
 	}
 }
@@ -5,22 +5,36 @@
 /* Description: Class to represent a Translation/Rotation/Scale in 3D
 /************************************************************************/
 #pragma once
+#include <vector>
 #include "Engine/Math/Vector3.hpp"
 #include "Engine/Math/Matrix44.hpp"
 
+class TransformHierarchy;
+
+// Local and world matrices are cached and only rebuilt when something they depend on changes
+// Changing a transform marks it and all of its descendants dirty, so reads never walk the parent chain
+// unless something above actually moved
 class Transform
 {
+	friend class TransformHierarchy;
+	friend class TransformUpdateJob;
+
 public:
 	//-----Public Methods-----
 
 	Transform();
 	Transform(const Vector3& startPosition, const Vector3& startRotation, const Vector3& startScale);
+	Transform(const Transform& copy);
+	~Transform();
+
+	// Copies position, rotation, and scale only - parent, children, and hierarchy are kept
 	void operator=(const Transform& copyFrom);
 
 	// Mutators
 	void SetPosition(const Vector3& newPosition);
 	void SetRotation(const Vector3& newRotation);
 	void SetScale(const Vector3& newScale);
+	void SetLocalTransform(const Vector3& newPosition, const Vector3& newRotation, const Vector3& newScale);
 
 	void SetModelMatrix(const Matrix44& model);
 	void SetParentTransform(Transform* parent);
@@ -31,41 +45,61 @@ public:
 	void Rotate(const Vector3& deltaRotation);
 	void Scale(const Vector3& deltaScale);
 
-	Matrix44 GetLocalMatrix();	// Matrix that transforms this space to parent's space
-	Matrix44 GetWorldMatrix();	// Matrix that transforms this space to absolute world space
-	Matrix44 GetParentsToWorldMatrix();
+	// Accessors, all defined in parent space
+	const Vector3& GetPosition() const;
+	const Vector3& GetRotation() const;
+	const Vector3& GetScale() const;
 
-	Vector3 GetIVector();
-	Vector3 GetJVector();
-	Vector3 GetKVector();
+	Transform*	GetParentTransform() const;
+	int			GetChildCount() const;
+	Transform*	GetChild(int childIndex) const;
+	bool		IsWorldMatrixDirty() const;
 
-	Vector3 GetWorldPosition();
-	Vector3 GetWorldRotation();
+	const Matrix44& GetLocalMatrix() const;		// Matrix that transforms this space to parent's space
+	const Matrix44& GetWorldMatrix() const;		// Matrix that transforms this space to absolute world space
+	Matrix44		GetParentsToWorldMatrix() const;
+
+	Vector3 GetIVector() const;
+	Vector3 GetJVector() const;
+	Vector3 GetKVector() const;
+
+	Vector3 GetWorldPosition() const;
+	Vector3 GetWorldRotation() const;
 
 
 private:
 	//-----Private Methods-----
 
-	void CheckAndUpdateLocalMatrix();
+	void MarkLocalMatrixDirty();
+	void MarkWorldMatrixDirty();
 
+	void UpdateLocalMatrix() const;
+	void UpdateWorldMatrixFromParent() const;	// Parent's world matrix must already be up to date
 
-public:
-	//-----Public Data-----
-
-	// All defined in parent space!
-	Vector3		position = Vector3::ZERO;	
-	Vector3		rotation = Vector3::ZERO;	
-	Vector3		scale = Vector3::ONES;		
+	void AddChild(Transform* child);
+	void RemoveChild(Transform* child);
+	void OnHierarchyChanged();
 
 
 private:
 	//-----Private Data-----
 
-	Vector3 m_oldPosition = Vector3::ZERO;
-	Vector3 m_oldRotation = Vector3::ZERO;
-	Vector3 m_oldScale = Vector3::ONES;
+	// All defined in parent space!
+	Vector3		m_position = Vector3::ZERO;
+	Vector3		m_rotation = Vector3::ZERO;
+	Vector3		m_scale = Vector3::ONES;
+
+	// Caches, updated lazily on read or all at once by a TransformHierarchy
+	mutable Matrix44	m_localMatrix;
+	mutable Matrix44	m_worldMatrix;
+	mutable bool		m_isLocalMatrixDirty = true;
+	mutable bool		m_isWorldMatrixDirty = true;
+
+	Transform*				m_parentTransform = nullptr;
+	std::vector<Transform*>	m_childTransforms;
 
-	Matrix44 m_localMatrix;
+	// The hierarchy this transform was added to, if any, and where it is in it
+	TransformHierarchy*		m_hierarchy = nullptr;
+	int						m_hierarchyIndex = -1;
 
-	Transform* m_parentTransform = nullptr;
 };
@@ -0,0 +1,279 @@
+/************************************************************************/
+/* File: TransformHierarchy.cpp
+/* Author: Andrew Chase
+/* Date: June 13th, 2019
+/* Description: Implementation of the TransformHierarchy class
+/************************************************************************/
+#include "Engine/Math/Transform.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Math/TransformHierarchy.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
+#include "Engine/Core/Utility/ErrorWarningAssert.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Job for cleaning a range of transforms that all share the same depth
+// Their parents are one level up and already clean, so no two jobs touch the same transform
+//
+class TransformUpdateJob : public Job
+{
+public:
+
+	TransformUpdateJob(Transform* const* transforms, int count)
+		: m_transforms(transforms), m_count(count)
+	{
+		m_jobType = JOB_TYPE_TRANSFORM_UPDATE;
+		m_jobFlags = WORKER_FLAGS_ALL_BUT_DISK;
+	}
+
+	virtual void Execute() override
+	{
+		for (int index = 0; index < m_count; ++index)
+		{
+			const Transform* transform = m_transforms[index];
+
+			if (transform->IsWorldMatrixDirty())
+			{
+				transform->UpdateWorldMatrixFromParent();
+			}
+		}
+	}
+
+	Transform* const*	m_transforms = nullptr;
+	int					m_count = 0;
+
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Destructor - the transforms aren't deleted, just told they're no longer in a hierarchy
+//
+TransformHierarchy::~TransformHierarchy()
+{
+	for (int index = 0; index < (int)m_transforms.size(); ++index)
+	{
+		m_transforms[index]->m_hierarchy = nullptr;
+		m_transforms[index]->m_hierarchyIndex = -1;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the transform to be updated each frame
+//
+void TransformHierarchy::AddTransform(Transform* transform)
+{
+	ASSERT_OR_DIE(transform->m_hierarchy == nullptr, "Error: TransformHierarchy::AddTransform() transform is already in a hierarchy");
+
+	transform->m_hierarchy = this;
+	transform->m_hierarchyIndex = (int)m_transforms.size();
+
+	m_transforms.push_back(transform);
+	MarkOrderDirty();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Stops updating the transform, does not delete it
+//
+void TransformHierarchy::RemoveTransform(Transform* transform)
+{
+	if (transform->m_hierarchy != this)
+	{
+		return;
+	}
+
+	// Swap remove, the order gets rebuilt on the next update anyway
+	int index = transform->m_hierarchyIndex;
+	m_transforms[index] = m_transforms.back();
+	m_transforms[index]->m_hierarchyIndex = index;
+	m_transforms.pop_back();
+
+	transform->m_hierarchy = nullptr;
+	transform->m_hierarchyIndex = -1;
+
+	MarkOrderDirty();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Brings every world matrix up to date, one depth level at a time
+// Roots go through the lazy path on the main thread, since their parents may be outside this hierarchy
+//
+void TransformHierarchy::UpdateWorldMatrices()
+{
+	if (m_isOrderDirty)
+	{
+		RebuildOrder();
+	}
+
+	m_lastUpdatedCount = 0;
+
+	if (m_transforms.size() == 0)
+	{
+		return;
+	}
+
+	for (int index = m_levelStarts[0]; index < m_levelStarts[1]; ++index)
+	{
+		if (m_transforms[index]->IsWorldMatrixDirty())
+		{
+			m_transforms[index]->GetWorldMatrix();
+			m_lastUpdatedCount++;
+		}
+	}
+
+	for (int levelIndex = 1; levelIndex < GetLevelCount(); ++levelIndex)
+	{
+		m_lastUpdatedCount += UpdateLevel(levelIndex);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of transforms in the hierarchy
+//
+int TransformHierarchy::GetTransformCount() const
+{
+	return (int)m_transforms.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of depth levels as of the last update
+//
+int TransformHierarchy::GetLevelCount() const
+{
+	return (int)m_levelStarts.size() - 1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns how many transforms were dirty on the last update
+// Transforms updated in jobs aren't counted, since checking would mean another pass over them
+//
+int TransformHierarchy::GetLastUpdatedCount() const
+{
+	return m_lastUpdatedCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Flags the update order for rebuilding, called when a transform is added, removed, or reparented
+//
+void TransformHierarchy::MarkOrderDirty()
+{
+	m_isOrderDirty = true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sorts the transforms by depth with a counting sort, keeping their relative order within a level
+//
+void TransformHierarchy::RebuildOrder()
+{
+	int transformCount = (int)m_transforms.size();
+
+	std::vector<int> depths(transformCount);
+	int maxDepth = 0;
+
+	for (int index = 0; index < transformCount; ++index)
+	{
+		depths[index] = GetDepth(m_transforms[index]);
+		maxDepth = MaxInt(maxDepth, depths[index]);
+	}
+
+	// Count each depth, then turn the counts into start indices
+	m_levelStarts.clear();
+	m_levelStarts.resize(maxDepth + 2, 0);
+
+	for (int index = 0; index < transformCount; ++index)
+	{
+		m_levelStarts[depths[index] + 1]++;
+	}
+
+	for (int levelIndex = 1; levelIndex < (int)m_levelStarts.size(); ++levelIndex)
+	{
+		m_levelStarts[levelIndex] += m_levelStarts[levelIndex - 1];
+	}
+
+	std::vector<int> nextSlots(m_levelStarts.begin(), m_levelStarts.end() - 1);
+	std::vector<Transform*> sortedTransforms(transformCount);
+
+	for (int index = 0; index < transformCount; ++index)
+	{
+		int slot = nextSlots[depths[index]]++;
+
+		sortedTransforms[slot] = m_transforms[index];
+		sortedTransforms[slot]->m_hierarchyIndex = slot;
+	}
+
+	m_transforms.swap(sortedTransforms);
+	m_isOrderDirty = false;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of ancestors the transform has in this hierarchy, stopping at the first one that isn't
+//
+int TransformHierarchy::GetDepth(const Transform* transform) const
+{
+	int depth = 0;
+	const Transform* parent = transform->m_parentTransform;
+
+	while (parent != nullptr && parent->m_hierarchy == this)
+	{
+		depth++;
+		parent = parent->m_parentTransform;
+	}
+
+	return depth;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Cleans all dirty transforms in the level, in jobs if it's big enough to be worth splitting
+// Returns the number cleaned on the main thread
+//
+int TransformHierarchy::UpdateLevel(int levelIndex)
+{
+	int levelStart = m_levelStarts[levelIndex];
+	int levelCount = m_levelStarts[levelIndex + 1] - levelStart;
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	bool useJobs = (jobSystem != nullptr && jobSystem->GetWorkerThreadCount(WORKER_FLAGS_ALL_BUT_DISK) > 0 && levelCount >= 2 * MIN_TRANSFORMS_PER_JOB);
+
+	if (useJobs)
+	{
+		int workerCount = jobSystem->GetWorkerThreadCount(WORKER_FLAGS_ALL_BUT_DISK);
+		int jobCount = ClampInt(levelCount / MIN_TRANSFORMS_PER_JOB, 1, workerCount);
+		int transformsPerJob = (levelCount + jobCount - 1) / jobCount;
+
+		for (int jobStart = 0; jobStart < levelCount; jobStart += transformsPerJob)
+		{
+			int jobTransformCount = MinInt(transformsPerJob, levelCount - jobStart);
+			QueueJob(new TransformUpdateJob(&m_transforms[levelStart + jobStart], jobTransformCount));
+		}
+
+		// The next level reads these, so it has to wait
+		jobSystem->BlockUntilAllJobsOfTypeAreFinalized(JOB_TYPE_TRANSFORM_UPDATE);
+		return 0;
+	}
+
+	int updatedCount = 0;
+
+	for (int index = levelStart; index < levelStart + levelCount; ++index)
+	{
+		const Transform* transform = m_transforms[index];
+
+		if (transform->IsWorldMatrixDirty())
+		{
+			transform->UpdateWorldMatrixFromParent();
+			updatedCount++;
+		}
+	}
+
+	return updatedCount;
+}
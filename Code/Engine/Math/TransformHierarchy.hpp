@@ -0,0 +1,64 @@
+/************************************************************************/
+/* File: TransformHierarchy.hpp
+/* Author: Andrew Chase
+/* Date: June 13th, 2019
+/* Description: Keeps a set of transforms sorted parents-before-children
+/*				so all their world matrices can be brought up to date
+/*				in one pass per frame, split across worker threads
+/************************************************************************/
+#pragma once
+#include <vector>
+
+class Transform;
+
+class TransformHierarchy
+{
+	friend class Transform;
+
+public:
+	//-----Public Methods-----
+
+	TransformHierarchy() {}
+	~TransformHierarchy();
+	TransformHierarchy(const TransformHierarchy& copy) = delete;
+
+	// A transform can only be in one hierarchy at a time, and is removed automatically when destroyed
+	void	AddTransform(Transform* transform);
+	void	RemoveTransform(Transform* transform);
+
+	// Cleans every dirty world matrix, after which reads on the main thread don't recalculate anything
+	void	UpdateWorldMatrices();
+
+	int		GetTransformCount() const;
+	int		GetLevelCount() const;
+	int		GetLastUpdatedCount() const;
+
+
+private:
+	//-----Private Methods-----
+
+	void	MarkOrderDirty();
+	void	RebuildOrder();
+	int		GetDepth(const Transform* transform) const;
+
+	int		UpdateLevel(int levelIndex);
+
+
+private:
+	//-----Private Data-----
+
+	// Not owned, sorted by depth after RebuildOrder()
+	std::vector<Transform*>	m_transforms;
+
+	// Index into m_transforms where each depth starts, with one extra entry at the end for the count
+	// Transforms whose parents aren't in this hierarchy count as depth 0
+	std::vector<int>		m_levelStarts;
+	bool					m_isOrderDirty = false;
+
+	int						m_lastUpdatedCount = 0;
+
+	// Levels with fewer transforms than this are updated on the main thread, and bigger ones are split
+	// into jobs of at least this many, since each matrix is only a few dozen multiplies
+	static constexpr int MIN_TRANSFORMS_PER_JOB = 1024;
+
+};
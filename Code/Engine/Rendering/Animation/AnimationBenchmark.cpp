@@ -0,0 +1,261 @@
+/************************************************************************/
+/* File: AnimationBenchmark.cpp
+/* Author: Andrew Chase
+/* Date: June 7th, 2019
+/* Description: Implementation of the AnimationBenchmark class
+/************************************************************************/
+#include "Engine/Core/Time/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Assets/AssimpLoader.hpp"
+#include "Engine/Rendering/Animation/Pose.hpp"
+#include "Engine/Rendering/Animation/Animator.hpp"
+#include "Engine/Rendering/Animation/Skeleton.hpp"
+#include "Engine/Core/DeveloperConsole/Command.hpp"
+#include "Engine/Rendering/Animation/AnimationClip.hpp"
+#include "Engine/Rendering/Animation/AnimationSystem.hpp"
+#include "Engine/Rendering/Animation/AnimationBenchmark.hpp"
+
+// Console commands
+static void Command_AnimationBenchmark(Command& cmd);
+static void Command_AnimationCrowdBenchmark(Command& cmd);
+
+
+//-----------------------------------------------------------------------------------------------
+// Samples the clip's matrix pose at every frame, the way clips used to be stored
+//
+static void BakeMatrixPoses(const AnimationClip* clip, Pose* scratchPose, std::vector<Matrix44>& out_matrices)
+{
+	int frameCount = clip->GetFrameCount();
+	int boneCount = (int)scratchPose->GetBoneCount();
+
+	out_matrices.resize((size_t)frameCount * boneCount);
+
+	for (int frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+	{
+		clip->SamplePoseAtTime(frameIndex * clip->GetFrameDurationSeconds(), scratchPose);
+
+		const Matrix44* boneData = scratchPose->GetTotalBoneData();
+		for (int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+		{
+			out_matrices[frameIndex * boneCount + boneIndex] = boneData[boneIndex];
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Samples each clip posesPerClip times spread over its length, both from its tracks and from baked matrices
+// Clips must all share a skeleton
+//
+AnimationBenchmarkResults_t AnimationBenchmark::Run(const std::vector<AnimationClip*>& clips, int posesPerClip)
+{
+	AnimationBenchmarkResults_t results;
+
+	if (clips.size() == 0 || posesPerClip <= 0)
+	{
+		return results;
+	}
+
+	Pose scratchPose;
+	scratchPose.Initialize(clips[0]->GetSkeleton());
+	int boneCount = (int)scratchPose.GetBoneCount();
+
+	uint64_t trackCounts = 0;
+	uint64_t matrixCounts = 0;
+
+	std::vector<Matrix44> bakedMatrices;
+
+	for (int clipIndex = 0; clipIndex < (int)clips.size(); ++clipIndex)
+	{
+		AnimationClip* clip = clips[clipIndex];
+
+		results.clipCount++;
+		results.frameCount += clip->GetFrameCount();
+		results.keyCount += clip->GetKeyCount();
+		results.compressedBytes += clip->GetMemoryUsageBytes();
+		results.uncompressedBytes += clip->GetUncompressedMemoryUsageBytes();
+
+		float duration = clip->GetTotalDurationSeconds();
+		float timeStep = duration / (float)posesPerClip;
+
+		// Tracks
+		uint64_t startHPC = GetPerformanceCounter();
+		for (int poseIndex = 0; poseIndex < posesPerClip; ++poseIndex)
+		{
+			clip->SamplePoseAtTime(poseIndex * timeStep, &scratchPose);
+		}
+		trackCounts += GetPerformanceCounter() - startHPC;
+
+		// Baked matrices, interpolated element-wise between frames like the old clip did
+		BakeMatrixPoses(clip, &scratchPose, bakedMatrices);
+		int frameCount = clip->GetFrameCount();
+
+		startHPC = GetPerformanceCounter();
+		for (int poseIndex = 0; poseIndex < posesPerClip; ++poseIndex)
+		{
+			float framePosition = (poseIndex * timeStep) / clip->GetFrameDurationSeconds();
+			int firstFrame = (int)framePosition % frameCount;
+			int secondFrame = (firstFrame + 1) % frameCount;
+			float fraction = framePosition - (float)(int)framePosition;
+
+			const Matrix44* firstMatrices = &bakedMatrices[firstFrame * boneCount];
+			const Matrix44* secondMatrices = &bakedMatrices[secondFrame * boneCount];
+
+			for (int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+			{
+				scratchPose.SetBoneTransform(boneIndex, Interpolate(firstMatrices[boneIndex], secondMatrices[boneIndex], fraction));
+			}
+		}
+		matrixCounts += GetPerformanceCounter() - startHPC;
+	}
+
+	double totalPoses = (double)results.clipCount * (double)posesPerClip;
+	results.trackPosesPerSecond = totalPoses / TimeSystem::PerformanceCountToSeconds(trackCounts);
+	results.matrixPosesPerSecond = totalPoses / TimeSystem::PerformanceCountToSeconds(matrixCounts);
+
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Updates characterCount animators, each playing one of the clips, through an AnimationSystem
+// Half the characters are mid-transition so blending is part of the cost
+//
+AnimationCrowdResults_t AnimationBenchmark::RunCrowd(const std::vector<AnimationClip*>& clips, int characterCount, int updateCount)
+{
+	AnimationCrowdResults_t results;
+
+	if (clips.size() == 0 || characterCount <= 0 || updateCount <= 0)
+	{
+		return results;
+	}
+
+	AnimationSystem animationSystem;
+	std::vector<Animator*> animators;
+
+	for (int characterIndex = 0; characterIndex < characterCount; ++characterIndex)
+	{
+		Animator* animator = new Animator();
+		animator->Play(clips[characterIndex % clips.size()]);
+
+		if ((characterIndex & 1) == 1)
+		{
+			animator->TransitionToClip(clips[(characterIndex + 1) % clips.size()], 1000.f);
+		}
+
+		animationSystem.AddAnimator(animator);
+		animators.push_back(animator);
+	}
+
+	float totalMilliseconds = 0.f;
+
+	for (int updateIndex = 0; updateIndex < updateCount; ++updateIndex)
+	{
+		animationSystem.Update();
+		totalMilliseconds += animationSystem.GetStats().updateMilliseconds;
+	}
+
+	const AnimationSystemStats_t& stats = animationSystem.GetStats();
+
+	results.characterCount = stats.animatorCount;
+	results.bonesPerFrame = stats.boneCount;
+	results.jobsPerFrame = stats.jobCount;
+	results.averageUpdateMilliseconds = totalMilliseconds / (float)updateCount;
+	results.charactersPerMillisecond = (results.averageUpdateMilliseconds > 0.f ? (float)results.characterCount / results.averageUpdateMilliseconds : 0.f);
+
+	for (int characterIndex = 0; characterIndex < characterCount; ++characterIndex)
+	{
+		delete animators[characterIndex];
+	}
+
+	return results;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Registers the benchmark console commands
+//
+void AnimationBenchmark::InitializeConsoleCommands()
+{
+	Command::Register("anim_benchmark", "Loads the animations in file -f and reports clip memory and sampling speed, -n poses per clip", Command_AnimationBenchmark);
+	Command::Register("anim_crowd_benchmark", "Loads the animations in file -f and updates -n characters -u times, reporting characters per millisecond", Command_AnimationCrowdBenchmark);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Loads the file's skeleton and animations, runs the benchmark on them, and prints the results
+//
+static void Command_AnimationBenchmark(Command& cmd)
+{
+	std::string filepath;
+	if (!cmd.GetParam("f", filepath))
+	{
+		ConsoleErrorf("No file specified, use -f <file>");
+		return;
+	}
+
+	int posesPerClip = 1000;
+	cmd.GetParam("n", posesPerClip, &posesPerClip);
+
+	AssimpLoader loader;
+	loader.OpenFile(filepath);
+
+	Skeleton* skeleton = loader.ImportSkeleton();
+	std::vector<AnimationClip*> clips = loader.ImportAnimation(skeleton);
+
+	loader.CloseFile();
+
+	AnimationBenchmarkResults_t results = AnimationBenchmark::Run(clips, posesPerClip);
+
+	ConsolePrintf(Rgba::GREEN, "%s: %i clips, %i bones, %i frames reduced to %i keys", filepath.c_str(), results.clipCount, skeleton->GetBoneCount(), results.frameCount, results.keyCount);
+	ConsolePrintf(Rgba::GREEN, "Memory: %u bytes as tracks, %u bytes as matrices (%.1fx smaller)", 
+		(unsigned int)results.compressedBytes, (unsigned int)results.uncompressedBytes, (float)results.uncompressedBytes / (float)(results.compressedBytes > 0 ? results.compressedBytes : 1));
+	ConsolePrintf(Rgba::GREEN, "Sampling: %.0f poses/sec from tracks, %.0f poses/sec from matrices", results.trackPosesPerSecond, results.matrixPosesPerSecond);
+
+	for (int clipIndex = 0; clipIndex < (int)clips.size(); ++clipIndex)
+	{
+		delete clips[clipIndex];
+	}
+
+	delete skeleton;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Loads the file's skeleton and animations, updates a crowd playing them, and prints the throughput
+//
+static void Command_AnimationCrowdBenchmark(Command& cmd)
+{
+	std::string filepath;
+	if (!cmd.GetParam("f", filepath))
+	{
+		ConsoleErrorf("No file specified, use -f <file>");
+		return;
+	}
+
+	int characterCount = 1000;
+	cmd.GetParam("n", characterCount, &characterCount);
+
+	int updateCount = 60;
+	cmd.GetParam("u", updateCount, &updateCount);
+
+	AssimpLoader loader;
+	loader.OpenFile(filepath);
+
+	Skeleton* skeleton = loader.ImportSkeleton();
+	std::vector<AnimationClip*> clips = loader.ImportAnimation(skeleton);
+
+	loader.CloseFile();
+
+	AnimationCrowdResults_t results = AnimationBenchmark::RunCrowd(clips, characterCount, updateCount);
+
+	ConsolePrintf(Rgba::GREEN, "%s: %i characters, %i bones per frame, %i jobs per frame", filepath.c_str(), results.characterCount, results.bonesPerFrame, results.jobsPerFrame);
+	ConsolePrintf(Rgba::GREEN, "Update: %.3f ms average over %i updates, %.1f characters/ms", results.averageUpdateMilliseconds, updateCount, results.charactersPerMillisecond);
+
+	for (int clipIndex = 0; clipIndex < (int)clips.size(); ++clipIndex)
+	{
+		delete clips[clipIndex];
+	}
+
+	delete skeleton;
+}
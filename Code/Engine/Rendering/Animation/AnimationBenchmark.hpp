@@ -0,0 +1,44 @@
+/************************************************************************/
+/* File: AnimationBenchmark.hpp
+/* Author: Andrew Chase
+/* Date: June 7th, 2019
+/* Description: Measures animation clip memory and sampling speed against
+/*				the old layout of a full matrix per bone per frame, and
+/*				crowd update throughput of the AnimationSystem
+/************************************************************************/
+#pragma once
+#include <vector>
+
+class AnimationClip;
+
+struct AnimationBenchmarkResults_t
+{
+	int		clipCount = 0;
+	int		frameCount = 0;
+	int		keyCount = 0;
+	size_t	compressedBytes = 0;
+	size_t	uncompressedBytes = 0;
+	double	trackPosesPerSecond = 0.0;
+	double	matrixPosesPerSecond = 0.0;
+};
+
+struct AnimationCrowdResults_t
+{
+	int		characterCount = 0;
+	int		bonesPerFrame = 0;
+	int		jobsPerFrame = 0;
+	float	averageUpdateMilliseconds = 0.f;
+	float	charactersPerMillisecond = 0.f;
+};
+
+
+class AnimationBenchmark
+{
+public:
+	//-----Public Methods-----
+
+	static AnimationBenchmarkResults_t	Run(const std::vector<AnimationClip*>& clips, int posesPerClip);
+	static AnimationCrowdResults_t		RunCrowd(const std::vector<AnimationClip*>& clips, int characterCount, int updateCount);
+	static void							InitializeConsoleCommands();
+
+};
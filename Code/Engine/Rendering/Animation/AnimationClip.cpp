@@ -1,37 +1,254 @@
+/************************************************************************/
+/* File: AnimationClip.cpp
+/* Author: Andrew Chase
+/* Date: July 16th, 2018
+/* Description: Implementation of the AnimationClip class
+/************************************************************************/
+#include <math.h>
+#include <algorithm>
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Rendering/Animation/Pose.hpp"
-#include "Engine/Rendering/Animation/AnimationClip.hpp"
 #include "Engine/Rendering/Animation/Skeleton.hpp"
+#include "Engine/Rendering/Animation/AnimationClip.hpp"
 
+// Quantized components are fixed point with this as 1.0
+static constexpr float QUANTIZED_ONE = 32767.f;
 
-void AnimationClip::Initialize(unsigned int numPoses, const Skeleton* skeleton, float framesPerSecond)
+
+//-----------------------------------------------------------------------------------------------
+// Greedy keyframe reduction - walks forward from the last kept key, extending the segment until a
+// frame in the middle can't be reproduced by interpolating the segment's ends within tolerance
+// The first and last frames are always kept, so looping back to the start interpolates the same
+// as it did before reduction
+//
+template <typename T, typename InterpolateFunc, typename ToleranceFunc>
+static void ReduceKeys(const T* values, int frameCount, InterpolateFunc interpolate, ToleranceFunc isWithinTolerance, std::vector<uint16_t>& out_keyFrames, std::vector<T>& out_keys)
 {
-	m_poses = (Pose*) malloc(sizeof(Pose) * numPoses);
-	m_numPoses = numPoses;
+	out_keyFrames.push_back(0);
+	out_keys.push_back(values[0]);
+
+	// Constant tracks only need the one key
+	bool isConstant = true;
+	for (int frameIndex = 1; frameIndex < frameCount; ++frameIndex)
+	{
+		if (!isWithinTolerance(values[0], values[frameIndex]))
+		{
+			isConstant = false;
+			break;
+		}
+	}
+
+	if (isConstant)
+	{
+		return;
+	}
+
+	int anchorFrame = 0;
+	for (int endFrame = anchorFrame + 2; endFrame < frameCount; ++endFrame)
+	{
+		bool canSkipMiddle = true;
+
+		for (int middleFrame = anchorFrame + 1; middleFrame < endFrame; ++middleFrame)
+		{
+			float fraction = (float)(middleFrame - anchorFrame) / (float)(endFrame - anchorFrame);
+			T interpolated = interpolate(values[anchorFrame], values[endFrame], fraction);
+
+			if (!isWithinTolerance(interpolated, values[middleFrame]))
+			{
+				canSkipMiddle = false;
+				break;
+			}
+		}
 
+		if (!canSkipMiddle)
+		{
+			anchorFrame = endFrame - 1;
+			out_keyFrames.push_back((uint16_t)anchorFrame);
+			out_keys.push_back(values[anchorFrame]);
+		}
+	}
+
+	if (anchorFrame != frameCount - 1)
+	{
+		out_keyFrames.push_back((uint16_t)(frameCount - 1));
+		out_keys.push_back(values[frameCount - 1]);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Quantizes the rotation, which should be unit length
+//
+QuantizedQuaternion_t QuantizedQuaternion_t::Encode(const Quaternion& rotation)
+{
+	Quaternion normalized = rotation.GetNormalized();
+
+	QuantizedQuaternion_t result;
+	result.s = (int16_t)RoundToNearestInt(ClampFloat(normalized.s, -1.f, 1.f) * QUANTIZED_ONE);
+	result.x = (int16_t)RoundToNearestInt(ClampFloat(normalized.v.x, -1.f, 1.f) * QUANTIZED_ONE);
+	result.y = (int16_t)RoundToNearestInt(ClampFloat(normalized.v.y, -1.f, 1.f) * QUANTIZED_ONE);
+	result.z = (int16_t)RoundToNearestInt(ClampFloat(normalized.v.z, -1.f, 1.f) * QUANTIZED_ONE);
+
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the rotation as a quaternion, not renormalized since interpolation renormalizes anyway
+//
+Quaternion QuantizedQuaternion_t::Decode() const
+{
+	float oneOverQuantizedOne = (1.f / QUANTIZED_ONE);
+	return Quaternion((float)s * oneOverQuantizedOne, (float)x * oneOverQuantizedOne, (float)y * oneOverQuantizedOne, (float)z * oneOverQuantizedOne);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets up the clip for the given skeleton with no animated bones, tracks are added with SetBoneTrack()
+//
+void AnimationClip::Initialize(unsigned int numFrames, const Skeleton* skeleton, float framesPerSecond)
+{
+	ASSERT_OR_DIE(numFrames > 0 && numFrames <= 0xffff, Stringf("Error: AnimationClip::Initialize() frame count %u is out of range", numFrames));
+
+	m_numFrames = numFrames;
 	m_baseSkeleton = skeleton;
 
+	m_framesPerSecond = framesPerSecond;
 	m_frameDuration = (1.f / framesPerSecond);
-	m_durationSeconds = numPoses * m_frameDuration;
+	m_durationSeconds = numFrames * m_frameDuration;
+
+	unsigned int boneCount = skeleton->GetBoneCount();
+	m_tracks.clear();
+	m_tracks.resize(boneCount);
+
+	m_preRotations.resize(boneCount);
+	m_bindTranslations.resize(boneCount);
+	m_bindRotations.resize(boneCount);
+	m_bindScales.resize(boneCount);
+
+	for (unsigned int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		BoneData_t boneData = skeleton->GetBoneData(boneIndex);
+
+		m_preRotations[boneIndex] = Quaternion::FromMatrix(boneData.preRotation);
+
+		m_bindTranslations[boneIndex] = Matrix44::ExtractTranslation(boneData.localTransform);
+		m_bindRotations[boneIndex] = Quaternion::FromMatrix(boneData.localTransform);
+		m_bindScales[boneIndex] = Matrix44::ExtractScale(boneData.localTransform);
+	}
 }
 
-Pose* AnimationClip::CalculatePoseAtTime(float t) const
+
+//-----------------------------------------------------------------------------------------------
+// Compresses one value per frame into keys for the bone
+// Rotations are the bone's own rotation, the skeleton's pre-rotation is applied when sampled
+//
+void AnimationClip::SetBoneTrack(unsigned int boneIndex, const Vector3* translations, const Quaternion* rotations, const Vector3* scales)
+{
+	ASSERT_OR_DIE(boneIndex < (unsigned int)m_tracks.size(), Stringf("Error: AnimationClip::SetBoneTrack() bone index %u out of range", boneIndex));
+
+	BoneTrack_t& track = m_tracks[boneIndex];
+	ASSERT_OR_DIE(track.rotationKeyCount == 0, Stringf("Error: AnimationClip::SetBoneTrack() called twice for bone %u", boneIndex));
+
+	int frameCount = (int)m_numFrames;
+
+	float translationToleranceSquared = m_compressionSettings.translationTolerance * m_compressionSettings.translationTolerance;
+	float scaleToleranceSquared = m_compressionSettings.scaleTolerance * m_compressionSettings.scaleTolerance;
+	float minRotationDot = CosDegrees(0.5f * m_compressionSettings.rotationToleranceDegrees);
+
+	auto lerpVector = [](const Vector3& start, const Vector3& end, float fraction) { return Interpolate(start, end, fraction); };
+	auto isTranslationWithinTolerance = [=](const Vector3& a, const Vector3& b) { return (a - b).GetLengthSquared() <= translationToleranceSquared; };
+	auto isScaleWithinTolerance = [=](const Vector3& a, const Vector3& b) { return (a - b).GetLengthSquared() <= scaleToleranceSquared; };
+	auto nlerpRotation = [](const Quaternion& start, const Quaternion& end, float fraction) { return Quaternion::Nlerp(start, end, fraction); };
+	auto isRotationWithinTolerance = [=](const Quaternion& a, const Quaternion& b) { return fabsf(DotProduct(a.GetNormalized(), b.GetNormalized())) >= minRotationDot; };
+
+	// Translation
+	track.firstTranslationKey = (int)m_translationKeys.size();
+	ReduceKeys(translations, frameCount, lerpVector, isTranslationWithinTolerance, m_translationKeyFrames, m_translationKeys);
+	track.translationKeyCount = (int)m_translationKeys.size() - track.firstTranslationKey;
+
+	// Rotation, reduced at full precision then quantized
+	std::vector<uint16_t> rotationKeyFrames;
+	std::vector<Quaternion> rotationKeys;
+	ReduceKeys(rotations, frameCount, nlerpRotation, isRotationWithinTolerance, rotationKeyFrames, rotationKeys);
+
+	track.firstRotationKey = (int)m_rotationKeys.size();
+	track.rotationKeyCount = (int)rotationKeys.size();
+
+	for (int keyIndex = 0; keyIndex < (int)rotationKeys.size(); ++keyIndex)
+	{
+		m_rotationKeyFrames.push_back(rotationKeyFrames[keyIndex]);
+		m_rotationKeys.push_back(QuantizedQuaternion_t::Encode(rotationKeys[keyIndex]));
+	}
+
+	// Scale
+	track.firstScaleKey = (int)m_scaleKeys.size();
+	ReduceKeys(scales, frameCount, lerpVector, isScaleWithinTolerance, m_scaleKeyFrames, m_scaleKeys);
+	track.scaleKeyCount = (int)m_scaleKeys.size() - track.firstScaleKey;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Fills the pose's local bone transforms at the given time, looping past the end
+// Doesn't build the model space matrices, so the result can be blended first
+//
+void AnimationClip::SampleLocalPose(float timeSeconds, Pose* out_pose) const
 {
-	while (t >= m_durationSeconds)
+	int boneCount = (int)m_tracks.size();
+	ASSERT_OR_DIE((int)out_pose->GetBoneCount() == boneCount, "Error: AnimationClip::SampleLocalPose() pose doesn't match the clip's skeleton");
+
+	float framePosition = ModFloat(timeSeconds * m_framesPerSecond, (float)m_numFrames);
+	if (framePosition < 0.f)
 	{
-		t -= m_durationSeconds;
+		framePosition += (float)m_numFrames;
 	}
 
-	float normalizedTime = RangeMapFloat(t, 0.f, GetTotalDurationSeconds(), 0.f, 1.f);
+	for (int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+	{
+		const BoneTrack_t& track = m_tracks[boneIndex];
+
+		if (track.rotationKeyCount == 0)
+		{
+			out_pose->SetLocalTransform(boneIndex, m_bindTranslations[boneIndex], m_bindRotations[boneIndex], m_bindScales[boneIndex]);
+			continue;
+		}
 
-	return CalculatePoseAtNormalizedTime(normalizedTime);
+		Vector3 translation = SampleTranslation(track, framePosition);
+		Quaternion rotation = m_preRotations[boneIndex] * SampleRotation(track, framePosition);
+		Vector3 scale = SampleScale(track, framePosition);
+
+		out_pose->SetLocalTransform(boneIndex, translation, rotation, scale);
+	}
 }
 
-Pose* AnimationClip::GetPoseAtIndex(unsigned int poseIndex)
+
+//-----------------------------------------------------------------------------------------------
+// Fills the pose with the model space bone transforms at the given time, looping past the end
+//
+void AnimationClip::SamplePoseAtTime(float timeSeconds, Pose* out_pose) const
 {
-	return &m_poses[poseIndex];
+	SampleLocalPose(timeSeconds, out_pose);
+	out_pose->ConstructWorldMatrices();
 }
-#include "Engine/Core/EngineCommon.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a new pose for the given time in seconds, which the caller is responsible for deleting
+//
+Pose* AnimationClip::CalculatePoseAtTime(float t) const
+{
+	Pose* pose = new Pose();
+	pose->Initialize(m_baseSkeleton);
+
+	SamplePoseAtTime(t, pose);
+	return pose;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a new pose for the given normalized time, which the caller is responsible for deleting
+//
 Pose* AnimationClip::CalculatePoseAtNormalizedTime(float t) const
 {
 	// Loop the animation for now
@@ -40,68 +257,206 @@ Pose* AnimationClip::CalculatePoseAtNormalizedTime(float t) const
 		t -= 1.0f;
 	}
 
-	int numPoses = GetPoseCount();
-
-	float timeIntoAnimation = (t * m_durationSeconds);
-
-	int firstPoseIndex = (int) (t * numPoses);
-	int secondPoseIndex = firstPoseIndex == (numPoses - 1) ? 0 : firstPoseIndex + 1;
-
-	float currentTime = (float) firstPoseIndex * (m_durationSeconds / m_numPoses);
-	//ASSERT_OR_DIE(currentTime <= timeIntoAnimation, "Error: current was over t");
-
-	float interpolationValue = (timeIntoAnimation - currentTime) / (m_durationSeconds / m_numPoses);
-	return CalcuateInterpolatedPose(firstPoseIndex, secondPoseIndex, interpolationValue);
+	return CalculatePoseAtTime(t * m_durationSeconds);
 }
 
-int AnimationClip::GetPoseCount() const
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of frames the clip was sampled at, before keys were reduced
+//
+int AnimationClip::GetFrameCount() const
 {
-	return m_numPoses;
+	return m_numFrames;
 }
 
+
+//-----------------------------------------------------------------------------------------------
+// Returns the length of the clip in seconds
+//
 float AnimationClip::GetTotalDurationSeconds() const
 {
 	return m_durationSeconds;
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns the length of a single frame in seconds
+//
 float AnimationClip::GetFrameDurationSeconds() const
 {
 	return m_frameDuration;
 }
 
+
+//-----------------------------------------------------------------------------------------------
+// Returns the name of the clip
+//
+const std::string& AnimationClip::GetName() const
+{
+	return m_name;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the skeleton this clip animates
+//
+const Skeleton* AnimationClip::GetSkeleton() const
+{
+	return m_baseSkeleton;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the total number of translation, rotation and scale keys across all bones
+//
+int AnimationClip::GetKeyCount() const
+{
+	return (int)(m_translationKeys.size() + m_rotationKeys.size() + m_scaleKeys.size());
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of bytes used by the clip's animation data
+//
+size_t AnimationClip::GetMemoryUsageBytes() const
+{
+	size_t byteCount = sizeof(AnimationClip);
+
+	byteCount += m_tracks.size() * sizeof(BoneTrack_t);
+	byteCount += (m_translationKeyFrames.size() + m_rotationKeyFrames.size() + m_scaleKeyFrames.size()) * sizeof(uint16_t);
+	byteCount += (m_translationKeys.size() + m_scaleKeys.size()) * sizeof(Vector3);
+	byteCount += m_rotationKeys.size() * sizeof(QuantizedQuaternion_t);
+	byteCount += (m_preRotations.size() + m_bindRotations.size()) * sizeof(Quaternion);
+	byteCount += (m_bindTranslations.size() + m_bindScales.size()) * sizeof(Vector3);
+
+	return byteCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of bytes the clip would take as a full matrix per bone per frame, for comparison
+//
+size_t AnimationClip::GetUncompressedMemoryUsageBytes() const
+{
+	return sizeof(AnimationClip) + (size_t)m_numFrames * m_tracks.size() * sizeof(Matrix44);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets the name of the clip
+//
 void AnimationClip::SetName(const std::string& name)
 {
 	m_name = name;
 }
 
-// void AnimationClip::SetFramesPerSecond(float framesPerSecond)
-// {
-// 	m_framesPerSecond = framesPerSecond;
-// }
-// 
-// void AnimationClip::SetDurationSeconds(float durationSeconds)
-// {
-// 	m_durationSeconds = durationSeconds;
-// }
 
-Pose* AnimationClip::CalcuateInterpolatedPose(unsigned int firstPoseIndex, unsigned int secondPoseIndex, float t) const
+//-----------------------------------------------------------------------------------------------
+// Sets how rotations are blended between keys - nlerp is cheaper, slerp keeps a constant angular speed
+//
+void AnimationClip::SetRotationInterpolation(RotationInterpolationMode mode)
 {
-	Pose* firstPose = &m_poses[firstPoseIndex];
-	Pose* secondPose = &m_poses[secondPoseIndex];
-	unsigned int transformCount = firstPose->GetBoneCount();
+	m_rotationInterpolation = mode;
+}
 
-	Pose* result = new Pose();
-	result->Initialize(m_baseSkeleton);
 
-	for (unsigned int transformIndex = 0; transformIndex < transformCount; ++transformIndex)
+//-----------------------------------------------------------------------------------------------
+// Sets the tolerances used by SetBoneTrack() calls after this one
+//
+void AnimationClip::SetCompressionSettings(const AnimationCompressionSettings_t& settings)
+{
+	m_compressionSettings = settings;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the translation of the track at the given frame position
+//
+Vector3 AnimationClip::SampleTranslation(const BoneTrack_t& track, float framePosition) const
+{
+	int firstKey, secondKey;
+	float fraction;
+	FindKeyPair(&m_translationKeyFrames[track.firstTranslationKey], track.translationKeyCount, framePosition, firstKey, secondKey, fraction);
+
+	const Vector3* keys = &m_translationKeys[track.firstTranslationKey];
+	return Interpolate(keys[firstKey], keys[secondKey], fraction);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the rotation of the track at the given frame position
+//
+Quaternion AnimationClip::SampleRotation(const BoneTrack_t& track, float framePosition) const
+{
+	int firstKey, secondKey;
+	float fraction;
+	FindKeyPair(&m_rotationKeyFrames[track.firstRotationKey], track.rotationKeyCount, framePosition, firstKey, secondKey, fraction);
+
+	const QuantizedQuaternion_t* keys = &m_rotationKeys[track.firstRotationKey];
+	Quaternion start = keys[firstKey].Decode();
+
+	if (firstKey == secondKey)
 	{
-		Matrix44 firstTransfrom = firstPose->GetBoneTransform(transformIndex);
-		Matrix44 secondTransfrom = secondPose->GetBoneTransform(transformIndex);
+		return start.GetNormalized();
+	}
+
+	Quaternion end = keys[secondKey].Decode();
 
-		Matrix44 finalTransform = Interpolate(firstTransfrom, secondTransfrom, t);
-		result->SetBoneTransform(transformIndex, finalTransform);
+	if (m_rotationInterpolation == ROTATION_INTERPOLATION_SLERP)
+	{
+		return Quaternion::Slerp(start.GetNormalized(), end.GetNormalized(), fraction);
 	}
 
-	return result;
+	return Quaternion::Nlerp(start, end, fraction);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the scale of the track at the given frame position
+//
+Vector3 AnimationClip::SampleScale(const BoneTrack_t& track, float framePosition) const
+{
+	int firstKey, secondKey;
+	float fraction;
+	FindKeyPair(&m_scaleKeyFrames[track.firstScaleKey], track.scaleKeyCount, framePosition, firstKey, secondKey, fraction);
+
+	const Vector3* keys = &m_scaleKeys[track.firstScaleKey];
+	return Interpolate(keys[firstKey], keys[secondKey], fraction);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Finds the keys on either side of the frame position and how far it is between them
+// Past the last key the second key wraps to the first, which sits one frame past the end
+//
+void AnimationClip::FindKeyPair(const uint16_t* keyFrames, int keyCount, float framePosition, int& out_firstKey, int& out_secondKey, float& out_fraction) const
+{
+	if (keyCount == 1)
+	{
+		out_firstKey = 0;
+		out_secondKey = 0;
+		out_fraction = 0.f;
+		return;
+	}
+
+	// First key with a frame past the position, the key before it is the start of the segment
+	// The first key is always frame 0, so there is always a key before it
+	int firstKeyAfter = (int)(std::upper_bound(keyFrames, keyFrames + keyCount, (uint16_t)framePosition) - keyFrames);
+	out_firstKey = firstKeyAfter - 1;
+
+	float startFrame = (float)keyFrames[out_firstKey];
+	float endFrame;
+
+	if (firstKeyAfter < keyCount)
+	{
+		out_secondKey = firstKeyAfter;
+		endFrame = (float)keyFrames[firstKeyAfter];
+	}
+	else
+	{
+		out_secondKey = 0;
+		endFrame = (float)m_numFrames;
+	}
+
+	out_fraction = (framePosition - startFrame) / (endFrame - startFrame);
 }
@@ -1,34 +1,103 @@
+/************************************************************************/
+/* File: AnimationClip.hpp
+/* Author: Andrew Chase
+/* Date: July 16th, 2018
+/* Description: Class to represent a skeletal animation, stored as a
+/*				compressed translation/rotation/scale track per bone
+/************************************************************************/
 #pragma once
 #include <vector>
+#include <string>
+#include <stdint.h>
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Quaternion.hpp"
 #include "Engine/Rendering/Animation/Pose.hpp"
 
+enum RotationInterpolationMode
+{
+	ROTATION_INTERPOLATION_NLERP,
+	ROTATION_INTERPOLATION_SLERP
+};
+
+// Unit quaternion with each component stored as a 16-bit fixed point value in [-1, 1]
+struct QuantizedQuaternion_t
+{
+	static QuantizedQuaternion_t	Encode(const Quaternion& rotation);
+	Quaternion						Decode() const;
+
+	int16_t s;
+	int16_t x;
+	int16_t y;
+	int16_t z;
+};
+
+// Ranges into the clip's key arrays for one bone
+// A bone with no keys isn't animated and stays at the skeleton's local transform
+struct BoneTrack_t
+{
+	int firstTranslationKey = 0;
+	int translationKeyCount = 0;
+	int firstRotationKey = 0;
+	int rotationKeyCount = 0;
+	int firstScaleKey = 0;
+	int scaleKeyCount = 0;
+};
+
+// Keys are dropped if linearly interpolating their neighbors lands within these of the real value
+struct AnimationCompressionSettings_t
+{
+	float translationTolerance = 0.001f;
+	float rotationToleranceDegrees = 0.1f;
+	float scaleTolerance = 0.001f;
+};
+
+
 class AnimationClip
 {
+	friend class BakeFile;
+
 public:
 	//-----Public Methods-----
 
-	void Initialize(unsigned int numPoses, const Skeleton* skeleton, float framesPerSecond);
+	void	Initialize(unsigned int numFrames, const Skeleton* skeleton, float framesPerSecond);
 
-	// Accessors
-	Pose*	GetPoseAtIndex(unsigned int poseIndex);
+	// Takes one value per frame and compresses them into keys, call once per animated bone
+	void	SetBoneTrack(unsigned int boneIndex, const Vector3* translations, const Quaternion* rotations, const Vector3* scales);
+
+	// Sampling into caller-owned poses, initialized to this clip's skeleton
+	void	SampleLocalPose(float timeSeconds, Pose* out_pose) const;
+	void	SamplePoseAtTime(float timeSeconds, Pose* out_pose) const;
+
+	// Sampling into new poses, which the caller must delete - for tools, not per frame
 	Pose*	CalculatePoseAtTime(float t) const;
 	Pose*	CalculatePoseAtNormalizedTime(float t) const;
 
-	int		GetPoseCount() const;
-	float	GetTotalDurationSeconds() const;
-	float	GetFrameDurationSeconds() const;
+	// Accessors
+	int					GetFrameCount() const;
+	float				GetTotalDurationSeconds() const;
+	float				GetFrameDurationSeconds() const;
+	const std::string&	GetName() const;
+	const Skeleton*		GetSkeleton() const;
+
+	int					GetKeyCount() const;
+	size_t				GetMemoryUsageBytes() const;
+	size_t				GetUncompressedMemoryUsageBytes() const;
 
-	
 	// Mutators
 	void SetName(const std::string& name);
-	//void SetFramesPerSecond(float framesPerSecond);
-	//void SetDurationSeconds(float durationSeconds);
+	void SetRotationInterpolation(RotationInterpolationMode mode);
+	void SetCompressionSettings(const AnimationCompressionSettings_t& settings);
 
 
 private:
 	//-----Private Methods-----
 
-	Pose* CalcuateInterpolatedPose(unsigned int firstPoseIndex, unsigned int secondPoseIndex, float t) const;
+	Vector3		SampleTranslation(const BoneTrack_t& track, float framePosition) const;
+	Quaternion	SampleRotation(const BoneTrack_t& track, float framePosition) const;
+	Vector3		SampleScale(const BoneTrack_t& track, float framePosition) const;
+
+	void		FindKeyPair(const uint16_t* keyFrames, int keyCount, float framePosition, int& out_firstKey, int& out_secondKey, float& out_fraction) const;
 
 
 private:
@@ -36,12 +105,31 @@ private:
 
 	std::string m_name;
 
-	Pose* m_poses = nullptr;
-	unsigned int m_numPoses;
+	unsigned int m_numFrames = 0;
+
+	float m_durationSeconds = 0.f;
+	float m_framesPerSecond = 0.f;
+	float m_frameDuration = 0.f;
+
+	const Skeleton* m_baseSkeleton = nullptr;
+
+	RotationInterpolationMode		m_rotationInterpolation = ROTATION_INTERPOLATION_NLERP;
+	AnimationCompressionSettings_t	m_compressionSettings;
+
+	std::vector<BoneTrack_t> m_tracks;
+
+	// Keys for all bones, each bone's keys are contiguous and start at frame 0
+	std::vector<uint16_t>				m_translationKeyFrames;
+	std::vector<Vector3>				m_translationKeys;
+	std::vector<uint16_t>				m_rotationKeyFrames;
+	std::vector<QuantizedQuaternion_t>	m_rotationKeys;
+	std::vector<uint16_t>				m_scaleKeyFrames;
+	std::vector<Vector3>				m_scaleKeys;
 
-	float m_durationSeconds;
-	float m_framesPerSecond;
-	float m_frameDuration;
+	// Copied from the skeleton so sampling doesn't have to copy whole BoneData_t's
+	std::vector<Quaternion>	m_preRotations;
+	std::vector<Vector3>	m_bindTranslations;
+	std::vector<Quaternion>	m_bindRotations;
+	std::vector<Vector3>	m_bindScales;
 
-	const Skeleton* m_baseSkeleton;
 };
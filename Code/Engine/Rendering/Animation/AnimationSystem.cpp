@@ -0,0 +1,278 @@
+/************************************************************************/
+/* File: AnimationSystem.cpp
+/* Author: Andrew Chase
+/* Date: June 10th, 2019
+/* Description: Implementation of the AnimationSystem class
+/************************************************************************/
+#include "Engine/Core/Time/Time.hpp"
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
+#include "Engine/Rendering/Animation/Pose.hpp"
+#include "Engine/Rendering/Animation/Animator.hpp"
+#include "Engine/Rendering/Buffers/RenderBuffer.hpp"
+#include "Engine/Rendering/Animation/AnimationSystem.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Job for evaluating a group of animators on a worker thread, writing each one's palette to its spot
+//
+class AnimationEvaluateJob : public Job
+{
+public:
+
+	AnimationEvaluateJob()
+	{
+		m_jobType = JOB_TYPE_ANIMATION_UPDATE;
+		m_jobFlags = WORKER_FLAGS_ALL_BUT_DISK;
+	}
+
+	virtual void Execute() override
+	{
+		for (int animatorIndex = 0; animatorIndex < (int)m_animators.size(); ++animatorIndex)
+		{
+			Animator* animator = m_animators[animatorIndex];
+
+			animator->EvaluatePose();
+			animator->GetEvaluatedPose()->WriteSkinningPalette(m_palettes[animatorIndex]);
+		}
+	}
+
+	std::vector<Animator*> m_animators;
+	std::vector<Matrix44*> m_palettes;
+
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+AnimationSystem::~AnimationSystem()
+{
+	delete m_paletteBuffer;
+	m_paletteBuffer = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the animator to be updated each frame
+//
+void AnimationSystem::AddAnimator(Animator* animator)
+{
+	m_animators.push_back(animator);
+	m_paletteOffsets.push_back(-1);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Stops updating the animator, does not delete it
+//
+void AnimationSystem::RemoveAnimator(Animator* animator)
+{
+	for (int animatorIndex = 0; animatorIndex < (int)m_animators.size(); ++animatorIndex)
+	{
+		if (m_animators[animatorIndex] == animator)
+		{
+			m_animators.erase(m_animators.begin() + animatorIndex);
+			m_paletteOffsets.erase(m_paletteOffsets.begin() + animatorIndex);
+			return;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Evaluates every playing animator and writes their skinning palettes, returning once they're all done
+//
+void AnimationSystem::Update()
+{
+	uint64_t startHPC = GetPerformanceCounter();
+
+	// Clock reads and transition bookkeeping all happen here, before any animator is evaluated
+	m_activeAnimatorIndices.clear();
+
+	for (int animatorIndex = 0; animatorIndex < (int)m_animators.size(); ++animatorIndex)
+	{
+		Animator* animator = m_animators[animatorIndex];
+		animator->PrepareUpdate();
+
+		if (animator->IsPlaying())
+		{
+			m_activeAnimatorIndices.push_back(animatorIndex);
+		}
+	}
+
+	AssignPaletteOffsets();
+
+	m_stats.jobCount = 0;
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	bool useJobs = (jobSystem != nullptr && jobSystem->GetWorkerThreadCount(WORKER_FLAGS_ALL_BUT_DISK) > 0);
+
+	if (useJobs)
+	{
+		QueueEvaluationJobs();
+		jobSystem->BlockUntilAllJobsOfTypeAreFinalized(JOB_TYPE_ANIMATION_UPDATE);
+	}
+	else
+	{
+		for (int activeIndex = 0; activeIndex < (int)m_activeAnimatorIndices.size(); ++activeIndex)
+		{
+			int animatorIndex = m_activeAnimatorIndices[activeIndex];
+			Animator* animator = m_animators[animatorIndex];
+
+			animator->EvaluatePose();
+			animator->GetEvaluatedPose()->WriteSkinningPalette(&m_paletteData[m_paletteOffsets[animatorIndex]]);
+		}
+	}
+
+	m_isPaletteBufferDirty = true;
+
+	float updateSeconds = (float)TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - startHPC);
+
+	m_stats.animatorCount = (int)m_activeAnimatorIndices.size();
+	m_stats.updateMilliseconds = updateSeconds * 1000.f;
+	m_stats.charactersPerMillisecond = (m_stats.updateMilliseconds > 0.f ? (float)m_stats.animatorCount / m_stats.updateMilliseconds : 0.f);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Uploads all palettes in one copy if they changed, then binds the buffer to the slot
+// Shaders index the buffer with the animator's palette offset
+//
+void AnimationSystem::BindSkinningPalettes(unsigned int bindSlot)
+{
+	if (m_paletteBuffer == nullptr)
+	{
+		m_paletteBuffer = new RenderBuffer();
+	}
+
+	if (m_isPaletteBufferDirty)
+	{
+		m_paletteBuffer->CopyToGPU(m_paletteData.size() * sizeof(Matrix44), m_paletteData.data());
+		m_isPaletteBufferDirty = false;
+	}
+
+	m_paletteBuffer->Bind(bindSlot);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns where the animator's palette starts in the palette buffer, in matrices
+// Returns -1 if the animator isn't in the system or wasn't playing on the last update
+//
+int AnimationSystem::GetPaletteOffset(const Animator* animator) const
+{
+	for (int animatorIndex = 0; animatorIndex < (int)m_animators.size(); ++animatorIndex)
+	{
+		if (m_animators[animatorIndex] == animator)
+		{
+			return m_paletteOffsets[animatorIndex];
+		}
+	}
+
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the animator's skinning palette from the last update, or nullptr if it doesn't have one
+//
+const Matrix44* AnimationSystem::GetPalette(const Animator* animator) const
+{
+	int paletteOffset = GetPaletteOffset(animator);
+
+	if (paletteOffset < 0)
+	{
+		return nullptr;
+	}
+
+	return &m_paletteData[paletteOffset];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of animators in the system, playing or not
+//
+int AnimationSystem::GetAnimatorCount() const
+{
+	return (int)m_animators.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the timing and counts from the last update
+//
+const AnimationSystemStats_t& AnimationSystem::GetStats() const
+{
+	return m_stats;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Lays the palettes of all playing animators out back to back, and sizes the palette data to fit
+// Only reallocates when the total grows
+//
+void AnimationSystem::AssignPaletteOffsets()
+{
+	int matrixCount = 0;
+	m_stats.boneCount = 0;
+
+	for (int animatorIndex = 0; animatorIndex < (int)m_paletteOffsets.size(); ++animatorIndex)
+	{
+		m_paletteOffsets[animatorIndex] = -1;
+	}
+
+	for (int activeIndex = 0; activeIndex < (int)m_activeAnimatorIndices.size(); ++activeIndex)
+	{
+		int animatorIndex = m_activeAnimatorIndices[activeIndex];
+		int boneCount = m_animators[animatorIndex]->GetBoneCount();
+
+		m_paletteOffsets[animatorIndex] = matrixCount;
+		m_stats.boneCount += boneCount;
+
+		int alignedBoneCount = ((boneCount + PALETTE_ALIGNMENT_MATRICES - 1) / PALETTE_ALIGNMENT_MATRICES) * PALETTE_ALIGNMENT_MATRICES;
+		matrixCount += alignedBoneCount;
+	}
+
+	m_paletteData.resize(matrixCount);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Groups the playing animators into jobs and queues them
+// Each animator is in exactly one job and owns its palette range, so no two threads write the same memory
+//
+void AnimationSystem::QueueEvaluationJobs()
+{
+	AnimationEvaluateJob* currentJob = nullptr;
+	int bonesInCurrentJob = 0;
+
+	for (int activeIndex = 0; activeIndex < (int)m_activeAnimatorIndices.size(); ++activeIndex)
+	{
+		int animatorIndex = m_activeAnimatorIndices[activeIndex];
+		Animator* animator = m_animators[animatorIndex];
+
+		if (currentJob == nullptr)
+		{
+			currentJob = new AnimationEvaluateJob();
+			bonesInCurrentJob = 0;
+		}
+
+		currentJob->m_animators.push_back(animator);
+		currentJob->m_palettes.push_back(&m_paletteData[m_paletteOffsets[animatorIndex]]);
+		bonesInCurrentJob += animator->GetBoneCount();
+
+		if (bonesInCurrentJob >= MIN_BONES_PER_JOB)
+		{
+			QueueJob(currentJob);
+			currentJob = nullptr;
+			m_stats.jobCount++;
+		}
+	}
+
+	if (currentJob != nullptr)
+	{
+		QueueJob(currentJob);
+		m_stats.jobCount++;
+	}
+}
@@ -0,0 +1,82 @@
+/************************************************************************/
+/* File: AnimationSystem.hpp
+/* Author: Andrew Chase
+/* Date: June 10th, 2019
+/* Description: Updates a set of animators each frame, evaluating them on
+/*				the JobSystem's worker threads and writing their skinning
+/*				palettes into one buffer for upload
+/************************************************************************/
+#pragma once
+#include <vector>
+#include "Engine/Math/Matrix44.hpp"
+
+class Animator;
+class RenderBuffer;
+
+struct AnimationSystemStats_t
+{
+	int		animatorCount = 0;
+	int		boneCount = 0;
+	int		jobCount = 0;
+	float	updateMilliseconds = 0.f;
+	float	charactersPerMillisecond = 0.f;
+};
+
+
+class AnimationSystem
+{
+public:
+	//-----Public Methods-----
+
+	AnimationSystem() {}
+	~AnimationSystem();
+
+	void	AddAnimator(Animator* animator);
+	void	RemoveAnimator(Animator* animator);
+
+	void	Update();
+
+	// Uploads the palettes if they changed since the last upload, and binds them as a shader storage buffer
+	void	BindSkinningPalettes(unsigned int bindSlot);
+
+	// Offset of the animator's palette into the palette buffer, in matrices, or -1 if it wasn't updated last frame
+	int				GetPaletteOffset(const Animator* animator) const;
+	const Matrix44*	GetPalette(const Animator* animator) const;
+
+	int							GetAnimatorCount() const;
+	const AnimationSystemStats_t&	GetStats() const;
+
+
+private:
+	//-----Private Methods-----
+
+	void	AssignPaletteOffsets();
+	void	QueueEvaluationJobs();
+
+
+private:
+	//-----Private Data-----
+
+	// Not owned, whoever added an animator is responsible for deleting it
+	std::vector<Animator*>	m_animators;
+	std::vector<int>		m_paletteOffsets;		// Parallel to m_animators
+
+	// Animators that are playing this frame and where their palettes go, rebuilt every update
+	std::vector<int>		m_activeAnimatorIndices;
+
+	// All palettes back to back, written directly by the jobs
+	std::vector<Matrix44>	m_paletteData;
+	RenderBuffer*			m_paletteBuffer = nullptr;	// Made on first bind, so updating alone never touches the GPU
+	bool					m_isPaletteBufferDirty = false;
+
+	AnimationSystemStats_t	m_stats;
+
+	// Palettes start on a multiple of this many matrices (256 bytes), the largest storage buffer
+	// offset alignment drivers commonly require, so each one can also be bound as a range
+	static constexpr int PALETTE_ALIGNMENT_MATRICES = 4;
+
+	// Small animators are grouped into one job until it has at least this many bones, so the
+	// cost of queueing a job isn't more than the work in it
+	static constexpr int MIN_BONES_PER_JOB = 512;
+
+};
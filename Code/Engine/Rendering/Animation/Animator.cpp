@@ -8,9 +8,11 @@
 #include "Engine/Core/Time/Stopwatch.hpp"
 #include "Engine/Rendering/Animation/Animator.hpp"
 #include "Engine/Rendering/Animation/AnimationClip.hpp"
+#include "Engine/Rendering/Animation/Skeleton.hpp"
 #include "Engine/Rendering/DebugRendering/DebugRenderSystem.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Core/Utility/StringUtils.hpp"
+#include "Engine/Core/Utility/ErrorWarningAssert.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
@@ -21,6 +23,7 @@ Animator::Animator()
 	m_currStopwatch = new Stopwatch(nullptr);
 	m_nextStopwatch = new Stopwatch(nullptr);
 	m_transitionStopwatch = new Stopwatch(nullptr);
+	m_layerStopwatch = new Stopwatch(nullptr);
 }
 
 
@@ -37,6 +40,9 @@ Animator::~Animator()
 
 	delete m_transitionStopwatch;
 	m_transitionStopwatch = nullptr;
+
+	delete m_layerStopwatch;
+	m_layerStopwatch = nullptr;
 }
 
 
@@ -80,38 +86,119 @@ void Animator::TransitionToClip(AnimationClip* clip, float transitionTime)
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Plays the clip on top of the current animation, for the bones in the mask
+// The layer loops on its own clock, independent of transitions on the base animation
+//
+void Animator::SetLayer(AnimationClip* clip, const std::vector<float>& boneMask, float weight)
+{
+	m_layerAnimation = clip;
+	m_layerBoneMask = boneMask;
+	m_layerWeight = weight;
+
+	m_layerStopwatch->SetInterval(clip->GetTotalDurationSeconds());
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets how much the layer overrides the base animation, 0 to 1
+//
+void Animator::SetLayerWeight(float weight)
+{
+	m_layerWeight = weight;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Stops playing the layer, leaving just the base animation
+//
+void Animator::ClearLayer()
+{
+	m_layerAnimation = nullptr;
+	m_layerBoneMask.clear();
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Returns the pose to render given the animator's current state
+// All sampling and blending happens in the pooled poses, so nothing is allocated here
 //
 Pose* Animator::GetCurrentPose()
 {
-	if (m_currAnimation == nullptr)
+	PrepareUpdate();
+
+	if (m_evaluation.currentClip == nullptr)
 	{
 		return nullptr;
 	}
 
-	if (m_isTransitioning)
+	EvaluatePose();
+	return &m_posePool[POSE_CURRENT];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the pose from the last EvaluatePose(), without evaluating again
+//
+const Pose* Animator::GetEvaluatedPose() const
+{
+	if (m_poolSkeleton == nullptr)
 	{
-		// Get the blend between the two
+		return nullptr;
+	}
 
-		// Get times
-		float currTimeElapsed = m_currStopwatch->GetElapsedTimeNormalized();
-		float nextTimeElapsed = m_nextStopwatch->GetElapsedTimeNormalized();
+	return &m_posePool[POSE_CURRENT];
+}
 
-		// Get each respective pose
-		Pose* currentPose	= m_currAnimation->CalculatePoseAtNormalizedTime(currTimeElapsed);
-		Pose* nextPose		= m_nextAnimation->CalculatePoseAtNormalizedTime(nextTimeElapsed);
 
-		// Interpolate the poses based on time into transition
-		float transitionTimeNormalized = m_transitionStopwatch->GetElapsedTimeNormalized();
-		int boneCount = currentPose->GetBoneCount();
+//-----------------------------------------------------------------------------------------------
+// Returns true if the animator has a clip playing
+//
+bool Animator::IsPlaying() const
+{
+	return (m_currAnimation != nullptr);
+}
 
-		for (int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
-		{
-			currentPose->SetBoneTransform(boneIndex, Interpolate(currentPose->GetBoneTransform(boneIndex), nextPose->GetBoneTransform(boneIndex), transitionTimeNormalized));
-		}
 
-		// Check if we're done transitioning
+//-----------------------------------------------------------------------------------------------
+// Returns the number of bones the animator's pose will have, 0 if nothing is playing
+//
+int Animator::GetBoneCount() const
+{
+	if (m_currAnimation == nullptr)
+	{
+		return 0;
+	}
+
+	return (int)m_currAnimation->GetSkeleton()->GetBoneCount();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Reads the clocks and decides which clips to sample this frame, finishing transitions
+// Must be called on the main thread, before EvaluatePose()
+//
+void Animator::PrepareUpdate()
+{
+	m_evaluation = AnimatorEvaluation_t();
+
+	if (m_currAnimation == nullptr)
+	{
+		return;
+	}
+
+	InitializePosePool(m_currAnimation->GetSkeleton());
+
+	m_evaluation.currentClip = m_currAnimation;
+	m_evaluation.currentTime = GetClipTime(m_currAnimation, m_currStopwatch);
+
+	if (m_isTransitioning)
+	{
+		m_evaluation.nextClip = m_nextAnimation;
+		m_evaluation.nextTime = GetClipTime(m_nextAnimation, m_nextStopwatch);
+		m_evaluation.transitionFraction = ClampFloatZeroToOne(m_transitionStopwatch->GetElapsedTimeNormalized());
+
+		// Check if we're done transitioning, this frame still blends
 		if (m_transitionStopwatch->HasIntervalElapsed())
 		{
 			m_currAnimation = m_nextAnimation;
@@ -124,15 +211,85 @@ Pose* Animator::GetCurrentPose()
 
 			m_isTransitioning = false;
 		}
+	}
 
-		// Return the result, cleaning up
-		delete nextPose; 
-		return currentPose;
+	if (m_layerAnimation != nullptr && m_layerWeight > 0.f)
+	{
+		m_evaluation.layerClip = m_layerAnimation;
+		m_evaluation.layerTime = GetClipTime(m_layerAnimation, m_layerStopwatch);
+		m_evaluation.layerWeight = m_layerWeight;
 	}
-	else
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Samples and blends the clips chosen in PrepareUpdate() and builds the model space matrices
+// Only touches this animator's poses, so different animators can be evaluated on different threads
+//
+void Animator::EvaluatePose()
+{
+	if (m_evaluation.currentClip == nullptr)
 	{
-		// Just return the pose at time
-		float timeElapsed = m_currStopwatch->GetElapsedTimeNormalized();
-		return m_currAnimation->CalculatePoseAtNormalizedTime(timeElapsed);
+		return;
 	}
+
+	Pose& currentPose = m_posePool[POSE_CURRENT];
+	SampleClip(m_evaluation.currentClip, m_evaluation.currentTime, currentPose);
+
+	if (m_evaluation.nextClip != nullptr)
+	{
+		Pose& nextPose = m_posePool[POSE_NEXT];
+		SampleClip(m_evaluation.nextClip, m_evaluation.nextTime, nextPose);
+
+		Pose::Blend(currentPose, nextPose, m_evaluation.transitionFraction, currentPose);
+	}
+
+	if (m_evaluation.layerClip != nullptr)
+	{
+		Pose& layerPose = m_posePool[POSE_LAYER];
+		SampleClip(m_evaluation.layerClip, m_evaluation.layerTime, layerPose);
+
+		Pose::BlendMasked(currentPose, layerPose, m_layerBoneMask, m_evaluation.layerWeight, currentPose);
+	}
+
+	currentPose.ConstructWorldMatrices();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sizes the pooled poses for the skeleton, only doing work when the skeleton changes
+//
+void Animator::InitializePosePool(const Skeleton* skeleton)
+{
+	if (m_poolSkeleton == skeleton)
+	{
+		return;
+	}
+
+	for (int poseIndex = 0; poseIndex < NUM_POOLED_POSES; ++poseIndex)
+	{
+		m_posePool[poseIndex].Initialize(skeleton);
+	}
+
+	m_poolSkeleton = skeleton;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the time into the clip the stopwatch is at, in seconds
+//
+float Animator::GetClipTime(const AnimationClip* clip, const Stopwatch* stopwatch) const
+{
+	return stopwatch->GetElapsedTimeNormalized() * clip->GetTotalDurationSeconds();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Samples the local transforms of the clip at the given time into the pose
+//
+void Animator::SampleClip(const AnimationClip* clip, float timeSeconds, Pose& out_pose) const
+{
+	ASSERT_OR_DIE(clip->GetSkeleton() == m_poolSkeleton, "Error: Animator is blending clips that use different skeletons");
+
+	clip->SampleLocalPose(timeSeconds, &out_pose);
 }
@@ -5,11 +5,29 @@
 /* Description: Class to represent a skeletal animator
 /************************************************************************/
 #pragma once
+#include <vector>
+#include "Engine/Rendering/Animation/Pose.hpp"
 
-class Pose;
+class Skeleton;
 class Stopwatch;
 class AnimationClip;
 
+// What the animator will sample on its next evaluation, captured on the main thread
+struct AnimatorEvaluation_t
+{
+	const AnimationClip*	currentClip = nullptr;
+	float					currentTime = 0.f;
+
+	const AnimationClip*	nextClip = nullptr;
+	float					nextTime = 0.f;
+	float					transitionFraction = 0.f;
+
+	const AnimationClip*	layerClip = nullptr;
+	float					layerTime = 0.f;
+	float					layerWeight = 0.f;
+};
+
+
 class Animator
 {
 public:
@@ -23,13 +41,47 @@ public:
 	void	Play(AnimationClip* clip);
 	void	TransitionToClip(AnimationClip* clip, float transitionTime);
 
+	// Plays a second clip over the bones in the mask, weighted per bone (see Pose::BuildBoneMask())
+	void	SetLayer(AnimationClip* clip, const std::vector<float>& boneMask, float weight);
+	void	SetLayerWeight(float weight);
+	void	ClearLayer();
+
 	// Accessors
-	Pose*	GetCurrentPose();
+	// The pose is owned by the animator and is overwritten on the next call
+	Pose*		GetCurrentPose();
+	const Pose*	GetEvaluatedPose() const;
+	bool		IsPlaying() const;
+	int			GetBoneCount() const;
+
+	// Split update, used by the AnimationSystem to evaluate animators in parallel
+	// GetCurrentPose() is the two together
+	void		PrepareUpdate();
+	void		EvaluatePose();
+
+
+private:
+	//-----Private Methods-----
+
+	void	InitializePosePool(const Skeleton* skeleton);
+	float	GetClipTime(const AnimationClip* clip, const Stopwatch* stopwatch) const;
+	void	SampleClip(const AnimationClip* clip, float timeSeconds, Pose& out_pose) const;
 
 
 private:
 	//-----Private Data-----
 
+	// Poses are reused every frame, so getting the current pose doesn't allocate
+	enum ePooledPose
+	{
+		POSE_CURRENT,
+		POSE_NEXT,
+		POSE_LAYER,
+		NUM_POOLED_POSES
+	};
+
+	Pose			m_posePool[NUM_POOLED_POSES];
+	const Skeleton*	m_poolSkeleton			= nullptr;
+
 	AnimationClip*	m_currAnimation = nullptr;
 	AnimationClip*	m_nextAnimation = nullptr;
 
@@ -40,4 +92,11 @@ private:
 	bool			m_isPaused				= false;
 	bool			m_isTransitioning		= false;
 
+	AnimationClip*		m_layerAnimation	= nullptr;
+	Stopwatch*			m_layerStopwatch	= nullptr;
+	std::vector<float>	m_layerBoneMask;
+	float				m_layerWeight		= 1.0f;
+
+	AnimatorEvaluation_t	m_evaluation;
+
 };
@@ -0,0 +1,326 @@
+/************************************************************************/
+/* File: CPUSkinnedMesh.cpp
+/* Author: Andrew Chase
+/* Date: June 11th, 2019
+/* Description: Implementation of the CPUSkinnedMesh class
+/************************************************************************/
+#include <float.h>
+#include <xmmintrin.h>
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Rendering/Meshes/Mesh.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
+#include "Engine/Rendering/Animation/CPUSkinnedMesh.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns an inverted box that any point will grow to contain
+//
+static AABB3 MakeEmptyBounds()
+{
+	return AABB3(Vector3(FLT_MAX, FLT_MAX, FLT_MAX), Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Grows the bounds to contain the other bounds
+//
+static void UnionBounds(AABB3& bounds, const AABB3& other)
+{
+	bounds.mins = Vector3(MinFloat(bounds.mins.x, other.mins.x), MinFloat(bounds.mins.y, other.mins.y), MinFloat(bounds.mins.z, other.mins.z));
+	bounds.maxs = Vector3(MaxFloat(bounds.maxs.x, other.maxs.x), MaxFloat(bounds.maxs.y, other.maxs.y), MaxFloat(bounds.maxs.z, other.maxs.z));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Normalizes the xyz of the vector, leaving it alone if it has no length
+//
+static inline __m128 NormalizeXYZ(const __m128& vector)
+{
+	__m128 squared = _mm_mul_ps(vector, vector);
+	__m128 lengthSquared = _mm_add_ss(squared, _mm_add_ss(_mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 2, 2, 2))));
+
+	if (_mm_cvtss_f32(lengthSquared) <= 0.f)
+	{
+		return vector;
+	}
+
+	return _mm_div_ps(vector, _mm_sqrt_ps(_mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(0, 0, 0, 0))));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns i * x + j * y + k * z, the direction transformed by the basis
+//
+static inline __m128 TransformDirection(const __m128& i, const __m128& j, const __m128& k, float x, float y, float z)
+{
+	__m128 result = _mm_mul_ps(i, _mm_set1_ps(x));
+	result = _mm_add_ps(result, _mm_mul_ps(j, _mm_set1_ps(y)));
+	result = _mm_add_ps(result, _mm_mul_ps(k, _mm_set1_ps(z)));
+
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Job for skinning a range of one mesh's vertices on a worker thread
+// The bounds of the range are merged into the mesh's bounds when finalized on the main thread
+//
+class CPUSkinningJob : public Job
+{
+public:
+
+	CPUSkinningJob(CPUSkinnedMesh* mesh, const Matrix44* palette, int firstVertex, int vertexCount)
+		: m_mesh(mesh), m_palette(palette), m_firstVertex(firstVertex), m_vertexCount(vertexCount)
+	{
+		m_jobType = JOB_TYPE_CPU_SKINNING;
+		m_jobFlags = WORKER_FLAGS_ALL_BUT_DISK;
+	}
+
+	virtual void Execute() override
+	{
+		m_bounds = MakeEmptyBounds();
+		m_mesh->SkinRange(m_palette, m_firstVertex, m_vertexCount, m_bounds);
+	}
+
+	virtual void Finalize() override
+	{
+		UnionBounds(m_mesh->m_skinnedBounds, m_bounds);
+	}
+
+	CPUSkinnedMesh*	m_mesh = nullptr;
+	const Matrix44*	m_palette = nullptr;
+	int				m_firstVertex = 0;
+	int				m_vertexCount = 0;
+	AABB3			m_bounds;
+
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Copies the bind pose vertices and indices, and sets up the output vertices
+//
+void CPUSkinnedMesh::Initialize(const VertexSkinned* vertices, int vertexCount, const unsigned int* indices, int indexCount)
+{
+	m_sourceVertices.assign(vertices, vertices + vertexCount);
+	m_indices.assign(indices, indices + indexCount);
+
+	m_skinnedVertices.resize(vertexCount);
+	m_bindBounds = MakeEmptyBounds();
+
+	for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const VertexSkinned& source = vertices[vertexIndex];
+		m_skinnedVertices[vertexIndex] = VertexLit(source.m_position, source.m_color, source.m_texUVs, source.m_normal, source.m_tangent);
+
+		UnionBounds(m_bindBounds, AABB3(source.m_position, source.m_position));
+	}
+
+	if (vertexCount == 0)
+	{
+		m_bindBounds = AABB3(Vector3::ZERO, Vector3::ZERO);
+	}
+
+	m_skinnedBounds = m_bindBounds;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Skins the mesh with the palette, returning once done
+//
+void CPUSkinnedMesh::Skin(const Matrix44* palette)
+{
+	CPUSkinnedMesh* mesh = this;
+	SkinMeshes(&mesh, &palette, 1);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Skins each mesh with its palette, returning once all are done
+// All meshes are queued before waiting, so small meshes still keep every worker busy
+//
+void CPUSkinnedMesh::SkinMeshes(CPUSkinnedMesh* const* meshes, const Matrix44* const* palettes, int meshCount)
+{
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	bool useJobs = (jobSystem != nullptr && jobSystem->GetWorkerThreadCount(WORKER_FLAGS_ALL_BUT_DISK) > 0);
+
+	for (int meshIndex = 0; meshIndex < meshCount; ++meshIndex)
+	{
+		CPUSkinnedMesh* mesh = meshes[meshIndex];
+		int vertexCount = mesh->GetVertexCount();
+
+		if (vertexCount == 0)
+		{
+			continue;
+		}
+
+		mesh->m_skinnedBounds = MakeEmptyBounds();
+
+		if (!useJobs)
+		{
+			mesh->SkinRange(palettes[meshIndex], 0, vertexCount, mesh->m_skinnedBounds);
+			continue;
+		}
+
+		for (int firstVertex = 0; firstVertex < vertexCount; firstVertex += MIN_VERTICES_PER_JOB)
+		{
+			int rangeCount = MinInt(MIN_VERTICES_PER_JOB, vertexCount - firstVertex);
+			QueueJob(new CPUSkinningJob(mesh, palettes[meshIndex], firstVertex, rangeCount));
+		}
+	}
+
+	if (useJobs)
+	{
+		jobSystem->BlockUntilAllJobsOfTypeAreFinalized(JOB_TYPE_CPU_SKINNING);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Skins the vertices in the range, one vertex at a time with the four bone matrices blended in SSE
+// Vertices with no weights are left in the bind pose
+//
+void CPUSkinnedMesh::SkinRange(const Matrix44* palette, int firstVertex, int vertexCount, AABB3& out_bounds)
+{
+	__m128 boundsMin = _mm_setr_ps(out_bounds.mins.x, out_bounds.mins.y, out_bounds.mins.z, 0.f);
+	__m128 boundsMax = _mm_setr_ps(out_bounds.maxs.x, out_bounds.maxs.y, out_bounds.maxs.z, 0.f);
+
+	__m128 identityI = _mm_setr_ps(1.f, 0.f, 0.f, 0.f);
+	__m128 identityJ = _mm_setr_ps(0.f, 1.f, 0.f, 0.f);
+	__m128 identityK = _mm_setr_ps(0.f, 0.f, 1.f, 0.f);
+	__m128 identityT = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+
+	float result[4];
+	int endVertex = firstVertex + vertexCount;
+
+	for (int vertexIndex = firstVertex; vertexIndex < endVertex; ++vertexIndex)
+	{
+		const VertexSkinned& source = m_sourceVertices[vertexIndex];
+
+		// Weighted sum of the bone matrices, one basis vector per register
+		__m128 blendedI = _mm_setzero_ps();
+		__m128 blendedJ = _mm_setzero_ps();
+		__m128 blendedK = _mm_setzero_ps();
+		__m128 blendedT = _mm_setzero_ps();
+		float totalWeight = 0.f;
+
+		for (int influenceIndex = 0; influenceIndex < MAX_BONES_PER_VERTEX; ++influenceIndex)
+		{
+			float weight = source.m_boneWeights[influenceIndex];
+
+			if (weight <= 0.f)
+			{
+				continue;
+			}
+
+			const Matrix44& boneMatrix = palette[source.m_bones[influenceIndex]];
+			__m128 weight4 = _mm_set1_ps(weight);
+
+			blendedI = _mm_add_ps(blendedI, _mm_mul_ps(_mm_loadu_ps(&boneMatrix.Ix), weight4));
+			blendedJ = _mm_add_ps(blendedJ, _mm_mul_ps(_mm_loadu_ps(&boneMatrix.Jx), weight4));
+			blendedK = _mm_add_ps(blendedK, _mm_mul_ps(_mm_loadu_ps(&boneMatrix.Kx), weight4));
+			blendedT = _mm_add_ps(blendedT, _mm_mul_ps(_mm_loadu_ps(&boneMatrix.Tx), weight4));
+
+			totalWeight += weight;
+		}
+
+		if (totalWeight <= 0.f)
+		{
+			blendedI = identityI;
+			blendedJ = identityJ;
+			blendedK = identityK;
+			blendedT = identityT;
+		}
+
+		VertexLit& skinned = m_skinnedVertices[vertexIndex];
+
+		// Position
+		__m128 position = _mm_add_ps(TransformDirection(blendedI, blendedJ, blendedK, source.m_position.x, source.m_position.y, source.m_position.z), blendedT);
+		_mm_storeu_ps(result, position);
+		skinned.m_position = Vector3(result[0], result[1], result[2]);
+
+		boundsMin = _mm_min_ps(boundsMin, position);
+		boundsMax = _mm_max_ps(boundsMax, position);
+
+		// Normal and tangent, renormalized since the blended matrix may not be a pure rotation
+		__m128 normal = NormalizeXYZ(TransformDirection(blendedI, blendedJ, blendedK, source.m_normal.x, source.m_normal.y, source.m_normal.z));
+		_mm_storeu_ps(result, normal);
+		skinned.m_normal = Vector3(result[0], result[1], result[2]);
+
+		__m128 tangent = NormalizeXYZ(TransformDirection(blendedI, blendedJ, blendedK, source.m_tangent.x, source.m_tangent.y, source.m_tangent.z));
+		_mm_storeu_ps(result, tangent);
+		skinned.m_tangent = Vector4(result[0], result[1], result[2], source.m_tangent.w);
+	}
+
+	_mm_storeu_ps(result, boundsMin);
+	out_bounds.mins = Vector3(result[0], result[1], result[2]);
+
+	_mm_storeu_ps(result, boundsMax);
+	out_bounds.maxs = Vector3(result[0], result[1], result[2]);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Uploads the last skinned vertices and the indices to the mesh
+//
+void CPUSkinnedMesh::UpdateMesh(Mesh& out_mesh) const
+{
+	out_mesh.SetVertices((unsigned int)m_skinnedVertices.size(), m_skinnedVertices.data());
+	out_mesh.SetIndices((unsigned int)m_indices.size(), m_indices.data());
+	out_mesh.SetDrawInstruction(PRIMITIVE_TRIANGLES, true, 0, (unsigned int)m_indices.size());
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of vertices in the mesh
+//
+int CPUSkinnedMesh::GetVertexCount() const
+{
+	return (int)m_sourceVertices.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of indices in the mesh, three per triangle
+//
+int CPUSkinnedMesh::GetIndexCount() const
+{
+	return (int)m_indices.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the vertices from the last skin, or the bind pose if it hasn't been skinned
+//
+const VertexLit* CPUSkinnedMesh::GetSkinnedVertices() const
+{
+	return m_skinnedVertices.data();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the triangle indices into the vertices
+//
+const unsigned int* CPUSkinnedMesh::GetIndices() const
+{
+	return m_indices.data();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the bounds of the vertices from the last skin, in the palette's space
+//
+const AABB3& CPUSkinnedMesh::GetSkinnedBounds() const
+{
+	return m_skinnedBounds;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the bounds of the mesh in its bind pose
+//
+const AABB3& CPUSkinnedMesh::GetBindBounds() const
+{
+	return m_bindBounds;
+}
@@ -0,0 +1,60 @@
+/************************************************************************/
+/* File: CPUSkinnedMesh.hpp
+/* Author: Andrew Chase
+/* Date: June 11th, 2019
+/* Description: Skinned mesh data kept on the CPU and skinned there with
+/*				SSE, for bounds, hit detection, and rendering without
+/*				the skinning shader
+/************************************************************************/
+#pragma once
+#include <vector>
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Rendering/Core/Vertex.hpp"
+
+class Mesh;
+class Matrix44;
+
+class CPUSkinnedMesh
+{
+	friend class CPUSkinningJob;
+
+public:
+	//-----Public Methods-----
+
+	void	Initialize(const VertexSkinned* vertices, int vertexCount, const unsigned int* indices, int indexCount);
+
+	// Skins every vertex with the palette (see Pose::WriteSkinningPalette()), split into jobs when there are workers
+	void		Skin(const Matrix44* palette);
+	static void	SkinMeshes(CPUSkinnedMesh* const* meshes, const Matrix44* const* palettes, int meshCount);
+
+	// Skins part of the mesh on the calling thread, growing the bounds to contain the skinned positions
+	void	SkinRange(const Matrix44* palette, int firstVertex, int vertexCount, AABB3& out_bounds);
+
+	// Uploads the skinned vertices as VertexLit, to draw without the skinning shader
+	void	UpdateMesh(Mesh& out_mesh) const;
+
+	// Accessors
+	int					GetVertexCount() const;
+	int					GetIndexCount() const;
+	const VertexLit*	GetSkinnedVertices() const;
+	const unsigned int*	GetIndices() const;
+	const AABB3&		GetSkinnedBounds() const;
+	const AABB3&		GetBindBounds() const;
+
+
+private:
+	//-----Private Data-----
+
+	// Bind pose vertices
+	std::vector<VertexSkinned>	m_sourceVertices;
+	std::vector<unsigned int>	m_indices;
+	AABB3						m_bindBounds;
+
+	// Results of the last skin, colors and UVs are copied once on initialize
+	std::vector<VertexLit>		m_skinnedVertices;
+	AABB3						m_skinnedBounds;
+
+	// Meshes with fewer vertices than this are skinned in one job
+	static constexpr int MIN_VERTICES_PER_JOB = 4096;
+
+};
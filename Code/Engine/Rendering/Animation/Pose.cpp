@@ -5,40 +5,67 @@
 /* Description: Implementation of the Pose class
 /************************************************************************/
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DeveloperConsole/DevConsole.hpp"
 #include "Engine/Rendering/Animation/Pose.hpp"
 #include "Engine/Rendering/Animation/Skeleton.hpp"
 
 
 //-----------------------------------------------------------------------------------------------
-// Destructor
+// Returns the matrix translation * rotation * scale, without the three matrix multiplies
 //
-Pose::~Pose()
+static Matrix44 MakeTRSMatrix(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
 {
-	if (m_boneTransforms != NULL)
-	{
-		free(m_boneTransforms);
-		m_boneTransforms = NULL;
-	}
+	Matrix44 result = Matrix44::MakeRotation(rotation);
+
+	result.Ix *= scale.x;
+	result.Iy *= scale.x;
+	result.Iz *= scale.x;
+
+	result.Jx *= scale.y;
+	result.Jy *= scale.y;
+	result.Jz *= scale.y;
+
+	result.Kx *= scale.z;
+	result.Ky *= scale.z;
+	result.Kz *= scale.z;
+
+	result.Tx = translation.x;
+	result.Ty = translation.y;
+	result.Tz = translation.z;
+
+	return result;
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Initializes the pose for the given skeleton
+// Initializes the pose for the given skeleton, set to the skeleton's bind pose
 //
 void Pose::Initialize(const Skeleton* skeleton)
 {
 	// Only support up to 150 bones
 	int numBones = skeleton->GetBoneCount();
-	ASSERT_OR_DIE(numBones <= 150, 
-		Stringf("Error: Pose::Initialize called for skeleton with more than 100 bones, unsupported. Count was %i", numBones));
+	ASSERT_OR_DIE(numBones <= 150,
+		Stringf("Error: Pose::Initialize called for skeleton with more than 150 bones, unsupported. Count was %i", numBones));
+
+	m_boneTransforms.resize(numBones);
+	m_localTranslations.resize(numBones);
+	m_localRotations.resize(numBones);
+	m_localScales.resize(numBones);
 
-	m_boneTransforms = (Matrix44*) malloc (sizeof(Matrix44) * numBones);
 	m_boneCount = numBones;
 	m_skeleton = skeleton;
 
+	const Matrix44* bindLocalTransforms = skeleton->GetLocalTransforms();
+
 	for (int i = 0; i < numBones; ++i)
 	{
-		m_boneTransforms[i] = skeleton->GetBoneData(i).localTransform;
+		const Matrix44& bindLocalTransform = bindLocalTransforms[i];
+
+		m_boneTransforms[i] = bindLocalTransform;
+
+		m_localTranslations[i] = Matrix44::ExtractTranslation(bindLocalTransform);
+		m_localRotations[i] = Quaternion::FromMatrix(bindLocalTransform);
+		m_localScales[i] = Matrix44::ExtractScale(bindLocalTransform);
 	}
 }
 
@@ -48,7 +75,7 @@ void Pose::Initialize(const Skeleton* skeleton)
 //
 const Matrix44* Pose::GetTotalBoneData() const
 {
-	return m_boneTransforms;
+	return m_boneTransforms.data();
 }
 
 
@@ -61,6 +88,33 @@ const Skeleton* Pose::GetSkeleton() const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns the translation of the bone relative to its parent
+//
+Vector3 Pose::GetLocalTranslation(unsigned int boneIndex) const
+{
+	return m_localTranslations[boneIndex];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the rotation of the bone relative to its parent
+//
+Quaternion Pose::GetLocalRotation(unsigned int boneIndex) const
+{
+	return m_localRotations[boneIndex];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the scale of the bone relative to its parent
+//
+Vector3 Pose::GetLocalScale(unsigned int boneIndex) const
+{
+	return m_localScales[boneIndex];
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Sets the bone transform at the given index to the transform specified
 //
@@ -73,25 +127,53 @@ void Pose::SetBoneTransform(unsigned int index, const Matrix44& transform)
 
 
 //-----------------------------------------------------------------------------------------------
-// Converts all locally-defined bone transforms in the pose into world-space transforms through
-// concatenation
+// Sets the transform of the bone relative to its parent
+//
+void Pose::SetLocalTransform(unsigned int boneIndex, const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+{
+	m_localTranslations[boneIndex] = translation;
+	m_localRotations[boneIndex] = rotation;
+	m_localScales[boneIndex] = scale;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Builds model space matrices for all bones from their local transforms by concatenating parents
 //
 void Pose::ConstructWorldMatrices()
 {
+	const int* parentIndices = m_skeleton->GetParentIndices();
+
 	for (int boneIndex = 0; boneIndex < (int) m_boneCount; ++boneIndex)
-	{	
-		BoneData_t boneData = m_skeleton->GetBoneData(boneIndex);
+	{
+		Matrix44 localMatrix = MakeTRSMatrix(m_localTranslations[boneIndex], m_localRotations[boneIndex], m_localScales[boneIndex]);
 
-		int parentIndex = boneData.parentIndex;
+		int parentIndex = parentIndices[boneIndex];
 		ASSERT_OR_DIE(parentIndex < boneIndex, Stringf("Child was before parent in the pose transform array."));
 
 		if (parentIndex >= 0)
 		{
-			Matrix44 localMatrix = m_boneTransforms[boneIndex];
-			Matrix44 parentMatrix = m_boneTransforms[parentIndex];
-
-			m_boneTransforms[boneIndex] = parentMatrix * localMatrix;
+			m_boneTransforms[boneIndex] = m_boneTransforms[parentIndex] * localMatrix;
 		}
+		else
+		{
+			m_boneTransforms[boneIndex] = localMatrix;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Writes the final skinning matrix for every bone into the palette, which must fit GetBoneCount() matrices
+// Call after ConstructWorldMatrices()
+//
+void Pose::WriteSkinningPalette(Matrix44* out_palette) const
+{
+	const Matrix44* meshToBoneMatrices = m_skeleton->GetMeshToBoneMatrices();
+
+	for (unsigned int boneIndex = 0; boneIndex < m_boneCount; ++boneIndex)
+	{
+		out_palette[boneIndex] = m_boneTransforms[boneIndex] * meshToBoneMatrices[boneIndex];
 	}
 }
 
@@ -114,3 +196,105 @@ unsigned int Pose::GetBoneCount() const
 {
 	return m_boneCount;
 }
+
+
+//-----------------------------------------------------------------------------------------------
+// Interpolates every bone between the two poses
+//
+void Pose::Blend(const Pose& start, const Pose& end, float fractionTowardEnd, Pose& out_pose)
+{
+	ASSERT_OR_DIE(start.m_boneCount == end.m_boneCount && start.m_boneCount == out_pose.m_boneCount, "Error: Pose::Blend() poses have different bone counts");
+
+	for (unsigned int boneIndex = 0; boneIndex < start.m_boneCount; ++boneIndex)
+	{
+		out_pose.m_localTranslations[boneIndex] = Interpolate(start.m_localTranslations[boneIndex], end.m_localTranslations[boneIndex], fractionTowardEnd);
+		out_pose.m_localRotations[boneIndex] = Quaternion::Nlerp(start.m_localRotations[boneIndex], end.m_localRotations[boneIndex], fractionTowardEnd);
+		out_pose.m_localScales[boneIndex] = Interpolate(start.m_localScales[boneIndex], end.m_localScales[boneIndex], fractionTowardEnd);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Interpolates each bone toward the layer by the layer weight scaled by that bone's weight
+// Bones with a weight of zero are left as the base, without any interpolation
+//
+void Pose::BlendMasked(const Pose& base, const Pose& layer, const std::vector<float>& boneWeights, float layerWeight, Pose& out_pose)
+{
+	ASSERT_OR_DIE(base.m_boneCount == layer.m_boneCount && base.m_boneCount == out_pose.m_boneCount, "Error: Pose::BlendMasked() poses have different bone counts");
+	ASSERT_OR_DIE(boneWeights.size() >= base.m_boneCount, "Error: Pose::BlendMasked() mask doesn't have a weight for every bone");
+
+	for (unsigned int boneIndex = 0; boneIndex < base.m_boneCount; ++boneIndex)
+	{
+		float weight = boneWeights[boneIndex] * layerWeight;
+
+		if (weight <= 0.f)
+		{
+			out_pose.m_localTranslations[boneIndex] = base.m_localTranslations[boneIndex];
+			out_pose.m_localRotations[boneIndex] = base.m_localRotations[boneIndex];
+			out_pose.m_localScales[boneIndex] = base.m_localScales[boneIndex];
+			continue;
+		}
+
+		out_pose.m_localTranslations[boneIndex] = Interpolate(base.m_localTranslations[boneIndex], layer.m_localTranslations[boneIndex], weight);
+		out_pose.m_localRotations[boneIndex] = Quaternion::Nlerp(base.m_localRotations[boneIndex], layer.m_localRotations[boneIndex], weight);
+		out_pose.m_localScales[boneIndex] = Interpolate(base.m_localScales[boneIndex], layer.m_localScales[boneIndex], weight);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the difference between the additive pose and its reference pose on top of the base
+// i.e. the reference is the additive clip's neutral pose, usually its first frame
+//
+void Pose::BlendAdditive(const Pose& base, const Pose& additive, const Pose& additiveReference, float weight, Pose& out_pose)
+{
+	ASSERT_OR_DIE(base.m_boneCount == additive.m_boneCount && base.m_boneCount == additiveReference.m_boneCount && base.m_boneCount == out_pose.m_boneCount,
+		"Error: Pose::BlendAdditive() poses have different bone counts");
+
+	for (unsigned int boneIndex = 0; boneIndex < base.m_boneCount; ++boneIndex)
+	{
+		Vector3 translationDelta = additive.m_localTranslations[boneIndex] - additiveReference.m_localTranslations[boneIndex];
+		Vector3 scaleDelta = additive.m_localScales[boneIndex] - additiveReference.m_localScales[boneIndex];
+
+		// Rotation from the reference to the additive, applied in the bone's local space
+		Quaternion rotationDelta = additiveReference.m_localRotations[boneIndex].GetConjugate() * additive.m_localRotations[boneIndex];
+		Quaternion weightedRotationDelta = Quaternion::Nlerp(Quaternion::IDENTITY, rotationDelta, weight);
+
+		out_pose.m_localTranslations[boneIndex] = base.m_localTranslations[boneIndex] + translationDelta * weight;
+		out_pose.m_localRotations[boneIndex] = base.m_localRotations[boneIndex] * weightedRotationDelta;
+		out_pose.m_localScales[boneIndex] = base.m_localScales[boneIndex] + scaleDelta * weight;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Makes a per-bone weight array that is 1 for the given bone and its descendants, 0 elsewhere
+// Relies on parents always coming before their children, same as ConstructWorldMatrices()
+//
+void Pose::BuildBoneMask(const Skeleton* skeleton, const std::string& rootBoneName, std::vector<float>& out_boneWeights)
+{
+	int boneCount = (int)skeleton->GetBoneCount();
+	int rootBoneIndex = skeleton->GetBoneMapping(rootBoneName);
+	const int* parentIndices = skeleton->GetParentIndices();
+
+	out_boneWeights.clear();
+	out_boneWeights.resize(boneCount, 0.f);
+
+	if (rootBoneIndex < 0)
+	{
+		ConsoleWarningf("Pose::BuildBoneMask() couldn't find bone \"%s\", mask is empty", rootBoneName.c_str());
+		return;
+	}
+
+	out_boneWeights[rootBoneIndex] = 1.0f;
+
+	for (int boneIndex = rootBoneIndex + 1; boneIndex < boneCount; ++boneIndex)
+	{
+		int parentIndex = parentIndices[boneIndex];
+
+		if (parentIndex >= 0 && out_boneWeights[parentIndex] > 0.f)
+		{
+			out_boneWeights[boneIndex] = 1.0f;
+		}
+	}
+}
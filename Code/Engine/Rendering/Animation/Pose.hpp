@@ -2,12 +2,15 @@
 /* File: Pose.hpp
 /* Author: Andrew Chase
 /* Date: July 16th, 2018
-/* Description: Class to represent a single state of a skeleton 
+/* Description: Class to represent a single state of a skeleton
 				(single frame of an animation clip)
 /************************************************************************/
 #pragma once
 #include <vector>
+#include <string>
+#include "Engine/Math/Vector3.hpp"
 #include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Quaternion.hpp"
 
 class Skeleton;
 
@@ -17,8 +20,10 @@ public:
 	//-----Public Methods-----
 
 	Pose() {}
-	~Pose();
+	~Pose() {}
+	Pose(const Pose& copy) = delete;
 
+	// Storage is only reallocated if the skeleton has more bones than the pose has held before
 	void			Initialize(const Skeleton* skeleton);
 
 	// Accessors
@@ -27,18 +32,40 @@ public:
 	const Matrix44* GetTotalBoneData() const;
 	const Skeleton* GetSkeleton() const;
 
+	Vector3			GetLocalTranslation(unsigned int boneIndex) const;
+	Quaternion		GetLocalRotation(unsigned int boneIndex) const;
+	Vector3			GetLocalScale(unsigned int boneIndex) const;
 
 	// Mutators
 	void			SetBoneTransform(unsigned int index, const Matrix44& transform);
+	void			SetLocalTransform(unsigned int boneIndex, const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
 	void			ConstructWorldMatrices();
 
+	// Writes model space * inverse bind pose for every bone, the matrices the skinning shader wants
+	void			WriteSkinningPalette(Matrix44* out_palette) const;
+
+	// Blending, done on the local transforms - the output can be one of the inputs
+	// Call ConstructWorldMatrices() on the output afterwards
+	static void		Blend(const Pose& start, const Pose& end, float fractionTowardEnd, Pose& out_pose);
+	static void		BlendMasked(const Pose& base, const Pose& layer, const std::vector<float>& boneWeights, float layerWeight, Pose& out_pose);
+	static void		BlendAdditive(const Pose& base, const Pose& additive, const Pose& additiveReference, float weight, Pose& out_pose);
+
+	// Makes a per-bone weight array that is 1 for the given bone and its descendants, 0 elsewhere
+	static void		BuildBoneMask(const Skeleton* skeleton, const std::string& rootBoneName, std::vector<float>& out_boneWeights);
+
 
 private:
 	//-----Private Data-----
 
-	Matrix44* m_boneTransforms = nullptr;
+	// Model space matrices, or whatever was last set with SetBoneTransform()
+	std::vector<Matrix44> m_boneTransforms;
 	unsigned int m_boneCount = 0;
 
-	const Skeleton* m_skeleton;
+	// Local space transforms, relative to the parent bone
+	std::vector<Vector3>	m_localTranslations;
+	std::vector<Quaternion>	m_localRotations;
+	std::vector<Vector3>	m_localScales;
+
+	const Skeleton* m_skeleton = nullptr;
 
 };
@@ -55,6 +55,10 @@ int Skeleton::CreateOrGetBoneMapping(const std::string& boneName)
 		m_boneData.push_back(BoneData_t());
 		m_boneNameMappings[boneName] = boneIndex;
 
+		m_parentIndices.push_back(-1);
+		m_localTransforms.push_back(Matrix44());
+		m_meshToBoneMatrices.push_back(Matrix44());
+
 		// Also add the name to the name's list
 		m_boneNames.push_back(boneName);
 	}
@@ -81,6 +85,33 @@ std::vector<std::string> Skeleton::GetAllBoneNames() const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns the parent index of every bone, -1 for the root
+//
+const int* Skeleton::GetParentIndices() const
+{
+	return m_parentIndices.data();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the transform of every bone relative to its parent, in the bind pose
+//
+const Matrix44* Skeleton::GetLocalTransforms() const
+{
+	return m_localTransforms.data();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the inverse bind pose of every bone
+//
+const Matrix44* Skeleton::GetMeshToBoneMatrices() const
+{
+	return m_meshToBoneMatrices.data();
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Returns the number of bones in the skeleton
 //
@@ -107,6 +138,7 @@ void Skeleton::SetLocalTransform(unsigned int boneIndex, const Matrix44& localTr
 	ASSERT_OR_DIE(boneIndex < m_boneData.size(), Stringf("Error: SkeletonBase::SetLocalTransform received index out of bounds - size is %i, index is %i.", m_boneData.size(), boneIndex));
 
 	m_boneData[boneIndex].localTransform = localTransform;
+	m_localTransforms[boneIndex] = localTransform;
 }
 
 
@@ -133,6 +165,7 @@ void Skeleton::SetParentBoneIndex(unsigned int boneIndex, int parentBoneIndex)
 	}
 
 	m_boneData[boneIndex].parentIndex = parentBoneIndex;
+	m_parentIndices[boneIndex] = parentBoneIndex;
 }
 
 
@@ -144,6 +177,7 @@ void Skeleton::SetMeshToBoneMatrix(unsigned int boneIndex, const Matrix44& meshT
 	ASSERT_OR_DIE(boneIndex < m_boneData.size(), Stringf("Error: SkeletonBase::SetBindPose received index out of bounds - size is %i, index is %i.", m_boneData.size(), boneIndex));
 
 	m_boneData[boneIndex].meshToBoneMatrix = meshToBoneTransform;
+	m_meshToBoneMatrices[boneIndex] = meshToBoneTransform;
 }
 
 
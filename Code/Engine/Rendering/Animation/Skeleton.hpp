@@ -38,6 +38,11 @@ public:
 
 	std::vector<std::string> GetAllBoneNames() const;
 
+	// Flat per-bone arrays, for per-frame code that only needs one field of every bone
+	const int*		GetParentIndices() const;
+	const Matrix44*	GetLocalTransforms() const;
+	const Matrix44*	GetMeshToBoneMatrices() const;
+
 	// Mutators
 	void SetBoneToMeshMatrix(unsigned int boneIndex, const Matrix44& offsetMatrix);
 	void SetLocalTransform(unsigned int boneIndex, const Matrix44& localTransform);
@@ -55,4 +60,9 @@ private:
 	std::vector<BoneData_t>				m_boneData;				// Collection of bone information (transforms, parent indices)
 	std::vector<std::string>			m_boneNames;			// Names of all bones in the skeleton
 
+	// Copies of the BoneData_t fields read every frame, kept in sync by the setters
+	std::vector<int>					m_parentIndices;
+	std::vector<Matrix44>				m_localTransforms;
+	std::vector<Matrix44>				m_meshToBoneMatrices;
+
 };
@@ -73,7 +73,7 @@ void Camera::TranslateLocal(const Vector3& localTranslation)
 //
 Vector3 Camera::Rotate(const Vector3& rotation)
 {
-	Vector3 newRotation = m_transform.rotation + rotation;
+	Vector3 newRotation = m_transform.GetRotation() + rotation;
 	SetRotation(newRotation);
 
 	return newRotation;
@@ -106,7 +106,7 @@ void Camera::SetTransform(const Transform& transform)
 //
 void Camera::SetPosition(const Vector3& position)
 {
-	m_transform.position = position;
+	m_transform.SetPosition(position);
 	m_viewMatrix = InvertLookAtMatrix(m_transform.GetWorldMatrix());
 }
 
@@ -145,9 +145,6 @@ void Camera::LookAt(const Vector3& position, const Vector3& target, const Vector
 {
 	Matrix44 cameraMatrix = Matrix44::MakeLookAt(position, target, up);
 
-	m_transform.position = position;
-	m_transform.rotation = Matrix44::ExtractRotationDegrees(cameraMatrix);
-
 	m_transform.SetModelMatrix(cameraMatrix);
 	m_viewMatrix = InvertLookAtMatrix(cameraMatrix);
 }
@@ -271,7 +268,7 @@ void Camera::FinalizeUniformBuffer()
 	bufferData.m_cameraX	= GetIVector();
 	bufferData.m_cameraY	= GetJVector();
 	bufferData.m_cameraZ	= GetKVector();
-	bufferData.m_cameraPosition = m_transform.position;
+	bufferData.m_cameraPosition = m_transform.GetPosition();
 
 	bufferData.m_inverseViewProjection = Matrix44::GetInverse(m_viewMatrix) * Matrix44::GetInverse(m_projectionMatrix * m_changeOfBasisMatrix);
 	
@@ -330,7 +327,7 @@ Vector3 Camera::GetPosition() const
 //
 Vector3 Camera::GetRotation() const
 {
-	return m_transform.rotation;
+	return m_transform.GetRotation();
 }
 
 
@@ -120,13 +120,23 @@ bool DrawCall::SetDataFromRenderable(Renderable* renderable, int dcIndex)
 		return false;
 	}
 
-	for (int instanceIndex = 0; instanceIndex < numMatrices; ++instanceIndex)
+	Matrix44 drawMatrix = renderable->GetDraw(dcIndex).drawMatrix;
+	const Matrix44* instanceMatrices = renderable->GetInstanceMatrixData();
+
+	// Most draws have no draw matrix, so the instance matrices can be copied as one block
+	if (drawMatrix == Matrix44::IDENTITY)
+	{
+		m_drawMatrices.assign(instanceMatrices, instanceMatrices + numMatrices);
+	}
+	else
 	{
-		Matrix44 instanceMatrix = renderable->GetInstanceMatrix(instanceIndex);
-		Matrix44 drawMatrix = renderable->GetDraw(dcIndex).drawMatrix;
+		m_drawMatrices.reserve(numMatrices);
 
-		Matrix44 matrixForRender = instanceMatrix * drawMatrix;
-		m_drawMatrices.push_back(matrixForRender);
+		for (int instanceIndex = 0; instanceIndex < numMatrices; ++instanceIndex)
+		{
+			Matrix44 matrixForRender = instanceMatrices[instanceIndex] * drawMatrix;
+			m_drawMatrices.push_back(matrixForRender);
+		}
 	}
 
 	const Shader* shader = m_material->GetShader();
@@ -0,0 +1,175 @@
+/************************************************************************/
+/* File: ImmediateBatch.cpp
+/* Author: Andrew Chase
+/* Date: June 3rd, 2019
+/* Description: Implementation of the ImmediateBatch class
+/************************************************************************/
+#include "Engine/Rendering/Core/ImmediateBatch.hpp"
+#include "Engine/Core/Utility/ErrorWarningAssert.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets the draw state for the batch, which must be empty
+//
+void ImmediateBatch::Begin(Material* material, PrimitiveType primitiveType, float lineWidth)
+{
+	ASSERT_OR_DIE(IsEmpty(), "Error: ImmediateBatch::Begin() called on a batch that wasn't flushed");
+
+	m_material = material;
+	m_primitiveType = primitiveType;
+	m_lineWidth = lineWidth;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends the vertices to the batch, offsetting the given indices by the vertices already in the batch
+// If no indices are given the vertices are indexed in order
+//
+void ImmediateBatch::Append(const Vertex3D_PCU* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+	unsigned int baseIndex = (unsigned int)m_vertices.size();
+	m_vertices.insert(m_vertices.end(), vertices, vertices + vertexCount);
+
+	if (indices != nullptr)
+	{
+		for (unsigned int index = 0; index < indexCount; ++index)
+		{
+			m_indices.push_back(baseIndex + indices[index]);
+		}
+	}
+	else
+	{
+		for (unsigned int index = 0; index < vertexCount; ++index)
+		{
+			m_indices.push_back(baseIndex + index);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Pushes a single vertex to the batch, the caller is responsible for indexing it
+//
+void ImmediateBatch::PushVertex(const Vertex3D_PCU& vertex)
+{
+	m_vertices.push_back(vertex);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Pushes a single index to the batch, as an absolute index into the batch's vertices
+//
+void ImmediateBatch::PushIndex(unsigned int index)
+{
+	m_indices.push_back(index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Empties the batch, keeping the memory around for the next batch
+//
+void ImmediateBatch::Clear()
+{
+	m_vertices.clear();
+	m_indices.clear();
+	m_material = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if there is no geometry in the batch
+//
+bool ImmediateBatch::IsEmpty() const
+{
+	return (m_indices.size() == 0);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if geometry with the given state can be added to this batch without a flush
+//
+bool ImmediateBatch::CanAccept(Material* material, PrimitiveType primitiveType, float lineWidth) const
+{
+	if (IsEmpty())
+	{
+		return true;
+	}
+
+	// Line width only affects line and point draws
+	bool lineWidthMatters = (primitiveType != PRIMITIVE_TRIANGLES);
+
+	return (material == m_material && primitiveType == m_primitiveType && (!lineWidthMatters || lineWidth == m_lineWidth));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the material the batch will be drawn with
+//
+Material* ImmediateBatch::GetMaterial() const
+{
+	return m_material;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the primitive type of the batch
+//
+PrimitiveType ImmediateBatch::GetPrimitiveType() const
+{
+	return m_primitiveType;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the line width the batch will be drawn with
+//
+float ImmediateBatch::GetLineWidth() const
+{
+	return m_lineWidth;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of vertices in the batch
+//
+unsigned int ImmediateBatch::GetVertexCount() const
+{
+	return (unsigned int)m_vertices.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of indices in the batch
+//
+unsigned int ImmediateBatch::GetIndexCount() const
+{
+	return (unsigned int)m_indices.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the vertex buffer of the batch
+//
+const Vertex3D_PCU* ImmediateBatch::GetVertexData() const
+{
+	return m_vertices.data();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the index buffer of the batch
+//
+const unsigned int* ImmediateBatch::GetIndexData() const
+{
+	return m_indices.data();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the primitive type can be concatenated into a single indexed list
+// Quads are drawn immediately, as they can't be indexed
+//
+bool ImmediateBatch::IsBatchablePrimitive(PrimitiveType primitiveType)
+{
+	return (primitiveType == PRIMITIVE_TRIANGLES || primitiveType == PRIMITIVE_LINES || primitiveType == PRIMITIVE_POINTS);
+}
@@ -0,0 +1,56 @@
+/************************************************************************/
+/* File: ImmediateBatch.hpp
+/* Author: Andrew Chase
+/* Date: June 3rd, 2019
+/* Description: Class to accumulate immediate-mode PCU geometry that
+/*				shares the same draw state, so it can be drawn in one call
+/************************************************************************/
+#pragma once
+#include <vector>
+#include "Engine/Rendering/Core/Vertex.hpp"
+#include "Engine/Rendering/OpenGL/glTypes.hpp"
+
+class Material;
+
+class ImmediateBatch
+{
+public:
+	//-----Public Methods-----
+
+	// Mutators
+	void			Begin(Material* material, PrimitiveType primitiveType, float lineWidth);
+	void			Append(const Vertex3D_PCU* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+	void			PushVertex(const Vertex3D_PCU& vertex);
+	void			PushIndex(unsigned int index);
+	void			Clear();
+
+	// Accessors
+	bool			IsEmpty() const;
+	bool			CanAccept(Material* material, PrimitiveType primitiveType, float lineWidth) const;
+
+	Material*		GetMaterial() const;
+	PrimitiveType	GetPrimitiveType() const;
+	float			GetLineWidth() const;
+
+	unsigned int		GetVertexCount() const;
+	unsigned int		GetIndexCount() const;
+	const Vertex3D_PCU*	GetVertexData() const;
+	const unsigned int*	GetIndexData() const;
+
+	// Producers
+	static bool		IsBatchablePrimitive(PrimitiveType primitiveType);
+
+
+private:
+	//-----Private Data-----
+
+	// Draw state shared by everything in the batch
+	Material*					m_material = nullptr;
+	PrimitiveType				m_primitiveType = PRIMITIVE_TRIANGLES;
+	float						m_lineWidth = 1.0f;
+
+	// Geometry is always stored indexed, so indexed and non-indexed submissions can be mixed
+	std::vector<Vertex3D_PCU>	m_vertices;
+	std::vector<unsigned int>	m_indices;
+
+};
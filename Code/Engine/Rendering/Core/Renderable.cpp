@@ -72,6 +72,16 @@ void Renderable::RemoveInstanceMatrix(unsigned int instanceIndex)
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Resizes the instance list to the given count, for when all matrices are written at once through
+// GetInstanceMatrixData(); new matrices are identity until written
+//
+void Renderable::SetInstanceCount(unsigned int instanceCount)
+{
+	m_instanceModels.resize(instanceCount);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Sets the mesh of the draw at the given index to the given mesh
 //
@@ -174,6 +184,15 @@ Matrix44 Renderable::GetInstanceMatrix(unsigned int instanceIndex) const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns the contiguous array of instance matrices, GetInstanceCount() long, for writing in bulk
+//
+Matrix44* Renderable::GetInstanceMatrixData()
+{
+	return m_instanceModels.data();
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Returns the instance material if one was created, otherwise returns the shared material
 //
@@ -37,6 +37,7 @@ public:
 	void SetInstanceMatrix(unsigned int instanceIndex, const Matrix44& model);
 	void AddInstanceMatrix(const Matrix44& model);
 	void RemoveInstanceMatrix(unsigned int instanceIndex);
+	void SetInstanceCount(unsigned int instanceCount);
 
 	void SetMesh(unsigned int index, Mesh* mesh);
 	void SetModelMatrix(unsigned int index, const Matrix44& model);
@@ -51,6 +52,7 @@ public:
 	Material*			GetSharedMaterial(unsigned int drawIndex) const;
 	Material*			GetMaterialInstance(unsigned int drawIndex);
 	Matrix44			GetInstanceMatrix(unsigned int instanceIndex) const;
+	Matrix44*			GetInstanceMatrixData();
 
 	Material*			GetMaterialForRender(unsigned int drawIndex) const;
 
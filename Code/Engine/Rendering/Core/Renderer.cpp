@@ -130,6 +130,15 @@ Renderer::~Renderer()
 	delete m_UICamera;
 	delete m_effectsCamera;
 
+	// Delete the cached font materials
+	std::map<const BitmapFont*, Material*>::iterator itr = m_fontMaterials.begin();
+	for (itr; itr != m_fontMaterials.end(); itr++)
+	{
+		delete itr->second;
+	}
+
+	m_fontMaterials.clear();
+
 	// Free the vao 
 	glDeleteVertexArrays(1, &m_defaultVAO);
 	GL_CHECK_ERROR();
@@ -189,6 +198,20 @@ void Renderer::BeginFrame()
 
 	// Clear the lights, making the game reset them
 	DisableAllLights();
+
+	// Reset the batch counts for the new frame
+	m_immediateStatsLastFrame = m_immediateStatsThisFrame;
+	m_immediateStatsThisFrame = ImmediateBatchStats_t();
+
+	// Reload assets whose files changed, so the frame draws with all of one version or the other
+	AssetDB::ReloadChangedAssets();
+
+	// Upload assets that finished loading on other threads, before anything draws with them
+	FinalizeAsyncFileReads();
+	AssetDB::FinalizeAsyncLoads();
+
+	// Then make room for them, if they pushed the AssetDB over its budget
+	AssetDB::EvictUnusedAssets();
 }
 
 
@@ -197,6 +220,9 @@ void Renderer::BeginFrame()
 //
 void Renderer::EndFrame()
 {
+	// Draw anything still waiting in the immediate batch
+	FlushImmediateBatch();
+
 	// Copy the default frame buffer to the back buffer before swapping
 	m_defaultCamera->FinalizeFrameBuffer();
 	CopyFrameBuffer( nullptr, &m_defaultCamera->m_frameBuffer ); 
@@ -238,6 +264,8 @@ void Renderer::EndFrame()
 //
 void Renderer::ClearScreen(const Rgba& clearColor)
 {
+	FlushImmediateBatch();
+
 	float red, green, blue, alpha;
 	clearColor.GetAsFloats(red, green, blue, alpha);
 
@@ -251,6 +279,8 @@ void Renderer::ClearScreen(const Rgba& clearColor)
 //
 void Renderer::ClearScreen(const Vector3& clearColor)
 {
+	FlushImmediateBatch();
+
 	glClearColor(clearColor.x, clearColor.y, clearColor.z, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT);
 }
@@ -396,17 +426,9 @@ void Renderer::Draw2DQuad(const AABB2& bounds, const AABB2& textureUVs, const Rg
 	m_immediateBuilder.BeginBuilding(PRIMITIVE_TRIANGLES, true);
 	m_immediateBuilder.Push2DQuad(bounds, textureUVs, tint);
 	m_immediateBuilder.FinishBuilding();
-	m_immediateBuilder.UpdateMesh(m_immediateMesh);
 
-	// Draw
-	if (material == nullptr)
-	{
-		DrawMesh(&m_immediateMesh);
-	}
-	else
-	{
-		DrawMeshWithMaterial(&m_immediateMesh, material);
-	}
+	// Add to the batch, it will be drawn once the draw state changes
+	SubmitImmediateBuilder(PRIMITIVE_TRIANGLES, material, m_currentLineWidth);
 }
 
 
@@ -493,17 +515,9 @@ void Renderer::DrawWireCube(const Vector3& center, const Vector3& dimensions, co
 	m_immediateBuilder.PushLine(Vector3(mins.x, maxs.y, mins.z), Vector3(mins.x, maxs.y, maxs.z), tint);
 
 	m_immediateBuilder.FinishBuilding();
-	m_immediateBuilder.UpdateMesh<Vertex3D_PCU>(m_immediateMesh);
 
-	// Draw
-	if (material == nullptr)
-	{
-		DrawMesh(&m_immediateMesh);
-	}
-	else
-	{
-		DrawMeshWithMaterial(&m_immediateMesh, material);
-	}
+	// Add to the batch, it will be drawn once the draw state changes
+	SubmitImmediateBuilder(PRIMITIVE_LINES, material, m_currentLineWidth);
 }
 
 
@@ -633,14 +647,10 @@ void Renderer::DrawText2D(const std::string& text, const Vector2& drawMins, floa
 
 	// Construct the Mesh
 	m_immediateBuilder.FinishBuilding();
-	m_immediateBuilder.UpdateMesh(m_immediateMesh);
-
-	// Set the texture and draw
-	Material fontMat = Material();
-	fontMat.SetDiffuse(&font->GetSpriteSheet().GetTexture());
-	fontMat.SetShader(AssetDB::CreateOrGetShader("UI"));
 
-	DrawMeshWithMaterial(&m_immediateMesh, &fontMat);
+	// Batch with the font's material, so consecutive text draws become one draw
+	Material* fontMaterial = GetOrCreateFontMaterial(font);
+	SubmitImmediateBuilder(PRIMITIVE_TRIANGLES, fontMaterial, m_currentLineWidth);
 }
 
 
@@ -699,6 +709,9 @@ void SaveScreenshotToFile(void* args)
 //
 void Renderer::SetCurrentCamera(Camera* camera)
 {
+	// Anything batched was submitted for the previous camera
+	FlushImmediateBatch();
+
 	// passing in nullptr resets the current camera to the default one
 	if (camera == nullptr) {
 		camera = m_defaultCamera; 
@@ -1076,7 +1089,9 @@ void Renderer::BindRenderState(const RenderState& state) const
 //
 void Renderer::SetGLLineWidth(float lineWidth)
 {
+	// Batches remember their own line width, so no flush is needed here
 	glLineWidth(lineWidth);
+	m_currentLineWidth = lineWidth;
 }
 
 
@@ -1137,6 +1152,9 @@ void Renderer::DeleteVAO(unsigned int& vaoHandle) const
 //
 void Renderer::Draw(const DrawCall& drawCall)
 {
+	// Keep submission order - anything batched before this draw needs to be drawn first
+	FlushImmediateBatch();
+
 	// Bind all the state
 	BindVAO(drawCall.GetVAOHandle());
 	BindMaterial(drawCall.GetMaterial()); 
@@ -1244,6 +1262,9 @@ void Renderer::DrawMesh(Mesh* mesh)
 //
 void Renderer::DrawMeshWithMaterial(Mesh* mesh, Material* material)
 {
+	// Draw anything batched first, since drawing the batch also uses the immediate renderable
+	FlushImmediateBatch();
+
 	RenderableDraw_t draw;
 	draw.sharedMaterial = material;
 	draw.mesh = mesh;
@@ -1262,6 +1283,8 @@ void Renderer::DrawMeshWithMaterial(Mesh* mesh, Material* material)
 //
 void Renderer::DrawRenderable(Renderable* renderable)
 {
+	FlushImmediateBatch();
+
 	int numDraws = renderable->GetDrawCountPerInstance();
 
 	for (int drawIndex = 0; drawIndex < numDraws; ++drawIndex)
@@ -1278,6 +1301,8 @@ void Renderer::DrawRenderable(Renderable* renderable)
 //
 void Renderer::ClearDepth(float clearDepth /*= 1.0f*/)
 {
+	FlushImmediateBatch();
+
 	glDepthMask(GL_TRUE);
 	glClearDepthf(clearDepth);
 	glClear(GL_DEPTH_BUFFER_BIT);
@@ -1568,37 +1593,228 @@ void Renderer::UpdateTimeData()
 
 //-----------------------------------------------------------------------------------------------
 // Draws to the screen given the vertices and the draw primitive type
+// The draw is batched with the previous immediate draws if they share the same state
 //
 void Renderer::DrawMeshImmediate(const Vertex3D_PCU* vertices, int vertexCount, PrimitiveType primitiveType /*= PRIMITIVE_TRIANGLES*/, const unsigned int* indices /*= nullptr*/, int indexCount /*= -1*/, Material* material/*= nullptr*/)
 {
-	m_immediateMesh.SetVertices(vertexCount, vertices);
-
 	bool isUsingIndices = indices != nullptr;
-	if (isUsingIndices)
+	SubmitImmediate(vertices, (unsigned int)vertexCount, primitiveType, indices, (isUsingIndices ? (unsigned int)indexCount : 0), material, m_currentLineWidth);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Draws everything accumulated in the immediate batch in a single draw, and empties the batch
+//
+void Renderer::FlushImmediateBatch()
+{
+	if (m_immediateBatch.IsEmpty())
 	{
-		m_immediateMesh.SetIndices(indexCount, indices);
+		return;
 	}
-	
-	DrawInstruction instruction;
 
-	instruction.m_primType = primitiveType;
-	instruction.m_startIndex = 0;
-	instruction.m_usingIndices = isUsingIndices;
-	instruction.m_elementCount = (isUsingIndices ? indexCount : vertexCount);
+	// Upload the batch to the immediate mesh
+	unsigned int indexCount = m_immediateBatch.GetIndexCount();
+
+	m_immediateBatchMesh.SetVertices(m_immediateBatch.GetVertexCount(), m_immediateBatch.GetVertexData());
+	m_immediateBatchMesh.SetIndices(indexCount, m_immediateBatch.GetIndexData());
+	m_immediateBatchMesh.SetDrawInstruction(m_immediateBatch.GetPrimitiveType(), true, 0, indexCount);
+
+	Material* material = m_immediateBatch.GetMaterial();
+	float lineWidth = m_immediateBatch.GetLineWidth();
+
+	// Clear before drawing, so the draw below doesn't try to flush again
+	m_immediateBatch.Clear();
+
+	glLineWidth(lineWidth);
+	DrawMeshWithMaterial(&m_immediateBatchMesh, material);
+	glLineWidth(m_currentLineWidth);
+
+	m_immediateStatsThisFrame.drawCount++;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Flushes the immediate batch only if it's drawn with the given material
+//
+void Renderer::FlushImmediateBatchUsing(const Material* material)
+{
+	if (!m_immediateBatch.IsEmpty() && m_immediateBatch.GetMaterial() == material)
+	{
+		FlushImmediateBatch();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets whether immediate draws are batched; if disabled they are drawn as soon as they are submitted
+//
+void Renderer::SetImmediateBatchingEnabled(bool isEnabled)
+{
+	FlushImmediateBatch();
+	m_isImmediateBatchingEnabled = isEnabled;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if immediate draws are being batched
+//
+bool Renderer::IsImmediateBatchingEnabled() const
+{
+	return m_isImmediateBatchingEnabled;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the immediate draw counts of the last completed frame
+//
+ImmediateBatchStats_t Renderer::GetImmediateBatchStatsLastFrame() const
+{
+	return m_immediateStatsLastFrame;
+}
+
 
-	m_immediateMesh.SetDrawInstruction(instruction);
+//-----------------------------------------------------------------------------------------------
+// Adds the given geometry to the immediate batch, flushing the batch first if the state differs
+// Primitives that can't be concatenated are drawn right away
+//
+void Renderer::SubmitImmediate(const Vertex3D_PCU* vertices, unsigned int vertexCount, PrimitiveType primitiveType, const unsigned int* indices, unsigned int indexCount, Material* material, float lineWidth)
+{
+	m_immediateStatsThisFrame.submissionCount++;
 
 	if (material == nullptr)
 	{
-		DrawMesh(&m_immediateMesh);
+		material = AssetDB::CreateOrGetSharedMaterial("Default_Opaque");
 	}
-	else
+
+	// Can't batch, so draw what we have and then draw this right away
+	if (!ImmediateBatch::IsBatchablePrimitive(primitiveType))
 	{
+		FlushImmediateBatch();
+
+		m_immediateMesh.SetVertices(vertexCount, vertices);
+
+		bool isUsingIndices = (indices != nullptr);
+		if (isUsingIndices)
+		{
+			m_immediateMesh.SetIndices(indexCount, indices);
+		}
+
+		m_immediateMesh.SetDrawInstruction(primitiveType, isUsingIndices, 0, (isUsingIndices ? indexCount : vertexCount));
+
+		glLineWidth(lineWidth);
 		DrawMeshWithMaterial(&m_immediateMesh, material);
+		glLineWidth(m_currentLineWidth);
+
+		m_immediateStatsThisFrame.drawCount++;
+		return;
+	}
+
+	if (!m_immediateBatch.CanAccept(material, primitiveType, lineWidth))
+	{
+		FlushImmediateBatch();
+	}
+
+	if (m_immediateBatch.IsEmpty())
+	{
+		m_immediateBatch.Begin(material, primitiveType, lineWidth);
+	}
+
+	m_immediateBatch.Append(vertices, vertexCount, indices, indexCount);
+
+	if (!m_isImmediateBatchingEnabled)
+	{
+		FlushImmediateBatch();
 	}
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Adds the contents of the immediate builder to the immediate batch as PCU vertices
+//
+void Renderer::SubmitImmediateBuilder(PrimitiveType primitiveType, Material* material, float lineWidth)
+{
+	m_immediateStatsThisFrame.submissionCount++;
+
+	if (material == nullptr)
+	{
+		material = AssetDB::CreateOrGetSharedMaterial("Default_Opaque");
+	}
+
+	// Can't batch, so draw what we have and then draw this right away
+	if (!ImmediateBatch::IsBatchablePrimitive(primitiveType))
+	{
+		FlushImmediateBatch();
+
+		m_immediateBuilder.UpdateMesh<Vertex3D_PCU>(m_immediateMesh);
+		DrawMeshWithMaterial(&m_immediateMesh, material);
+
+		m_immediateStatsThisFrame.drawCount++;
+		return;
+	}
+
+	if (!m_immediateBatch.CanAccept(material, primitiveType, lineWidth))
+	{
+		FlushImmediateBatch();
+	}
+
+	if (m_immediateBatch.IsEmpty())
+	{
+		m_immediateBatch.Begin(material, primitiveType, lineWidth);
+	}
+
+	// Convert straight into the batch, no intermediate buffer
+	unsigned int baseIndex = m_immediateBatch.GetVertexCount();
+	int vertexCount = m_immediateBuilder.GetVertexCount();
+	int indexCount = m_immediateBuilder.GetIndexCount();
+
+	for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		m_immediateBatch.PushVertex(m_immediateBuilder.GetVertex<Vertex3D_PCU>(vertexIndex));
+	}
+
+	if (indexCount > 0)
+	{
+		for (int indexIndex = 0; indexIndex < indexCount; ++indexIndex)
+		{
+			m_immediateBatch.PushIndex(baseIndex + m_immediateBuilder.GetIndex(indexIndex));
+		}
+	}
+	else
+	{
+		for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			m_immediateBatch.PushIndex(baseIndex + vertexIndex);
+		}
+	}
+
+	if (!m_isImmediateBatchingEnabled)
+	{
+		FlushImmediateBatch();
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the material used to draw text with the given font, creating it if it doesn't exist
+//
+Material* Renderer::GetOrCreateFontMaterial(const BitmapFont* font)
+{
+	bool alreadyExists = m_fontMaterials.find(font) != m_fontMaterials.end();
+	if (alreadyExists)
+	{
+		return m_fontMaterials[font];
+	}
+
+	Material* fontMaterial = new Material();
+	fontMaterial->SetDiffuse(&font->GetSpriteSheet().GetTexture());
+	fontMaterial->SetShader(AssetDB::CreateOrGetShader("UI"));
+
+	m_fontMaterials[font] = fontMaterial;
+
+	return fontMaterial;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Draws a point at the given position with the given color and size
 //
@@ -1636,16 +1852,13 @@ void Renderer::DrawPoint(const Vector3& position, const Rgba& color, float radiu
 //
 void Renderer::Draw3DLine(const Vector3& startPos, const Rgba& startColor, const Vector3& endPos, const Rgba& endColor, float width/*=1.0f*/, Material* material /*= nullptr*/)
 {
-	SetGLLineWidth(width);
-
 	Vertex3D_PCU vertices[2];
 
 	vertices[0] = Vertex3D_PCU(startPos, startColor, Vector2::ZERO);
 	vertices[1] = Vertex3D_PCU(endPos, endColor, Vector2::ZERO);
 
-	DrawMeshImmediate(vertices, 2, PRIMITIVE_LINES, nullptr, -1, material);
-
-	SetGLLineWidth(1.0f);
+	// Width is kept with the batch, so lines of the same width batch together
+	SubmitImmediate(vertices, 2, PRIMITIVE_LINES, nullptr, 0, material, width);
 }
 
 
@@ -1654,6 +1867,8 @@ void Renderer::Draw3DLine(const Vector3& startPos, const Rgba& startColor, const
 //
 bool Renderer::CopyFrameBuffer( FrameBuffer *destination, FrameBuffer *source )
 {
+	FlushImmediateBatch();
+
 	// we need at least the src.
 	if (source == nullptr) 
 	{
@@ -6,6 +6,7 @@
 /* Description: Class used to call OpenGL functions to draw to screen
 /************************************************************************/
 #pragma once
+#include <map>
 #include <string>
 #include <vector>
 #include "Engine/Core/Rgba.hpp"
@@ -20,6 +21,7 @@
 #include "Engine/Rendering/Core/Renderable.hpp"
 #include "Engine/Rendering/Meshes/MeshBuilder.hpp"
 #include "Engine/Rendering/Buffers/UniformBuffer.hpp"
+#include "Engine/Rendering/Core/ImmediateBatch.hpp"
 // Defines
 #define TIME_BUFFER_BINDING (0)		// Updated once per frame
 #define CAMERA_BUFFER_BINDING (1)	// Updated ~once per frame
@@ -48,6 +50,13 @@ enum TextDrawMode
 	NUM_TEXT_DRAW_MODES
 };
 
+// Counts for immediate draws, to see how well they are batching
+struct ImmediateBatchStats_t
+{
+	int submissionCount = 0;	// Number of immediate draw functions called
+	int drawCount = 0;			// Number of GPU draws those submissions resulted in
+};
+
 
 class Renderer
 {
@@ -129,6 +138,14 @@ private:
 public:
 	//-----Drawing-----
 
+	// Immediate batching - consecutive draws with the same material pointer are merged, so Materials call
+	// FlushImmediateBatchUsing() before they change or are destroyed, and pending geometry is drawn with the state
+	// it was submitted with. Edits made through GetPropertyBlock() or GetEditableShader() aren't seen, flush before those
+	void FlushImmediateBatch();
+	void FlushImmediateBatchUsing(const Material* material);
+	void SetImmediateBatchingEnabled(bool isEnabled);
+	bool IsImmediateBatchingEnabled() const;
+
 	// For ALL drawing
 	void DrawMeshImmediate(const Vertex3D_PCU* verts, int numVerts, PrimitiveType drawPrimitive = PRIMITIVE_TRIANGLES, const unsigned int* indices = nullptr, int numIndices = -1, Material* material = nullptr);
 	void DrawMesh(Mesh* mesh);
@@ -208,6 +225,8 @@ public:
 
 	const Sampler*	GetDefaultSampler() const;
 
+	ImmediateBatchStats_t GetImmediateBatchStatsLastFrame() const;
+
 
 private:
 	//-----Private Methods-----	
@@ -222,6 +241,11 @@ private:
 	void DrawTextInBox2D_ShrinkToFit(const std::string& text, const AABB2& box, const Vector2& alignment, float cellHeight, BitmapFont* font, Rgba color=Rgba::WHITE, float aspectScale=1.0f);
 	void DrawTextInBox2D_WordWrap(const std::string& text, const AABB2& box, const Vector2& alignment, float cellHeight, BitmapFont* font, Rgba color=Rgba::WHITE, float aspectScale=1.0f);
 
+	// Immediate batching helpers
+	void SubmitImmediate(const Vertex3D_PCU* vertices, unsigned int vertexCount, PrimitiveType primitiveType, const unsigned int* indices, unsigned int indexCount, Material* material, float lineWidth);
+	void SubmitImmediateBuilder(PrimitiveType primitiveType, Material* material, float lineWidth);
+	Material* GetOrCreateFontMaterial(const BitmapFont* font);
+
 	// For setting up the renderer after the OpenGL context is made
 	void PostGLStartup();
 
@@ -243,6 +267,17 @@ private:
 	MeshBuilder				m_immediateBuilder;
 	Renderable				m_immediateRenderable;
 
+	// Immediate draws are accumulated here and only drawn when the draw state changes
+	ImmediateBatch			m_immediateBatch;
+	Mesh					m_immediateBatchMesh;
+	bool					m_isImmediateBatchingEnabled = true;
+	float					m_currentLineWidth = 1.0f;
+	ImmediateBatchStats_t	m_immediateStatsThisFrame;
+	ImmediateBatchStats_t	m_immediateStatsLastFrame;
+
+	// Text draws share one material per font, so consecutive text can batch
+	std::map<const BitmapFont*, Material*> m_fontMaterials;
+
 	Sampler*				m_defaultSampler = nullptr;
 	Sampler*				m_shadowSampler = nullptr;
 
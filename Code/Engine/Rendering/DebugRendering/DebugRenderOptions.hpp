@@ -1,15 +1,13 @@
 /************************************************************************/
-/* File: DebugRenderTask.hpp
+/* File: DebugRenderOptions.hpp
 /* Author: Andrew Chase
-/* Date: March 29th, 2018
-/* Description: Base class for all Debug Render primitives
+/* Date: June 4th, 2019
+/* Description: Settings shared by all debug render primitives
 /************************************************************************/
 #pragma once
 #include "Engine/Core/Rgba.hpp"
-#include "Engine/Rendering/Core/Renderable.hpp"
 
 class Texture;
-class Renderable;
 
 // Enumeration for depth rendering
 enum DebugRenderMode
@@ -28,7 +26,7 @@ enum DebugCamera
 };
 
 
-// Struct for debug render settings that all tasks have
+// Struct for debug render settings that all primitives have
 struct DebugRenderOptions
 {
 	DebugRenderOptions()
@@ -57,38 +55,3 @@ struct DebugRenderOptions
 	bool m_isWireFrame;
 	Texture* m_customTexture = nullptr;
 };
-
-
-class DebugRenderTask
-{
-public:
-	//-----Public Methods-----
-
-	DebugRenderTask(const DebugRenderOptions& options, DebugCamera renderSpace);
-	virtual ~DebugRenderTask();
-
-	void			Update();
-	virtual void	Render() const;
-
-	bool IsFinished() const;	// Finished when TTL is < 0
-
-
-protected:
-	//-----Protected Methods-----
-
-	void SetupDrawState(DebugRenderMode modeToDraw, float colorScale = 1.0f) const;
-	Rgba CalculateDrawColor(float colorScale = 1.0f) const;
-
-
-protected:
-	//-----Protected Data-----
-
-	DebugRenderOptions	m_options;
-	DebugCamera			m_cameraSpace;
-
-	Renderable*			m_renderable = nullptr;
-
-	float m_timeToLive;
-	bool m_isFinished = false;
-	bool m_deleteMesh = false;
-};
@@ -0,0 +1,828 @@
+/************************************************************************/
+/* File: DebugRenderPools.cpp
+/* Author: Andrew Chase
+/* Date: June 4th, 2019
+/* Description: Implementation of the debug render primitive pools
+/************************************************************************/
+#include "Engine/Assets/AssetDB.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Rendering/Core/Renderer.hpp"
+#include "Engine/Rendering/Meshes/MeshBuilder.hpp"
+#include "Engine/Rendering/DebugRendering/DebugRenderPools.hpp"
+#include "Engine/Rendering/DebugRendering/DebugRenderSystem.hpp"
+#include "Engine/Rendering/DebugRendering/DebugRenderStreams.hpp"
+
+// Geometry shared by all primitives of a type, in local space, built on first use
+struct DebugRenderTemplate_t
+{
+	std::vector<Vertex3D_PCU>	vertices;
+	std::vector<unsigned int>	indices;
+};
+
+#define DEBUG_TEXTURE_PATH "Data/Images/Debug/Debug.png"
+
+
+//-----------------------------------------------------------------------------------------------
+// Copies the builder's geometry into the template
+//
+static void CopyBuilderToTemplate(MeshBuilder& mb, DebugRenderTemplate_t& out_template)
+{
+	int vertexCount = mb.GetVertexCount();
+	for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		out_template.vertices.push_back(mb.GetVertex<Vertex3D_PCU>(vertexIndex));
+	}
+
+	int indexCount = mb.GetIndexCount();
+	for (int index = 0; index < indexCount; ++index)
+	{
+		out_template.indices.push_back(mb.GetIndex(index));
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the unit point template, a set of lines through the origin
+//
+static const DebugRenderTemplate_t& GetPointTemplate()
+{
+	static DebugRenderTemplate_t s_pointTemplate;
+
+	if (s_pointTemplate.vertices.size() == 0)
+	{
+		MeshBuilder mb;
+		mb.BeginBuilding(PRIMITIVE_LINES, false);
+		mb.PushPoint(Vector3::ZERO);
+		mb.FinishBuilding();
+
+		CopyBuilderToTemplate(mb, s_pointTemplate);
+	}
+
+	return s_pointTemplate;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the unit cube template, centered at the origin
+//
+static const DebugRenderTemplate_t& GetCubeTemplate()
+{
+	static DebugRenderTemplate_t s_cubeTemplate;
+
+	if (s_cubeTemplate.vertices.size() == 0)
+	{
+		MeshBuilder mb;
+		mb.BeginBuilding(PRIMITIVE_TRIANGLES, true);
+		mb.PushCube(Vector3::ZERO, Vector3::ONES);
+		mb.FinishBuilding();
+
+		CopyBuilderToTemplate(mb, s_cubeTemplate);
+	}
+
+	return s_cubeTemplate;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends the template to the stream, scaled and offset, with all vertices set to the given color
+//
+static void AppendTemplate(ImmediateBatch& stream, const DebugRenderTemplate_t& geometry, const Vector3& position, const Vector3& scale, const Rgba& color)
+{
+	unsigned int baseIndex = stream.GetVertexCount();
+
+	int vertexCount = (int)geometry.vertices.size();
+	for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const Vertex3D_PCU& localVertex = geometry.vertices[vertexIndex];
+		Vector3 offset = Vector3(localVertex.m_position.x * scale.x, localVertex.m_position.y * scale.y, localVertex.m_position.z * scale.z);
+
+		stream.PushVertex(Vertex3D_PCU(position + offset, color, localVertex.m_texUVs));
+	}
+
+	if (geometry.indices.size() > 0)
+	{
+		int indexCount = (int)geometry.indices.size();
+		for (int index = 0; index < indexCount; ++index)
+		{
+			stream.PushIndex(baseIndex + geometry.indices[index]);
+		}
+	}
+	else
+	{
+		for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			stream.PushIndex(baseIndex + vertexIndex);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends a single line segment to the stream
+//
+static void AppendLine(ImmediateBatch& stream, const Vector3& startPosition, const Rgba& startColor, const Vector3& endPosition, const Rgba& endColor)
+{
+	unsigned int baseIndex = stream.GetVertexCount();
+
+	stream.PushVertex(Vertex3D_PCU(startPosition, startColor, Vector2::ZERO));
+	stream.PushVertex(Vertex3D_PCU(endPosition, endColor, Vector2::ZERO));
+
+	stream.PushIndex(baseIndex);
+	stream.PushIndex(baseIndex + 1);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Appends a quad given by its corners to the stream, as two triangles
+//
+static void AppendQuad(ImmediateBatch& stream, const Vector3& bottomLeft, const Vector3& bottomRight, const Vector3& topRight, const Vector3& topLeft, const Rgba& color)
+{
+	unsigned int baseIndex = stream.GetVertexCount();
+
+	stream.PushVertex(Vertex3D_PCU(bottomLeft, color, Vector2(0.f, 0.f)));
+	stream.PushVertex(Vertex3D_PCU(bottomRight, color, Vector2(1.f, 0.f)));
+	stream.PushVertex(Vertex3D_PCU(topRight, color, Vector2(1.f, 1.f)));
+	stream.PushVertex(Vertex3D_PCU(topLeft, color, Vector2(0.f, 1.f)));
+
+	stream.PushIndex(baseIndex + 0);
+	stream.PushIndex(baseIndex + 1);
+	stream.PushIndex(baseIndex + 2);
+
+	stream.PushIndex(baseIndex + 0);
+	stream.PushIndex(baseIndex + 2);
+	stream.PushIndex(baseIndex + 3);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the component-wise product of the two colors
+//
+static Rgba MultiplyColors(const Rgba& a, const Rgba& b)
+{
+	float aRed, aGreen, aBlue, aAlpha;
+	float bRed, bGreen, bBlue, bAlpha;
+
+	a.GetAsFloats(aRed, aGreen, aBlue, aAlpha);
+	b.GetAsFloats(bRed, bGreen, bBlue, bAlpha);
+
+	return Rgba(aRed * bRed, aGreen * bGreen, aBlue * bBlue, aAlpha * bAlpha);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Decrements the time to live of all primitives, removing ones that expired last update
+// Removed primitives were still drawn once with a negative TTL, so 0 lifetime primitives draw one frame
+//
+void DebugRenderPool::UpdateLifetimes(float deltaTime)
+{
+	int primitiveIndex = 0;
+
+	while (primitiveIndex < GetCount())
+	{
+		if (m_timesToLive[primitiveIndex] < 0.f)
+		{
+			// Swap-remove, so check the same index again
+			RemoveAt(primitiveIndex);
+		}
+		else
+		{
+			m_timesToLive[primitiveIndex] -= deltaTime;
+			primitiveIndex++;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes all primitives from the pool
+//
+void DebugRenderPool::Clear()
+{
+	while (GetCount() > 0)
+	{
+		RemoveAt(GetCount() - 1);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of primitives in the pool
+//
+int DebugRenderPool::GetCount() const
+{
+	return (int)m_timesToLive.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the data common to all primitives, subclasses add the rest
+//
+void DebugRenderPool::AddCommon(const DebugRenderOptions& options)
+{
+	m_lifetimes.push_back(options.m_lifetime);
+	m_timesToLive.push_back(options.m_lifetime);
+	m_startColors.push_back(options.m_startColor);
+	m_endColors.push_back(options.m_endColor);
+	m_renderModes.push_back(options.m_renderMode);
+	m_isWireFrames.push_back(options.m_isWireFrame);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the primitive at the given index by moving the last primitive into its place
+//
+void DebugRenderPool::RemoveAt(int index)
+{
+	SwapRemove(m_lifetimes, index);
+	SwapRemove(m_timesToLive, index);
+	SwapRemove(m_startColors, index);
+	SwapRemove(m_endColors, index);
+	SwapRemove(m_renderModes, index);
+	SwapRemove(m_isWireFrames, index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the color the primitive should be drawn with this frame
+//
+Rgba DebugRenderPool::CalculateDrawColor(int index) const
+{
+	return Interpolate(m_startColors[index], m_endColors[index], CalculateNormalizedTime(index));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns how far through its lifetime the primitive is
+//
+float DebugRenderPool::CalculateNormalizedTime(int index) const
+{
+	float lifetime = m_lifetimes[index];
+
+	if (lifetime == 0.f)
+	{
+		return 1.f;
+	}
+
+	return (lifetime - m_timesToLive[index]) / lifetime;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the draws needed for the primitive this frame, XRAY primitives in world space also
+// draw their hidden parts darkened, which is drawn first so it doesn't bleed through
+//
+int DebugRenderPool::GetDrawPasses(int index, DebugCamera camera, DebugRenderPass_t* out_passes) const
+{
+	Rgba drawColor = CalculateDrawColor(index);
+	DebugRenderMode renderMode = m_renderModes[index];
+
+	if (renderMode != DEBUG_RENDER_XRAY)
+	{
+		out_passes[0].depthMode = renderMode;
+		out_passes[0].color = drawColor;
+		return 1;
+	}
+
+	int passCount = 0;
+	if (camera == DEBUG_CAMERA_WORLD)
+	{
+		Rgba hiddenColor = drawColor;
+		hiddenColor.ScaleRGB(DebugRenderSystem::DEFAULT_XRAY_COLOR_SCALE);
+
+		out_passes[passCount].depthMode = DEBUG_RENDER_HIDDEN;
+		out_passes[passCount].color = hiddenColor;
+		passCount++;
+	}
+
+	out_passes[passCount].depthMode = DEBUG_RENDER_USE_DEPTH;
+	out_passes[passCount].color = drawColor;
+	passCount++;
+
+	return passCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a point
+//
+void DebugPointPool::Add(const Vector3& position, const DebugRenderOptions& options, float radius)
+{
+	AddCommon(options);
+	m_positions.push_back(position);
+	m_radii.push_back(radius);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the geometry for all points into the streams, line width is the point radius
+//
+void DebugPointPool::AppendGeometry(DebugRenderStreams& streams) const
+{
+	const DebugRenderTemplate_t& pointTemplate = GetPointTemplate();
+	DebugRenderPass_t passes[MAX_PASSES_PER_PRIMITIVE];
+
+	int pointCount = GetCount();
+	for (int pointIndex = 0; pointIndex < pointCount; ++pointIndex)
+	{
+		float radius = m_radii[pointIndex];
+		int passCount = GetDrawPasses(pointIndex, DEBUG_CAMERA_WORLD, passes);
+
+		for (int passIndex = 0; passIndex < passCount; ++passIndex)
+		{
+			ImmediateBatch& stream = streams.GetStream(DEBUG_CAMERA_WORLD, passes[passIndex].depthMode, PRIMITIVE_LINES, radius);
+			AppendTemplate(stream, pointTemplate, m_positions[pointIndex], Vector3(radius, radius, radius), passes[passIndex].color);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the point at the given index
+//
+void DebugPointPool::RemoveAt(int index)
+{
+	DebugRenderPool::RemoveAt(index);
+	SwapRemove(m_positions, index);
+	SwapRemove(m_radii, index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a 3D line
+//
+void DebugLine3DPool::Add(const Vector3& startPosition, const Vector3& endPosition, const DebugRenderOptions& options, float lineWidth)
+{
+	AddCommon(options);
+	m_startPositions.push_back(startPosition);
+	m_endPositions.push_back(endPosition);
+	m_lineWidths.push_back(lineWidth);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the geometry for all 3D lines into the streams
+//
+void DebugLine3DPool::AppendGeometry(DebugRenderStreams& streams) const
+{
+	DebugRenderPass_t passes[MAX_PASSES_PER_PRIMITIVE];
+
+	int lineCount = GetCount();
+	for (int lineIndex = 0; lineIndex < lineCount; ++lineIndex)
+	{
+		int passCount = GetDrawPasses(lineIndex, DEBUG_CAMERA_WORLD, passes);
+
+		for (int passIndex = 0; passIndex < passCount; ++passIndex)
+		{
+			const Rgba& color = passes[passIndex].color;
+			ImmediateBatch& stream = streams.GetStream(DEBUG_CAMERA_WORLD, passes[passIndex].depthMode, PRIMITIVE_LINES, m_lineWidths[lineIndex]);
+
+			AppendLine(stream, m_startPositions[lineIndex], color, m_endPositions[lineIndex], color);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the line at the given index
+//
+void DebugLine3DPool::RemoveAt(int index)
+{
+	DebugRenderPool::RemoveAt(index);
+	SwapRemove(m_startPositions, index);
+	SwapRemove(m_endPositions, index);
+	SwapRemove(m_lineWidths, index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a 3D quad, using the custom texture if one is specified
+//
+void DebugQuad3DPool::Add(const Vector3& position, const Vector2& dimensions, const DebugRenderOptions& options, const Vector3& rightVector, const Vector3& upVector)
+{
+	AddCommon(options);
+	m_positions.push_back(position);
+	m_dimensions.push_back(dimensions);
+	m_rightVectors.push_back(rightVector);
+	m_upVectors.push_back(upVector);
+	m_textures.push_back(options.m_customTexture);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the geometry for all 3D quads into the streams
+//
+void DebugQuad3DPool::AppendGeometry(DebugRenderStreams& streams) const
+{
+	const Texture* debugTexture = AssetDB::CreateOrGetTexture(DEBUG_TEXTURE_PATH);
+	DebugRenderPass_t passes[MAX_PASSES_PER_PRIMITIVE];
+
+	int quadCount = GetCount();
+	for (int quadIndex = 0; quadIndex < quadCount; ++quadIndex)
+	{
+		bool isWireFrame = m_isWireFrames[quadIndex];
+
+		const Texture* texture = nullptr;
+		if (!isWireFrame)
+		{
+			texture = (m_textures[quadIndex] != nullptr ? m_textures[quadIndex] : debugTexture);
+		}
+
+		// Quads are centered on their position
+		Vector3 halfRight = m_rightVectors[quadIndex] * (0.5f * m_dimensions[quadIndex].x);
+		Vector3 halfUp = m_upVectors[quadIndex] * (0.5f * m_dimensions[quadIndex].y);
+		Vector3 position = m_positions[quadIndex];
+
+		int passCount = GetDrawPasses(quadIndex, DEBUG_CAMERA_WORLD, passes);
+		for (int passIndex = 0; passIndex < passCount; ++passIndex)
+		{
+			ImmediateBatch& stream = streams.GetStream(DEBUG_CAMERA_WORLD, passes[passIndex].depthMode, PRIMITIVE_TRIANGLES, 1.0f, texture, isWireFrame);
+			AppendQuad(stream, position - halfRight - halfUp, position + halfRight - halfUp, position + halfRight + halfUp, position - halfRight + halfUp, passes[passIndex].color);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the quad at the given index
+//
+void DebugQuad3DPool::RemoveAt(int index)
+{
+	DebugRenderPool::RemoveAt(index);
+	SwapRemove(m_positions, index);
+	SwapRemove(m_dimensions, index);
+	SwapRemove(m_rightVectors, index);
+	SwapRemove(m_upVectors, index);
+	SwapRemove(m_textures, index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a basis, storing the axes instead of the matrix since that's all that's drawn
+//
+void DebugBasisPool::Add(const Matrix44& basis, const DebugRenderOptions& options, float scale)
+{
+	AddCommon(options);
+	m_positions.push_back(Matrix44::ExtractTranslation(basis));
+	m_iVectors.push_back(basis.GetIVector().xyz());
+	m_jVectors.push_back(basis.GetJVector().xyz());
+	m_kVectors.push_back(basis.GetKVector().xyz());
+	m_scales.push_back(scale);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the geometry for all bases into the streams, line width is the basis scale
+//
+void DebugBasisPool::AppendGeometry(DebugRenderStreams& streams) const
+{
+	DebugRenderPass_t passes[MAX_PASSES_PER_PRIMITIVE];
+
+	int basisCount = GetCount();
+	for (int basisIndex = 0; basisIndex < basisCount; ++basisIndex)
+	{
+		float scale = m_scales[basisIndex];
+		Vector3 position = m_positions[basisIndex];
+
+		int passCount = GetDrawPasses(basisIndex, DEBUG_CAMERA_WORLD, passes);
+		for (int passIndex = 0; passIndex < passCount; ++passIndex)
+		{
+			ImmediateBatch& stream = streams.GetStream(DEBUG_CAMERA_WORLD, passes[passIndex].depthMode, PRIMITIVE_LINES, scale);
+
+			// Axis colors are tinted by the draw color
+			Rgba iColor = MultiplyColors(Rgba::RED, passes[passIndex].color);
+			Rgba jColor = MultiplyColors(Rgba::DARK_GREEN, passes[passIndex].color);
+			Rgba kColor = MultiplyColors(Rgba::BLUE, passes[passIndex].color);
+
+			AppendLine(stream, position, iColor, position + m_iVectors[basisIndex] * scale, iColor);
+			AppendLine(stream, position, jColor, position + m_jVectors[basisIndex] * scale, jColor);
+			AppendLine(stream, position, kColor, position + m_kVectors[basisIndex] * scale, kColor);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the basis at the given index
+//
+void DebugBasisPool::RemoveAt(int index)
+{
+	DebugRenderPool::RemoveAt(index);
+	SwapRemove(m_positions, index);
+	SwapRemove(m_iVectors, index);
+	SwapRemove(m_jVectors, index);
+	SwapRemove(m_kVectors, index);
+	SwapRemove(m_scales, index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a UV sphere
+//
+void DebugUVSpherePool::Add(const Vector3& position, const DebugRenderOptions& options, float radius, unsigned int numSlices, unsigned int numWedges)
+{
+	AddCommon(options);
+	m_positions.push_back(position);
+	m_radii.push_back(radius);
+	m_sliceCounts.push_back(numSlices);
+	m_wedgeCounts.push_back(numWedges);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the geometry for all spheres into the streams
+// Vertices are generated the same way as MeshBuilder::PushUVSphere()
+//
+void DebugUVSpherePool::AppendGeometry(DebugRenderStreams& streams) const
+{
+	const Texture* debugTexture = AssetDB::CreateOrGetTexture(DEBUG_TEXTURE_PATH);
+	DebugRenderPass_t passes[MAX_PASSES_PER_PRIMITIVE];
+
+	int sphereCount = GetCount();
+	for (int sphereIndex = 0; sphereIndex < sphereCount; ++sphereIndex)
+	{
+		bool isWireFrame = m_isWireFrames[sphereIndex];
+		const Texture* texture = (isWireFrame ? nullptr : debugTexture);
+
+		Vector3 position = m_positions[sphereIndex];
+		float radius = m_radii[sphereIndex];
+		unsigned int numSlices = m_sliceCounts[sphereIndex];
+		unsigned int numWedges = m_wedgeCounts[sphereIndex];
+		unsigned int numVerticesPerSlice = numWedges + 1;
+
+		int passCount = GetDrawPasses(sphereIndex, DEBUG_CAMERA_WORLD, passes);
+		for (int passIndex = 0; passIndex < passCount; ++passIndex)
+		{
+			ImmediateBatch& stream = streams.GetStream(DEBUG_CAMERA_WORLD, passes[passIndex].depthMode, PRIMITIVE_TRIANGLES, 1.0f, texture, isWireFrame);
+			unsigned int baseIndex = stream.GetVertexCount();
+
+			for (unsigned int sliceIndex = 0; sliceIndex <= numSlices; ++sliceIndex)
+			{
+				float v = (float)sliceIndex / (float)numSlices;
+				float azimuth = RangeMapFloat(v, 0.f, 1.0f, 180.f, 0.f);
+
+				for (unsigned int wedgeIndex = 0; wedgeIndex <= numWedges; ++wedgeIndex)
+				{
+					float u = (float)wedgeIndex / (float)numWedges;
+					Vector3 vertexPosition = position + SphericalToCartesian(radius, 360.f * u, azimuth);
+
+					stream.PushVertex(Vertex3D_PCU(vertexPosition, passes[passIndex].color, Vector2(u, v)));
+				}
+			}
+
+			for (unsigned int sliceIndex = 0; sliceIndex < numSlices; ++sliceIndex)
+			{
+				for (unsigned int wedgeIndex = 0; wedgeIndex < numWedges; ++wedgeIndex)
+				{
+					unsigned int bottomLeft		= baseIndex + numVerticesPerSlice * sliceIndex + wedgeIndex;
+					unsigned int bottomRight	= bottomLeft + 1;
+					unsigned int topRight		= bottomRight + numVerticesPerSlice;
+					unsigned int topLeft		= bottomLeft + numVerticesPerSlice;
+
+					stream.PushIndex(bottomLeft);
+					stream.PushIndex(bottomRight);
+					stream.PushIndex(topRight);
+
+					stream.PushIndex(bottomLeft);
+					stream.PushIndex(topRight);
+					stream.PushIndex(topLeft);
+				}
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the sphere at the given index
+//
+void DebugUVSpherePool::RemoveAt(int index)
+{
+	DebugRenderPool::RemoveAt(index);
+	SwapRemove(m_positions, index);
+	SwapRemove(m_radii, index);
+	SwapRemove(m_sliceCounts, index);
+	SwapRemove(m_wedgeCounts, index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a cube
+//
+void DebugCubePool::Add(const Vector3& position, const DebugRenderOptions& options, const Vector3& dimensions)
+{
+	AddCommon(options);
+	m_positions.push_back(position);
+	m_dimensions.push_back(dimensions);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the geometry for all cubes into the streams
+// Solid cubes are textured triangles, wire cubes are drawn as their 12 edges
+//
+void DebugCubePool::AppendGeometry(DebugRenderStreams& streams) const
+{
+	const Texture* debugTexture = AssetDB::CreateOrGetTexture(DEBUG_TEXTURE_PATH);
+	const DebugRenderTemplate_t& cubeTemplate = GetCubeTemplate();
+	DebugRenderPass_t passes[MAX_PASSES_PER_PRIMITIVE];
+
+	int cubeCount = GetCount();
+	for (int cubeIndex = 0; cubeIndex < cubeCount; ++cubeIndex)
+	{
+		Vector3 position = m_positions[cubeIndex];
+		Vector3 dimensions = m_dimensions[cubeIndex];
+		bool isWireFrame = m_isWireFrames[cubeIndex];
+
+		int passCount = GetDrawPasses(cubeIndex, DEBUG_CAMERA_WORLD, passes);
+		for (int passIndex = 0; passIndex < passCount; ++passIndex)
+		{
+			const Rgba& color = passes[passIndex].color;
+
+			if (!isWireFrame)
+			{
+				ImmediateBatch& stream = streams.GetStream(DEBUG_CAMERA_WORLD, passes[passIndex].depthMode, PRIMITIVE_TRIANGLES, 1.0f, debugTexture);
+				AppendTemplate(stream, cubeTemplate, position, dimensions, color);
+				continue;
+			}
+
+			ImmediateBatch& stream = streams.GetStream(DEBUG_CAMERA_WORLD, passes[passIndex].depthMode, PRIMITIVE_LINES, 3.0f);
+
+			Vector3 mins = position - dimensions * 0.5f;
+			Vector3 maxs = position + dimensions * 0.5f;
+
+			Vector3 corners[8] =
+			{
+				Vector3(mins.x, mins.y, mins.z), Vector3(maxs.x, mins.y, mins.z), Vector3(maxs.x, maxs.y, mins.z), Vector3(mins.x, maxs.y, mins.z),
+				Vector3(mins.x, mins.y, maxs.z), Vector3(maxs.x, mins.y, maxs.z), Vector3(maxs.x, maxs.y, maxs.z), Vector3(mins.x, maxs.y, maxs.z)
+			};
+
+			for (int edgeIndex = 0; edgeIndex < 4; ++edgeIndex)
+			{
+				int nextIndex = (edgeIndex + 1) % 4;
+
+				AppendLine(stream, corners[edgeIndex], color, corners[nextIndex], color);				// Min z ring
+				AppendLine(stream, corners[edgeIndex + 4], color, corners[nextIndex + 4], color);		// Max z ring
+				AppendLine(stream, corners[edgeIndex], color, corners[edgeIndex + 4], color);			// Connecting edge
+			}
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the cube at the given index
+//
+void DebugCubePool::RemoveAt(int index)
+{
+	DebugRenderPool::RemoveAt(index);
+	SwapRemove(m_positions, index);
+	SwapRemove(m_dimensions, index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a 2D quad
+//
+void DebugQuad2DPool::Add(const AABB2& bounds, const DebugRenderOptions& options)
+{
+	AddCommon(options);
+	m_bounds.push_back(bounds);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the geometry for all 2D quads into the streams
+//
+void DebugQuad2DPool::AppendGeometry(DebugRenderStreams& streams) const
+{
+	const Texture* debugTexture = AssetDB::CreateOrGetTexture(DEBUG_TEXTURE_PATH);
+	DebugRenderPass_t passes[MAX_PASSES_PER_PRIMITIVE];
+
+	int quadCount = GetCount();
+	for (int quadIndex = 0; quadIndex < quadCount; ++quadIndex)
+	{
+		bool isWireFrame = m_isWireFrames[quadIndex];
+		const Texture* texture = (isWireFrame ? nullptr : debugTexture);
+		const AABB2& bounds = m_bounds[quadIndex];
+
+		int passCount = GetDrawPasses(quadIndex, DEBUG_CAMERA_SCREEN, passes);
+		for (int passIndex = 0; passIndex < passCount; ++passIndex)
+		{
+			ImmediateBatch& stream = streams.GetStream(DEBUG_CAMERA_SCREEN, passes[passIndex].depthMode, PRIMITIVE_TRIANGLES, 1.0f, texture, isWireFrame);
+
+			AppendQuad(stream, Vector3(bounds.mins.x, bounds.mins.y, 0.f), Vector3(bounds.maxs.x, bounds.mins.y, 0.f),
+				Vector3(bounds.maxs.x, bounds.maxs.y, 0.f), Vector3(bounds.mins.x, bounds.maxs.y, 0.f), passes[passIndex].color);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the quad at the given index
+//
+void DebugQuad2DPool::RemoveAt(int index)
+{
+	DebugRenderPool::RemoveAt(index);
+	SwapRemove(m_bounds, index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a 2D line, where the end point has its own color range
+//
+void DebugLine2DPool::Add(const Vector2& startPosition, const Vector2& endPosition, const DebugRenderOptions& options, const Rgba& endStartColor, const Rgba& endEndColor, float lineWidth)
+{
+	AddCommon(options);
+	m_startPositions.push_back(startPosition);
+	m_endPositions.push_back(endPosition);
+	m_endStartColors.push_back(endStartColor);
+	m_endEndColors.push_back(endEndColor);
+	m_lineWidths.push_back(lineWidth);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Generates the geometry for all 2D lines into the streams
+//
+void DebugLine2DPool::AppendGeometry(DebugRenderStreams& streams) const
+{
+	DebugRenderPass_t passes[MAX_PASSES_PER_PRIMITIVE];
+
+	int lineCount = GetCount();
+	for (int lineIndex = 0; lineIndex < lineCount; ++lineIndex)
+	{
+		Rgba endColor = Interpolate(m_endStartColors[lineIndex], m_endEndColors[lineIndex], CalculateNormalizedTime(lineIndex));
+
+		Vector3 startPosition = Vector3(m_startPositions[lineIndex].x, m_startPositions[lineIndex].y, 0.f);
+		Vector3 endPosition = Vector3(m_endPositions[lineIndex].x, m_endPositions[lineIndex].y, 0.f);
+
+		int passCount = GetDrawPasses(lineIndex, DEBUG_CAMERA_SCREEN, passes);
+		for (int passIndex = 0; passIndex < passCount; ++passIndex)
+		{
+			ImmediateBatch& stream = streams.GetStream(DEBUG_CAMERA_SCREEN, passes[passIndex].depthMode, PRIMITIVE_LINES, m_lineWidths[lineIndex]);
+			AppendLine(stream, startPosition, passes[passIndex].color, endPosition, endColor);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the line at the given index
+//
+void DebugLine2DPool::RemoveAt(int index)
+{
+	DebugRenderPool::RemoveAt(index);
+	SwapRemove(m_startPositions, index);
+	SwapRemove(m_endPositions, index);
+	SwapRemove(m_endStartColors, index);
+	SwapRemove(m_endEndColors, index);
+	SwapRemove(m_lineWidths, index);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a 2D text
+//
+void DebugText2DPool::Add(const std::string& text, const AABB2& bounds, const DebugRenderOptions& options, float textHeight, const Vector2& alignment)
+{
+	AddCommon(options);
+	m_texts.push_back(text);
+	m_bounds.push_back(bounds);
+	m_textHeights.push_back(textHeight);
+	m_alignments.push_back(alignment);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Draws all text through the renderer, which batches it by font
+//
+void DebugText2DPool::Draw(Renderer* renderer, Camera* screenCamera) const
+{
+	int textCount = GetCount();
+	if (textCount == 0)
+	{
+		return;
+	}
+
+	renderer->SetCurrentCamera(screenCamera);
+	BitmapFont* font = AssetDB::CreateOrGetBitmapFont("Data/Images/Fonts/ConsoleFont.png");
+
+	for (int textIndex = 0; textIndex < textCount; ++textIndex)
+	{
+		renderer->DrawTextInBox2D(m_texts[textIndex], m_bounds[textIndex], m_alignments[textIndex], m_textHeights[textIndex], TEXT_DRAW_OVERRUN, font, CalculateDrawColor(textIndex));
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the text at the given index
+//
+void DebugText2DPool::RemoveAt(int index)
+{
+	DebugRenderPool::RemoveAt(index);
+	SwapRemove(m_texts, index);
+	SwapRemove(m_bounds, index);
+	SwapRemove(m_textHeights, index);
+	SwapRemove(m_alignments, index);
+}
@@ -0,0 +1,227 @@
+/************************************************************************/
+/* File: DebugRenderPools.hpp
+/* Author: Andrew Chase
+/* Date: June 4th, 2019
+/* Description: Pools of debug render primitives, one per primitive type,
+/*				stored as parallel arrays and swap-removed when expired
+/************************************************************************/
+#pragma once
+#include <string>
+#include <vector>
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Rendering/DebugRendering/DebugRenderOptions.hpp"
+
+class Camera;
+class Texture;
+class Matrix44;
+class Renderer;
+class DebugRenderStreams;
+
+// A single draw of a primitive, XRAY primitives are drawn twice
+struct DebugRenderPass_t
+{
+	DebugRenderMode depthMode;
+	Rgba			color;
+};
+
+
+class DebugRenderPool
+{
+public:
+	//-----Public Methods-----
+
+	virtual ~DebugRenderPool() {}
+
+	void	UpdateLifetimes(float deltaTime);
+	void	Clear();
+
+	int		GetCount() const;
+
+
+protected:
+	//-----Protected Methods-----
+
+	void			AddCommon(const DebugRenderOptions& options);
+	virtual void	RemoveAt(int index);
+
+	Rgba			CalculateDrawColor(int index) const;
+	float			CalculateNormalizedTime(int index) const;
+	int				GetDrawPasses(int index, DebugCamera camera, DebugRenderPass_t* out_passes) const;
+
+	template <typename T>
+	static void SwapRemove(std::vector<T>& values, int index)
+	{
+		values[index] = values.back();
+		values.pop_back();
+	}
+
+
+protected:
+	//-----Protected Data-----
+
+	std::vector<float>				m_lifetimes;
+	std::vector<float>				m_timesToLive;
+	std::vector<Rgba>				m_startColors;
+	std::vector<Rgba>				m_endColors;
+	std::vector<DebugRenderMode>	m_renderModes;
+	std::vector<bool>				m_isWireFrames;
+
+	static constexpr int MAX_PASSES_PER_PRIMITIVE = 2;
+
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// 3D Pools
+//
+class DebugPointPool : public DebugRenderPool
+{
+public:
+	void Add(const Vector3& position, const DebugRenderOptions& options, float radius);
+	void AppendGeometry(DebugRenderStreams& streams) const;
+
+protected:
+	virtual void RemoveAt(int index) override;
+
+private:
+	std::vector<Vector3>	m_positions;
+	std::vector<float>		m_radii;
+};
+
+
+class DebugLine3DPool : public DebugRenderPool
+{
+public:
+	void Add(const Vector3& startPosition, const Vector3& endPosition, const DebugRenderOptions& options, float lineWidth);
+	void AppendGeometry(DebugRenderStreams& streams) const;
+
+protected:
+	virtual void RemoveAt(int index) override;
+
+private:
+	std::vector<Vector3>	m_startPositions;
+	std::vector<Vector3>	m_endPositions;
+	std::vector<float>		m_lineWidths;
+};
+
+
+class DebugQuad3DPool : public DebugRenderPool
+{
+public:
+	void Add(const Vector3& position, const Vector2& dimensions, const DebugRenderOptions& options, const Vector3& rightVector, const Vector3& upVector);
+	void AppendGeometry(DebugRenderStreams& streams) const;
+
+protected:
+	virtual void RemoveAt(int index) override;
+
+private:
+	std::vector<Vector3>		m_positions;
+	std::vector<Vector2>		m_dimensions;
+	std::vector<Vector3>		m_rightVectors;
+	std::vector<Vector3>		m_upVectors;
+	std::vector<const Texture*>	m_textures;
+};
+
+
+class DebugBasisPool : public DebugRenderPool
+{
+public:
+	void Add(const Matrix44& basis, const DebugRenderOptions& options, float scale);
+	void AppendGeometry(DebugRenderStreams& streams) const;
+
+protected:
+	virtual void RemoveAt(int index) override;
+
+private:
+	std::vector<Vector3>	m_positions;
+	std::vector<Vector3>	m_iVectors;
+	std::vector<Vector3>	m_jVectors;
+	std::vector<Vector3>	m_kVectors;
+	std::vector<float>		m_scales;
+};
+
+
+class DebugUVSpherePool : public DebugRenderPool
+{
+public:
+	void Add(const Vector3& position, const DebugRenderOptions& options, float radius, unsigned int numSlices, unsigned int numWedges);
+	void AppendGeometry(DebugRenderStreams& streams) const;
+
+protected:
+	virtual void RemoveAt(int index) override;
+
+private:
+	std::vector<Vector3>		m_positions;
+	std::vector<float>			m_radii;
+	std::vector<unsigned int>	m_sliceCounts;
+	std::vector<unsigned int>	m_wedgeCounts;
+};
+
+
+class DebugCubePool : public DebugRenderPool
+{
+public:
+	void Add(const Vector3& position, const DebugRenderOptions& options, const Vector3& dimensions);
+	void AppendGeometry(DebugRenderStreams& streams) const;
+
+protected:
+	virtual void RemoveAt(int index) override;
+
+private:
+	std::vector<Vector3>	m_positions;
+	std::vector<Vector3>	m_dimensions;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// 2D Pools
+//
+class DebugQuad2DPool : public DebugRenderPool
+{
+public:
+	void Add(const AABB2& bounds, const DebugRenderOptions& options);
+	void AppendGeometry(DebugRenderStreams& streams) const;
+
+protected:
+	virtual void RemoveAt(int index) override;
+
+private:
+	std::vector<AABB2>	m_bounds;
+};
+
+
+class DebugLine2DPool : public DebugRenderPool
+{
+public:
+	void Add(const Vector2& startPosition, const Vector2& endPosition, const DebugRenderOptions& options, const Rgba& endStartColor, const Rgba& endEndColor, float lineWidth);
+	void AppendGeometry(DebugRenderStreams& streams) const;
+
+protected:
+	virtual void RemoveAt(int index) override;
+
+private:
+	std::vector<Vector2>	m_startPositions;
+	std::vector<Vector2>	m_endPositions;
+	std::vector<Rgba>		m_endStartColors;
+	std::vector<Rgba>		m_endEndColors;
+	std::vector<float>		m_lineWidths;
+};
+
+
+// Text is drawn through the renderer instead of the debug streams, where it is batched by font
+class DebugText2DPool : public DebugRenderPool
+{
+public:
+	void Add(const std::string& text, const AABB2& bounds, const DebugRenderOptions& options, float textHeight, const Vector2& alignment);
+	void Draw(Renderer* renderer, Camera* screenCamera) const;
+
+protected:
+	virtual void RemoveAt(int index) override;
+
+private:
+	std::vector<std::string>	m_texts;
+	std::vector<AABB2>			m_bounds;
+	std::vector<float>			m_textHeights;
+	std::vector<Vector2>		m_alignments;
+};
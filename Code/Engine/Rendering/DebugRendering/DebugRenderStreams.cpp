@@ -0,0 +1,224 @@
+/************************************************************************/
+/* File: DebugRenderStreams.cpp
+/* Author: Andrew Chase
+/* Date: June 4th, 2019
+/* Description: Implementation of the DebugRenderStreams class
+/************************************************************************/
+#include "Engine/Assets/AssetDB.hpp"
+#include "Engine/Rendering/Meshes/Mesh.hpp"
+#include "Engine/Core/Utility/ErrorWarningAssert.hpp"
+#include "Engine/Rendering/Core/Renderer.hpp"
+#include "Engine/Rendering/Shaders/Shader.hpp"
+#include "Engine/Rendering/Materials/MaterialInstance.hpp"
+#include "Engine/Rendering/DebugRendering/DebugRenderStreams.hpp"
+
+// Hidden draws first so they don't draw over visible geometry, and depth-ignoring draws last so they are on top
+const DebugRenderMode DebugRenderStreams::DEPTH_MODE_DRAW_ORDER[] = { DEBUG_RENDER_HIDDEN, DEBUG_RENDER_USE_DEPTH, DEBUG_RENDER_IGNORE_DEPTH };
+
+
+//-----------------------------------------------------------------------------------------------
+// Destructor
+//
+DebugRenderStreams::~DebugRenderStreams()
+{
+	for (int streamIndex = 0; streamIndex < (int)m_streams.size(); ++streamIndex)
+	{
+		delete m_streams[streamIndex]->material;
+		delete m_streams[streamIndex]->mesh;
+		delete m_streams[streamIndex];
+	}
+
+	m_streams.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the stream for the given draw state to push geometry into, creating one if it doesn't exist
+// Line width only separates streams for lines, and texture/wireframe only separate streams for triangles
+//
+ImmediateBatch& DebugRenderStreams::GetStream(DebugCamera camera, DebugRenderMode depthMode, PrimitiveType primitiveType, float lineWidth /*= 1.0f*/, const Texture* texture /*= nullptr*/, bool isWireFrame /*= false*/)
+{
+	if (primitiveType == PRIMITIVE_TRIANGLES)
+	{
+		lineWidth = 1.0f;
+	}
+	else
+	{
+		texture = nullptr;
+		isWireFrame = false;
+	}
+
+	DebugRenderStream_t* stream = nullptr;
+	for (int streamIndex = 0; streamIndex < (int)m_streams.size(); ++streamIndex)
+	{
+		DebugRenderStream_t* currStream = m_streams[streamIndex];
+
+		if (currStream->camera == camera && currStream->depthMode == depthMode && currStream->primitiveType == primitiveType
+			&& currStream->lineWidth == lineWidth && currStream->texture == texture && currStream->isWireFrame == isWireFrame)
+		{
+			stream = currStream;
+			break;
+		}
+	}
+
+	if (stream == nullptr)
+	{
+		stream = CreateStream(camera, depthMode, primitiveType, lineWidth, texture, isWireFrame);
+	}
+
+	if (stream->batch.IsEmpty())
+	{
+		stream->batch.Begin(stream->material, primitiveType, lineWidth);
+	}
+
+	return stream->batch;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Draws all streams that have geometry in them, one draw call each, emptying them for the next frame
+//
+void DebugRenderStreams::Draw(Renderer* renderer, Camera* screenCamera, Camera* worldCamera)
+{
+	DestroyUnusedStreams();
+
+	m_drawCountLastFrame = 0;
+
+	// World geometry first so screen geometry is drawn over it
+	DebugCamera cameraOrder[2] = { DEBUG_CAMERA_WORLD, DEBUG_CAMERA_SCREEN };
+
+	for (int cameraIndex = 0; cameraIndex < 2; ++cameraIndex)
+	{
+		DebugCamera currCamera = cameraOrder[cameraIndex];
+		bool isCameraSet = false;
+
+		for (int modeIndex = 0; modeIndex < NUM_DEPTH_MODES_TO_DRAW; ++modeIndex)
+		{
+			for (int streamIndex = 0; streamIndex < (int)m_streams.size(); ++streamIndex)
+			{
+				DebugRenderStream_t* stream = m_streams[streamIndex];
+
+				if (stream->camera != currCamera || stream->depthMode != DEPTH_MODE_DRAW_ORDER[modeIndex] || stream->batch.IsEmpty())
+				{
+					continue;
+				}
+
+				if (!isCameraSet)
+				{
+					renderer->SetCurrentCamera(currCamera == DEBUG_CAMERA_WORLD ? worldCamera : screenCamera);
+					isCameraSet = true;
+				}
+
+				DrawStream(renderer, stream);
+			}
+		}
+	}
+
+	renderer->SetGLLineWidth(1.0f);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of draw calls used to draw all debug geometry last frame
+//
+int DebugRenderStreams::GetDrawCountLastFrame() const
+{
+	return m_drawCountLastFrame;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Creates a new stream with a material set up for the given draw state
+//
+DebugRenderStream_t* DebugRenderStreams::CreateStream(DebugCamera camera, DebugRenderMode depthMode, PrimitiveType primitiveType, float lineWidth, const Texture* texture, bool isWireFrame)
+{
+	DebugRenderStream_t* stream = new DebugRenderStream_t();
+
+	stream->camera = camera;
+	stream->depthMode = depthMode;
+	stream->primitiveType = primitiveType;
+	stream->lineWidth = lineWidth;
+	stream->texture = texture;
+	stream->isWireFrame = isWireFrame;
+
+	// Color is baked into the vertices, so the tint stays white
+	Material* material = new MaterialInstance(AssetDB::GetSharedMaterial("Debug_Render"));
+	material->SetDiffuse(texture);
+	material->SetProperty("TINT", Vector4(1.f, 1.f, 1.f, 1.f));
+
+	Shader* shader = material->GetEditableShader();
+	shader->SetFillMode(isWireFrame ? FILL_MODE_WIRE : FILL_MODE_SOLID);
+
+	switch (depthMode)
+	{
+	case DEBUG_RENDER_HIDDEN:
+		shader->EnableDepth(DEPTH_TEST_GREATER, true);
+		break;
+	case DEBUG_RENDER_USE_DEPTH:
+		shader->EnableDepth(DEPTH_TEST_LESS, true);
+		break;
+	case DEBUG_RENDER_IGNORE_DEPTH:
+		shader->DisableDepth();
+		break;
+	default:
+		ERROR_AND_DIE("Error: DebugRenderStreams::CreateStream() received a depth mode that isn't drawn directly");
+		break;
+	}
+
+	stream->material = material;
+	stream->mesh = new Mesh();
+
+	m_streams.push_back(stream);
+	return stream;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Uploads the stream's geometry and draws it, emptying the stream
+//
+void DebugRenderStreams::DrawStream(Renderer* renderer, DebugRenderStream_t* stream)
+{
+	ImmediateBatch& batch = stream->batch;
+	unsigned int indexCount = batch.GetIndexCount();
+
+	stream->mesh->SetVertices(batch.GetVertexCount(), batch.GetVertexData());
+	stream->mesh->SetIndices(indexCount, batch.GetIndexData());
+	stream->mesh->SetDrawInstruction(stream->primitiveType, true, 0, indexCount);
+
+	batch.Clear();
+
+	renderer->SetGLLineWidth(stream->lineWidth);
+	renderer->DrawMeshWithMaterial(stream->mesh, stream->material);
+
+	m_drawCountLastFrame++;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Deletes streams that haven't had geometry in them for a while, so one-off draw states don't accumulate
+//
+void DebugRenderStreams::DestroyUnusedStreams()
+{
+	for (int streamIndex = (int)m_streams.size() - 1; streamIndex >= 0; --streamIndex)
+	{
+		DebugRenderStream_t* stream = m_streams[streamIndex];
+
+		if (!stream->batch.IsEmpty())
+		{
+			stream->framesUnused = 0;
+			continue;
+		}
+
+		stream->framesUnused++;
+
+		if (stream->framesUnused > MAX_FRAMES_UNUSED)
+		{
+			delete stream->material;
+			delete stream->mesh;
+			delete stream;
+
+			m_streams[streamIndex] = m_streams.back();
+			m_streams.pop_back();
+		}
+	}
+}
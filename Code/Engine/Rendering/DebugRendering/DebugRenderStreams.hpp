@@ -0,0 +1,75 @@
+/************************************************************************/
+/* File: DebugRenderStreams.hpp
+/* Author: Andrew Chase
+/* Date: June 4th, 2019
+/* Description: Set of vertex streams the debug primitives are generated
+/*				into each frame, one per unique draw state
+/************************************************************************/
+#pragma once
+#include <vector>
+#include "Engine/Rendering/Core/ImmediateBatch.hpp"
+#include "Engine/Rendering/DebugRendering/DebugRenderOptions.hpp"
+
+class Mesh;
+class Camera;
+class Texture;
+class Material;
+class Renderer;
+
+// A single stream of geometry, drawn in one draw call
+struct DebugRenderStream_t
+{
+	// Draw state
+	DebugCamera		camera;
+	DebugRenderMode	depthMode;		// Never XRAY, XRAY primitives are split into two streams
+	PrimitiveType	primitiveType;
+	float			lineWidth;
+	const Texture*	texture;
+	bool			isWireFrame;
+
+	Material*		material = nullptr;
+	Mesh*			mesh = nullptr;
+	ImmediateBatch	batch;
+
+	int				framesUnused = 0;
+};
+
+
+class DebugRenderStreams
+{
+public:
+	//-----Public Methods-----
+
+	DebugRenderStreams() {}
+	~DebugRenderStreams();
+
+	ImmediateBatch& GetStream(DebugCamera camera, DebugRenderMode depthMode, PrimitiveType primitiveType, float lineWidth = 1.0f, const Texture* texture = nullptr, bool isWireFrame = false);
+
+	void	Draw(Renderer* renderer, Camera* screenCamera, Camera* worldCamera);
+	int		GetDrawCountLastFrame() const;
+
+
+private:
+	//-----Private Methods-----
+
+	DebugRenderStream_t*	CreateStream(DebugCamera camera, DebugRenderMode depthMode, PrimitiveType primitiveType, float lineWidth, const Texture* texture, bool isWireFrame);
+	void					DrawStream(Renderer* renderer, DebugRenderStream_t* stream);
+	void					DestroyUnusedStreams();
+
+
+private:
+	//-----Private Data-----
+
+	// Streams persist between frames so their materials and GPU buffers are reused
+	std::vector<DebugRenderStream_t*>	m_streams;
+
+	int m_drawCountLastFrame = 0;
+
+	// Order the depth modes are drawn in, so depth-ignoring geometry draws on top of everything else
+	static const DebugRenderMode DEPTH_MODE_DRAW_ORDER[];
+	static constexpr int NUM_DEPTH_MODES_TO_DRAW = 3;
+
+	// Streams unused for this many frames are destroyed
+	static constexpr int MAX_FRAMES_UNUSED = 60;
+
+};
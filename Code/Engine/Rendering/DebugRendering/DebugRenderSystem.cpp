@@ -5,6 +5,7 @@
 /* Description: System that controls all debug rendering tasks
 /************************************************************************/
 #include "Engine/Core/Window.hpp"
+#include "Engine/Core/Time/Clock.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Rendering/Core/Camera.hpp"
@@ -14,16 +15,6 @@
 #include "Engine/Core/DeveloperConsole/DevConsole.hpp"
 
 #include "Engine/Rendering/DebugRendering/DebugRenderSystem.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_Cube.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_Point.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_Basis.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_Line2D.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_Line3D.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_Quad2D.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_Quad3D.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_Text2D.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_UVSphere.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask_Skeleton.hpp"
 
 // Singleton instance
 DebugRenderSystem*	DebugRenderSystem::s_instance = nullptr;
@@ -136,36 +127,61 @@ void DebugRenderSystem::Update()
 		return;
 	}
 
-	// First check for finished tasks
-	for (int taskIndex = 0; taskIndex < (int) m_tasks.size(); ++taskIndex)
-	{
-		if (m_tasks[taskIndex]->IsFinished())
-		{
-			delete m_tasks[taskIndex];
-			m_tasks.erase(m_tasks.begin() + taskIndex);
+	float deltaTime = Clock::GetMasterDeltaTime();
 
-			taskIndex--;
-		}
-		else
-		{
-			m_tasks[taskIndex]->Update();
-		}
-	}
+	m_points.UpdateLifetimes(deltaTime);
+	m_lines3D.UpdateLifetimes(deltaTime);
+	m_quads3D.UpdateLifetimes(deltaTime);
+	m_bases.UpdateLifetimes(deltaTime);
+	m_spheres.UpdateLifetimes(deltaTime);
+	m_cubes.UpdateLifetimes(deltaTime);
+	m_quads2D.UpdateLifetimes(deltaTime);
+	m_lines2D.UpdateLifetimes(deltaTime);
+	m_texts2D.UpdateLifetimes(deltaTime);
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Draws all current tasks to screen
+// Draws all current primitives to screen, generating all geometry into one stream per draw state
 //
-void DebugRenderSystem::Render() const
+void DebugRenderSystem::Render()
 {
-	if (m_renderTasks)
+	if (!m_renderTasks)
 	{
-		for (int taskIndex = 0; taskIndex < (int) m_tasks.size(); ++taskIndex)
-		{
-			m_tasks[taskIndex]->Render();
-		}
+		return;
 	}
+
+	m_points.AppendGeometry(m_streams);
+	m_lines3D.AppendGeometry(m_streams);
+	m_quads3D.AppendGeometry(m_streams);
+	m_bases.AppendGeometry(m_streams);
+	m_spheres.AppendGeometry(m_streams);
+	m_cubes.AppendGeometry(m_streams);
+	m_quads2D.AppendGeometry(m_streams);
+	m_lines2D.AppendGeometry(m_streams);
+
+	Renderer* renderer = Renderer::GetInstance();
+	m_streams.Draw(renderer, m_screenCamera, m_worldCamera);
+
+	// Text last so it's on top
+	m_texts2D.Draw(renderer, m_screenCamera);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes all primitives from all pools
+//
+void DebugRenderSystem::ClearPools()
+{
+	m_points.Clear();
+	m_lines3D.Clear();
+	m_quads3D.Clear();
+	m_bases.Clear();
+	m_spheres.Clear();
+	m_cubes.Clear();
+	m_quads2D.Clear();
+	m_lines2D.Clear();
+	m_texts2D.Clear();
 }
 
 
@@ -235,6 +251,27 @@ bool DebugRenderSystem::AreTasksBeingRendered()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns the number of primitives currently in the system
+//
+int DebugRenderSystem::GetPrimitiveCount()
+{
+	DebugRenderSystem* system = s_instance;
+
+	return system->m_points.GetCount() + system->m_lines3D.GetCount() + system->m_quads3D.GetCount() + system->m_bases.GetCount() + system->m_spheres.GetCount()
+		+ system->m_cubes.GetCount() + system->m_quads2D.GetCount() + system->m_lines2D.GetCount() + system->m_texts2D.GetCount();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of draw calls the system made last frame, not including text
+//
+int DebugRenderSystem::GetDrawCountLastFrame()
+{
+	return s_instance->m_streams.GetDrawCountLastFrame();
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Pauses the update on all current tasks
 //
@@ -276,12 +313,7 @@ void DebugRenderSystem::ToggleShowRenderTasks()
 //
 void DebugRenderSystem::Clear()
 {
-	for (int taskIndex = 0; taskIndex < (int) s_instance->m_tasks.size(); ++taskIndex)
-	{
-		delete s_instance->m_tasks[taskIndex];
-	}
-
-	s_instance->m_tasks.clear();
+	s_instance->ClearPools();
 }
 
 
@@ -306,8 +338,7 @@ DebugRenderMode DebugRenderSystem::ConvertStringToRenderMode(const std::string&
 //
 void DebugRenderSystem::DrawPoint(const Vector3& position, const DebugRenderOptions& options, float radius /*= 1.0f*/)
 {
-	DebugRenderTask_Point* point = new DebugRenderTask_Point(position, options, radius);
-	s_instance->m_tasks.push_back(point);
+	s_instance->m_points.Add(position, options, radius);
 }
 
 
@@ -330,8 +361,7 @@ void DebugRenderSystem::DrawPoint(const Vector3& position, float lifeTime, const
 //
 void DebugRenderSystem::Draw3DLine(const Vector3& startPosition, const Vector3& endPosition, const DebugRenderOptions& options, float lineWidth /*= 1.0f*/)
 {
-	DebugRenderTask_Line3D* line = new DebugRenderTask_Line3D(startPosition, endPosition, options, lineWidth);
-	s_instance->m_tasks.push_back(line);
+	s_instance->m_lines3D.Add(startPosition, endPosition, options, lineWidth);
 }
 
 
@@ -355,8 +385,7 @@ void DebugRenderSystem::Draw3DLine(const Vector3& startPosition, const Vector3&
 //
 void DebugRenderSystem::Draw3DQuad(const Vector3& position, const Vector2& dimensions, const DebugRenderOptions& options, const Vector3& rightVector /*= Vector3::DIRECTION_RIGHT*/, const Vector3& upVector /*= Vector3::DIRECTION_UP*/)
 {
-	DebugRenderTask_Quad3D* quad = new DebugRenderTask_Quad3D(position, dimensions, options, rightVector, upVector);
-	s_instance->m_tasks.push_back(quad);
+	s_instance->m_quads3D.Add(position, dimensions, options, rightVector, upVector);
 }
 
 
@@ -393,8 +422,7 @@ void DebugRenderSystem::Draw3DQuadWithNormal(const Vector3& position, const Vect
 //
 void DebugRenderSystem::DrawBasis(const Matrix44& basis, const DebugRenderOptions& options, float scale /*= 1.0f*/)
 {
-	DebugRenderTask_Basis* task = new DebugRenderTask_Basis(basis, options, scale);
-	s_instance->m_tasks.push_back(task);
+	s_instance->m_bases.Add(basis, options, scale);
 }
 
 
@@ -418,8 +446,7 @@ void DebugRenderSystem::DrawBasis(const Vector3& position, const Vector3& rotati
 //
 void DebugRenderSystem::DrawUVSphere(const Vector3& position, const DebugRenderOptions& options, float radius /*= 1.0f*/, unsigned int numSlices /*= 4*/, unsigned int numWedges /*= 8*/)
 {
-	DebugRenderTask_UVSphere* sphere = new DebugRenderTask_UVSphere(position, options, radius, numSlices, numWedges);
-	s_instance->m_tasks.push_back(sphere);
+	s_instance->m_spheres.Add(position, options, radius, numSlices, numWedges);
 }
 
 
@@ -443,8 +470,7 @@ void DebugRenderSystem::DrawUVSphere(const Vector3& position, float lifetime, co
 //
 void DebugRenderSystem::DrawCube(const Vector3& position, const DebugRenderOptions& options, const Vector3& dimensions)
 {
-	DebugRenderTask_Cube* cube = new DebugRenderTask_Cube(position, options, dimensions);
-	s_instance->m_tasks.push_back(cube);
+	s_instance->m_cubes.Add(position, options, dimensions);
 }
 
 
@@ -468,8 +494,7 @@ void DebugRenderSystem::DrawCube(const Vector3& position, float lifetime, const
 //
 void DebugRenderSystem::Draw2DQuad(const AABB2& bounds, const DebugRenderOptions& options)
 {
-	DebugRenderTask_Quad2D* quad = new DebugRenderTask_Quad2D(bounds, options);
-	s_instance->m_tasks.push_back(quad);
+	s_instance->m_quads2D.Add(bounds, options);
 }
 
 
@@ -493,8 +518,7 @@ void DebugRenderSystem::Draw2DQuad(const AABB2& bounds, const Rgba& color, float
 //
 void DebugRenderSystem::Draw2DLine(const Vector2& startPosition, const Vector2& endPosition, const DebugRenderOptions& options, const Rgba& endStartColor, const Rgba& endEndColor, float lineWidth /*= 1.0f*/)
 {
-	DebugRenderTask_Line2D* line = new DebugRenderTask_Line2D(startPosition, endPosition, options, endStartColor, endEndColor, lineWidth);
-	s_instance->m_tasks.push_back(line);
+	s_instance->m_lines2D.Add(startPosition, endPosition, options, endStartColor, endEndColor, lineWidth);
 }
 
 
@@ -518,8 +542,7 @@ void DebugRenderSystem::Draw2DLine(const Vector2& startPosition, const Vector2&
 //
 void DebugRenderSystem::Draw2DText(const std::string& text, const AABB2& bounds, const DebugRenderOptions& options, float textHeight /*= 50.f*/, const Vector2& alignment /*=Vector2::ZERO*/)
 {
-	DebugRenderTask_Text2D* textTask = new DebugRenderTask_Text2D(text, bounds, options, textHeight, alignment);
-	s_instance->m_tasks.push_back(textTask);
+	s_instance->m_texts2D.Add(text, bounds, options, textHeight, alignment);
 }
 
 
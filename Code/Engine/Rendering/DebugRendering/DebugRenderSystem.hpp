@@ -6,7 +6,9 @@
 /************************************************************************/
 #pragma once
 #include "Engine/Math/AABB2.hpp"
-#include "Engine/Rendering/DebugRendering/DebugRenderTask.hpp"
+#include "Engine/Rendering/DebugRendering/DebugRenderPools.hpp"
+#include "Engine/Rendering/DebugRendering/DebugRenderOptions.hpp"
+#include "Engine/Rendering/DebugRendering/DebugRenderStreams.hpp"
 
 class Camera;
 class Matrix44;
@@ -31,6 +33,8 @@ public:
 
 	static bool					AreTasksBeingUpdated();
 	static bool					AreTasksBeingRendered();
+	static int					GetPrimitiveCount();
+	static int					GetDrawCountLastFrame();
 
 
 	static void Pause();
@@ -93,7 +97,9 @@ private:
 
 	// Called by UpdateAndRender()
 	void Update();
-	void Render() const;
+	void Render();
+
+	void ClearPools();
 
 
 private:
@@ -105,8 +111,19 @@ private:
 	bool m_updatePaused = false;
 	bool m_renderTasks = true;
 
-	// All rendering tasks currently being drawn
-	std::vector<DebugRenderTask*> m_tasks;
+	// All primitives currently being drawn, pooled by type
+	DebugPointPool		m_points;
+	DebugLine3DPool		m_lines3D;
+	DebugQuad3DPool		m_quads3D;
+	DebugBasisPool		m_bases;
+	DebugUVSpherePool	m_spheres;
+	DebugCubePool		m_cubes;
+	DebugQuad2DPool		m_quads2D;
+	DebugLine2DPool		m_lines2D;
+	DebugText2DPool		m_texts2D;
+
+	// Geometry for all primitives is generated into these each frame
+	DebugRenderStreams	m_streams;
 
 	// Singleton instance
 	static DebugRenderSystem* s_instance;
@@ -53,6 +53,8 @@ Material::Material()
 //
 Material::~Material()
 {
+	FlushImmediateDraws();
+
 	if (m_isInstancedShader)
 	{
 		delete m_shader;
@@ -77,7 +79,7 @@ bool Material::LoadFromFile(const std::string& filepath)
 {
 	// Load the document
 	XMLDocument document;
-	XMLError error = document.LoadFile(filepath.c_str());
+	XMLError error = LoadXmlDocument(document, filepath);
 
 	if (error != tinyxml2::XML_SUCCESS)
 	{
@@ -113,8 +115,9 @@ bool Material::LoadFromFile(const std::string& filepath)
 		{
 			std::string textureName = ParseXmlAttribute(*currElement, "name", "Invalid");
 			bool generateMipMaps = ParseXmlAttribute(*currElement, "generateMipMaps", false);
+			bool useCompressedCache = ParseXmlAttribute(*currElement, "useCompressedCache", false);
 
-			const Texture* texture = AssetDB::CreateOrGetTexture(textureName, generateMipMaps);
+			const Texture* texture = AssetDB::CreateOrGetTexture(textureName, generateMipMaps, false, useCompressedCache);
 			int bindPoint = ParseXmlAttribute(*currElement, "bind", 0);
 
 			m_textures[bindPoint] = texture;
@@ -299,6 +302,8 @@ void Material::SetShader(Shader* shader, bool isInstancedShader)
 	// Don't do anything if it's the same shader
 	if (m_shader != shader)
 	{
+		FlushImmediateDraws();
+
 		if (m_isInstancedShader)
 		{
 			delete m_shader;
@@ -323,7 +328,11 @@ void Material::SetShader(Shader* shader, bool isInstancedShader)
 //
 void Material::SetTexture(unsigned int bindPoint, const Texture* texture)
 {
-	m_textures[bindPoint] = texture;
+	if (m_textures[bindPoint] != texture)
+	{
+		FlushImmediateDraws();
+		m_textures[bindPoint] = texture;
+	}
 }
 
 
@@ -332,7 +341,11 @@ void Material::SetTexture(unsigned int bindPoint, const Texture* texture)
 //
 void Material::SetSampler(unsigned int bindPoint, const Sampler* sampler)
 {
-	m_samplers[bindPoint] = sampler;
+	if (m_samplers[bindPoint] != sampler)
+	{
+		FlushImmediateDraws();
+		m_samplers[bindPoint] = sampler;
+	}
 }
 
 
@@ -413,6 +426,8 @@ bool Material::SetProperty(const char* propertyName, const void* data, size_t by
 
 		if (propertyDescription != nullptr)
 		{
+			FlushImmediateDraws();
+
 			// Found the block, so get the name
 			std::string blockName = blockDescription->GetName();
 			
@@ -451,6 +466,7 @@ bool Material::SetPropertyBlock(const char* blockName, const void* data, size_t
 
 	if (block != nullptr)
 	{
+		FlushImmediateDraws();
 		block->SetCPUData(byteSize, data);	
 		return true;
 	}
@@ -465,6 +481,8 @@ bool Material::SetPropertyBlock(const char* blockName, const void* data, size_t
 		return false;
 	}
 
+	FlushImmediateDraws();
+
 	block = CreatePropertyBlock(blockDescription);
 	block->SetCPUData(byteSize, data);
 	return true;
@@ -506,3 +524,18 @@ MaterialPropertyBlock* Material::CreatePropertyBlock(const PropertyBlockDescript
 	m_propertyBlocks.push_back(block);
 	return block;
 }
+
+
+//-----------------------------------------------------------------------------------------------
+// Draws any immediate geometry the Renderer has batched with this material, since the batch only
+// holds the pointer - called before the material changes or is destroyed
+//
+void Material::FlushImmediateDraws() const
+{
+	Renderer* renderer = Renderer::GetInstance();
+
+	if (renderer != nullptr)
+	{
+		renderer->FlushImmediateBatchUsing(this);
+	}
+}
@@ -75,6 +75,7 @@ protected:
 	//-----Protected Methods-----
 
 	MaterialPropertyBlock* CreatePropertyBlock(const PropertyBlockDescription* blockDescription);
+	void FlushImmediateDraws() const;	// Called before any change, so batched draws keep the state they were submitted with
 
 
 private:
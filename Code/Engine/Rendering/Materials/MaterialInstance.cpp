@@ -24,6 +24,8 @@ MaterialInstance::MaterialInstance(const Material* baseMaterial)
 //
 void MaterialInstance::ResetToBaseMaterial()
 {
+	FlushImmediateDraws();
+
 	if (m_isInstancedShader)
 	{
 		delete m_shader;
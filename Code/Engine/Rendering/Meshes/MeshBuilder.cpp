@@ -9,7 +9,9 @@
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time/Time.hpp"
 #include "Engine/Rendering/Meshes/MeshBuilder.hpp"
+#include "Engine/Rendering/Meshes/ObjFileParser.hpp"
 #include "ThirdParty/mikkt/mikktspace.h"
 
 
@@ -21,6 +23,8 @@ static void GetVertexNormal(const SMikkTSpaceContext * pContext, float fvNormOut
 static void GetVertexUV(const SMikkTSpaceContext * pContext, float fvTexcOut[], const int iFace, const int iVert);
 static void SetVertexTangent(const SMikkTSpaceContext * pContext, const float fvTangent[], const float fSign, const int iFace, const int iVert);
 
+bool MeshBuilder::s_optimizeOnLoad = false;
+
 //-----------------------------------------------------------------------------------------------
 // Begins the build process by setting up the instruction
 //
@@ -69,103 +73,53 @@ void MeshBuilder::Clear()
 
 //-----------------------------------------------------------------------------------------------
 // Loads an OBJ file at the given path and parses the information
+// Files with normals come out indexed, one vertex per unique position/uv/normal triplet. Without them
+// each face gets its own flat normal, so every triangle keeps its own three vertices
 //
 void MeshBuilder::LoadFromObjFile(const std::string& filePath)
 {
 	AssertBuildState(false, PRIMITIVE_TRIANGLES, false);
-	BeginBuilding(PRIMITIVE_TRIANGLES, false);
-
-	size_t size;
-	const char* buffer = (const char*)FileReadToNewBuffer(filePath.c_str(), size);
-	if (buffer == nullptr) { return; }
-
-	std::string fileContents = std::string(buffer);
-
-	std::vector<Vector3> positions;
-	std::vector<Vector3> normals;
-	std::vector<Vector2> uvs;
 
-	std::vector<std::string> lines = Tokenize(fileContents, '\n');
-	int numLines = (int) lines.size();
+	ObjFileParser parser;
+	bool normalsSpecified = false;
 
-	for (int lineIndex = 0; lineIndex < numLines; ++lineIndex)
+	if (parser.LoadFile(filePath))
 	{
-		std::string currLine = lines[lineIndex];
-
-		std::vector<std::string> tokens = Tokenize(currLine, ' ');
+		normalsSpecified = (parser.GetNormals().size() > 0);
+	}
 
-		// Empty line check
-		if (tokens.size() == 0) { continue; }
+	BeginBuilding(PRIMITIVE_TRIANGLES, normalsSpecified);
 
-		// Figure out how to treat the line
-		bool isPosition = (tokens[0] == "v");
-		bool isNormal	= (tokens[0] == "vn");
-		bool isUV		= (tokens[0] == "vt");
-		bool isFace		= (tokens[0] == "f");
+	if (normalsSpecified)
+	{
+		parser.BuildIndexedVertices(0, parser.GetTriangleCount(), m_vertices, m_indices);
+	}
+	else
+	{
+		const std::vector<ObjFaceCorner_t>& corners = parser.GetCorners();
+		m_vertices.reserve(m_vertices.size() + corners.size());
 
-		if (isPosition || isNormal || isUV)
+		for (int cornerIndex = 0; cornerIndex < (int)corners.size(); ++cornerIndex)
 		{
-			// Treat tokens as floats
-			float x = StringToFloat(tokens[1]);
-			float y = StringToFloat(tokens[2]);
-
-			// Only care about the z if it's not a UV
-			if (isPosition || isNormal)
-			{
-				float z = StringToFloat(tokens[3]);
-				
-				// Figure out where to push it
-				if (isPosition) { positions.push_back(Vector3(x, y, z)); }
-				else			{ normals.push_back(Vector3(x, y, z));   }
-			}
-			else
-			{
-				// Is a UV
-				uvs.push_back(Vector2(x, y));
-			}
-		}
-		else if (isFace)
-		{
-			// flag + 3 tokens specifies 3 vertices, which is one triangle
-			// otherwise we assume 4 vertices are specified, for a quad
-			bool isTwoTriangles = (tokens.size() == 5);
-
-			std::vector<VertexMaster> vertices;
-
-			// Start at one to miss the flag
-			for (int tokenIndex = 1; tokenIndex < (int) tokens.size(); ++tokenIndex)
-			{
-				vertices.push_back(CreateMasterFromString(tokens[tokenIndex], positions, normals, uvs));
-			}
-
-			// Push the vertices in order
-			m_vertices.push_back(vertices[0]);
-			m_vertices.push_back(vertices[1]);
-			m_vertices.push_back(vertices[2]);
-
-			if (isTwoTriangles)
-			{
-				m_vertices.push_back(vertices[0]);
-				m_vertices.push_back(vertices[2]);
-				m_vertices.push_back(vertices[3]);
-			}
+			m_vertices.push_back(parser.CreateVertex(corners[cornerIndex]));
 		}
 	}
 
 	// Flip the Mesh horizontally, since OBJ files use a right-handed basis
 	FlipHorizontal();
 
-	// Generate normals (and tangents), only if none were specified in the OBJ file
-	bool normalsSpecified = (normals.size() > 0);
-
-	if (!normalsSpecified)
-	{
-		GenerateFlatTBN();
-	}
-	else
+	if (GetNumTriangles() > 0)
 	{
-		// Generate tangents using existing normals
-		GenerateMikkTangents(*this);
+		// Generate normals (and tangents), only if none were specified in the OBJ file
+		if (!normalsSpecified)
+		{
+			GenerateFlatTBN();
+		}
+		else
+		{
+			// Generate tangents using existing normals
+			GenerateMikkTangents(*this);
+		}
 	}
 
 	FinishBuilding();
@@ -187,6 +141,73 @@ void MeshBuilder::FlipHorizontal()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Sets whether the asset loaders optimize the meshes they build
+//
+void MeshBuilder::SetOptimizeOnLoad(bool optimizeOnLoad)
+{
+	s_optimizeOnLoad = optimizeOnLoad;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true if the asset loaders optimize the meshes they build
+//
+bool MeshBuilder::IsOptimizeOnLoadEnabled()
+{
+	return s_optimizeOnLoad;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs the optimization passes over everything in the builder, which becomes one indexed triangle list
+// Only for finished builders, since vertices and triangles are merged and reordered
+//
+MeshOptimizationStats_t MeshBuilder::Optimize()
+{
+	ASSERT_OR_DIE(!m_isBuilding, "Error: MeshBuilder::Optimize() called while still building");
+	ASSERT_OR_DIE(m_instruction.m_primType == PRIMITIVE_TRIANGLES, "Error: MeshBuilder::Optimize() called on builder that isn't using triangles");
+	ASSERT_OR_DIE(m_instruction.m_startIndex == 0, "Error: MeshBuilder::Optimize() called on builder with more than one draw");
+
+	MeshOptimizationStats_t stats;
+	stats.triangleCount = GetNumTriangles();
+	stats.vertexCountBefore = (int) m_vertices.size();
+
+	// Without indices every corner is its own vertex, so nothing is ever reused
+	if (m_instruction.m_usingIndices)
+	{
+		stats.acmrBefore = MeshOptimizer::CalculateACMR(m_indices.data(), (int) m_indices.size(), (int) m_vertices.size());
+	}
+	else
+	{
+		stats.acmrBefore = 3.f;
+		m_indices.clear();
+	}
+
+	uint64_t startTime = GetPerformanceCounter();
+
+	MeshOptimizer::WeldVertices(m_vertices, m_indices);
+	MeshOptimizer::OptimizeVertexCacheOrder(m_indices.data(), (int) m_indices.size(), (int) m_vertices.size());
+	MeshOptimizer::OptimizeVertexFetchOrder(m_indices.data(), (int) m_indices.size(), m_vertices);
+
+	stats.secondsTaken = TimeSystem::PerformanceCountToSeconds(GetPerformanceCounter() - startTime);
+
+	m_instruction.m_usingIndices = true;
+	m_instruction.m_elementCount = (unsigned int) m_indices.size();
+
+	stats.vertexCountAfter = (int) m_vertices.size();
+	stats.acmrAfter = MeshOptimizer::CalculateACMR(m_indices.data(), (int) m_indices.size(), (int) m_vertices.size());
+
+	if (stats.triangleCount > 0)
+	{
+		stats.atvrBefore = stats.acmrBefore * (float) stats.triangleCount / (float) stats.vertexCountBefore;
+		stats.atvrAfter = stats.acmrAfter * (float) stats.triangleCount / (float) stats.vertexCountAfter;
+	}
+
+	return stats;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Returns the position of the vertex at the given index
 //
@@ -233,6 +254,22 @@ int MeshBuilder::GetNumTriangles() const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns the index into the vertex vector for the given corner of the given triangle
+//
+int MeshBuilder::GetVertexIndexForCorner(int triangleIndex, int cornerIndex) const
+{
+	int elementIndex = triangleIndex * 3 + cornerIndex;
+
+	if (m_instruction.m_usingIndices)
+	{
+		return (int) m_indices[elementIndex];
+	}
+
+	return elementIndex;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Sets the tangent of the vertex at the given index to the one specified
 //
@@ -423,6 +460,24 @@ int MeshBuilder::GetElementCount()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns the index at the given position in the index list
+//
+unsigned int MeshBuilder::GetIndex(int index) const
+{
+	return m_indices[index];
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the draw instruction the finished mesh will be drawn with
+//
+DrawInstruction MeshBuilder::GetDrawInstruction() const
+{
+	return m_instruction;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Sets the color on the vertex stamp to the one given
 //
@@ -786,51 +841,6 @@ void MeshBuilder::AssertBuildState(bool shouldBeBuilding, PrimitiveType primitiv
 }
 
 
-//-----------------------------------------------------------------------------------------------
-// For object loading, parses the token and returns a vertex master
-//
-VertexMaster MeshBuilder::CreateMasterFromString(const std::string& text, const std::vector<Vector3>& positions, const std::vector<Vector3>& normals, const std::vector<Vector2>& uvs)
-{
-	std::vector<std::string> indicesText = Tokenize(text, '/');
-
-	// OBJ FILES USE 1-BASED INDEXING, SO SUBTRACT ONE FROM THEM
-	VertexMaster master;
-	master.m_color = Rgba::WHITE;
-
-	// First is index for position, always (it's required)
-	int positionIndex = StringToInt(indicesText[0]) - 1;
-	master.m_position = positions[positionIndex];
-
-	// If either text coord or normal was omitted, then we need to see which was omitted
-	if (indicesText.size() == 2)
-	{
-		bool normalWasSpecified = (GetCharacterCount(text, '/') == 2); // Two slashes means position and normal
-
-		if (normalWasSpecified)
-		{
-			int normalIndex = StringToInt(indicesText[1]) - 1;
-			master.m_normal = normals[normalIndex];
-		}
-		else
-		{
-			int uvIndex = StringToInt(indicesText[1]) - 1;
-			master.m_uvs = uvs[uvIndex];
-		}
-	}
-	else
-	{
-		// Both UV and normal were specified
-		int uvIndex = StringToInt(indicesText[1]) - 1;
-		int normalIndex = StringToInt(indicesText[2]) - 1;
-
-		master.m_normal = normals[normalIndex];
-		master.m_uvs = uvs[uvIndex];
-	}
-
-	return master;
-}
-
-
 //-------------------------MikkT Tangent Space--------------------------------
 
 static int GetNumFaces(const SMikkTSpaceContext* pContext)
@@ -849,7 +859,7 @@ static int GetNumVerticesPerFace(const SMikkTSpaceContext* pContext, const int i
 static void GetVertexPosition(const SMikkTSpaceContext * pContext, float fvPosOut[], const int iFace, const int iVert)
 {
 	MeshBuilder* mb = (MeshBuilder*)pContext->m_pUserData;
-	int vertexIndex = iFace * 3 + iVert;
+	int vertexIndex = mb->GetVertexIndexForCorner(iFace, iVert);
 
 	Vector3 position = mb->GetVertexPosition(vertexIndex);
 
@@ -861,7 +871,7 @@ static void GetVertexPosition(const SMikkTSpaceContext * pContext, float fvPosOu
 static void GetVertexNormal(const SMikkTSpaceContext * pContext, float fvNormOut[], const int iFace, const int iVert)
 {
 	MeshBuilder* mb = (MeshBuilder*)pContext->m_pUserData;
-	int vertexIndex = iFace * 3 + iVert;
+	int vertexIndex = mb->GetVertexIndexForCorner(iFace, iVert);
 
 	Vector3 normal = mb->GetVertexNormal(vertexIndex);
 
@@ -873,7 +883,7 @@ static void GetVertexNormal(const SMikkTSpaceContext * pContext, float fvNormOut
 static void GetVertexUV(const SMikkTSpaceContext * pContext, float fvTexcOut[], const int iFace, const int iVert)
 {
 	MeshBuilder* mb = (MeshBuilder*)pContext->m_pUserData;
-	int vertexIndex = iFace * 3 + iVert;
+	int vertexIndex = mb->GetVertexIndexForCorner(iFace, iVert);
 
 	Vector2 uv = mb->GetVertexUV(vertexIndex);
 
@@ -885,7 +895,7 @@ static void GetVertexUV(const SMikkTSpaceContext * pContext, float fvTexcOut[],
 void SetVertexTangent(const SMikkTSpaceContext * pContext, const float fvTangent[], const float fSign, const int iFace, const int iVert)
 {
 	MeshBuilder* mb = (MeshBuilder*)pContext->m_pUserData;
-	int vertexIndex = iFace * 3 + iVert;
+	int vertexIndex = mb->GetVertexIndexForCorner(iFace, iVert);
 
 	Vector4 tangent = Vector4(fvTangent[0], fvTangent[1], fvTangent[2], fSign);
 
@@ -9,6 +9,7 @@
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Rendering/Meshes/Mesh.hpp"
+#include "Engine/Rendering/Meshes/MeshOptimizer.hpp"
 #include "Engine/Rendering/Core/Vertex.hpp"
 
 typedef Vector3 (*SurfacePatchFunction)(const Vector2&);
@@ -59,6 +60,14 @@ public:
 	void	GenerateFlatTBN();
 	void	GenerateSmoothNormals();
 
+	// Welds, indexes, and reorders the finished mesh for the vertex caches, returning before/after stats
+	MeshOptimizationStats_t Optimize();
+
+	// Whether the asset loaders run Optimize() on the meshes they build - off unless turned on, since it
+	// changes the vertex and index order of what's loaded and adds its cost to every load that isn't baked
+	static void SetOptimizeOnLoad(bool optimizeOnLoad);
+	static bool IsOptimizeOnLoadEnabled();
+
 	// Accessors
 	template <typename VERT_TYPE>
 	VERT_TYPE GetVertex(int index)
@@ -67,9 +76,11 @@ public:
 		return vertex;
 	}
 
-	int		GetVertexCount();
-	int		GetIndexCount();
-	int		GetElementCount();
+	int				GetVertexCount();
+	int				GetIndexCount();
+	int				GetElementCount();
+	unsigned int	GetIndex(int index) const;
+	DrawInstruction	GetDrawInstruction() const;
 
 
 public:
@@ -79,6 +90,7 @@ public:
 	Vector3 GetVertexNormal(int vboIndex) const;
 	Vector2 GetVertexUV(int vboIndex) const;
 	int		GetNumTriangles() const;
+	int		GetVertexIndexForCorner(int triangleIndex, int cornerIndex) const;
 
 	void	SetVertexTangent(int vboIndex, const Vector4& tangent);
 
@@ -125,9 +137,6 @@ public:
 
 	void AssertBuildState(bool shouldBeBuilding, PrimitiveType primitiveType, bool shouldUseIndices) const;
 
-	// For Object file loading
-	static VertexMaster CreateMasterFromString(const std::string& text, const std::vector<Vector3>& positions, const std::vector<Vector3>& normals, const std::vector<Vector2>& uvs);
-
 
 private:
 	//-----Private Data-----
@@ -138,6 +147,8 @@ private:
 
 	std::vector<unsigned int>	m_indices;
 	std::vector<VertexMaster>	m_vertices;
+
+	static bool s_optimizeOnLoad;
 	
 };
 
@@ -1,6 +1,5 @@
-#include "Engine/Core/File.hpp"
-#include "Engine/Core/Utility/StringUtils.hpp"
 #include "Engine/Rendering/Meshes/MeshBuilder.hpp"
+#include "Engine/Rendering/Meshes/ObjFileParser.hpp"
 #include "Engine/Rendering/Meshes/MeshGroupBuilder.hpp"
 
 
@@ -23,128 +22,56 @@ MeshGroupBuilder::~MeshGroupBuilder()
 	m_meshBuilders.clear();
 }
 
-void MeshGroupBuilder::LoadFromObjFile(const std::string& filePath)
+int MeshGroupBuilder::GetMeshBuilderCount() const
 {
-	// Load the file
-
-	// Iterate across all the lines, collecting the vertex and index information
-
-	// When we start hitting faces, start pushing to meshbuilder
-
-	// Once we hit the usemtl, create the mesh, add to list, and clear mb
-
-	MeshBuilder* mb = new MeshBuilder();
-	mb->BeginBuilding(PRIMITIVE_TRIANGLES, false);
-
-	size_t size;
-	const char* buffer = (const char*)FileReadToNewBuffer(filePath.c_str(), size);
-	if (buffer == nullptr) { return; }
+	return (int) m_meshBuilders.size();
+}
 
-	std::string fileContents = std::string(buffer);
+MeshBuilder* MeshGroupBuilder::GetMeshBuilder(int index) const
+{
+	return m_meshBuilders[index];
+}
 
-	std::vector<Vector3> positions;
-	std::vector<Vector3> normals;
-	std::vector<Vector2> uvs;
+void MeshGroupBuilder::LoadFromObjFile(const std::string& filePath)
+{
+	ObjFileParser parser;
+	if (!parser.LoadFile(filePath)) { return; }
 
-	std::vector<std::string> lines = Tokenize(fileContents, '\n');
-	int numLines = (int) lines.size();
+	// Each usemtl line starts a new mesh
+	const std::vector<int>& materialStarts = parser.GetMaterialStarts();
+	const std::vector<ObjFaceCorner_t>& corners = parser.GetCorners();
+	int groupStart = 0;
 
-	for (int lineIndex = 0; lineIndex < numLines; ++lineIndex)
+	for (int groupIndex = 0; groupIndex <= (int) materialStarts.size(); ++groupIndex)
 	{
-		std::string currLine = lines[lineIndex];
-
-		std::vector<std::string> tokens = Tokenize(currLine, ' ');
-
-		// Empty line check
-		if (tokens.size() == 0) { continue; }
+		int groupEnd = (groupIndex < (int) materialStarts.size() ? materialStarts[groupIndex] : parser.GetTriangleCount());
 
-		// Figure out how to treat the line
-		bool isPosition = (tokens[0] == "v");
-		bool isNormal	= (tokens[0] == "vn");
-		bool isUV		= (tokens[0] == "vt");
-		bool isFace		= (tokens[0] == "f");
-		bool isMaterialChange = (tokens[0] == "usemtl");
-
-		if (isPosition || isNormal || isUV)
+		// Only make a mesh if the group has data
+		if (groupEnd > groupStart)
 		{
-			// Treat tokens as floats
-			float x = StringToFloat(tokens[1]);
-			float y = StringToFloat(tokens[2]);
-
-			// Only care about the z if it's not a UV
-			if (isPosition || isNormal)
-			{
-				float z = StringToFloat(tokens[3]);
+			MeshBuilder* mb = new MeshBuilder();
+			mb->BeginBuilding(PRIMITIVE_TRIANGLES, false);
 
-				// Figure out where to push it
-				if (isPosition) { positions.push_back(Vector3(x, y, z)); }
-				else			{ normals.push_back(Vector3(x, y, z));   }
-			}
-			else
+			for (int cornerIndex = groupStart * 3; cornerIndex < groupEnd * 3; ++cornerIndex)
 			{
-				// Is a UV
-				uvs.push_back(Vector2(x, y));
+				mb->PushVertex(parser.CreateVertex(corners[cornerIndex]));
 			}
-		}
-		else if (isFace)
-		{
-			// flag + 3 tokens specifies 3 vertices, which is one triangle
-			// otherwise we assume 4 vertices are specified, for a quad
-			bool isTwoTriangles = (tokens.size() == 5); // 5 = 1 from 'f', 4 from the 4 verts
 
-			std::vector<VertexMaster> vertices;
-
-			// Start at one to skip the 'f' flag
-			for (int tokenIndex = 1; tokenIndex < (int) tokens.size(); ++tokenIndex)
-			{
-				vertices.push_back(MeshBuilder::CreateMasterFromString(tokens[tokenIndex], positions, normals, uvs));
-			}
+			// Flip the Mesh horizontally, since OBJ files use a right-handed basis
+			mb->FlipHorizontal();
 
-			// Push the vertices in order
-			mb->PushVertex(vertices[0]);
-			mb->PushVertex(vertices[1]);
-			mb->PushVertex(vertices[2]);
+			mb->GenerateSmoothNormals();
+			mb->FinishBuilding();
 
-			if (isTwoTriangles)
+			if (MeshBuilder::IsOptimizeOnLoadEnabled())
 			{
-				mb->PushVertex(vertices[0]);
-				mb->PushVertex(vertices[2]);
-				mb->PushVertex(vertices[3]);
+				mb->Optimize();
 			}
-		}
-		else if (isMaterialChange)
-		{
-			// Finalize the MeshBuilder, if it has data
-			if (mb->GetNumTriangles() > 0)
-			{
-				// Flip the Mesh horizontally, since OBJ files use a right-handed basis
-				mb->FlipHorizontal();
 
-				mb->GenerateSmoothNormals();
-				mb->FinishBuilding();
-
-				// Add the builder to the list
-				m_meshBuilders.push_back(mb);
-
-				// Create a new builder here for the next mesh
-				mb = new MeshBuilder();		
-				mb->BeginBuilding(PRIMITIVE_TRIANGLES, false);
-			}
+			// Add the builder to the list
+			m_meshBuilders.push_back(mb);
 		}
-	}
 
-	// Create a mesh from what's remaining in the builder, if there is any
-	// Finalize the MeshBuilder, if it has data
-	if (mb->GetNumTriangles() > 0)
-	{
-		// Flip the Mesh horizontally, since OBJ files use a right-handed basis
-		mb->FlipHorizontal();
-
-		mb->GenerateSmoothNormals();
-		mb->FinishBuilding();
-
-		// Add the builder to the list
-		m_meshBuilders.push_back(mb);
+		groupStart = groupEnd;
 	}
 }
-
@@ -12,6 +12,9 @@ public:
 	~MeshGroupBuilder();
 
 	void LoadFromObjFile(const std::string& filename);
+
+	int				GetMeshBuilderCount() const;
+	MeshBuilder*	GetMeshBuilder(int index) const;
 	
 	template <typename VERT_TYPE = VertexLit>
 	MeshGroup* CreateMeshGroup() const
@@ -0,0 +1,445 @@
+/************************************************************************/
+/* File: MeshOptimizer.cpp
+/* Author: Andrew Chase
+/* Date: June 15th, 2019
+/* Description: Implementation of the MeshOptimizer class
+/************************************************************************/
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Rendering/Meshes/MeshBuilder.hpp"
+#include "Engine/Rendering/Meshes/MeshOptimizer.hpp"
+#include "Engine/Core/DeveloperConsole/Command.hpp"
+#include "Engine/Core/DeveloperConsole/DevConsole.hpp"
+
+// Console commands
+static void Command_MeshOptimize(Command& cmd);
+
+// Forsyth's tuning values, from "Linear-Speed Vertex Cache Optimisation"
+// The cache modeled is an LRU, bigger than most hardware, which keeps the order good across cache sizes
+static constexpr int	FORSYTH_CACHE_SIZE = 32;
+static constexpr int	FORSYTH_VALENCE_TABLE_SIZE = 32;
+static constexpr float	FORSYTH_CACHE_DECAY_POWER = 1.5f;
+static constexpr float	FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+static constexpr float	FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+static constexpr float	FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+
+//-----------------------------------------------------------------------------------------------
+// Score tables for the Forsyth pass, built once since the powf calls dominate otherwise
+//
+struct ForsythScoreTables_t
+{
+	ForsythScoreTables_t()
+	{
+		for (int cachePosition = 0; cachePosition < FORSYTH_CACHE_SIZE; ++cachePosition)
+		{
+			if (cachePosition < 3)
+			{
+				// The last triangle's vertices get a fixed score, so the next triangle isn't biased toward one edge of it
+				cacheScores[cachePosition] = FORSYTH_LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				float scaler = 1.f - ((float)(cachePosition - 3) / (float)(FORSYTH_CACHE_SIZE - 3));
+				cacheScores[cachePosition] = powf(scaler, FORSYTH_CACHE_DECAY_POWER);
+			}
+		}
+
+		valenceScores[0] = 0.f;
+		for (int valence = 1; valence < FORSYTH_VALENCE_TABLE_SIZE; ++valence)
+		{
+			valenceScores[valence] = FORSYTH_VALENCE_BOOST_SCALE * powf((float)valence, -FORSYTH_VALENCE_BOOST_POWER);
+		}
+	}
+
+	float cacheScores[FORSYTH_CACHE_SIZE];
+	float valenceScores[FORSYTH_VALENCE_TABLE_SIZE];
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns how much the vertex wants its triangles drawn next - more if it's recently used, and more if
+// it has few triangles left, so lone triangles get cleaned up instead of stranded
+//
+static float GetForsythVertexScore(int cachePosition, int remainingTriangles)
+{
+	static const ForsythScoreTables_t s_tables;
+
+	if (remainingTriangles == 0)
+	{
+		return -1.f;
+	}
+
+	float score = 0.f;
+
+	if (cachePosition >= 0)
+	{
+		score = s_tables.cacheScores[cachePosition];
+	}
+
+	if (remainingTriangles < FORSYTH_VALENCE_TABLE_SIZE)
+	{
+		score += s_tables.valenceScores[remainingTriangles];
+	}
+	else
+	{
+		score += FORSYTH_VALENCE_BOOST_SCALE * powf((float)remainingTriangles, -FORSYTH_VALENCE_BOOST_POWER);
+	}
+
+	return score;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Hashes all of the vertex's bytes, VertexMaster has no padding so equal vertices hash equal
+//
+static uint32_t HashVertex(const VertexMaster& vertex)
+{
+	const uint32_t* words = (const uint32_t*)&vertex;
+	int wordCount = (int)(sizeof(VertexMaster) / sizeof(uint32_t));
+
+	uint32_t hash = 2166136261u;
+	for (int wordIndex = 0; wordIndex < wordCount; ++wordIndex)
+	{
+		hash = (hash ^ words[wordIndex]) * 16777619u;
+	}
+
+	hash ^= (hash >> 15);
+	hash *= 0x2C1B3C6Du;
+	hash ^= (hash >> 12);
+
+	return hash;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Merges identical vertices using an open addressed table of vertex indices, so nothing is copied into keys
+//
+void MeshOptimizer::WeldVertices(std::vector<VertexMaster>& vertices, std::vector<unsigned int>& indices)
+{
+	static_assert(sizeof(VertexMaster) % sizeof(uint32_t) == 0, "VertexMaster has padding, welding hashes would read it");
+
+	int vertexCount = (int)vertices.size();
+
+	int tableSize = 1;
+	while (tableSize < vertexCount * 2)
+	{
+		tableSize *= 2;
+	}
+
+	std::vector<int> table(tableSize, -1);
+	std::vector<unsigned int> remap(vertexCount);
+	std::vector<VertexMaster> uniqueVertices;
+	uniqueVertices.reserve(vertexCount);
+
+	for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const VertexMaster& vertex = vertices[vertexIndex];
+		int slot = (int)(HashVertex(vertex) & (uint32_t)(tableSize - 1));
+
+		while (table[slot] != -1 && memcmp(&uniqueVertices[table[slot]], &vertex, sizeof(VertexMaster)) != 0)
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+
+		if (table[slot] == -1)
+		{
+			table[slot] = (int)uniqueVertices.size();
+			uniqueVertices.push_back(vertex);
+		}
+
+		remap[vertexIndex] = (unsigned int)table[slot];
+	}
+
+	if (indices.size() == 0)
+	{
+		indices = remap;
+	}
+	else
+	{
+		for (int indexIndex = 0; indexIndex < (int)indices.size(); ++indexIndex)
+		{
+			indices[indexIndex] = remap[indices[indexIndex]];
+		}
+	}
+
+	vertices.swap(uniqueVertices);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Greedily emits the highest scoring triangle each step, only rescoring triangles touching the cache
+// When nothing in the cache has triangles left, it moves on to the next unemitted triangle in the
+// original order rather than searching the whole mesh, which keeps it linear
+//
+void MeshOptimizer::OptimizeVertexCacheOrder(unsigned int* indices, int indexCount, int vertexCount)
+{
+	int triangleCount = indexCount / 3;
+
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	// Triangles using each vertex, packed into one array
+	std::vector<int> remainingTriangleCounts(vertexCount, 0);
+	for (int indexIndex = 0; indexIndex < indexCount; ++indexIndex)
+	{
+		remainingTriangleCounts[indices[indexIndex]]++;
+	}
+
+	std::vector<int> adjacencyStarts(vertexCount + 1, 0);
+	for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		adjacencyStarts[vertexIndex + 1] = adjacencyStarts[vertexIndex] + remainingTriangleCounts[vertexIndex];
+	}
+
+	std::vector<int> adjacentTriangles(indexCount);
+	std::vector<int> adjacencyFill(adjacencyStarts.begin(), adjacencyStarts.end() - 1);
+
+	for (int indexIndex = 0; indexIndex < indexCount; ++indexIndex)
+	{
+		adjacentTriangles[adjacencyFill[indices[indexIndex]]++] = indexIndex / 3;
+	}
+
+	// Initial scores
+	std::vector<float> vertexScores(vertexCount);
+
+	for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		vertexScores[vertexIndex] = GetForsythVertexScore(-1, remainingTriangleCounts[vertexIndex]);
+	}
+
+	// Start from the best triangle anywhere, which favors a low valence spot like a corner or border
+	int bestTriangle = 0;
+	float bestScore = -1.f;
+
+	for (int triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex)
+	{
+		const unsigned int* corners = &indices[triangleIndex * 3];
+		float score = vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+
+		if (score > bestScore)
+		{
+			bestScore = score;
+			bestTriangle = triangleIndex;
+		}
+	}
+
+	std::vector<uint8_t> isTriangleEmitted(triangleCount, 0);
+
+	std::vector<unsigned int> reorderedIndices(indexCount);
+
+	// Room for the three new vertices to push three old ones off the end
+	int cache[FORSYTH_CACHE_SIZE + 3];
+	int newCache[FORSYTH_CACHE_SIZE + 3];
+	int cacheCount = 0;
+
+	int nextUnemittedTriangle = 0;
+
+	for (int emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+	{
+		if (bestTriangle < 0)
+		{
+			while (isTriangleEmitted[nextUnemittedTriangle] != 0)
+			{
+				nextUnemittedTriangle++;
+			}
+
+			bestTriangle = nextUnemittedTriangle;
+		}
+
+		const unsigned int* corners = &indices[bestTriangle * 3];
+		memcpy(&reorderedIndices[emittedCount * 3], corners, 3 * sizeof(unsigned int));
+		isTriangleEmitted[bestTriangle] = 1;
+
+		// Take the triangle off its vertices' lists, and put its vertices at the front of the cache
+		int newCacheCount = 0;
+
+		for (int cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+		{
+			int vertexIndex = (int)corners[cornerIndex];
+			int* triangles = &adjacentTriangles[adjacencyStarts[vertexIndex]];
+			int& remainingCount = remainingTriangleCounts[vertexIndex];
+
+			for (int listIndex = 0; listIndex < remainingCount; ++listIndex)
+			{
+				if (triangles[listIndex] == bestTriangle)
+				{
+					triangles[listIndex] = triangles[remainingCount - 1];
+					remainingCount--;
+					break;
+				}
+			}
+
+			bool isAlreadyAdded = (newCacheCount > 0 && newCache[0] == vertexIndex) || (newCacheCount > 1 && newCache[1] == vertexIndex);
+			if (!isAlreadyAdded)
+			{
+				newCache[newCacheCount++] = vertexIndex;
+			}
+		}
+
+		int triangleVertexCount = newCacheCount;
+		for (int cacheIndex = 0; cacheIndex < cacheCount; ++cacheIndex)
+		{
+			int vertexIndex = cache[cacheIndex];
+			bool isInTriangle = false;
+
+			for (int newIndex = 0; newIndex < triangleVertexCount; ++newIndex)
+			{
+				isInTriangle = isInTriangle || (newCache[newIndex] == vertexIndex);
+			}
+
+			if (!isInTriangle)
+			{
+				newCache[newCacheCount++] = vertexIndex;
+			}
+		}
+
+		// Rescore everything that moved, including the ones that just fell out of the cache
+		for (int cacheIndex = 0; cacheIndex < newCacheCount; ++cacheIndex)
+		{
+			int vertexIndex = newCache[cacheIndex];
+			int cachePosition = (cacheIndex < FORSYTH_CACHE_SIZE ? cacheIndex : -1);
+			vertexScores[vertexIndex] = GetForsythVertexScore(cachePosition, remainingTriangleCounts[vertexIndex]);
+		}
+
+		// The best next triangle is almost always one touching the cache
+		bestTriangle = -1;
+		bestScore = -1.f;
+
+		for (int cacheIndex = 0; cacheIndex < newCacheCount; ++cacheIndex)
+		{
+			int vertexIndex = newCache[cacheIndex];
+			const int* triangles = &adjacentTriangles[adjacencyStarts[vertexIndex]];
+
+			for (int listIndex = 0; listIndex < remainingTriangleCounts[vertexIndex]; ++listIndex)
+			{
+				int triangleIndex = triangles[listIndex];
+				const unsigned int* triangleCorners = &indices[triangleIndex * 3];
+
+				float score = vertexScores[triangleCorners[0]] + vertexScores[triangleCorners[1]] + vertexScores[triangleCorners[2]];
+
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = triangleIndex;
+				}
+			}
+		}
+
+		cacheCount = MinInt(newCacheCount, FORSYTH_CACHE_SIZE);
+		memcpy(cache, newCache, cacheCount * sizeof(int));
+	}
+
+	memcpy(indices, reorderedIndices.data(), indexCount * sizeof(unsigned int));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Moves vertices into first-use order, keeping any the indices never touch at the end
+//
+void MeshOptimizer::OptimizeVertexFetchOrder(unsigned int* indices, int indexCount, std::vector<VertexMaster>& vertices)
+{
+	const unsigned int UNUSED_VERTEX = 0xFFFFFFFF;
+
+	std::vector<unsigned int> remap(vertices.size(), UNUSED_VERTEX);
+	std::vector<VertexMaster> reorderedVertices;
+	reorderedVertices.reserve(vertices.size());
+
+	for (int indexIndex = 0; indexIndex < indexCount; ++indexIndex)
+	{
+		unsigned int vertexIndex = indices[indexIndex];
+
+		if (remap[vertexIndex] == UNUSED_VERTEX)
+		{
+			remap[vertexIndex] = (unsigned int)reorderedVertices.size();
+			reorderedVertices.push_back(vertices[vertexIndex]);
+		}
+
+		indices[indexIndex] = remap[vertexIndex];
+	}
+
+	for (int vertexIndex = 0; vertexIndex < (int)vertices.size(); ++vertexIndex)
+	{
+		if (remap[vertexIndex] == UNUSED_VERTEX)
+		{
+			reorderedVertices.push_back(vertices[vertexIndex]);
+		}
+	}
+
+	vertices.swap(reorderedVertices);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Counts cache misses through a FIFO of the given size - a vertex is still cached if fewer than
+// cacheSize misses have happened since it was last loaded
+//
+float MeshOptimizer::CalculateACMR(const unsigned int* indices, int indexCount, int vertexCount, int cacheSize /*= ACMR_CACHE_SIZE*/)
+{
+	int triangleCount = indexCount / 3;
+
+	if (triangleCount == 0)
+	{
+		return 0.f;
+	}
+
+	std::vector<int> loadedAtMiss(vertexCount, -cacheSize - 1);
+	int missCount = 0;
+
+	for (int indexIndex = 0; indexIndex < indexCount; ++indexIndex)
+	{
+		unsigned int vertexIndex = indices[indexIndex];
+
+		if (missCount - loadedAtMiss[vertexIndex] > cacheSize)
+		{
+			loadedAtMiss[vertexIndex] = missCount;
+			missCount++;
+		}
+	}
+
+	return (float)missCount / (float)triangleCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Registers the console command for checking the optimizer against a model
+//
+void MeshOptimizer::InitializeConsoleCommands()
+{
+	Command::Register("mesh_optimize", "Loads the OBJ file -f, optimizes it, and prints vertex counts and ACMR before and after", Command_MeshOptimize);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Loads the model, runs the optimization passes, and prints the stats
+//
+static void Command_MeshOptimize(Command& cmd)
+{
+	std::string filepath;
+	if (!cmd.GetParam("f", filepath))
+	{
+		ConsoleErrorf("No file specified, use -f <file>");
+		return;
+	}
+
+	MeshBuilder mb;
+	mb.LoadFromObjFile(filepath);
+
+	if (mb.GetVertexCount() == 0)
+	{
+		ConsoleErrorf("Couldn't load any triangles from %s", filepath.c_str());
+		return;
+	}
+
+	MeshOptimizationStats_t stats = mb.Optimize();
+
+	ConsolePrintf(Rgba::GREEN, "%s: %i triangles, %i vertices welded to %i, in %.2f ms",
+		filepath.c_str(), stats.triangleCount, stats.vertexCountBefore, stats.vertexCountAfter, stats.secondsTaken * 1000.0);
+	ConsolePrintf(Rgba::GREEN, "ACMR %.3f -> %.3f, ATVR %.3f -> %.3f (FIFO of %i)",
+		stats.acmrBefore, stats.acmrAfter, stats.atvrBefore, stats.atvrAfter, MeshOptimizer::ACMR_CACHE_SIZE);
+}
@@ -0,0 +1,56 @@
+/************************************************************************/
+/* File: MeshOptimizer.hpp
+/* Author: Andrew Chase
+/* Date: June 15th, 2019
+/* Description: Post-build passes that weld duplicate vertices and reorder
+/*				triangles and vertices for the GPU's vertex caches
+/************************************************************************/
+#pragma once
+#include <vector>
+#include "Engine/Rendering/Core/Vertex.hpp"
+
+// ACMR is vertex shader runs per triangle - 3 is no reuse at all, and a well ordered grid approaches 0.5
+// ATVR is vertex shader runs per vertex - 1 is every vertex transformed exactly once
+struct MeshOptimizationStats_t
+{
+	int		triangleCount = 0;
+	int		vertexCountBefore = 0;
+	int		vertexCountAfter = 0;
+
+	float	acmrBefore = 0.f;
+	float	acmrAfter = 0.f;
+	float	atvrBefore = 0.f;
+	float	atvrAfter = 0.f;
+
+	double	secondsTaken = 0.0;
+};
+
+
+class MeshOptimizer
+{
+public:
+	//-----Public Methods-----
+
+	// Merges vertices that are identical in every attribute and remaps the indices to match
+	// Empty indices are treated as an unindexed triangle list, and filled in
+	static void		WeldVertices(std::vector<VertexMaster>& vertices, std::vector<unsigned int>& indices);
+
+	// Reorders triangles so vertices are reused while still in the post-transform cache (Forsyth's algorithm)
+	static void		OptimizeVertexCacheOrder(unsigned int* indices, int indexCount, int vertexCount);
+
+	// Reorders vertices into the order the indices first use them, so fetches walk memory forwards
+	static void		OptimizeVertexFetchOrder(unsigned int* indices, int indexCount, std::vector<VertexMaster>& vertices);
+
+	// Simulates a FIFO post-transform cache, returning the vertex shader runs per triangle
+	static float	CalculateACMR(const unsigned int* indices, int indexCount, int vertexCount, int cacheSize = ACMR_CACHE_SIZE);
+
+	static void		InitializeConsoleCommands();
+
+
+public:
+	//-----Public Data-----
+
+	// Most hardware caches hold somewhere around this many vertices, and it's the usual size for comparing ACMR
+	static constexpr int ACMR_CACHE_SIZE = 16;
+
+};
@@ -0,0 +1,702 @@
+/************************************************************************/
+/* File: ObjFileParser.cpp
+/* Author: Andrew Chase
+/* Date: June 15th, 2019
+/* Description: Implementation of the ObjFileParser class
+/************************************************************************/
+#include <stdint.h>
+#include <string.h>
+#include <unordered_map>
+#include "Engine/Core/File.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
+#include "Engine/Rendering/Meshes/ObjFileParser.hpp"
+
+// What a line of the file describes, decided by its first word
+enum ObjLineType
+{
+	OBJ_LINE_OTHER,
+	OBJ_LINE_POSITION,
+	OBJ_LINE_UV,
+	OBJ_LINE_NORMAL,
+	OBJ_LINE_FACE,
+	OBJ_LINE_MATERIAL
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Job for running one of the two passes over a chunk of the file
+//
+class ObjParseJob : public Job
+{
+public:
+
+	ObjParseJob(ObjFileParser* parser, int chunkIndex, bool isCountPass)
+		: m_parser(parser), m_chunkIndex(chunkIndex), m_isCountPass(isCountPass)
+	{
+		m_jobType = JOB_TYPE_OBJ_PARSE;
+		m_jobFlags = WORKER_FLAGS_ALL_BUT_DISK;
+	}
+
+	virtual void Execute() override
+	{
+		ObjFileParser::ObjChunk_t& chunk = m_parser->m_chunks[m_chunkIndex];
+
+		if (m_isCountPass)
+		{
+			m_parser->CountChunk(chunk);
+		}
+		else
+		{
+			m_parser->ParseChunk(chunk);
+		}
+	}
+
+	ObjFileParser*	m_parser = nullptr;
+	int				m_chunkIndex = 0;
+	bool			m_isCountPass = true;
+
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Hash for deduplicating corners, so each unique position/uv/normal triplet becomes one vertex
+//
+struct ObjFaceCornerHash
+{
+	size_t operator()(const ObjFaceCorner_t& corner) const
+	{
+		uint64_t hash = ((uint64_t)(uint32_t)corner.m_positionIndex << 32) | (uint32_t)corner.m_normalIndex;
+		hash ^= (uint64_t)(uint32_t)corner.m_uvIndex * 0x9E3779B97F4A7C15ull;
+
+		hash ^= (hash >> 29);
+		hash *= 0xBF58476D1CE4E5B9ull;
+		hash ^= (hash >> 32);
+
+		return (size_t)hash;
+	}
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns true for the characters that separate words on a line, including the \r of \r\n endings
+//
+static inline bool IsObjWhitespace(char character)
+{
+	return (character == ' ' || character == '\t' || character == '\r');
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Moves the cursor past any whitespace
+//
+static inline void SkipWhitespace(const char*& cursor, const char* end)
+{
+	while (cursor < end && IsObjWhitespace(*cursor))
+	{
+		cursor++;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Moves the cursor to the end of the current word
+//
+static inline void SkipWord(const char*& cursor, const char* end)
+{
+	while (cursor < end && !IsObjWhitespace(*cursor))
+	{
+		cursor++;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Reads the first word of the line and returns what kind of line it is, leaving the cursor after the word
+//
+static ObjLineType ReadLineType(const char*& cursor, const char* end)
+{
+	SkipWhitespace(cursor, end);
+
+	const char* word = cursor;
+	SkipWord(cursor, end);
+	size_t length = (size_t)(cursor - word);
+
+	if (length == 1)
+	{
+		if (word[0] == 'v') { return OBJ_LINE_POSITION; }
+		if (word[0] == 'f') { return OBJ_LINE_FACE; }
+	}
+	else if (length == 2 && word[0] == 'v')
+	{
+		if (word[1] == 't') { return OBJ_LINE_UV; }
+		if (word[1] == 'n') { return OBJ_LINE_NORMAL; }
+	}
+	else if (length == 6 && memcmp(word, "usemtl", 6) == 0)
+	{
+		return OBJ_LINE_MATERIAL;
+	}
+
+	return OBJ_LINE_OTHER;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses anything the fast path can't, like nan, inf, or very long mantissas, by copying just the
+// one word into a terminated buffer for strtod
+//
+static float ParseFloatSlow(const char* start, const char* end)
+{
+	char buffer[64];
+	size_t length = MinInt((int)(end - start), (int)sizeof(buffer) - 1);
+
+	memcpy(buffer, start, length);
+	buffer[length] = '\0';
+
+	return (float)strtod(buffer, nullptr);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses the next word as a float without copying it anywhere, advancing the cursor past it
+// Digits are gathered into an integer and scaled once by an exact power of ten, which rounds
+// correctly for any number written with fewer than 16 significant digits and an exponent within 22
+//
+static float ParseFloat(const char*& cursor, const char* end)
+{
+	static const double POWERS_OF_TEN[] =
+	{
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	SkipWhitespace(cursor, end);
+	const char* start = cursor;
+
+	bool isNegative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+'))
+	{
+		isNegative = (*cursor == '-');
+		cursor++;
+	}
+
+	uint64_t mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool hasDigits = false;
+
+	// Integer part, dropping digits past what fits and bumping the exponent instead
+	while (cursor < end && *cursor >= '0' && *cursor <= '9')
+	{
+		if (significantDigits < 19)
+		{
+			mantissa = mantissa * 10 + (uint64_t)(*cursor - '0');
+			significantDigits += (mantissa != 0 ? 1 : 0);
+		}
+		else
+		{
+			exponent++;
+		}
+
+		hasDigits = true;
+		cursor++;
+	}
+
+	// Fraction
+	if (cursor < end && *cursor == '.')
+	{
+		cursor++;
+
+		while (cursor < end && *cursor >= '0' && *cursor <= '9')
+		{
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + (uint64_t)(*cursor - '0');
+				significantDigits += (mantissa != 0 ? 1 : 0);
+				exponent--;
+			}
+
+			hasDigits = true;
+			cursor++;
+		}
+	}
+
+	if (!hasDigits)
+	{
+		SkipWord(cursor, end);
+		return ParseFloatSlow(start, cursor);
+	}
+
+	// Exponent
+	if (cursor < end && (*cursor == 'e' || *cursor == 'E'))
+	{
+		cursor++;
+
+		bool isExponentNegative = false;
+		if (cursor < end && (*cursor == '-' || *cursor == '+'))
+		{
+			isExponentNegative = (*cursor == '-');
+			cursor++;
+		}
+
+		int writtenExponent = 0;
+		while (cursor < end && *cursor >= '0' && *cursor <= '9')
+		{
+			writtenExponent = MinInt(writtenExponent * 10 + (*cursor - '0'), 10000);
+			cursor++;
+		}
+
+		exponent += (isExponentNegative ? -writtenExponent : writtenExponent);
+	}
+
+	// Past 2^53 the mantissa isn't exact as a double, and past 10^22 neither is the power
+	if (mantissa > (1ull << 53) || exponent < -22 || exponent > 22)
+	{
+		SkipWord(cursor, end);
+		return ParseFloatSlow(start, cursor);
+	}
+
+	double value = (double)mantissa;
+	value = (exponent >= 0 ? value * POWERS_OF_TEN[exponent] : value / POWERS_OF_TEN[-exponent]);
+
+	return (float)(isNegative ? -value : value);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses the next run of digits as an int, returning 0 if there aren't any
+//
+static int ParseInt(const char*& cursor, const char* end)
+{
+	bool isNegative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+'))
+	{
+		isNegative = (*cursor == '-');
+		cursor++;
+	}
+
+	int value = 0;
+	while (cursor < end && *cursor >= '0' && *cursor <= '9')
+	{
+		value = value * 10 + (*cursor - '0');
+		cursor++;
+	}
+
+	return (isNegative ? -value : value);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Converts an OBJ index to a 0-based one - OBJ counts from 1, negative indices count back from
+// the latest attribute, and 0 means the index was left out
+//
+static inline int ResolveObjIndex(int objIndex, int countSoFar)
+{
+	if (objIndex > 0) { return objIndex - 1; }
+	if (objIndex < 0) { return countSoFar + objIndex; }
+
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses one face corner of the form p, p/t, p//n, or p/t/n
+// Returns false once there are no corners left on the line
+//
+static bool ParseFaceCorner(const char*& cursor, const char* end, int positionCount, int uvCount, int normalCount, ObjFaceCorner_t& out_corner)
+{
+	SkipWhitespace(cursor, end);
+
+	if (cursor >= end)
+	{
+		return false;
+	}
+
+	out_corner = ObjFaceCorner_t();
+	out_corner.m_positionIndex = ResolveObjIndex(ParseInt(cursor, end), positionCount);
+
+	if (cursor < end && *cursor == '/')
+	{
+		cursor++;
+
+		if (cursor < end && *cursor != '/')
+		{
+			out_corner.m_uvIndex = ResolveObjIndex(ParseInt(cursor, end), uvCount);
+		}
+
+		if (cursor < end && *cursor == '/')
+		{
+			cursor++;
+			out_corner.m_normalIndex = ResolveObjIndex(ParseInt(cursor, end), normalCount);
+		}
+	}
+
+	// Anything unexpected left in the word is dropped, so the next corner starts clean
+	SkipWord(cursor, end);
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Maps the file and parses it in place, line endings and all
+//
+bool ObjFileParser::LoadFile(const std::string& filePath)
+{
+	MappedFile file;
+
+	if (!file.Open(filePath.c_str()))
+	{
+		return false;
+	}
+
+	Parse(file.GetData(), file.GetSize());
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses the OBJ text, replacing anything parsed before
+// The first pass only counts attributes per chunk, so the second can write every chunk's attributes
+// straight into their final place and resolve relative face indices, without any chunk waiting on another
+//
+void ObjFileParser::Parse(const char* data, size_t size)
+{
+	m_positions.clear();
+	m_normals.clear();
+	m_uvs.clear();
+	m_corners.clear();
+	m_materialStarts.clear();
+
+	// Single threaded when already in a job (as async mesh loads are), since waiting would tie up the worker
+	// Otherwise the calling thread takes a chunk too
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	bool canUseJobs = (jobSystem != nullptr && !JobSystem::IsOnWorkerThread());
+	int workerCount = (canUseJobs ? jobSystem->GetWorkerThreadCount(WORKER_FLAGS_ALL_BUT_DISK) : 0);
+	int chunkCount = ClampInt((int)(size / MIN_BYTES_PER_CHUNK), 1, workerCount + 1);
+
+	SplitIntoChunks(data, size, chunkCount);
+	RunPassOnChunks(true);
+
+	int positionCount = 0;
+	int uvCount = 0;
+	int normalCount = 0;
+
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); ++chunkIndex)
+	{
+		ObjChunk_t& chunk = m_chunks[chunkIndex];
+
+		chunk.m_firstPosition = positionCount;
+		chunk.m_firstUV = uvCount;
+		chunk.m_firstNormal = normalCount;
+
+		positionCount += chunk.m_positionCount;
+		uvCount += chunk.m_uvCount;
+		normalCount += chunk.m_normalCount;
+	}
+
+	m_positions.resize(positionCount);
+	m_uvs.resize(uvCount);
+	m_normals.resize(normalCount);
+
+	RunPassOnChunks(false);
+
+	// Stitch the faces together in file order
+	size_t cornerCount = 0;
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); ++chunkIndex)
+	{
+		cornerCount += m_chunks[chunkIndex].m_corners.size();
+	}
+
+	m_corners.reserve(cornerCount);
+
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); ++chunkIndex)
+	{
+		ObjChunk_t& chunk = m_chunks[chunkIndex];
+		int firstTriangle = GetTriangleCount();
+
+		for (int startIndex = 0; startIndex < (int)chunk.m_materialStarts.size(); ++startIndex)
+		{
+			m_materialStarts.push_back(firstTriangle + chunk.m_materialStarts[startIndex]);
+		}
+
+		m_corners.insert(m_corners.end(), chunk.m_corners.begin(), chunk.m_corners.end());
+	}
+
+	m_chunks.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the vertex positions, in file order
+//
+const std::vector<Vector3>& ObjFileParser::GetPositions() const
+{
+	return m_positions;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the vertex normals, in file order
+//
+const std::vector<Vector3>& ObjFileParser::GetNormals() const
+{
+	return m_normals;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the texture coordinates, in file order
+//
+const std::vector<Vector2>& ObjFileParser::GetUVs() const
+{
+	return m_uvs;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the corners of every triangle, three in a row per triangle
+//
+const std::vector<ObjFaceCorner_t>& ObjFileParser::GetCorners() const
+{
+	return m_corners;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the index of the first triangle following each material change
+//
+const std::vector<int>& ObjFileParser::GetMaterialStarts() const
+{
+	return m_materialStarts;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of triangles parsed
+//
+int ObjFileParser::GetTriangleCount() const
+{
+	return (int)m_corners.size() / 3;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the vertex for the corner, leaving out any attribute it doesn't reference
+// Out of range indices are treated as missing rather than read past the end
+//
+VertexMaster ObjFileParser::CreateVertex(const ObjFaceCorner_t& corner) const
+{
+	VertexMaster master;
+	master.m_color = Rgba::WHITE;
+
+	if (corner.m_positionIndex >= 0 && corner.m_positionIndex < (int)m_positions.size())
+	{
+		master.m_position = m_positions[corner.m_positionIndex];
+	}
+
+	if (corner.m_uvIndex >= 0 && corner.m_uvIndex < (int)m_uvs.size())
+	{
+		master.m_uvs = m_uvs[corner.m_uvIndex];
+	}
+
+	if (corner.m_normalIndex >= 0 && corner.m_normalIndex < (int)m_normals.size())
+	{
+		master.m_normal = m_normals[corner.m_normalIndex];
+	}
+
+	return master;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Makes a vertex for each unique position/uv/normal triplet in the range and indexes the triangles into them
+//
+void ObjFileParser::BuildIndexedVertices(int firstTriangle, int triangleCount, std::vector<VertexMaster>& out_vertices, std::vector<unsigned int>& out_indices) const
+{
+	int firstCorner = firstTriangle * 3;
+	int endCorner = firstCorner + triangleCount * 3;
+
+	std::unordered_map<ObjFaceCorner_t, unsigned int, ObjFaceCornerHash> vertexIndices;
+	vertexIndices.reserve(triangleCount * 3);
+
+	out_indices.reserve(out_indices.size() + triangleCount * 3);
+
+	for (int cornerIndex = firstCorner; cornerIndex < endCorner; ++cornerIndex)
+	{
+		const ObjFaceCorner_t& corner = m_corners[cornerIndex];
+		auto result = vertexIndices.emplace(corner, (unsigned int)out_vertices.size());
+
+		if (result.second)
+		{
+			out_vertices.push_back(CreateVertex(corner));
+		}
+
+		out_indices.push_back(result.first->second);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Splits the data into roughly even chunks, moving each split to the next line break
+//
+void ObjFileParser::SplitIntoChunks(const char* data, size_t size, int chunkCount)
+{
+	m_chunks.clear();
+	m_chunks.resize(chunkCount);
+
+	const char* dataEnd = data + size;
+	const char* chunkStart = data;
+
+	for (int chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+	{
+		const char* chunkEnd = dataEnd;
+
+		if (chunkIndex < chunkCount - 1)
+		{
+			chunkEnd = data + (size * (chunkIndex + 1)) / chunkCount;
+			chunkEnd = (chunkEnd < chunkStart ? chunkStart : chunkEnd);
+
+			const char* lineBreak = (const char*)memchr(chunkEnd, '\n', (size_t)(dataEnd - chunkEnd));
+			chunkEnd = (lineBreak != nullptr ? lineBreak + 1 : dataEnd);
+		}
+
+		m_chunks[chunkIndex].m_start = chunkStart;
+		m_chunks[chunkIndex].m_end = chunkEnd;
+
+		chunkStart = chunkEnd;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Runs the count or parse pass over every chunk, the first on this thread and the rest in jobs
+//
+void ObjFileParser::RunPassOnChunks(bool isCountPass)
+{
+	std::vector<int> jobIDs;
+
+	for (int chunkIndex = 1; chunkIndex < (int)m_chunks.size(); ++chunkIndex)
+	{
+		jobIDs.push_back(QueueJob(new ObjParseJob(this, chunkIndex, isCountPass)));
+	}
+
+	if (isCountPass)	{ CountChunk(m_chunks[0]); }
+	else				{ ParseChunk(m_chunks[0]); }
+
+	// Only this parse's jobs, so concurrent parses don't finalize each other's chunks
+	if (jobIDs.size() > 0)
+	{
+		JobSystem::GetInstance()->BlockUntilJobsAreFinalized(jobIDs);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Counts the positions, uvs, and normals in the chunk
+//
+void ObjFileParser::CountChunk(ObjChunk_t& chunk) const
+{
+	const char* lineStart = chunk.m_start;
+
+	while (lineStart < chunk.m_end)
+	{
+		const char* lineEnd = (const char*)memchr(lineStart, '\n', (size_t)(chunk.m_end - lineStart));
+		lineEnd = (lineEnd != nullptr ? lineEnd : chunk.m_end);
+
+		const char* cursor = lineStart;
+		switch (ReadLineType(cursor, lineEnd))
+		{
+		case OBJ_LINE_POSITION:	chunk.m_positionCount++;	break;
+		case OBJ_LINE_UV:		chunk.m_uvCount++;			break;
+		case OBJ_LINE_NORMAL:	chunk.m_normalCount++;		break;
+		default:
+			break;
+		}
+
+		lineStart = lineEnd + 1;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses the chunk's attributes into their place in the shared arrays, and its faces into the chunk
+//
+void ObjFileParser::ParseChunk(ObjChunk_t& chunk)
+{
+	int positionCount = chunk.m_firstPosition;
+	int uvCount = chunk.m_firstUV;
+	int normalCount = chunk.m_firstNormal;
+
+	const char* lineStart = chunk.m_start;
+
+	while (lineStart < chunk.m_end)
+	{
+		const char* lineEnd = (const char*)memchr(lineStart, '\n', (size_t)(chunk.m_end - lineStart));
+		lineEnd = (lineEnd != nullptr ? lineEnd : chunk.m_end);
+
+		const char* cursor = lineStart;
+		switch (ReadLineType(cursor, lineEnd))
+		{
+		case OBJ_LINE_POSITION:
+		{
+			float x = ParseFloat(cursor, lineEnd);
+			float y = ParseFloat(cursor, lineEnd);
+			float z = ParseFloat(cursor, lineEnd);
+
+			m_positions[positionCount++] = Vector3(x, y, z);
+		}
+			break;
+		case OBJ_LINE_UV:
+		{
+			float u = ParseFloat(cursor, lineEnd);
+			float v = ParseFloat(cursor, lineEnd);
+
+			m_uvs[uvCount++] = Vector2(u, v);
+		}
+			break;
+		case OBJ_LINE_NORMAL:
+		{
+			float x = ParseFloat(cursor, lineEnd);
+			float y = ParseFloat(cursor, lineEnd);
+			float z = ParseFloat(cursor, lineEnd);
+
+			m_normals[normalCount++] = Vector3(x, y, z);
+		}
+			break;
+		case OBJ_LINE_FACE:
+		{
+			// Fan out from the first corner, so quads become (0, 1, 2) and (0, 2, 3)
+			ObjFaceCorner_t firstCorner;
+			ObjFaceCorner_t previousCorner;
+			ObjFaceCorner_t currentCorner;
+			int cornerCount = 0;
+
+			while (ParseFaceCorner(cursor, lineEnd, positionCount, uvCount, normalCount, currentCorner))
+			{
+				if (cornerCount == 0)
+				{
+					firstCorner = currentCorner;
+				}
+				else if (cornerCount >= 2)
+				{
+					chunk.m_corners.push_back(firstCorner);
+					chunk.m_corners.push_back(previousCorner);
+					chunk.m_corners.push_back(currentCorner);
+				}
+
+				previousCorner = currentCorner;
+				cornerCount++;
+			}
+		}
+			break;
+		case OBJ_LINE_MATERIAL:
+			chunk.m_materialStarts.push_back((int)chunk.m_corners.size() / 3);
+			break;
+		default:
+			break;
+		}
+
+		lineStart = lineEnd + 1;
+	}
+}
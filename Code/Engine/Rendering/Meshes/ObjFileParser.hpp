@@ -0,0 +1,102 @@
+/************************************************************************/
+/* File: ObjFileParser.hpp
+/* Author: Andrew Chase
+/* Date: June 15th, 2019
+/* Description: Parses OBJ text in place into positions, normals, UVs,
+/*				and triangulated faces, splitting large files across
+/*				worker threads
+/************************************************************************/
+#pragma once
+#include <string>
+#include <vector>
+#include "Engine/Math/Vector2.hpp"
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Rendering/Core/Vertex.hpp"
+
+// One corner of a face, as 0-based indices into the parsed attributes, -1 where the face omitted one
+struct ObjFaceCorner_t
+{
+	int m_positionIndex = -1;
+	int m_uvIndex = -1;
+	int m_normalIndex = -1;
+
+	bool operator==(const ObjFaceCorner_t& compare) const
+	{
+		return (m_positionIndex == compare.m_positionIndex && m_uvIndex == compare.m_uvIndex && m_normalIndex == compare.m_normalIndex);
+	}
+};
+
+class ObjFileParser
+{
+	friend class ObjParseJob;
+
+public:
+	//-----Public Methods-----
+
+	// Returns false if the file couldn't be read
+	bool LoadFile(const std::string& filePath);
+
+	// Data is only read during the call, nothing points into it afterwards
+	void Parse(const char* data, size_t size);
+
+	// Accessors
+	const std::vector<Vector3>&			GetPositions() const;
+	const std::vector<Vector3>&			GetNormals() const;
+	const std::vector<Vector2>&			GetUVs() const;
+	const std::vector<ObjFaceCorner_t>&	GetCorners() const;			// Three per triangle, faces with more sides are fanned
+	const std::vector<int>&				GetMaterialStarts() const;	// First triangle after each usemtl line
+
+	int				GetTriangleCount() const;
+	VertexMaster	CreateVertex(const ObjFaceCorner_t& corner) const;
+
+	// Appends one vertex per unique corner in the triangle range, and three indices per triangle
+	// Indices are offset by the number of vertices already in out_vertices
+	void			BuildIndexedVertices(int firstTriangle, int triangleCount, std::vector<VertexMaster>& out_vertices, std::vector<unsigned int>& out_indices) const;
+
+
+private:
+	//-----Private Methods-----
+
+	// A run of whole lines, parsed independently of the others
+	struct ObjChunk_t
+	{
+		const char* m_start = nullptr;
+		const char* m_end = nullptr;
+
+		// Attribute counts from the first pass, and where the chunk's attributes start once they're summed
+		int m_positionCount = 0;
+		int m_uvCount = 0;
+		int m_normalCount = 0;
+
+		int m_firstPosition = 0;
+		int m_firstUV = 0;
+		int m_firstNormal = 0;
+
+		// Faces can't be counted without being parsed, so they're kept per chunk and appended at the end
+		std::vector<ObjFaceCorner_t>	m_corners;
+		std::vector<int>				m_materialStarts;
+	};
+
+	void SplitIntoChunks(const char* data, size_t size, int chunkCount);
+	void RunPassOnChunks(bool isCountPass);
+
+	void CountChunk(ObjChunk_t& chunk) const;
+	void ParseChunk(ObjChunk_t& chunk);
+
+
+private:
+	//-----Private Data-----
+
+	std::vector<Vector3>			m_positions;
+	std::vector<Vector3>			m_normals;
+	std::vector<Vector2>			m_uvs;
+	std::vector<ObjFaceCorner_t>	m_corners;
+	std::vector<int>				m_materialStarts;
+
+	std::vector<ObjChunk_t>			m_chunks;
+
+	// Files smaller than two chunks of this are parsed on the calling thread, since a job per few
+	// thousand lines is where splitting starts to pay for the extra pass
+	static constexpr size_t MIN_BYTES_PER_CHUNK = 256 * 1024;
+
+};
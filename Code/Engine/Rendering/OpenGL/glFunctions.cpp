@@ -119,6 +119,7 @@ PFNGLCOPYIMAGESUBDATAPROC	glCopyImageSubData = nullptr;
 
 PFNGLTEXSTORAGE2DPROC		glTexStorage2D = nullptr;
 PFNGLTEXSUBIMAGE2DPROC		glTexSubImage2D = nullptr;
+PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC	glCompressedTexSubImage2D = nullptr;
 PFNGLDELETETEXTURESPROC		glDeleteTextures = nullptr;	
 PFNGLGENERATEMIPMAPPROC		glGenerateMipmap = nullptr;
 
@@ -380,6 +381,7 @@ void BindGLFunctions()
 	GL_BIND_FUNCTION(glCopyImageSubData);
 	GL_BIND_FUNCTION(glTexStorage2D);
 	GL_BIND_FUNCTION(glTexSubImage2D);
+	GL_BIND_FUNCTION(glCompressedTexSubImage2D);
 	GL_BIND_FUNCTION(glDeleteTextures);	
 	GL_BIND_FUNCTION(glGenerateMipmap);
 	GL_BIND_FUNCTION(glBindImageTexture);
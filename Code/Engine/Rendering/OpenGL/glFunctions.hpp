@@ -126,6 +126,7 @@ extern PFNGLACTIVETEXTUREPROC		glActiveTexture;
 extern PFNGLCOPYIMAGESUBDATAPROC	glCopyImageSubData;
 extern PFNGLTEXSTORAGE2DPROC		glTexStorage2D;
 extern PFNGLTEXSUBIMAGE2DPROC		glTexSubImage2D;
+extern PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC	glCompressedTexSubImage2D;
 extern PFNGLDELETETEXTURESPROC		glDeleteTextures;	
 extern PFNGLGENERATEMIPMAPPROC		glGenerateMipmap;
 extern PFNGLBINDIMAGETEXTUREPROC	glBindImageTexture;
@@ -190,6 +190,12 @@ unsigned int ToGLType(EdgeSampling sampling) { return g_openGLEdgeSamplings[samp
 // |-------------------------|-------------------------|-------------------------|-------------------------| //
 // |D24S8 (Depth24/Stencil8) |   GL_DEPTH24_STENCIL8   |     GL_DEPTH_STENCIL    |   GL_UNSIGNED_INT_24_8  | //
 // |-------------------------|-------------------------|-------------------------|-------------------------| //
+// |   BC1 (DXT1, opaque)    |GL_COMPRESSED_RGB_S3TC_  |         GL_RGB          |     GL_UNSIGNED_BYTE    | //
+// |                         |        DXT1_EXT         |                         |                         | //
+// |-------------------------|-------------------------|-------------------------|-------------------------| //
+// |   BC3 (DXT5, alpha)     |GL_COMPRESSED_RGBA_S3TC_ |         GL_RGBA         |     GL_UNSIGNED_BYTE    | //
+// |                         |        DXT5_EXT         |                         |                         | //
+// |-------------------------|-------------------------|-------------------------|-------------------------| //
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // Internal Format
@@ -199,7 +205,9 @@ int g_openGLInternalFormats[NUM_TEXTURE_FORMATS] =
 	GL_RG8,
 	GL_RGB8,
 	GL_RGBA8,
-	GL_DEPTH24_STENCIL8
+	GL_DEPTH24_STENCIL8,
+	GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+	GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
 };
 
 // Channels
@@ -209,7 +217,9 @@ int g_openGLChannels[NUM_TEXTURE_FORMATS] =
 	GL_RG,
 	GL_RGB,
 	GL_RGBA,
-	GL_DEPTH_STENCIL
+	GL_DEPTH_STENCIL,
+	GL_RGB,
+	GL_RGBA
 };
 
 // Pixel Layouts
@@ -219,7 +229,9 @@ int g_openGLPixelLayouts[NUM_TEXTURE_FORMATS] =
 	GL_UNSIGNED_BYTE,
 	GL_UNSIGNED_BYTE,
 	GL_UNSIGNED_BYTE,
-	GL_UNSIGNED_INT_24_8
+	GL_UNSIGNED_INT_24_8,
+	GL_UNSIGNED_BYTE,
+	GL_UNSIGNED_BYTE
 };
 
 unsigned int ToGLInternalFormat(TextureFormat format) { return g_openGLInternalFormats[format]; }
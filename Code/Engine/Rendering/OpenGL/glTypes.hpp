@@ -167,6 +167,8 @@ enum TextureFormat
 	TEXTURE_FORMAT_RGB8,
 	TEXTURE_FORMAT_RGBA8,
 	TEXTURE_FORMAT_D24S8,
+	TEXTURE_FORMAT_BC1,		// Block compressed, uploaded with glCompressedTexSubImage2D()
+	TEXTURE_FORMAT_BC3,
 	NUM_TEXTURE_FORMATS
 };
 
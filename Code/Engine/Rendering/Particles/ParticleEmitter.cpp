@@ -10,12 +10,18 @@
 
 #include "Engine/Rendering/DebugRendering/DebugRenderSystem.hpp"
 
+// For giving each emitter its own random stream by default
+uint64_t ParticleEmitter::s_emittersCreated = 0;
+
+
 //-----------------------------------------------------------------------------------------------
 // Constructor - takes a clock for timing, all particles of this emitter will use this clock
 //
 ParticleEmitter::ParticleEmitter(Clock* referenceClock)
+	: m_streamID(s_emittersCreated++)
 {
 	m_stopwatch = new Stopwatch(referenceClock);
+	m_randomStream.SetSeed(DEFAULT_SEED, m_streamID);
 }
 
 
@@ -34,9 +40,7 @@ ParticleEmitter::~ParticleEmitter()
 //
 void ParticleEmitter::SetTransform(const Vector3& position, const Vector3& rotation, const Vector3& scale)
 {
-	transform.position = position;
-	transform.rotation = rotation;
-	transform.scale = scale;
+	transform.SetLocalTransform(position, rotation, scale);
 }
 
 
@@ -55,65 +59,53 @@ void ParticleEmitter::SetRenderable(Renderable* renderable)
 
 
 //-----------------------------------------------------------------------------------------------
-// Sets the renderable for this particle emitter
-// Also clears the passed renderable's instance list, to ensure we don't render anything other than
-// particle instances
+// Spawns, moves and kills particles, then writes all instance matrices to the renderable
 //
 void ParticleEmitter::Update()
 {
-	if (m_spawnsOverTime)
-	{
-		unsigned int numParticles = m_stopwatch->DecrementByIntervalAll();
-		SpawnBurst(numParticles);
-	}
+	PrepareUpdate();
+	Simulate();
+}
+
 
-	// Iterate across the particles
-	int numParticles = (int) m_particles.size();
-	for (int particleIndex = numParticles - 1; particleIndex >= 0; --particleIndex)
+//-----------------------------------------------------------------------------------------------
+// Reads everything the update needs from the clock and transform, so Simulate() doesn't have to
+//
+void ParticleEmitter::PrepareUpdate()
+{
+	m_frameSpawnCount = (m_spawnsOverTime ? m_stopwatch->DecrementByIntervalAll() : 0);
+	m_frameDeltaSeconds = m_stopwatch->GetDeltaSeconds();
+	m_frameTotalSeconds = m_stopwatch->GetTotalSeconds();
+	m_frameSpawnPosition = GetSpawnPosition();
+
+	if (m_areParticlesParented)
 	{
-		Particle& p = m_particles[particleIndex];
-		p.m_force = m_force;
-		p.Update(m_stopwatch->GetDeltaSeconds());
-		m_renderable->SetInstanceMatrix(particleIndex, p.m_transform.GetWorldMatrix());
-
-		if (p.IsDead(m_stopwatch->GetTotalSeconds()))
-		{
-			m_particles.erase(m_particles.begin() + particleIndex);
-			m_renderable->RemoveInstanceMatrix(particleIndex);
-		}
+		m_frameEmitterMatrix = transform.GetWorldMatrix();
 	}
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Spawns a single particle, given the emitter's current spawn state
+// Spawns, moves and kills particles using the state from the last PrepareUpdate()
 //
-void ParticleEmitter::SpawnParticle()
+void ParticleEmitter::Simulate()
 {
-	Particle particle;
-	particle.m_velocity = m_spawnVelocityCallback();
-	particle.m_angularVelocity = m_spawnAngularVelocityCallback();
-	particle.m_mass = 1.0f;
+	SpawnParticles(m_frameSpawnCount, m_frameSpawnPosition, m_frameTotalSeconds);
+	m_frameSpawnCount = 0;
 
-	particle.m_force = m_force;
-	particle.m_torque = Vector3::ZERO;
+	m_particles.Integrate(m_force, m_frameDeltaSeconds);
+	m_particles.RemoveDead(m_frameTotalSeconds);
 
-	particle.m_timeCreated = m_stopwatch->GetTotalSeconds();
-	particle.m_timeToDestroy = particle.m_timeCreated + m_spawnLifetimeCallback();
-
-	particle.m_transform.Scale(m_spawnScaleCallback());
+	UpdateInstanceMatrices(m_frameEmitterMatrix);
+}
 
-	if (m_areParticlesParented)
-	{
-		particle.m_transform.SetParentTransform(&transform);
-	}
-	else
-	{
-		particle.m_transform.position = transform.position;
-	}
 
-	m_renderable->AddInstanceMatrix(particle.m_transform.GetWorldMatrix());
-	m_particles.push_back(particle);
+//-----------------------------------------------------------------------------------------------
+// Spawns a single particle, given the emitter's current spawn state
+//
+void ParticleEmitter::SpawnParticle()
+{
+	SpawnBurst(1);
 }
 
 
@@ -122,7 +114,7 @@ void ParticleEmitter::SpawnParticle()
 //
 void ParticleEmitter::SpawnBurst()
 {
-	int spawnCount = m_burstRange.GetRandomInRange();
+	int spawnCount = m_randomStream.GetRandomIntInRange(m_burstRange.min, m_burstRange.max);
 	SpawnBurst(spawnCount);
 }
 
@@ -132,10 +124,8 @@ void ParticleEmitter::SpawnBurst()
 //
 void ParticleEmitter::SpawnBurst(unsigned int numToSpawn)
 {
-	for (int particleIndex = 0; particleIndex < (int) numToSpawn; ++particleIndex)
-	{
-		SpawnParticle();
-	}
+	SpawnParticles((int)numToSpawn, GetSpawnPosition(), m_stopwatch->GetTotalSeconds());
+	UpdateInstanceMatrices(m_areParticlesParented ? transform.GetWorldMatrix() : Matrix44::IDENTITY);
 }
 
 
@@ -188,6 +178,25 @@ void ParticleEmitter::SetParticlesParented(bool shouldParent)
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Restarts this emitter's random sequence from the given seed
+// Emitters given the same seed still differ, since each keeps its own stream ID
+//
+void ParticleEmitter::SetSeed(uint64_t seed)
+{
+	m_randomStream.SetSeed(seed, m_streamID);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Sets the distributions used to initialize spawned particles
+//
+void ParticleEmitter::SetSpawnParams(const ParticleSpawnParams_t& params)
+{
+	m_spawnParams = params;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Sets the spawn velocity callback function to the one specified
 //
@@ -238,12 +247,12 @@ bool ParticleEmitter::IsFinished() const
 //
 int ParticleEmitter::GetParticleCount() const
 {
-	return (int) m_particles.size();
+	return m_particles.GetCount();
 }
 
 
 //-----------------------------------------------------------------------------------------------
-// Returns the number of particles currently spawned on the emitter
+// Returns the renderable the particles are drawn with
 //
 Renderable* ParticleEmitter::GetRenderable() const
 {
@@ -251,6 +260,77 @@ Renderable* ParticleEmitter::GetRenderable() const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns true if any spawn callback is set, in which case the emitter can't be simulated off the main thread
+//
+bool ParticleEmitter::UsesSpawnCallbacks() const
+{
+	return (m_spawnVelocityCallback != nullptr || m_spawnAngularVelocityCallback != nullptr
+		|| m_spawnLifetimeCallback != nullptr || m_spawnScaleCallback != nullptr);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the distributions used to initialize spawned particles
+//
+const ParticleSpawnParams_t& ParticleEmitter::GetSpawnParams() const
+{
+	return m_spawnParams;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds particles to the store without touching the renderable
+// Without callbacks the whole batch is sampled from the spawn params, otherwise each particle is built
+// one at a time with the callbacks filling in the attributes they're set for
+//
+void ParticleEmitter::SpawnParticles(int numToSpawn, const Vector3& spawnPosition, float timeCreated)
+{
+	if (!UsesSpawnCallbacks())
+	{
+		m_particles.AddBatch(numToSpawn, spawnPosition, timeCreated, m_spawnParams, m_randomStream);
+		return;
+	}
+
+	for (int spawnIndex = 0; spawnIndex < numToSpawn; ++spawnIndex)
+	{
+		Vector3 velocity = (m_spawnVelocityCallback != nullptr ? m_spawnVelocityCallback() : m_spawnParams.velocity.Sample(m_randomStream));
+		Vector3 angularVelocity = (m_spawnAngularVelocityCallback != nullptr ? m_spawnAngularVelocityCallback() : m_spawnParams.angularVelocity.Sample(m_randomStream));
+		Vector3 scale = (m_spawnScaleCallback != nullptr ? m_spawnScaleCallback() : m_spawnParams.scale.Sample(m_randomStream));
+		float lifetime = (m_spawnLifetimeCallback != nullptr ? m_spawnLifetimeCallback() : m_randomStream.GetRandomFloatInRange(m_spawnParams.lifetime.min, m_spawnParams.lifetime.max));
+
+		m_particles.Add(spawnPosition, velocity, angularVelocity, scale, timeCreated, lifetime);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Writes every particle's matrix directly into the renderable's instance buffer
+// The emitter matrix is only used if the particles are parented
+//
+void ParticleEmitter::UpdateInstanceMatrices(const Matrix44& emitterMatrix)
+{
+	int particleCount = m_particles.GetCount();
+	m_renderable->SetInstanceCount(particleCount);
+
+	if (particleCount == 0)
+	{
+		return;
+	}
+
+	m_particles.WriteModelMatrices(m_renderable->GetInstanceMatrixData(), (m_areParticlesParented ? &emitterMatrix : nullptr));
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parented particles spawn at the origin of the emitter's space, others at the emitter's position
+//
+Vector3 ParticleEmitter::GetSpawnPosition() const
+{
+	return (m_areParticlesParented ? Vector3::ZERO : transform.GetPosition());
+}
+
+
 //---------- Default Spawn Callbacks ----------
 
 //-----------------------------------------------------------------------------------------------
@@ -7,7 +7,11 @@
 #pragma once
 #include <vector>
 #include "Engine/Math/IntRange.hpp"
-#include "Engine/Rendering/Particles/Particle.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Transform.hpp"
+#include "Engine/Math/RandomStream.hpp"
+#include "Engine/Rendering/Particles/ParticleStore.hpp"
+#include "Engine/Rendering/Particles/ParticleSpawnParams.hpp"
 
 class Clock;
 class Stopwatch;
@@ -19,7 +23,7 @@ typedef Vector3 (*SpawnAngularVelocity_cb)();
 typedef Vector3 (*SpawnScale_cb)();
 typedef float (*SpawnLifetime_cb)();
 
-// Default callbacks, in case one isn't set explicitly
+// Default callbacks, matching the default spawn params
 Vector3 DefaultSpawnVelocity();
 Vector3 DefaultSpawnAngularVelocity();
 float	DefaultSpawnLifetime();
@@ -37,7 +41,12 @@ public:
 	void SetTransform(const Vector3& position, const Vector3& rotation, const Vector3& scale);
 	void SetRenderable(Renderable* renderable);
 
+	// Update() is PrepareUpdate() followed by Simulate()
+	// PrepareUpdate() reads the clock and transform so must be on the main thread, Simulate() only touches
+	// this emitter's own data and can run on any thread, as long as no callbacks are set
 	void Update();
+	void PrepareUpdate();
+	void Simulate();
 	
 	// Spawning
 	void SpawnParticle();
@@ -49,8 +58,11 @@ public:
 
 	void SetKillWhenDone(bool killWhenDone);
 	void SetParticlesParented(bool shouldParent);
+	void SetSeed(uint64_t seed);
+	void SetSpawnParams(const ParticleSpawnParams_t& params);
 
-	// Setting callbacks used when particles are spawned
+	// Setting callbacks used when particles are spawned, overriding the spawn params for that attribute
+	// Pass nullptr to go back to the spawn params
 	void SetSpawnVelocityFunction(SpawnVelocity_cb callback);
 	void SetSpawnAngularVelocityFunction(SpawnAngularVelocity_cb callback);
 	void SetSpawnLifetimeFunction(SpawnLifetime_cb callback);
@@ -60,6 +72,16 @@ public:
 	bool IsFinished() const;
 	int GetParticleCount() const;
 	Renderable* GetRenderable() const;
+	bool UsesSpawnCallbacks() const;
+	const ParticleSpawnParams_t& GetSpawnParams() const;
+
+
+private:
+	//-----Private Methods-----
+
+	void	SpawnParticles(int numToSpawn, const Vector3& spawnPosition, float timeCreated);
+	void	UpdateInstanceMatrices(const Matrix44& emitterMatrix);
+	Vector3 GetSpawnPosition() const;
 
 
 public:
@@ -73,7 +95,7 @@ private:
 
 	Renderable* m_renderable;
 
-	std::vector<Particle> m_particles;
+	ParticleStore m_particles;
 
 	bool m_spawnsOverTime = false;
 	Stopwatch* m_stopwatch;
@@ -81,13 +103,28 @@ private:
 	bool m_killWhenDone = false;
 	IntRange m_burstRange;
 
-	Vector3 m_force = Vector3(0.f, -9.8f, 0.f);
+	Vector3 m_force = Vector3(0.f, -9.8f, 0.f);	// Particles have unit mass, so this is also their acceleration
 
 	bool m_areParticlesParented = false;
 
-	// Callbacks for spawning
-	SpawnVelocity_cb m_spawnVelocityCallback = DefaultSpawnVelocity;
-	SpawnAngularVelocity_cb m_spawnAngularVelocityCallback = DefaultSpawnAngularVelocity;
-	SpawnLifetime_cb m_spawnLifetimeCallback = DefaultSpawnLifetime;
-	SpawnScale_cb m_spawnScaleCallback = DefaultSpawnScale;
+	// Each emitter draws from its own stream, so results don't depend on update order or thread
+	RandomStream m_randomStream;
+	uint64_t m_streamID = 0;
+	ParticleSpawnParams_t m_spawnParams;
+
+	// Callbacks for spawning, null unless set
+	SpawnVelocity_cb m_spawnVelocityCallback = nullptr;
+	SpawnAngularVelocity_cb m_spawnAngularVelocityCallback = nullptr;
+	SpawnLifetime_cb m_spawnLifetimeCallback = nullptr;
+	SpawnScale_cb m_spawnScaleCallback = nullptr;
+
+	// State captured in PrepareUpdate() for Simulate() to use
+	int m_frameSpawnCount = 0;
+	float m_frameDeltaSeconds = 0.f;
+	float m_frameTotalSeconds = 0.f;
+	Vector3 m_frameSpawnPosition;
+	Matrix44 m_frameEmitterMatrix;
+
+	static uint64_t s_emittersCreated;
+	static constexpr uint64_t DEFAULT_SEED = 0x853c49e6748fea9bULL;
 };
@@ -0,0 +1,103 @@
+/************************************************************************/
+/* File: ParticleSpawnParams.cpp
+/* Author: Andrew Chase
+/* Date: June 6th, 2019
+/* Description: Implementation of the spawn distribution sampling
+/************************************************************************/
+#include "Engine/Math/RandomStream.hpp"
+#include "Engine/Rendering/Particles/ParticleSpawnParams.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Makes a distribution that always returns the given value
+//
+SpawnDistribution_t SpawnDistribution_t::MakeConstant(const Vector3& value)
+{
+	SpawnDistribution_t distribution;
+	distribution.type = SPAWN_DISTRIBUTION_CONSTANT;
+	distribution.mins = value;
+	distribution.maxs = value;
+
+	return distribution;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Makes a distribution that picks each component within the bounds
+//
+SpawnDistribution_t SpawnDistribution_t::MakeBox(const Vector3& mins, const Vector3& maxs)
+{
+	SpawnDistribution_t distribution;
+	distribution.type = SPAWN_DISTRIBUTION_BOX;
+	distribution.mins = mins;
+	distribution.maxs = maxs;
+
+	return distribution;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Makes a distribution that picks a random direction with a length in the range
+//
+SpawnDistribution_t SpawnDistribution_t::MakeSphere(float minMagnitude, float maxMagnitude)
+{
+	SpawnDistribution_t distribution;
+	distribution.type = SPAWN_DISTRIBUTION_SPHERE;
+	distribution.magnitude = FloatRange(minMagnitude, maxMagnitude);
+
+	return distribution;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a single value from the distribution
+//
+Vector3 SpawnDistribution_t::Sample(RandomStream& randomStream) const
+{
+	switch (type)
+	{
+	case SPAWN_DISTRIBUTION_BOX:
+		return randomStream.GetRandomPointInBox(mins, maxs);
+		break;
+	case SPAWN_DISTRIBUTION_SPHERE:
+	{
+		// Separate statements so the draw order, and so the sequence, doesn't depend on the compiler
+		Vector3 direction = randomStream.GetRandomPointOnSphere();
+		float length = randomStream.GetRandomFloatInRange(magnitude.min, magnitude.max);
+
+		return direction * length;
+	}
+		break;
+	case SPAWN_DISTRIBUTION_CONSTANT:
+	default:
+		return mins;
+		break;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Writes count values into the component arrays
+// Constant and box distributions fill one whole component array at a time
+//
+void SpawnDistribution_t::SampleInto(float* out_xs, float* out_ys, float* out_zs, int count, RandomStream& randomStream) const
+{
+	if (type == SPAWN_DISTRIBUTION_SPHERE)
+	{
+		for (int valueIndex = 0; valueIndex < count; ++valueIndex)
+		{
+			Vector3 value = Sample(randomStream);
+
+			out_xs[valueIndex] = value.x;
+			out_ys[valueIndex] = value.y;
+			out_zs[valueIndex] = value.z;
+		}
+
+		return;
+	}
+
+	// Constant distributions have mins == maxs, which the fill handles without drawing any numbers
+	randomStream.FillFloatsInRange(out_xs, count, mins.x, maxs.x);
+	randomStream.FillFloatsInRange(out_ys, count, mins.y, maxs.y);
+	randomStream.FillFloatsInRange(out_zs, count, mins.z, maxs.z);
+}
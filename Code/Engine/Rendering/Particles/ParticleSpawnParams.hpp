@@ -0,0 +1,45 @@
+/************************************************************************/
+/* File: ParticleSpawnParams.hpp
+/* Author: Andrew Chase
+/* Date: June 6th, 2019
+/* Description: Declarative description of how an emitter's particles
+/*				are initialized, sampled in batches from a RandomStream
+/************************************************************************/
+#pragma once
+#include "Engine/Math/Vector3.hpp"
+#include "Engine/Math/FloatRange.hpp"
+
+class RandomStream;
+
+enum SpawnDistributionType
+{
+	SPAWN_DISTRIBUTION_CONSTANT,	// Always mins
+	SPAWN_DISTRIBUTION_BOX,			// Each component picked independently between mins and maxs
+	SPAWN_DISTRIBUTION_SPHERE		// Random direction, with a length picked from the magnitude range
+};
+
+
+struct SpawnDistribution_t
+{
+	static SpawnDistribution_t MakeConstant(const Vector3& value);
+	static SpawnDistribution_t MakeBox(const Vector3& mins, const Vector3& maxs);
+	static SpawnDistribution_t MakeSphere(float minMagnitude, float maxMagnitude);
+
+	Vector3 Sample(RandomStream& randomStream) const;
+	void	SampleInto(float* out_xs, float* out_ys, float* out_zs, int count, RandomStream& randomStream) const;
+
+	SpawnDistributionType	type = SPAWN_DISTRIBUTION_CONSTANT;
+	Vector3					mins = Vector3(0.f, 0.f, 0.f);
+	Vector3					maxs = Vector3(0.f, 0.f, 0.f);
+	FloatRange				magnitude;
+};
+
+
+// Defaults match the default spawn callbacks - stationary, unit scale, living one second
+struct ParticleSpawnParams_t
+{
+	SpawnDistribution_t velocity;
+	SpawnDistribution_t angularVelocity;
+	SpawnDistribution_t scale = SpawnDistribution_t::MakeConstant(Vector3(1.f, 1.f, 1.f));
+	FloatRange			lifetime = FloatRange(1.f);
+};
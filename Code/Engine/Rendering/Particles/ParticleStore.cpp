@@ -0,0 +1,283 @@
+/************************************************************************/
+/* File: ParticleStore.cpp
+/* Author: Andrew Chase
+/* Date: June 5th, 2019
+/* Description: Implementation of the ParticleStore class
+/************************************************************************/
+#include <xmmintrin.h>
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/RandomStream.hpp"
+#include "Engine/Rendering/Particles/ParticleSpawnParams.hpp"
+#include "Engine/Rendering/Particles/ParticleStore.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Moves the last element into the index and shrinks the array by one
+//
+template <typename T>
+static void SwapRemove(std::vector<T>& values, int index)
+{
+	values[index] = values.back();
+	values.pop_back();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Forward euler for one component of all particles, four at a time
+// Velocity is updated first and the new velocity is used to move, same as the old per-particle update
+//
+static void IntegrateComponent(float* positions, float* velocities, float acceleration, float deltaTime, int count)
+{
+	float velocityChange = acceleration * deltaTime;
+
+	__m128 velocityChange4 = _mm_set1_ps(velocityChange);
+	__m128 deltaTime4 = _mm_set1_ps(deltaTime);
+
+	int index = 0;
+	for (; index + 4 <= count; index += 4)
+	{
+		__m128 velocity4 = _mm_add_ps(_mm_loadu_ps(velocities + index), velocityChange4);
+		__m128 position4 = _mm_add_ps(_mm_loadu_ps(positions + index), _mm_mul_ps(velocity4, deltaTime4));
+
+		_mm_storeu_ps(velocities + index, velocity4);
+		_mm_storeu_ps(positions + index, position4);
+	}
+
+	// Remainder that doesn't fill a register
+	for (; index < count; ++index)
+	{
+		velocities[index] += velocityChange;
+		positions[index] += velocities[index] * deltaTime;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds a particle to the end of the store
+//
+void ParticleStore::Add(const Vector3& position, const Vector3& velocity, const Vector3& angularVelocity, const Vector3& scale, float timeCreated, float lifetime)
+{
+	m_positionsX.push_back(position.x);
+	m_positionsY.push_back(position.y);
+	m_positionsZ.push_back(position.z);
+
+	m_velocitiesX.push_back(velocity.x);
+	m_velocitiesY.push_back(velocity.y);
+	m_velocitiesZ.push_back(velocity.z);
+
+	m_rotationsX.push_back(0.f);
+	m_rotationsY.push_back(0.f);
+	m_rotationsZ.push_back(0.f);
+
+	m_angularVelocitiesX.push_back(angularVelocity.x);
+	m_angularVelocitiesY.push_back(angularVelocity.y);
+	m_angularVelocitiesZ.push_back(angularVelocity.z);
+
+	m_scales.push_back(scale);
+
+	m_timesCreated.push_back(timeCreated);
+	m_timesToDestroy.push_back(timeCreated + lifetime);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds count particles at the position, sampling their initial state from the spawn params
+// Each attribute is written one whole component array at a time
+//
+void ParticleStore::AddBatch(int count, const Vector3& position, float timeCreated, const ParticleSpawnParams_t& params, RandomStream& randomStream)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	int firstIndex = GetCount();
+	int newCount = firstIndex + count;
+
+	m_positionsX.resize(newCount, position.x);
+	m_positionsY.resize(newCount, position.y);
+	m_positionsZ.resize(newCount, position.z);
+
+	m_velocitiesX.resize(newCount);
+	m_velocitiesY.resize(newCount);
+	m_velocitiesZ.resize(newCount);
+	params.velocity.SampleInto(&m_velocitiesX[firstIndex], &m_velocitiesY[firstIndex], &m_velocitiesZ[firstIndex], count, randomStream);
+
+	m_rotationsX.resize(newCount, 0.f);
+	m_rotationsY.resize(newCount, 0.f);
+	m_rotationsZ.resize(newCount, 0.f);
+
+	m_angularVelocitiesX.resize(newCount);
+	m_angularVelocitiesY.resize(newCount);
+	m_angularVelocitiesZ.resize(newCount);
+	params.angularVelocity.SampleInto(&m_angularVelocitiesX[firstIndex], &m_angularVelocitiesY[firstIndex], &m_angularVelocitiesZ[firstIndex], count, randomStream);
+
+	m_scales.resize(newCount);
+	for (int particleIndex = firstIndex; particleIndex < newCount; ++particleIndex)
+	{
+		m_scales[particleIndex] = params.scale.Sample(randomStream);
+	}
+
+	m_timesCreated.resize(newCount, timeCreated);
+
+	// Lifetimes go straight into the destroy times, then get offset by the spawn time
+	m_timesToDestroy.resize(newCount);
+	float* timesToDestroy = &m_timesToDestroy[firstIndex];
+	randomStream.FillFloatsInRange(timesToDestroy, count, params.lifetime.min, params.lifetime.max);
+
+	for (int particleIndex = 0; particleIndex < count; ++particleIndex)
+	{
+		timesToDestroy[particleIndex] += timeCreated;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes all particles, keeping the memory for reuse
+//
+void ParticleStore::Clear()
+{
+	m_positionsX.clear();
+	m_positionsY.clear();
+	m_positionsZ.clear();
+
+	m_velocitiesX.clear();
+	m_velocitiesY.clear();
+	m_velocitiesZ.clear();
+
+	m_rotationsX.clear();
+	m_rotationsY.clear();
+	m_rotationsZ.clear();
+
+	m_angularVelocitiesX.clear();
+	m_angularVelocitiesY.clear();
+	m_angularVelocitiesZ.clear();
+
+	m_scales.clear();
+
+	m_timesCreated.clear();
+	m_timesToDestroy.clear();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Moves all particles forward in time, with the acceleration applied to all of them
+// Particles have no torque, so their angular velocity is constant
+//
+void ParticleStore::Integrate(const Vector3& acceleration, float deltaTime)
+{
+	int count = GetCount();
+
+	IntegrateComponent(m_positionsX.data(), m_velocitiesX.data(), acceleration.x, deltaTime, count);
+	IntegrateComponent(m_positionsY.data(), m_velocitiesY.data(), acceleration.y, deltaTime, count);
+	IntegrateComponent(m_positionsZ.data(), m_velocitiesZ.data(), acceleration.z, deltaTime, count);
+
+	IntegrateComponent(m_rotationsX.data(), m_angularVelocitiesX.data(), 0.f, deltaTime, count);
+	IntegrateComponent(m_rotationsY.data(), m_angularVelocitiesY.data(), 0.f, deltaTime, count);
+	IntegrateComponent(m_rotationsZ.data(), m_angularVelocitiesZ.data(), 0.f, deltaTime, count);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes all particles whose lifetime is over, returning the number removed
+// Removal swaps the last particle in, so particle order isn't preserved
+//
+int ParticleStore::RemoveDead(float currentTime)
+{
+	int removedCount = 0;
+	int particleIndex = 0;
+
+	while (particleIndex < GetCount())
+	{
+		if (currentTime >= m_timesToDestroy[particleIndex])
+		{
+			RemoveAt(particleIndex);
+			removedCount++;
+		}
+		else
+		{
+			particleIndex++;
+		}
+	}
+
+	return removedCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Writes the model matrix of every particle into the given buffer, which must fit GetCount() matrices
+// If a parent matrix is given the particles are treated as being in its space
+//
+void ParticleStore::WriteModelMatrices(Matrix44* out_matrices, const Matrix44* parentMatrix) const
+{
+	int count = GetCount();
+
+	for (int particleIndex = 0; particleIndex < count; ++particleIndex)
+	{
+		Vector3 position = Vector3(m_positionsX[particleIndex], m_positionsY[particleIndex], m_positionsZ[particleIndex]);
+		Vector3 rotation = Vector3(m_rotationsX[particleIndex], m_rotationsY[particleIndex], m_rotationsZ[particleIndex]);
+
+		out_matrices[particleIndex] = Matrix44::MakeModelMatrix(position, rotation, m_scales[particleIndex]);
+	}
+
+	if (parentMatrix != nullptr)
+	{
+		Matrix44::MultiplyMatrices(*parentMatrix, out_matrices, out_matrices, count);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of particles in the store
+//
+int ParticleStore::GetCount() const
+{
+	return (int)m_timesToDestroy.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the position of the particle at the given index, in the space it was spawned in
+//
+Vector3 ParticleStore::GetPosition(int particleIndex) const
+{
+	return Vector3(m_positionsX[particleIndex], m_positionsY[particleIndex], m_positionsZ[particleIndex]);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns a normalized parameter for time through the particle's life
+//
+float ParticleStore::GetNormalizedTime(int particleIndex, float currentTime) const
+{
+	float timeCreated = m_timesCreated[particleIndex];
+	return (currentTime - timeCreated) / (m_timesToDestroy[particleIndex] - timeCreated);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Removes the particle at the index by moving the last particle into its place
+//
+void ParticleStore::RemoveAt(int particleIndex)
+{
+	SwapRemove(m_positionsX, particleIndex);
+	SwapRemove(m_positionsY, particleIndex);
+	SwapRemove(m_positionsZ, particleIndex);
+
+	SwapRemove(m_velocitiesX, particleIndex);
+	SwapRemove(m_velocitiesY, particleIndex);
+	SwapRemove(m_velocitiesZ, particleIndex);
+
+	SwapRemove(m_rotationsX, particleIndex);
+	SwapRemove(m_rotationsY, particleIndex);
+	SwapRemove(m_rotationsZ, particleIndex);
+
+	SwapRemove(m_angularVelocitiesX, particleIndex);
+	SwapRemove(m_angularVelocitiesY, particleIndex);
+	SwapRemove(m_angularVelocitiesZ, particleIndex);
+
+	SwapRemove(m_scales, particleIndex);
+
+	SwapRemove(m_timesCreated, particleIndex);
+	SwapRemove(m_timesToDestroy, particleIndex);
+}
@@ -0,0 +1,66 @@
+/************************************************************************/
+/* File: ParticleStore.hpp
+/* Author: Andrew Chase
+/* Date: June 5th, 2019
+/* Description: Structure-of-arrays storage for all particles of an emitter
+/************************************************************************/
+#pragma once
+#include <vector>
+#include "Engine/Math/Vector3.hpp"
+
+class Matrix44;
+class RandomStream;
+struct ParticleSpawnParams_t;
+
+class ParticleStore
+{
+public:
+	//-----Public Methods-----
+
+	void	Add(const Vector3& position, const Vector3& velocity, const Vector3& angularVelocity, const Vector3& scale, float timeCreated, float lifetime);
+	void	AddBatch(int count, const Vector3& position, float timeCreated, const ParticleSpawnParams_t& params, RandomStream& randomStream);
+	void	Clear();
+
+	void	Integrate(const Vector3& acceleration, float deltaTime);
+	int		RemoveDead(float currentTime);
+	void	WriteModelMatrices(Matrix44* out_matrices, const Matrix44* parentMatrix) const;
+
+	int		GetCount() const;
+	Vector3	GetPosition(int particleIndex) const;
+	float	GetNormalizedTime(int particleIndex, float currentTime) const;
+
+
+private:
+	//-----Private Methods-----
+
+	void	RemoveAt(int particleIndex);
+
+
+private:
+	//-----Private Data-----
+
+	// Each component is its own array so it can be integrated four particles at a time
+	std::vector<float> m_positionsX;
+	std::vector<float> m_positionsY;
+	std::vector<float> m_positionsZ;
+
+	std::vector<float> m_velocitiesX;
+	std::vector<float> m_velocitiesY;
+	std::vector<float> m_velocitiesZ;
+
+	// Rotations are euler angles in degrees
+	std::vector<float> m_rotationsX;
+	std::vector<float> m_rotationsY;
+	std::vector<float> m_rotationsZ;
+
+	std::vector<float> m_angularVelocitiesX;
+	std::vector<float> m_angularVelocitiesY;
+	std::vector<float> m_angularVelocitiesZ;
+
+	// Only read when building matrices
+	std::vector<Vector3> m_scales;
+
+	std::vector<float> m_timesCreated;
+	std::vector<float> m_timesToDestroy;
+
+};
@@ -0,0 +1,165 @@
+/************************************************************************/
+/* File: ParticleSystem.cpp
+/* Author: Andrew Chase
+/* Date: June 6th, 2019
+/* Description: Implementation of the ParticleSystem class
+/************************************************************************/
+#include "Engine/Core/JobSystem/Job.hpp"
+#include "Engine/Core/JobSystem/JobSystem.hpp"
+#include "Engine/Rendering/Particles/ParticleSystem.hpp"
+#include "Engine/Rendering/Particles/ParticleEmitter.hpp"
+
+
+//-----------------------------------------------------------------------------------------------
+// Job for simulating a group of emitters on a worker thread
+//
+class ParticleSimulateJob : public Job
+{
+public:
+
+	ParticleSimulateJob()
+	{
+		m_jobType = JOB_TYPE_PARTICLE_UPDATE;
+		m_jobFlags = WORKER_FLAGS_ALL_BUT_DISK;
+	}
+
+	virtual void Execute() override
+	{
+		for (int emitterIndex = 0; emitterIndex < (int)m_emitters.size(); ++emitterIndex)
+		{
+			m_emitters[emitterIndex]->Simulate();
+		}
+	}
+
+	std::vector<ParticleEmitter*> m_emitters;
+
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Adds the emitter to be updated each frame
+//
+void ParticleSystem::AddEmitter(ParticleEmitter* emitter)
+{
+	m_emitters.push_back(emitter);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Stops updating the emitter, does not delete it
+//
+void ParticleSystem::RemoveEmitter(ParticleEmitter* emitter)
+{
+	for (int emitterIndex = 0; emitterIndex < (int)m_emitters.size(); ++emitterIndex)
+	{
+		if (m_emitters[emitterIndex] == emitter)
+		{
+			m_emitters.erase(m_emitters.begin() + emitterIndex);
+			return;
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Updates all emitters, returning once they're all done
+// Emitters with spawn callbacks are simulated on this thread while the rest run as jobs, since the
+// callbacks may not be safe to call from other threads
+//
+void ParticleSystem::Update()
+{
+	// Clock and transform reads all happen here, before any emitter is simulated
+	for (int emitterIndex = 0; emitterIndex < (int)m_emitters.size(); ++emitterIndex)
+	{
+		m_emitters[emitterIndex]->PrepareUpdate();
+	}
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	bool useJobs = (jobSystem != nullptr && jobSystem->GetWorkerThreadCount(WORKER_FLAGS_ALL_BUT_DISK) > 0);
+
+	if (useJobs)
+	{
+		QueueSimulationJobs();
+	}
+
+	for (int emitterIndex = 0; emitterIndex < (int)m_emitters.size(); ++emitterIndex)
+	{
+		ParticleEmitter* emitter = m_emitters[emitterIndex];
+
+		if (!useJobs || emitter->UsesSpawnCallbacks())
+		{
+			emitter->Simulate();
+		}
+	}
+
+	if (useJobs)
+	{
+		jobSystem->BlockUntilAllJobsOfTypeAreFinalized(JOB_TYPE_PARTICLE_UPDATE);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of emitters being updated
+//
+int ParticleSystem::GetEmitterCount() const
+{
+	return (int)m_emitters.size();
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the number of particles across all emitters
+//
+int ParticleSystem::GetParticleCount() const
+{
+	int particleCount = 0;
+
+	for (int emitterIndex = 0; emitterIndex < (int)m_emitters.size(); ++emitterIndex)
+	{
+		particleCount += m_emitters[emitterIndex]->GetParticleCount();
+	}
+
+	return particleCount;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Groups the emitters that can run off the main thread into jobs and queues them
+// Each emitter is in exactly one job, so no two threads touch the same emitter
+//
+void ParticleSystem::QueueSimulationJobs()
+{
+	ParticleSimulateJob* currentJob = nullptr;
+	int particlesInCurrentJob = 0;
+
+	for (int emitterIndex = 0; emitterIndex < (int)m_emitters.size(); ++emitterIndex)
+	{
+		ParticleEmitter* emitter = m_emitters[emitterIndex];
+
+		if (emitter->UsesSpawnCallbacks())
+		{
+			continue;
+		}
+
+		if (currentJob == nullptr)
+		{
+			currentJob = new ParticleSimulateJob();
+			particlesInCurrentJob = 0;
+		}
+
+		currentJob->m_emitters.push_back(emitter);
+		particlesInCurrentJob += emitter->GetParticleCount();
+
+		if (particlesInCurrentJob >= MIN_PARTICLES_PER_JOB)
+		{
+			QueueJob(currentJob);
+			currentJob = nullptr;
+		}
+	}
+
+	if (currentJob != nullptr)
+	{
+		QueueJob(currentJob);
+	}
+}
@@ -0,0 +1,43 @@
+/************************************************************************/
+/* File: ParticleSystem.hpp
+/* Author: Andrew Chase
+/* Date: June 6th, 2019
+/* Description: Updates a set of emitters each frame, simulating them on
+/*				the JobSystem's worker threads when there are any
+/************************************************************************/
+#pragma once
+#include <vector>
+
+class ParticleEmitter;
+
+class ParticleSystem
+{
+public:
+	//-----Public Methods-----
+
+	void	AddEmitter(ParticleEmitter* emitter);
+	void	RemoveEmitter(ParticleEmitter* emitter);
+
+	void	Update();
+
+	int		GetEmitterCount() const;
+	int		GetParticleCount() const;
+
+
+private:
+	//-----Private Methods-----
+
+	void	QueueSimulationJobs();
+
+
+private:
+	//-----Private Data-----
+
+	// Not owned, whoever added an emitter is responsible for deleting it
+	std::vector<ParticleEmitter*> m_emitters;
+
+	// Small emitters are grouped into one job until it has at least this many particles, so the
+	// cost of queueing a job isn't more than the work in it
+	static constexpr int MIN_PARTICLES_PER_JOB = 1024;
+
+};
@@ -9,6 +9,7 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Utility/XmlUtilities.hpp"
 #include "Engine/Rendering/Resources/SpriteSheet.hpp"
+#include "Engine/Core/DeveloperConsole/DevConsole.hpp"
 
 // XML Format for a spritesheet
 // <spritesheet name="archer" texture="archer.png" layout="5,5"> // <--ROOT,  Layout currently not used with individual sprites
@@ -127,7 +128,7 @@ SpriteSheet* SpriteSheet::LoadSpriteSheet(const std::string& filePath)
 {
 	// First get the general spritesheet information
 	XMLDocument document;
-	XMLError error = document.LoadFile(filePath.c_str());
+	XMLError error = LoadXmlDocument(document, filePath);
 	ASSERT_OR_DIE(error == tinyxml2::XML_SUCCESS, Stringf("Error: SpriteSheet::LoadSpriteSheet() couldn't load file \"%s\"", filePath.c_str()));
 
 	XMLElement* rootElement = document.RootElement();
@@ -161,7 +162,46 @@ SpriteSheet* SpriteSheet::LoadSpriteSheet(const std::string& filePath)
 
 
 //-----------------------------------------------------------------------------------------------
-// Parses the given sprite XML element and adds the sprite to the SpriteSheet
+// Re-parses the layout and sprites from the XML file, leaving the sheet as it was if it can't be loaded
+// The texture is held by reference so it can't be swapped here - the sheet has to be recreated for that
+// Sprites no longer in the file are kept, since something may still be holding them
+//
+bool SpriteSheet::ReloadFromFile(const std::string& xmlFilepath)
+{
+	XMLDocument document;
+	XMLError error = LoadXmlDocument(document, xmlFilepath);
+
+	if (error != tinyxml2::XML_SUCCESS)
+	{
+		ConsoleErrorf("SpriteSheet::ReloadFromFile() couldn't load file \"%s\"", xmlFilepath.c_str());
+		return false;
+	}
+
+	XMLElement* rootElement = document.RootElement();
+
+	std::string textureName = ParseXmlAttribute(*rootElement, "texture");
+	if (AssetDB::GetTexture(textureName) != &m_texture)
+	{
+		ConsoleWarningf("SpriteSheet \"%s\" changed its texture to \"%s\", which only takes effect on restart", xmlFilepath.c_str(), textureName.c_str());
+	}
+
+	m_spriteLayout = ParseXmlAttribute(*rootElement, "layout", IntVector2(1, 1));
+
+	XMLElement* spriteElement = rootElement->FirstChildElement();
+
+	while (spriteElement != nullptr)
+	{
+		ParseSprite(*spriteElement);
+		spriteElement = spriteElement->NextSiblingElement();
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses the given sprite XML element and adds the sprite to the SpriteSheet, or updates the
+// sprite of the same name if there already is one
 //
 void SpriteSheet::ParseSprite(const XMLElement& element)
 {
@@ -232,7 +272,18 @@ void SpriteSheet::ParseSprite(const XMLElement& element)
 		uvs.maxs.y = temp;
 	}
 
-	// Create the sprite
-	Sprite* sprite = new Sprite(spriteName, m_texture, uvs, pivot, spriteDimensions);
-	m_sprites[spriteName] = sprite;
+	// Create the sprite, or update it in place on a reload
+	std::map<std::string, Sprite*>::iterator itr = m_sprites.find(spriteName);
+
+	if (itr != m_sprites.end())
+	{
+		itr->second->m_uvs = uvs;
+		itr->second->m_pivot = pivot;
+		itr->second->m_dimensions = spriteDimensions;
+	}
+	else
+	{
+		Sprite* sprite = new Sprite(spriteName, m_texture, uvs, pivot, spriteDimensions);
+		m_sprites[spriteName] = sprite;
+	}
 }
@@ -29,6 +29,7 @@ public:
 	const Texture& GetTexture() const;											// Returns a reference to the texture this sprite sheet comprises
 
 	static SpriteSheet* LoadSpriteSheet(const std::string& xmlFilepath);
+	bool				ReloadFromFile(const std::string& xmlFilepath);		// Updates the sprites in place, so Sprite pointers stay valid
 
 
 private:
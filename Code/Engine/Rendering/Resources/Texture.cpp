@@ -14,6 +14,7 @@
 #include "Engine/Assets/AssetDB.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/CompressedImage.hpp"
 #include "Engine/Rendering/Resources/Texture.hpp"
 #include "Engine/Rendering/OpenGL/glFunctions.hpp"
 
@@ -34,11 +35,19 @@
 // |-------------------------|-------------------------|-------------------------|-------------------------| //
 // |D24S8 (Depth24/Stencil8) |   GL_DEPTH24_STENCIL8   |     GL_DEPTH_STENCIL    |   GL_UNSIGNED_INT_24_8  | //
 // |-------------------------|-------------------------|-------------------------|-------------------------| //
+// |   BC1 (DXT1, opaque)    |GL_COMPRESSED_RGB_S3TC_  |         GL_RGB          |     GL_UNSIGNED_BYTE    | //
+// |                         |        DXT1_EXT         |                         |                         | //
+// |-------------------------|-------------------------|-------------------------|-------------------------| //
+// |   BC3 (DXT5, alpha)     |GL_COMPRESSED_RGBA_S3TC_ |         GL_RGBA         |     GL_UNSIGNED_BYTE    | //
+// |                         |        DXT5_EXT         |                         |                         | //
+// |-------------------------|-------------------------|-------------------------|-------------------------| //
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
 // C Functions
 unsigned int CalculateMipLevelCount(const IntVector2& dimensions);
+unsigned int GetBytesPerTexel(TextureFormat format);
+size_t GetMipLevelSize(TextureFormat format, const IntVector2& dimensions);
 
 
 //-----------------------------------------------------------------------------------------------
@@ -49,6 +58,7 @@ Texture::Texture()
 	, m_dimensions(0, 0)
 	, m_textureFormat(TEXTURE_FORMAT_RGBA8)
 	, m_textureType(TEXTURE_TYPE_2D)
+	, m_isUsingMipMaps(false)
 {
 }
 
@@ -62,26 +72,96 @@ Texture::~Texture()
 }
 
 //-----------------------------------------------------------------------------------------------
-// Loads the image from file
+// Loads the image from file, uncompressed
 //
 bool Texture::CreateFromFile(const std::string& filename, bool useMipMaps /*= false*/)
 {
-	Image* loadedImage = AssetDB::CreateOrGetImage(filename);
+	return CreateFromFile(filename, useMipMaps, false);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Loads the image from file, through the compressed cache if useCompressedCache is set
+//
+bool Texture::CreateFromFile(const std::string& filename, bool useMipMaps, bool useCompressedCache)
+{
+	// Only needed for the upload, the AssetDB keeps its own copy if one was asked for
+	Image* loadedImage = nullptr;
+	CompressedImage* compressedImage = nullptr;
+
+	if (!LoadFileForUpload(filename, useMipMaps, useCompressedCache, loadedImage, compressedImage))
+	{
+		return false;
+	}
+
+	if (compressedImage != nullptr)
+	{
+		CreateFromCompressedImage(compressedImage, useMipMaps);
+		delete compressedImage;
+	}
+	else
+	{
+		CreateFromImage(loadedImage, useMipMaps);
+		delete loadedImage;
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Reads the file into whatever form it will be uploaded in - the cached compressed copy if there
+// is one, otherwise the decoded image, compressed and cached first if it can be
+//
+bool Texture::LoadFileForUpload(const std::string& filename, bool useMipMaps, bool useCompressedCache, Image*& out_image, CompressedImage*& out_compressedImage)
+{
+	out_image = nullptr;
+	out_compressedImage = nullptr;
+
+	if (useCompressedCache)
+	{
+		CompressedImage* cachedImage = new CompressedImage();
 
-	if (loadedImage == nullptr)
+		if (cachedImage->LoadFromCache(filename, useMipMaps))
+		{
+			out_compressedImage = cachedImage;
+			return true;
+		}
+
+		delete cachedImage;
+	}
+
+	Image* loadedImage = new Image();
+
+	if (!loadedImage->LoadFromFile(filename))
 	{
+		delete loadedImage;
 		return false;
 	}
 
-	// Flip the image so it isn't upsidedown
-	if (!loadedImage->IsFlippedForTextures())
+	// Flip the image so it isn't upsidedown, and get it ready to upload as is
+	loadedImage->FlipVertical();
+	loadedImage->ConvertToRGBA();
+
+	if (useMipMaps)
 	{
-		loadedImage->FlipVertical();
+		loadedImage->GenerateMipChain();
 	}
 
-	// Construct the Texture from the image
-	CreateFromImage(loadedImage, useMipMaps);
+	// Only the first load of this source pays for the compression
+	if (useCompressedCache && CompressedImage::CanCompress(*loadedImage))
+	{
+		CompressedImage* compressedImage = new CompressedImage();
+		compressedImage->CreateFromImage(*loadedImage);
+		compressedImage->SaveToCache(filename, useMipMaps);
+
+		delete loadedImage;
+		out_compressedImage = compressedImage;
 
+		return true;
+	}
+
+	out_image = loadedImage;
 	return true;
 }
 
@@ -91,7 +171,101 @@ bool Texture::CreateFromFile(const std::string& filename, bool useMipMaps /*= fa
 //
 void Texture::CreateFromImage(const Image* image, bool useMipMaps /*= false*/)
 {
-	CreateFromRawData(image->GetTexelDimensions(), image->GetNumComponentsPerTexel(), image->GetImageData(), useMipMaps);
+	// Upload the image's own mips if it has them, rather than having the GPU generate them
+	if (useMipMaps && image->GetMipLevelCount() > 1)
+	{
+		CreateFromMipChain(image);
+	}
+	else
+	{
+		CreateFromRawData(image->GetTexelDimensions(), image->GetNumComponentsPerTexel(), image->GetImageData(), useMipMaps);
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Initializes the texture with every level of the image's mip chain
+//
+void Texture::CreateFromMipChain(const Image* image)
+{
+	// Storage is immutable, so a refill needs a new texture object
+	if (m_textureHandle != NULL)
+	{
+		glDeleteTextures(1, &m_textureHandle);
+		m_textureHandle = NULL;
+	}
+
+	glGenTextures(1, &m_textureHandle);
+	GL_CHECK_ERROR();
+
+	m_dimensions = image->GetTexelDimensions();
+	m_textureFormat = static_cast<TextureFormat>(image->GetNumComponentsPerTexel() - 1);
+	m_isUsingMipMaps = true;
+
+	unsigned int numMipLevels = (unsigned int) image->GetMipLevelCount();
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, m_textureHandle);
+
+	glTexStorage2D(GL_TEXTURE_2D, numMipLevels, ToGLInternalFormat(m_textureFormat), m_dimensions.x, m_dimensions.y);
+	GL_CHECK_ERROR();
+
+	// Rows are tightly packed, which small RGB levels aren't aligned to
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	for (unsigned int mipLevel = 0; mipLevel < numMipLevels; ++mipLevel)
+	{
+		const Image* mip = image->GetMipLevel(mipLevel);
+		IntVector2 mipDimensions = mip->GetTexelDimensions();
+
+		glTexSubImage2D(GL_TEXTURE_2D, mipLevel, 0, 0, mipDimensions.x, mipDimensions.y,
+			ToGLChannel(m_textureFormat), ToGLPixelLayout(m_textureFormat), mip->GetImageData());
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	GL_CHECK_ERROR();
+
+	glBindTexture(GL_TEXTURE_2D, NULL);
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Initializes the texture with the image's blocks, which the GPU samples as they are
+//
+void Texture::CreateFromCompressedImage(const CompressedImage* image, bool useMipMaps /*= false*/)
+{
+	if (m_textureHandle != NULL)
+	{
+		glDeleteTextures(1, &m_textureHandle);
+		m_textureHandle = NULL;
+	}
+
+	glGenTextures(1, &m_textureHandle);
+	GL_CHECK_ERROR();
+
+	unsigned int numMipLevels = (useMipMaps ? (unsigned int) image->GetMipLevelCount() : 1);
+
+	m_dimensions = image->GetMipDimensions(0);
+	m_textureFormat = (image->GetFormat() == BLOCK_FORMAT_BC3 ? TEXTURE_FORMAT_BC3 : TEXTURE_FORMAT_BC1);
+	m_isUsingMipMaps = (numMipLevels > 1);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, m_textureHandle);
+
+	glTexStorage2D(GL_TEXTURE_2D, numMipLevels, ToGLInternalFormat(m_textureFormat), m_dimensions.x, m_dimensions.y);
+	GL_CHECK_ERROR();
+
+	for (unsigned int mipLevel = 0; mipLevel < numMipLevels; ++mipLevel)
+	{
+		IntVector2 mipDimensions = image->GetMipDimensions(mipLevel);
+
+		glCompressedTexSubImage2D(GL_TEXTURE_2D, mipLevel, 0, 0, mipDimensions.x, mipDimensions.y,
+			ToGLInternalFormat(m_textureFormat), (GLsizei) image->GetMipSize(mipLevel), image->GetMipData(mipLevel));
+	}
+
+	GL_CHECK_ERROR();
+
+	glBindTexture(GL_TEXTURE_2D, NULL);
 }
 
 
@@ -100,14 +274,19 @@ void Texture::CreateFromImage(const Image* image, bool useMipMaps /*= false*/)
 //
 void Texture::CreateFromRawData(const IntVector2& dimensions, unsigned int numComponents, const unsigned char* imageData, bool useMipMaps)
 {
-	if (m_textureHandle == NULL)
+	// glTexStorage2D() storage can't be reallocated, so refilling a texture (e.g. an async load's placeholder) needs a new one
+	if (m_textureHandle != NULL)
 	{
-		glGenTextures(1, &m_textureHandle);
-		GL_CHECK_ERROR();
+		glDeleteTextures(1, &m_textureHandle);
+		m_textureHandle = NULL;
 	}
 
+	glGenTextures(1, &m_textureHandle);
+	GL_CHECK_ERROR();
+
 	m_dimensions = dimensions;
 	m_textureFormat = static_cast<TextureFormat>(numComponents - 1);
+	m_isUsingMipMaps = useMipMaps;
 
 	// Use texture slot 0 for the operation
 	glActiveTexture(GL_TEXTURE0);
@@ -207,6 +386,39 @@ TextureType Texture::GetTextureType() const
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Returns roughly how much video memory the texture uses, including its mip chain
+// Cube maps are laid out as a 4x3 grid of faces in m_dimensions, so only half the area is stored
+//
+size_t Texture::GetGPUMemorySize() const
+{
+	if (m_textureHandle == NULL)
+	{
+		return 0;
+	}
+
+	if (m_textureType == TEXTURE_TYPE_CUBE_MAP)
+	{
+		size_t tileSize = (size_t)(m_dimensions.x / 4);
+		return tileSize * tileSize * 6 * GetBytesPerTexel(m_textureFormat);
+	}
+
+	unsigned int numMipLevels = (m_isUsingMipMaps ? CalculateMipLevelCount(m_dimensions) : 1);
+	IntVector2 mipDimensions = m_dimensions;
+	size_t totalBytes = 0;
+
+	for (unsigned int mipLevel = 0; mipLevel < numMipLevels; ++mipLevel)
+	{
+		totalBytes += GetMipLevelSize(m_textureFormat, mipDimensions);
+
+		mipDimensions.x = (mipDimensions.x > 1 ? mipDimensions.x / 2 : 1);
+		mipDimensions.y = (mipDimensions.y > 1 ? mipDimensions.y / 2 : 1);
+	}
+
+	return totalBytes;
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Creates a target object on the GPU, full of garbage data, used as an intermediate render target
 //
@@ -238,6 +450,7 @@ bool Texture::CreateRenderTarget(unsigned int width, unsigned int height, Textur
 	// Set members
 	m_dimensions = IntVector2((int)width, (int)height);  
 	m_textureFormat = format; 
+	m_isUsingMipMaps = false;
 
 	return true; 
 }
@@ -296,4 +509,37 @@ unsigned int CalculateMipLevelCount(const IntVector2& dimensions)
 	int levelCount = Ceiling(log);
 
 	return (unsigned int) levelCount;
-}
\ No newline at end of file
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the bytes each texel takes on the GPU, RGB8 counts as 4 since drivers pad it out
+//
+unsigned int GetBytesPerTexel(TextureFormat format)
+{
+	switch (format)
+	{
+	case TEXTURE_FORMAT_R8:		return 1;
+	case TEXTURE_FORMAT_RG8:	return 2;
+	case TEXTURE_FORMAT_RGB8:	return 4;
+	case TEXTURE_FORMAT_RGBA8:	return 4;
+	case TEXTURE_FORMAT_D24S8:	return 4;
+	default:
+		return 4;
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Returns the bytes one mip level of the given size takes on the GPU, in whole 4x4 blocks for compressed formats
+//
+size_t GetMipLevelSize(TextureFormat format, const IntVector2& dimensions)
+{
+	switch (format)
+	{
+	case TEXTURE_FORMAT_BC1:	return GetBlockCompressedSize(BLOCK_FORMAT_BC1, dimensions);
+	case TEXTURE_FORMAT_BC3:	return GetBlockCompressedSize(BLOCK_FORMAT_BC3, dimensions);
+	default:
+		return (size_t) dimensions.x * (size_t) dimensions.y * GetBytesPerTexel(format);
+	}
+}
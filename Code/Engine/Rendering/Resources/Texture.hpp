@@ -13,6 +13,7 @@
 #include "Engine/Rendering/OpenGL/glTypes.hpp"
 
 class Image;
+class CompressedImage;
 
 //---------------------------------------------------------------------------
 class Texture
@@ -25,14 +26,22 @@ public:
 
 	// Only the AssetDatabase can create textures for use other than render targets
 	virtual bool CreateFromFile(const std::string& filename, bool useMipMaps = false);
+	bool CreateFromFile(const std::string& filename, bool useMipMaps, bool useCompressedCache);
 	virtual void CreateFromImage(const Image* image, bool useMipMaps = false);
 	virtual void CreateFromRawData(const IntVector2& dimensions, unsigned int numComponents, const unsigned char* imageData, bool useMipMaps);
+	void CreateFromCompressedImage(const CompressedImage* image, bool useMipMaps = false);
+
+	// The CPU half of CreateFromFile(), safe off the main thread - sets one of the outputs, which the caller then owns
+	// With useCompressedCache the file is block compressed and cached next to its source on first load, which is lossy,
+	// so it's only for textures that opt in - not fonts, UI or normal maps where the artifacts show
+	static bool LoadFileForUpload(const std::string& filename, bool useMipMaps, bool useCompressedCache, Image*& out_image, CompressedImage*& out_compressedImage);
 	
 	void InitializeAsImageTexture(const IntVector2& dimensions);
 
 	IntVector2		GetDimensions() const;
 	unsigned int	GetHandle() const;
 	TextureType		GetTextureType() const;
+	size_t			GetGPUMemorySize() const;	// Estimate, drivers may pad
 
 	// Render target related
 	bool CreateRenderTarget(unsigned int width, unsigned int height, TextureFormat format);
@@ -41,6 +50,12 @@ public:
 	static bool CopyTexture(Texture* source, Texture* destination);
 
 
+protected:
+	//-----Protected Methods-----
+
+	void CreateFromMipChain(const Image* image);
+
+
 protected:
 	//-----Protected Data-----
 
@@ -51,15 +51,16 @@ bool TextureCube::CreateFromFile(const std::string& filename, bool useMipMaps /*
 {
 	UNUSED(useMipMaps);
 
-	Image* loadedImage = AssetDB::CreateOrGetImage(filename);
+	// Only needed for the upload, so it isn't kept in the AssetDB
+	Image loadedImage;
 
-	if (loadedImage == nullptr)
+	if (!loadedImage.LoadFromFile(filename))
 	{
 		return false;
 	}
 
 	// Construct the Texture from the image, never generate mip maps
-	CreateFromImage(loadedImage, false);
+	CreateFromImage(&loadedImage, false);
 
 	return true;
 }
@@ -43,11 +43,18 @@ bool ComputeShader::Initialize(const char* filename)
 {
 	GLuint shaderID = glCreateShader(GL_COMPUTE_SHADER);
 
-	// Get the shader source
-	size_t size;
-	char* src = (char*)FileReadToNewBuffer(filename, size);
+	// Get the shader source, which isn't null terminated when mapped
+	MappedFile file;
+	if (!file.Open(filename))
+	{
+		glDeleteShader(shaderID);
+		return false;
+	}
+
+	const char* src = file.GetData();
+	GLint srcLength = (GLint) file.GetSize();
 
-	glShaderSource(shaderID, 1, &src, NULL);
+	glShaderSource(shaderID, 1, &src, &srcLength);
 	glCompileShader(shaderID);
 
 	// Check compile status
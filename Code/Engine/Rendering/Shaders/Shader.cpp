@@ -26,7 +26,7 @@ Shader::Shader(const std::string& xmlfilepath)
 {
 	// Load the document
 	XMLDocument document;
-	XMLError error = document.LoadFile(xmlfilepath.c_str());
+	XMLError error = LoadXmlDocument(document, xmlfilepath);
 
 	if (error != tinyxml2::XML_SUCCESS)
 	{
@@ -35,15 +35,7 @@ Shader::Shader(const std::string& xmlfilepath)
 	}
 
 	// I keep a root around just because I like having a single root element
-	XMLElement* shaderElement = document.RootElement();
-
-	ParseProgram(*shaderElement);
-	ParseCullMode(*shaderElement);
-	ParseFillMode(*shaderElement);
-	ParseWindOrder(*shaderElement);
-	ParseDepthMode(*shaderElement);
-	ParseBlendMode(*shaderElement);
-	ParseLayerAndQueue(*shaderElement);
+	ParseShaderElement(*document.RootElement());
 }
 
 
@@ -84,8 +76,49 @@ Shader* Shader::Clone()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Reloads the render state, order and program from the XML file, leaving the shader as it was if
+// the file can't be loaded
+//
+bool Shader::ReloadFromFile(const std::string& xmlFilepath)
+{
+	XMLDocument document;
+	XMLError error = LoadXmlDocument(document, xmlFilepath);
+
+	if (error != tinyxml2::XML_SUCCESS)
+	{
+		ERROR_RECOVERABLE(Stringf("Error: Shader::ReloadFromFile couldn't load file \"%s\"", xmlFilepath.c_str()));
+		return false;
+	}
+
+	// Elements left out of the file mean the defaults, not whatever the last load had
+	m_renderState = RenderState();
+	m_layer = 0;
+	m_queue = SORTING_QUEUE_OPAQUE;
+
+	ParseShaderElement(*document.RootElement());
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Parses everything from the shader's root element
+//
+void Shader::ParseShaderElement(const XMLElement& shaderElement)
+{
+	ParseProgram(shaderElement);
+	ParseCullMode(shaderElement);
+	ParseFillMode(shaderElement);
+	ParseWindOrder(shaderElement);
+	ParseDepthMode(shaderElement);
+	ParseBlendMode(shaderElement);
+	ParseLayerAndQueue(shaderElement);
+}
+
+
 //-----------------------------------------------------------------------------------------------
 // Parses the shader xml element for the shader program parameters and assigns the program of this shader
+// A shader that already has a program recompiles it in place instead
 //
 void Shader::ParseProgram(const XMLElement& shaderElement)
 {
@@ -107,10 +140,12 @@ void Shader::ParseProgram(const XMLElement& shaderElement)
 
 			if (vsFilepath.size() > 0 && fsFilepath.size() > 0)
 			{
-				ShaderProgram* program = new ShaderProgram(programName);
-				program->LoadProgramFromFiles(vsFilepath.c_str(), fsFilepath.c_str());	// Will assign invalid program internally if compilation fails
+				if (m_shaderProgram == nullptr)
+				{
+					m_shaderProgram = new ShaderProgram(programName);
+				}
 
-				m_shaderProgram = program;			
+				m_shaderProgram->LoadProgramFromFiles(vsFilepath.c_str(), fsFilepath.c_str());	// Will assign invalid program internally if compilation fails
 			}
 		}
 	}
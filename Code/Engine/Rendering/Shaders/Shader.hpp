@@ -66,6 +66,9 @@ public:
 
 	Shader* Clone();
 
+	// Re-parses the XML in place, keeping this Shader and its ShaderProgram so everything pointing at them sees the change
+	bool ReloadFromFile(const std::string& xmlFilepath);
+
 	static Shader* BuildShader(const std::string& programName, const char* vsSource, const char* fsSource, 
 		const RenderState& state, unsigned int sortingLayer, SortingQueue sortingQueue);
 
@@ -96,6 +99,7 @@ private:
 	//-----Private Methods-----
 
 	// For XML Parsing
+	void ParseShaderElement(const XMLElement& shaderElement);
 	void ParseProgram(const XMLElement& shaderElement);
 	void ParseCullMode(const XMLElement& shaderElement);
 	void ParseFillMode(const XMLElement& shaderElement);
@@ -108,7 +112,7 @@ private:
 private:
 	//-----Private Data-----
 
-	ShaderProgram*	m_shaderProgram;
+	ShaderProgram*	m_shaderProgram = nullptr;
 	RenderState		m_renderState;
 
 	// For the forward rendering path, is ignored elsewhere
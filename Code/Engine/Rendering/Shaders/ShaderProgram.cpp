@@ -371,15 +371,15 @@ static GLuint CreateShader(char const *filenameOrSource, GLenum type, bool isFil
 	// If we're passed a file name, then load it from file
 	if (isFileName)
 	{
-		size_t size;
-		char* src = (char*)FileReadToNewBuffer(filenameOrSource, size);
-		GUARANTEE_OR_DIE(src != nullptr, Stringf("Error: File \"%s\" could not be found or opened.", filenameOrSource));
+		MappedFile file;
+		bool opened = file.Open(filenameOrSource);
+		GUARANTEE_OR_DIE(opened, Stringf("Error: File \"%s\" could not be found or opened.", filenameOrSource));
 
-		GLint shader_length = (GLint)strlen(src);
+		// The mapping isn't null terminated, so the length is passed
+		const char* src = file.GetData();
+		GLint shader_length = (GLint)file.GetSize();
 		glShaderSource(shader_id, 1, &src, &shader_length);
 		glCompileShader(shader_id);
-
-		free(src);
 	}
 	// Otherwise treat the passed char* as a string source
 	else